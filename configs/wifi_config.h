@@ -50,4 +50,10 @@
 /* Wi-Fi re-connection time interval in milliseconds. */
 #define WIFI_CONN_RETRY_INTERVAL_MS       (5000)
 
+/* Reconnection after the link is lost in operation: first and longest wait
+ * in milliseconds between the attempts of the UDP server task, the wait
+ * doubles after every failed attempt. */
+#define WIFI_RECONNECT_MIN_MS             (1000u)
+#define WIFI_RECONNECT_MAX_MS             (30000u)
+
 #endif /* WIFI_CONFIG_H_ */
@@ -0,0 +1,110 @@
+#******************************************************************************
+# File Name:   bench_compare.py
+#
+# Description: Compares the results of the host kernel benchmark
+#              (test/bench_radar.c) with a stored baseline, or stores them as
+#              the new baseline. The results are read as json records, one
+#              per line; of repeated runs the fastest is kept.
+#
+#********************************************************************************
+# Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#********************************************************************************
+
+#!/usr/bin/env python
+import json
+import optparse
+import os
+import sys
+
+# The comparison is the one of the on-target benchmark of the client
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+from udp_client_radar import DEFAULT_BENCH_TOLERANCE, bench_key, compare_bench
+
+
+def read_results(f):
+        """
+         f: file of json records, one per line
+
+        Returns the benchmark results in the order of their first run, each with the fastest
+        minimum and average cycles of all runs.
+        """
+        results = {}
+        for line in f:
+                line = line.strip()
+                if not line:
+                        continue
+                record = json.loads(line)
+                if "done" in record:
+                        continue
+                key = bench_key(record)
+                best = results.get(key)
+                if best is None:
+                        results[key] = record
+                else:
+                        best["min_cycles"] = min(best["min_cycles"], record["min_cycles"])
+                        best["avg_cycles"] = min(best["avg_cycles"], record["avg_cycles"])
+        return list(results.values())
+
+
+if __name__ == '__main__':
+        parser = optparse.OptionParser(usage="bench_compare.py [options] <results, - for stdin>")
+        parser.add_option("--baseline", dest="baseline", type="string", help="Compare the results with this json file.")
+        parser.add_option("--report", dest="report", type="string", help="Write the results to this json file, e.g. as the new baseline.")
+        parser.add_option("--tolerance", dest="tolerance", type="float", default=DEFAULT_BENCH_TOLERANCE, help="Allowed slowdown in percent [default: %default].")
+        (options, args) = parser.parse_args()
+        if len(args) != 1:
+                parser.print_usage()
+                sys.exit(1)
+
+        if args[0] == "-":
+                results = read_results(sys.stdin)
+        else:
+                with open(args[0]) as f:
+                        results = read_results(f)
+
+        for record in results:
+                print("{kernel:20} {samples:5} x {chirps:3} x {antennas} min {min_cycles:8} avg {avg_cycles:8}".format(**record))
+
+        if options.report:
+                with open(options.report, "w") as f:
+                        json.dump(results, f, indent=2)
+                print("bench_compare.py: wrote", options.report)
+
+        if options.baseline:
+                with open(options.baseline) as f:
+                        regressions = compare_bench(results, json.load(f), options.tolerance)
+                for record, base in regressions:
+                        print("Regression:", record["kernel"], bench_key(record)[1:], "min",
+                              base["min_cycles"], "->", record["min_cycles"])
+                if regressions:
+                        sys.exit(1)
+                print("No regression against", options.baseline)
@@ -0,0 +1,272 @@
+#******************************************************************************
+# File Name:   radar_profiles.py
+#
+# Description: Pre-build generator of the radar profile table. Reads the
+#              profiles listed in source/radar_profiles.json, each a radar
+#              settings file with the register list exported for it, checks
+#              that both describe the same frames and writes the register
+#              lists and frame geometries to source/radar_profile_table.h.
+#
+#********************************************************************************
+# Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#********************************************************************************
+
+#!/usr/bin/env python
+import json
+import optparse
+import os
+import re
+import subprocess
+import sys
+
+# Relative deviation allowed between a setting and the value the register export was rounded to
+TIMING_TOLERANCE = 0.02
+FREQUENCY_TOLERANCE_HZ = 1000000
+
+# Receive antennas of the sensor
+MAX_RX_ANTENNAS = 3
+
+DEFINE = re.compile(r"^#define[ \t]+XENSIV_BGT60TRXX_CONF_(\w+)[ \t]+\(?([^)\s]+)\)?", re.MULTILINE)
+REGISTER = re.compile(r"\b0x([0-9a-fA-F]+)UL\b")
+NAME = re.compile(r"^[a-z][a-z0-9_]*$")
+
+
+class ProfileError(Exception):
+        pass
+
+
+def load_settings(path):
+        """
+         path: radar settings json file as exported with the register list
+
+        Returns the fmcw_single_shape settings.
+        """
+        with open(path) as f:
+                settings = json.load(f)
+        try:
+                return settings["device_config"]["fmcw_single_shape"]
+        except KeyError:
+                raise ProfileError(path + ": no device_config.fmcw_single_shape")
+
+
+def load_registers(path):
+        """
+         path: radar_settings.h style register export
+
+        Returns the configuration defines and the register list.
+        """
+        with open(path) as f:
+                text = f.read()
+        defines = {name: value for name, value in DEFINE.findall(text)}
+        start = text.find("register_list[]")
+        if start < 0:
+                raise ProfileError(path + ": no register_list")
+        registers = [int(value, 16) for value in REGISTER.findall(text[start:text.find("};", start)])]
+        return defines, registers
+
+
+def close(setting, exported, tolerance):
+        return abs(float(exported) - setting) <= tolerance * abs(setting)
+
+
+def check_profile(name, settings, defines, registers):
+        """
+         name: profile name
+         settings: fmcw_single_shape settings
+         defines: XENSIV_BGT60TRXX_CONF_* values of the register export
+         registers: register list of the export
+
+        Raises a ProfileError if the register export was not made for the settings.
+        """
+        errors = []
+        expected = {
+                "NUM_SAMPLES_PER_CHIRP": settings["num_samples_per_chirp"],
+                "NUM_CHIRPS_PER_FRAME": settings["num_chirps_per_frame"],
+                "NUM_RX_ANTENNAS": len(settings["rx_antennas"]),
+                "NUM_TX_ANTENNAS": len(settings["tx_antennas"]),
+                "NUM_REGS": len(registers),
+        }
+        for key, value in expected.items():
+                if int(defines.get(key, -1)) != value:
+                        errors.append("{} is {}, expected {}".format(key, defines.get(key), value))
+        timings = {
+                "FRAME_REPETION_TIME_S": settings["frame_repetition_time_s"],
+                "CHIRP_REPETION_TIME_S": settings["chirp_repetition_time_s"],
+                "SAMPLE_RATE": settings["sample_rate_Hz"],
+        }
+        for key, value in timings.items():
+                if key not in defines or not close(value, defines[key], TIMING_TOLERANCE):
+                        errors.append("{} is {}, expected {}".format(key, defines.get(key), value))
+        frequencies = {
+                "LOWER_FREQ_HZ": settings["lower_frequency_Hz"],
+                "UPPER_FREQ_HZ": settings["upper_frequency_Hz"],
+        }
+        for key, value in frequencies.items():
+                if key not in defines or abs(int(defines[key]) - value) > FREQUENCY_TOLERANCE_HZ:
+                        errors.append("{} is {}, expected {}".format(key, defines.get(key), value))
+        if not 1 <= len(settings["rx_antennas"]) <= MAX_RX_ANTENNAS:
+                errors.append("{} RX antennas, 1 to {} supported".format(len(settings["rx_antennas"]), MAX_RX_ANTENNAS))
+        addresses = [register >> 25 for register in registers]
+        if any(a >= b for a, b in zip(addresses, addresses[1:])):
+                errors.append("register addresses are not ascending")
+        if errors:
+                raise ProfileError("profile {}: register export does not match the settings, export it again: {}".format(
+                        name, "; ".join(errors)))
+
+
+def read_profiles(manifest, configurator=None):
+        """
+         manifest: radar_profiles.json
+         configurator: optional command exporting the register list, {settings} and {registers}
+                       are replaced by the file names
+
+        Returns the profiles in the order of the manifest, the first is the default.
+        """
+        base = os.path.dirname(os.path.abspath(manifest))
+        with open(manifest) as f:
+                entries = json.load(f)["profiles"]
+        if not 1 <= len(entries) <= 255:
+                raise ProfileError(manifest + ": 1 to 255 profiles expected")
+
+        profiles = []
+        for entry in entries:
+                name = entry["name"]
+                if not NAME.match(name) or name in (p["name"] for p in profiles):
+                        raise ProfileError("profile name {!r} is not a unique lower case identifier".format(name))
+                settings_path = os.path.join(base, entry["settings"])
+                registers_path = os.path.join(base, entry["registers"])
+                if configurator:
+                        subprocess.check_call(configurator.format(settings=settings_path, registers=registers_path),
+                                              shell=True)
+                settings = load_settings(settings_path)
+                defines, registers = load_registers(registers_path)
+                check_profile(name, settings, defines, registers)
+                profiles.append({
+                        "name": name,
+                        "settings": entry["settings"],
+                        "registers_file": entry["registers"],
+                        "samples": int(defines["NUM_SAMPLES_PER_CHIRP"]),
+                        "chirps": int(defines["NUM_CHIRPS_PER_FRAME"]),
+                        "rx": int(defines["NUM_RX_ANTENNAS"]),
+                        "period_us": int(round(float(defines["FRAME_REPETION_TIME_S"]) * 1e6)),
+                        "registers": registers,
+                })
+        return profiles
+
+
+def max_of(profiles):
+        """
+         profiles: profiles of the table
+
+        Returns the body of RADAR_PROFILE_MAX_OF(), the largest SIZE() over the profiles.
+        """
+        terms = ["SIZE({samples}u, {chirps}u, {rx}u)".format(**p) for p in profiles]
+        body = terms[-1]
+        for term in reversed(terms[:-1]):
+                body = "RADAR_PROFILE_MAX({}, {})".format(term, body)
+        return "(" + body + ")"
+
+
+def generate(profiles, manifest_name):
+        """
+         profiles: profiles of the table
+         manifest_name: file name of the manifest for the header comment
+
+        Returns the text of radar_profile_table.h.
+        """
+        lines = [
+                "/* Radar profiles generated by scripts/radar_profiles.py from {}.".format(manifest_name),
+                " * Do not edit, change the profiles and build again. */",
+                "#ifndef RADAR_PROFILE_TABLE_H_",
+                "#define RADAR_PROFILE_TABLE_H_",
+                "",
+                "#include <stdint.h>",
+                "",
+                "#define RADAR_PROFILE_COUNT ({}u)".format(len(profiles)),
+                "",
+                "/* X(id, name, samples per chirp, chirps per frame, RX antennas, frame period in us) */",
+                "#define RADAR_PROFILE_LIST(X) \\",
+        ]
+        entries = ["    X({}, \"{name}\", {samples}u, {chirps}u, {rx}u, {period_us}u)".format(i, **p)
+                   for i, p in enumerate(profiles)]
+        lines += [entry + " \\" for entry in entries[:-1]] + [entries[-1], ""]
+        lines += [
+                "#define RADAR_PROFILE_MAX_SAMPLES_PER_CHIRP ({}u)".format(max(p["samples"] for p in profiles)),
+                "#define RADAR_PROFILE_MAX_CHIRPS_PER_FRAME ({}u)".format(max(p["chirps"] for p in profiles)),
+                "#define RADAR_PROFILE_MAX_RX_ANTENNAS ({}u)".format(max(p["rx"] for p in profiles)),
+                "",
+                "/* Largest SIZE(samples per chirp, chirps per frame, RX antennas) over the profiles */",
+                "#define RADAR_PROFILE_MAX(a, b) (((a) > (b)) ? (a) : (b))",
+                "#define RADAR_PROFILE_MAX_OF(SIZE) \\",
+                "    " + max_of(profiles),
+                "",
+                "#if defined(RADAR_PROFILE_TABLE_IMPL)",
+        ]
+        for i, p in enumerate(profiles):
+                lines.append("/* {name}: {settings}, registers from {registers_file} */".format(**p))
+                lines.append("static const uint32_t radar_profile_{}_registers[] = {{".format(i))
+                lines += ["    0x{:x}UL,".format(register) for register in p["registers"]]
+                lines.append("};")
+                lines.append("")
+        lines += [
+                "#endif",
+                "",
+                "#endif /* RADAR_PROFILE_TABLE_H_ */",
+        ]
+        return "\n".join(lines) + "\n"
+
+
+if __name__ == '__main__':
+        parser = optparse.OptionParser(usage="radar_profiles.py [options] <radar_profiles.json> <radar_profile_table.h>")
+        parser.add_option("--configurator", dest="configurator", type="string",
+                          help="Command exporting the register list of a profile, e.g. "
+                               "\"<tool> {settings} {registers}\"; without it the existing exports are used.")
+        (options, args) = parser.parse_args()
+        if len(args) != 2:
+                parser.print_usage()
+                sys.exit(1)
+
+        try:
+                text = generate(read_profiles(args[0], options.configurator), os.path.basename(args[0]))
+        except (ProfileError, KeyError, ValueError, OSError, subprocess.CalledProcessError) as e:
+                print("radar_profiles.py: error:", e)
+                sys.exit(1)
+
+        # Only a changed table rebuilds the sources including it
+        old = None
+        if os.path.exists(args[1]):
+                with open(args[1]) as f:
+                        old = f.read()
+        if text != old:
+                with open(args[1], "w") as f:
+                        f.write(text)
+                print("radar_profiles.py: wrote", args[1])
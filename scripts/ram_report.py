@@ -0,0 +1,118 @@
+#******************************************************************************
+# File Name:   ram_report.py
+#
+# Description: Post-build RAM report. Sums the .data and .bss input sections of
+#              the linker map file per subsystem of the application and per
+#              library, so growth of the statically allocated memory shows at
+#              every build.
+#
+#********************************************************************************
+# Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#********************************************************************************
+
+#!/usr/bin/env python
+import os
+import re
+import sys
+from collections import defaultdict
+
+# Subsystems of the application by object file, see source/radar_memory.h
+SUBSYSTEMS = {
+        "main": "application",
+        "radar_memory": "rtos objects",
+        "radar_task": "acquisition",
+        "radar_handoff": "acquisition",
+        "radar_clock": "acquisition",
+        "radar_test_pattern": "acquisition",
+        "radar_config_task": "configuration",
+        "radar_bench": "benchmark",
+        "udp_server": "transport",
+        "radar_fec": "transport",
+        "radar_resend": "transport",
+        "radar_sync": "transport",
+}
+PROCESSING = "processing"
+
+# Input section of the map file: name, possibly on its own line, then address, size and object
+SECTION = re.compile(r"^ (\.(?:data|bss)\S*|COMMON)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S+)", re.MULTILINE)
+
+# Heap and stack reserved by the linker script
+RESERVED = re.compile(r"^(\.heap|\.stack_dummy)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)", re.MULTILINE)
+
+
+def owner(path):
+        """
+         path: object file or library member of an input section
+
+        Returns the subsystem of an application object file or the name of the library.
+        """
+        member = re.match(r"(.*?)([^/\\]+)\.a\((.*)\)$", path)
+        if member:
+                name = member.group(2)
+                return "lib " + (name[3:] if name.startswith("lib") else name)
+        parts = path.replace("\\", "/").split("/")
+        name = os.path.splitext(parts[-1])[0]
+        if "source" in parts:
+                return SUBSYSTEMS.get(name, PROCESSING if name.startswith("radar_") else "application")
+        for marker in ("mtb_shared", "libs"):
+                if marker in parts and parts.index(marker) + 1 < len(parts):
+                        return "lib " + parts[parts.index(marker) + 1]
+        return name
+
+
+def ram_report(map_file):
+        """
+         map_file: linker map file of the application
+
+        Prints the RAM per subsystem and library, largest first.
+        """
+        with open(map_file) as f:
+                text = f.read()
+
+        sizes = defaultdict(int)
+        for _, address, size, path in SECTION.findall(text):
+                if int(address, 16) != 0:
+                        sizes[owner(path)] += int(size, 16)
+        for name, address, size in RESERVED.findall(text):
+                sizes["reserved " + name[1:]] += int(size, 16)
+
+        print("RAM report of", map_file)
+        for name, size in sorted(sizes.items(), key=lambda item: -item[1]):
+                print("  {:<32} {:>9} bytes".format(name, size))
+        print("  {:<32} {:>9} bytes".format("total", sum(sizes.values())))
+
+
+if __name__ == '__main__':
+        if len(sys.argv) != 2:
+                print("Usage: ram_report.py <map file>")
+                sys.exit(1)
+        ram_report(sys.argv[1])
@@ -50,6 +50,7 @@
 /* UDP server task header file. */
 #include "udp_server.h"
 #include "radar_task.h"
+#include "radar_memory.h"
 
 /******************************************************************************
  * Function Name: main
@@ -91,8 +92,8 @@ int main()
     printf("===============================================================\n\n");
 
     /* Create the tasks. */
-    if(pdPASS != xTaskCreate(udp_server_task, "UDP server task", UDP_SERVER_TASK_STACK_SIZE, NULL,
-               UDP_SERVER_TASK_PRIORITY, NULL))
+    if (NULL == xTaskCreateStatic(udp_server_task, "UDP server task", UDP_SERVER_TASK_STACK_SIZE, NULL,
+                                  UDP_SERVER_TASK_PRIORITY, udp_server_task_stack, &udp_server_task_buffer))
     {
         printf("Failed to create UDP server task!\n");
     }
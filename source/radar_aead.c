@@ -0,0 +1,221 @@
+/*****************************************************************************
+ * File name: radar_aead.c
+ *
+ * Description: Authenticated encryption of the frame datagrams with AES-GCM
+ * and a pre-shared key. The payload is encrypted in place and the header is
+ * authenticated, so the transport can still number, protect and retransmit
+ * the sealed datagrams.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file from library */
+#include "mbedtls/platform_util.h"
+
+/* Header file for local module */
+#include "radar_aead.h"
+#include "radar_frame.h"
+
+/*******************************************************************************
+ * Function Name: hex_digit
+ *******************************************************************************
+ * Summary:
+ *   Converts a hex digit to its value.
+ *
+ * Parameters:
+ *   c : character
+ *
+ * Return:
+ *   value of the digit, -1 if the character is no hex digit
+ ******************************************************************************/
+static int32_t hex_digit(char c)
+{
+    if ((c >= '0') && (c <= '9'))
+    {
+        return c - '0';
+    }
+    if ((c >= 'a') && (c <= 'f'))
+    {
+        return c - 'a' + 10;
+    }
+    if ((c >= 'A') && (c <= 'F'))
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/*******************************************************************************
+ * Function Name: parse_key
+ *******************************************************************************
+ * Summary:
+ *   Converts the hex digits of the pre-shared key to bytes.
+ *
+ * Parameters:
+ *   hex : RADAR_AEAD_KEY_SIZE * 2 hex digits
+ *   key : destination of RADAR_AEAD_KEY_SIZE bytes
+ *
+ * Return:
+ *   true if the key has the right length and only hex digits
+ ******************************************************************************/
+static bool parse_key(const char *hex, uint8_t *key)
+{
+    if (strlen(hex) != (2u * RADAR_AEAD_KEY_SIZE))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < RADAR_AEAD_KEY_SIZE; ++i)
+    {
+        const int32_t high = hex_digit(hex[2u * i]);
+        const int32_t low = hex_digit(hex[(2u * i) + 1u]);
+
+        if ((high < 0) || (low < 0))
+        {
+            return false;
+        }
+        key[i] = (uint8_t)((high << 4) | low);
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_aead_init
+ *******************************************************************************
+ * Summary:
+ *   Sets up the encryption with the pre-shared key. The key schedule is
+ *   computed here once, sealing a datagram only runs the cipher. No datagram
+ *   is sealed before a salt is set.
+ *
+ * Parameters:
+ *   aead : encryption state
+ *   key  : RADAR_AEAD_KEY_SIZE * 2 hex digits, empty disables the encryption
+ *
+ * Return:
+ *   true unless the key is malformed
+ ******************************************************************************/
+bool radar_aead_init(radar_aead_t *aead, const char *key)
+{
+    uint8_t key_bytes[RADAR_AEAD_KEY_SIZE];
+    bool result = true;
+
+    mbedtls_gcm_init(&aead->gcm);
+    aead->enabled = false;
+    aead->salted = false;
+    aead->next_frame_num = 0;
+
+    if (key[0] == '\0')
+    {
+        return true;
+    }
+
+    if (!parse_key(key, key_bytes) ||
+        (mbedtls_gcm_setkey(&aead->gcm, MBEDTLS_CIPHER_ID_AES, key_bytes, RADAR_AEAD_KEY_SIZE * 8u) != 0))
+    {
+        result = false;
+    }
+    else
+    {
+        aead->enabled = true;
+    }
+
+    mbedtls_platform_zeroize(key_bytes, sizeof(key_bytes));
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_aead_set_salt
+ *******************************************************************************
+ * Summary:
+ *   Starts a session with a new salt, every frame number can be sealed once
+ *   again. The salt has to be random, a salt used before with the same key
+ *   repeats nonces.
+ *
+ * Parameters:
+ *   aead : encryption state
+ *   salt : RADAR_AEAD_SALT_SIZE random bytes
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_aead_set_salt(radar_aead_t *aead, const uint8_t *salt)
+{
+    memcpy(aead->salt, salt, RADAR_AEAD_SALT_SIZE);
+    aead->salted = true;
+    aead->next_frame_num = 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_aead_seal
+ *******************************************************************************
+ * Summary:
+ *   Encrypts the payload of a frame datagram in place and appends the salt
+ *   and the tag authenticating the header and the payload. Frame numbers have
+ *   to increase from one datagram to the next, a sealed datagram is
+ *   retransmitted as it is.
+ *
+ * Parameters:
+ *   aead     : encryption state
+ *   datagram : frame datagram with RADAR_AEAD_OVERHEAD bytes of room after it
+ *   length   : size of the datagram
+ *
+ * Return:
+ *   size of the sealed datagram, 0 if the frame number was sealed before
+ *   under this salt or no salt is set
+ ******************************************************************************/
+uint32_t radar_aead_seal(radar_aead_t *aead, uint8_t *datagram, uint32_t length)
+{
+    uint8_t nonce[RADAR_AEAD_NONCE_SIZE];
+    uint32_t frame_num;
+
+    if (!aead->salted || (length < RADAR_FRAME_HEADER_SIZE))
+    {
+        return 0;
+    }
+
+    frame_num = radar_frame_get_u32(&datagram[RADAR_FRAME_HDR_FRAME_NUM]);
+    if (frame_num < aead->next_frame_num)
+    {
+        return 0;
+    }
+
+    memcpy(nonce, aead->salt, RADAR_AEAD_SALT_SIZE);
+    radar_frame_put_u32(&nonce[RADAR_AEAD_SALT_SIZE], frame_num);
+    memcpy(&datagram[length], aead->salt, RADAR_AEAD_SALT_SIZE);
+
+    datagram[RADAR_FRAME_HDR_FLAGS] |= RADAR_FRAME_FLAG_SEALED;
+    if (mbedtls_gcm_crypt_and_tag(&aead->gcm, MBEDTLS_GCM_ENCRYPT, length - RADAR_FRAME_HEADER_SIZE,
+                                  nonce, sizeof(nonce), datagram, RADAR_FRAME_HEADER_SIZE,
+                                  &datagram[RADAR_FRAME_HEADER_SIZE], &datagram[RADAR_FRAME_HEADER_SIZE],
+                                  RADAR_AEAD_TAG_SIZE, &datagram[length + RADAR_AEAD_SALT_SIZE]) != 0)
+    {
+        datagram[RADAR_FRAME_HDR_FLAGS] &= (uint8_t)~RADAR_FRAME_FLAG_SEALED;
+        return 0;
+    }
+
+    aead->next_frame_num = (uint64_t)frame_num + 1u;
+    return length + RADAR_AEAD_OVERHEAD;
+}
+
+/* [] END OF FILE */
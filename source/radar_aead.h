@@ -0,0 +1,79 @@
+/******************************************************************************
+ * File Name:   radar_aead.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_aead.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_AEAD_H_
+#define RADAR_AEAD_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mbedtls/gcm.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Pre-shared key as 32 hex digits, set with RADAR_AEAD_KEY in the Makefile.
+ * Without a key the frame datagrams are sent in plaintext. */
+#ifndef RADAR_AEAD_KEY
+#define RADAR_AEAD_KEY                  ""
+#endif
+
+/* Sealed frame datagram:
+ *   [0..21]   frame header with RADAR_FRAME_FLAG_SEALED, authenticated
+ *   [22..n-1] payload, encrypted in place
+ *   [n..n+7]  salt of the session
+ *   [n+8..]   authentication tag
+ * The AES-GCM nonce is the salt followed by the frame number, little endian.
+ * Every frame number is sealed once per salt, a new salt is drawn when they
+ * wrap around. */
+#define RADAR_AEAD_KEY_SIZE             (16u)
+#define RADAR_AEAD_SALT_SIZE            (8u)
+#define RADAR_AEAD_NONCE_SIZE           (RADAR_AEAD_SALT_SIZE + 4u)
+#define RADAR_AEAD_TAG_SIZE             (16u)
+#define RADAR_AEAD_OVERHEAD             (RADAR_AEAD_SALT_SIZE + RADAR_AEAD_TAG_SIZE)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    mbedtls_gcm_context gcm;    /* key schedule, computed once */
+    bool enabled;               /* a key is set */
+    bool salted;                /* salt is set, frames may be sealed */
+    uint8_t salt[RADAR_AEAD_SALT_SIZE];
+    uint64_t next_frame_num;    /* smallest frame number not sealed yet */
+} radar_aead_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+bool radar_aead_init(radar_aead_t *aead, const char *key);
+void radar_aead_set_salt(radar_aead_t *aead, const uint8_t *salt);
+uint32_t radar_aead_seal(radar_aead_t *aead, uint8_t *datagram, uint32_t length);
+
+#endif /* RADAR_AEAD_H_ */
+/* [] END OF FILE */
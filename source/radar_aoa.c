@@ -0,0 +1,148 @@
+/*****************************************************************************
+ * File name: radar_aoa.c
+ *
+ * Description: This file implements the angle of arrival estimation of
+ * detected targets by phase comparison between antenna pairs.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+#include <stdbool.h>
+
+/* Header file for local module */
+#include "radar_aoa.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define AOA_PI                          (3.14159265f)
+
+/* Angles are reported in 0.01 degrees */
+#define AOA_RAD_TO_CENTIDEGREE          (18000.0f / AOA_PI)
+
+/*******************************************************************************
+ * Function Name: frame_antenna
+ *******************************************************************************
+ * Summary:
+ *   Finds the index of a sensor antenna within the frame.
+ *
+ * Parameters:
+ *   antenna_mask : sensor antennas present in the frame
+ *   rx           : sensor antenna
+ *   index        : index of the antenna within the frame
+ *
+ * Return:
+ *   true if the antenna is present
+ ******************************************************************************/
+static bool frame_antenna(uint8_t antenna_mask, uint32_t rx, uint32_t *index)
+{
+    uint32_t below = antenna_mask & ((1u << rx) - 1u);
+
+    *index = 0;
+    while (below != 0)
+    {
+        *index += below & 1u;
+        below >>= 1;
+    }
+
+    return ((antenna_mask >> rx) & 1u) != 0;
+}
+
+/*******************************************************************************
+ * Function Name: pair_angle
+ *******************************************************************************
+ * Summary:
+ *   Estimates the angle of arrival from the phase difference of two antennas
+ *   half a wavelength apart: sin(angle) = phase / pi, with the phase of the
+ *   antenna relative to the reference antenna.
+ *
+ * Parameters:
+ *   rd          : range-Doppler state holding the complex maps
+ *   rx          : frame index of the antenna
+ *   reference   : frame index of the reference antenna
+ *   range_bin   : range bin of the target
+ *   doppler_bin : Doppler bin of the target in FFT order
+ *
+ * Return:
+ *   angle in 0.01 degrees
+ ******************************************************************************/
+static int16_t pair_angle(const radar_rd_t *rd, uint32_t rx, uint32_t reference, uint32_t range_bin,
+                          uint32_t doppler_bin)
+{
+    float a_re, a_im, b_re, b_im;
+    float ratio;
+
+    radar_rd_cell(rd, rx, range_bin, doppler_bin, &a_re, &a_im);
+    radar_rd_cell(rd, reference, range_bin, doppler_bin, &b_re, &b_im);
+
+    /* Phase of a * conj(b) */
+    ratio = atan2f((a_im * b_re) - (a_re * b_im), (a_re * b_re) + (a_im * b_im)) / AOA_PI;
+    ratio = (ratio > 1.0f) ? 1.0f : ((ratio < -1.0f) ? -1.0f : ratio);
+
+    return (int16_t)lroundf(asinf(ratio) * AOA_RAD_TO_CENTIDEGREE);
+}
+
+/*******************************************************************************
+ * Function Name: radar_aoa_estimate
+ *******************************************************************************
+ * Summary:
+ *   Fills in azimuth and elevation of the detected targets from the complex
+ *   range-Doppler maps of the antennas. An angle whose antenna pair is not
+ *   part of the frame stays RADAR_TARGET_ANGLE_NONE.
+ *
+ * Parameters:
+ *   rd           : range-Doppler state of the frame the targets come from
+ *   antenna_mask : sensor antennas present in the frame, in frame order
+ *   targets      : target list
+ *   num_targets  : number of targets
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_aoa_estimate(const radar_rd_t *rd, uint8_t antenna_mask, radar_target_t *targets,
+                        uint32_t num_targets)
+{
+    uint32_t azimuth_rx, elevation_rx, reference_rx;
+    const bool has_reference = frame_antenna(antenna_mask, RADAR_AOA_REFERENCE_RX, &reference_rx);
+    const bool has_azimuth = has_reference && frame_antenna(antenna_mask, RADAR_AOA_AZIMUTH_RX, &azimuth_rx);
+    const bool has_elevation = has_reference && frame_antenna(antenna_mask, RADAR_AOA_ELEVATION_RX, &elevation_rx);
+
+    for (uint32_t i = 0; i < num_targets; ++i)
+    {
+        const uint32_t range_bin = targets[i].range_bin;
+        const uint32_t doppler_bin = (targets[i].doppler_bin < 0)
+                                     ? (uint32_t)((int32_t)targets[i].doppler_bin + (int32_t)rd->doppler_bins)
+                                     : (uint32_t)targets[i].doppler_bin;
+
+        if (has_azimuth)
+        {
+            targets[i].azimuth = pair_angle(rd, azimuth_rx, reference_rx, range_bin, doppler_bin);
+        }
+        if (has_elevation)
+        {
+            targets[i].elevation = pair_angle(rd, elevation_rx, reference_rx, range_bin, doppler_bin);
+        }
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,53 @@
+/******************************************************************************
+ * File Name:   radar_aoa.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_aoa.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_AOA_H_
+#define RADAR_AOA_H_
+
+#include <stdint.h>
+
+#include "radar_cfar.h"
+#include "radar_range_doppler.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Antennas of the BGT60TR13C, numbered from RX1 = 0. RX1 and RX3 form the
+ * horizontal pair, RX2 and RX3 the vertical pair, each half a wavelength
+ * apart. */
+#define RADAR_AOA_AZIMUTH_RX            (0u)
+#define RADAR_AOA_ELEVATION_RX          (1u)
+#define RADAR_AOA_REFERENCE_RX          (2u)
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void radar_aoa_estimate(const radar_rd_t *rd, uint8_t antenna_mask, radar_target_t *targets,
+                        uint32_t num_targets);
+
+#endif /* RADAR_AOA_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,877 @@
+/*****************************************************************************
+ * File name: radar_bench.c
+ *
+ * Description: This file implements an on-target benchmark of the per-frame
+ * processing kernels over a sweep of frame geometries.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Header file from library */
+#if defined(__ARM_ARCH)
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+#endif
+#include "xensiv_bgt60trxx.h"
+
+/* Header file for local module */
+#include "radar_aead.h"
+#include "radar_aoa.h"
+#include "radar_bench.h"
+#include "radar_cfar.h"
+#include "radar_cycles.h"
+#include "radar_decim.h"
+#include "radar_fec.h"
+#include "radar_fft.h"
+#include "radar_frame.h"
+#include "radar_mti.h"
+#include "radar_range_doppler.h"
+#include "radar_roi.h"
+#include "radar_spectro.h"
+#if defined(__ARM_ARCH)
+#include "radar_task.h"
+#endif
+#include "radar_test_pattern.h"
+#include "radar_track.h"
+
+/* Radar profiles, the sweep is bounded by the largest geometry */
+#include "radar_profile.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define BENCH_MAX_SAMPLES_PER_CHIRP (RADAR_PROFILE_MAX_SAMPLES_PER_CHIRP)
+#define BENCH_MAX_CHIRPS_PER_FRAME  (RADAR_PROFILE_MAX_CHIRPS_PER_FRAME)
+#define BENCH_MAX_RX_ANTENNAS       (RADAR_PROFILE_MAX_RX_ANTENNAS)
+#define BENCH_MAX_SAMPLES           (BENCH_MAX_SAMPLES_PER_CHIRP * BENCH_MAX_CHIRPS_PER_FRAME * \
+                                     BENCH_MAX_RX_ANTENNAS)
+
+/* Smallest number of samples per chirp of the sweep */
+#define BENCH_MIN_SAMPLES_PER_CHIRP (32u)
+
+#define BENCH_QUEUE_LENGTH          (1u)
+
+/* Frame datagram of the full sensor frame */
+#define BENCH_MAX_DATAGRAM          (RADAR_FRAME_HEADER_SIZE + (2u * BENCH_MAX_SAMPLES))
+
+/* Key of the encryption benchmark */
+#define BENCH_AEAD_KEY              ("000102030405060708090a0b0c0d0e0f")
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    radar_frame_t frame;        /* geometry under test, samples point to bench_frame */
+    const radar_kernels_t *kernels; /* kernels of the profile with this geometry */
+    uint16_t test_word;
+    radar_mti_t mti;
+    radar_roi_t roi;
+    radar_rd_t rd;
+    uint32_t cfar_scale;
+} bench_context_t;
+
+typedef struct
+{
+    const char *name;
+    uint8_t param;
+    bool (*setup)(bench_context_t *context, uint8_t param);  /* optional, false skips the kernel */
+    void (*run)(bench_context_t *context, uint8_t param);
+} bench_kernel_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+static void bench_test_word_run(bench_context_t *context, uint8_t param);
+static bool bench_test_verify_setup(bench_context_t *context, uint8_t param);
+static void bench_test_verify_run(bench_context_t *context, uint8_t param);
+static void bench_header_run(bench_context_t *context, uint8_t param);
+static bool bench_decim_setup(bench_context_t *context, uint8_t param);
+static void bench_decim_run(bench_context_t *context, uint8_t param);
+static bool bench_mti_setup(bench_context_t *context, uint8_t param);
+static void bench_mti_run(bench_context_t *context, uint8_t param);
+static bool bench_roi_setup(bench_context_t *context, uint8_t param);
+static void bench_roi_run(bench_context_t *context, uint8_t param);
+static void bench_deinterleave_run(bench_context_t *context, uint8_t param);
+static bool bench_profile_setup(bench_context_t *context, uint8_t param);
+static bool bench_profile_verify_setup(bench_context_t *context, uint8_t param);
+static void bench_profile_verify_run(bench_context_t *context, uint8_t param);
+static bool bench_profile_roi_setup(bench_context_t *context, uint8_t param);
+static void bench_profile_roi_run(bench_context_t *context, uint8_t param);
+static void bench_profile_deinterleave_run(bench_context_t *context, uint8_t param);
+static bool bench_fft_setup(bench_context_t *context, uint8_t param);
+static void bench_fft_run(bench_context_t *context, uint8_t param);
+static bool bench_cfar_setup(bench_context_t *context, uint8_t param);
+static void bench_cfar_run(bench_context_t *context, uint8_t param);
+static bool bench_track_setup(bench_context_t *context, uint8_t param);
+static void bench_track_run(bench_context_t *context, uint8_t param);
+static bool bench_spectro_setup(bench_context_t *context, uint8_t param);
+static void bench_spectro_frame_run(bench_context_t *context, uint8_t param);
+static void bench_spectro_column_run(bench_context_t *context, uint8_t param);
+static bool bench_fec_setup(bench_context_t *context, uint8_t param);
+static void bench_fec_run(bench_context_t *context, uint8_t param);
+static bool bench_aead_setup(bench_context_t *context, uint8_t param);
+static void bench_aead_run(bench_context_t *context, uint8_t param);
+#if defined(__ARM_ARCH)
+static bool bench_queue_setup(bench_context_t *context, uint8_t param);
+static void bench_queue_run(bench_context_t *context, uint8_t param);
+#endif
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static uint16_t bench_frame[BENCH_MAX_SAMPLES];
+static uint16_t bench_out[BENCH_MAX_SAMPLES];
+static uint16_t bench_scratch[RADAR_DECIM_SCRATCH_SIZE(BENCH_MAX_SAMPLES_PER_CHIRP, BENCH_MAX_RX_ANTENNAS)];
+static int32_t bench_background[BENCH_MAX_SAMPLES_PER_CHIRP * BENCH_MAX_RX_ANTENNAS];
+static uint8_t bench_header[RADAR_FRAME_HEADER_SIZE];
+static float bench_rd_memory[RADAR_RD_MEMORY_SIZE(BENCH_MAX_SAMPLES_PER_CHIRP, BENCH_MAX_CHIRPS_PER_FRAME,
+                                                  BENCH_MAX_RX_ANTENNAS)];
+static uint32_t bench_rd_power[RADAR_RD_POWER_SIZE(BENCH_MAX_SAMPLES_PER_CHIRP, BENCH_MAX_CHIRPS_PER_FRAME)];
+static radar_target_t bench_targets[RADAR_CFAR_MAX_TARGETS];
+static radar_tracker_t bench_tracker;
+static const radar_track_config_t bench_track_config = {
+    .interval = RADAR_TRACK_DEFAULT_INTERVAL,
+    .gate = RADAR_TRACK_DEFAULT_GATE
+};
+static radar_spectro_t bench_spectro;
+static uint8_t bench_column[RADAR_SPECTRO_COLUMN_SIZE(RADAR_SPECTRO_MAX_RANGE_BINS, RADAR_SPECTRO_MAX_WINDOW)];
+static radar_fec_t bench_fec;
+static uint8_t bench_fec_memory[RADAR_FEC_MEMORY_SIZE(BENCH_MAX_DATAGRAM)];
+static uint8_t bench_datagram[BENCH_MAX_DATAGRAM + RADAR_AEAD_OVERHEAD];
+static radar_aead_t bench_aead;
+static const uint8_t bench_salt[RADAR_AEAD_SALT_SIZE] = { 0 };
+static const radar_geometry_t bench_max_geometry = {
+    .samples_per_chirp = BENCH_MAX_SAMPLES_PER_CHIRP,
+    .chirps_per_frame = BENCH_MAX_CHIRPS_PER_FRAME,
+    .rx_antennas = BENCH_MAX_RX_ANTENNAS
+};
+
+#if defined(__ARM_ARCH)
+static StaticQueue_t bench_queue_buffer;
+static uint8_t bench_queue_storage[BENCH_QUEUE_LENGTH * sizeof(uint16_t *)];
+static QueueHandle_t bench_queue = NULL;
+#endif
+
+/* Kernels in the order they are reported. The param of roi selects between
+ * the full frame copy (0) and a gather of antenna 1 and every other chirp (1).
+ * The *_profile kernels are the instances specialized for a radar profile and
+ * only run on its geometry, next to the generic kernel they replace. The
+ * queue handoff needs FreeRTOS and is only timed on target. */
+static const bench_kernel_t bench_kernels[] =
+{
+    { "test_word",            0, NULL,                       bench_test_word_run            },
+    { "test_verify",          0, bench_test_verify_setup,    bench_test_verify_run          },
+    { "test_verify_profile",  0, bench_profile_verify_setup, bench_profile_verify_run       },
+    { "header",               0, NULL,                       bench_header_run               },
+    { "decim2",               2, bench_decim_setup,          bench_decim_run                },
+    { "decim4",               4, bench_decim_setup,          bench_decim_run                },
+    { "decim8",               8, bench_decim_setup,          bench_decim_run                },
+    { "mti",                  0, bench_mti_setup,            bench_mti_run                  },
+    { "roi_copy",             0, bench_roi_setup,            bench_roi_run                  },
+    { "roi_gather",           1, bench_roi_setup,            bench_roi_run                  },
+    { "roi_copy_profile",     0, bench_profile_roi_setup,    bench_profile_roi_run          },
+    { "roi_gather_profile",   1, bench_profile_roi_setup,    bench_profile_roi_run          },
+    { "deinterleave",         0, NULL,                       bench_deinterleave_run         },
+    { "deinterleave_profile", 0, bench_profile_setup,        bench_profile_deinterleave_run },
+    { "range_fft",            0, bench_fft_setup,            bench_fft_run                  },
+    { "cfar",                 0, bench_cfar_setup,           bench_cfar_run                 },
+    { "track",                0, bench_track_setup,          bench_track_run                },
+    { "spectro_frame",        0, bench_spectro_setup,        bench_spectro_frame_run        },
+    { "spectro_column",       0, bench_spectro_setup,        bench_spectro_column_run       },
+    { "fec",                  0, bench_fec_setup,            bench_fec_run                  },
+    { "aead",                 0, bench_aead_setup,           bench_aead_run                 },
+#if defined(__ARM_ARCH)
+    { "queue",                0, bench_queue_setup,          bench_queue_run                },
+#endif
+};
+
+/*******************************************************************************
+ * Function Name: bench_test_word_run
+ *******************************************************************************
+ * Summary:
+ *   Generates the sensor test sequence for one frame.
+ ******************************************************************************/
+static void bench_test_word_run(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    context->test_word = XENSIV_BGT60TRXX_INITIAL_TEST_WORD;
+    radar_test_pattern_fill(context->frame.samples, context->frame.num_samples,
+                            context->frame.geometry.rx_antennas, &context->test_word);
+}
+
+/*******************************************************************************
+ * Function Name: bench_test_verify_setup
+ *******************************************************************************
+ * Summary:
+ *   Fills the frame with the test sequence to be verified.
+ ******************************************************************************/
+static bool bench_test_verify_setup(bench_context_t *context, uint8_t param)
+{
+    bench_test_word_run(context, param);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: bench_test_verify_run
+ *******************************************************************************
+ * Summary:
+ *   Verifies one frame against the test sequence like the test mode does.
+ ******************************************************************************/
+static void bench_test_verify_run(bench_context_t *context, uint8_t param)
+{
+    uint32_t first_error;
+
+    (void)param;
+
+    context->test_word = XENSIV_BGT60TRXX_INITIAL_TEST_WORD;
+    (void)radar_test_pattern_verify(context->frame.samples, context->frame.num_samples,
+                                    context->frame.geometry.rx_antennas, &context->test_word,
+                                    &first_error);
+}
+
+/*******************************************************************************
+ * Function Name: bench_header_run
+ *******************************************************************************
+ * Summary:
+ *   Builds the header of a transmitted frame.
+ ******************************************************************************/
+static void bench_header_run(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    radar_frame_write_header(bench_header, RADAR_DATA_COMMAND, context->frame.num_samples, &context->frame);
+}
+
+/*******************************************************************************
+ * Function Name: bench_decim_setup
+ *******************************************************************************
+ * Summary:
+ *   Skips decimation factors the geometry does not support.
+ ******************************************************************************/
+static bool bench_decim_setup(bench_context_t *context, uint8_t param)
+{
+    return radar_decim_is_valid(param, &context->frame.geometry);
+}
+
+/*******************************************************************************
+ * Function Name: bench_decim_run
+ *******************************************************************************
+ * Summary:
+ *   Decimates the frame in place by the factor given as param.
+ ******************************************************************************/
+static void bench_decim_run(bench_context_t *context, uint8_t param)
+{
+    radar_decim_frame(param, &context->frame.geometry, context->frame.samples, bench_scratch);
+}
+
+/*******************************************************************************
+ * Function Name: bench_mti_setup
+ *******************************************************************************
+ * Summary:
+ *   Starts the clutter removal with an empty background.
+ ******************************************************************************/
+static bool bench_mti_setup(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    radar_mti_init(&context->mti, bench_background, sizeof(bench_background) / sizeof(bench_background[0]));
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: bench_mti_run
+ *******************************************************************************
+ * Summary:
+ *   Removes the static clutter of one frame.
+ ******************************************************************************/
+static void bench_mti_run(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    (void)radar_mti_process(&context->mti, RADAR_MTI_DEFAULT_ALPHA_SHIFT, &context->frame.geometry,
+                            context->frame.samples);
+}
+
+/*******************************************************************************
+ * Function Name: bench_roi_setup
+ *******************************************************************************
+ * Summary:
+ *   Selects the full frame or, if param is set, the first antenna, every
+ *   other chirp and the first half of the samples.
+ ******************************************************************************/
+static bool bench_roi_setup(bench_context_t *context, uint8_t param)
+{
+    radar_roi_reset(&context->roi, &context->frame.geometry);
+
+    if (param != 0)
+    {
+        context->roi.antenna_mask = 1u;
+        context->roi.chirp_stride = (context->frame.geometry.chirps_per_frame > 1u) ? 2u : 1u;
+        context->roi.sample_count = context->frame.geometry.samples_per_chirp / 2u;
+    }
+
+    return radar_roi_is_valid(&context->roi, &context->frame.geometry);
+}
+
+/*******************************************************************************
+ * Function Name: bench_roi_run
+ *******************************************************************************
+ * Summary:
+ *   Gathers the selected region of the frame.
+ ******************************************************************************/
+static void bench_roi_run(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    (void)radar_roi_gather(&context->roi, &context->frame.geometry, context->frame.samples, bench_out);
+}
+
+/*******************************************************************************
+ * Function Name: bench_deinterleave_run
+ *******************************************************************************
+ * Summary:
+ *   Splits the frame into one block of samples per antenna.
+ ******************************************************************************/
+static void bench_deinterleave_run(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    radar_frame_deinterleave(&context->frame.geometry, context->frame.samples, bench_out);
+}
+
+/*******************************************************************************
+ * Function Name: bench_profile_setup
+ *******************************************************************************
+ * Summary:
+ *   Selects the kernels of the radar profile with the geometry under test,
+ *   skips the specialized kernels on other geometries.
+ ******************************************************************************/
+static bool bench_profile_setup(bench_context_t *context, uint8_t param)
+{
+    const radar_profile_t *profile = radar_profile_find(&context->frame.geometry);
+
+    (void)param;
+
+    context->kernels = (profile != NULL) ? &profile->kernels : NULL;
+    return (profile != NULL);
+}
+
+/*******************************************************************************
+ * Function Name: bench_profile_verify_setup
+ *******************************************************************************
+ * Summary:
+ *   Fills the frame with the test sequence for the specialized verification.
+ ******************************************************************************/
+static bool bench_profile_verify_setup(bench_context_t *context, uint8_t param)
+{
+    return bench_profile_setup(context, param) && bench_test_verify_setup(context, param);
+}
+
+/*******************************************************************************
+ * Function Name: bench_profile_verify_run
+ *******************************************************************************
+ * Summary:
+ *   Verifies one frame against the test sequence with the profile kernel.
+ ******************************************************************************/
+static void bench_profile_verify_run(bench_context_t *context, uint8_t param)
+{
+    uint32_t first_error;
+
+    (void)param;
+
+    context->test_word = XENSIV_BGT60TRXX_INITIAL_TEST_WORD;
+    (void)context->kernels->test_verify(context->frame.samples, &context->test_word, &first_error);
+}
+
+/*******************************************************************************
+ * Function Name: bench_profile_roi_setup
+ *******************************************************************************
+ * Summary:
+ *   Selects the region like bench_roi_setup() for the profile kernel.
+ ******************************************************************************/
+static bool bench_profile_roi_setup(bench_context_t *context, uint8_t param)
+{
+    return bench_profile_setup(context, param) && bench_roi_setup(context, param);
+}
+
+/*******************************************************************************
+ * Function Name: bench_profile_roi_run
+ *******************************************************************************
+ * Summary:
+ *   Gathers the selected region of the frame with the profile kernel.
+ ******************************************************************************/
+static void bench_profile_roi_run(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    (void)context->kernels->roi_gather(&context->roi, context->frame.samples, bench_out);
+}
+
+/*******************************************************************************
+ * Function Name: bench_profile_deinterleave_run
+ *******************************************************************************
+ * Summary:
+ *   Splits the frame into one block of samples per antenna with the profile
+ *   kernel.
+ ******************************************************************************/
+static void bench_profile_deinterleave_run(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    context->kernels->deinterleave(context->frame.samples, bench_out);
+}
+
+/*******************************************************************************
+ * Function Name: bench_fft_setup
+ *******************************************************************************
+ * Summary:
+ *   Clears the chirp buffers of the range FFT. The FFT is timed on zeros so
+ *   that repeated runs on the same buffer cannot overflow.
+ ******************************************************************************/
+static bool bench_fft_setup(bench_context_t *context, uint8_t param)
+{
+    const uint32_t size = RADAR_FFT_SIZE(context->frame.geometry.samples_per_chirp);
+
+    (void)param;
+
+    radar_rd_init(&context->rd, bench_rd_memory, bench_rd_power, &bench_max_geometry);
+    memset(context->rd.chirp_re, 0, size * sizeof(float));
+    memset(context->rd.chirp_im, 0, size * sizeof(float));
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: bench_fft_run
+ *******************************************************************************
+ * Summary:
+ *   Computes the range FFT of one chirp.
+ ******************************************************************************/
+static void bench_fft_run(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    radar_fft(context->rd.chirp_re, context->rd.chirp_im, RADAR_FFT_SIZE(context->frame.geometry.samples_per_chirp));
+}
+
+/*******************************************************************************
+ * Function Name: bench_cfar_setup
+ *******************************************************************************
+ * Summary:
+ *   Sets up the range-Doppler processing for the target detection, which
+ *   reads the frame split per antenna.
+ ******************************************************************************/
+static bool bench_cfar_setup(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    radar_rd_init(&context->rd, bench_rd_memory, bench_rd_power, &bench_max_geometry);
+    context->cfar_scale = radar_cfar_scale(RADAR_CFAR_DEFAULT_THRESHOLD_DB);
+    radar_frame_deinterleave(&context->frame.geometry, context->frame.samples, bench_out);
+
+    return radar_rd_is_valid(&context->rd, &context->frame.geometry);
+}
+
+/*******************************************************************************
+ * Function Name: bench_cfar_run
+ *******************************************************************************
+ * Summary:
+ *   Computes the range-Doppler map of the frame, detects the targets with the
+ *   default detector settings and estimates their angles.
+ ******************************************************************************/
+static void bench_cfar_run(bench_context_t *context, uint8_t param)
+{
+    static const radar_cfar_config_t config = {
+        .guard_cells = RADAR_CFAR_DEFAULT_GUARD_CELLS,
+        .training_cells = RADAR_CFAR_DEFAULT_TRAINING_CELLS,
+        .threshold_db = RADAR_CFAR_DEFAULT_THRESHOLD_DB
+    };
+    uint32_t num_targets;
+
+    (void)param;
+
+    radar_rd_process(&context->rd, &context->frame.geometry, bench_out);
+    num_targets = radar_cfar_detect(&config, context->cfar_scale, context->rd.power, context->rd.range_bins,
+                                    context->rd.doppler_bins, bench_targets, RADAR_CFAR_MAX_TARGETS);
+    radar_aoa_estimate(&context->rd, context->frame.roi.antenna_mask, bench_targets, num_targets);
+}
+
+/*******************************************************************************
+ * Function Name: bench_track_setup
+ *******************************************************************************
+ * Summary:
+ *   Fills the track table with confirmed tracks, one per detected target,
+ *   spread over the range bins of the frame and far apart in Doppler so
+ *   that every target gets its own track.
+ ******************************************************************************/
+static bool bench_track_setup(bench_context_t *context, uint8_t param)
+{
+    const uint32_t range_bins = RADAR_RD_RANGE_BINS(context->frame.geometry.samples_per_chirp);
+
+    (void)param;
+
+    for (uint32_t i = 0; i < RADAR_TRACK_MAX_TRACKS; ++i)
+    {
+        bench_targets[i].range_bin = (uint16_t)((i * range_bins) / RADAR_TRACK_MAX_TRACKS);
+        bench_targets[i].doppler_bin = (int16_t)(i * 2u * RADAR_TRACK_MAX_GATE);
+        bench_targets[i].power = 1000u;
+        bench_targets[i].azimuth = RADAR_TARGET_ANGLE_NONE;
+        bench_targets[i].elevation = RADAR_TARGET_ANGLE_NONE;
+    }
+
+    bench_tracker.next_id = 0;
+    radar_track_reset(&bench_tracker);
+    for (uint32_t i = 0; i < RADAR_TRACK_CONFIRM_HITS; ++i)
+    {
+        radar_track_update(&bench_tracker, &bench_track_config, bench_targets, RADAR_TRACK_MAX_TRACKS);
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: bench_track_run
+ *******************************************************************************
+ * Summary:
+ *   Associates a full table of tracks with as many targets and updates them.
+ ******************************************************************************/
+static void bench_track_run(bench_context_t *context, uint8_t param)
+{
+
+    (void)context;
+    (void)param;
+
+    radar_track_update(&bench_tracker, &bench_track_config, bench_targets, RADAR_TRACK_MAX_TRACKS);
+}
+
+/*******************************************************************************
+ * Function Name: bench_spectro_setup
+ *******************************************************************************
+ * Summary:
+ *   Sets up the spectrogram of the most range bins with the default window
+ *   and a column every frame, and fills the window.
+ ******************************************************************************/
+static bool bench_spectro_setup(bench_context_t *context, uint8_t param)
+{
+    const radar_spectro_config_t config = {
+        .range_bin = 1,
+        .range_bins = RADAR_SPECTRO_MAX_RANGE_BINS,
+        .window = RADAR_SPECTRO_DEFAULT_WINDOW,
+        .hop = 1
+    };
+
+    (void)param;
+
+    if ((config.range_bin + config.range_bins) > RADAR_RD_RANGE_BINS(context->frame.geometry.samples_per_chirp))
+    {
+        return false;
+    }
+
+    radar_spectro_init(&bench_spectro, &config);
+    for (uint32_t i = 0; i < config.window; ++i)
+    {
+        (void)radar_spectro_process(&bench_spectro, &context->frame.geometry, context->frame.samples);
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: bench_spectro_frame_run
+ *******************************************************************************
+ * Summary:
+ *   Adds the slow-time samples of one frame to the spectrogram window.
+ ******************************************************************************/
+static void bench_spectro_frame_run(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    (void)radar_spectro_process(&bench_spectro, &context->frame.geometry, context->frame.samples);
+}
+
+/*******************************************************************************
+ * Function Name: bench_spectro_column_run
+ *******************************************************************************
+ * Summary:
+ *   Computes and encodes one spectrogram column.
+ ******************************************************************************/
+static void bench_spectro_column_run(bench_context_t *context, uint8_t param)
+{
+    (void)context;
+    (void)param;
+
+    (void)radar_spectro_write_column(&bench_spectro, bench_column);
+}
+
+/*******************************************************************************
+ * Function Name: bench_fec_setup
+ *******************************************************************************
+ * Summary:
+ *   Sets up the parity of the largest group over datagrams of the frame.
+ ******************************************************************************/
+static bool bench_fec_setup(bench_context_t *context, uint8_t param)
+{
+    const radar_fec_config_t config = {
+        .group_size = RADAR_FEC_MAX_GROUP,
+        .parity_count = RADAR_FEC_DEFAULT_PARITY
+    };
+
+    (void)param;
+
+    radar_fec_init(&bench_fec, bench_fec_memory, BENCH_MAX_DATAGRAM, &config);
+    radar_frame_write_header(bench_datagram, RADAR_DATA_COMMAND, 0, &context->frame);
+    memcpy(&bench_datagram[RADAR_FRAME_HEADER_SIZE], context->frame.samples,
+           context->frame.num_samples * sizeof(uint16_t));
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: bench_fec_run
+ *******************************************************************************
+ * Summary:
+ *   Adds one frame datagram to the parity, every group size runs also
+ *   clear the parity of the previous group.
+ ******************************************************************************/
+static void bench_fec_run(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    (void)radar_fec_add(&bench_fec, bench_datagram,
+                        RADAR_FRAME_HEADER_SIZE + (context->frame.num_samples * sizeof(uint16_t)));
+}
+
+/*******************************************************************************
+ * Function Name: bench_aead_setup
+ *******************************************************************************
+ * Summary:
+ *   Sets up the encryption with a fixed key and a frame datagram to seal.
+ ******************************************************************************/
+static bool bench_aead_setup(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    /* The key schedule is computed once, like in the UDP server */
+    if (!bench_aead.enabled && !radar_aead_init(&bench_aead, BENCH_AEAD_KEY))
+    {
+        return false;
+    }
+
+    radar_frame_write_header(bench_datagram, RADAR_DATA_COMMAND, 0, &context->frame);
+    memcpy(&bench_datagram[RADAR_FRAME_HEADER_SIZE], context->frame.samples,
+           context->frame.num_samples * sizeof(uint16_t));
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: bench_aead_run
+ *******************************************************************************
+ * Summary:
+ *   Encrypts one frame datagram in place and computes its tag. The salt is
+ *   set again every run so the same frame number can be sealed.
+ ******************************************************************************/
+static void bench_aead_run(bench_context_t *context, uint8_t param)
+{
+    (void)param;
+
+    radar_aead_set_salt(&bench_aead, bench_salt);
+    (void)radar_aead_seal(&bench_aead, bench_datagram,
+                          RADAR_FRAME_HEADER_SIZE + (context->frame.num_samples * sizeof(uint16_t)));
+}
+
+#if defined(__ARM_ARCH)
+/*******************************************************************************
+ * Function Name: bench_queue_setup
+ *******************************************************************************
+ * Summary:
+ *   Creates the queue used to time a frame handoff.
+ ******************************************************************************/
+static bool bench_queue_setup(bench_context_t *context, uint8_t param)
+{
+    (void)context;
+    (void)param;
+
+    if (bench_queue == NULL)
+    {
+        bench_queue = xQueueCreateStatic(BENCH_QUEUE_LENGTH, sizeof(uint16_t *), bench_queue_storage,
+                                         &bench_queue_buffer);
+    }
+
+    return (bench_queue != NULL);
+}
+
+/*******************************************************************************
+ * Function Name: bench_queue_run
+ *******************************************************************************
+ * Summary:
+ *   Passes the frame pointer through a queue the way frames are handed to the
+ *   UDP server task.
+ ******************************************************************************/
+static void bench_queue_run(bench_context_t *context, uint8_t param)
+{
+    uint16_t *samples = NULL;
+
+    (void)param;
+
+    (void)xQueueSendToBack(bench_queue, &context->frame.samples, 0);
+    (void)xQueueReceive(bench_queue, &samples, 0);
+}
+#endif /* defined(__ARM_ARCH) */
+
+/*******************************************************************************
+ * Function Name: bench_kernel
+ *******************************************************************************
+ * Summary:
+ *   Times one kernel on the geometry of the context and reports the result.
+ *   On target the scheduler is suspended while the kernel runs so that other
+ *   tasks do not end up in the measurement, interrupts are still served.
+ *
+ * Parameters:
+ *   kernel  : kernel to run
+ *   context : geometry and state of the run
+ *   report  : callback receiving the json record
+ *   arg     : callback data pointer
+ *
+ * Return:
+ *   true if the kernel was run, false if it does not support the geometry
+ ******************************************************************************/
+static bool bench_kernel(const bench_kernel_t *kernel, bench_context_t *context,
+                         radar_bench_report_t report, void *arg)
+{
+    char record[RADAR_BENCH_RECORD_SIZE];
+    uint32_t min_cycles = UINT32_MAX;
+    uint64_t total_cycles = 0;
+    int length;
+
+    if ((kernel->setup != NULL) && !kernel->setup(context, kernel->param))
+    {
+        return false;
+    }
+
+#if defined(__ARM_ARCH)
+    vTaskSuspendAll();
+#endif
+    for (uint32_t iteration = 0; iteration < RADAR_BENCH_ITERATIONS; ++iteration)
+    {
+        const uint32_t start = radar_cycles_now();
+        kernel->run(context, kernel->param);
+        const uint32_t cycles = radar_cycles_now() - start;
+
+        total_cycles += cycles;
+        if (cycles < min_cycles)
+        {
+            min_cycles = cycles;
+        }
+    }
+#if defined(__ARM_ARCH)
+    (void)xTaskResumeAll();
+#endif
+
+    length = snprintf(record, sizeof(record),
+                      "{\"kernel\":\"%s\",\"samples\":%u,\"chirps\":%u,\"antennas\":%u,"
+                      "\"iterations\":%" PRIu32 ",\"min_cycles\":%" PRIu32 ",\"avg_cycles\":%" PRIu32 "}",
+                      kernel->name, (unsigned int)context->frame.geometry.samples_per_chirp,
+                      (unsigned int)context->frame.geometry.chirps_per_frame,
+                      (unsigned int)context->frame.geometry.rx_antennas, RADAR_BENCH_ITERATIONS, min_cycles,
+                      (uint32_t)(total_cycles / RADAR_BENCH_ITERATIONS));
+    report(record, (uint32_t)length, arg);
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_bench_run
+ *******************************************************************************
+ * Summary:
+ *   Runs every kernel on every geometry of the sweep. Samples per chirp and
+ *   chirps per frame are halved from the configured values down to
+ *   BENCH_MIN_SAMPLES_PER_CHIRP and one chirp, the antennas go from one to the
+ *   configured number. Each result is reported as one json record, the last
+ *   record {"done":<n>} carries the number of results.
+ *
+ * Parameters:
+ *   report : callback receiving the json records
+ *   arg    : callback data pointer
+ *
+ * Return:
+ *   number of results
+ ******************************************************************************/
+uint32_t radar_bench_run(radar_bench_report_t report, void *arg)
+{
+    static bench_context_t context;
+    char record[RADAR_BENCH_RECORD_SIZE];
+    uint32_t results = 0;
+    int length;
+
+    radar_cycles_init();
+
+    for (uint16_t samples = BENCH_MAX_SAMPLES_PER_CHIRP; samples > 0; samples /= 2u)
+    {
+        for (uint16_t chirps = BENCH_MAX_CHIRPS_PER_FRAME; chirps > 0; chirps /= 2u)
+        {
+            for (uint8_t antennas = 1; antennas <= BENCH_MAX_RX_ANTENNAS; ++antennas)
+            {
+                context.frame.samples = bench_frame;
+                context.frame.geometry.samples_per_chirp = samples;
+                context.frame.geometry.chirps_per_frame = chirps;
+                context.frame.geometry.rx_antennas = antennas;
+                context.frame.num_samples = (uint32_t)samples * chirps * antennas;
+                context.frame.decimation = 1;
+                context.frame.flags = 0;
+                radar_roi_reset(&context.frame.roi, &context.frame.geometry);
+
+                for (uint32_t i = 0; i < (sizeof(bench_kernels) / sizeof(bench_kernels[0])); ++i)
+                {
+                    if (bench_kernel(&bench_kernels[i], &context, report, arg))
+                    {
+                        results++;
+                    }
+                }
+            }
+
+            if ((chirps % 2u) != 0)
+            {
+                break;
+            }
+        }
+
+        if (((samples % 2u) != 0) || ((samples / 2u) < BENCH_MIN_SAMPLES_PER_CHIRP))
+        {
+            break;
+        }
+    }
+
+    length = snprintf(record, sizeof(record), "{\"done\":%" PRIu32 "}", results);
+    report(record, (uint32_t)length, arg);
+
+    return results;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,54 @@
+/******************************************************************************
+ * File Name:   radar_bench.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_bench.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_BENCH_H_
+#define RADAR_BENCH_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Number of timed runs of every kernel per geometry */
+#define RADAR_BENCH_ITERATIONS      (16u)
+
+/* Size of one json result record including the terminating zero */
+#define RADAR_BENCH_RECORD_SIZE     (160u)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Called once per json record, the record is only valid during the call */
+typedef void (*radar_bench_report_t)(const char *record, uint32_t length, void *arg);
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+uint32_t radar_bench_run(radar_bench_report_t report, void *arg);
+
+#endif /* RADAR_BENCH_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,275 @@
+/*****************************************************************************
+ * File name: radar_cfar.c
+ *
+ * Description: This file implements the cell averaging CFAR detector and the
+ * target list encoding.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+
+/* Header file for local module */
+#include "radar_cfar.h"
+#include "radar_frame.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* The threshold scale is a Q8 fixed point factor */
+#define CFAR_SCALE_SHIFT                (8)
+
+/*******************************************************************************
+ * Function Name: radar_cfar_config_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks the detector settings against their limits.
+ *
+ * Parameters:
+ *   config : detector settings
+ *
+ * Return:
+ *   true if the settings are valid
+ ******************************************************************************/
+bool radar_cfar_config_is_valid(const radar_cfar_config_t *config)
+{
+    return (config->guard_cells <= RADAR_CFAR_MAX_GUARD_CELLS) &&
+           (config->training_cells >= RADAR_CFAR_MIN_TRAINING_CELLS) &&
+           (config->training_cells <= RADAR_CFAR_MAX_TRAINING_CELLS) &&
+           (config->threshold_db <= RADAR_CFAR_MAX_THRESHOLD_DB);
+}
+
+/*******************************************************************************
+ * Function Name: radar_cfar_scale
+ *******************************************************************************
+ * Summary:
+ *   Converts the detection threshold to the factor applied to the noise
+ *   estimate. Evaluated once per setting change, not per frame.
+ *
+ * Parameters:
+ *   threshold_db : threshold above the noise estimate
+ *
+ * Return:
+ *   linear factor in Q8
+ ******************************************************************************/
+uint32_t radar_cfar_scale(uint8_t threshold_db)
+{
+    return (uint32_t)((powf(10.0f, (float)threshold_db / 10.0f) * (float)(1u << CFAR_SCALE_SHIFT)) + 0.5f);
+}
+
+/*******************************************************************************
+ * Function Name: add_target
+ *******************************************************************************
+ * Summary:
+ *   Adds a detection to the target list. A full list keeps the strongest
+ *   targets.
+ ******************************************************************************/
+static uint32_t add_target(radar_target_t *targets, uint32_t num_targets, uint32_t max_targets,
+                           uint16_t range_bin, int16_t doppler_bin, uint32_t power)
+{
+    uint32_t idx = num_targets;
+
+    if (num_targets >= max_targets)
+    {
+        idx = 0;
+        for (uint32_t i = 1; i < num_targets; ++i)
+        {
+            if (targets[i].power < targets[idx].power)
+            {
+                idx = i;
+            }
+        }
+
+        if ((max_targets == 0) || (targets[idx].power >= power))
+        {
+            return num_targets;
+        }
+    }
+    else
+    {
+        num_targets++;
+    }
+
+    targets[idx].range_bin = range_bin;
+    targets[idx].doppler_bin = doppler_bin;
+    targets[idx].power = power;
+    targets[idx].azimuth = RADAR_TARGET_ANGLE_NONE;
+    targets[idx].elevation = RADAR_TARGET_ANGLE_NONE;
+
+    return num_targets;
+}
+
+/*******************************************************************************
+ * Function Name: is_doppler_peak
+ *******************************************************************************
+ * Summary:
+ *   Checks that a cell is not below its neighbours in Doppler, which wrap
+ *   around. Ties go to the lower Doppler bin.
+ ******************************************************************************/
+static bool is_doppler_peak(const uint32_t *power, uint32_t range_bins, uint32_t doppler_bins,
+                            uint32_t range_bin, uint32_t doppler_bin)
+{
+    const uint32_t value = power[(doppler_bin * range_bins) + range_bin];
+    const uint32_t prev = (doppler_bin + doppler_bins - 1u) % doppler_bins;
+    const uint32_t next = (doppler_bin + 1u) % doppler_bins;
+
+    if (doppler_bins < 2u)
+    {
+        return true;
+    }
+
+    return (value >= power[(prev * range_bins) + range_bin]) && (value > power[(next * range_bins) + range_bin]);
+}
+
+/*******************************************************************************
+ * Function Name: radar_cfar_detect
+ *******************************************************************************
+ * Summary:
+ *   Runs the cell averaging CFAR detector along the range bins of every
+ *   Doppler bin of a power map. The noise estimate of a cell is the mean of
+ *   the training cells on both sides beyond the guard cells; at the ends of
+ *   a row only the cells that exist are used. Both window sums slide by one
+ *   cell per step, so the cost is linear in the number of cells whatever the
+ *   window size. A cell is a target if it exceeds the scaled noise estimate
+ *   and is a local peak in range and Doppler.
+ *
+ * Parameters:
+ *   config       : detector settings
+ *   scale        : threshold factor from radar_cfar_scale()
+ *   power        : power map, Doppler bin major
+ *   range_bins   : number of range bins
+ *   doppler_bins : number of Doppler bins in FFT order
+ *   targets      : target list
+ *   max_targets  : capacity of the target list, the strongest targets are kept
+ *
+ * Return:
+ *   number of targets in the list
+ ******************************************************************************/
+uint32_t radar_cfar_detect(const radar_cfar_config_t *config, uint32_t scale, const uint32_t *power,
+                           uint32_t range_bins, uint32_t doppler_bins, radar_target_t *targets,
+                           uint32_t max_targets)
+{
+    const int32_t guard = config->guard_cells;
+    const int32_t training = config->training_cells;
+    const int32_t bins = (int32_t)range_bins;
+    uint32_t num_targets = 0;
+
+    for (uint32_t doppler = 0; doppler < doppler_bins; ++doppler)
+    {
+        const uint32_t *row = &power[doppler * range_bins];
+        const int16_t velocity = (int16_t)((doppler < ((doppler_bins + 1u) / 2u)) ? (int32_t)doppler
+                                           : ((int32_t)doppler - (int32_t)doppler_bins));
+        uint64_t lag_sum = 0;       /* training cells below the cell under test */
+        uint64_t lead_sum = 0;      /* training cells above the cell under test */
+        uint32_t lag_count = 0;
+        uint32_t lead_count = 0;
+
+        for (int32_t i = guard + 1; (i <= (guard + training)) && (i < bins); ++i)
+        {
+            lead_sum += row[i];
+            lead_count++;
+        }
+
+        for (int32_t cell = 0; cell < bins; ++cell)
+        {
+            const uint32_t count = lag_count + lead_count;
+            const uint32_t value = row[cell];
+
+            if ((count > 0) &&
+                ((((uint64_t)value * count) << CFAR_SCALE_SHIFT) > ((lag_sum + lead_sum) * scale)) &&
+                ((cell == 0) || (value >= row[cell - 1])) &&
+                ((cell == (bins - 1)) || (value > row[cell + 1])) &&
+                is_doppler_peak(power, range_bins, doppler_bins, (uint32_t)cell, doppler))
+            {
+                num_targets = add_target(targets, num_targets, max_targets, (uint16_t)cell, velocity, value);
+            }
+
+            /* Slide both windows by one cell */
+            const int32_t lag_in = cell - guard;
+            const int32_t lag_out = cell - guard - training;
+            const int32_t lead_out = cell + guard + 1;
+            const int32_t lead_in = cell + guard + training + 1;
+
+            if (lag_in >= 0)
+            {
+                lag_sum += row[lag_in];
+                lag_count++;
+            }
+            if (lag_out >= 0)
+            {
+                lag_sum -= row[lag_out];
+                lag_count--;
+            }
+            if (lead_out < bins)
+            {
+                lead_sum -= row[lead_out];
+                lead_count--;
+            }
+            if (lead_in < bins)
+            {
+                lead_sum += row[lead_in];
+                lead_count++;
+            }
+        }
+    }
+
+    return num_targets;
+}
+
+/*******************************************************************************
+ * Function Name: radar_cfar_write_targets
+ *******************************************************************************
+ * Summary:
+ *   Encodes a target list, see RADAR_TARGETS_HEADER_SIZE for the layout.
+ *
+ * Parameters:
+ *   data             : output, RADAR_TARGETS_SIZE(num_targets) bytes
+ *   targets          : target list
+ *   num_targets      : number of targets
+ *   range_fft_log2   : log2 of the range FFT size
+ *   doppler_fft_log2 : log2 of the Doppler FFT size
+ *
+ * Return:
+ *   number of bytes written
+ ******************************************************************************/
+uint32_t radar_cfar_write_targets(uint8_t *data, const radar_target_t *targets, uint32_t num_targets,
+                                  uint8_t range_fft_log2, uint8_t doppler_fft_log2)
+{
+    radar_frame_put_u16(&data[0], (uint16_t)num_targets);
+    data[2] = range_fft_log2;
+    data[3] = doppler_fft_log2;
+    data += RADAR_TARGETS_HEADER_SIZE;
+
+    for (uint32_t i = 0; i < num_targets; ++i)
+    {
+        radar_frame_put_u16(&data[0], targets[i].range_bin);
+        radar_frame_put_u16(&data[2], (uint16_t)targets[i].doppler_bin);
+        radar_frame_put_u32(&data[4], targets[i].power);
+        radar_frame_put_u16(&data[8], (uint16_t)targets[i].azimuth);
+        radar_frame_put_u16(&data[10], (uint16_t)targets[i].elevation);
+        data += RADAR_TARGET_SIZE;
+    }
+
+    return RADAR_TARGETS_SIZE(num_targets);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * File Name:   radar_cfar.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_cfar.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_CFAR_H_
+#define RADAR_CFAR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RADAR_CFAR_MAX_GUARD_CELLS      (16)
+#define RADAR_CFAR_MIN_TRAINING_CELLS   (1)
+#define RADAR_CFAR_MAX_TRAINING_CELLS   (32)
+#define RADAR_CFAR_MAX_THRESHOLD_DB     (30)
+
+#define RADAR_CFAR_DEFAULT_GUARD_CELLS      (2)
+#define RADAR_CFAR_DEFAULT_TRAINING_CELLS   (8)
+#define RADAR_CFAR_DEFAULT_THRESHOLD_DB     (12)
+
+/* Angle of a target whose antennas were not received */
+#define RADAR_TARGET_ANGLE_NONE         (INT16_MIN)
+
+/* Most targets reported per frame */
+#define RADAR_CFAR_MAX_TARGETS          (32)
+
+/* Target list layout, all multi-byte fields are little endian:
+ *   [0..1]   number of targets
+ *   [2]      log2 of the range FFT size
+ *   [3]      log2 of the Doppler FFT size
+ * followed by one entry per target:
+ *   [0..1]   range bin
+ *   [2..3]   Doppler bin, signed
+ *   [4..7]   power
+ *   [8..9]   azimuth in 0.01 degrees, signed
+ *   [10..11] elevation in 0.01 degrees, signed */
+#define RADAR_TARGETS_HEADER_SIZE       (4)
+#define RADAR_TARGET_SIZE               (12)
+#define RADAR_TARGETS_SIZE(num_targets) (RADAR_TARGETS_HEADER_SIZE + ((num_targets) * RADAR_TARGET_SIZE))
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t guard_cells;        /* cells next to the cell under test left out on each side */
+    uint8_t training_cells;     /* cells averaged on each side */
+    uint8_t threshold_db;       /* detection threshold above the noise estimate */
+} radar_cfar_config_t;
+
+typedef struct
+{
+    uint16_t range_bin;
+    int16_t doppler_bin;
+    uint32_t power;
+    int16_t azimuth;            /* 0.01 degrees or RADAR_TARGET_ANGLE_NONE */
+    int16_t elevation;
+} radar_target_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+bool radar_cfar_config_is_valid(const radar_cfar_config_t *config);
+uint32_t radar_cfar_scale(uint8_t threshold_db);
+uint32_t radar_cfar_detect(const radar_cfar_config_t *config, uint32_t scale, const uint32_t *power,
+                           uint32_t range_bins, uint32_t doppler_bins, radar_target_t *targets,
+                           uint32_t max_targets);
+uint32_t radar_cfar_write_targets(uint8_t *data, const radar_target_t *targets, uint32_t num_targets,
+                                  uint8_t range_fft_log2, uint8_t doppler_fft_log2);
+
+#endif /* RADAR_CFAR_H_ */
+/* [] END OF FILE */
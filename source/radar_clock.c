@@ -0,0 +1,159 @@
+/*****************************************************************************
+ * File name: radar_clock.c
+ *
+ * Description: This file implements the microsecond device clock that
+ * timestamps frames and the time exchange with the host.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file includes */
+#include "cyhal.h"
+
+/* Header file from library */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Header file for local module */
+#include "radar_clock.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define CLOCK_FREQUENCY_HZ              (1000000u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static cyhal_timer_t clock_timer;
+
+/* The 32-bit timer wraps every 71 minutes. It is extended to 64 bits on
+ * every read, which happens at least once per frame and per time exchange. */
+static uint32_t clock_last_count = 0;
+static uint64_t clock_wraps = 0;
+
+/*******************************************************************************
+ * Function Name: clock_extend
+ *******************************************************************************
+ * Summary:
+ *   Reads the timer and extends it to 64 bits. Called with interrupts
+ *   masked.
+ ******************************************************************************/
+static uint64_t clock_extend(void)
+{
+    const uint32_t count = cyhal_timer_read(&clock_timer);
+
+    if (count < clock_last_count)
+    {
+        clock_wraps += (uint64_t)1u << 32;
+    }
+    clock_last_count = count;
+
+    return clock_wraps + count;
+}
+
+/*******************************************************************************
+ * Function Name: radar_clock_init
+ *******************************************************************************
+ * Summary:
+ *   Starts a free running 1 MHz timer as device clock.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   error
+ ******************************************************************************/
+cy_rslt_t radar_clock_init(void)
+{
+    const cyhal_timer_cfg_t config = {
+        .compare_value = 0,
+        .period = UINT32_MAX,
+        .direction = CYHAL_TIMER_DIR_UP,
+        .is_compare = false,
+        .is_continuous = true,
+        .value = 0
+    };
+    cy_rslt_t result;
+
+    result = cyhal_timer_init(&clock_timer, NC, NULL);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cyhal_timer_configure(&clock_timer, &config);
+    }
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cyhal_timer_set_frequency(&clock_timer, CLOCK_FREQUENCY_HZ);
+    }
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cyhal_timer_start(&clock_timer);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_clock_now_us
+ *******************************************************************************
+ * Summary:
+ *   Reads the device clock from a task.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   microseconds since radar_clock_init()
+ ******************************************************************************/
+uint64_t radar_clock_now_us(void)
+{
+    uint64_t now;
+
+    taskENTER_CRITICAL();
+    now = clock_extend();
+    taskEXIT_CRITICAL();
+
+    return now;
+}
+
+/*******************************************************************************
+ * Function Name: radar_clock_now_us_from_isr
+ *******************************************************************************
+ * Summary:
+ *   Reads the device clock from an interrupt handler.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   microseconds since radar_clock_init()
+ ******************************************************************************/
+uint64_t radar_clock_now_us_from_isr(void)
+{
+    UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+    uint64_t now = clock_extend();
+
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+
+    return now;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,43 @@
+/******************************************************************************
+ * File Name:   radar_clock.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_clock.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_CLOCK_H_
+#define RADAR_CLOCK_H_
+
+#include <stdint.h>
+
+#include "cy_result.h"
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+cy_rslt_t radar_clock_init(void);
+uint64_t radar_clock_now_us(void);
+uint64_t radar_clock_now_us_from_isr(void);
+
+#endif /* RADAR_CLOCK_H_ */
+/* [] END OF FILE */
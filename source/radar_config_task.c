@@ -27,6 +27,8 @@
  */
 
 /* Header file from system */
+#include <errno.h>
+#include <inttypes.h>
 #include "stdbool.h"
 #include "stdio.h"
 #include "stdlib.h"
@@ -38,7 +40,14 @@
 #include "rtos_artifacts.h"
 
 /* Header file for local tasks */
+#include "radar_bench.h"
 #include "radar_config_task.h"
+#include "radar_decim.h"
+#include "radar_fifo.h"
+#include "radar_handoff.h"
+#include "radar_link.h"
+#include "radar_memory.h"
+#include "radar_profile.h"
 #include "radar_task.h"
 #include "udp_server.h"
 
@@ -48,16 +57,1264 @@
 #define DISABLE_STRING ("disable")
 #define TEST_STRING ("test")
 
+/* Strings objects for the region of interest, values are numbers */
+#define ROI_ANTENNAS_STRING ("roi_antennas")
+#define ROI_CHIRP_STRIDE_STRING ("roi_chirp_stride")
+#define ROI_SAMPLE_START_STRING ("roi_sample_start")
+#define ROI_SAMPLE_COUNT_STRING ("roi_sample_count")
+
+/* Strings object for the decimation factor, value is a number */
+#define DECIMATION_STRING ("decimation")
+
+/* Strings objects for the static clutter removal */
+#define MTI_STRING ("mti")
+#define MTI_ALPHA_SHIFT_STRING ("mti_alpha_shift")
+#define MTI_THRESHOLD_STRING ("mti_threshold")
+
+/* Strings objects for the target detector, values are numbers */
+#define CFAR_GUARD_CELLS_STRING ("cfar_guard_cells")
+#define CFAR_TRAINING_CELLS_STRING ("cfar_training_cells")
+#define CFAR_THRESHOLD_DB_STRING ("cfar_threshold_db")
+
+/* Strings objects for the tracker, values are numbers */
+#define TRACK_INTERVAL_STRING ("track_interval")
+#define TRACK_GATE_STRING ("track_gate")
+
+/* Strings object for the range bin of the vital signs, value is a number */
+#define VITAL_RANGE_BIN_STRING ("vital_range_bin")
+
+/* Strings objects for the micro-Doppler spectrogram, values are numbers */
+#define SPECTRO_RANGE_BIN_STRING ("spectro_range_bin")
+#define SPECTRO_RANGE_BINS_STRING ("spectro_range_bins")
+#define SPECTRO_WINDOW_STRING ("spectro_window")
+#define SPECTRO_HOP_STRING ("spectro_hop")
+
+/* Strings objects and values for the processing pipeline and its statistics */
+#define PIPELINE_STRING ("pipeline")
+#define STATS_STRING ("stats")
+#define GET_STRING ("get")
+
+/* Strings object and value for the kernel benchmark */
+#define BENCH_STRING ("bench")
+#define RUN_STRING ("run")
+
+/* Strings object for the time exchange with the client, value is a number */
+#define SYNC_INTERVAL_STRING ("sync_interval")
+
+/* Strings objects for the parity over the frame datagrams, values are numbers */
+#define FEC_GROUP_STRING ("fec_group")
+#define FEC_PARITY_STRING ("fec_parity")
+
+/* Strings objects for the retransmission of lost frame datagrams, values are numbers */
+#define RESEND_DEPTH_STRING ("resend_depth")
+#define RESEND_BUDGET_STRING ("resend_budget")
+
+/* Strings object for the drain rate of the frames kept during a Wi-Fi outage */
+#define BACKLOG_RATE_STRING ("backlog_rate")
+
+/* Strings object and values for the transport of the frame datagrams */
+#define TRANSPORT_STRING ("transport")
+#define UDP_STRING ("udp")
+#define TCP_STRING ("tcp")
+
+/* Strings object and values for the hand-off of the frames to the UDP server */
+#define HANDOFF_STRING ("handoff")
+#define QUEUE_STRING ("queue")
+#define LATEST_STRING ("latest")
+
+/* Strings object for the simulated sensor FIFO overflows, value is a number */
+#define FIFO_INJECT_STRING ("fifo_inject")
+
+/* Strings object for the radar profile, value is the profile id */
+#define PROFILE_STRING ("profile")
+
+/* Strings objects for the link capacity test, the values of the run are
+ * numbers, the test is started with "run" and ended with "stop" */
+#define LINK_SIZE_STRING ("link_size")
+#define LINK_BATCH_STRING ("link_batch")
+#define LINK_RATE_STRING ("link_rate")
+#define LINK_COUNT_STRING ("link_count")
+#define LINK_TEST_STRING ("link_test")
+#define STOP_STRING ("stop")
+
+/* Strings objects for the multicast frame stream, the group is a dotted IPv4
+ * address or "disable", the port and the TTL are numbers */
+#define MULTICAST_STRING ("multicast")
+#define MULTICAST_PORT_STRING ("multicast_port")
+#define MULTICAST_TTL_STRING ("multicast_ttl")
+
+/* Strings objects for the client lease, the duration is a number in ms and
+ * stopping the sensor on expiry is "enable" or "disable" */
+#define LEASE_STRING ("lease")
+#define LEASE_STOP_STRING ("lease_stop")
+
 #define RADAR_STR_LENGTH strlen(RADAR_STRING)
 #define ENABLE_STR_LENGTH strlen(ENABLE_STRING)
 #define DISABLE_STR_LENGTH strlen(DISABLE_STRING)
 #define TEST_STR_LENGTH strlen(TEST_STRING)
 
+/* Size of the statistics reply including the command and dummy bytes */
+#define STATS_BUFFER_SIZE (1536)
+
+/* Benchmark records in flight: the radar data queue, the one the UDP server
+ * is sending and the one being written */
+#define BENCH_MSG_COUNT (RADAR_MEMORY_DATA_QUEUE_LENGTH + 2u)
+#define BENCH_BUFFER_SIZE (2 + RADAR_BENCH_RECORD_SIZE)
+#define BENCH_QUEUE_TIMEOUT_MS (1000)
+
+/* Longest number accepted as a configuration value */
+#define MAX_NUMBER_STR_LENGTH (10)
+
+/* Longest dotted IPv4 address accepted as a configuration value */
+#define MAX_IPV4_STR_LENGTH (15)
+
+/* Settings present in a message */
+#define SETTING_ROI_ANTENNAS        (1ull << 0)
+#define SETTING_ROI_CHIRP_STRIDE    (1ull << 1)
+#define SETTING_ROI_SAMPLE_START    (1ull << 2)
+#define SETTING_ROI_SAMPLE_COUNT    (1ull << 3)
+#define SETTING_DECIMATION          (1ull << 4)
+#define SETTING_MTI_ENABLE          (1ull << 5)
+#define SETTING_MTI_ALPHA_SHIFT     (1ull << 6)
+#define SETTING_MTI_THRESHOLD       (1ull << 7)
+#define SETTING_CFAR_GUARD_CELLS    (1ull << 8)
+#define SETTING_CFAR_TRAINING_CELLS (1ull << 9)
+#define SETTING_CFAR_THRESHOLD_DB   (1ull << 10)
+#define SETTING_VITAL_RANGE_BIN     (1ull << 11)
+#define SETTING_SPECTRO_RANGE_BIN   (1ull << 12)
+#define SETTING_SPECTRO_RANGE_BINS  (1ull << 13)
+#define SETTING_SPECTRO_WINDOW      (1ull << 14)
+#define SETTING_SPECTRO_HOP         (1ull << 15)
+#define SETTING_TRACK_INTERVAL      (1ull << 16)
+#define SETTING_TRACK_GATE          (1ull << 17)
+#define SETTING_SYNC_INTERVAL       (1ull << 18)
+#define SETTING_FEC_GROUP           (1ull << 19)
+#define SETTING_FEC_PARITY          (1ull << 20)
+#define SETTING_RESEND_DEPTH        (1ull << 21)
+#define SETTING_RESEND_BUDGET       (1ull << 22)
+#define SETTING_TRANSPORT           (1ull << 23)
+#define SETTING_HANDOFF             (1ull << 24)
+#define SETTING_FIFO_INJECT         (1ull << 25)
+#define SETTING_PROFILE             (1ull << 26)
+#define SETTING_LINK_SIZE           (1ull << 27)
+#define SETTING_LINK_BATCH          (1ull << 28)
+#define SETTING_LINK_RATE           (1ull << 29)
+#define SETTING_LINK_COUNT          (1ull << 30)
+#define SETTING_LINK_TEST           (1ull << 31)
+#define SETTING_MULTICAST_GROUP     (1ull << 32)
+#define SETTING_MULTICAST_PORT      (1ull << 33)
+#define SETTING_MULTICAST_TTL       (1ull << 34)
+#define SETTING_LEASE_DURATION      (1ull << 35)
+#define SETTING_LEASE_STOP          (1ull << 36)
+#define SETTING_BACKLOG_RATE        (1ull << 37)
+
+#define SETTING_ROI                 (SETTING_ROI_ANTENNAS | SETTING_ROI_CHIRP_STRIDE | \
+                                     SETTING_ROI_SAMPLE_START | SETTING_ROI_SAMPLE_COUNT)
+#define SETTING_MTI                 (SETTING_MTI_ENABLE | SETTING_MTI_ALPHA_SHIFT | SETTING_MTI_THRESHOLD)
+#define SETTING_CFAR                (SETTING_CFAR_GUARD_CELLS | SETTING_CFAR_TRAINING_CELLS | \
+                                     SETTING_CFAR_THRESHOLD_DB)
+#define SETTING_SPECTRO             (SETTING_SPECTRO_RANGE_BIN | SETTING_SPECTRO_RANGE_BINS | \
+                                     SETTING_SPECTRO_WINDOW | SETTING_SPECTRO_HOP)
+#define SETTING_TRACK               (SETTING_TRACK_INTERVAL | SETTING_TRACK_GATE)
+#define SETTING_FEC                 (SETTING_FEC_GROUP | SETTING_FEC_PARITY)
+#define SETTING_RESEND              (SETTING_RESEND_DEPTH | SETTING_RESEND_BUDGET)
+#define SETTING_LINK                (SETTING_LINK_SIZE | SETTING_LINK_BATCH | SETTING_LINK_RATE | \
+                                     SETTING_LINK_COUNT | SETTING_LINK_TEST)
+#define SETTING_MULTICAST           (SETTING_MULTICAST_GROUP | SETTING_MULTICAST_PORT | SETTING_MULTICAST_TTL)
+#define SETTING_LEASE               (SETTING_LEASE_DURATION | SETTING_LEASE_STOP)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Settings collected from the keys of one message. They are applied together
+ * once the whole message is parsed, so the order of the keys does not
+ * matter. */
+typedef struct
+{
+    uint64_t fields;            /* SETTING_* bits of the values present */
+    radar_roi_t roi;
+    uint8_t decimation;
+    radar_mti_config_t mti;
+    radar_cfar_config_t cfar;
+    radar_track_config_t track;
+    uint16_t vital_range_bin;
+    radar_spectro_config_t spectro;
+    uint32_t sync_interval;
+    radar_fec_config_t fec;
+    radar_resend_config_t resend;
+    uint8_t transport;
+    uint8_t handoff;
+    uint16_t fifo_inject;
+    uint8_t profile;
+    radar_link_config_t link;
+    bool link_run;              /* link_test is "run", else "stop" */
+    udp_server_multicast_t multicast;
+    udp_server_lease_t lease;
+    uint16_t backlog_rate;
+} pending_settings_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+TaskHandle_t radar_config_task_handle = NULL;
+
+static pending_settings_t pending;
+
+/* The client enabled the radar, and the sensor is stopped because the
+ * client lease expired */
+static bool radar_enabled = false;
+static bool lease_suspended = false;
+
+/* Settings of the next link test run, link_* keys missing from a message
+ * keep the value of the previous run */
+static radar_link_config_t link_config = {
+    .size = RADAR_LINK_DEFAULT_SIZE,
+    .batch = RADAR_LINK_DEFAULT_BATCH,
+    .rate = RADAR_LINK_DEFAULT_RATE,
+    .count = RADAR_LINK_DEFAULT_COUNT
+};
+
+/* Statistics reply sent through the radar data queue */
+static uint8_t stats_buffer[STATS_BUFFER_SIZE];
+static publisher_data_t stats_msg = {
+    .cmd = RADAR_STATS_COMMAND,
+    .data = stats_buffer,
+    .length = 0
+};
+static publisher_data_t *stats_msg_ptr = &stats_msg;
+
+/* Benchmark records, reused round robin */
+static uint8_t bench_buffers[BENCH_MSG_COUNT][BENCH_BUFFER_SIZE];
+static publisher_data_t bench_msgs[BENCH_MSG_COUNT];
+static uint32_t bench_msg_idx = 0;
+
+/* {"bench":"run"} was received, the benchmark runs after the parsing */
+static bool bench_requested = false;
+
+/*******************************************************************************
+ * Function Name: json_key_matches
+ *******************************************************************************
+ * Summary:
+ *   Compares the key of a json object with a string.
+ *
+ * Parameters:
+ *      json_object: incoming json object
+ *      key: expected key
+ *
+ * Return:
+ *   true if the key matches
+ ******************************************************************************/
+static bool json_key_matches(const cy_JSON_object_t *json_object, const char *key)
+{
+    return (json_object->object_string_length == strlen(key)) &&
+           (memcmp(json_object->object_string, key, json_object->object_string_length) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: json_value_matches
+ *******************************************************************************
+ * Summary:
+ *   Compares the value of a json object with a string.
+ *
+ * Parameters:
+ *      json_object: incoming json object
+ *      value: expected value
+ *
+ * Return:
+ *   true if the value matches
+ ******************************************************************************/
+static bool json_value_matches(const cy_JSON_object_t *json_object, const char *value)
+{
+    return (json_object->value_length == strlen(value)) &&
+           (memcmp(json_object->value, value, json_object->value_length) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: json_value_to_uint
+ *******************************************************************************
+ * Summary:
+ *   Converts the value of a json object to an unsigned decimal number. Signs,
+ *   leading blanks, other bases and values beyond unsigned long are refused.
+ *
+ * Parameters:
+ *      json_object: incoming json object
+ *      max: largest accepted value
+ *      value: converted value
+ *
+ * Return:
+ *   true if the value is a number within range
+ ******************************************************************************/
+static bool json_value_to_uint(const cy_JSON_object_t *json_object, uint32_t max, uint32_t *value)
+{
+    char number[MAX_NUMBER_STR_LENGTH + 1];
+    char *end;
+    unsigned long result;
+
+    if ((json_object->value_length == 0) || (json_object->value_length > MAX_NUMBER_STR_LENGTH))
+    {
+        return false;
+    }
+
+    memcpy(number, json_object->value, json_object->value_length);
+    number[json_object->value_length] = '\0';
+
+    if ((number[0] < '0') || (number[0] > '9'))
+    {
+        return false;
+    }
+
+    errno = 0;
+    result = strtoul(number, &end, 10);
+    if ((errno == ERANGE) || (*end != '\0') || (result > max))
+    {
+        return false;
+    }
+
+    *value = (uint32_t)result;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: json_value_to_ipv4
+ *******************************************************************************
+ * Summary:
+ *   Converts the value of a json object from a dotted IPv4 address. The first
+ *   byte of the address is stored in the least significant byte, as in
+ *   cy_socket_ip_address_t.
+ *
+ * Parameters:
+ *      json_object: incoming json object
+ *      address: converted address
+ *
+ * Return:
+ *   true if the value is a dotted IPv4 address
+ ******************************************************************************/
+static bool json_value_to_ipv4(const cy_JSON_object_t *json_object, uint32_t *address)
+{
+    char text[MAX_IPV4_STR_LENGTH + 1];
+    char *start = text;
+    char *end;
+    unsigned long octet;
+    uint32_t result = 0;
+
+    if ((json_object->value_length == 0) || (json_object->value_length > MAX_IPV4_STR_LENGTH))
+    {
+        return false;
+    }
+
+    memcpy(text, json_object->value, json_object->value_length);
+    text[json_object->value_length] = '\0';
+
+    for (uint32_t i = 0; i < 4u; i++)
+    {
+        if ((*start < '0') || (*start > '9'))
+        {
+            return false;
+        }
+        octet = strtoul(start, &end, 10);
+        if ((octet > UINT8_MAX) || (*end != ((i < 3u) ? '.' : '\0')))
+        {
+            return false;
+        }
+        result |= (uint32_t)octet << (8u * i);
+        start = end + 1;
+    }
+
+    *address = result;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: parse_setting_value
+ *******************************************************************************
+ * Summary:
+ *   Collects a numeric processing setting from one json object.
+ *
+ * Parameters:
+ *      json_object: incoming json object
+ *
+ * Return:
+ *   true if the key is a known setting
+ ******************************************************************************/
+static bool parse_setting_value(const cy_JSON_object_t *json_object)
+{
+    uint32_t value;
+    uint64_t field;
+    uint32_t max;
+
+    if (json_key_matches(json_object, ROI_ANTENNAS_STRING))
+    {
+        field = SETTING_ROI_ANTENNAS;
+        max = UINT8_MAX;
+    }
+    else if (json_key_matches(json_object, ROI_CHIRP_STRIDE_STRING))
+    {
+        field = SETTING_ROI_CHIRP_STRIDE;
+        max = UINT8_MAX;
+    }
+    else if (json_key_matches(json_object, ROI_SAMPLE_START_STRING))
+    {
+        field = SETTING_ROI_SAMPLE_START;
+        max = UINT16_MAX;
+    }
+    else if (json_key_matches(json_object, ROI_SAMPLE_COUNT_STRING))
+    {
+        field = SETTING_ROI_SAMPLE_COUNT;
+        max = UINT16_MAX;
+    }
+    else if (json_key_matches(json_object, DECIMATION_STRING))
+    {
+        field = SETTING_DECIMATION;
+        max = RADAR_DECIM_MAX_FACTOR;
+    }
+    else if (json_key_matches(json_object, MTI_ALPHA_SHIFT_STRING))
+    {
+        field = SETTING_MTI_ALPHA_SHIFT;
+        max = RADAR_MTI_MAX_ALPHA_SHIFT;
+    }
+    else if (json_key_matches(json_object, MTI_THRESHOLD_STRING))
+    {
+        field = SETTING_MTI_THRESHOLD;
+        max = UINT32_MAX;
+    }
+    else if (json_key_matches(json_object, CFAR_GUARD_CELLS_STRING))
+    {
+        field = SETTING_CFAR_GUARD_CELLS;
+        max = RADAR_CFAR_MAX_GUARD_CELLS;
+    }
+    else if (json_key_matches(json_object, CFAR_TRAINING_CELLS_STRING))
+    {
+        field = SETTING_CFAR_TRAINING_CELLS;
+        max = RADAR_CFAR_MAX_TRAINING_CELLS;
+    }
+    else if (json_key_matches(json_object, CFAR_THRESHOLD_DB_STRING))
+    {
+        field = SETTING_CFAR_THRESHOLD_DB;
+        max = RADAR_CFAR_MAX_THRESHOLD_DB;
+    }
+    else if (json_key_matches(json_object, TRACK_INTERVAL_STRING))
+    {
+        field = SETTING_TRACK_INTERVAL;
+        max = RADAR_TRACK_MAX_INTERVAL;
+    }
+    else if (json_key_matches(json_object, TRACK_GATE_STRING))
+    {
+        field = SETTING_TRACK_GATE;
+        max = RADAR_TRACK_MAX_GATE;
+    }
+    else if (json_key_matches(json_object, VITAL_RANGE_BIN_STRING))
+    {
+        field = SETTING_VITAL_RANGE_BIN;
+        max = UINT16_MAX;
+    }
+    else if (json_key_matches(json_object, SYNC_INTERVAL_STRING))
+    {
+        field = SETTING_SYNC_INTERVAL;
+        max = RADAR_SYNC_MAX_INTERVAL_MS;
+    }
+    else if (json_key_matches(json_object, FEC_GROUP_STRING))
+    {
+        field = SETTING_FEC_GROUP;
+        max = RADAR_FEC_MAX_GROUP;
+    }
+    else if (json_key_matches(json_object, FEC_PARITY_STRING))
+    {
+        field = SETTING_FEC_PARITY;
+        max = RADAR_FEC_MAX_PARITY;
+    }
+    else if (json_key_matches(json_object, RESEND_DEPTH_STRING))
+    {
+        field = SETTING_RESEND_DEPTH;
+        max = RADAR_RESEND_MAX_DEPTH;
+    }
+    else if (json_key_matches(json_object, RESEND_BUDGET_STRING))
+    {
+        field = SETTING_RESEND_BUDGET;
+        max = RADAR_RESEND_MAX_BUDGET;
+    }
+    else if (json_key_matches(json_object, FIFO_INJECT_STRING))
+    {
+        field = SETTING_FIFO_INJECT;
+        max = RADAR_FIFO_MAX_INJECT_INTERVAL;
+    }
+    else if (json_key_matches(json_object, PROFILE_STRING))
+    {
+        field = SETTING_PROFILE;
+        max = RADAR_PROFILE_COUNT - 1u;
+    }
+    else if (json_key_matches(json_object, LINK_SIZE_STRING))
+    {
+        field = SETTING_LINK_SIZE;
+        max = RADAR_LINK_MAX_SIZE;
+    }
+    else if (json_key_matches(json_object, LINK_BATCH_STRING))
+    {
+        field = SETTING_LINK_BATCH;
+        max = RADAR_LINK_MAX_BATCH;
+    }
+    else if (json_key_matches(json_object, LINK_RATE_STRING))
+    {
+        field = SETTING_LINK_RATE;
+        max = RADAR_LINK_MAX_RATE;
+    }
+    else if (json_key_matches(json_object, LINK_COUNT_STRING))
+    {
+        field = SETTING_LINK_COUNT;
+        max = RADAR_LINK_MAX_COUNT;
+    }
+    else if (json_key_matches(json_object, MULTICAST_PORT_STRING))
+    {
+        field = SETTING_MULTICAST_PORT;
+        max = UINT16_MAX;
+    }
+    else if (json_key_matches(json_object, MULTICAST_TTL_STRING))
+    {
+        field = SETTING_MULTICAST_TTL;
+        max = UINT8_MAX;
+    }
+    else if (json_key_matches(json_object, LEASE_STRING))
+    {
+        field = SETTING_LEASE_DURATION;
+        max = UDP_SERVER_LEASE_MAX_MS;
+    }
+    else if (json_key_matches(json_object, BACKLOG_RATE_STRING))
+    {
+        field = SETTING_BACKLOG_RATE;
+        max = RADAR_WIFI_MAX_RATE;
+    }
+    else if (json_key_matches(json_object, SPECTRO_RANGE_BIN_STRING))
+    {
+        field = SETTING_SPECTRO_RANGE_BIN;
+        max = UINT16_MAX;
+    }
+    else if (json_key_matches(json_object, SPECTRO_RANGE_BINS_STRING))
+    {
+        field = SETTING_SPECTRO_RANGE_BINS;
+        max = RADAR_SPECTRO_MAX_RANGE_BINS;
+    }
+    else if (json_key_matches(json_object, SPECTRO_WINDOW_STRING))
+    {
+        field = SETTING_SPECTRO_WINDOW;
+        max = RADAR_SPECTRO_MAX_WINDOW;
+    }
+    else if (json_key_matches(json_object, SPECTRO_HOP_STRING))
+    {
+        field = SETTING_SPECTRO_HOP;
+        max = RADAR_SPECTRO_MAX_WINDOW;
+    }
+    else if (json_key_matches(json_object, MTI_STRING))
+    {
+        if (json_value_matches(json_object, ENABLE_STRING) || json_value_matches(json_object, DISABLE_STRING))
+        {
+            pending.mti.enabled = json_value_matches(json_object, ENABLE_STRING);
+            pending.fields |= SETTING_MTI_ENABLE;
+        }
+        else
+        {
+            printf("Invalid setting value \r\n");
+        }
+        return true;
+    }
+    else if (json_key_matches(json_object, TRANSPORT_STRING))
+    {
+        if (json_value_matches(json_object, UDP_STRING) || json_value_matches(json_object, TCP_STRING))
+        {
+            pending.transport = json_value_matches(json_object, TCP_STRING) ? UDP_SERVER_TRANSPORT_TCP
+                                                                            : UDP_SERVER_TRANSPORT_UDP;
+            pending.fields |= SETTING_TRANSPORT;
+        }
+        else
+        {
+            printf("Invalid setting value \r\n");
+        }
+        return true;
+    }
+    else if (json_key_matches(json_object, HANDOFF_STRING))
+    {
+        if (json_value_matches(json_object, QUEUE_STRING) || json_value_matches(json_object, LATEST_STRING))
+        {
+            pending.handoff = json_value_matches(json_object, LATEST_STRING) ? RADAR_HANDOFF_LATEST
+                                                                             : RADAR_HANDOFF_QUEUE;
+            pending.fields |= SETTING_HANDOFF;
+        }
+        else
+        {
+            printf("Invalid setting value \r\n");
+        }
+        return true;
+    }
+    else if (json_key_matches(json_object, LINK_TEST_STRING))
+    {
+        if (json_value_matches(json_object, RUN_STRING) || json_value_matches(json_object, STOP_STRING))
+        {
+            pending.link_run = json_value_matches(json_object, RUN_STRING);
+            pending.fields |= SETTING_LINK_TEST;
+        }
+        else
+        {
+            printf("Invalid setting value \r\n");
+        }
+        return true;
+    }
+    else if (json_key_matches(json_object, LEASE_STOP_STRING))
+    {
+        if (json_value_matches(json_object, ENABLE_STRING) || json_value_matches(json_object, DISABLE_STRING))
+        {
+            pending.lease.stop_radar = json_value_matches(json_object, ENABLE_STRING);
+            pending.fields |= SETTING_LEASE_STOP;
+        }
+        else
+        {
+            printf("Invalid setting value \r\n");
+        }
+        return true;
+    }
+    else if (json_key_matches(json_object, MULTICAST_STRING))
+    {
+        if (json_value_matches(json_object, DISABLE_STRING))
+        {
+            pending.multicast.enabled = false;
+            pending.fields |= SETTING_MULTICAST_GROUP;
+        }
+        else if (json_value_to_ipv4(json_object, &pending.multicast.group))
+        {
+            pending.multicast.enabled = true;
+            pending.fields |= SETTING_MULTICAST_GROUP;
+        }
+        else
+        {
+            printf("Invalid setting value \r\n");
+        }
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (!json_value_to_uint(json_object, max, &value))
+    {
+        printf("Invalid setting value \r\n");
+        return true;
+    }
+
+    switch (field)
+    {
+        case SETTING_ROI_ANTENNAS:
+            pending.roi.antenna_mask = (uint8_t)value;
+            break;
+        case SETTING_ROI_CHIRP_STRIDE:
+            pending.roi.chirp_stride = (uint8_t)value;
+            break;
+        case SETTING_ROI_SAMPLE_START:
+            pending.roi.sample_start = (uint16_t)value;
+            break;
+        case SETTING_ROI_SAMPLE_COUNT:
+            pending.roi.sample_count = (uint16_t)value;
+            break;
+        case SETTING_DECIMATION:
+            pending.decimation = (uint8_t)value;
+            break;
+        case SETTING_MTI_ALPHA_SHIFT:
+            pending.mti.alpha_shift = (uint8_t)value;
+            break;
+        case SETTING_MTI_THRESHOLD:
+            pending.mti.energy_threshold = value;
+            break;
+        case SETTING_CFAR_GUARD_CELLS:
+            pending.cfar.guard_cells = (uint8_t)value;
+            break;
+        case SETTING_CFAR_TRAINING_CELLS:
+            pending.cfar.training_cells = (uint8_t)value;
+            break;
+        case SETTING_CFAR_THRESHOLD_DB:
+            pending.cfar.threshold_db = (uint8_t)value;
+            break;
+        case SETTING_TRACK_INTERVAL:
+            pending.track.interval = (uint8_t)value;
+            break;
+        case SETTING_TRACK_GATE:
+            pending.track.gate = (uint8_t)value;
+            break;
+        case SETTING_VITAL_RANGE_BIN:
+            pending.vital_range_bin = (uint16_t)value;
+            break;
+        case SETTING_SYNC_INTERVAL:
+            pending.sync_interval = value;
+            break;
+        case SETTING_FEC_GROUP:
+            pending.fec.group_size = (uint8_t)value;
+            break;
+        case SETTING_FEC_PARITY:
+            pending.fec.parity_count = (uint8_t)value;
+            break;
+        case SETTING_RESEND_DEPTH:
+            pending.resend.depth = (uint8_t)value;
+            break;
+        case SETTING_RESEND_BUDGET:
+            pending.resend.budget = (uint16_t)value;
+            break;
+        case SETTING_FIFO_INJECT:
+            pending.fifo_inject = (uint16_t)value;
+            break;
+        case SETTING_PROFILE:
+            pending.profile = (uint8_t)value;
+            break;
+        case SETTING_LINK_SIZE:
+            pending.link.size = (uint16_t)value;
+            break;
+        case SETTING_LINK_BATCH:
+            pending.link.batch = (uint8_t)value;
+            break;
+        case SETTING_LINK_RATE:
+            pending.link.rate = (uint16_t)value;
+            break;
+        case SETTING_LINK_COUNT:
+            pending.link.count = value;
+            break;
+        case SETTING_LEASE_DURATION:
+            pending.lease.duration_ms = value;
+            break;
+        case SETTING_BACKLOG_RATE:
+            pending.backlog_rate = (uint16_t)value;
+            break;
+        case SETTING_MULTICAST_PORT:
+            pending.multicast.port = (uint16_t)value;
+            break;
+        case SETTING_MULTICAST_TTL:
+            pending.multicast.ttl = (uint8_t)value;
+            break;
+        case SETTING_SPECTRO_RANGE_BIN:
+            pending.spectro.range_bin = (uint16_t)value;
+            break;
+        case SETTING_SPECTRO_RANGE_BINS:
+            pending.spectro.range_bins = (uint8_t)value;
+            break;
+        case SETTING_SPECTRO_WINDOW:
+            pending.spectro.window = (uint16_t)value;
+            break;
+        case SETTING_SPECTRO_HOP:
+            pending.spectro.hop = (uint16_t)value;
+            break;
+        default:
+            break;
+    }
+
+    pending.fields |= field;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: apply_pending_settings
+ *******************************************************************************
+ * Summary:
+ *   Applies the settings collected from a message. The profile is applied
+ *   first because it resets the decimation and the region of interest, and
+ *   the decimation before the region of interest because it defines the
+ *   samples the region of interest refers to.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void apply_pending_settings(void)
+{
+    if ((pending.fields & SETTING_PROFILE) != 0)
+    {
+        if (radar_set_profile(pending.profile) != RESULT_SUCCESS)
+        {
+            printf("Stop the radar before changing the profile \r\n");
+        }
+        else
+        {
+            printf("Radar profile: %s \r\n", radar_profile_get(pending.profile)->name);
+        }
+    }
+
+    if ((pending.fields & SETTING_DECIMATION) != 0)
+    {
+        if (radar_set_decimation(pending.decimation) != RESULT_SUCCESS)
+        {
+            printf("Invalid decimation factor \r\n");
+        }
+        else
+        {
+            printf("Decimation factor: %u \r\n", pending.decimation);
+        }
+    }
+
+    if ((pending.fields & SETTING_ROI) != 0)
+    {
+        radar_roi_t roi;
+
+        /* Keys missing from the message keep their current value */
+        radar_get_roi(&roi);
+        if ((pending.fields & SETTING_ROI_ANTENNAS) != 0)
+        {
+            roi.antenna_mask = pending.roi.antenna_mask;
+        }
+        if ((pending.fields & SETTING_ROI_CHIRP_STRIDE) != 0)
+        {
+            roi.chirp_stride = pending.roi.chirp_stride;
+        }
+        if ((pending.fields & SETTING_ROI_SAMPLE_START) != 0)
+        {
+            roi.sample_start = pending.roi.sample_start;
+        }
+        if ((pending.fields & SETTING_ROI_SAMPLE_COUNT) != 0)
+        {
+            roi.sample_count = pending.roi.sample_count;
+        }
+
+        if (radar_set_roi(&roi) != RESULT_SUCCESS)
+        {
+            printf("Invalid region of interest \r\n");
+        }
+        else
+        {
+            printf("Region of interest: antennas 0x%x, chirp stride %u, samples %u..%u \r\n",
+                   roi.antenna_mask, roi.chirp_stride, roi.sample_start,
+                   roi.sample_start + roi.sample_count - 1);
+        }
+    }
+
+    if ((pending.fields & SETTING_MTI) != 0)
+    {
+        radar_mti_config_t mti;
+
+        radar_get_mti(&mti);
+        if ((pending.fields & SETTING_MTI_ENABLE) != 0)
+        {
+            mti.enabled = pending.mti.enabled;
+        }
+        if ((pending.fields & SETTING_MTI_ALPHA_SHIFT) != 0)
+        {
+            mti.alpha_shift = pending.mti.alpha_shift;
+        }
+        if ((pending.fields & SETTING_MTI_THRESHOLD) != 0)
+        {
+            mti.energy_threshold = pending.mti.energy_threshold;
+        }
+
+        if (radar_set_mti(&mti) != RESULT_SUCCESS)
+        {
+            printf("Invalid clutter removal setting \r\n");
+        }
+        else
+        {
+            printf("Clutter removal %s: alpha 1/%u, threshold %" PRIu32 " \r\n",
+                   mti.enabled ? "enabled" : "disabled", 1u << mti.alpha_shift, mti.energy_threshold);
+        }
+    }
+
+    if ((pending.fields & SETTING_CFAR) != 0)
+    {
+        radar_cfar_config_t cfar;
+
+        radar_get_cfar(&cfar);
+        if ((pending.fields & SETTING_CFAR_GUARD_CELLS) != 0)
+        {
+            cfar.guard_cells = pending.cfar.guard_cells;
+        }
+        if ((pending.fields & SETTING_CFAR_TRAINING_CELLS) != 0)
+        {
+            cfar.training_cells = pending.cfar.training_cells;
+        }
+        if ((pending.fields & SETTING_CFAR_THRESHOLD_DB) != 0)
+        {
+            cfar.threshold_db = pending.cfar.threshold_db;
+        }
+
+        if (radar_set_cfar(&cfar) != RESULT_SUCCESS)
+        {
+            printf("Invalid target detector setting \r\n");
+        }
+        else
+        {
+            printf("Target detector: %u guard cells, %u training cells, threshold %u dB \r\n",
+                   cfar.guard_cells, cfar.training_cells, cfar.threshold_db);
+        }
+    }
+
+    if ((pending.fields & SETTING_TRACK) != 0)
+    {
+        radar_track_config_t track;
+
+        radar_get_track(&track);
+        if ((pending.fields & SETTING_TRACK_INTERVAL) != 0)
+        {
+            track.interval = pending.track.interval;
+        }
+        if ((pending.fields & SETTING_TRACK_GATE) != 0)
+        {
+            track.gate = pending.track.gate;
+        }
+
+        if (radar_set_track(&track) != RESULT_SUCCESS)
+        {
+            printf("Invalid tracker setting \r\n");
+        }
+        else
+        {
+            printf("Tracker: report every %u frames, gate %u bins \r\n", track.interval, track.gate);
+        }
+    }
+
+    if ((pending.fields & SETTING_VITAL_RANGE_BIN) != 0)
+    {
+        if (radar_set_vital_range_bin(pending.vital_range_bin) != RESULT_SUCCESS)
+        {
+            printf("Invalid vital signs range bin \r\n");
+        }
+        else
+        {
+            printf("Vital signs at range bin %u \r\n", pending.vital_range_bin);
+        }
+    }
+
+    if ((pending.fields & SETTING_SPECTRO) != 0)
+    {
+        radar_spectro_config_t spectro;
+
+        radar_get_spectro(&spectro);
+        if ((pending.fields & SETTING_SPECTRO_RANGE_BIN) != 0)
+        {
+            spectro.range_bin = pending.spectro.range_bin;
+        }
+        if ((pending.fields & SETTING_SPECTRO_RANGE_BINS) != 0)
+        {
+            spectro.range_bins = pending.spectro.range_bins;
+        }
+        if ((pending.fields & SETTING_SPECTRO_WINDOW) != 0)
+        {
+            spectro.window = pending.spectro.window;
+        }
+        if ((pending.fields & SETTING_SPECTRO_HOP) != 0)
+        {
+            spectro.hop = pending.spectro.hop;
+        }
+
+        if (radar_set_spectro(&spectro) != RESULT_SUCCESS)
+        {
+            printf("Invalid spectrogram setting \r\n");
+        }
+        else
+        {
+            printf("Spectrogram: range bins %u to %u, window %u, hop %u frames \r\n",
+                   spectro.range_bin, spectro.range_bin + spectro.range_bins - 1u, spectro.window, spectro.hop);
+        }
+    }
+
+    if ((pending.fields & SETTING_SYNC_INTERVAL) != 0)
+    {
+        udp_server_set_sync_interval(pending.sync_interval);
+        printf("Time exchange every %" PRIu32 " ms \r\n", pending.sync_interval);
+    }
+
+    if ((pending.fields & SETTING_FEC) != 0)
+    {
+        radar_fec_config_t fec;
+
+        udp_server_get_fec(&fec);
+        if ((pending.fields & SETTING_FEC_GROUP) != 0)
+        {
+            fec.group_size = pending.fec.group_size;
+        }
+        if ((pending.fields & SETTING_FEC_PARITY) != 0)
+        {
+            fec.parity_count = pending.fec.parity_count;
+        }
+
+        if (udp_server_set_fec(&fec) != RESULT_SUCCESS)
+        {
+            printf("Invalid parity setting \r\n");
+        }
+        else if (fec.group_size == 0)
+        {
+            printf("Parity disabled \r\n");
+        }
+        else
+        {
+            printf("Parity: %u datagrams per group of %u \r\n", fec.parity_count, fec.group_size);
+        }
+    }
+
+    if ((pending.fields & SETTING_RESEND) != 0)
+    {
+        radar_resend_config_t resend;
+
+        udp_server_get_resend(&resend);
+        if ((pending.fields & SETTING_RESEND_DEPTH) != 0)
+        {
+            resend.depth = pending.resend.depth;
+        }
+        if ((pending.fields & SETTING_RESEND_BUDGET) != 0)
+        {
+            resend.budget = pending.resend.budget;
+        }
+
+        if (udp_server_set_resend(&resend) != RESULT_SUCCESS)
+        {
+            printf("Invalid retransmission setting \r\n");
+        }
+        else
+        {
+            printf("Retransmission: last %u frame datagrams, up to %u per second \r\n", resend.depth, resend.budget);
+        }
+    }
+
+    if ((pending.fields & SETTING_BACKLOG_RATE) != 0)
+    {
+        if (udp_server_set_backlog_rate(pending.backlog_rate) != RESULT_SUCCESS)
+        {
+            printf("Invalid backlog rate \r\n");
+        }
+        else
+        {
+            printf("Wi-Fi outage backlog sent at up to %u frames per second \r\n", pending.backlog_rate);
+        }
+    }
+
+    if ((pending.fields & SETTING_TRANSPORT) != 0)
+    {
+        (void)udp_server_set_transport(pending.transport);
+        printf("Frame transport: %s \r\n", (pending.transport == UDP_SERVER_TRANSPORT_TCP) ? "TCP" : "UDP");
+    }
+
+    if ((pending.fields & SETTING_HANDOFF) != 0)
+    {
+        (void)radar_set_handoff(pending.handoff);
+        printf("Frame hand-off: %s \r\n", (pending.handoff == RADAR_HANDOFF_LATEST) ? "latest frame" : "queue");
+    }
+
+    if ((pending.fields & SETTING_FIFO_INJECT) != 0)
+    {
+        (void)radar_set_fifo_inject(pending.fifo_inject);
+        if (pending.fifo_inject == 0)
+        {
+            printf("FIFO overflow simulation disabled \r\n");
+        }
+        else
+        {
+            printf("FIFO overflow simulated every %u reads \r\n", pending.fifo_inject);
+        }
+    }
+
+    if ((pending.fields & SETTING_LINK) != 0)
+    {
+        radar_link_config_t link = link_config;
+
+        if ((pending.fields & SETTING_LINK_SIZE) != 0)
+        {
+            link.size = pending.link.size;
+        }
+        if ((pending.fields & SETTING_LINK_BATCH) != 0)
+        {
+            link.batch = pending.link.batch;
+        }
+        if ((pending.fields & SETTING_LINK_RATE) != 0)
+        {
+            link.rate = pending.link.rate;
+        }
+        if ((pending.fields & SETTING_LINK_COUNT) != 0)
+        {
+            link.count = pending.link.count;
+        }
+
+        if (!radar_link_config_is_valid(&link))
+        {
+            printf("Invalid link test setting \r\n");
+        }
+        else
+        {
+            link_config = link;
+            if ((pending.fields & SETTING_LINK_TEST) == 0)
+            {
+                printf("Link test: %" PRIu32 " datagrams of %u bytes, %u per second in bursts of %u \r\n",
+                       link.count, link.size, link.rate, link.batch);
+            }
+            else if (!pending.link_run)
+            {
+                udp_server_stop_link_test();
+                printf("Link test stopped \r\n");
+            }
+            else if (udp_server_start_link_test(&link) != RESULT_SUCCESS)
+            {
+                printf("Failed to start the link test \r\n");
+            }
+            else
+            {
+                printf("Link test started: %" PRIu32 " datagrams of %u bytes, %u per second in bursts of %u \r\n",
+                       link.count, link.size, link.rate, link.batch);
+            }
+        }
+    }
+
+    if ((pending.fields & SETTING_MULTICAST) != 0)
+    {
+        udp_server_multicast_t multicast;
+
+        udp_server_get_multicast(&multicast);
+        if ((pending.fields & SETTING_MULTICAST_GROUP) != 0)
+        {
+            multicast.enabled = pending.multicast.enabled;
+            if (pending.multicast.enabled)
+            {
+                multicast.group = pending.multicast.group;
+            }
+        }
+        if ((pending.fields & SETTING_MULTICAST_PORT) != 0)
+        {
+            multicast.port = pending.multicast.port;
+        }
+        if ((pending.fields & SETTING_MULTICAST_TTL) != 0)
+        {
+            multicast.ttl = pending.multicast.ttl;
+        }
+
+        if (udp_server_set_multicast(&multicast) != RESULT_SUCCESS)
+        {
+            printf("Invalid multicast setting \r\n");
+        }
+        else if (!multicast.enabled)
+        {
+            printf("Frame stream to the client \r\n");
+        }
+        else
+        {
+            printf("Frame stream to multicast group %u.%u.%u.%u:%u, TTL %u \r\n",
+                   (unsigned int)(multicast.group & 0xFFu), (unsigned int)((multicast.group >> 8) & 0xFFu),
+                   (unsigned int)((multicast.group >> 16) & 0xFFu), (unsigned int)(multicast.group >> 24),
+                   multicast.port, multicast.ttl);
+        }
+    }
+
+    if ((pending.fields & SETTING_LEASE) != 0)
+    {
+        udp_server_lease_t lease;
+
+        udp_server_get_lease(&lease);
+        if ((pending.fields & SETTING_LEASE_DURATION) != 0)
+        {
+            lease.duration_ms = pending.lease.duration_ms;
+        }
+        if ((pending.fields & SETTING_LEASE_STOP) != 0)
+        {
+            lease.stop_radar = pending.lease.stop_radar;
+        }
+
+        (void)udp_server_set_lease(&lease);
+        if (lease.duration_ms == 0)
+        {
+            printf("Client lease disabled \r\n");
+        }
+        else
+        {
+            printf("Client lease: %" PRIu32 " ms, %s on expiry \r\n", lease.duration_ms,
+                   lease.stop_radar ? "sensor stopped" : "frames suspended");
+        }
+    }
+
+    pending.fields = 0;
+}
 
 /*******************************************************************************
- * Global Variables
+ * Function Name: handle_lease_request
+ *******************************************************************************
+ * Summary:
+ *   Stops the sensor when the client lease expired and restarts it when the
+ *   client is heard again, unless the client disabled the radar meanwhile.
+ *
+ * Parameters:
+ *   expired : the lease expired, else it was renewed
+ *
+ * Return:
+ *   none
  ******************************************************************************/
-TaskHandle_t radar_config_task_handle = NULL;
+static void handle_lease_request(bool expired)
+{
+    if (expired && radar_enabled && !lease_suspended)
+    {
+        lease_suspended = true;
+        radar_start(false);
+        printf("Radar stopped until the client is heard again \r\n");
+    }
+    else if (!expired && lease_suspended)
+    {
+        lease_suspended = false;
+        if (radar_enabled)
+        {
+            radar_start(true);
+            printf("Radar restarted \r\n");
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: send_stats
+ *******************************************************************************
+ * Summary:
+ *   Sends the processing statistics as json string to the UDP client.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void send_stats(void)
+{
+    stats_buffer[0] = RADAR_STATS_COMMAND;
+    stats_buffer[1] = DUMMY_BYTE;
+    stats_msg.length = 2 + radar_format_stats((char *)&stats_buffer[2], STATS_BUFFER_SIZE - 2);
+
+    printf("%s \r\n", (char *)&stats_buffer[2]);
+
+    if (xQueueSendToBack(radar_data_queue, &stats_msg_ptr, 0) != pdTRUE)
+    {
+        printf("Failed to queue statistics \r\n");
+    }
+}
+
+/*******************************************************************************
+ * Function Name: send_bench_record
+ *******************************************************************************
+ * Summary:
+ *   Sends one benchmark record as json string to the UDP client. Waits for
+ *   room in the radar data queue so that no record is lost.
+ *
+ * Parameters:
+ *   record: json string
+ *   length: length of the json string
+ *   arg: unused
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void send_bench_record(const char *record, uint32_t length, void *arg)
+{
+    publisher_data_t *msg = &bench_msgs[bench_msg_idx];
+
+    (void)arg;
+
+    bench_msg_idx = (bench_msg_idx + 1) % BENCH_MSG_COUNT;
+
+    msg->cmd = RADAR_BENCH_COMMAND;
+    msg->data = bench_buffers[msg - bench_msgs];
+    msg->data[0] = RADAR_BENCH_COMMAND;
+    msg->data[1] = DUMMY_BYTE;
+    memcpy(&msg->data[2], record, length);
+    msg->length = 2 + length;
+
+    printf("%s \r\n", record);
+
+    if (xQueueSendToBack(radar_data_queue, &msg, pdMS_TO_TICKS(BENCH_QUEUE_TIMEOUT_MS)) != pdTRUE)
+    {
+        printf("Failed to queue benchmark record \r\n");
+    }
+}
 
 /*******************************************************************************
  * Function Name: json_parser_cb
@@ -78,18 +1335,24 @@ static cy_rslt_t json_parser_cb(cy_JSON_object_t *json_object, void *arg)
     if ((json_object->object_string_length == RADAR_STR_LENGTH) && (memcmp(json_object->object_string, RADAR_STRING, json_object->object_string_length) == 0))
     {
 
+        /* A command of the client overrides a sensor stop of the client lease */
+        lease_suspended = false;
+
         if (( json_object->value_length == ENABLE_STR_LENGTH) && (memcmp(json_object->value, ENABLE_STRING, json_object->value_length) == 0))
         {
+            radar_enabled = true;
             radar_start(true);
             printf("Radar data transmission is enabled \r\n");
         }
         else if (( json_object->value_length == DISABLE_STR_LENGTH) && (memcmp(json_object->value, DISABLE_STRING, json_object->value_length) == 0))
         {
+            radar_enabled = false;
             radar_start(false);
             printf("Radar data transmission is disabled \r\n");
         }
         else if(( json_object->value_length == TEST_STR_LENGTH) && (memcmp(json_object->value, TEST_STRING, json_object->value_length) == 0))
         {
+            radar_enabled = true;
             if (radar_start(true) != RESULT_SUCCESS)
             {
                 printf("Failed to write to radar device\n");
@@ -112,7 +1375,40 @@ static cy_rslt_t json_parser_cb(cy_JSON_object_t *json_object, void *arg)
         }
 
     }
-    else
+    else if (json_key_matches(json_object, PIPELINE_STRING))
+    {
+        if (radar_set_pipeline(json_object->value, json_object->value_length) != RESULT_SUCCESS)
+        {
+            printf("Invalid pipeline \r\n");
+        }
+        else
+        {
+            printf("Pipeline: %.*s \r\n", (int)json_object->value_length, json_object->value);
+        }
+    }
+    else if (json_key_matches(json_object, STATS_STRING))
+    {
+        if (json_value_matches(json_object, GET_STRING))
+        {
+            send_stats();
+        }
+        else
+        {
+            printf("Invalid setting value \r\n");
+        }
+    }
+    else if (json_key_matches(json_object, BENCH_STRING))
+    {
+        if (json_value_matches(json_object, RUN_STRING))
+        {
+            bench_requested = true;
+        }
+        else
+        {
+            printf("Invalid setting value \r\n");
+        }
+    }
+    else if (!parse_setting_value(json_object))
     {
         printf("Invalid parameter name \r\n");
     }
@@ -146,20 +1442,40 @@ void radar_config_task(void *pvParameters)
         /* Block till a notification is received from the udp_server_recv_handler */
         if (xQueueReceive(radar_config_queue, &msg_payload, portMAX_DELAY) == pdPASS )
         {
+            /* Sensor stop or restart of the client lease from the UDP server task */
+            if ((msg_payload == udp_server_lease_expired) || (msg_payload == udp_server_lease_renewed))
+            {
+                handle_lease_request(msg_payload == udp_server_lease_expired);
+                continue;
+            }
+
             printf("Command received from udp client %s \r\n", msg_payload);
 
             /* Get mutex to block any other json parse jobs */
             if (xSemaphoreTake(sem_udp_payload, portMAX_DELAY) == pdTRUE)
             {
+                pending.fields = 0;
 
                 result = cy_JSON_parser(msg_payload, strlen(msg_payload));
                 if (result != CY_RSLT_SUCCESS)
                 {
                     printf("Json parser error: invalid json message!\r\n");
                 }
+                else
+                {
+                    apply_pending_settings();
+                }
             }
             xSemaphoreGive(sem_udp_payload);
 
+            /* The benchmark takes seconds, run it without the payload buffer
+             * so the UDP receive callback can take the next command */
+            if (bench_requested)
+            {
+                bench_requested = false;
+                printf("Benchmark finished with %" PRIu32 " results \r\n",
+                       radar_bench_run(send_bench_record, NULL));
+            }
         }
     }
 }
@@ -0,0 +1,74 @@
+/******************************************************************************
+ * File Name:   radar_cycles.h
+ *
+ * Description: This file contains the cycle counter used to measure the cost
+ *   of the frame processing on target and on host.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_CYCLES_H_
+#define RADAR_CYCLES_H_
+
+/* clock_gettime() of the host path is POSIX and hidden in the strict C modes
+ * of the host compiler. The feature macro only takes effect before the first
+ * system header of a translation unit, so the host build also defines it on
+ * the command line (test/Makefile). */
+#if !defined(__ARM_ARCH) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdint.h>
+
+#if defined(__ARM_ARCH)
+#include "cy_pdl.h"
+#else
+#include <time.h>
+#endif
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+/* Starts the cycle counter. On target this is the DWT cycle counter of the
+ * CM4, on host builds a monotonic nanosecond clock stands in for it. */
+static inline void radar_cycles_init(void)
+{
+#if defined(__ARM_ARCH)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+static inline uint32_t radar_cycles_now(void)
+{
+#if defined(__ARM_ARCH)
+    return DWT->CYCCNT;
+#else
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec);
+#endif
+}
+
+#endif /* RADAR_CYCLES_H_ */
+/* [] END OF FILE */
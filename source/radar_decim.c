@@ -0,0 +1,262 @@
+/*****************************************************************************
+ * File name: radar_decim.c
+ *
+ * Description: This file implements the anti-aliasing decimation of every
+ * chirp with polyphase FIR filters in fixed point. The filter coefficients
+ * for each supported factor are computed by the compiler.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <stddef.h>
+
+/* Header file for local module */
+#include "radar_decim.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define DECIM_PI                (3.14159265358979323846)
+
+/* sin(x) for 0 <= x <= pi/2, Taylor series up to x^11 */
+#define DECIM_SIN_Q1(x)         ((x) * (1.0 - ((x) * (x) / 6.0) * (1.0 - ((x) * (x) / 20.0) * \
+                                 (1.0 - ((x) * (x) / 42.0) * (1.0 - ((x) * (x) / 72.0) *  \
+                                 (1.0 - ((x) * (x) / 110.0)))))))
+
+#define DECIM_MOD128(j)         ((((j) % 128) + 128) % 128)
+#define DECIM_FOLD(q)           (((q) > 32) ? (64 - (q)) : (q))
+
+/* sin(j * pi / 64) for any integer j */
+#define DECIM_SIN64(j)          (((DECIM_MOD128(j) < 64) ? 1.0 : -1.0) * \
+                                 DECIM_SIN_Q1((DECIM_PI / 64.0) * DECIM_FOLD(DECIM_MOD128(j) % 64)))
+
+/* Hann windowed sinc low pass for factor M with the cutoff at the Nyquist
+ * frequency of the decimated signal. Tap n of the 16 * M taps is centred on
+ * n = 8 * M - 1, which leaves the last tap zero. All arguments of
+ * DECIM_SIN64() are integers for M in 2, 4 and 8. */
+#define DECIM_OFFSET(M, n)      ((n) - ((8 * (M)) - 1))
+#define DECIM_SINC(M, n)        ((DECIM_OFFSET(M, n) == 0) ? 1.0 :                     \
+                                 (DECIM_SIN64((64 * DECIM_OFFSET(M, n)) / (M)) /       \
+                                  ((DECIM_PI * DECIM_OFFSET(M, n)) / (M))))
+#define DECIM_HANN(M, n)        (0.5 - (0.5 * DECIM_SIN64(((8 * ((n) + 1)) / (M)) + 32)))
+#define DECIM_TAP(M, n)         ((DECIM_SINC(M, n) * DECIM_HANN(M, n)) / (M))
+#define DECIM_Q15(x)            ((int16_t)(((x) * 32768.0) + (((x) < 0) ? -0.5 : 0.5)))
+
+/* Coefficient k of polyphase branch p, i.e. tap k * M + p */
+#define DECIM_COEF(M, p, k)     DECIM_Q15(DECIM_TAP(M, ((k) * (M)) + (p)))
+#define DECIM_BRANCH(M, p)                                                              \
+    DECIM_COEF(M, p, 0),  DECIM_COEF(M, p, 1),  DECIM_COEF(M, p, 2),  DECIM_COEF(M, p, 3),  \
+    DECIM_COEF(M, p, 4),  DECIM_COEF(M, p, 5),  DECIM_COEF(M, p, 6),  DECIM_COEF(M, p, 7),  \
+    DECIM_COEF(M, p, 8),  DECIM_COEF(M, p, 9),  DECIM_COEF(M, p, 10), DECIM_COEF(M, p, 11), \
+    DECIM_COEF(M, p, 12), DECIM_COEF(M, p, 13), DECIM_COEF(M, p, 14), DECIM_COEF(M, p, 15)
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+/* Polyphase branches of the filters, RADAR_DECIM_TAPS_PER_PHASE coefficients
+ * per branch and one branch per input phase */
+static const int16_t decim_coeffs_2[] =
+{
+    DECIM_BRANCH(2, 0), DECIM_BRANCH(2, 1)
+};
+
+static const int16_t decim_coeffs_4[] =
+{
+    DECIM_BRANCH(4, 0), DECIM_BRANCH(4, 1), DECIM_BRANCH(4, 2), DECIM_BRANCH(4, 3)
+};
+
+static const int16_t decim_coeffs_8[] =
+{
+    DECIM_BRANCH(8, 0), DECIM_BRANCH(8, 1), DECIM_BRANCH(8, 2), DECIM_BRANCH(8, 3),
+    DECIM_BRANCH(8, 4), DECIM_BRANCH(8, 5), DECIM_BRANCH(8, 6), DECIM_BRANCH(8, 7)
+};
+
+/*******************************************************************************
+ * Function Name: get_coeffs
+ *******************************************************************************
+ * Summary:
+ *   Returns the polyphase filter of a decimation factor.
+ *
+ * Parameters:
+ *   factor : decimation factor
+ *
+ * Return:
+ *   filter coefficients, NULL if the factor has no filter
+ ******************************************************************************/
+static const int16_t *get_coeffs(uint8_t factor)
+{
+    switch (factor)
+    {
+        case 2:
+            return decim_coeffs_2;
+        case 4:
+            return decim_coeffs_4;
+        case 8:
+            return decim_coeffs_8;
+        default:
+            return NULL;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_decim_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks that a decimation factor is supported for a frame geometry. A
+ *   factor of 1 disables the decimation.
+ *
+ * Parameters:
+ *   factor   : decimation factor
+ *   geometry : geometry of the frames to decimate
+ *
+ * Return:
+ *   true if the factor can be applied
+ ******************************************************************************/
+bool radar_decim_is_valid(uint8_t factor, const radar_geometry_t *geometry)
+{
+    if (factor == 1)
+    {
+        return true;
+    }
+
+    return (get_coeffs(factor) != NULL) && ((geometry->samples_per_chirp % factor) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: radar_decim_geometry
+ *******************************************************************************
+ * Summary:
+ *   Computes the geometry of the frames produced by the decimation.
+ *
+ * Parameters:
+ *   factor : decimation factor
+ *   in     : geometry of the frames to decimate
+ *   out    : geometry of the decimated frames
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_decim_geometry(uint8_t factor, const radar_geometry_t *in, radar_geometry_t *out)
+{
+    *out = *in;
+    out->samples_per_chirp = (uint16_t)(in->samples_per_chirp / factor);
+}
+
+/*******************************************************************************
+ * Function Name: radar_decim_frame
+ *******************************************************************************
+ * Summary:
+ *   Low pass filters and decimates every chirp of every antenna of a frame in
+ *   place. The decimated frame keeps the sensor layout and is packed at the
+ *   start of the buffer. Chirps are filtered independently, each end of a
+ *   chirp is extended with its edge sample so the DC offset of the ADC does
+ *   not ramp at the borders. Input samples must be 12-bit values.
+ *
+ * Parameters:
+ *   factor   : decimation factor, checked with radar_decim_is_valid()
+ *   geometry : geometry of the input frame
+ *   frame    : frame to decimate
+ *   scratch  : RADAR_DECIM_SCRATCH_SIZE() words of scratch memory
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_decim_frame(uint8_t factor, const radar_geometry_t *geometry,
+                       uint16_t *frame, uint16_t *scratch)
+{
+    const int16_t *coeffs = get_coeffs(factor);
+    const uint32_t num_antennas = geometry->rx_antennas;
+    const uint32_t samples_in = geometry->samples_per_chirp;
+    const uint32_t samples_out = samples_in / factor;
+    const uint32_t line_length = samples_in + (RADAR_DECIM_TAPS_PER_PHASE * factor);
+    const uint32_t front = 8u * factor;
+    const uint32_t centre = (8u * factor) - 1u;
+    uint16_t *out = frame;
+
+    if (coeffs == NULL)
+    {
+        return;
+    }
+
+    for (uint32_t chirp = 0; chirp < geometry->chirps_per_frame; ++chirp)
+    {
+        const uint16_t *in = &frame[chirp * samples_in * num_antennas];
+
+        /* Split the chirp into one padded line per antenna. The whole chirp
+         * is copied first because the output overwrites it in place. */
+        for (uint32_t rx = 0; rx < num_antennas; ++rx)
+        {
+            uint16_t *line = &scratch[rx * line_length];
+            const uint16_t first = in[rx];
+            const uint16_t last = in[((samples_in - 1u) * num_antennas) + rx];
+            uint32_t idx = 0;
+
+            while (idx < front)
+            {
+                line[idx++] = first;
+            }
+            for (uint32_t sample = 0; sample < samples_in; ++sample)
+            {
+                line[idx++] = in[(sample * num_antennas) + rx];
+            }
+            while (idx < line_length)
+            {
+                line[idx++] = last;
+            }
+        }
+
+        for (uint32_t sample = 0; sample < samples_out; ++sample)
+        {
+            for (uint32_t rx = 0; rx < num_antennas; ++rx)
+            {
+                const uint16_t *line = &scratch[(rx * line_length) + front + (sample * factor) + centre];
+                int32_t acc = 0;
+
+                for (uint32_t phase = 0; phase < factor; ++phase)
+                {
+                    const int16_t *branch = &coeffs[phase * RADAR_DECIM_TAPS_PER_PHASE];
+                    const uint16_t *x = line - phase;
+
+                    for (uint32_t tap = 0; tap < RADAR_DECIM_TAPS_PER_PHASE; ++tap)
+                    {
+                        acc += (int32_t)branch[tap] * (int32_t)*x;
+                        x -= factor;
+                    }
+                }
+
+                acc = (acc + (1 << 14)) >> 15;
+                if (acc < 0)
+                {
+                    acc = 0;
+                }
+                else if (acc > RADAR_DECIM_SAMPLE_MAX)
+                {
+                    acc = RADAR_DECIM_SAMPLE_MAX;
+                }
+
+                *out++ = (uint16_t)acc;
+            }
+        }
+    }
+}
+
+/* [] END OF FILE */
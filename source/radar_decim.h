@@ -0,0 +1,60 @@
+/******************************************************************************
+ * File Name:   radar_decim.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_decim.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_DECIM_H_
+#define RADAR_DECIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "radar_frame.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RADAR_DECIM_MAX_FACTOR          (8)
+
+/* Every decimation filter has RADAR_DECIM_TAPS_PER_PHASE * factor taps */
+#define RADAR_DECIM_TAPS_PER_PHASE      (16)
+
+/* Largest sample value produced, the output keeps the 12-bit ADC range */
+#define RADAR_DECIM_SAMPLE_MAX          (0x0FFF)
+
+/* Number of 16-bit words of scratch memory needed by radar_decim_frame() */
+#define RADAR_DECIM_SCRATCH_SIZE(samples_per_chirp, rx_antennas) \
+    ((rx_antennas) * ((samples_per_chirp) + (RADAR_DECIM_TAPS_PER_PHASE * RADAR_DECIM_MAX_FACTOR)))
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+bool radar_decim_is_valid(uint8_t factor, const radar_geometry_t *geometry);
+void radar_decim_geometry(uint8_t factor, const radar_geometry_t *in, radar_geometry_t *out);
+void radar_decim_frame(uint8_t factor, const radar_geometry_t *geometry,
+                       uint16_t *frame, uint16_t *scratch);
+
+#endif /* RADAR_DECIM_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,250 @@
+/*****************************************************************************
+ * File name: radar_fec.c
+ *
+ * Description: This file implements the forward error correction of the radar
+ * data stream: interleaved XOR parity over groups of datagrams, computed
+ * while the datagrams are sent, from which the client rebuilds lost datagrams
+ * without a retransmission.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_fec.h"
+#include "radar_frame.h"
+
+/*******************************************************************************
+ * Function Name: fec_slot
+ *******************************************************************************
+ * Summary:
+ *   Returns the parity datagram of an index, the payload follows the header
+ *   of the configured group size.
+ ******************************************************************************/
+static uint8_t *fec_slot(const radar_fec_t *fec, uint32_t index)
+{
+    return &fec->memory[index * RADAR_FEC_SLOT_SIZE(fec->max_datagram)];
+}
+
+/*******************************************************************************
+ * Function Name: fec_xor
+ *******************************************************************************
+ * Summary:
+ *   Adds bytes to a parity payload.
+ ******************************************************************************/
+static void fec_xor(uint8_t *payload, const uint8_t *data, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        payload[i] ^= data[i];
+    }
+}
+
+/*******************************************************************************
+ * Function Name: fec_start_group
+ *******************************************************************************
+ * Summary:
+ *   Clears the payloads of the previous group. Only the bytes it used are
+ *   cleared, everything behind them is still zero.
+ ******************************************************************************/
+static void fec_start_group(radar_fec_t *fec)
+{
+    const uint32_t header_size = RADAR_FEC_HEADER_SIZE(fec->config.group_size);
+
+    for (uint32_t i = 0; i < fec->config.parity_count; ++i)
+    {
+        memset(&fec_slot(fec, i)[header_size], 0, fec->payload_size[i]);
+        fec->payload_size[i] = 0;
+    }
+    fec->count = 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_fec_config_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks the group size and the parity datagrams per group. A parity
+ *   datagram covers every parity_count-th datagram of the group, so up to
+ *   parity_count consecutive losses can be rebuilt.
+ *
+ * Parameters:
+ *   config : parity settings
+ *
+ * Return:
+ *   true if the settings are supported
+ ******************************************************************************/
+bool radar_fec_config_is_valid(const radar_fec_config_t *config)
+{
+    if (config->group_size == 0)
+    {
+        return true;
+    }
+
+    return (config->group_size >= 2) && (config->group_size <= RADAR_FEC_MAX_GROUP) &&
+           (config->parity_count >= 1) && (config->parity_count <= RADAR_FEC_MAX_PARITY) &&
+           (config->parity_count <= config->group_size);
+}
+
+/*******************************************************************************
+ * Function Name: radar_fec_init
+ *******************************************************************************
+ * Summary:
+ *   Sets up the encoder on its parity memory.
+ *
+ * Parameters:
+ *   fec          : encoder state
+ *   memory       : RADAR_FEC_MEMORY_SIZE(max_datagram) bytes
+ *   max_datagram : largest datagram that is protected
+ *   config       : valid parity settings
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_fec_init(radar_fec_t *fec, uint8_t *memory, uint32_t max_datagram, const radar_fec_config_t *config)
+{
+    fec->memory = memory;
+    fec->max_datagram = max_datagram;
+    radar_fec_configure(fec, config);
+}
+
+/*******************************************************************************
+ * Function Name: radar_fec_configure
+ *******************************************************************************
+ * Summary:
+ *   Changes the parity settings. The current group is dropped without its
+ *   parity datagrams.
+ *
+ * Parameters:
+ *   fec    : encoder state
+ *   config : valid parity settings
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_fec_configure(radar_fec_t *fec, const radar_fec_config_t *config)
+{
+    fec->config = *config;
+    memset(fec->memory, 0, RADAR_FEC_MEMORY_SIZE(fec->max_datagram));
+    memset(fec->payload_size, 0, sizeof(fec->payload_size));
+    fec->count = 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_fec_add
+ *******************************************************************************
+ * Summary:
+ *   Adds a sent datagram with a frame header to the parity of its group
+ *   position. A datagram too far from the start of the group to be listed
+ *   starts a new group, the old one is dropped.
+ *
+ * Parameters:
+ *   fec      : encoder state
+ *   datagram : sent datagram, starting with the frame header
+ *   length   : size of the datagram
+ *
+ * Return:
+ *   true if the group is complete and its parity datagrams are ready
+ ******************************************************************************/
+bool radar_fec_add(radar_fec_t *fec, const uint8_t *datagram, uint32_t length)
+{
+    uint8_t size[2];
+    uint8_t *payload;
+    uint32_t frame;
+    uint32_t index;
+
+    if ((fec->config.group_size == 0) || (length < RADAR_FRAME_HEADER_SIZE) || (length > fec->max_datagram))
+    {
+        return false;
+    }
+
+    frame = radar_frame_get_u32(&datagram[RADAR_FRAME_HDR_FRAME_NUM]);
+    if ((fec->count == fec->config.group_size) ||
+        ((fec->count != 0) && ((frame - fec->base_frame) >= RADAR_FEC_OFFSET_UNUSED)))
+    {
+        fec_start_group(fec);
+    }
+    if (fec->count == 0)
+    {
+        fec->base_frame = frame;
+    }
+
+    index = fec->count % fec->config.parity_count;
+    payload = &fec_slot(fec, index)[RADAR_FEC_HEADER_SIZE(fec->config.group_size)];
+    radar_frame_put_u16(size, (uint16_t)length);
+    fec_xor(&payload[0], size, sizeof(size));
+    fec_xor(&payload[sizeof(size)], datagram, length);
+    if (fec->payload_size[index] < (length + sizeof(size)))
+    {
+        fec->payload_size[index] = (uint16_t)(length + sizeof(size));
+    }
+
+    fec->offsets[fec->count] = (uint16_t)(frame - fec->base_frame);
+    fec->count++;
+
+    return fec->count == fec->config.group_size;
+}
+
+/*******************************************************************************
+ * Function Name: radar_fec_write_parity
+ *******************************************************************************
+ * Summary:
+ *   Completes the header of a parity datagram of the current group, see
+ *   RADAR_FEC_HDR_OFFSETS. The datagram stays valid until the next
+ *   radar_fec_add.
+ *
+ * Parameters:
+ *   fec      : encoder state
+ *   index    : parity datagram, below the parity datagrams per group
+ *   datagram : output, the parity datagram
+ *
+ * Return:
+ *   size of the parity datagram, 0 if there is none
+ ******************************************************************************/
+uint32_t radar_fec_write_parity(radar_fec_t *fec, uint32_t index, const uint8_t **datagram)
+{
+    uint8_t *data;
+
+    if ((fec->config.group_size == 0) || (fec->count == 0) || (index >= fec->config.parity_count))
+    {
+        return 0;
+    }
+
+    data = fec_slot(fec, index);
+    data[0] = RADAR_FEC_COMMAND;
+    data[1] = RADAR_FRAME_DUMMY_BYTE;
+    radar_frame_put_u32(&data[2], fec->base_frame);
+    data[6] = fec->count;
+    data[7] = fec->config.parity_count;
+    data[8] = (uint8_t)index;
+    radar_frame_put_u16(&data[9], fec->payload_size[index]);
+    for (uint32_t i = 0; i < fec->config.group_size; ++i)
+    {
+        radar_frame_put_u16(&data[RADAR_FEC_HDR_OFFSETS + (2u * i)],
+                            (i < fec->count) ? fec->offsets[i] : (uint16_t)RADAR_FEC_OFFSET_UNUSED);
+    }
+
+    *datagram = data;
+    return RADAR_FEC_HEADER_SIZE(fec->config.group_size) + fec->payload_size[index];
+}
+
+/* [] END OF FILE */
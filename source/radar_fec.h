@@ -0,0 +1,92 @@
+/******************************************************************************
+ * File Name:   radar_fec.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_fec.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_FEC_H_
+#define RADAR_FEC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RADAR_FEC_MAX_GROUP             (16u)
+#define RADAR_FEC_MAX_PARITY            (4u)
+
+#define RADAR_FEC_DEFAULT_PARITY        (1u)
+
+/* Parity datagram layout, all multi-byte fields little endian:
+ *   [0]      command, RADAR_FEC_COMMAND
+ *   [1]      dummy byte
+ *   [2..5]   frame number of the first datagram of the group
+ *   [6]      datagrams in the group
+ *   [7]      parity datagrams per group
+ *   [8]      index of this parity datagram, it covers the datagrams at
+ *            positions index, index + parity datagrams, ...
+ *   [9..10]  payload size
+ *   [11..]   frame number of every datagram of the group minus the first,
+ *            2 bytes per configured group position, 0xFFFF if unused
+ * followed by the payload: the XOR of the covered datagrams, each prefixed
+ * with its size (2 bytes) and zero padded to the payload size. */
+#define RADAR_FEC_HDR_OFFSETS           (11u)
+#define RADAR_FEC_HEADER_SIZE(group_size) (RADAR_FEC_HDR_OFFSETS + (2u * (group_size)))
+#define RADAR_FEC_SLOT_SIZE(max_datagram) (RADAR_FEC_HEADER_SIZE(RADAR_FEC_MAX_GROUP) + 2u + (max_datagram))
+#define RADAR_FEC_MEMORY_SIZE(max_datagram) (RADAR_FEC_MAX_PARITY * RADAR_FEC_SLOT_SIZE(max_datagram))
+
+#define RADAR_FEC_OFFSET_UNUSED         (0xFFFFu)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t group_size;         /* data datagrams per group, 0 disables the parity */
+    uint8_t parity_count;       /* parity datagrams per group */
+} radar_fec_config_t;
+
+typedef struct
+{
+    radar_fec_config_t config;
+    uint8_t *memory;            /* RADAR_FEC_MAX_PARITY slots, a parity datagram each */
+    uint32_t max_datagram;
+    uint32_t base_frame;        /* frame number of the first datagram of the group */
+    uint16_t offsets[RADAR_FEC_MAX_GROUP];
+    uint16_t payload_size[RADAR_FEC_MAX_PARITY];
+    uint8_t count;              /* datagrams in the current group */
+} radar_fec_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+bool radar_fec_config_is_valid(const radar_fec_config_t *config);
+void radar_fec_init(radar_fec_t *fec, uint8_t *memory, uint32_t max_datagram, const radar_fec_config_t *config);
+void radar_fec_configure(radar_fec_t *fec, const radar_fec_config_t *config);
+bool radar_fec_add(radar_fec_t *fec, const uint8_t *datagram, uint32_t length);
+uint32_t radar_fec_write_parity(radar_fec_t *fec, uint32_t index, const uint8_t **datagram);
+
+#endif /* RADAR_FEC_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,130 @@
+/*****************************************************************************
+ * File name: radar_fft.c
+ *
+ * Description: This file implements an in-place radix-2 complex FFT on single
+ * precision floats, which the CM4 FPU handles natively.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+
+/* Header file for local module */
+#include "radar_fft.h"
+
+/*******************************************************************************
+ * Function Name: radar_fft_log2
+ *******************************************************************************
+ * Summary:
+ *   Computes the number of radix-2 stages of an FFT size.
+ *
+ * Parameters:
+ *   size : FFT size, power of two
+ *
+ * Return:
+ *   base 2 logarithm of size
+ ******************************************************************************/
+uint32_t radar_fft_log2(uint32_t size)
+{
+    uint32_t stages = 0;
+
+    while ((1u << stages) < size)
+    {
+        stages++;
+    }
+
+    return stages;
+}
+
+/*******************************************************************************
+ * Function Name: radar_fft
+ *******************************************************************************
+ * Summary:
+ *   Computes the forward FFT of a complex sequence in place, the output is in
+ *   natural order. The twiddle factors of every stage are generated with a
+ *   rotation recurrence, so only one sine and cosine are evaluated per stage
+ *   and no table is needed.
+ *
+ * Parameters:
+ *   re   : real parts
+ *   im   : imaginary parts
+ *   size : number of points, power of two up to RADAR_FFT_MAX_SIZE
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_fft(float *re, float *im, uint32_t size)
+{
+    /* Bit reversal permutation */
+    for (uint32_t i = 1, j = 0; i < size; ++i)
+    {
+        uint32_t bit = size >> 1;
+
+        while ((j & bit) != 0)
+        {
+            j ^= bit;
+            bit >>= 1;
+        }
+        j |= bit;
+
+        if (i < j)
+        {
+            const float tmp_re = re[i];
+            const float tmp_im = im[i];
+
+            re[i] = re[j];
+            im[i] = im[j];
+            re[j] = tmp_re;
+            im[j] = tmp_im;
+        }
+    }
+
+    for (uint32_t half = 1; half < size; half <<= 1)
+    {
+        const float angle = -3.14159265f / (float)half;
+        const float step_re = cosf(angle);
+        const float step_im = sinf(angle);
+        float w_re = 1.0f;
+        float w_im = 0.0f;
+
+        for (uint32_t k = 0; k < half; ++k)
+        {
+            for (uint32_t i = k; i < size; i += 2u * half)
+            {
+                const uint32_t j = i + half;
+                const float t_re = (re[j] * w_re) - (im[j] * w_im);
+                const float t_im = (re[j] * w_im) + (im[j] * w_re);
+
+                re[j] = re[i] - t_re;
+                im[j] = im[i] - t_im;
+                re[i] += t_re;
+                im[i] += t_im;
+            }
+
+            const float next_re = (w_re * step_re) - (w_im * step_im);
+            w_im = (w_re * step_im) + (w_im * step_re);
+            w_re = next_re;
+        }
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,53 @@
+/******************************************************************************
+ * File Name:   radar_fft.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_fft.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_FFT_H_
+#define RADAR_FFT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RADAR_FFT_MAX_SIZE      (1024u)
+
+/* Smallest supported FFT size holding n points, 0 if n is too large. Usable
+ * in constant expressions to size buffers. */
+#define RADAR_FFT_SIZE(n)       (((n) <= 1u)   ? 1u   : ((n) <= 2u)   ? 2u   : ((n) <= 4u)   ? 4u   : \
+                                 ((n) <= 8u)   ? 8u   : ((n) <= 16u)  ? 16u  : ((n) <= 32u)  ? 32u  : \
+                                 ((n) <= 64u)  ? 64u  : ((n) <= 128u) ? 128u : ((n) <= 256u) ? 256u : \
+                                 ((n) <= 512u) ? 512u : ((n) <= 1024u) ? 1024u : 0u)
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+uint32_t radar_fft_log2(uint32_t size);
+void radar_fft(float *re, float *im, uint32_t size);
+
+#endif /* RADAR_FFT_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,230 @@
+/*****************************************************************************
+ * File name: radar_fifo.c
+ *
+ * Description: This file implements the supervision of the sensor FIFO:
+ * classification of the errors from the FIFO status register, the counters of
+ * the recoveries and the frame numbering across them.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_fifo.h"
+#include "xensiv_bgt60trxx.h"
+
+/*******************************************************************************
+ * Function Name: radar_fifo_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes the FIFO supervision with cleared counters.
+ *
+ * Parameters:
+ *   fifo            : FIFO supervision
+ *   frame_period_us : frame repetition time of the sensor
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_fifo_init(radar_fifo_t *fifo, uint32_t frame_period_us)
+{
+    memset(fifo, 0, sizeof(*fifo));
+    fifo->frame_period_us = (frame_period_us != 0) ? frame_period_us : 1u;
+}
+
+/*******************************************************************************
+ * Function Name: radar_fifo_restart
+ *******************************************************************************
+ * Summary:
+ *   Called when the acquisition is started, the time until the first frame
+ *   does not count as lost frames.
+ *
+ * Parameters:
+ *   fifo : FIFO supervision
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_fifo_restart(radar_fifo_t *fifo)
+{
+    fifo->have_frame = false;
+    fifo->gap = false;
+}
+
+/*******************************************************************************
+ * Function Name: radar_fifo_set_inject
+ *******************************************************************************
+ * Summary:
+ *   Simulates FIFO overflows to test the recovery: every interval-th FIFO
+ *   read is skipped and handled as an overflow.
+ *
+ * Parameters:
+ *   fifo     : FIFO supervision
+ *   interval : FIFO reads per simulated overflow, 0 disables the simulation
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_fifo_set_inject(radar_fifo_t *fifo, uint16_t interval)
+{
+    fifo->inject_interval = interval;
+    fifo->inject_count = 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_fifo_inject
+ *******************************************************************************
+ * Summary:
+ *   Counts a FIFO read for the simulated overflows.
+ *
+ * Parameters:
+ *   fifo : FIFO supervision
+ *
+ * Return:
+ *   true if this read is to be handled as an overflow
+ ******************************************************************************/
+bool radar_fifo_inject(radar_fifo_t *fifo)
+{
+    if (fifo->inject_interval == 0)
+    {
+        return false;
+    }
+
+    fifo->inject_count++;
+    if (fifo->inject_count < fifo->inject_interval)
+    {
+        return false;
+    }
+
+    fifo->inject_count = 0;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_fifo_classify
+ *******************************************************************************
+ * Summary:
+ *   Finds the reason for a recovery in the FIFO status register.
+ *
+ * Parameters:
+ *   fstat     : value of the FSTAT register
+ *   otherwise : reason if no FIFO error flag is set
+ *
+ * Return:
+ *   reason for the recovery
+ ******************************************************************************/
+radar_fifo_error_t radar_fifo_classify(uint32_t fstat, radar_fifo_error_t otherwise)
+{
+    if ((fstat & XENSIV_BGT60TRXX_REG_FSTAT_FOF_ERR_MSK) != 0)
+    {
+        return RADAR_FIFO_OVERFLOW;
+    }
+    if ((fstat & XENSIV_BGT60TRXX_REG_FSTAT_FUF_ERR_MSK) != 0)
+    {
+        return RADAR_FIFO_UNDERFLOW;
+    }
+
+    return otherwise;
+}
+
+/*******************************************************************************
+ * Function Name: radar_fifo_recovered
+ *******************************************************************************
+ * Summary:
+ *   Counts a recovery. The frames read before and after it may not be
+ *   consecutive, so the next frame is numbered from the elapsed time and
+ *   marked as a discontinuity.
+ *
+ * Parameters:
+ *   fifo    : FIFO supervision
+ *   error   : reason for the recovery
+ *   success : the FIFO was reset and the acquisition restarted
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_fifo_recovered(radar_fifo_t *fifo, radar_fifo_error_t error, bool success)
+{
+    switch (error)
+    {
+        case RADAR_FIFO_OVERFLOW:
+            fifo->stats.overflows++;
+            break;
+        case RADAR_FIFO_UNDERFLOW:
+            fifo->stats.underflows++;
+            break;
+        case RADAR_FIFO_READ_ERROR:
+            fifo->stats.read_errors++;
+            break;
+        default:
+            fifo->stats.stalls++;
+            break;
+    }
+
+    if (success)
+    {
+        fifo->stats.recoveries++;
+    }
+    else
+    {
+        fifo->stats.failed_recoveries++;
+    }
+    fifo->gap = true;
+    fifo->marker = true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_fifo_frame
+ *******************************************************************************
+ * Summary:
+ *   Counts a frame read from the FIFO. After a recovery, the sensor frames
+ *   since the last frame read are derived from the frame times.
+ *
+ * Parameters:
+ *   fifo : FIFO supervision
+ *   time : device time of the FIFO interrupt of the frame
+ *
+ * Return:
+ *   sensor frames lost between the previous frame and this one
+ ******************************************************************************/
+uint32_t radar_fifo_frame(radar_fifo_t *fifo, uint64_t time)
+{
+    uint32_t lost = 0;
+
+    if (fifo->gap && fifo->have_frame && (time > fifo->last_frame_time))
+    {
+        const uint64_t periods = ((time - fifo->last_frame_time) + (fifo->frame_period_us / 2u)) /
+                                 fifo->frame_period_us;
+
+        lost = (periods > 1u) ? (uint32_t)(periods - 1u) : 0u;
+        fifo->stats.frames_lost += lost;
+    }
+
+    fifo->gap = false;
+    fifo->have_frame = true;
+    fifo->last_frame_time = time;
+
+    return lost;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * File Name:   radar_fifo.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_fifo.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_FIFO_H_
+#define RADAR_FIFO_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Largest interval of the simulated FIFO overflows in FIFO reads */
+#define RADAR_FIFO_MAX_INJECT_INTERVAL  (10000u)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Reasons for a FIFO recovery */
+typedef enum
+{
+    RADAR_FIFO_OVERFLOW,        /* FSTAT FOF_ERR, frames were overwritten */
+    RADAR_FIFO_UNDERFLOW,       /* FSTAT FUF_ERR, more words read than available */
+    RADAR_FIFO_READ_ERROR,      /* failed read without a FIFO error flag */
+    RADAR_FIFO_STALL            /* no FIFO interrupt for a while during acquisition */
+} radar_fifo_error_t;
+
+typedef struct
+{
+    uint32_t overflows;
+    uint32_t underflows;
+    uint32_t read_errors;
+    uint32_t stalls;
+    uint32_t recoveries;
+    uint32_t failed_recoveries;
+    uint32_t frames_lost;       /* sensor frames missing around the recoveries */
+} radar_fifo_stats_t;
+
+/* FIFO supervision of the acquisition. Keeps the frame numbers aligned with
+ * the sensor frames across a recovery and marks the first frame after it. */
+typedef struct
+{
+    uint32_t frame_period_us;
+    uint64_t last_frame_time;   /* device time of the last frame read */
+    bool have_frame;            /* last_frame_time is valid */
+    bool gap;                   /* frames may be missing before the next one */
+    bool marker;                /* next sent frame starts after a discontinuity */
+    uint16_t inject_interval;   /* every n-th read fails as overflow, 0 disables */
+    uint16_t inject_count;
+    radar_fifo_stats_t stats;
+} radar_fifo_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void radar_fifo_init(radar_fifo_t *fifo, uint32_t frame_period_us);
+void radar_fifo_restart(radar_fifo_t *fifo);
+void radar_fifo_set_inject(radar_fifo_t *fifo, uint16_t interval);
+bool radar_fifo_inject(radar_fifo_t *fifo);
+radar_fifo_error_t radar_fifo_classify(uint32_t fstat, radar_fifo_error_t otherwise);
+void radar_fifo_recovered(radar_fifo_t *fifo, radar_fifo_error_t error, bool success);
+uint32_t radar_fifo_frame(radar_fifo_t *fifo, uint64_t time);
+
+#endif /* RADAR_FIFO_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,86 @@
+/*****************************************************************************
+ * File name: radar_frame.c
+ *
+ * Description: This file implements the construction of the frame header sent
+ * in front of the samples of every radar data datagram.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_frame.h"
+#include "radar_kernels.h"
+
+/*******************************************************************************
+ * Function Name: radar_frame_write_header
+ *******************************************************************************
+ * Summary:
+ *   Fills the frame header in front of the samples of an outgoing message.
+ *
+ * Parameters:
+ *   data      : pointer to the start of the outgoing message
+ *   cmd       : command of the message
+ *   frame_num : number of the frame
+ *   frame     : processed frame
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_frame_write_header(uint8_t *data, uint8_t cmd, uint32_t frame_num, const radar_frame_t *frame)
+{
+    data[RADAR_FRAME_HDR_CMD] = cmd;
+    data[RADAR_FRAME_HDR_SEQUENCE] = RADAR_FRAME_DUMMY_BYTE;
+    radar_frame_put_u32(&data[RADAR_FRAME_HDR_FRAME_NUM], frame_num);
+    data[RADAR_FRAME_HDR_ROI_ANTENNAS] = frame->roi.antenna_mask;
+    data[RADAR_FRAME_HDR_ROI_CHIRP_STRIDE] = frame->roi.chirp_stride;
+    radar_frame_put_u16(&data[RADAR_FRAME_HDR_ROI_SAMPLE_START], frame->roi.sample_start);
+    radar_frame_put_u16(&data[RADAR_FRAME_HDR_ROI_SAMPLE_COUNT], frame->roi.sample_count);
+    data[RADAR_FRAME_HDR_DECIMATION] = frame->decimation;
+    data[RADAR_FRAME_HDR_FLAGS] = frame->flags;
+    radar_frame_put_u64(&data[RADAR_FRAME_HDR_TIMESTAMP], frame->timestamp);
+}
+
+/*******************************************************************************
+ * Function Name: radar_frame_deinterleave
+ *******************************************************************************
+ * Summary:
+ *   Splits the interleaved antennas of a frame into one contiguous block per
+ *   antenna, chirp by chirp, so that per antenna processing reads
+ *   consecutive samples.
+ *
+ * Parameters:
+ *   geometry : frame geometry
+ *   in       : samples, chirp by chirp with the antennas interleaved
+ *   out      : samples, antenna by antenna, then chirp by chirp
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_frame_deinterleave(const radar_geometry_t *geometry, const uint16_t *in, uint16_t *out)
+{
+    radar_kernel_deinterleave(in, out, geometry->samples_per_chirp, geometry->chirps_per_frame,
+                              geometry->rx_antennas);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,168 @@
+/******************************************************************************
+ * File Name:   radar_frame.h
+ *
+ * Description: This file contains the function prototypes, types and
+ *   constants used in radar_frame.c, which include the frame geometry and
+ *   the layout of the frame header sent with every radar data datagram.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_FRAME_H_
+#define RADAR_FRAME_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Frame header layout, all multi-byte fields are little endian:
+ *   [0]      command
+ *   [1]      sequence number of the frame datagrams, counted by the UDP
+ *            server when it sends them, RADAR_FRAME_DUMMY_BYTE before
+ *   [2..5]   frame number
+ *   [6]      ROI antenna mask
+ *   [7]      ROI chirp stride
+ *   [8..9]   ROI first sample
+ *   [10..11] ROI sample count
+ *   [12]     decimation factor
+ *   [13]     flags, RADAR_FRAME_FLAG_*
+ *   [14..21] time of the frame in microseconds, host time with
+ *            RADAR_FRAME_FLAG_SYNCED, device time otherwise
+ * The header size is kept a multiple of two so the samples that follow stay
+ * 16-bit aligned. */
+#define RADAR_FRAME_HEADER_SIZE             (22)
+#define RADAR_FRAME_HEADER_WORDS            (RADAR_FRAME_HEADER_SIZE / 2)
+
+#define RADAR_FRAME_HDR_CMD                 (0)
+#define RADAR_FRAME_HDR_SEQUENCE            (1)
+#define RADAR_FRAME_HDR_FRAME_NUM           (2)
+#define RADAR_FRAME_HDR_ROI_ANTENNAS        (6)
+#define RADAR_FRAME_HDR_ROI_CHIRP_STRIDE    (7)
+#define RADAR_FRAME_HDR_ROI_SAMPLE_START    (8)
+#define RADAR_FRAME_HDR_ROI_SAMPLE_COUNT    (10)
+#define RADAR_FRAME_HDR_DECIMATION          (12)
+#define RADAR_FRAME_HDR_FLAGS               (13)
+#define RADAR_FRAME_HDR_TIMESTAMP           (14)
+
+/* Value of the byte following the command */
+#define RADAR_FRAME_DUMMY_BYTE              (0xFF)
+
+/* Commands, the first byte of every message to the client */
+#define RADAR_DATA_COMMAND  (1)
+#define RADAR_STATS_COMMAND (2)
+#define RADAR_BENCH_COMMAND (3)
+#define RADAR_TARGETS_COMMAND (4)
+#define RADAR_VITAL_COMMAND (5)
+#define RADAR_SPECTRO_COMMAND (6)
+#define RADAR_TRACKS_COMMAND (7)
+#define RADAR_SYNC_COMMAND  (8)
+#define RADAR_FEC_COMMAND   (9)
+#define RADAR_NACK_COMMAND  (10)
+#define RADAR_LATEST_COMMAND (11)   /* mailbox notification, not sent */
+#define RADAR_TEST_COMMAND  (12)    /* test mode result text, sent without command byte */
+#define RADAR_LINK_COMMAND  (13)    /* link test datagram */
+#define RADAR_LINK_REPORT_COMMAND (14)  /* result of a link test run, json text */
+#define RADAR_KEEPALIVE_COMMAND (15)    /* client keepalive, renews the client lease */
+#define RADAR_WIFI_COMMAND  (16)    /* Wi-Fi link change notification, not sent */
+
+/* Frame header flags */
+#define RADAR_FRAME_FLAG_MTI                (1u << 0)   /* static clutter removed */
+#define RADAR_FRAME_FLAG_TARGETS            (1u << 1)   /* samples replaced by a target list */
+#define RADAR_FRAME_FLAG_VITAL              (1u << 2)   /* samples replaced by vital signs */
+#define RADAR_FRAME_FLAG_SPECTRO            (1u << 3)   /* samples replaced by a spectrogram column */
+#define RADAR_FRAME_FLAG_TRACKS             (1u << 4)   /* samples replaced by a track report */
+#define RADAR_FRAME_FLAG_SYNCED             (1u << 5)   /* timestamp converted to host time */
+#define RADAR_FRAME_FLAG_RESYNC             (1u << 6)   /* first frame after a FIFO recovery */
+#define RADAR_FRAME_FLAG_SEALED             (1u << 7)   /* payload encrypted, see radar_aead.h */
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Shape of a frame as read from the sensor FIFO. Samples are stored chirp by
+ * chirp, and within a chirp the RX antennas are interleaved per sample. */
+typedef struct
+{
+    uint16_t samples_per_chirp;
+    uint16_t chirps_per_frame;
+    uint8_t  rx_antennas;
+} radar_geometry_t;
+
+/* Region of interest selected from every frame before transmission */
+typedef struct
+{
+    uint8_t  antenna_mask;      /* bit n selects RX antenna n + 1 */
+    uint8_t  chirp_stride;      /* keep every n-th chirp, starting at chirp 0 */
+    uint16_t sample_start;      /* first sample of every kept chirp */
+    uint16_t sample_count;      /* number of samples kept per chirp */
+} radar_roi_t;
+
+/* Frame travelling from the FIFO read to the transmission. Processing updates
+ * the geometry, the applied region and the flags together with the samples. */
+typedef struct
+{
+    uint16_t *samples;
+    uint32_t num_samples;       /* 16-bit words, also for results replacing the samples */
+    radar_geometry_t geometry;
+    radar_roi_t roi;            /* region echoed in the frame header */
+    uint8_t decimation;
+    uint8_t flags;              /* RADAR_FRAME_FLAG_* */
+    uint64_t timestamp;         /* microseconds, see RADAR_FRAME_HDR_TIMESTAMP */
+} radar_frame_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+static inline void radar_frame_put_u16(uint8_t *dst, uint16_t value)
+{
+    dst[0] = (uint8_t)(value & 0x00ff);
+    dst[1] = (uint8_t)((value & 0xff00) >> 8);
+}
+
+static inline void radar_frame_put_u32(uint8_t *dst, uint32_t value)
+{
+    dst[0] = (uint8_t)(value & 0x000000ff);
+    dst[1] = (uint8_t)((value & 0x0000ff00) >> 8);
+    dst[2] = (uint8_t)((value & 0x00ff0000) >> 16);
+    dst[3] = (uint8_t)((value & 0xff000000) >> 24);
+}
+
+static inline void radar_frame_put_u64(uint8_t *dst, uint64_t value)
+{
+    radar_frame_put_u32(&dst[0], (uint32_t)value);
+    radar_frame_put_u32(&dst[4], (uint32_t)(value >> 32));
+}
+
+static inline uint32_t radar_frame_get_u32(const uint8_t *src)
+{
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static inline uint64_t radar_frame_get_u64(const uint8_t *src)
+{
+    return (uint64_t)radar_frame_get_u32(&src[0]) | ((uint64_t)radar_frame_get_u32(&src[4]) << 32);
+}
+
+void radar_frame_write_header(uint8_t *data, uint8_t cmd, uint32_t frame_num, const radar_frame_t *frame);
+void radar_frame_deinterleave(const radar_geometry_t *geometry, const uint16_t *in, uint16_t *out);
+
+#endif /* RADAR_FRAME_H_ */
+/* [] END OF FILE */
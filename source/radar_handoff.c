@@ -0,0 +1,178 @@
+/*****************************************************************************
+ * File name: radar_handoff.c
+ *
+ * Description: This file implements the latest-frame mailbox between the
+ * radar task and the UDP server and the histogram of the age of the frames
+ * when they are sent.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_handoff.h"
+
+/*******************************************************************************
+ * Function Name: radar_mailbox_init
+ *******************************************************************************
+ * Summary:
+ *   Hands out the three buffers, nothing is published yet.
+ *
+ * Parameters:
+ *   mailbox : mailbox to initialize
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_mailbox_init(radar_mailbox_t *mailbox)
+{
+    memset(mailbox, 0, sizeof(*mailbox));
+    mailbox->back = 0;
+    mailbox->latest = 1;
+    mailbox->front = 2;
+}
+
+/*******************************************************************************
+ * Function Name: radar_mailbox_publish
+ *******************************************************************************
+ * Summary:
+ *   Publishes the frame in the back buffer, the producer continues with the
+ *   buffer of the previous latest frame. An untaken previous frame is
+ *   superseded.
+ *
+ * Parameters:
+ *   mailbox : mailbox
+ *
+ * Return:
+ *   true if the consumer must be notified, false if a notification for an
+ *   untaken frame is still pending
+ ******************************************************************************/
+bool radar_mailbox_publish(radar_mailbox_t *mailbox)
+{
+    const uint8_t back = mailbox->back;
+    const bool notify = !mailbox->fresh;
+
+    mailbox->back = mailbox->latest;
+    mailbox->latest = back;
+    if (mailbox->fresh)
+    {
+        mailbox->superseded++;
+    }
+    mailbox->fresh = true;
+
+    return notify;
+}
+
+/*******************************************************************************
+ * Function Name: radar_mailbox_withdraw
+ *******************************************************************************
+ * Summary:
+ *   Marks the latest frame as taken, for a producer that failed to notify the
+ *   consumer.
+ *
+ * Parameters:
+ *   mailbox : mailbox
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_mailbox_withdraw(radar_mailbox_t *mailbox)
+{
+    mailbox->fresh = false;
+}
+
+/*******************************************************************************
+ * Function Name: radar_mailbox_take
+ *******************************************************************************
+ * Summary:
+ *   Takes the latest frame, its buffer becomes the front buffer. The previous
+ *   front buffer goes back to the producer.
+ *
+ * Parameters:
+ *   mailbox : mailbox
+ *
+ * Return:
+ *   true if a frame was taken, false if none was published since the last one
+ ******************************************************************************/
+bool radar_mailbox_take(radar_mailbox_t *mailbox)
+{
+    const uint8_t front = mailbox->front;
+
+    if (!mailbox->fresh)
+    {
+        return false;
+    }
+
+    mailbox->front = mailbox->latest;
+    mailbox->latest = front;
+    mailbox->fresh = false;
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_age_hist_reset
+ *******************************************************************************
+ * Summary:
+ *   Clears the age histogram.
+ *
+ * Parameters:
+ *   hist : histogram
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_age_hist_reset(radar_age_hist_t *hist)
+{
+    memset(hist, 0, sizeof(*hist));
+}
+
+/*******************************************************************************
+ * Function Name: radar_age_hist_add
+ *******************************************************************************
+ * Summary:
+ *   Counts the age of a frame in its power of two bin.
+ *
+ * Parameters:
+ *   hist   : histogram
+ *   age_us : time from the FIFO interrupt of the frame to its sending
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_age_hist_add(radar_age_hist_t *hist, uint32_t age_us)
+{
+    uint32_t bin = 0;
+
+    while ((bin < (RADAR_AGE_BINS - 1u)) && (age_us >= (RADAR_AGE_FIRST_BIN_US << bin)))
+    {
+        bin++;
+    }
+    hist->count[bin]++;
+    if (age_us > hist->max_us)
+    {
+        hist->max_us = age_us;
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * File Name:   radar_handoff.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_handoff.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_HANDOFF_H_
+#define RADAR_HANDOFF_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Hand-off of the frames to the UDP server */
+#define RADAR_HANDOFF_QUEUE             (0u)    /* every frame in order, new frames skipped while one is sent */
+#define RADAR_HANDOFF_LATEST            (1u)    /* the newest frame, older unsent ones are superseded */
+
+/* Frame buffers of the mailbox: written, latest published, being sent */
+#define RADAR_MAILBOX_SLOTS             (3u)
+
+/* Bin i of the age histogram counts ages below RADAR_AGE_FIRST_BIN_US << i,
+ * the last bin all older frames */
+#define RADAR_AGE_BINS                  (9u)
+#define RADAR_AGE_FIRST_BIN_US          (512u)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Latest-frame mailbox. The producer always has a buffer to write and the
+ * consumer always gets the newest published frame. The caller serializes
+ * the calls, they only exchange buffer indexes. */
+typedef struct
+{
+    uint8_t back;               /* written by the producer */
+    uint8_t latest;             /* last published frame */
+    uint8_t front;              /* held by the consumer */
+    bool fresh;                 /* latest not taken yet */
+    uint32_t superseded;        /* frames published again before they were taken */
+} radar_mailbox_t;
+
+typedef struct
+{
+    uint32_t count[RADAR_AGE_BINS];
+    uint32_t max_us;
+} radar_age_hist_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void radar_mailbox_init(radar_mailbox_t *mailbox);
+bool radar_mailbox_publish(radar_mailbox_t *mailbox);
+void radar_mailbox_withdraw(radar_mailbox_t *mailbox);
+bool radar_mailbox_take(radar_mailbox_t *mailbox);
+
+void radar_age_hist_reset(radar_age_hist_t *hist);
+void radar_age_hist_add(radar_age_hist_t *hist, uint32_t age_us);
+
+#endif /* RADAR_HANDOFF_H_ */
+/* [] END OF FILE */
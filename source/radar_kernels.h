@@ -0,0 +1,208 @@
+/******************************************************************************
+ * File Name:   radar_kernels.h
+ *
+ * Description: This file contains the per-frame kernels whose loops depend on
+ *   the frame geometry, written once and instantiated for every radar profile
+ *   with constant geometry as well as for any geometry.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_KERNELS_H_
+#define RADAR_KERNELS_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "radar_frame.h"
+#include "radar_roi.h"
+#include "xensiv_bgt60trxx.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* The kernels are inlined into the instance of every profile, so that loop
+ * bounds and strides become constants the compiler unrolls and folds */
+#define RADAR_KERNEL_INLINE         static inline __attribute__((always_inline))
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Kernels of one frame geometry, see radar_profile.h */
+typedef struct
+{
+    uint32_t (*test_verify)(const uint16_t *samples, uint16_t *test_word, uint32_t *first_error);
+    void (*deinterleave)(const uint16_t *in, uint16_t *out);
+    uint32_t (*roi_gather)(const radar_roi_t *roi, const uint16_t *frame, uint16_t *out);
+} radar_kernels_t;
+
+/*******************************************************************************
+ * Function Name: radar_kernel_test_verify
+ *******************************************************************************
+ * Summary:
+ *   Compares the RX1 samples of a frame with the test sequence. The sequence
+ *   advances by one word per sample of any antenna.
+ *
+ * Parameters:
+ *   samples     : frame buffer
+ *   num_samples : number of samples in the frame, a multiple of rx_antennas
+ *   rx_antennas : number of interleaved RX antennas
+ *   test_word   : sequence state, updated for the next frame
+ *   first_error : index of the first wrong sample, untouched if all match
+ *
+ * Return:
+ *   number of wrong samples
+ ******************************************************************************/
+RADAR_KERNEL_INLINE uint32_t radar_kernel_test_verify(const uint16_t *samples, uint32_t num_samples,
+                                                      uint32_t rx_antennas, uint16_t *test_word,
+                                                      uint32_t *first_error)
+{
+    uint16_t word = *test_word;
+    uint32_t errors = 0;
+
+    for (uint32_t sample_idx = 0; sample_idx < num_samples; sample_idx += rx_antennas)
+    {
+        if (word != samples[sample_idx])
+        {
+            if (errors == 0)
+            {
+                *first_error = sample_idx;
+            }
+            errors++;
+        }
+
+        for (uint32_t rx = 0; rx < rx_antennas; ++rx)
+        {
+            word = xensiv_bgt60trxx_get_next_test_word(word);
+        }
+    }
+
+    *test_word = word;
+    return errors;
+}
+
+/*******************************************************************************
+ * Function Name: radar_kernel_deinterleave
+ *******************************************************************************
+ * Summary:
+ *   Splits the interleaved antennas of a frame into one contiguous block per
+ *   antenna, chirp by chirp.
+ *
+ * Parameters:
+ *   in                : samples, chirp by chirp with the antennas interleaved
+ *   out               : samples, antenna by antenna, then chirp by chirp
+ *   samples_per_chirp : frame geometry
+ *   chirps_per_frame  : frame geometry
+ *   rx_antennas       : frame geometry
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+RADAR_KERNEL_INLINE void radar_kernel_deinterleave(const uint16_t *in, uint16_t *out, uint32_t samples_per_chirp,
+                                                   uint32_t chirps_per_frame, uint32_t rx_antennas)
+{
+    const uint32_t antenna_size = samples_per_chirp * chirps_per_frame;
+
+    if (rx_antennas == 1u)
+    {
+        memcpy(out, in, antenna_size * sizeof(uint16_t));
+        return;
+    }
+
+    for (uint32_t rx = 0; rx < rx_antennas; ++rx)
+    {
+        const uint16_t *src = &in[rx];
+        uint16_t *dst = &out[rx * antenna_size];
+
+        for (uint32_t i = 0; i < antenna_size; ++i)
+        {
+            dst[i] = *src;
+            src += rx_antennas;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_kernel_roi_gather
+ *******************************************************************************
+ * Summary:
+ *   Copies the samples of the region of interest into a contiguous buffer,
+ *   keeping the chirp by chirp layout with interleaved antennas. The region
+ *   must have been checked with radar_roi_is_valid().
+ *
+ * Parameters:
+ *   roi               : region of interest to extract
+ *   frame             : input frame
+ *   out               : output buffer, must not overlap the input frame
+ *   samples_per_chirp : geometry of the input frame
+ *   chirps_per_frame  : geometry of the input frame
+ *   rx_antennas       : geometry of the input frame
+ *
+ * Return:
+ *   number of samples written to the output buffer
+ ******************************************************************************/
+RADAR_KERNEL_INLINE uint32_t radar_kernel_roi_gather(const radar_roi_t *roi, const uint16_t *frame, uint16_t *out,
+                                                     uint32_t samples_per_chirp, uint32_t chirps_per_frame,
+                                                     uint32_t rx_antennas)
+{
+    const uint32_t chirp_length = samples_per_chirp * rx_antennas;
+    uint8_t selected[RADAR_ROI_MAX_ANTENNAS];
+    uint32_t num_selected = 0;
+    uint16_t *dst = out;
+
+    for (uint32_t rx = 0; rx < rx_antennas; ++rx)
+    {
+        if ((roi->antenna_mask & (1u << rx)) != 0)
+        {
+            selected[num_selected++] = (uint8_t)rx;
+        }
+    }
+
+    for (uint32_t chirp = 0; chirp < chirps_per_frame; chirp += roi->chirp_stride)
+    {
+        const uint16_t *src = &frame[(chirp * chirp_length) + ((uint32_t)roi->sample_start * rx_antennas)];
+
+        if (num_selected == rx_antennas)
+        {
+            /* All antennas selected, the sample window is contiguous */
+            const uint32_t length = (uint32_t)roi->sample_count * rx_antennas;
+
+            memcpy(dst, src, length * sizeof(uint16_t));
+            dst += length;
+        }
+        else
+        {
+            for (uint32_t sample = 0; sample < roi->sample_count; ++sample)
+            {
+                for (uint32_t i = 0; i < num_selected; ++i)
+                {
+                    *dst++ = src[selected[i]];
+                }
+                src += rx_antennas;
+            }
+        }
+    }
+
+    return (uint32_t)(dst - out);
+}
+
+#endif /* RADAR_KERNELS_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,307 @@
+/*****************************************************************************
+ * File name: radar_link.c
+ *
+ * Description: Paced sender of the link capacity test: sends datagrams of a
+ * given size in bursts at a given rate, numbered and timestamped so the
+ * client can measure the throughput, loss and delay of the link.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <inttypes.h>
+#include <stdio.h>
+
+/* Header file for local module */
+#include "radar_frame.h"
+#include "radar_link.h"
+
+/*******************************************************************************
+ * Function Name: burst_time_us
+ *******************************************************************************
+ * Summary:
+ *   Computes the scheduled start of a burst.
+ *
+ * Parameters:
+ *   link  : link test
+ *   burst : burst number in the run
+ *
+ * Return:
+ *   time in microseconds
+ ******************************************************************************/
+static uint64_t burst_time_us(const radar_link_t *link, uint32_t burst)
+{
+    return link->start_us + (((uint64_t)burst * link->config.batch * 1000000u) / link->config.rate);
+}
+
+/*******************************************************************************
+ * Function Name: radar_link_config_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks the datagram size, burst size, rate and count of a run.
+ *
+ * Parameters:
+ *   config : link test settings
+ *
+ * Return:
+ *   true if the settings are supported
+ ******************************************************************************/
+bool radar_link_config_is_valid(const radar_link_config_t *config)
+{
+    return (config->size >= RADAR_LINK_HEADER_SIZE) && (config->size <= RADAR_LINK_MAX_SIZE) &&
+           (config->batch >= 1u) && (config->batch <= RADAR_LINK_MAX_BATCH) &&
+           (config->rate >= 1u) && (config->rate <= RADAR_LINK_MAX_RATE) &&
+           (config->count >= 1u) && (config->count <= RADAR_LINK_MAX_COUNT);
+}
+
+/*******************************************************************************
+ * Function Name: radar_link_init
+ *******************************************************************************
+ * Summary:
+ *   Sets up an idle link test with the default settings.
+ *
+ * Parameters:
+ *   link : link test
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_link_init(radar_link_t *link)
+{
+    *link = (radar_link_t){
+        .config = {
+            .size = RADAR_LINK_DEFAULT_SIZE,
+            .batch = RADAR_LINK_DEFAULT_BATCH,
+            .rate = RADAR_LINK_DEFAULT_RATE,
+            .count = RADAR_LINK_DEFAULT_COUNT
+        }
+    };
+}
+
+/*******************************************************************************
+ * Function Name: radar_link_start
+ *******************************************************************************
+ * Summary:
+ *   Starts a run. The first burst is due at once, a run still going on is
+ *   replaced.
+ *
+ * Parameters:
+ *   link   : link test
+ *   config : settings of the run, checked with radar_link_config_is_valid()
+ *   now_us : device time
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_link_start(radar_link_t *link, const radar_link_config_t *config, uint64_t now_us)
+{
+    link->config = *config;
+    link->running = true;
+    link->run++;
+    link->start_us = now_us;
+    link->end_us = now_us;
+    link->sent = 0;
+    link->failed = 0;
+    link->max_lag_us = 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_link_stop
+ *******************************************************************************
+ * Summary:
+ *   Ends a run before all its datagrams are sent.
+ *
+ * Parameters:
+ *   link   : link test
+ *   now_us : device time
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_link_stop(radar_link_t *link, uint64_t now_us)
+{
+    if (link->running)
+    {
+        link->running = false;
+        link->end_us = now_us;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_link_due
+ *******************************************************************************
+ * Summary:
+ *   Counts the datagrams whose burst has started and tracks how far the
+ *   sender is behind the schedule. A sender that falls behind sends the late
+ *   datagrams back to back, so the rate of the run is kept on average and the
+ *   lag shows that the device could not sustain it.
+ *
+ * Parameters:
+ *   link   : link test
+ *   now_us : device time
+ *
+ * Return:
+ *   number of datagrams to send now
+ ******************************************************************************/
+uint32_t radar_link_due(radar_link_t *link, uint64_t now_us)
+{
+    const uint32_t done = link->sent + link->failed;
+    uint64_t due_bursts;
+    uint64_t due;
+    uint64_t scheduled;
+
+    if (!link->running || (now_us < link->start_us))
+    {
+        return 0;
+    }
+
+    due_bursts = (((now_us - link->start_us) * link->config.rate) / (link->config.batch * 1000000u)) + 1u;
+    due = due_bursts * link->config.batch;
+    if (due > link->config.count)
+    {
+        due = link->config.count;
+    }
+    if (due <= done)
+    {
+        return 0;
+    }
+
+    scheduled = burst_time_us(link, done / link->config.batch);
+    if ((now_us - scheduled) > link->max_lag_us)
+    {
+        link->max_lag_us = (uint32_t)(now_us - scheduled);
+    }
+
+    return (uint32_t)(due - done);
+}
+
+/*******************************************************************************
+ * Function Name: radar_link_next_us
+ *******************************************************************************
+ * Summary:
+ *   Gives the start of the next burst.
+ *
+ * Parameters:
+ *   link : link test
+ *
+ * Return:
+ *   device time in microseconds, UINT64_MAX if no run is going on
+ ******************************************************************************/
+uint64_t radar_link_next_us(const radar_link_t *link)
+{
+    const uint32_t done = link->sent + link->failed;
+
+    if (!link->running)
+    {
+        return UINT64_MAX;
+    }
+    return burst_time_us(link, done / link->config.batch);
+}
+
+/*******************************************************************************
+ * Function Name: radar_link_write_header
+ *******************************************************************************
+ * Summary:
+ *   Writes the header of the next datagram of the run.
+ *
+ * Parameters:
+ *   link     : link test
+ *   datagram : datagram of the configured size
+ *   time_us  : send time
+ *   flags    : RADAR_FRAME_FLAG_SYNCED if the send time is host time
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_link_write_header(const radar_link_t *link, uint8_t *datagram, uint64_t time_us, uint8_t flags)
+{
+    datagram[0] = RADAR_LINK_COMMAND;
+    datagram[RADAR_LINK_HDR_RUN] = link->run;
+    radar_frame_put_u32(&datagram[RADAR_LINK_HDR_SEQUENCE], link->sent + link->failed);
+    radar_frame_put_u64(&datagram[RADAR_LINK_HDR_TIMESTAMP], time_us);
+    datagram[RADAR_LINK_HDR_FLAGS] = flags;
+    datagram[RADAR_LINK_HDR_BATCH] = link->config.batch;
+}
+
+/*******************************************************************************
+ * Function Name: radar_link_sent
+ *******************************************************************************
+ * Summary:
+ *   Counts a datagram of the run and ends the run after the last one.
+ *
+ * Parameters:
+ *   link   : link test
+ *   sent   : the network stack took the datagram
+ *   now_us : device time
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_link_sent(radar_link_t *link, bool sent, uint64_t now_us)
+{
+    if (sent)
+    {
+        link->sent++;
+    }
+    else
+    {
+        link->failed++;
+    }
+
+    if ((link->sent + link->failed) >= link->config.count)
+    {
+        radar_link_stop(link, now_us);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_link_report
+ *******************************************************************************
+ * Summary:
+ *   Writes the result of the last run as json text.
+ *
+ * Parameters:
+ *   link   : link test
+ *   buffer : output buffer
+ *   size   : size of the output buffer
+ *
+ * Return:
+ *   length of the text
+ ******************************************************************************/
+uint32_t radar_link_report(const radar_link_t *link, char *buffer, uint32_t size)
+{
+    const int length = snprintf(buffer, size,
+                                "{\"run\":%u,\"size\":%u,\"batch\":%u,\"rate\":%u,\"count\":%" PRIu32
+                                ",\"sent\":%" PRIu32 ",\"failed\":%" PRIu32 ",\"duration_us\":%" PRIu32
+                                ",\"max_lag_us\":%" PRIu32 ",\"done\":%s}",
+                                link->run, link->config.size, link->config.batch, link->config.rate,
+                                link->config.count, link->sent, link->failed,
+                                (uint32_t)(link->end_us - link->start_us), link->max_lag_us,
+                                link->running ? "false" : "true");
+
+    if (length < 0)
+    {
+        return 0;
+    }
+    return ((uint32_t)length < size) ? (uint32_t)length : (size - 1u);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,101 @@
+/******************************************************************************
+ * File Name:   radar_link.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_link.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_LINK_H_
+#define RADAR_LINK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Link test datagram:
+ *   [0]       command, RADAR_LINK_COMMAND
+ *   [1]       run number, counts the runs started
+ *   [2..5]    datagram number in the run, little endian
+ *   [6..13]   send time in microseconds, little endian
+ *   [14]      flags, RADAR_FRAME_FLAG_SYNCED if the time is host time
+ *   [15]      datagrams per burst
+ *   [16..]    filler up to the datagram size */
+#define RADAR_LINK_HDR_RUN              (1u)
+#define RADAR_LINK_HDR_SEQUENCE         (2u)
+#define RADAR_LINK_HDR_TIMESTAMP        (6u)
+#define RADAR_LINK_HDR_FLAGS            (14u)
+#define RADAR_LINK_HDR_BATCH            (15u)
+#define RADAR_LINK_HEADER_SIZE          (16u)
+
+/* Largest datagram of a link test, frames of larger profiles are IP fragmented
+ * the same way */
+#define RADAR_LINK_MAX_SIZE             (8192u)
+#define RADAR_LINK_MAX_BATCH            (32u)
+#define RADAR_LINK_MAX_RATE             (20000u)
+#define RADAR_LINK_MAX_COUNT            (100000u)
+
+#define RADAR_LINK_DEFAULT_SIZE         (1024u)
+#define RADAR_LINK_DEFAULT_BATCH        (1u)
+#define RADAR_LINK_DEFAULT_RATE         (200u)
+#define RADAR_LINK_DEFAULT_COUNT        (1000u)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t size;              /* bytes per datagram */
+    uint8_t batch;              /* datagrams sent back to back per burst */
+    uint16_t rate;              /* datagrams per second */
+    uint32_t count;             /* datagrams of the run */
+} radar_link_config_t;
+
+typedef struct
+{
+    radar_link_config_t config;
+    bool running;
+    uint8_t run;
+    uint64_t start_us;
+    uint64_t end_us;
+    uint32_t sent;
+    uint32_t failed;            /* rejected by the network stack */
+    uint32_t max_lag_us;        /* longest delay of a burst behind its schedule */
+} radar_link_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+bool radar_link_config_is_valid(const radar_link_config_t *config);
+void radar_link_init(radar_link_t *link);
+void radar_link_start(radar_link_t *link, const radar_link_config_t *config, uint64_t now_us);
+void radar_link_stop(radar_link_t *link, uint64_t now_us);
+uint32_t radar_link_due(radar_link_t *link, uint64_t now_us);
+uint64_t radar_link_next_us(const radar_link_t *link);
+void radar_link_write_header(const radar_link_t *link, uint8_t *datagram, uint64_t time_us, uint8_t flags);
+void radar_link_sent(radar_link_t *link, bool sent, uint64_t now_us);
+uint32_t radar_link_report(const radar_link_t *link, char *buffer, uint32_t size);
+
+#endif /* RADAR_LINK_H_ */
+/* [] END OF FILE */
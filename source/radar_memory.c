@@ -0,0 +1,50 @@
+/*****************************************************************************
+ * File name: radar_memory.c
+ *
+ * Description: This file allocates the stacks, control blocks and queue
+ * storage of the application tasks and RTOS objects as laid out by the memory
+ * plan in radar_memory.h.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file for local module */
+#include "radar_memory.h"
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+StackType_t udp_server_task_stack[UDP_SERVER_TASK_STACK_SIZE];
+StaticTask_t udp_server_task_buffer;
+StackType_t radar_task_stack[RADAR_TASK_STACK_SIZE];
+StaticTask_t radar_task_buffer;
+StackType_t radar_config_task_stack[RADAR_CONFIG_TASK_STACK_SIZE];
+StaticTask_t radar_config_task_buffer;
+StackType_t wifi_join_task_stack[UDP_SERVER_WIFI_TASK_STACK_SIZE];
+StaticTask_t wifi_join_task_buffer;
+
+uint8_t radar_data_queue_storage[RADAR_MEMORY_DATA_QUEUE_LENGTH * sizeof(void *)];
+StaticQueue_t radar_data_queue_buffer;
+uint8_t radar_config_queue_storage[RADAR_MEMORY_CONFIG_QUEUE_LENGTH * sizeof(char *)];
+StaticQueue_t radar_config_queue_buffer;
+StaticSemaphore_t sem_udp_payload_buffer;
+
+/* [] END OF FILE */
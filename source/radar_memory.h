@@ -0,0 +1,143 @@
+/******************************************************************************
+ * File Name:   radar_memory.h
+ *
+ * Description: This file contains the memory plan, the constants used by the
+ *   tasks to size their statically allocated memory.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_MEMORY_H_
+#define RADAR_MEMORY_H_
+
+/* Memory plan of the application. Every RTOS object, frame buffer and
+ * scratch area is allocated statically with a size derived here from the
+ * largest frame geometry of the radar profiles; only the Wi-Fi and network
+ * stack use the heap. Scaling the frames up fails to compile when a budget below is
+ * exceeded, and the post-build RAM report lists what was linked. */
+
+#include "FreeRTOS.h"
+
+#include "radar_config_task.h"
+#include "radar_aead.h"
+#include "radar_fec.h"
+#include "radar_frame.h"
+#include "radar_handoff.h"
+#include "radar_link.h"
+#include "radar_profile_table.h"
+#include "radar_resend.h"
+#include "radar_stages.h"
+#include "radar_stream.h"
+#include "radar_task.h"
+#include "radar_wifi.h"
+#include "udp_server.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Sensor frames of the largest profile */
+#define RADAR_MEMORY_FRAME_SAMPLES(samples_per_chirp, chirps_per_frame, rx_antennas) \
+    ((samples_per_chirp) * (chirps_per_frame) * (rx_antennas))
+#define RADAR_MEMORY_SAMPLES_PER_FRAME      RADAR_PROFILE_MAX_OF(RADAR_MEMORY_FRAME_SAMPLES)
+
+/* Largest datagram carrying a frame, results replace the samples in place.
+ * The encryption appends its salt and tag in the same buffer. */
+#define RADAR_MEMORY_MAX_FRAME_DATAGRAM     (RADAR_FRAME_HEADER_SIZE + (2u * RADAR_MEMORY_SAMPLES_PER_FRAME) + \
+                                             RADAR_AEAD_OVERHEAD)
+#define RADAR_MEMORY_TX_BUFFER_WORDS        (RADAR_FRAME_HEADER_WORDS + RADAR_MEMORY_SAMPLES_PER_FRAME + \
+                                             (RADAR_AEAD_OVERHEAD / 2u))
+
+/* Largest UDP payload of an IPv4 datagram, larger ones cannot be sent */
+#define RADAR_MEMORY_MAX_UDP_PAYLOAD        (65507u)
+
+/* TCP stream: frames are collected up to one segment, the last one may
+ * overrun it by a whole datagram with its size prefix */
+#define RADAR_MEMORY_TCP_SEGMENT_SIZE       (1460u)
+#define RADAR_MEMORY_TCP_BUFFER_SIZE        (RADAR_STREAM_BUFFER_SIZE(RADAR_MEMORY_TCP_SEGMENT_SIZE, \
+                                                                       RADAR_MEMORY_MAX_FRAME_DATAGRAM))
+
+/* Messages that can wait in the radar data queue at once: a queued frame and
+ * a mailbox notification while the hand-off mode changes, the statistics
+ * reply, the retransmission, the link test, the client lease and the Wi-Fi
+ * link wake-ups. Benchmark records wait for space. The configuration queue
+ * holds client commands and the sensor stop or restart of the client lease. */
+#define RADAR_MEMORY_DATA_QUEUE_MESSAGES    (2u + 1u + 1u + 1u + 1u + 1u)
+#define RADAR_MEMORY_DATA_QUEUE_LENGTH      (RADAR_MEMORY_DATA_QUEUE_MESSAGES)
+#define RADAR_MEMORY_CONFIG_QUEUE_LENGTH    (4u)
+
+/* RAM of the memory plan per subsystem, in bytes */
+#define RADAR_MEMORY_TASKS_SIZE             (((UDP_SERVER_TASK_STACK_SIZE + RADAR_TASK_STACK_SIZE + \
+                                               RADAR_CONFIG_TASK_STACK_SIZE + UDP_SERVER_WIFI_TASK_STACK_SIZE) * \
+                                              sizeof(StackType_t)) + (4u * sizeof(StaticTask_t)))
+#define RADAR_MEMORY_QUEUES_SIZE            ((RADAR_MEMORY_DATA_QUEUE_LENGTH * sizeof(void *)) + \
+                                             (RADAR_MEMORY_CONFIG_QUEUE_LENGTH * sizeof(char *)) + \
+                                             (2u * sizeof(StaticQueue_t)) + sizeof(StaticSemaphore_t))
+#define RADAR_MEMORY_FRAMES_SIZE            ((RADAR_MEMORY_SAMPLES_PER_FRAME * sizeof(uint16_t)) + \
+                                             (RADAR_MAILBOX_SLOTS * RADAR_MEMORY_TX_BUFFER_WORDS * sizeof(uint16_t)))
+#define RADAR_MEMORY_PROCESSING_SIZE        RADAR_PROFILE_MAX_OF(RADAR_STAGES_ARENA_SIZE)
+#define RADAR_MEMORY_TRANSPORT_SIZE         (RADAR_FEC_MEMORY_SIZE(RADAR_MEMORY_MAX_FRAME_DATAGRAM) + \
+                                             RADAR_RESEND_MEMORY_SIZE(RADAR_MEMORY_MAX_FRAME_DATAGRAM) + \
+                                             RADAR_WIFI_MEMORY_SIZE(RADAR_MEMORY_MAX_FRAME_DATAGRAM) + \
+                                             RADAR_MEMORY_TCP_BUFFER_SIZE + RADAR_LINK_MAX_SIZE)
+#define RADAR_MEMORY_TOTAL_SIZE             (RADAR_MEMORY_TASKS_SIZE + RADAR_MEMORY_QUEUES_SIZE + \
+                                             RADAR_MEMORY_FRAMES_SIZE + RADAR_MEMORY_PROCESSING_SIZE + \
+                                             RADAR_MEMORY_TRANSPORT_SIZE)
+
+/* Half of the 1 MB SRAM for the plan, the rest is left to the heap of the
+ * Wi-Fi and network stack */
+#define RADAR_MEMORY_RAM_BUDGET             (512u * 1024u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Stacks and control blocks of the application tasks and RTOS objects,
+ * defined in radar_memory.c */
+extern StackType_t udp_server_task_stack[UDP_SERVER_TASK_STACK_SIZE];
+extern StaticTask_t udp_server_task_buffer;
+extern StackType_t radar_task_stack[RADAR_TASK_STACK_SIZE];
+extern StaticTask_t radar_task_buffer;
+extern StackType_t radar_config_task_stack[RADAR_CONFIG_TASK_STACK_SIZE];
+extern StaticTask_t radar_config_task_buffer;
+extern StackType_t wifi_join_task_stack[UDP_SERVER_WIFI_TASK_STACK_SIZE];
+extern StaticTask_t wifi_join_task_buffer;
+
+extern uint8_t radar_data_queue_storage[RADAR_MEMORY_DATA_QUEUE_LENGTH * sizeof(void *)];
+extern StaticQueue_t radar_data_queue_buffer;
+extern uint8_t radar_config_queue_storage[RADAR_MEMORY_CONFIG_QUEUE_LENGTH * sizeof(char *)];
+extern StaticQueue_t radar_config_queue_buffer;
+extern StaticSemaphore_t sem_udp_payload_buffer;
+
+/*******************************************************************************
+ * Compile time checks
+ ******************************************************************************/
+_Static_assert(RADAR_MEMORY_TOTAL_SIZE <= RADAR_MEMORY_RAM_BUDGET,
+               "Statically allocated memory exceeds RADAR_MEMORY_RAM_BUDGET");
+_Static_assert(RADAR_MEMORY_MAX_FRAME_DATAGRAM <= RADAR_MEMORY_MAX_UDP_PAYLOAD,
+               "Frame datagram exceeds the largest UDP payload");
+_Static_assert(RADAR_FEC_SLOT_SIZE(RADAR_MEMORY_MAX_FRAME_DATAGRAM) <= RADAR_MEMORY_MAX_UDP_PAYLOAD,
+               "Parity datagram exceeds the largest UDP payload");
+_Static_assert(RADAR_MEMORY_DATA_QUEUE_LENGTH >= RADAR_MEMORY_DATA_QUEUE_MESSAGES,
+               "Radar data queue too short for the messages that can wait at once");
+_Static_assert(RADAR_MAILBOX_SLOTS >= 3u,
+               "Latest-frame mailbox needs a buffer each for the producer, the latest frame and the consumer");
+
+#endif /* RADAR_MEMORY_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,153 @@
+/*****************************************************************************
+ * File name: radar_mti.c
+ *
+ * Description: This file implements the static clutter removal (moving target
+ * indication). An exponential moving average of every sample position is kept
+ * as background estimate and subtracted from the incoming chirps.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file for local module */
+#include "radar_mti.h"
+
+/*******************************************************************************
+ * Function Name: radar_mti_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes the clutter removal with the memory for its background.
+ *
+ * Parameters:
+ *   mti        : clutter removal state
+ *   background : background memory, one value per sample and antenna of a chirp
+ *   capacity   : number of values in the background memory
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_mti_init(radar_mti_t *mti, int32_t *background, uint32_t capacity)
+{
+    mti->background = background;
+    mti->capacity = capacity;
+    mti->primed = false;
+}
+
+/*******************************************************************************
+ * Function Name: radar_mti_reset
+ *******************************************************************************
+ * Summary:
+ *   Discards the background. The next chirp becomes the new background.
+ *
+ * Parameters:
+ *   mti : clutter removal state
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_mti_reset(radar_mti_t *mti)
+{
+    mti->primed = false;
+}
+
+/*******************************************************************************
+ * Function Name: radar_mti_config_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks the parameters of the clutter removal.
+ *
+ * Parameters:
+ *   config : clutter removal parameters
+ *
+ * Return:
+ *   true if the parameters are in range
+ ******************************************************************************/
+bool radar_mti_config_is_valid(const radar_mti_config_t *config)
+{
+    return (config->alpha_shift >= RADAR_MTI_MIN_ALPHA_SHIFT) &&
+           (config->alpha_shift <= RADAR_MTI_MAX_ALPHA_SHIFT);
+}
+
+/*******************************************************************************
+ * Function Name: radar_mti_process
+ *******************************************************************************
+ * Summary:
+ *   Subtracts the background from every chirp of a frame in place and updates
+ *   the background with the chirp. The residual is written offset by
+ *   RADAR_MTI_OUTPUT_OFFSET so the frame keeps the unsigned 12-bit format.
+ *
+ * Parameters:
+ *   mti         : clutter removal state
+ *   alpha_shift : background weight of a new chirp is 2^-alpha_shift
+ *   geometry    : geometry of the frame, a chirp must fit the background
+ *   frame       : frame to process
+ *
+ * Return:
+ *   mean residual power per sample of the frame
+ ******************************************************************************/
+uint32_t radar_mti_process(radar_mti_t *mti, uint8_t alpha_shift,
+                           const radar_geometry_t *geometry, uint16_t *frame)
+{
+    const uint32_t chirp_length = (uint32_t)geometry->samples_per_chirp * geometry->rx_antennas;
+    int32_t *background = mti->background;
+    uint16_t *sample = frame;
+    uint64_t energy = 0;
+
+    if (chirp_length > mti->capacity)
+    {
+        return 0;
+    }
+
+    if (!mti->primed)
+    {
+        for (uint32_t i = 0; i < chirp_length; ++i)
+        {
+            background[i] = (int32_t)frame[i] << 8;
+        }
+        mti->primed = true;
+    }
+
+    for (uint32_t chirp = 0; chirp < geometry->chirps_per_frame; ++chirp)
+    {
+        for (uint32_t i = 0; i < chirp_length; ++i)
+        {
+            const int32_t residual_q8 = ((int32_t)*sample << 8) - background[i];
+            const int32_t residual = (residual_q8 + 128) >> 8;
+            int32_t out = residual + RADAR_MTI_OUTPUT_OFFSET;
+
+            background[i] += residual_q8 >> alpha_shift;
+            energy += (uint64_t)((int64_t)residual * residual);
+
+            if (out < 0)
+            {
+                out = 0;
+            }
+            else if (out > RADAR_MTI_SAMPLE_MAX)
+            {
+                out = RADAR_MTI_SAMPLE_MAX;
+            }
+            *sample++ = (uint16_t)out;
+        }
+    }
+
+    return (uint32_t)(energy / (chirp_length * geometry->chirps_per_frame));
+}
+
+/* [] END OF FILE */
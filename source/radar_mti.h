@@ -0,0 +1,75 @@
+/******************************************************************************
+ * File Name:   radar_mti.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_mti.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_MTI_H_
+#define RADAR_MTI_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "radar_frame.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RADAR_MTI_MIN_ALPHA_SHIFT       (1)
+#define RADAR_MTI_MAX_ALPHA_SHIFT       (12)
+#define RADAR_MTI_DEFAULT_ALPHA_SHIFT   (4)
+
+/* Residual samples are offset to the middle of the 12-bit ADC range */
+#define RADAR_MTI_OUTPUT_OFFSET         (0x0800)
+#define RADAR_MTI_SAMPLE_MAX            (0x0FFF)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    bool     enabled;
+    uint8_t  alpha_shift;       /* background weight of a new chirp is 2^-alpha_shift */
+    uint32_t energy_threshold;  /* frames with a lower mean residual power are skipped, 0 keeps all */
+} radar_mti_config_t;
+
+/* Background estimate, one Q8 value per sample and antenna of a chirp */
+typedef struct
+{
+    int32_t *background;
+    uint32_t capacity;
+    bool primed;
+} radar_mti_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void radar_mti_init(radar_mti_t *mti, int32_t *background, uint32_t capacity);
+void radar_mti_reset(radar_mti_t *mti);
+bool radar_mti_config_is_valid(const radar_mti_config_t *config);
+uint32_t radar_mti_process(radar_mti_t *mti, uint8_t alpha_shift,
+                           const radar_geometry_t *geometry, uint16_t *frame);
+
+#endif /* RADAR_MTI_H_ */
+/* [] END OF FILE */
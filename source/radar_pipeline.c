@@ -0,0 +1,268 @@
+/*****************************************************************************
+ * File name: radar_pipeline.c
+ *
+ * Description: This file implements the frame processing pipeline that runs a
+ * runtime selected chain of stages between the FIFO read and the
+ * transmission, together with the static scratch arena the stages allocate
+ * their state from.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <stddef.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_cycles.h"
+#include "radar_pipeline.h"
+
+/*******************************************************************************
+ * Function Name: radar_arena_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes a scratch arena over a memory block.
+ *
+ * Parameters:
+ *   arena : arena to initialize
+ *   base  : memory block, aligned to RADAR_ARENA_ALIGNMENT
+ *   size  : size of the memory block in bytes
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_arena_init(radar_arena_t *arena, void *base, uint32_t size)
+{
+    arena->base = (uint8_t *)base;
+    arena->size = size;
+    arena->used = 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_arena_alloc
+ *******************************************************************************
+ * Summary:
+ *   Hands out the next block of an arena.
+ *
+ * Parameters:
+ *   arena : arena to allocate from
+ *   size  : size of the block in bytes
+ *
+ * Return:
+ *   block aligned to RADAR_ARENA_ALIGNMENT, NULL if the arena is exhausted
+ ******************************************************************************/
+void *radar_arena_alloc(radar_arena_t *arena, uint32_t size)
+{
+    const uint32_t block_size = RADAR_ARENA_BLOCK_SIZE(size);
+    void *block;
+
+    if (block_size > (arena->size - arena->used))
+    {
+        return NULL;
+    }
+
+    block = &arena->base[arena->used];
+    arena->used += block_size;
+
+    return block;
+}
+
+/*******************************************************************************
+ * Function Name: radar_pipeline_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes an empty pipeline with its two frame buffers. Each buffer must
+ *   hold a complete sensor frame.
+ *
+ * Parameters:
+ *   pipeline : pipeline to initialize
+ *   buffer_a : first frame buffer, frames enter the pipeline in this buffer
+ *   buffer_b : second frame buffer
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_pipeline_init(radar_pipeline_t *pipeline, uint16_t *buffer_a, uint16_t *buffer_b)
+{
+    memset(pipeline, 0, sizeof(*pipeline));
+    pipeline->buffers[0] = buffer_a;
+    pipeline->buffers[1] = buffer_b;
+}
+
+/*******************************************************************************
+ * Function Name: radar_pipeline_set_buffer_b
+ *******************************************************************************
+ * Summary:
+ *   Replaces the second frame buffer between two frames, for callers that
+ *   rotate their output buffers.
+ *
+ * Parameters:
+ *   pipeline : pipeline
+ *   buffer_b : second frame buffer
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_pipeline_set_buffer_b(radar_pipeline_t *pipeline, uint16_t *buffer_b)
+{
+    pipeline->buffers[1] = buffer_b;
+}
+
+/*******************************************************************************
+ * Function Name: radar_pipeline_parse
+ *******************************************************************************
+ * Summary:
+ *   Looks up the stages named in a comma separated pipeline description, e.g.
+ *   "decim,mti,roi". An empty description selects no stage.
+ *
+ * Parameters:
+ *   registry      : stages available
+ *   registry_size : number of stages available
+ *   description   : pipeline description, not null terminated
+ *   length        : length of the description
+ *   stages        : RADAR_PIPELINE_MAX_STAGES entries for the selected stages
+ *   num_stages    : number of selected stages
+ *
+ * Return:
+ *   true if all names are known and the pipeline is not too long
+ ******************************************************************************/
+bool radar_pipeline_parse(const radar_stage_t *registry, uint32_t registry_size,
+                          const char *description, uint32_t length,
+                          const radar_stage_t **stages, uint32_t *num_stages)
+{
+    uint32_t count = 0;
+    uint32_t start = 0;
+
+    while (start < length)
+    {
+        const char *separator = memchr(&description[start], RADAR_PIPELINE_SEPARATOR, length - start);
+        const uint32_t end = (separator != NULL) ? (uint32_t)(separator - description) : length;
+        const uint32_t name_length = end - start;
+        const radar_stage_t *stage = NULL;
+
+        for (uint32_t i = 0; i < registry_size; ++i)
+        {
+            if ((strlen(registry[i].name) == name_length) &&
+                (memcmp(registry[i].name, &description[start], name_length) == 0))
+            {
+                stage = &registry[i];
+                break;
+            }
+        }
+
+        if ((stage == NULL) || (count == RADAR_PIPELINE_MAX_STAGES))
+        {
+            return false;
+        }
+
+        stages[count++] = stage;
+        start = end + 1u;
+    }
+
+    *num_stages = count;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_pipeline_set_stages
+ *******************************************************************************
+ * Summary:
+ *   Replaces the stages of a pipeline and clears the cycle statistics. Must
+ *   not be called while the pipeline runs.
+ *
+ * Parameters:
+ *   pipeline   : pipeline to update
+ *   stages     : stages in processing order
+ *   num_stages : number of stages, at most RADAR_PIPELINE_MAX_STAGES
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_pipeline_set_stages(radar_pipeline_t *pipeline, const radar_stage_t *const *stages,
+                               uint32_t num_stages)
+{
+    for (uint32_t i = 0; i < num_stages; ++i)
+    {
+        pipeline->stages[i] = stages[i];
+    }
+    pipeline->num_stages = num_stages;
+    memset(pipeline->stats, 0, sizeof(pipeline->stats));
+}
+
+/*******************************************************************************
+ * Function Name: radar_pipeline_run
+ *******************************************************************************
+ * Summary:
+ *   Runs a frame through all stages of the pipeline and accounts the cycles
+ *   spent in every stage. The frame samples must be in one of the pipeline
+ *   buffers; on return frame->samples points to the buffer with the result.
+ *
+ * Parameters:
+ *   pipeline : pipeline to run
+ *   frame    : frame to process
+ *
+ * Return:
+ *   RADAR_STAGE_DROP if a stage dropped the frame
+ ******************************************************************************/
+radar_stage_result_t radar_pipeline_run(radar_pipeline_t *pipeline, radar_frame_t *frame)
+{
+    uint16_t *spare = (frame->samples == pipeline->buffers[0]) ? pipeline->buffers[1] : pipeline->buffers[0];
+
+    for (uint32_t i = 0; i < pipeline->num_stages; ++i)
+    {
+        const radar_stage_t *stage = pipeline->stages[i];
+        radar_stage_stats_t *stats = &pipeline->stats[i];
+        const uint32_t start = radar_cycles_now();
+        radar_stage_result_t result;
+
+        result = stage->process(stage->context, frame, stage->in_place ? NULL : spare);
+
+        stats->last_cycles = radar_cycles_now() - start;
+        stats->total_cycles += stats->last_cycles;
+        if (stats->last_cycles > stats->max_cycles)
+        {
+            stats->max_cycles = stats->last_cycles;
+        }
+        stats->runs++;
+
+        if (result == RADAR_STAGE_DROP)
+        {
+            return RADAR_STAGE_DROP;
+        }
+
+        if (!stage->in_place)
+        {
+            uint16_t *input = frame->samples;
+
+            frame->samples = spare;
+            spare = input;
+        }
+
+        if (result == RADAR_STAGE_DONE)
+        {
+            break;
+        }
+    }
+
+    return RADAR_STAGE_CONTINUE;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,113 @@
+/******************************************************************************
+ * File Name:   radar_pipeline.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_pipeline.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_PIPELINE_H_
+#define RADAR_PIPELINE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "radar_frame.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RADAR_PIPELINE_MAX_STAGES       (8)
+
+/* Separator of the stage names in a pipeline description, e.g. "decim,roi" */
+#define RADAR_PIPELINE_SEPARATOR        (',')
+
+/* Alignment of the blocks handed out by the scratch arena */
+#define RADAR_ARENA_ALIGNMENT           (8u)
+#define RADAR_ARENA_BLOCK_SIZE(size)    ((((size) + RADAR_ARENA_ALIGNMENT) - 1u) & ~(RADAR_ARENA_ALIGNMENT - 1u))
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef enum
+{
+    RADAR_STAGE_CONTINUE,       /* pass the frame to the next stage */
+    RADAR_STAGE_DROP,           /* stop processing, the frame is not sent */
+    RADAR_STAGE_DONE            /* stop processing, the frame is sent as is */
+} radar_stage_result_t;
+
+/* Stage processing function. In place stages get a NULL output and modify
+ * frame->samples. Other stages write their result to the output buffer, which
+ * has room for a complete sensor frame, and the pipeline swaps the buffers. */
+typedef radar_stage_result_t (*radar_stage_process_t)(void *context, radar_frame_t *frame,
+                                                      uint16_t *out);
+
+typedef struct
+{
+    const char *name;
+    radar_stage_process_t process;
+    bool in_place;
+    void *context;
+} radar_stage_t;
+
+typedef struct
+{
+    uint32_t runs;
+    uint32_t last_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+} radar_stage_stats_t;
+
+typedef struct
+{
+    const radar_stage_t *stages[RADAR_PIPELINE_MAX_STAGES];
+    radar_stage_stats_t stats[RADAR_PIPELINE_MAX_STAGES];
+    uint32_t num_stages;
+    uint16_t *buffers[2];
+} radar_pipeline_t;
+
+/* Bump allocator over a statically sized memory block. Blocks are only
+ * handed out during initialization and never freed. */
+typedef struct
+{
+    uint8_t *base;
+    uint32_t size;
+    uint32_t used;
+} radar_arena_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void radar_arena_init(radar_arena_t *arena, void *base, uint32_t size);
+void *radar_arena_alloc(radar_arena_t *arena, uint32_t size);
+
+void radar_pipeline_init(radar_pipeline_t *pipeline, uint16_t *buffer_a, uint16_t *buffer_b);
+void radar_pipeline_set_buffer_b(radar_pipeline_t *pipeline, uint16_t *buffer_b);
+bool radar_pipeline_parse(const radar_stage_t *registry, uint32_t registry_size,
+                          const char *description, uint32_t length,
+                          const radar_stage_t **stages, uint32_t *num_stages);
+void radar_pipeline_set_stages(radar_pipeline_t *pipeline, const radar_stage_t *const *stages,
+                               uint32_t num_stages);
+radar_stage_result_t radar_pipeline_run(radar_pipeline_t *pipeline, radar_frame_t *frame);
+
+#endif /* RADAR_PIPELINE_H_ */
+/* [] END OF FILE */
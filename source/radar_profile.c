@@ -0,0 +1,143 @@
+/*****************************************************************************
+ * File name: radar_profile.c
+ *
+ * Description: This file implements the table of radar profiles generated
+ * from the radar settings files by scripts/radar_profiles.py. Every profile
+ * gets its own instance of the per-frame kernels with its frame geometry as
+ * constants.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file for local module, with the register lists of the profiles */
+#define RADAR_PROFILE_TABLE_IMPL
+#include "radar_profile.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Kernels of one profile, the generic kernels inlined with constant geometry */
+#define PROFILE_KERNELS(index, label, samples, chirps, rx, period_us)                                      \
+    static uint32_t profile_##index##_test_verify(const uint16_t *frame, uint16_t *test_word,              \
+                                                  uint32_t *first_error)                                   \
+    {                                                                                                      \
+        return radar_kernel_test_verify(frame, (samples) * (chirps) * (rx), (rx), test_word, first_error); \
+    }                                                                                                      \
+    static void profile_##index##_deinterleave(const uint16_t *in, uint16_t *out)                          \
+    {                                                                                                      \
+        radar_kernel_deinterleave(in, out, (samples), (chirps), (rx));                                     \
+    }                                                                                                      \
+    static uint32_t profile_##index##_roi_gather(const radar_roi_t *roi, const uint16_t *frame,            \
+                                                 uint16_t *out)                                            \
+    {                                                                                                      \
+        return radar_kernel_roi_gather(roi, frame, out, (samples), (chirps), (rx));                        \
+    }
+
+#define PROFILE_ENTRY(index, label, samples, chirps, rx, period_us)                                        \
+    {                                                                                                      \
+        .id = (index),                                                                                     \
+        .name = label,                                                                                     \
+        .registers = radar_profile_##index##_registers,                                                    \
+        .num_registers = sizeof(radar_profile_##index##_registers) / sizeof(uint32_t),                     \
+        .geometry = { .samples_per_chirp = (samples), .chirps_per_frame = (chirps), .rx_antennas = (rx) }, \
+        .samples_per_frame = (samples) * (chirps) * (rx),                                                  \
+        .frame_period_us = (period_us),                                                                    \
+        .kernels = {                                                                                       \
+            .test_verify = profile_##index##_test_verify,                                                  \
+            .deinterleave = profile_##index##_deinterleave,                                                \
+            .roi_gather = profile_##index##_roi_gather                                                     \
+        }                                                                                                  \
+    },
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_PROFILE_LIST(PROFILE_KERNELS)
+
+static const radar_profile_t profiles[RADAR_PROFILE_COUNT] =
+{
+    RADAR_PROFILE_LIST(PROFILE_ENTRY)
+};
+
+/*******************************************************************************
+ * Function Name: radar_profile_get
+ *******************************************************************************
+ * Summary:
+ *   Looks up a profile by its position in radar_profiles.json.
+ *
+ * Parameters:
+ *   id : profile id
+ *
+ * Return:
+ *   profile, NULL if there is no profile with this id
+ ******************************************************************************/
+const radar_profile_t *radar_profile_get(uint32_t id)
+{
+    return (id < RADAR_PROFILE_COUNT) ? &profiles[id] : NULL;
+}
+
+/*******************************************************************************
+ * Function Name: radar_profile_has_geometry
+ *******************************************************************************
+ * Summary:
+ *   Checks whether frames of a geometry can be processed with the kernels of
+ *   a profile.
+ *
+ * Parameters:
+ *   profile  : profile
+ *   geometry : frame geometry
+ *
+ * Return:
+ *   true if the geometry is the one of the profile
+ ******************************************************************************/
+bool radar_profile_has_geometry(const radar_profile_t *profile, const radar_geometry_t *geometry)
+{
+    return (profile->geometry.samples_per_chirp == geometry->samples_per_chirp) &&
+           (profile->geometry.chirps_per_frame == geometry->chirps_per_frame) &&
+           (profile->geometry.rx_antennas == geometry->rx_antennas);
+}
+
+/*******************************************************************************
+ * Function Name: radar_profile_find
+ *******************************************************************************
+ * Summary:
+ *   Finds the first profile with a frame geometry.
+ *
+ * Parameters:
+ *   geometry : frame geometry
+ *
+ * Return:
+ *   profile, NULL if no profile has the geometry
+ ******************************************************************************/
+const radar_profile_t *radar_profile_find(const radar_geometry_t *geometry)
+{
+    for (uint32_t id = 0; id < RADAR_PROFILE_COUNT; ++id)
+    {
+        if (radar_profile_has_geometry(&profiles[id], geometry))
+        {
+            return &profiles[id];
+        }
+    }
+
+    return NULL;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,68 @@
+/******************************************************************************
+ * File Name:   radar_profile.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_profile.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_PROFILE_H_
+#define RADAR_PROFILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "radar_frame.h"
+#include "radar_kernels.h"
+#include "radar_profile_table.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Profile the sensor starts with, the first one of radar_profiles.json */
+#define RADAR_PROFILE_DEFAULT       (0u)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Sensor configuration generated from a radar settings file, in flash */
+typedef struct
+{
+    uint8_t id;                 /* position in radar_profiles.json */
+    const char *name;
+    const uint32_t *registers;
+    uint32_t num_registers;
+    radar_geometry_t geometry;
+    uint32_t samples_per_frame;
+    uint32_t frame_period_us;
+    radar_kernels_t kernels;    /* kernels with the geometry of the profile as constants */
+} radar_profile_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+const radar_profile_t *radar_profile_get(uint32_t id);
+const radar_profile_t *radar_profile_find(const radar_geometry_t *geometry);
+bool radar_profile_has_geometry(const radar_profile_t *profile, const radar_geometry_t *geometry);
+
+#endif /* RADAR_PROFILE_H_ */
+/* [] END OF FILE */
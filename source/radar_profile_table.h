@@ -0,0 +1,69 @@
+/* Radar profiles generated by scripts/radar_profiles.py from radar_profiles.json.
+ * Do not edit, change the profiles and build again. */
+#ifndef RADAR_PROFILE_TABLE_H_
+#define RADAR_PROFILE_TABLE_H_
+
+#include <stdint.h>
+
+#define RADAR_PROFILE_COUNT (1u)
+
+/* X(id, name, samples per chirp, chirps per frame, RX antennas, frame period in us) */
+#define RADAR_PROFILE_LIST(X) \
+    X(0, "default", 128u, 1u, 1u, 5004u)
+
+#define RADAR_PROFILE_MAX_SAMPLES_PER_CHIRP (128u)
+#define RADAR_PROFILE_MAX_CHIRPS_PER_FRAME (1u)
+#define RADAR_PROFILE_MAX_RX_ANTENNAS (1u)
+
+/* Largest SIZE(samples per chirp, chirps per frame, RX antennas) over the profiles */
+#define RADAR_PROFILE_MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define RADAR_PROFILE_MAX_OF(SIZE) \
+    (SIZE(128u, 1u, 1u))
+
+#if defined(RADAR_PROFILE_TABLE_IMPL)
+/* default: radar_settings.json, registers from radar_settings.h */
+static const uint32_t radar_profile_0_registers[] = {
+    0x11e8270UL,
+    0x3088210UL,
+    0x9e967fdUL,
+    0xb0805b4UL,
+    0xdf0227fUL,
+    0xf010700UL,
+    0x11000000UL,
+    0x13000000UL,
+    0x15000000UL,
+    0x17000be0UL,
+    0x19000000UL,
+    0x1b000000UL,
+    0x1d000000UL,
+    0x1f000b60UL,
+    0x21103c51UL,
+    0x231ff41fUL,
+    0x25006f7bUL,
+    0x2d000490UL,
+    0x3b000480UL,
+    0x49000480UL,
+    0x57000480UL,
+    0x5911be0eUL,
+    0x5b44c40aUL,
+    0x5d000000UL,
+    0x5f787e1eUL,
+    0x61f5208cUL,
+    0x630000a4UL,
+    0x65000252UL,
+    0x67000080UL,
+    0x69000000UL,
+    0x6b000000UL,
+    0x6d000000UL,
+    0x6f092910UL,
+    0x7f000100UL,
+    0x8f000100UL,
+    0x9f000100UL,
+    0xab000000UL,
+    0xad000000UL,
+    0xb7000000UL,
+};
+
+#endif
+
+#endif /* RADAR_PROFILE_TABLE_H_ */
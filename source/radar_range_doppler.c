@@ -0,0 +1,310 @@
+/*****************************************************************************
+ * File name: radar_range_doppler.c
+ *
+ * Description: This file implements the range-Doppler power map of a frame,
+ * the non-coherent sum over all antennas.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_range_doppler.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Largest float below UINT32_MAX */
+#define RD_POWER_MAX                    (4294967040.0f)
+
+#define RD_PI                           (3.14159265f)
+
+/*******************************************************************************
+ * Function Name: radar_rd_init
+ *******************************************************************************
+ * Summary:
+ *   Sets up the range-Doppler processing for frames up to the given size.
+ *
+ * Parameters:
+ *   rd           : range-Doppler state
+ *   memory       : RADAR_RD_MEMORY_SIZE() floats for the largest frame
+ *   power        : RADAR_RD_POWER_SIZE() cells for the largest frame
+ *   max_geometry : largest frame
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_rd_init(radar_rd_t *rd, float *memory, uint32_t *power, const radar_geometry_t *max_geometry)
+{
+    const uint32_t fft_size = RADAR_FFT_SIZE(max_geometry->samples_per_chirp);
+    const uint32_t maps_size = (uint32_t)max_geometry->rx_antennas *
+                               RADAR_RD_POWER_SIZE(max_geometry->samples_per_chirp, max_geometry->chirps_per_frame);
+
+    rd->window = memory;
+    rd->chirp_re = &rd->window[max_geometry->samples_per_chirp];
+    rd->chirp_im = &rd->chirp_re[fft_size];
+    rd->map_re = &rd->chirp_im[fft_size];
+    rd->map_im = &rd->map_re[maps_size];
+    rd->power = power;
+    rd->max_samples = max_geometry->samples_per_chirp;
+    rd->max_chirps = max_geometry->chirps_per_frame;
+    rd->max_antennas = max_geometry->rx_antennas;
+    rd->window_length = 0;
+    rd->range_bins = 0;
+    rd->doppler_bins = 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_rd_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks that a frame fits the memory given to radar_rd_init().
+ *
+ * Parameters:
+ *   rd       : range-Doppler state
+ *   geometry : frame geometry
+ *
+ * Return:
+ *   true if the frame can be processed
+ ******************************************************************************/
+bool radar_rd_is_valid(const radar_rd_t *rd, const radar_geometry_t *geometry)
+{
+    return (geometry->samples_per_chirp >= 2u) && (geometry->samples_per_chirp <= rd->max_samples) &&
+           (geometry->chirps_per_frame >= 1u) && (geometry->chirps_per_frame <= rd->max_chirps) &&
+           (geometry->rx_antennas >= 1u) && (geometry->rx_antennas <= rd->max_antennas);
+}
+
+/*******************************************************************************
+ * Function Name: radar_rd_process
+ *******************************************************************************
+ * Summary:
+ *   Computes the range-Doppler power map of a frame. Every chirp has its mean
+ *   removed and is Hann windowed before the range FFT, which is zero padded
+ *   to a power of two. The Doppler FFT over the Hann weighted chirps of every
+ *   range bin follows, also zero padded. The powers of all antennas are
+ *   summed up, the complex map of every antenna is kept for the angle
+ *   estimation. Only the positive range bins of the real input are kept;
+ *   Doppler bins are in FFT order, bins from doppler_bins / 2 on are negative
+ *   velocities.
+ *
+ * Parameters:
+ *   rd       : range-Doppler state, power holds the map on return
+ *   geometry : frame geometry, checked with radar_rd_is_valid()
+ *   frame    : samples antenna by antenna, see radar_frame_deinterleave()
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_rd_process(radar_rd_t *rd, const radar_geometry_t *geometry, const uint16_t *frame)
+{
+    const uint32_t num_samples = geometry->samples_per_chirp;
+    const uint32_t num_chirps = geometry->chirps_per_frame;
+    const uint32_t num_antennas = geometry->rx_antennas;
+    const uint32_t range_fft_size = RADAR_FFT_SIZE(num_samples);
+    const uint32_t range_bins = range_fft_size / 2u;
+    const uint32_t doppler_bins = RADAR_FFT_SIZE(num_chirps);
+    const float scale = RADAR_RD_POWER_SCALE / ((float)range_fft_size * (float)doppler_bins);
+
+    if (rd->window_length != num_samples)
+    {
+        for (uint32_t i = 0; i < num_samples; ++i)
+        {
+            rd->window[i] = 0.5f - (0.5f * cosf((6.28318531f * (float)i) / (float)num_samples));
+        }
+        rd->window_length = (uint16_t)num_samples;
+    }
+
+    rd->range_bins = (uint16_t)range_bins;
+    rd->doppler_bins = (uint16_t)doppler_bins;
+    memset(rd->power, 0, range_bins * doppler_bins * sizeof(uint32_t));
+
+    for (uint32_t rx = 0; rx < num_antennas; ++rx)
+    {
+        float *map_re = &rd->map_re[rx * range_bins * doppler_bins];
+        float *map_im = &rd->map_im[rx * range_bins * doppler_bins];
+
+        for (uint32_t chirp = 0; chirp < doppler_bins; ++chirp)
+        {
+            if (chirp >= num_chirps)
+            {
+                for (uint32_t bin = 0; bin < range_bins; ++bin)
+                {
+                    map_re[(bin * doppler_bins) + chirp] = 0.0f;
+                    map_im[(bin * doppler_bins) + chirp] = 0.0f;
+                }
+                continue;
+            }
+
+            const uint16_t *samples = &frame[((rx * num_chirps) + chirp) * num_samples];
+            uint32_t sum = 0;
+
+            for (uint32_t i = 0; i < num_samples; ++i)
+            {
+                sum += samples[i];
+            }
+
+            const float mean = (float)sum / (float)num_samples;
+
+            /* Hann window over the chirps keeps the Doppler sidelobes of
+             * strong targets below the detection threshold */
+            const float chirp_weight = (num_chirps > 1u)
+                                       ? (0.5f - (0.5f * cosf((6.28318531f * ((float)chirp + 0.5f)) / (float)num_chirps)))
+                                       : 1.0f;
+
+            for (uint32_t i = 0; i < num_samples; ++i)
+            {
+                rd->chirp_re[i] = ((float)samples[i] - mean) * rd->window[i] * chirp_weight;
+            }
+            for (uint32_t i = num_samples; i < range_fft_size; ++i)
+            {
+                rd->chirp_re[i] = 0.0f;
+            }
+            memset(rd->chirp_im, 0, range_fft_size * sizeof(float));
+
+            radar_fft(rd->chirp_re, rd->chirp_im, range_fft_size);
+
+            for (uint32_t bin = 0; bin < range_bins; ++bin)
+            {
+                map_re[(bin * doppler_bins) + chirp] = rd->chirp_re[bin];
+                map_im[(bin * doppler_bins) + chirp] = rd->chirp_im[bin];
+            }
+        }
+
+        for (uint32_t bin = 0; bin < range_bins; ++bin)
+        {
+            float *re = &map_re[bin * doppler_bins];
+            float *im = &map_im[bin * doppler_bins];
+
+            radar_fft(re, im, doppler_bins);
+
+            for (uint32_t doppler = 0; doppler < doppler_bins; ++doppler)
+            {
+                const float power = ((re[doppler] * re[doppler]) + (im[doppler] * im[doppler])) * scale;
+                uint32_t *cell = &rd->power[(doppler * range_bins) + bin];
+                const uint32_t value = (power < RD_POWER_MAX) ? (uint32_t)power : UINT32_MAX;
+
+                /* Saturating sum over the antennas */
+                *cell = (value > (UINT32_MAX - *cell)) ? UINT32_MAX : (*cell + value);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_rd_cell
+ *******************************************************************************
+ * Summary:
+ *   Reads the complex value of one antenna at a cell of the last map.
+ *
+ * Parameters:
+ *   rd          : range-Doppler state
+ *   rx          : antenna index within the frame
+ *   range_bin   : range bin
+ *   doppler_bin : Doppler bin in FFT order
+ *   re          : real part
+ *   im          : imaginary part
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_rd_cell(const radar_rd_t *rd, uint32_t rx, uint32_t range_bin, uint32_t doppler_bin,
+                   float *re, float *im)
+{
+    const uint32_t idx = (((rx * rd->range_bins) + range_bin) * rd->doppler_bins) + doppler_bin;
+
+    *re = rd->map_re[idx];
+    *im = rd->map_im[idx];
+}
+
+/*******************************************************************************
+ * Function Name: radar_rd_range_bin
+ *******************************************************************************
+ * Summary:
+ *   Computes one range bin of one antenna straight from an interleaved frame,
+ *   summed over all chirps. Only the one DFT bin is evaluated, with the same
+ *   mean removal, Hann window and bin numbering as radar_rd_process(), which
+ *   is far cheaper than the full range FFT when only a few bins are needed.
+ *
+ * Parameters:
+ *   geometry  : frame geometry
+ *   frame     : interleaved frame
+ *   rx        : antenna index within the frame
+ *   range_bin : range bin, below RADAR_RD_RANGE_BINS(samples_per_chirp)
+ *   re        : real part
+ *   im        : imaginary part
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_rd_range_bin(const radar_geometry_t *geometry, const uint16_t *frame, uint32_t rx,
+                        uint32_t range_bin, float *re, float *im)
+{
+    const uint32_t num_samples = geometry->samples_per_chirp;
+    const uint32_t num_antennas = geometry->rx_antennas;
+    const float bin_angle = (-2.0f * RD_PI * (float)range_bin) / (float)RADAR_FFT_SIZE(num_samples);
+    const float window_angle = (2.0f * RD_PI) / (float)num_samples;
+    const float bin_step_re = cosf(bin_angle);
+    const float bin_step_im = sinf(bin_angle);
+    const float window_step_re = cosf(window_angle);
+    const float window_step_im = sinf(window_angle);
+    float sum_re = 0.0f;
+    float sum_im = 0.0f;
+
+    for (uint32_t chirp = 0; chirp < geometry->chirps_per_frame; ++chirp)
+    {
+        const uint16_t *samples = &frame[(chirp * num_samples * num_antennas) + rx];
+        float bin_re = 1.0f, bin_im = 0.0f;
+        float window_re = 1.0f, window_im = 0.0f;
+        uint32_t total = 0;
+        float mean;
+
+        for (uint32_t i = 0; i < num_samples; ++i)
+        {
+            total += samples[i * num_antennas];
+        }
+        mean = (float)total / (float)num_samples;
+
+        for (uint32_t i = 0; i < num_samples; ++i)
+        {
+            const float x = ((float)samples[i * num_antennas] - mean) * (0.5f - (0.5f * window_re));
+            float next;
+
+            sum_re += x * bin_re;
+            sum_im += x * bin_im;
+
+            /* Advance both rotations by one sample */
+            next = (bin_re * bin_step_re) - (bin_im * bin_step_im);
+            bin_im = (bin_re * bin_step_im) + (bin_im * bin_step_re);
+            bin_re = next;
+            next = (window_re * window_step_re) - (window_im * window_step_im);
+            window_im = (window_re * window_step_im) + (window_im * window_step_re);
+            window_re = next;
+        }
+    }
+
+    *re = sum_re;
+    *im = sum_im;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * File Name:   radar_range_doppler.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_range_doppler.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_RANGE_DOPPLER_H_
+#define RADAR_RANGE_DOPPLER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "radar_fft.h"
+#include "radar_frame.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* The power of a cell is (re^2 + im^2) * RADAR_RD_POWER_SCALE / (N * D) for a
+ * range FFT size N and Doppler FFT size D, which keeps the noise floor of a
+ * few ADC counts above the integer resolution */
+#define RADAR_RD_POWER_SCALE            (16.0f)
+
+#define RADAR_RD_RANGE_BINS(samples_per_chirp)  (RADAR_FFT_SIZE(samples_per_chirp) / 2u)
+#define RADAR_RD_DOPPLER_BINS(chirps_per_frame) (RADAR_FFT_SIZE(chirps_per_frame))
+
+/* Number of power cells of the range-Doppler map */
+#define RADAR_RD_POWER_SIZE(samples_per_chirp, chirps_per_frame) \
+    (RADAR_RD_RANGE_BINS(samples_per_chirp) * RADAR_RD_DOPPLER_BINS(chirps_per_frame))
+
+/* Number of floats of working memory needed by radar_rd_init(): window, one
+ * complex chirp and the complex map of every antenna */
+#define RADAR_RD_MEMORY_SIZE(samples_per_chirp, chirps_per_frame, rx_antennas) \
+    ((samples_per_chirp) + (2u * RADAR_FFT_SIZE(samples_per_chirp)) +       \
+     (2u * (rx_antennas) * RADAR_RD_POWER_SIZE(samples_per_chirp, chirps_per_frame)))
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    float *window;
+    float *chirp_re;
+    float *chirp_im;
+    float *map_re;              /* per antenna, range bin major, Doppler bins contiguous */
+    float *map_im;
+    uint32_t *power;            /* Doppler bin major, range bins contiguous */
+    uint16_t max_samples;
+    uint16_t max_chirps;
+    uint8_t max_antennas;
+    uint16_t window_length;
+    uint16_t range_bins;        /* size of the last map */
+    uint16_t doppler_bins;
+} radar_rd_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void radar_rd_init(radar_rd_t *rd, float *memory, uint32_t *power, const radar_geometry_t *max_geometry);
+bool radar_rd_is_valid(const radar_rd_t *rd, const radar_geometry_t *geometry);
+void radar_rd_process(radar_rd_t *rd, const radar_geometry_t *geometry, const uint16_t *frame);
+void radar_rd_cell(const radar_rd_t *rd, uint32_t rx, uint32_t range_bin, uint32_t doppler_bin,
+                   float *re, float *im);
+void radar_rd_range_bin(const radar_geometry_t *geometry, const uint16_t *frame, uint32_t rx,
+                        uint32_t range_bin, float *re, float *im);
+
+#endif /* RADAR_RANGE_DOPPLER_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,249 @@
+/*****************************************************************************
+ * File name: radar_resend.c
+ *
+ * Description: This file implements the ring of sent frame datagrams the UDP
+ * server keeps for retransmission and the handling of the negative
+ * acknowledgements of the client that select the datagrams to send again.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_frame.h"
+#include "radar_resend.h"
+
+/*******************************************************************************
+ * Function Name: radar_resend_config_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks the ring depth and the retransmission budget.
+ *
+ * Parameters:
+ *   config : retransmission settings
+ *
+ * Return:
+ *   true if the settings are supported
+ ******************************************************************************/
+bool radar_resend_config_is_valid(const radar_resend_config_t *config)
+{
+    return (config->depth <= RADAR_RESEND_MAX_DEPTH) &&
+           (config->budget >= 1) && (config->budget <= RADAR_RESEND_MAX_BUDGET);
+}
+
+/*******************************************************************************
+ * Function Name: radar_resend_init
+ *******************************************************************************
+ * Summary:
+ *   Sets up an empty ring on its memory.
+ *
+ * Parameters:
+ *   ring         : retransmission ring
+ *   memory       : RADAR_RESEND_MEMORY_SIZE(max_datagram) bytes
+ *   max_datagram : largest datagram that is kept
+ *   depth        : datagrams kept, up to RADAR_RESEND_MAX_DEPTH
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_resend_init(radar_resend_t *ring, uint8_t *memory, uint32_t max_datagram, uint8_t depth)
+{
+    ring->memory = memory;
+    ring->max_datagram = max_datagram;
+    radar_resend_set_depth(ring, depth);
+}
+
+/*******************************************************************************
+ * Function Name: radar_resend_set_depth
+ *******************************************************************************
+ * Summary:
+ *   Changes the number of datagrams kept. The ring starts empty.
+ *
+ * Parameters:
+ *   ring  : retransmission ring
+ *   depth : datagrams kept, 0 disables the ring
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_resend_set_depth(radar_resend_t *ring, uint8_t depth)
+{
+    ring->depth = depth;
+    ring->next = 0;
+    ring->num_requested = 0;
+    memset(ring->length, 0, sizeof(ring->length));
+    memset(ring->requested, 0, sizeof(ring->requested));
+}
+
+/*******************************************************************************
+ * Function Name: radar_resend_store
+ *******************************************************************************
+ * Summary:
+ *   Keeps a sent frame datagram in place of the oldest one. A pending
+ *   request for the oldest one is dropped with it.
+ *
+ * Parameters:
+ *   ring     : retransmission ring
+ *   datagram : sent datagram, starting with the frame header
+ *   length   : size of the datagram
+ *
+ * Return:
+ *   true if the datagram is kept, false without a ring or for a datagram
+ *   that does not fit
+ ******************************************************************************/
+bool radar_resend_store(radar_resend_t *ring, const uint8_t *datagram, uint32_t length)
+{
+    const uint32_t slot = ring->next;
+
+    if ((ring->depth == 0) || (length < RADAR_FRAME_HEADER_SIZE) || (length > ring->max_datagram))
+    {
+        return false;
+    }
+
+    if (ring->requested[slot])
+    {
+        ring->requested[slot] = false;
+        ring->num_requested--;
+    }
+    memcpy(&ring->memory[slot * ring->max_datagram], datagram, length);
+    ring->length[slot] = (uint16_t)length;
+    ring->frame_num[slot] = radar_frame_get_u32(&datagram[RADAR_FRAME_HDR_FRAME_NUM]);
+    ring->next = (uint8_t)((slot + 1u) % ring->depth);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_resend_keep
+ *******************************************************************************
+ * Summary:
+ *   Keeps a frame datagram that could not be sent yet and marks it for
+ *   sending, behind the datagrams marked before. Once the ring is full the
+ *   oldest datagram is dropped.
+ *
+ * Parameters:
+ *   ring     : retransmission ring
+ *   datagram : datagram, starting with the frame header
+ *   length   : size of the datagram
+ *
+ * Return:
+ *   true if the datagram is kept
+ ******************************************************************************/
+bool radar_resend_keep(radar_resend_t *ring, const uint8_t *datagram, uint32_t length)
+{
+    const uint32_t slot = ring->next;
+
+    if (!radar_resend_store(ring, datagram, length))
+    {
+        return false;
+    }
+
+    ring->requested[slot] = true;
+    ring->num_requested++;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_resend_request
+ *******************************************************************************
+ * Summary:
+ *   Marks the datagrams a negative acknowledgement of the client asks for,
+ *   see RADAR_RESEND_NACK_HEADER_SIZE. Frames that are not in the ring are
+ *   ignored: they were either never sent or are too old.
+ *
+ * Parameters:
+ *   ring   : retransmission ring
+ *   nack   : received request
+ *   length : size of the request
+ *
+ * Return:
+ *   number of datagrams newly marked for retransmission
+ ******************************************************************************/
+uint32_t radar_resend_request(radar_resend_t *ring, const uint8_t *nack, uint32_t length)
+{
+    uint32_t first;
+    uint32_t num_bits;
+    uint32_t marked = 0;
+
+    if ((length <= RADAR_RESEND_NACK_HEADER_SIZE) || (length > RADAR_RESEND_NACK_MAX_SIZE) ||
+        (nack[0] != RADAR_NACK_COMMAND))
+    {
+        return 0;
+    }
+
+    first = radar_frame_get_u32(&nack[2]);
+    num_bits = 8u * (length - RADAR_RESEND_NACK_HEADER_SIZE);
+
+    for (uint32_t slot = 0; slot < ring->depth; ++slot)
+    {
+        const uint32_t bit = ring->frame_num[slot] - first;
+
+        if ((ring->length[slot] != 0) && !ring->requested[slot] && (bit < num_bits) &&
+            ((nack[RADAR_RESEND_NACK_HEADER_SIZE + (bit / 8u)] & (1u << (bit % 8u))) != 0))
+        {
+            ring->requested[slot] = true;
+            ring->num_requested++;
+            marked++;
+        }
+    }
+
+    return marked;
+}
+
+/*******************************************************************************
+ * Function Name: radar_resend_next
+ *******************************************************************************
+ * Summary:
+ *   Takes the oldest datagram marked for retransmission. The datagram stays
+ *   valid until the next radar_resend_store.
+ *
+ * Parameters:
+ *   ring     : retransmission ring
+ *   datagram : output, the datagram to send again
+ *
+ * Return:
+ *   size of the datagram, 0 if none is marked
+ ******************************************************************************/
+uint32_t radar_resend_next(radar_resend_t *ring, const uint8_t **datagram)
+{
+    if (ring->num_requested == 0)
+    {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < ring->depth; ++i)
+    {
+        const uint32_t slot = (ring->next + i) % ring->depth;
+
+        if (ring->requested[slot])
+        {
+            ring->requested[slot] = false;
+            ring->num_requested--;
+            *datagram = &ring->memory[slot * ring->max_datagram];
+            return ring->length[slot];
+        }
+    }
+
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * File Name:   radar_resend.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_resend.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_RESEND_H_
+#define RADAR_RESEND_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RADAR_RESEND_MAX_DEPTH          (64u)
+#define RADAR_RESEND_MAX_BUDGET         (1000u)
+
+#define RADAR_RESEND_DEFAULT_BUDGET     (100u)
+
+/* Request of the client for lost frame datagrams:
+ *   [0]      command, RADAR_NACK_COMMAND
+ *   [1]      dummy byte
+ *   [2..5]   first frame number, little endian
+ *   [6..]    1 to RADAR_RESEND_NACK_MAX_BITMAP bytes, bit i of byte j set if
+ *            frame number first + 8 * j + i is missing
+ * Frame numbers without a datagram are skipped, so the client can request a
+ * whole range between two received frames. */
+#define RADAR_RESEND_NACK_HEADER_SIZE   (6u)
+#define RADAR_RESEND_NACK_MAX_BITMAP    (8u)
+#define RADAR_RESEND_NACK_MAX_SIZE      (RADAR_RESEND_NACK_HEADER_SIZE + RADAR_RESEND_NACK_MAX_BITMAP)
+
+#define RADAR_RESEND_MEMORY_SIZE(max_datagram) (RADAR_RESEND_MAX_DEPTH * (max_datagram))
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t depth;              /* frame datagrams kept, 0 disables retransmission */
+    uint16_t budget;            /* retransmitted datagrams per second */
+} radar_resend_config_t;
+
+typedef struct
+{
+    uint8_t *memory;            /* RADAR_RESEND_MAX_DEPTH datagrams */
+    uint32_t max_datagram;
+    uint8_t depth;
+    uint8_t next;               /* slot of the next datagram, the oldest one */
+    uint8_t num_requested;
+    uint32_t frame_num[RADAR_RESEND_MAX_DEPTH];
+    uint16_t length[RADAR_RESEND_MAX_DEPTH];   /* 0 if the slot is empty */
+    bool requested[RADAR_RESEND_MAX_DEPTH];
+} radar_resend_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+bool radar_resend_config_is_valid(const radar_resend_config_t *config);
+void radar_resend_init(radar_resend_t *ring, uint8_t *memory, uint32_t max_datagram, uint8_t depth);
+void radar_resend_set_depth(radar_resend_t *ring, uint8_t depth);
+bool radar_resend_store(radar_resend_t *ring, const uint8_t *datagram, uint32_t length);
+bool radar_resend_keep(radar_resend_t *ring, const uint8_t *datagram, uint32_t length);
+uint32_t radar_resend_request(radar_resend_t *ring, const uint8_t *nack, uint32_t length);
+uint32_t radar_resend_next(radar_resend_t *ring, const uint8_t **datagram);
+
+#endif /* RADAR_RESEND_H_ */
+/* [] END OF FILE */
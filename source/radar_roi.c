@@ -0,0 +1,119 @@
+/*****************************************************************************
+ * File name: radar_roi.c
+ *
+ * Description: This file implements the region of interest selection that
+ * reduces every radar frame to the antennas, chirps and samples requested by
+ * the UDP client before the frame is transmitted.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_kernels.h"
+#include "radar_roi.h"
+
+/*******************************************************************************
+ * Function Name: radar_roi_reset
+ *******************************************************************************
+ * Summary:
+ *   Selects the complete frame, i.e. all antennas, all chirps and all samples.
+ *
+ * Parameters:
+ *   roi      : region of interest to reset
+ *   geometry : geometry of the frames the region applies to
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_roi_reset(radar_roi_t *roi, const radar_geometry_t *geometry)
+{
+    roi->antenna_mask = (uint8_t)((1u << geometry->rx_antennas) - 1u);
+    roi->chirp_stride = 1;
+    roi->sample_start = 0;
+    roi->sample_count = geometry->samples_per_chirp;
+}
+
+/*******************************************************************************
+ * Function Name: radar_roi_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks that a region of interest selects at least one sample and lies
+ *   completely within the given frame geometry.
+ *
+ * Parameters:
+ *   roi      : region of interest to check
+ *   geometry : geometry of the frames the region applies to
+ *
+ * Return:
+ *   true if the region can be applied to the geometry
+ ******************************************************************************/
+bool radar_roi_is_valid(const radar_roi_t *roi, const radar_geometry_t *geometry)
+{
+    const uint32_t all_antennas = (1u << geometry->rx_antennas) - 1u;
+
+    if ((roi->antenna_mask == 0) || ((roi->antenna_mask & ~all_antennas) != 0))
+    {
+        return false;
+    }
+
+    if ((roi->chirp_stride == 0) || (roi->chirp_stride > geometry->chirps_per_frame))
+    {
+        return false;
+    }
+
+    if ((roi->sample_count == 0) ||
+        (((uint32_t)roi->sample_start + roi->sample_count) > geometry->samples_per_chirp))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_roi_gather
+ *******************************************************************************
+ * Summary:
+ *   Copies the samples selected by the region of interest from a frame into
+ *   the output buffer in a single pass. The output keeps the sensor layout,
+ *   i.e. chirp by chirp with the selected antennas interleaved per sample.
+ *   The region must have been checked with radar_roi_is_valid().
+ *
+ * Parameters:
+ *   roi      : region of interest to extract
+ *   geometry : geometry of the input frame
+ *   frame    : input frame
+ *   out      : output buffer, must not overlap the input frame
+ *
+ * Return:
+ *   number of samples written to the output buffer
+ ******************************************************************************/
+uint32_t radar_roi_gather(const radar_roi_t *roi, const radar_geometry_t *geometry,
+                          const uint16_t *frame, uint16_t *out)
+{
+    return radar_kernel_roi_gather(roi, frame, out, geometry->samples_per_chirp, geometry->chirps_per_frame,
+                                   geometry->rx_antennas);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,50 @@
+/******************************************************************************
+ * File Name:   radar_roi.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_roi.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_ROI_H_
+#define RADAR_ROI_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "radar_frame.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RADAR_ROI_MAX_ANTENNAS      (3)
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void radar_roi_reset(radar_roi_t *roi, const radar_geometry_t *geometry);
+bool radar_roi_is_valid(const radar_roi_t *roi, const radar_geometry_t *geometry);
+uint32_t radar_roi_gather(const radar_roi_t *roi, const radar_geometry_t *geometry,
+                          const uint16_t *frame, uint16_t *out);
+
+#endif /* RADAR_ROI_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,232 @@
+/*****************************************************************************
+ * File name: radar_spectro.c
+ *
+ * Description: This file implements the micro-Doppler spectrogram: a
+ * short-time Fourier transform over the slow-time samples of a few range
+ * bins.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_fft.h"
+#include "radar_range_doppler.h"
+#include "radar_spectro.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define SPECTRO_PI                      (3.14159265f)
+
+/* Levels below the peak are sent in steps of 0.5 dB */
+#define SPECTRO_LEVEL_STEPS_PER_DB      (2.0f)
+#define SPECTRO_LEVEL_MAX               (255u)
+
+/*******************************************************************************
+ * Function Name: radar_spectro_config_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks the spectrogram settings against their limits. The range bins are
+ *   checked against the frame by the caller.
+ *
+ * Parameters:
+ *   config : spectrogram settings
+ *
+ * Return:
+ *   true if the settings are valid
+ ******************************************************************************/
+bool radar_spectro_config_is_valid(const radar_spectro_config_t *config)
+{
+    return (config->range_bins >= 1u) && (config->range_bins <= RADAR_SPECTRO_MAX_RANGE_BINS) &&
+           (config->window >= RADAR_SPECTRO_MIN_WINDOW) && (config->window <= RADAR_SPECTRO_MAX_WINDOW) &&
+           ((config->window & (config->window - 1u)) == 0u) &&
+           (config->hop >= 1u) && (config->hop <= config->window);
+}
+
+/*******************************************************************************
+ * Function Name: radar_spectro_init
+ *******************************************************************************
+ * Summary:
+ *   Sets up the spectrogram for valid settings and starts with an empty
+ *   window.
+ *
+ * Parameters:
+ *   spectro : spectrogram state
+ *   config  : spectrogram settings
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_spectro_init(radar_spectro_t *spectro, const radar_spectro_config_t *config)
+{
+    spectro->config = *config;
+
+    /* Periodic Hann window, the default of the usual host STFT tools */
+    for (uint32_t i = 0; i < config->window; ++i)
+    {
+        spectro->window[i] = 0.5f - (0.5f * cosf((2.0f * SPECTRO_PI * (float)i) / (float)config->window));
+    }
+
+    radar_spectro_reset(spectro);
+}
+
+/*******************************************************************************
+ * Function Name: radar_spectro_reset
+ *******************************************************************************
+ * Summary:
+ *   Drops the slow-time samples collected so far. The next column is sent
+ *   once the window is full again.
+ *
+ * Parameters:
+ *   spectro : spectrogram state
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_spectro_reset(radar_spectro_t *spectro)
+{
+    spectro->ring_idx = 0;
+    spectro->filled = 0;
+    spectro->since_column = spectro->config.hop - 1u;
+}
+
+/*******************************************************************************
+ * Function Name: radar_spectro_process
+ *******************************************************************************
+ * Summary:
+ *   Adds the slow-time sample of every range bin of a frame to the window.
+ *   Only the new range bins are computed; the samples of earlier frames stay
+ *   in the ring and are reused by every column whose window they fall into.
+ *
+ * Parameters:
+ *   spectro  : spectrogram state
+ *   geometry : frame geometry, holding all configured range bins
+ *   frame    : interleaved frame
+ *
+ * Return:
+ *   true if a column is due
+ ******************************************************************************/
+bool radar_spectro_process(radar_spectro_t *spectro, const radar_geometry_t *geometry, const uint16_t *frame)
+{
+    const radar_spectro_config_t *config = &spectro->config;
+
+    for (uint32_t bin = 0; bin < config->range_bins; ++bin)
+    {
+        radar_rd_range_bin(geometry, frame, 0, config->range_bin + bin,
+                           &spectro->ring_re[bin][spectro->ring_idx], &spectro->ring_im[bin][spectro->ring_idx]);
+    }
+
+    spectro->ring_idx = (uint16_t)((spectro->ring_idx + 1u) & (config->window - 1u));
+    if (spectro->filled < config->window)
+    {
+        spectro->filled++;
+        if (spectro->filled < config->window)
+        {
+            return false;
+        }
+    }
+
+    if (++spectro->since_column < config->hop)
+    {
+        return false;
+    }
+    spectro->since_column = 0;
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_spectro_write_column
+ *******************************************************************************
+ * Summary:
+ *   Computes the spectrogram column of the current window and encodes it,
+ *   see RADAR_SPECTRO_COLUMN_SIZE for the layout. Every range bin takes one
+ *   FFT of the window length over the windowed ring, oldest sample first.
+ *
+ * Parameters:
+ *   spectro : spectrogram state with a full window
+ *   data    : output, RADAR_SPECTRO_COLUMN_SIZE() bytes
+ *
+ * Return:
+ *   number of bytes written
+ ******************************************************************************/
+uint32_t radar_spectro_write_column(radar_spectro_t *spectro, uint8_t *data)
+{
+    const radar_spectro_config_t *config = &spectro->config;
+    const uint32_t window = config->window;
+    const uint32_t half = window / 2u;
+    uint8_t *block = &data[RADAR_SPECTRO_HEADER_SIZE];
+
+    radar_frame_put_u16(&data[0], config->range_bin);
+    data[2] = config->range_bins;
+    data[3] = (uint8_t)radar_fft_log2(window);
+    radar_frame_put_u16(&data[4], config->hop);
+
+    for (uint32_t bin = 0; bin < config->range_bins; ++bin)
+    {
+        float *level = spectro->fft_re;
+        float peak;
+
+        for (uint32_t i = 0; i < window; ++i)
+        {
+            const uint32_t slot = (spectro->ring_idx + i) & (window - 1u);
+
+            spectro->fft_re[i] = spectro->ring_re[bin][slot] * spectro->window[i];
+            spectro->fft_im[i] = spectro->ring_im[bin][slot] * spectro->window[i];
+        }
+
+        radar_fft(spectro->fft_re, spectro->fft_im, window);
+
+        /* Level in dB in place of the real part, floored at 0 dB */
+        peak = 0.0f;
+        for (uint32_t i = 0; i < window; ++i)
+        {
+            const float power = (spectro->fft_re[i] * spectro->fft_re[i]) +
+                                (spectro->fft_im[i] * spectro->fft_im[i]);
+
+            level[i] = (power > 1.0f) ? (10.0f * log10f(power)) : 0.0f;
+            if (level[i] > peak)
+            {
+                peak = level[i];
+            }
+        }
+
+        radar_frame_put_u16(&block[0], (uint16_t)lroundf(peak * 100.0f));
+
+        /* Negative Doppler bins first */
+        for (uint32_t i = 0; i < window; ++i)
+        {
+            const float steps = (peak - level[(i + half) & (window - 1u)]) * SPECTRO_LEVEL_STEPS_PER_DB;
+
+            block[2u + i] = (steps < (float)SPECTRO_LEVEL_MAX) ? (uint8_t)lroundf(steps) : SPECTRO_LEVEL_MAX;
+        }
+
+        block += 2u + window;
+    }
+
+    return (uint32_t)(block - data);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,95 @@
+/******************************************************************************
+ * File Name:   radar_spectro.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_spectro.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_SPECTRO_H_
+#define RADAR_SPECTRO_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "radar_frame.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RADAR_SPECTRO_MIN_WINDOW        (8u)
+#define RADAR_SPECTRO_MAX_WINDOW        (128u)
+#define RADAR_SPECTRO_MAX_RANGE_BINS    (4u)
+
+#define RADAR_SPECTRO_DEFAULT_RANGE_BIN     (2u)
+#define RADAR_SPECTRO_DEFAULT_RANGE_BINS    (1u)
+#define RADAR_SPECTRO_DEFAULT_WINDOW        (64u)
+#define RADAR_SPECTRO_DEFAULT_HOP           (8u)
+
+/* Spectrogram column layout, all multi-byte fields are little endian:
+ *   [0..1]   first range bin
+ *   [2]      number of range bins
+ *   [3]      log2 of the window length
+ *   [4..5]   hop in frames
+ * followed by one block per range bin:
+ *   [0..1]   peak level in 0.01 dB
+ *   [2..]    one byte per Doppler bin from -window/2 to window/2 - 1, level
+ *            below the peak in 0.5 dB, 255 for 127.5 dB or more */
+#define RADAR_SPECTRO_HEADER_SIZE       (6u)
+#define RADAR_SPECTRO_COLUMN_SIZE(range_bins, window) \
+    (RADAR_SPECTRO_HEADER_SIZE + ((range_bins) * (2u + (window))))
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t range_bin;         /* first range bin */
+    uint8_t range_bins;         /* consecutive range bins */
+    uint16_t window;            /* frames per STFT window, power of 2 */
+    uint16_t hop;               /* frames between columns */
+} radar_spectro_config_t;
+
+typedef struct
+{
+    radar_spectro_config_t config;
+    float window[RADAR_SPECTRO_MAX_WINDOW];
+    float ring_re[RADAR_SPECTRO_MAX_RANGE_BINS][RADAR_SPECTRO_MAX_WINDOW];
+    float ring_im[RADAR_SPECTRO_MAX_RANGE_BINS][RADAR_SPECTRO_MAX_WINDOW];
+    float fft_re[RADAR_SPECTRO_MAX_WINDOW];
+    float fft_im[RADAR_SPECTRO_MAX_WINDOW];
+    uint16_t ring_idx;          /* slot of the next slow-time sample */
+    uint16_t filled;            /* slow-time samples in the ring */
+    uint16_t since_column;      /* frames since the last column */
+} radar_spectro_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+bool radar_spectro_config_is_valid(const radar_spectro_config_t *config);
+void radar_spectro_init(radar_spectro_t *spectro, const radar_spectro_config_t *config);
+void radar_spectro_reset(radar_spectro_t *spectro);
+bool radar_spectro_process(radar_spectro_t *spectro, const radar_geometry_t *geometry, const uint16_t *frame);
+uint32_t radar_spectro_write_column(radar_spectro_t *spectro, uint8_t *data);
+
+#endif /* RADAR_SPECTRO_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,662 @@
+/*****************************************************************************
+ * File name: radar_stages.c
+ *
+ * Description: This file contains the processing stages available to the
+ * frame pipeline. Every stage adapts one of the frame processing modules to
+ * the pipeline interface and keeps its settings and state.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <stddef.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_stages.h"
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t factor;
+    uint16_t *scratch;
+} decim_stage_t;
+
+typedef struct
+{
+    radar_mti_config_t config;
+    radar_mti_t state;
+    radar_geometry_t geometry;  /* geometry the background was built for */
+    uint32_t skipped_frames;
+} mti_stage_t;
+
+typedef struct
+{
+    radar_roi_t roi;
+} roi_stage_t;
+
+typedef struct
+{
+    radar_cfar_config_t config;
+    uint32_t scale;             /* threshold factor of config.threshold_db */
+    uint16_t *antennas;         /* frame split into one block per antenna */
+    radar_rd_t rd;
+    radar_target_t targets[RADAR_CFAR_MAX_TARGETS];
+    uint32_t max_targets;       /* targets fitting into a frame buffer */
+} cfar_stage_t;
+
+typedef struct
+{
+    cfar_stage_t *detector;     /* detection state shared with the cfar stage */
+    radar_track_config_t config;
+    radar_geometry_t geometry;  /* geometry the tracks were built for */
+    radar_tracker_t tracker;
+    uint32_t max_tracks;        /* tracks fitting into a frame buffer */
+    uint32_t frames_since_report;
+} track_stage_t;
+
+typedef struct
+{
+    uint16_t range_bin;
+    radar_geometry_t geometry;  /* geometry the phase history was built for */
+    radar_vital_t state;
+} vital_stage_t;
+
+typedef struct
+{
+    radar_geometry_t geometry;  /* geometry the window was filled with */
+    radar_spectro_t state;
+} spectro_stage_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+static radar_stage_result_t decim_stage_process(void *context, radar_frame_t *frame, uint16_t *out);
+static radar_stage_result_t mti_stage_process(void *context, radar_frame_t *frame, uint16_t *out);
+static radar_stage_result_t roi_stage_process(void *context, radar_frame_t *frame, uint16_t *out);
+static radar_stage_result_t cfar_stage_process(void *context, radar_frame_t *frame, uint16_t *out);
+static radar_stage_result_t track_stage_process(void *context, radar_frame_t *frame, uint16_t *out);
+static radar_stage_result_t vital_stage_process(void *context, radar_frame_t *frame, uint16_t *out);
+static radar_stage_result_t spectro_stage_process(void *context, radar_frame_t *frame, uint16_t *out);
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static decim_stage_t decim_stage;
+static mti_stage_t mti_stage;
+static roi_stage_t roi_stage;
+static cfar_stage_t cfar_stage;
+static track_stage_t track_stage;
+static vital_stage_t vital_stage;
+static spectro_stage_t spectro_stage;
+
+/* Kernels specialized for the geometry of the sensor frames, used as long as
+ * no stage changed the geometry */
+static radar_geometry_t kernel_geometry;
+static const radar_kernels_t *kernels;
+
+const radar_stage_t radar_stages[] =
+{
+    { .name = "decim", .process = decim_stage_process, .in_place = true,  .context = &decim_stage },
+    { .name = "mti",   .process = mti_stage_process,   .in_place = true,  .context = &mti_stage },
+    { .name = "roi",   .process = roi_stage_process,   .in_place = false, .context = &roi_stage },
+    { .name = "cfar",  .process = cfar_stage_process,  .in_place = false, .context = &cfar_stage },
+    { .name = "track", .process = track_stage_process, .in_place = true,  .context = &track_stage },
+    { .name = "vital", .process = vital_stage_process, .in_place = true,  .context = &vital_stage },
+    { .name = "spectro", .process = spectro_stage_process, .in_place = true, .context = &spectro_stage },
+};
+
+const uint32_t radar_num_stages = sizeof(radar_stages) / sizeof(radar_stages[0]);
+
+/*******************************************************************************
+ * Function Name: decim_stage_process
+ *******************************************************************************
+ * Summary:
+ *   Decimates every chirp of the frame in place. Does nothing for a factor of
+ *   1 or a factor that does not fit the frame.
+ *
+ * Parameters:
+ *   context : decimation stage
+ *   frame   : frame to process
+ *   out     : unused, the stage works in place
+ *
+ * Return:
+ *   RADAR_STAGE_CONTINUE
+ ******************************************************************************/
+static radar_stage_result_t decim_stage_process(void *context, radar_frame_t *frame, uint16_t *out)
+{
+    decim_stage_t *stage = (decim_stage_t *)context;
+
+    (void)out;
+
+    if ((stage->factor > 1) && radar_decim_is_valid(stage->factor, &frame->geometry))
+    {
+        radar_decim_frame(stage->factor, &frame->geometry, frame->samples, stage->scratch);
+        radar_decim_geometry(stage->factor, &frame->geometry, &frame->geometry);
+        radar_roi_reset(&frame->roi, &frame->geometry);
+        frame->num_samples /= stage->factor;
+        frame->decimation = stage->factor;
+    }
+
+    return RADAR_STAGE_CONTINUE;
+}
+
+/*******************************************************************************
+ * Function Name: mti_stage_process
+ *******************************************************************************
+ * Summary:
+ *   Removes the static clutter from the frame in place. The background starts
+ *   over whenever the frame geometry changes.
+ *
+ * Parameters:
+ *   context : clutter removal stage
+ *   frame   : frame to process
+ *   out     : unused, the stage works in place
+ *
+ * Return:
+ *   RADAR_STAGE_DROP if the residual power is below the threshold
+ ******************************************************************************/
+static radar_stage_result_t mti_stage_process(void *context, radar_frame_t *frame, uint16_t *out)
+{
+    mti_stage_t *stage = (mti_stage_t *)context;
+    uint32_t energy;
+
+    (void)out;
+
+    if (!stage->config.enabled)
+    {
+        return RADAR_STAGE_CONTINUE;
+    }
+
+    if ((stage->geometry.samples_per_chirp != frame->geometry.samples_per_chirp) ||
+        (stage->geometry.chirps_per_frame != frame->geometry.chirps_per_frame) ||
+        (stage->geometry.rx_antennas != frame->geometry.rx_antennas))
+    {
+        radar_mti_reset(&stage->state);
+        stage->geometry = frame->geometry;
+    }
+
+    energy = radar_mti_process(&stage->state, stage->config.alpha_shift, &frame->geometry, frame->samples);
+
+    /* Nothing moves, the frame number gap tells the client */
+    if (energy < stage->config.energy_threshold)
+    {
+        stage->skipped_frames++;
+        return RADAR_STAGE_DROP;
+    }
+
+    frame->flags |= RADAR_FRAME_FLAG_MTI;
+    return RADAR_STAGE_CONTINUE;
+}
+
+/*******************************************************************************
+ * Function Name: has_sensor_geometry
+ *******************************************************************************
+ * Summary:
+ *   Checks whether a frame still has the geometry of the sensor frames, for
+ *   which the specialized kernels can be used.
+ *
+ * Parameters:
+ *   geometry : frame geometry
+ *
+ * Return:
+ *   true if the specialized kernels apply
+ ******************************************************************************/
+static bool has_sensor_geometry(const radar_geometry_t *geometry)
+{
+    return (kernels != NULL) &&
+           (geometry->samples_per_chirp == kernel_geometry.samples_per_chirp) &&
+           (geometry->chirps_per_frame == kernel_geometry.chirps_per_frame) &&
+           (geometry->rx_antennas == kernel_geometry.rx_antennas);
+}
+
+/*******************************************************************************
+ * Function Name: roi_stage_process
+ *******************************************************************************
+ * Summary:
+ *   Gathers the region of interest into the output buffer. A region that does
+ *   not fit the frame, e.g. after the pipeline changed, selects the complete
+ *   frame. The frame geometry becomes the geometry of the gathered samples.
+ *
+ * Parameters:
+ *   context : region of interest stage
+ *   frame   : frame to process
+ *   out     : output buffer
+ *
+ * Return:
+ *   RADAR_STAGE_CONTINUE
+ ******************************************************************************/
+static radar_stage_result_t roi_stage_process(void *context, radar_frame_t *frame, uint16_t *out)
+{
+    roi_stage_t *stage = (roi_stage_t *)context;
+    radar_roi_t roi = stage->roi;
+    uint32_t num_antennas = 0;
+
+    if (!radar_roi_is_valid(&roi, &frame->geometry))
+    {
+        radar_roi_reset(&roi, &frame->geometry);
+    }
+
+    if (has_sensor_geometry(&frame->geometry))
+    {
+        frame->num_samples = kernels->roi_gather(&roi, frame->samples, out);
+    }
+    else
+    {
+        frame->num_samples = radar_roi_gather(&roi, &frame->geometry, frame->samples, out);
+    }
+
+    for (uint32_t rx = 0; rx < frame->geometry.rx_antennas; ++rx)
+    {
+        num_antennas += (roi.antenna_mask >> rx) & 1u;
+    }
+    frame->geometry.samples_per_chirp = roi.sample_count;
+    frame->geometry.chirps_per_frame = (uint16_t)(((frame->geometry.chirps_per_frame - 1u) / roi.chirp_stride) + 1u);
+    frame->geometry.rx_antennas = (uint8_t)num_antennas;
+    frame->roi = roi;
+
+    return RADAR_STAGE_CONTINUE;
+}
+
+/*******************************************************************************
+ * Function Name: cfar_stage_detect
+ *******************************************************************************
+ * Summary:
+ *   Detects targets in the range-Doppler map of a frame the detector is
+ *   sized for and estimates their angles of arrival.
+ *
+ * Parameters:
+ *   stage : target detection stage
+ *   frame : frame to process
+ *
+ * Return:
+ *   number of targets in stage->targets
+ ******************************************************************************/
+static uint32_t cfar_stage_detect(cfar_stage_t *stage, const radar_frame_t *frame)
+{
+    uint32_t num_targets;
+
+    if (has_sensor_geometry(&frame->geometry))
+    {
+        kernels->deinterleave(frame->samples, stage->antennas);
+    }
+    else
+    {
+        radar_frame_deinterleave(&frame->geometry, frame->samples, stage->antennas);
+    }
+    radar_rd_process(&stage->rd, &frame->geometry, stage->antennas);
+
+    num_targets = radar_cfar_detect(&stage->config, stage->scale, stage->rd.power, stage->rd.range_bins,
+                                     stage->rd.doppler_bins, stage->targets, stage->max_targets);
+    radar_aoa_estimate(&stage->rd, frame->roi.antenna_mask, stage->targets, num_targets);
+
+    return num_targets;
+}
+
+/*******************************************************************************
+ * Function Name: cfar_stage_process
+ *******************************************************************************
+ * Summary:
+ *   Detects targets in the range-Doppler map of the frame, estimates their
+ *   angles of arrival and replaces the samples with the target list. Later
+ *   stages of the pipeline are skipped.
+ *   A frame larger than the sensor frame, which cannot happen with the
+ *   stages of this file, is passed on unchanged.
+ *
+ * Parameters:
+ *   context : target detection stage
+ *   frame   : frame to process
+ *   out     : output buffer for the target list
+ *
+ * Return:
+ *   RADAR_STAGE_DONE if the frame holds a target list
+ ******************************************************************************/
+static radar_stage_result_t cfar_stage_process(void *context, radar_frame_t *frame, uint16_t *out)
+{
+    cfar_stage_t *stage = (cfar_stage_t *)context;
+    uint32_t num_targets;
+
+    if (!radar_rd_is_valid(&stage->rd, &frame->geometry))
+    {
+        memcpy(out, frame->samples, frame->num_samples * sizeof(uint16_t));
+        return RADAR_STAGE_CONTINUE;
+    }
+
+    num_targets = cfar_stage_detect(stage, frame);
+
+    frame->num_samples = radar_cfar_write_targets((uint8_t *)out, stage->targets, num_targets,
+                                                  (uint8_t)radar_fft_log2(2u * stage->rd.range_bins),
+                                                  (uint8_t)radar_fft_log2(stage->rd.doppler_bins)) / sizeof(uint16_t);
+    frame->flags |= RADAR_FRAME_FLAG_TARGETS;
+
+    return RADAR_STAGE_DONE;
+}
+
+/*******************************************************************************
+ * Function Name: track_stage_process
+ *******************************************************************************
+ * Summary:
+ *   Detects targets like the cfar stage and feeds them to the tracker. Every
+ *   interval frames the samples are replaced with the confirmed tracks and
+ *   later stages of the pipeline are skipped, other frames are not sent. The
+ *   tracks are deleted when the frame geometry changes. A frame the detector
+ *   is not sized for is passed on unchanged.
+ *
+ * Parameters:
+ *   context : tracking stage
+ *   frame   : frame to process
+ *   out     : unused, the stage works in place
+ *
+ * Return:
+ *   RADAR_STAGE_DONE if the frame holds a track report, RADAR_STAGE_DROP
+ *   otherwise
+ ******************************************************************************/
+static radar_stage_result_t track_stage_process(void *context, radar_frame_t *frame, uint16_t *out)
+{
+    track_stage_t *stage = (track_stage_t *)context;
+    cfar_stage_t *detector = stage->detector;
+    uint32_t num_targets;
+
+    (void)out;
+
+    if (!radar_rd_is_valid(&detector->rd, &frame->geometry))
+    {
+        return RADAR_STAGE_CONTINUE;
+    }
+
+    if ((stage->geometry.samples_per_chirp != frame->geometry.samples_per_chirp) ||
+        (stage->geometry.chirps_per_frame != frame->geometry.chirps_per_frame))
+    {
+        radar_track_reset(&stage->tracker);
+        stage->geometry = frame->geometry;
+    }
+
+    num_targets = cfar_stage_detect(detector, frame);
+    radar_track_update(&stage->tracker, &stage->config, detector->targets, num_targets);
+
+    if (++stage->frames_since_report < stage->config.interval)
+    {
+        return RADAR_STAGE_DROP;
+    }
+    stage->frames_since_report = 0;
+
+    frame->num_samples = radar_track_write((uint8_t *)frame->samples, &stage->tracker, stage->max_tracks,
+                                           (uint8_t)radar_fft_log2(2u * detector->rd.range_bins),
+                                           (uint8_t)radar_fft_log2(detector->rd.doppler_bins)) / sizeof(uint16_t);
+    frame->flags |= RADAR_FRAME_FLAG_TRACKS;
+
+    return RADAR_STAGE_DONE;
+}
+
+/*******************************************************************************
+ * Function Name: vital_stage_process
+ *******************************************************************************
+ * Summary:
+ *   Tracks the breathing and heart rate at the configured range bin. Once per
+ *   second the samples are replaced with the rates and later stages of the
+ *   pipeline are skipped, other frames are not sent. The estimation starts
+ *   over when the range bin or the frame geometry changes. A range bin
+ *   beyond the frame passes the frame on unchanged.
+ *
+ * Parameters:
+ *   context : vital signs stage
+ *   frame   : frame to process
+ *   out     : unused, the stage works in place
+ *
+ * Return:
+ *   RADAR_STAGE_DONE if the frame holds a result, RADAR_STAGE_DROP otherwise
+ ******************************************************************************/
+static radar_stage_result_t vital_stage_process(void *context, radar_frame_t *frame, uint16_t *out)
+{
+    vital_stage_t *stage = (vital_stage_t *)context;
+    radar_vital_result_t result;
+
+    (void)out;
+
+    if (stage->range_bin >= RADAR_RD_RANGE_BINS(frame->geometry.samples_per_chirp))
+    {
+        return RADAR_STAGE_CONTINUE;
+    }
+
+    if ((stage->geometry.samples_per_chirp != frame->geometry.samples_per_chirp) ||
+        (stage->geometry.chirps_per_frame != frame->geometry.chirps_per_frame) ||
+        (stage->geometry.rx_antennas != frame->geometry.rx_antennas))
+    {
+        radar_vital_reset(&stage->state);
+        stage->geometry = frame->geometry;
+    }
+
+    if (!radar_vital_process(&stage->state, stage->range_bin, &frame->geometry, frame->samples, &result))
+    {
+        return RADAR_STAGE_DROP;
+    }
+
+    frame->num_samples = radar_vital_write_result((uint8_t *)frame->samples, &result) / sizeof(uint16_t);
+    frame->flags |= RADAR_FRAME_FLAG_VITAL;
+
+    return RADAR_STAGE_DONE;
+}
+
+/*******************************************************************************
+ * Function Name: spectro_stage_process
+ *******************************************************************************
+ * Summary:
+ *   Builds the micro-Doppler spectrogram of the configured range bins. Every
+ *   hop frames the samples are replaced with a spectrogram column and later
+ *   stages of the pipeline are skipped, other frames are not sent. The window
+ *   starts over when the frame geometry changes. Range bins beyond the frame
+ *   pass the frame on unchanged.
+ *
+ * Parameters:
+ *   context : spectrogram stage
+ *   frame   : frame to process
+ *   out     : unused, the stage works in place
+ *
+ * Return:
+ *   RADAR_STAGE_DONE if the frame holds a column, RADAR_STAGE_DROP otherwise
+ ******************************************************************************/
+static radar_stage_result_t spectro_stage_process(void *context, radar_frame_t *frame, uint16_t *out)
+{
+    spectro_stage_t *stage = (spectro_stage_t *)context;
+    const radar_spectro_config_t *config = &stage->state.config;
+
+    (void)out;
+
+    if ((config->range_bin + config->range_bins) > RADAR_RD_RANGE_BINS(frame->geometry.samples_per_chirp))
+    {
+        return RADAR_STAGE_CONTINUE;
+    }
+
+    if ((stage->geometry.samples_per_chirp != frame->geometry.samples_per_chirp) ||
+        (stage->geometry.chirps_per_frame != frame->geometry.chirps_per_frame) ||
+        (stage->geometry.rx_antennas != frame->geometry.rx_antennas))
+    {
+        radar_spectro_reset(&stage->state);
+        stage->geometry = frame->geometry;
+    }
+
+    if (!radar_spectro_process(&stage->state, &frame->geometry, frame->samples))
+    {
+        return RADAR_STAGE_DROP;
+    }
+
+    frame->num_samples = radar_spectro_write_column(&stage->state, (uint8_t *)frame->samples) / sizeof(uint16_t);
+    frame->flags |= RADAR_FRAME_FLAG_SPECTRO;
+
+    return RADAR_STAGE_DONE;
+}
+
+/*******************************************************************************
+ * Function Name: radar_stages_init
+ *******************************************************************************
+ * Summary:
+ *   Allocates the state of all stages from the scratch arena. The arena must
+ *   provide RADAR_STAGES_ARENA_SIZE() bytes for the sensor geometry. Called
+ *   again with a reset arena when the sensor geometry changes.
+ *
+ * Parameters:
+ *   arena           : scratch arena
+ *   sensor_geometry : geometry of the frames read from the sensor
+ *   sensor_kernels  : kernels specialized for the sensor geometry
+ *   frame_rate      : frames per second read from the sensor
+ *
+ * Return:
+ *   true if the arena was large enough
+ ******************************************************************************/
+bool radar_stages_init(radar_arena_t *arena, const radar_geometry_t *sensor_geometry,
+                       const radar_kernels_t *sensor_kernels, float frame_rate)
+{
+    const uint32_t chirp_length = (uint32_t)sensor_geometry->samples_per_chirp * sensor_geometry->rx_antennas;
+    const uint32_t frame_size = chirp_length * sensor_geometry->chirps_per_frame * sizeof(uint16_t);
+    int32_t *background;
+    float *rd_memory;
+    uint32_t *rd_power;
+    radar_spectro_config_t spectro_config;
+
+    kernel_geometry = *sensor_geometry;
+    kernels = sensor_kernels;
+
+    decim_stage.factor = 1;
+    decim_stage.scratch = radar_arena_alloc(arena,
+                                            RADAR_DECIM_SCRATCH_SIZE(sensor_geometry->samples_per_chirp,
+                                                                     sensor_geometry->rx_antennas) * sizeof(uint16_t));
+
+    background = radar_arena_alloc(arena, chirp_length * sizeof(int32_t));
+    radar_mti_init(&mti_stage.state, background, chirp_length);
+    mti_stage.config.enabled = false;
+    mti_stage.skipped_frames = 0;
+
+    radar_roi_reset(&roi_stage.roi, sensor_geometry);
+
+    cfar_stage.antennas = radar_arena_alloc(arena, frame_size);
+    rd_memory = radar_arena_alloc(arena, RADAR_RD_MEMORY_SIZE(sensor_geometry->samples_per_chirp,
+                                                              sensor_geometry->chirps_per_frame,
+                                                              sensor_geometry->rx_antennas) * sizeof(float));
+    rd_power = radar_arena_alloc(arena, RADAR_RD_POWER_SIZE(sensor_geometry->samples_per_chirp,
+                                                            sensor_geometry->chirps_per_frame) * sizeof(uint32_t));
+    radar_rd_init(&cfar_stage.rd, rd_memory, rd_power, sensor_geometry);
+    cfar_stage.config.guard_cells = RADAR_CFAR_DEFAULT_GUARD_CELLS;
+    cfar_stage.config.training_cells = RADAR_CFAR_DEFAULT_TRAINING_CELLS;
+    cfar_stage.config.threshold_db = RADAR_CFAR_DEFAULT_THRESHOLD_DB;
+    cfar_stage.scale = radar_cfar_scale(cfar_stage.config.threshold_db);
+    cfar_stage.max_targets = (frame_size < RADAR_TARGETS_SIZE(RADAR_CFAR_MAX_TARGETS))
+                             ? ((frame_size - RADAR_TARGETS_HEADER_SIZE) / RADAR_TARGET_SIZE)
+                             : RADAR_CFAR_MAX_TARGETS;
+
+    track_stage.detector = &cfar_stage;
+    track_stage.config.interval = RADAR_TRACK_DEFAULT_INTERVAL;
+    track_stage.config.gate = RADAR_TRACK_DEFAULT_GATE;
+    track_stage.geometry = *sensor_geometry;
+    track_stage.tracker.next_id = 0;
+    radar_track_reset(&track_stage.tracker);
+    track_stage.max_tracks = (frame_size < RADAR_TRACKS_SIZE(RADAR_TRACK_MAX_TRACKS))
+                             ? ((frame_size - RADAR_TRACKS_HEADER_SIZE) / RADAR_TRACK_SIZE)
+                             : RADAR_TRACK_MAX_TRACKS;
+    track_stage.frames_since_report = 0;
+
+    vital_stage.range_bin = 0;
+    vital_stage.geometry = *sensor_geometry;
+    radar_vital_init(&vital_stage.state, frame_rate);
+
+    spectro_config.range_bin = RADAR_SPECTRO_DEFAULT_RANGE_BIN;
+    spectro_config.range_bins = RADAR_SPECTRO_DEFAULT_RANGE_BINS;
+    spectro_config.window = RADAR_SPECTRO_DEFAULT_WINDOW;
+    spectro_config.hop = RADAR_SPECTRO_DEFAULT_HOP;
+    spectro_stage.geometry = *sensor_geometry;
+    radar_spectro_init(&spectro_stage.state, &spectro_config);
+
+    return (decim_stage.scratch != NULL) && (background != NULL) && (cfar_stage.antennas != NULL) &&
+           (rd_memory != NULL) && (rd_power != NULL);
+}
+
+/*******************************************************************************
+ * Function Name: radar_stages_configure
+ *******************************************************************************
+ * Summary:
+ *   Takes over new settings for all stages. Must not be called while a frame
+ *   is processed. Enabling the clutter removal starts with a new background.
+ *   Changed threshold, vital signs or spectrogram settings re-initialize
+ *   their stage, so call it on a copy of the settings outside of critical
+ *   sections.
+ *
+ * Parameters:
+ *   settings : settings of all stages
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_stages_configure(const radar_stage_settings_t *settings)
+{
+    decim_stage.factor = settings->decimation;
+
+    if (settings->mti.enabled && !mti_stage.config.enabled)
+    {
+        radar_mti_reset(&mti_stage.state);
+    }
+    mti_stage.config = settings->mti;
+
+    roi_stage.roi = settings->roi;
+
+    /* The threshold factor needs powf(), only convert it when it changes */
+    if (settings->cfar.threshold_db != cfar_stage.config.threshold_db)
+    {
+        cfar_stage.scale = radar_cfar_scale(settings->cfar.threshold_db);
+    }
+    cfar_stage.config = settings->cfar;
+
+    track_stage.config = settings->track;
+
+    if (settings->vital_range_bin != vital_stage.range_bin)
+    {
+        radar_vital_reset(&vital_stage.state);
+        vital_stage.range_bin = settings->vital_range_bin;
+    }
+
+    if ((settings->spectro.range_bin != spectro_stage.state.config.range_bin) ||
+        (settings->spectro.range_bins != spectro_stage.state.config.range_bins) ||
+        (settings->spectro.window != spectro_stage.state.config.window) ||
+        (settings->spectro.hop != spectro_stage.state.config.hop))
+    {
+        radar_spectro_init(&spectro_stage.state, &settings->spectro);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_stages_get_mti_skipped
+ *******************************************************************************
+ * Summary:
+ *   Reads the number of frames dropped by the clutter removal because their
+ *   residual power was below the threshold.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   number of dropped frames
+ ******************************************************************************/
+uint32_t radar_stages_get_mti_skipped(void)
+{
+    return mti_stage.skipped_frames;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,92 @@
+/******************************************************************************
+ * File Name:   radar_stages.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_stages.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_STAGES_H_
+#define RADAR_STAGES_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "radar_aoa.h"
+#include "radar_cfar.h"
+#include "radar_decim.h"
+#include "radar_kernels.h"
+#include "radar_mti.h"
+#include "radar_pipeline.h"
+#include "radar_range_doppler.h"
+#include "radar_roi.h"
+#include "radar_spectro.h"
+#include "radar_track.h"
+#include "radar_vital.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Pipeline used until the UDP client selects another one */
+#define RADAR_PIPELINE_DEFAULT          ("decim,mti,roi")
+
+/* Arena size in bytes needed by radar_stages_init() for a sensor geometry */
+#define RADAR_STAGES_ARENA_SIZE(samples_per_chirp, chirps_per_frame, rx_antennas)                          \
+    (RADAR_ARENA_BLOCK_SIZE(RADAR_DECIM_SCRATCH_SIZE(samples_per_chirp, rx_antennas) * sizeof(uint16_t)) +   \
+     RADAR_ARENA_BLOCK_SIZE((samples_per_chirp) * (rx_antennas) * sizeof(int32_t)) +                       \
+     RADAR_ARENA_BLOCK_SIZE((samples_per_chirp) * (chirps_per_frame) * (rx_antennas) * sizeof(uint16_t)) + \
+     RADAR_ARENA_BLOCK_SIZE(RADAR_RD_MEMORY_SIZE(samples_per_chirp, chirps_per_frame, rx_antennas) *       \
+                            sizeof(float)) +                                                               \
+     RADAR_ARENA_BLOCK_SIZE(RADAR_RD_POWER_SIZE(samples_per_chirp, chirps_per_frame) * sizeof(uint32_t)))
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Settings of all stages, taken over before every frame */
+typedef struct
+{
+    uint8_t decimation;
+    radar_mti_config_t mti;
+    radar_roi_t roi;
+    radar_cfar_config_t cfar;
+    radar_track_config_t track;
+    uint16_t vital_range_bin;
+    radar_spectro_config_t spectro;
+} radar_stage_settings_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Stages available for pipeline descriptions */
+extern const radar_stage_t radar_stages[];
+extern const uint32_t radar_num_stages;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+bool radar_stages_init(radar_arena_t *arena, const radar_geometry_t *sensor_geometry,
+                       const radar_kernels_t *sensor_kernels, float frame_rate);
+void radar_stages_configure(const radar_stage_settings_t *settings);
+uint32_t radar_stages_get_mti_skipped(void);
+
+#endif /* RADAR_STAGES_H_ */
+/* [] END OF FILE */
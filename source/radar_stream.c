@@ -0,0 +1,161 @@
+/*****************************************************************************
+ * File name: radar_stream.c
+ *
+ * Description: This file implements the framing of the TCP stream of frame
+ * datagrams: the datagrams are prefixed with their size and collected into
+ * segments on the sending side, and split up again on the receiving side.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_frame.h"
+#include "radar_stream.h"
+
+/*******************************************************************************
+ * Function Name: radar_stream_init
+ *******************************************************************************
+ * Summary:
+ *   Sets up an empty stream.
+ *
+ * Parameters:
+ *   stream       : stream state
+ *   buffer       : RADAR_STREAM_BUFFER_SIZE(segment_size, max_datagram) bytes
+ *   segment_size : bytes written at once
+ *   max_datagram : largest frame datagram
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_stream_init(radar_stream_t *stream, uint8_t *buffer, uint32_t segment_size, uint32_t max_datagram)
+{
+    stream->buffer = buffer;
+    stream->segment_size = segment_size;
+    stream->max_datagram = max_datagram;
+    radar_stream_clear(stream);
+}
+
+/*******************************************************************************
+ * Function Name: radar_stream_add
+ *******************************************************************************
+ * Summary:
+ *   Appends a frame datagram with its size. The stream has to be written
+ *   once it is full before the next datagram is added.
+ *
+ * Parameters:
+ *   stream   : stream state
+ *   datagram : frame datagram
+ *   length   : size of the datagram
+ *
+ * Return:
+ *   true if the datagram was added, false if it exceeds max_datagram or the
+ *   stream is full
+ ******************************************************************************/
+bool radar_stream_add(radar_stream_t *stream, const uint8_t *datagram, uint32_t length)
+{
+    if ((length > stream->max_datagram) || radar_stream_is_full(stream))
+    {
+        return false;
+    }
+
+    radar_frame_put_u32(&stream->buffer[stream->length], length);
+    memcpy(&stream->buffer[stream->length + RADAR_STREAM_LENGTH_SIZE], datagram, length);
+    stream->length += RADAR_STREAM_LENGTH_SIZE + length;
+    stream->frames++;
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_stream_is_full
+ *******************************************************************************
+ * Summary:
+ *   Checks whether the stream holds a full segment to write.
+ *
+ * Parameters:
+ *   stream : stream state
+ *
+ * Return:
+ *   true if the collected datagrams fill a segment
+ ******************************************************************************/
+bool radar_stream_is_full(const radar_stream_t *stream)
+{
+    return stream->length >= stream->segment_size;
+}
+
+/*******************************************************************************
+ * Function Name: radar_stream_clear
+ *******************************************************************************
+ * Summary:
+ *   Empties the stream after its bytes were written or dropped.
+ *
+ * Parameters:
+ *   stream : stream state
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_stream_clear(radar_stream_t *stream)
+{
+    stream->length = 0;
+    stream->frames = 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_stream_next
+ *******************************************************************************
+ * Summary:
+ *   Finds the first frame datagram in received stream bytes, as the client
+ *   does.
+ *
+ * Parameters:
+ *   data            : received bytes, starting with a size
+ *   length          : number of received bytes
+ *   datagram        : output, the datagram
+ *   datagram_length : output, its size
+ *
+ * Return:
+ *   bytes taken by the datagram and its size, 0 if it is not complete yet
+ ******************************************************************************/
+uint32_t radar_stream_next(const uint8_t *data, uint32_t length, const uint8_t **datagram, uint32_t *datagram_length)
+{
+    uint32_t size;
+
+    if (length < RADAR_STREAM_LENGTH_SIZE)
+    {
+        return 0;
+    }
+
+    size = radar_frame_get_u32(data);
+    if ((length - RADAR_STREAM_LENGTH_SIZE) < size)
+    {
+        return 0;
+    }
+
+    *datagram = &data[RADAR_STREAM_LENGTH_SIZE];
+    *datagram_length = size;
+    return RADAR_STREAM_LENGTH_SIZE + size;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,67 @@
+/******************************************************************************
+ * File Name:   radar_stream.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_stream.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_STREAM_H_
+#define RADAR_STREAM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Stream of frame datagrams over TCP: every datagram prefixed with its size,
+ * 4 bytes little endian. Datagrams are collected until a segment is full and
+ * then written at once; the last one may overrun the segment by a whole
+ * datagram with its size. */
+#define RADAR_STREAM_LENGTH_SIZE        (4u)
+#define RADAR_STREAM_BUFFER_SIZE(segment_size, max_datagram) \
+    ((segment_size) + RADAR_STREAM_LENGTH_SIZE + (max_datagram))
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t *buffer;            /* RADAR_STREAM_BUFFER_SIZE(segment_size, max_datagram) bytes */
+    uint32_t segment_size;
+    uint32_t max_datagram;
+    uint32_t length;            /* bytes collected */
+    uint32_t frames;            /* datagrams collected */
+} radar_stream_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void radar_stream_init(radar_stream_t *stream, uint8_t *buffer, uint32_t segment_size, uint32_t max_datagram);
+bool radar_stream_add(radar_stream_t *stream, const uint8_t *datagram, uint32_t length);
+bool radar_stream_is_full(const radar_stream_t *stream);
+void radar_stream_clear(radar_stream_t *stream);
+uint32_t radar_stream_next(const uint8_t *data, uint32_t length, const uint8_t **datagram, uint32_t *datagram_length);
+
+#endif /* RADAR_STREAM_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,234 @@
+/*****************************************************************************
+ * File name: radar_sync.c
+ *
+ * Description: This file implements the two-way time exchange with the host
+ * and the running estimate of the host clock offset and drift applied to
+ * frame timestamps.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_frame.h"
+#include "radar_sync.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Loop gains of the offset and drift correction per filtered exchange */
+#define SYNC_OFFSET_GAIN                (0.25f)
+#define SYNC_DRIFT_GAIN                 (0.02f)
+
+/* Drift limit, crystals are good to a few 10 ppm */
+#define SYNC_MAX_DRIFT                  (500e-6f)
+
+/* An error above this restarts the estimate, the host clock was stepped */
+#define SYNC_STEP_THRESHOLD_US          (100000)
+
+/*******************************************************************************
+ * Function Name: sync_correct
+ *******************************************************************************
+ * Summary:
+ *   Corrects the offset and drift with a filtered exchange: a second order
+ *   loop that moves the offset part of the way to the measurement and the
+ *   drift by the error spread over the time since the last correction. A
+ *   stepped host clock restarts the offset but keeps the drift, the rate of
+ *   the clocks did not change.
+ ******************************************************************************/
+static void sync_correct(radar_sync_t *sync, const radar_sync_sample_t *sample)
+{
+    const int64_t elapsed = (int64_t)(sample->time - sync->ref_time);
+    int64_t predicted;
+    int64_t error;
+
+    if (sync->synced && (elapsed > 0))
+    {
+        predicted = sync->ref_offset + (int64_t)(sync->drift * (float)elapsed);
+        error = sample->offset - predicted;
+        if ((error < SYNC_STEP_THRESHOLD_US) && (error > -SYNC_STEP_THRESHOLD_US))
+        {
+            sync->ref_offset = predicted + (int64_t)(SYNC_OFFSET_GAIN * (float)error);
+            sync->drift += (SYNC_DRIFT_GAIN * (float)error) / (float)elapsed;
+            if (sync->drift > SYNC_MAX_DRIFT)
+            {
+                sync->drift = SYNC_MAX_DRIFT;
+            }
+            else if (sync->drift < -SYNC_MAX_DRIFT)
+            {
+                sync->drift = -SYNC_MAX_DRIFT;
+            }
+            sync->ref_time = sample->time;
+            return;
+        }
+    }
+
+    if (!sync->synced)
+    {
+        sync->drift = 0.0f;
+    }
+    sync->ref_offset = sample->offset;
+    sync->ref_time = sample->time;
+    sync->synced = true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_sync_init
+ *******************************************************************************
+ * Summary:
+ *   Starts without a time estimate.
+ *
+ * Parameters:
+ *   sync : time synchronization state
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_sync_init(radar_sync_t *sync)
+{
+    memset(sync, 0, sizeof(*sync));
+}
+
+/*******************************************************************************
+ * Function Name: radar_sync_write_request
+ *******************************************************************************
+ * Summary:
+ *   Builds the next request, see RADAR_SYNC_REQUEST_SIZE. The request time
+ *   should be taken as late as possible before sending. A response to an
+ *   earlier request is ignored from now on.
+ *
+ * Parameters:
+ *   sync : time synchronization state
+ *   data : output, RADAR_SYNC_REQUEST_SIZE bytes
+ *   now  : device time in microseconds
+ *
+ * Return:
+ *   number of bytes written
+ ******************************************************************************/
+uint32_t radar_sync_write_request(radar_sync_t *sync, uint8_t *data, uint64_t now)
+{
+    sync->sequence++;
+    sync->request_time = now;
+    sync->request_pending = true;
+
+    data[0] = RADAR_SYNC_COMMAND;
+    data[1] = RADAR_FRAME_DUMMY_BYTE;
+    radar_frame_put_u32(&data[2], sync->sequence);
+    radar_frame_put_u64(&data[6], now);
+
+    return RADAR_SYNC_REQUEST_SIZE;
+}
+
+/*******************************************************************************
+ * Function Name: radar_sync_process_response
+ *******************************************************************************
+ * Summary:
+ *   Adds the exchange of a response to the clock filter. Of the last
+ *   RADAR_SYNC_FILTER_LENGTH exchanges the one with the lowest delay has the
+ *   least queueing in it; it corrects the estimate unless it was used
+ *   before.
+ *
+ * Parameters:
+ *   sync   : time synchronization state
+ *   data   : received datagram
+ *   length : size of the datagram
+ *   now    : device time in microseconds the datagram was received
+ *
+ * Return:
+ *   true if the datagram answered the pending request
+ ******************************************************************************/
+bool radar_sync_process_response(radar_sync_t *sync, const uint8_t *data, uint32_t length, uint64_t now)
+{
+    radar_sync_sample_t *sample;
+    const radar_sync_sample_t *best;
+    int64_t t1, t2, t3, t4;
+
+    if ((length != RADAR_SYNC_RESPONSE_SIZE) || (data[0] != RADAR_SYNC_COMMAND) || !sync->request_pending ||
+        (radar_frame_get_u32(&data[2]) != sync->sequence) || (radar_frame_get_u64(&data[6]) != sync->request_time))
+    {
+        return false;
+    }
+    sync->request_pending = false;
+
+    t1 = (int64_t)sync->request_time;
+    t2 = (int64_t)radar_frame_get_u64(&data[14]);
+    t3 = (int64_t)radar_frame_get_u64(&data[22]);
+    t4 = (int64_t)now;
+
+    sample = &sync->samples[sync->next_sample];
+    sample->time = (uint64_t)(t1 + ((t4 - t1) / 2));
+    sample->offset = ((t2 - t1) + (t3 - t4)) / 2;
+    sample->delay = (t4 - t1) - (t3 - t2);
+    sync->next_sample = (sync->next_sample + 1u) % RADAR_SYNC_FILTER_LENGTH;
+    if (sync->num_samples < RADAR_SYNC_FILTER_LENGTH)
+    {
+        sync->num_samples++;
+    }
+
+    best = &sync->samples[0];
+    for (uint32_t i = 1; i < sync->num_samples; ++i)
+    {
+        if (sync->samples[i].delay < best->delay)
+        {
+            best = &sync->samples[i];
+        }
+    }
+
+    if (!sync->synced || (best->time > sync->ref_time))
+    {
+        sync_correct(sync, best);
+        sync->last_delay = best->delay;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_sync_host_time
+ *******************************************************************************
+ * Summary:
+ *   Converts a device time to host time with the current offset and drift.
+ *
+ * Parameters:
+ *   sync        : time synchronization state
+ *   device_time : device time in microseconds
+ *   host_time   : host time in microseconds
+ *
+ * Return:
+ *   true if an estimate exists, host_time is left unchanged otherwise
+ ******************************************************************************/
+bool radar_sync_host_time(const radar_sync_t *sync, uint64_t device_time, uint64_t *host_time)
+{
+    const int64_t elapsed = (int64_t)(device_time - sync->ref_time);
+
+    if (!sync->synced)
+    {
+        return false;
+    }
+
+    *host_time = device_time + (uint64_t)(sync->ref_offset + (int64_t)(sync->drift * (float)elapsed));
+
+    return true;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * File Name:   radar_sync.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_sync.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_SYNC_H_
+#define RADAR_SYNC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Two-way time exchange with the host, all times in microseconds and all
+ * multi-byte fields little endian. The device sends a request:
+ *   [0]      command, RADAR_SYNC_COMMAND
+ *   [1]      dummy byte
+ *   [2..5]   sequence number
+ *   [6..13]  t1, device time the request was sent
+ * and the host echoes it with its own times appended:
+ *   [14..21] t2, host time the request was received
+ *   [22..29] t3, host time the response was sent
+ * The device takes t4 when the response arrives. */
+#define RADAR_SYNC_REQUEST_SIZE         (14)
+#define RADAR_SYNC_RESPONSE_SIZE        (30)
+
+/* Exchanges the clock filter picks the one with the lowest delay from */
+#define RADAR_SYNC_FILTER_LENGTH        (8)
+
+#define RADAR_SYNC_MAX_INTERVAL_MS      (60000)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    uint64_t time;              /* device time halfway through the exchange */
+    int64_t offset;             /* host minus device time */
+    int64_t delay;              /* round trip without the host turnaround */
+} radar_sync_sample_t;
+
+typedef struct
+{
+    radar_sync_sample_t samples[RADAR_SYNC_FILTER_LENGTH];
+    uint32_t num_samples;
+    uint32_t next_sample;
+    uint32_t sequence;          /* of the last request */
+    uint64_t request_time;      /* t1 of the last request */
+    bool request_pending;
+    bool synced;
+    uint64_t ref_time;          /* device time of the last correction */
+    int64_t ref_offset;         /* host minus device time at ref_time */
+    float drift;                /* host clock rate minus device clock rate */
+    int64_t last_delay;         /* delay of the last filtered sample */
+} radar_sync_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void radar_sync_init(radar_sync_t *sync);
+uint32_t radar_sync_write_request(radar_sync_t *sync, uint8_t *data, uint64_t now);
+bool radar_sync_process_response(radar_sync_t *sync, const uint8_t *data, uint32_t length, uint64_t now);
+bool radar_sync_host_time(const radar_sync_t *sync, uint64_t device_time, uint64_t *host_time);
+
+#endif /* RADAR_SYNC_H_ */
+/* [] END OF FILE */
@@ -28,6 +28,7 @@
 /* Header file from system */
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 
 /* Header file includes */
 #include "cybsp.h"
@@ -36,14 +37,22 @@
 #include "rtos_artifacts.h"
 
 /* Header file for local task */
+#include "radar_clock.h"
 #include "radar_config_task.h"
 
+#include "radar_cycles.h"
+#include "radar_fifo.h"
+#include "radar_frame.h"
+#include "radar_handoff.h"
+#include "radar_memory.h"
+#include "radar_pipeline.h"
+#include "radar_profile.h"
+#include "radar_stages.h"
 #include "radar_task.h"
+#include "radar_test_pattern.h"
 #include "udp_server.h"
 #include "xensiv_bgt60trxx_mtb.h"
 
-#define XENSIV_BGT60TRXX_CONF_IMPL
-#include "radar_settings.h"
 /*******************************************************************************
  * Macros
  ******************************************************************************/
@@ -57,12 +66,17 @@
 
 #define XENSIV_BGT60TRXX_SPI_FREQUENCY      (25000000UL)
 
-#define NUM_SAMPLES_PER_FRAME               (XENSIV_BGT60TRXX_CONF_NUM_SAMPLES_PER_CHIRP *\
-                                             XENSIV_BGT60TRXX_CONF_NUM_CHIRPS_PER_FRAME *\
-                                             XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS)
-
 #define GPIO_INTERRUPT_PRIORITY             (6)
 
+#define TEST_BUFFER_SIZE                    (64)
+
+/* Without a FIFO interrupt for this long during acquisition the FIFO is reset */
+#define FIFO_STALL_TIMEOUT_MS(period_us)    ((((period_us) * 4u) / 1000u) + 100u)
+
+/* Largest share of frames skipped while the TCP stream backs up, 1 in 8 is
+ * still read */
+#define TCP_MAX_SKIP                        (8u)
+
 
 /*******************************************************************************
  * Global Variables
@@ -71,16 +85,106 @@ TaskHandle_t radar_task_handle = NULL;
 
 static cyhal_spi_t spi_obj;
 static xensiv_bgt60trxx_mtb_t bgt60_obj;
-static uint16_t bgt60_buffer[NUM_SAMPLES_PER_FRAME + 3] __attribute__((aligned(2)));
+static uint16_t bgt60_buffer[RADAR_MEMORY_SAMPLES_PER_FRAME] __attribute__((aligned(2)));
+static uint16_t tx_buffers[RADAR_MAILBOX_SLOTS][RADAR_MEMORY_TX_BUFFER_WORDS] __attribute__((aligned(2)));
+
+/* Scratch memory of the processing stages, handed out once at startup */
+static uint64_t stage_arena_memory[RADAR_MEMORY_PROCESSING_SIZE / sizeof(uint64_t)];
+static radar_arena_t stage_arena;
+static radar_pipeline_t pipeline;
+
+/* Profile selected by the configuration task and the one the frames are read
+ * with, which changes at the next frame. The settings are checked against the
+ * geometry of the selected profile. */
+static const radar_profile_t *profile_pending = NULL;
+static const radar_profile_t *profile = NULL;
+static radar_geometry_t sensor_geometry;
+
+/* Processing settings from the configuration task, applied at the next frame.
+ * The region of interest refers to the samples after decimation and is set
+ * together with the sensor geometry. */
+static radar_stage_settings_t stage_settings = {
+    .decimation = 1,
+    .mti = {
+        .enabled = false,
+        .alpha_shift = RADAR_MTI_DEFAULT_ALPHA_SHIFT,
+        .energy_threshold = 0
+    },
+    .cfar = {
+        .guard_cells = RADAR_CFAR_DEFAULT_GUARD_CELLS,
+        .training_cells = RADAR_CFAR_DEFAULT_TRAINING_CELLS,
+        .threshold_db = RADAR_CFAR_DEFAULT_THRESHOLD_DB
+    },
+    .track = {
+        .interval = RADAR_TRACK_DEFAULT_INTERVAL,
+        .gate = RADAR_TRACK_DEFAULT_GATE
+    },
+    .vital_range_bin = 0,
+    .spectro = {
+        .range_bin = RADAR_SPECTRO_DEFAULT_RANGE_BIN,
+        .range_bins = RADAR_SPECTRO_DEFAULT_RANGE_BINS,
+        .window = RADAR_SPECTRO_DEFAULT_WINDOW,
+        .hop = RADAR_SPECTRO_DEFAULT_HOP
+    }
+};
+
+/* Pipeline selected by the configuration task, applied at the next frame */
+static const radar_stage_t *pipeline_pending[RADAR_PIPELINE_MAX_STAGES];
+static uint32_t pipeline_pending_length = 0;
+static bool pipeline_changed = false;
 
 static uint32_t frame_num = 0;
-static publisher_data_t udp_data = {
-    .data = (uint8_t *)bgt60_buffer,
-    .cmd =  1,
-    .length = (NUM_SAMPLES_PER_FRAME * 2) + 6
+
+/* Frames go to the UDP server in one of three buffers. In queue mode the
+ * frames are written to the back buffer of the mailbox and queued; while the
+ * UDP server still uses the queued one, new frames are read from the FIFO and
+ * dropped, so a slow transport lowers the frame rate instead of overwriting a
+ * frame in flight. In latest mode the frames are published to the mailbox and
+ * the UDP server is only notified; it takes the newest frame when it is ready
+ * to send. */
+static publisher_data_t tx_msgs[RADAR_MAILBOX_SLOTS];
+static uint64_t tx_times[RADAR_MAILBOX_SLOTS];
+static radar_mailbox_t mailbox;
+static publisher_data_t mailbox_msg = {
+    .cmd = RADAR_LATEST_COMMAND,
+    .data = NULL,
+    .length = 0
+};
+static publisher_data_t *mailbox_msg_ptr = &mailbox_msg;
+static publisher_data_t *volatile tx_pending = NULL;
+static uint32_t tx_dropped = 0;
+
+/* Frames are skipped before processing while the TCP stream backs up: one
+ * of every tcp_skip_factor frames is kept */
+static uint8_t tcp_skip_factor = 1;
+static uint8_t tcp_skip_count = 0;
+static uint32_t tcp_skipped = 0;
+
+/* Hand-off mode selected by the configuration task and the one in use, which
+ * only changes while no queued frame is pending */
+static uint8_t handoff_mode_pending = RADAR_HANDOFF_QUEUE;
+static uint8_t handoff_mode = RADAR_HANDOFF_QUEUE;
+static radar_age_hist_t tx_age;
+
+/* Device time of the last FIFO interrupt, read in a critical section */
+static volatile uint64_t frame_time = 0;
+
+/* Supervision of the sensor FIFO, read by the configuration task in a
+ * critical section */
+static radar_fifo_t fifo;
+static volatile bool acquisition_running = false;
+
+/* Test mode result text */
+static uint8_t test_buffer[TEST_BUFFER_SIZE];
+static publisher_data_t test_msg = {
+    .cmd = RADAR_TEST_COMMAND,
+    .data = test_buffer,
+    .length = 0
 };
-static publisher_data_t * publisher_msg = &udp_data;
+static publisher_data_t *test_msg_ptr = &test_msg;
 static bool test_mode = false;
+static uint16_t test_word = XENSIV_BGT60TRXX_INITIAL_TEST_WORD;
+static bool test_resync = false;
 
 /*******************************************************************************
 * Function Name: xensiv_bgt60trxx_interrupt_handler
@@ -108,6 +212,8 @@ static void xensiv_bgt60trxx_interrupt_handler(void *args, cyhal_gpio_irq_event_
 
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
+    frame_time = radar_clock_now_us_from_isr();
+
     vTaskNotifyGiveFromISR(radar_task_handle, &xHigherPriorityTaskWoken);
 
     /* Context switch needed? */
@@ -130,6 +236,8 @@ static void xensiv_bgt60trxx_interrupt_handler(void *args, cyhal_gpio_irq_event_
 *******************************************************************************/
 static int32_t init_sensor(void)
 {
+    const radar_profile_t *initial = radar_profile_get(RADAR_PROFILE_DEFAULT);
+
     if (cyhal_spi_init(&spi_obj,
                        PIN_XENSIV_BGT60TRXX_SPI_MOSI,
                        PIN_XENSIV_BGT60TRXX_SPI_MISO,
@@ -174,15 +282,15 @@ static int32_t init_sensor(void)
                                   &spi_obj,
                                   PIN_XENSIV_BGT60TRXX_SPI_CSN,
                                   PIN_XENSIV_BGT60TRXX_RSTN,
-                                  register_list,
-                                  XENSIV_BGT60TRXX_CONF_NUM_REGS) != CY_RSLT_SUCCESS)
+                                  initial->registers,
+                                  initial->num_registers) != CY_RSLT_SUCCESS)
     {
         printf("ERROR: xensiv_bgt60trxx_mtb_init failed\n");
         return RESULT_ERROR;
     }
 
     if (xensiv_bgt60trxx_mtb_interrupt_init(&bgt60_obj,
-                                            NUM_SAMPLES_PER_FRAME,
+                                            initial->samples_per_frame,
                                             PIN_XENSIV_BGT60TRXX_IRQ,
                                             GPIO_INTERRUPT_PRIORITY,
                                             xensiv_bgt60trxx_interrupt_handler,
@@ -192,6 +300,11 @@ static int32_t init_sensor(void)
         return RESULT_ERROR;
     }
 
+    profile_pending = initial;
+    profile = initial;
+    sensor_geometry = initial->geometry;
+    radar_roi_reset(&stage_settings.roi, &sensor_geometry);
+
     return RESULT_SUCCESS;
 }
 /*******************************************************************************
@@ -211,36 +324,148 @@ static int32_t init_sensor(void)
 static void test_radar_spi_data_1rx(const uint16_t *samples)
 {
     static uint32_t frame_idx = 0;
-    static uint16_t test_word = XENSIV_BGT60TRXX_INITIAL_TEST_WORD;
 
-    /* Check received data */
-    for (int32_t sample_idx = 0; sample_idx < NUM_SAMPLES_PER_FRAME; ++sample_idx)
+    uint32_t first_error = 0;
+
+    /* The FIFO was reset, the sequence continues at an unknown word */
+    if (test_resync)
     {
-        if ((sample_idx % XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS) == 0)
-        {
-            if (test_word != samples[sample_idx])
-            {
-                printf("Frame %" PRIu32 " error detected. "
-                       "Expected: %" PRIu16 ". "
-                       "Received: %" PRIu16 "\n",
-                       frame_idx, test_word, samples[sample_idx]);
-                CY_ASSERT(false);
-            }
-        }
+        test_word = samples[0];
+        test_resync = false;
+    }
 
-        // Generate next test_word
-        test_word = xensiv_bgt60trxx_get_next_test_word(test_word);
+    /* Check received data */
+    if (profile->kernels.test_verify(samples, &test_word, &first_error) > 0)
+    {
+        printf("Frame %" PRIu32 " error detected at sample %" PRIu32 ". "
+               "Received: %" PRIu16 "\n",
+               frame_idx, first_error, samples[first_error]);
+        CY_ASSERT(false);
     }
 
-    sprintf((char *)publisher_msg->data, "Frame %" PRIu32 " received correctly", frame_idx);
-    publisher_msg->length = strlen((const char *) publisher_msg->data);
+    snprintf((char *)test_msg.data, TEST_BUFFER_SIZE, "Frame %" PRIu32 " received correctly", frame_idx);
+    test_msg.length = strlen((const char *)test_msg.data);
 
     /* Send message back to publish queue. */
-    xQueueSendToBack(radar_data_queue, &publisher_msg, 0 );
+    xQueueSendToBack(radar_data_queue, &test_msg_ptr, 0 );
 
     frame_idx++;
 }
 
+/*******************************************************************************
+ * Function Name: recover_fifo
+ *******************************************************************************
+ * Summary:
+ *   Brings the sensor back to consecutive frames after a FIFO error without
+ *   a new configuration: the frame generation is stopped, the FIFO is
+ *   cleared and the acquisition restarted if it was running.
+ *
+ * Parameters:
+ *   otherwise : reason for the recovery if the FIFO status shows no error
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void recover_fifo(radar_fifo_error_t otherwise)
+{
+    uint32_t fstat = 0;
+    radar_fifo_error_t error;
+    bool success;
+
+    if (xensiv_bgt60trxx_get_reg(&bgt60_obj.dev, XENSIV_BGT60TRXX_REG_FSTAT, &fstat) != XENSIV_BGT60TRXX_STATUS_OK)
+    {
+        fstat = 0;
+    }
+    error = radar_fifo_classify(fstat, otherwise);
+
+    success = (xensiv_bgt60trxx_start_frame(&bgt60_obj.dev, false) == XENSIV_BGT60TRXX_STATUS_OK) &&
+              (xensiv_bgt60trxx_soft_reset(&bgt60_obj.dev, XENSIV_BGT60TRXX_RESET_FIFO) == XENSIV_BGT60TRXX_STATUS_OK);
+
+    /* An interrupt raised before the reset refers to data that is gone */
+    (void)ulTaskNotifyTake(pdTRUE, 0);
+
+    if (success && acquisition_running)
+    {
+        success = (xensiv_bgt60trxx_start_frame(&bgt60_obj.dev, true) == XENSIV_BGT60TRXX_STATUS_OK);
+    }
+
+    taskENTER_CRITICAL();
+    radar_fifo_recovered(&fifo, error, success);
+    taskEXIT_CRITICAL();
+
+    test_resync = true;
+}
+
+/*******************************************************************************
+ * Function Name: skip_for_tcp
+ *******************************************************************************
+ * Summary:
+ *   Lowers the frame rate to what the TCP stream takes. At every kept frame
+ *   the share of skipped frames doubles while the UDP server still holds
+ *   bytes the link did not take, and halves once the link caught up. In UDP
+ *   mode the fill level stays 0 and every frame is kept.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true if the frame is skipped
+ ******************************************************************************/
+static bool skip_for_tcp(void)
+{
+    if (tcp_skip_count != 0)
+    {
+        tcp_skip_count--;
+        tcp_skipped++;
+        return true;
+    }
+
+    if (udp_server_get_tcp_fill() != 0)
+    {
+        if (tcp_skip_factor < TCP_MAX_SKIP)
+        {
+            tcp_skip_factor *= 2u;
+        }
+    }
+    else if (tcp_skip_factor > 1u)
+    {
+        tcp_skip_factor /= 2u;
+    }
+    tcp_skip_count = tcp_skip_factor - 1u;
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: apply_profile
+ *******************************************************************************
+ * Summary:
+ *   Switches the processing to the profile selected by the configuration
+ *   task. The sensor was already configured for it; the stages are allocated
+ *   again for its frame geometry and start over.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void apply_profile(void)
+{
+    taskENTER_CRITICAL();
+    profile = profile_pending;
+    fifo.frame_period_us = profile->frame_period_us;
+    taskEXIT_CRITICAL();
+
+    radar_arena_init(&stage_arena, stage_arena_memory, sizeof(stage_arena_memory));
+    if (!radar_stages_init(&stage_arena, &profile->geometry, &profile->kernels,
+                           1000000.0f / (float)profile->frame_period_us))
+    {
+        printf("Failed to set up the radar processing for profile %s!\n", profile->name);
+        CY_ASSERT(0);
+    }
+}
+
 /*******************************************************************************
  * Function Name: radar_task
  *******************************************************************************
@@ -270,48 +495,215 @@ void radar_task(void *pvParameters)
      * Create task for radar configuration. Configuration parameters come from
      * udp client task.
      */
-    if (pdPASS != xTaskCreate(radar_config_task,
-                              RADAR_CONFIG_TASK_NAME,
-                              RADAR_CONFIG_TASK_STACK_SIZE,
-                              NULL,
-                              RADAR_CONFIG_TASK_PRIORITY,
-                              &radar_config_task_handle))
+    radar_config_task_handle = xTaskCreateStatic(radar_config_task,
+                                                 RADAR_CONFIG_TASK_NAME,
+                                                 RADAR_CONFIG_TASK_STACK_SIZE,
+                                                 NULL,
+                                                 RADAR_CONFIG_TASK_PRIORITY,
+                                                 radar_config_task_stack,
+                                                 &radar_config_task_buffer);
+    if (radar_config_task_handle == NULL)
     {
         printf("Failed to create Radar config task!\n");
         CY_ASSERT(0);
     }
 
+    /* Frames enter the pipeline in the FIFO buffer and ping-pong with the
+     * sample area of the outgoing message */
+    radar_arena_init(&stage_arena, stage_arena_memory, sizeof(stage_arena_memory));
+    if (!radar_stages_init(&stage_arena, &profile->geometry, &profile->kernels,
+                           1000000.0f / (float)profile->frame_period_us) ||
+        !radar_pipeline_parse(radar_stages, radar_num_stages,
+                              RADAR_PIPELINE_DEFAULT, strlen(RADAR_PIPELINE_DEFAULT),
+                              pipeline_pending, &pipeline_pending_length))
+    {
+        printf("Failed to set up the radar processing pipeline!\n");
+        CY_ASSERT(0);
+    }
+    for (uint32_t i = 0; i < RADAR_MAILBOX_SLOTS; ++i)
+    {
+        tx_msgs[i].cmd = RADAR_DATA_COMMAND;
+        tx_msgs[i].data = (uint8_t *)tx_buffers[i];
+        tx_msgs[i].length = 0;
+    }
+    radar_mailbox_init(&mailbox);
+    radar_age_hist_reset(&tx_age);
+    radar_fifo_init(&fifo, profile->frame_period_us);
+    radar_pipeline_init(&pipeline, bgt60_buffer, &tx_buffers[mailbox.back][RADAR_FRAME_HEADER_WORDS]);
+    radar_pipeline_set_stages(&pipeline, pipeline_pending, pipeline_pending_length);
+    radar_cycles_init();
+
     printf("Radar device initialized successfully. Waiting for start from UDP client...\n\n");
 
     for (;;)
     {
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        const TickType_t timeout = acquisition_running ? pdMS_TO_TICKS(FIFO_STALL_TIMEOUT_MS(profile->frame_period_us))
+                                                       : portMAX_DELAY;
+        bool injected;
+
+        if (ulTaskNotifyTake(pdTRUE, timeout) == 0)
+        {
+            /* A missed interrupt edge leaves the FIFO above its limit */
+            if (acquisition_running)
+            {
+                recover_fifo(RADAR_FIFO_STALL);
+            }
+            continue;
+        }
+
+        if (profile != profile_pending)
+        {
+            apply_profile();
+        }
 
-        if (xensiv_bgt60trxx_get_fifo_data(&bgt60_obj.dev,
-                                           &bgt60_buffer[3],
-                                           NUM_SAMPLES_PER_FRAME) == XENSIV_BGT60TRXX_STATUS_OK)
+        injected = radar_fifo_inject(&fifo);
+        if (!injected &&
+            (xensiv_bgt60trxx_get_fifo_data(&bgt60_obj.dev,
+                                            bgt60_buffer,
+                                            profile->samples_per_frame) == XENSIV_BGT60TRXX_STATUS_OK))
         {
             if(!test_mode)
             {
+                radar_frame_t frame = {
+                    .samples = bgt60_buffer,
+                    .num_samples = profile->samples_per_frame,
+                    .geometry = profile->geometry,
+                    .decimation = 1,
+                    .flags = 0
+                };
+
+                radar_stage_settings_t settings;
+                publisher_data_t *publisher_msg;
+                uint16_t *tx_samples;
+                uint8_t slot;
+
+                /* Frames lost in a FIFO recovery keep their numbers */
+                taskENTER_CRITICAL();
+                frame.timestamp = frame_time;
+                frame_num += radar_fifo_frame(&fifo, frame.timestamp);
+                taskEXIT_CRITICAL();
+
+                if (tx_pending != NULL)
+                {
+                    frame_num++;
+                    tx_dropped++;
+                    continue;
+                }
+                if (skip_for_tcp())
+                {
+                    frame_num++;
+                    continue;
+                }
+
+                radar_roi_reset(&frame.roi, &profile->geometry);
+
+                taskENTER_CRITICAL();
+                if (handoff_mode != handoff_mode_pending)
+                {
+                    handoff_mode = handoff_mode_pending;
+                    radar_age_hist_reset(&tx_age);
+                }
+                slot = mailbox.back;
+                settings = stage_settings;
+                if (pipeline_changed)
+                {
+                    radar_pipeline_set_stages(&pipeline, pipeline_pending, pipeline_pending_length);
+                    pipeline_changed = false;
+                }
+                taskEXIT_CRITICAL();
+
+                /* A changed setting re-initializes its stage, which takes too
+                 * long for the critical section */
+                radar_stages_configure(&settings);
+
+                publisher_msg = &tx_msgs[slot];
+                tx_samples = &tx_buffers[slot][RADAR_FRAME_HEADER_WORDS];
+                tx_times[slot] = frame.timestamp;
+                radar_pipeline_set_buffer_b(&pipeline, tx_samples);
+
                 frame_num++;
-                publisher_msg->data[0] = RADAR_DATA_COMMAND;
-                publisher_msg->data[1] = DUMMY_BYTE;
-                publisher_msg->data[2] = (uint8_t)(frame_num & 0x000000ff);
-                publisher_msg->data[3] = (uint8_t)((frame_num & 0x0000ff00) >> 8);
-                publisher_msg->data[4] = (uint8_t)((frame_num & 0x00ff0000) >> 16);
-                publisher_msg->data[5] = (uint8_t)((frame_num & 0xff000000) >> 24);
+                if (radar_pipeline_run(&pipeline, &frame) == RADAR_STAGE_DROP)
+                {
+                    continue;
+                }
+
+                if (frame.samples != tx_samples)
+                {
+                    memcpy(tx_samples, frame.samples, frame.num_samples * sizeof(uint16_t));
+                }
+                if ((frame.flags & RADAR_FRAME_FLAG_TRACKS) != 0)
+                {
+                    publisher_msg->cmd = RADAR_TRACKS_COMMAND;
+                }
+                else if ((frame.flags & RADAR_FRAME_FLAG_SPECTRO) != 0)
+                {
+                    publisher_msg->cmd = RADAR_SPECTRO_COMMAND;
+                }
+                else if ((frame.flags & RADAR_FRAME_FLAG_VITAL) != 0)
+                {
+                    publisher_msg->cmd = RADAR_VITAL_COMMAND;
+                }
+                else if ((frame.flags & RADAR_FRAME_FLAG_TARGETS) != 0)
+                {
+                    publisher_msg->cmd = RADAR_TARGETS_COMMAND;
+                }
+                else
+                {
+                    publisher_msg->cmd = RADAR_DATA_COMMAND;
+                }
+                if (udp_server_host_time(frame.timestamp, &frame.timestamp))
+                {
+                    frame.flags |= RADAR_FRAME_FLAG_SYNCED;
+                }
+                taskENTER_CRITICAL();
+                if (fifo.marker)
+                {
+                    frame.flags |= RADAR_FRAME_FLAG_RESYNC;
+                    fifo.marker = false;
+                }
+                taskEXIT_CRITICAL();
+                radar_frame_write_header(publisher_msg->data, publisher_msg->cmd, frame_num, &frame);
+
+                publisher_msg->length = RADAR_FRAME_HEADER_SIZE + (frame.num_samples * 2);
+
+                if (handoff_mode == RADAR_HANDOFF_LATEST)
+                {
+                    bool notify;
 
-                publisher_msg->length = (NUM_SAMPLES_PER_FRAME * 2) + 6;
+                    taskENTER_CRITICAL();
+                    notify = radar_mailbox_publish(&mailbox);
+                    taskEXIT_CRITICAL();
 
-                /* Send message back to publish queue. */
-                xQueueSendToBack(radar_data_queue, &publisher_msg, 0 );
+                    /* One notification per frame published to an empty mailbox */
+                    if (notify && (xQueueSendToBack(radar_data_queue, &mailbox_msg_ptr, 0) != pdTRUE))
+                    {
+                        taskENTER_CRITICAL();
+                        radar_mailbox_withdraw(&mailbox);
+                        taskEXIT_CRITICAL();
+                        tx_dropped++;
+                    }
+                }
+                else
+                {
+                    /* Send message back to publish queue. */
+                    tx_pending = publisher_msg;
+                    if (xQueueSendToBack(radar_data_queue, &publisher_msg, 0) != pdTRUE)
+                    {
+                        tx_pending = NULL;
+                        tx_dropped++;
+                    }
+                }
             }
             else
             {
-                test_radar_spi_data_1rx(&bgt60_buffer[3]);
+                test_radar_spi_data_1rx(bgt60_buffer);
             }
 
         }
+        else
+        {
+            recover_fifo(injected ? RADAR_FIFO_OVERFLOW : RADAR_FIFO_READ_ERROR);
+        }
     }
 }
 /*******************************************************************************
@@ -328,6 +720,12 @@ void radar_task(void *pvParameters)
  ******************************************************************************/
 int32_t radar_start(bool start)
 {
+    /* The time until the first frame is not lost to a FIFO error */
+    taskENTER_CRITICAL();
+    radar_fifo_restart(&fifo);
+    acquisition_running = start;
+    taskEXIT_CRITICAL();
+
     if (xensiv_bgt60trxx_start_frame(&bgt60_obj.dev, start) != XENSIV_BGT60TRXX_STATUS_OK)
     {
         return RESULT_ERROR;
@@ -361,4 +759,692 @@ int32_t radar_enable_test_mode(bool start)
     return RESULT_SUCCESS;
 }
 
+/*******************************************************************************
+ * Function Name: radar_set_roi
+ *******************************************************************************
+ * Summary:
+ *   Sets the region of interest transmitted from every frame. The new region
+ *   takes effect with the next frame read from the sensor.
+ *
+ * Parameters:
+ *   roi : region of interest to apply
+ *
+ * Return:
+ *   error
+ ******************************************************************************/
+int32_t radar_set_roi(const radar_roi_t *roi)
+{
+    int32_t result = RESULT_ERROR;
+    radar_geometry_t geometry;
+
+    taskENTER_CRITICAL();
+    radar_decim_geometry(stage_settings.decimation, &sensor_geometry, &geometry);
+    if (radar_roi_is_valid(roi, &geometry))
+    {
+        stage_settings.roi = *roi;
+        result = RESULT_SUCCESS;
+    }
+    taskEXIT_CRITICAL();
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_get_roi
+ *******************************************************************************
+ * Summary:
+ *   Reads the region of interest currently applied to every frame.
+ *
+ * Parameters:
+ *   roi : destination for the current region of interest
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_get_roi(radar_roi_t *roi)
+{
+    taskENTER_CRITICAL();
+    *roi = stage_settings.roi;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_set_decimation
+ *******************************************************************************
+ * Summary:
+ *   Sets the decimation factor applied to every chirp before transmission.
+ *   Changing the factor changes the number of samples per chirp, so the region
+ *   of interest is reset to the complete decimated frame.
+ *
+ * Parameters:
+ *   factor : decimation factor, 1 disables the decimation
+ *
+ * Return:
+ *   error
+ ******************************************************************************/
+int32_t radar_set_decimation(uint8_t factor)
+{
+    radar_geometry_t geometry;
+
+    if (!radar_decim_is_valid(factor, &sensor_geometry))
+    {
+        return RESULT_ERROR;
+    }
+
+    radar_decim_geometry(factor, &sensor_geometry, &geometry);
+
+    taskENTER_CRITICAL();
+    if (stage_settings.decimation != factor)
+    {
+        stage_settings.decimation = factor;
+        radar_roi_reset(&stage_settings.roi, &geometry);
+    }
+    taskEXIT_CRITICAL();
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: radar_get_decimation
+ *******************************************************************************
+ * Summary:
+ *   Reads the decimation factor currently applied to every chirp.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   decimation factor
+ ******************************************************************************/
+uint8_t radar_get_decimation(void)
+{
+    return stage_settings.decimation;
+}
+
+/*******************************************************************************
+ * Function Name: radar_set_mti
+ *******************************************************************************
+ * Summary:
+ *   Sets the static clutter removal parameters. Enabling the clutter removal
+ *   starts with a new background.
+ *
+ * Parameters:
+ *   config : clutter removal parameters
+ *
+ * Return:
+ *   error
+ ******************************************************************************/
+int32_t radar_set_mti(const radar_mti_config_t *config)
+{
+    if (!radar_mti_config_is_valid(config))
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    stage_settings.mti = *config;
+    taskEXIT_CRITICAL();
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: radar_get_mti
+ *******************************************************************************
+ * Summary:
+ *   Reads the static clutter removal parameters.
+ *
+ * Parameters:
+ *   config : destination for the clutter removal parameters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_get_mti(radar_mti_config_t *config)
+{
+    taskENTER_CRITICAL();
+    *config = stage_settings.mti;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_set_cfar
+ *******************************************************************************
+ * Summary:
+ *   Sets the target detector parameters.
+ *
+ * Parameters:
+ *   config : target detector parameters
+ *
+ * Return:
+ *   error
+ ******************************************************************************/
+int32_t radar_set_cfar(const radar_cfar_config_t *config)
+{
+    if (!radar_cfar_config_is_valid(config))
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    stage_settings.cfar = *config;
+    taskEXIT_CRITICAL();
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: radar_get_cfar
+ *******************************************************************************
+ * Summary:
+ *   Reads the target detector parameters.
+ *
+ * Parameters:
+ *   config : destination for the target detector parameters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_get_cfar(radar_cfar_config_t *config)
+{
+    taskENTER_CRITICAL();
+    *config = stage_settings.cfar;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_set_track
+ *******************************************************************************
+ * Summary:
+ *   Sets the report interval and association gate of the tracker.
+ *
+ * Parameters:
+ *   config : tracker settings
+ *
+ * Return:
+ *   error
+ ******************************************************************************/
+int32_t radar_set_track(const radar_track_config_t *config)
+{
+    if (!radar_track_config_is_valid(config))
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    stage_settings.track = *config;
+    taskEXIT_CRITICAL();
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: radar_get_track
+ *******************************************************************************
+ * Summary:
+ *   Reads the tracker settings.
+ *
+ * Parameters:
+ *   config : destination for the tracker settings
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_get_track(radar_track_config_t *config)
+{
+    taskENTER_CRITICAL();
+    *config = stage_settings.track;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_set_vital_range_bin
+ *******************************************************************************
+ * Summary:
+ *   Selects the range bin the vital signs are tracked at.
+ *
+ * Parameters:
+ *   range_bin : range bin of the person
+ *
+ * Return:
+ *   error
+ ******************************************************************************/
+int32_t radar_set_vital_range_bin(uint16_t range_bin)
+{
+    int32_t result = RESULT_ERROR;
+
+    taskENTER_CRITICAL();
+    if (range_bin < RADAR_RD_RANGE_BINS(sensor_geometry.samples_per_chirp))
+    {
+        stage_settings.vital_range_bin = range_bin;
+        result = RESULT_SUCCESS;
+    }
+    taskEXIT_CRITICAL();
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_get_vital_range_bin
+ *******************************************************************************
+ * Summary:
+ *   Reads the range bin the vital signs are tracked at.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   range bin
+ ******************************************************************************/
+uint16_t radar_get_vital_range_bin(void)
+{
+    uint16_t range_bin;
+
+    taskENTER_CRITICAL();
+    range_bin = stage_settings.vital_range_bin;
+    taskEXIT_CRITICAL();
+
+    return range_bin;
+}
+
+/*******************************************************************************
+ * Function Name: radar_set_spectro
+ *******************************************************************************
+ * Summary:
+ *   Sets the range bins, window and hop of the micro-Doppler spectrogram. A
+ *   column has to fit into the buffer of a sensor frame.
+ *
+ * Parameters:
+ *   config : spectrogram settings
+ *
+ * Return:
+ *   error
+ ******************************************************************************/
+int32_t radar_set_spectro(const radar_spectro_config_t *config)
+{
+    int32_t result = RESULT_ERROR;
+
+    if (!radar_spectro_config_is_valid(config))
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    if (((config->range_bin + config->range_bins) <= RADAR_RD_RANGE_BINS(sensor_geometry.samples_per_chirp)) &&
+        (RADAR_SPECTRO_COLUMN_SIZE(config->range_bins, config->window) <=
+         (RADAR_MEMORY_FRAME_SAMPLES(sensor_geometry.samples_per_chirp, sensor_geometry.chirps_per_frame,
+                                     sensor_geometry.rx_antennas) * sizeof(uint16_t))))
+    {
+        stage_settings.spectro = *config;
+        result = RESULT_SUCCESS;
+    }
+    taskEXIT_CRITICAL();
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: radar_get_spectro
+ *******************************************************************************
+ * Summary:
+ *   Reads the micro-Doppler spectrogram settings.
+ *
+ * Parameters:
+ *   config : destination for the spectrogram settings
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_get_spectro(radar_spectro_config_t *config)
+{
+    taskENTER_CRITICAL();
+    *config = stage_settings.spectro;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_get_mti_skipped_frames
+ *******************************************************************************
+ * Summary:
+ *   Reads the number of frames not transmitted because their residual power
+ *   after clutter removal was below the threshold.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   number of skipped frames
+ ******************************************************************************/
+uint32_t radar_get_mti_skipped_frames(void)
+{
+    return radar_stages_get_mti_skipped();
+}
+
+/*******************************************************************************
+ * Function Name: radar_set_pipeline
+ *******************************************************************************
+ * Summary:
+ *   Selects the processing stages every frame runs through, given as comma
+ *   separated stage names, e.g. "decim,mti,roi". The new pipeline takes
+ *   effect with the next frame read from the sensor.
+ *
+ * Parameters:
+ *   description : stage names, not null terminated
+ *   length      : length of the description
+ *
+ * Return:
+ *   error
+ ******************************************************************************/
+int32_t radar_set_pipeline(const char *description, uint32_t length)
+{
+    const radar_stage_t *stages[RADAR_PIPELINE_MAX_STAGES];
+    uint32_t num_stages;
+
+    if (!radar_pipeline_parse(radar_stages, radar_num_stages, description, length, stages, &num_stages))
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    memcpy(pipeline_pending, stages, num_stages * sizeof(stages[0]));
+    pipeline_pending_length = num_stages;
+    pipeline_changed = true;
+    taskEXIT_CRITICAL();
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: radar_set_handoff
+ *******************************************************************************
+ * Summary:
+ *   Selects how frames are handed to the UDP server, applied at the next frame
+ *   once no queued frame is pending. The age histogram starts over.
+ *
+ * Parameters:
+ *   mode : RADAR_HANDOFF_QUEUE or RADAR_HANDOFF_LATEST
+ *
+ * Return:
+ *   error
+ ******************************************************************************/
+int32_t radar_set_handoff(uint8_t mode)
+{
+    if ((mode != RADAR_HANDOFF_QUEUE) && (mode != RADAR_HANDOFF_LATEST))
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    handoff_mode_pending = mode;
+    taskEXIT_CRITICAL();
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: radar_set_profile
+ *******************************************************************************
+ * Summary:
+ *   Configures the sensor with another radar profile. Only possible while
+ *   the acquisition is stopped; the processing switches to the profile with
+ *   the next frame. The region of interest and the decimation are reset to
+ *   the frame geometry of the profile, range bins outside of it to defaults.
+ *
+ * Parameters:
+ *   id : profile id, the position in radar_profiles.json
+ *
+ * Return:
+ *   error
+ ******************************************************************************/
+int32_t radar_set_profile(uint8_t id)
+{
+    const radar_profile_t *next = radar_profile_get(id);
+
+    if ((next == NULL) || acquisition_running)
+    {
+        return RESULT_ERROR;
+    }
+
+    if ((xensiv_bgt60trxx_config(&bgt60_obj.dev, next->registers, next->num_registers) != XENSIV_BGT60TRXX_STATUS_OK) ||
+        (xensiv_bgt60trxx_set_fifo_limit(&bgt60_obj.dev, next->samples_per_frame) != XENSIV_BGT60TRXX_STATUS_OK) ||
+        (xensiv_bgt60trxx_soft_reset(&bgt60_obj.dev, XENSIV_BGT60TRXX_RESET_FIFO) != XENSIV_BGT60TRXX_STATUS_OK))
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    profile_pending = next;
+    sensor_geometry = next->geometry;
+    stage_settings.decimation = 1;
+    radar_roi_reset(&stage_settings.roi, &sensor_geometry);
+    if (stage_settings.vital_range_bin >= RADAR_RD_RANGE_BINS(sensor_geometry.samples_per_chirp))
+    {
+        stage_settings.vital_range_bin = 0;
+    }
+    if ((stage_settings.spectro.range_bin + stage_settings.spectro.range_bins) >
+        RADAR_RD_RANGE_BINS(sensor_geometry.samples_per_chirp))
+    {
+        stage_settings.spectro.range_bin = RADAR_SPECTRO_DEFAULT_RANGE_BIN;
+        stage_settings.spectro.range_bins = RADAR_SPECTRO_DEFAULT_RANGE_BINS;
+    }
+    taskEXIT_CRITICAL();
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: radar_set_fifo_inject
+ *******************************************************************************
+ * Summary:
+ *   Simulates sensor FIFO overflows to test the recovery: every interval-th
+ *   FIFO read is skipped and the FIFO is reset as after an overflow.
+ *
+ * Parameters:
+ *   interval : FIFO reads per simulated overflow, 0 disables the simulation
+ *
+ * Return:
+ *   error
+ ******************************************************************************/
+int32_t radar_set_fifo_inject(uint16_t interval)
+{
+    if (interval > RADAR_FIFO_MAX_INJECT_INTERVAL)
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    radar_fifo_set_inject(&fifo, interval);
+    taskEXIT_CRITICAL();
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: radar_take_latest_frame
+ *******************************************************************************
+ * Summary:
+ *   Called by the UDP server for a mailbox notification, takes the newest
+ *   published frame.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   frame message, NULL if the frame was already taken
+ ******************************************************************************/
+publisher_data_t *radar_take_latest_frame(void)
+{
+    publisher_data_t *msg = NULL;
+
+    taskENTER_CRITICAL();
+    if (radar_mailbox_take(&mailbox))
+    {
+        msg = &tx_msgs[mailbox.front];
+    }
+    taskEXIT_CRITICAL();
+
+    return msg;
+}
+
+/*******************************************************************************
+ * Function Name: radar_release_frame
+ *******************************************************************************
+ * Summary:
+ *   Called by the UDP server once it no longer needs the frame message. A
+ *   queued frame buffer may be written again. The age of the frame is counted
+ *   in the histogram.
+ *
+ * Parameters:
+ *   msg : frame message from the radar task
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_release_frame(const publisher_data_t *msg)
+{
+    const uint64_t now = radar_clock_now_us();
+    uint32_t slot = 0;
+
+    while ((slot < RADAR_MAILBOX_SLOTS) && (msg != &tx_msgs[slot]))
+    {
+        slot++;
+    }
+    if (slot == RADAR_MAILBOX_SLOTS)
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    radar_age_hist_add(&tx_age, (uint32_t)(now - tx_times[slot]));
+    if (tx_pending == msg)
+    {
+        tx_pending = NULL;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_format_stats
+ *******************************************************************************
+ * Summary:
+ *   Writes the frame counters and the cycles spent in every pipeline stage as
+ *   a json string.
+ *
+ * Parameters:
+ *   buffer : destination for the json string
+ *   size   : size of the destination
+ *
+ * Return:
+ *   length of the json string, truncated to the destination size
+ ******************************************************************************/
+uint32_t radar_format_stats(char *buffer, uint32_t size)
+{
+    radar_stage_stats_t stats[RADAR_PIPELINE_MAX_STAGES];
+    const char *names[RADAR_PIPELINE_MAX_STAGES];
+    radar_sync_t sync;
+    udp_server_transport_stats_t transport;
+    radar_age_hist_t age;
+    radar_fifo_stats_t fifo_stats;
+    const radar_profile_t *active;
+    uint32_t superseded;
+    uint8_t mode;
+    uint32_t num_stages;
+    uint32_t length;
+
+    taskENTER_CRITICAL();
+    num_stages = pipeline.num_stages;
+    for (uint32_t i = 0; i < num_stages; ++i)
+    {
+        stats[i] = pipeline.stats[i];
+        names[i] = pipeline.stages[i]->name;
+    }
+    age = tx_age;
+    superseded = mailbox.superseded;
+    mode = handoff_mode;
+    fifo_stats = fifo.stats;
+    active = profile;
+    taskEXIT_CRITICAL();
+
+    length = (uint32_t)snprintf(buffer, size, "{\"frames\":%" PRIu32 ",\"mti_skipped\":%" PRIu32
+                                ",\"tx_dropped\":%" PRIu32 ",\"tcp_skipped\":%" PRIu32 ",\"pipeline\":[",
+                                frame_num, radar_stages_get_mti_skipped(), tx_dropped, tcp_skipped);
+
+    for (uint32_t i = 0; (i < num_stages) && (length < size); ++i)
+    {
+        const uint32_t average = (stats[i].runs != 0) ? (uint32_t)(stats[i].total_cycles / stats[i].runs) : 0;
+
+        length += (uint32_t)snprintf(&buffer[length], size - length,
+                                     "%s{\"stage\":\"%s\",\"runs\":%" PRIu32 ",\"avg_cycles\":%" PRIu32
+                                     ",\"max_cycles\":%" PRIu32 "}",
+                                     (i == 0) ? "" : ",", names[i], stats[i].runs, average, stats[i].max_cycles);
+    }
+
+    udp_server_get_sync(&sync);
+    if (length < size)
+    {
+        length += (uint32_t)snprintf(&buffer[length], size - length,
+                                     "],\"sync\":{\"synced\":%s,\"offset_us\":%" PRId64 ",\"drift_ppb\":%" PRId32
+                                     ",\"delay_us\":%" PRId64 "}",
+                                     sync.synced ? "true" : "false", sync.ref_offset,
+                                     (int32_t)(sync.drift * 1e9f), sync.last_delay);
+    }
+
+    udp_server_get_transport_stats(&transport);
+    if (length < size)
+    {
+        length += (uint32_t)snprintf(&buffer[length], size - length,
+                                     ",\"transport\":{\"mode\":\"%s\",\"connected\":%s,\"frames\":%" PRIu32
+                                     ",\"dropped\":%" PRIu32 ",\"bytes\":%" PRIu32 ",\"suspended\":%s"
+                                     ",\"lease_expiries\":%" PRIu32 ",\"wifi\":\"%s\",\"wifi_disconnects\":%" PRIu32
+                                     ",\"kept\":%" PRIu32 ",\"backlog_dropped\":%" PRIu32 "}",
+                                     (transport.mode == UDP_SERVER_TRANSPORT_TCP) ? "tcp" : "udp",
+                                     transport.connected ? "true" : "false", transport.frames_sent,
+                                     transport.frames_dropped, transport.bytes_sent,
+                                     transport.suspended ? "true" : "false", transport.lease_expiries,
+                                     (transport.wifi == RADAR_WIFI_DOWN) ? "down" :
+                                     (transport.wifi == RADAR_WIFI_DRAINING) ? "draining" : "up",
+                                     transport.wifi_disconnects, transport.frames_kept, transport.backlog_dropped);
+    }
+
+    if (length < size)
+    {
+        length += (uint32_t)snprintf(&buffer[length], size - length,
+                                     ",\"handoff\":{\"mode\":\"%s\",\"superseded\":%" PRIu32
+                                     ",\"age_max_us\":%" PRIu32 ",\"age_hist\":[",
+                                     (mode == RADAR_HANDOFF_LATEST) ? "latest" : "queue", superseded, age.max_us);
+    }
+    for (uint32_t i = 0; (i < RADAR_AGE_BINS) && (length < size); ++i)
+    {
+        length += (uint32_t)snprintf(&buffer[length], size - length, "%s%" PRIu32, (i == 0) ? "" : ",", age.count[i]);
+    }
+    if (length < size)
+    {
+        length += (uint32_t)snprintf(&buffer[length], size - length, "]}");
+    }
+
+    if (length < size)
+    {
+        length += (uint32_t)snprintf(&buffer[length], size - length,
+                                     ",\"fifo\":{\"overflows\":%" PRIu32 ",\"underflows\":%" PRIu32
+                                     ",\"read_errors\":%" PRIu32 ",\"stalls\":%" PRIu32 ",\"recoveries\":%" PRIu32
+                                     ",\"failed\":%" PRIu32 ",\"frames_lost\":%" PRIu32 "}",
+                                     fifo_stats.overflows, fifo_stats.underflows, fifo_stats.read_errors,
+                                     fifo_stats.stalls, fifo_stats.recoveries, fifo_stats.failed_recoveries,
+                                     fifo_stats.frames_lost);
+    }
+
+    if (length < size)
+    {
+        length += (uint32_t)snprintf(&buffer[length], size - length,
+                                     ",\"profile\":{\"id\":%u,\"name\":\"%s\",\"samples\":%u,\"chirps\":%u"
+                                     ",\"antennas\":%u,\"period_us\":%" PRIu32 "}}",
+                                     (unsigned int)active->id, active->name,
+                                     (unsigned int)active->geometry.samples_per_chirp,
+                                     (unsigned int)active->geometry.chirps_per_frame,
+                                     (unsigned int)active->geometry.rx_antennas, active->frame_period_us);
+    }
+
+    return (length < size) ? length : (size - 1u);
+}
+
 /* [] END OF FILE */
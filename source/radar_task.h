@@ -28,18 +28,26 @@
 #ifndef RADAR_TASK_H_
 #define RADAR_TASK_H_
 
+#include "radar_cfar.h"
+#include "radar_frame.h"
+#include "radar_mti.h"
+#include "radar_roi.h"
+#include "radar_spectro.h"
+#include "radar_track.h"
+#include "udp_server.h"
+
 /*******************************************************************************
  * Macros
  ******************************************************************************/
 #define RADAR_TASK_NAME       "RADAR PRESENCE TASK"
-#define RADAR_TASK_STACK_SIZE (1024 * 4)
-#define RADAR_TASK_PRIORITY   (3)
+#define RADAR_TASK_STACK_SIZE (configMINIMAL_STACK_SIZE * 8)
+#define RADAR_TASK_PRIORITY   (7)
 
 #define RESULT_SUCCESS  (0)
 #define RESULT_ERROR    (-1)
 
-#define RADAR_DATA_COMMAND  (1)
-#define DUMMY_BYTE          (0xFF)
+/* The command codes of the messages are defined in radar_frame.h */
+#define DUMMY_BYTE          (RADAR_FRAME_DUMMY_BYTE)
 
 /*******************************************************************************
  * Functions
@@ -47,6 +55,28 @@
 void radar_task(void *pvParameters);
 int32_t radar_start(bool start);
 int32_t radar_enable_test_mode(bool start);
+int32_t radar_set_roi(const radar_roi_t *roi);
+void radar_get_roi(radar_roi_t *roi);
+int32_t radar_set_decimation(uint8_t factor);
+uint8_t radar_get_decimation(void);
+int32_t radar_set_mti(const radar_mti_config_t *config);
+void radar_get_mti(radar_mti_config_t *config);
+uint32_t radar_get_mti_skipped_frames(void);
+int32_t radar_set_cfar(const radar_cfar_config_t *config);
+void radar_get_cfar(radar_cfar_config_t *config);
+int32_t radar_set_track(const radar_track_config_t *config);
+void radar_get_track(radar_track_config_t *config);
+int32_t radar_set_vital_range_bin(uint16_t range_bin);
+uint16_t radar_get_vital_range_bin(void);
+int32_t radar_set_spectro(const radar_spectro_config_t *config);
+void radar_get_spectro(radar_spectro_config_t *config);
+int32_t radar_set_pipeline(const char *description, uint32_t length);
+int32_t radar_set_handoff(uint8_t mode);
+int32_t radar_set_fifo_inject(uint16_t interval);
+int32_t radar_set_profile(uint8_t id);
+publisher_data_t *radar_take_latest_frame(void);
+void radar_release_frame(const publisher_data_t *msg);
+uint32_t radar_format_stats(char *buffer, uint32_t size);
 
 #endif /* RADAR_TASK_H_ */
 /* [] END OF FILE */
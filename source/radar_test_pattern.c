@@ -0,0 +1,88 @@
+/*****************************************************************************
+ * File name: radar_test_pattern.c
+ *
+ * Description: This file implements the generation and verification of the
+ * deterministic sequence the sensor writes to antenna RX1 in data test mode.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from library */
+#include "xensiv_bgt60trxx.h"
+
+/* Header file for local module */
+#include "radar_kernels.h"
+#include "radar_test_pattern.h"
+
+/*******************************************************************************
+ * Function Name: radar_test_pattern_fill
+ *******************************************************************************
+ * Summary:
+ *   Writes the test sequence to the RX1 samples of a frame the way the sensor
+ *   does in data test mode. The samples of the other antennas are cleared.
+ *
+ * Parameters:
+ *   samples     : frame buffer
+ *   num_samples : number of samples in the frame
+ *   rx_antennas : number of interleaved RX antennas
+ *   test_word   : sequence state, updated for the next frame
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_test_pattern_fill(uint16_t *samples, uint32_t num_samples, uint32_t rx_antennas,
+                             uint16_t *test_word)
+{
+    uint16_t word = *test_word;
+
+    for (uint32_t sample_idx = 0; sample_idx < num_samples; ++sample_idx)
+    {
+        samples[sample_idx] = ((sample_idx % rx_antennas) == 0) ? word : 0;
+        word = xensiv_bgt60trxx_get_next_test_word(word);
+    }
+
+    *test_word = word;
+}
+
+/*******************************************************************************
+ * Function Name: radar_test_pattern_verify
+ *******************************************************************************
+ * Summary:
+ *   Compares the RX1 samples of a frame with the test sequence. The sequence
+ *   advances by one word per sample of any antenna.
+ *
+ * Parameters:
+ *   samples     : frame buffer
+ *   num_samples : number of samples in the frame
+ *   rx_antennas : number of interleaved RX antennas
+ *   test_word   : sequence state, updated for the next frame
+ *   first_error : index of the first wrong sample, untouched if all match
+ *
+ * Return:
+ *   number of wrong samples
+ ******************************************************************************/
+uint32_t radar_test_pattern_verify(const uint16_t *samples, uint32_t num_samples, uint32_t rx_antennas,
+                                   uint16_t *test_word, uint32_t *first_error)
+{
+    return radar_kernel_test_verify(samples, num_samples, rx_antennas, test_word, first_error);
+}
+
+/* [] END OF FILE */
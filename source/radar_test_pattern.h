@@ -0,0 +1,42 @@
+/******************************************************************************
+ * File Name:   radar_test_pattern.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_test_pattern.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_TEST_PATTERN_H_
+#define RADAR_TEST_PATTERN_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void radar_test_pattern_fill(uint16_t *samples, uint32_t num_samples, uint32_t rx_antennas,
+                             uint16_t *test_word);
+uint32_t radar_test_pattern_verify(const uint16_t *samples, uint32_t num_samples, uint32_t rx_antennas,
+                                   uint16_t *test_word, uint32_t *first_error);
+
+#endif /* RADAR_TEST_PATTERN_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,272 @@
+/*****************************************************************************
+ * File name: radar_track.c
+ *
+ * Description: This file implements the multi-target tracker: alpha-beta
+ * filtered tracks fed by gated nearest-neighbour association of the detected
+ * targets.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+
+/* Header file for local module */
+#include "radar_frame.h"
+#include "radar_track.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Alpha-beta gains of the range and smoothing of the Doppler bin */
+#define TRACK_ALPHA                     (0.5f)
+#define TRACK_BETA                      (0.1f)
+#define TRACK_DOPPLER_ALPHA             (0.5f)
+
+/* Confidence of a new track, moved a quarter of the way to 100 percent on
+ * every detection and to 0 on every miss */
+#define TRACK_BIRTH_CONFIDENCE          (25u)
+#define TRACK_FULL_CONFIDENCE           (100u)
+
+#define TRACK_NONE                      (0xFFu)
+
+/*******************************************************************************
+ * Function Name: radar_track_config_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks the tracker settings against their limits.
+ *
+ * Parameters:
+ *   config : tracker settings
+ *
+ * Return:
+ *   true if the settings are valid
+ ******************************************************************************/
+bool radar_track_config_is_valid(const radar_track_config_t *config)
+{
+    return (config->interval >= RADAR_TRACK_MIN_INTERVAL) &&
+           (config->gate >= RADAR_TRACK_MIN_GATE) && (config->gate <= RADAR_TRACK_MAX_GATE);
+}
+
+/*******************************************************************************
+ * Function Name: radar_track_reset
+ *******************************************************************************
+ * Summary:
+ *   Deletes all tracks. Track ids keep counting up.
+ *
+ * Parameters:
+ *   tracker : tracker state
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_track_reset(radar_tracker_t *tracker)
+{
+    tracker->num_tracks = 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_track_update
+ *******************************************************************************
+ * Summary:
+ *   Advances all tracks by one frame. The closest pair of track and target
+ *   within the gate is associated first, then the next closest of the
+ *   remaining ones, until no pair is left. Associated tracks are corrected
+ *   with their target, the others coast on their prediction and are deleted
+ *   once they missed too many frames. Targets outside the gate of every
+ *   track start a new tentative track while the table has room.
+ *
+ * Parameters:
+ *   tracker     : tracker state
+ *   config      : tracker settings
+ *   targets     : targets detected in the frame
+ *   num_targets : number of targets, at most RADAR_CFAR_MAX_TARGETS
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_track_update(radar_tracker_t *tracker, const radar_track_config_t *config,
+                        const radar_target_t *targets, uint32_t num_targets)
+{
+    const float gate = (float)config->gate;
+    uint8_t track_target[RADAR_TRACK_MAX_TRACKS];
+    uint32_t targets_used = 0;
+    uint32_t kept = 0;
+
+    if (num_targets > RADAR_CFAR_MAX_TARGETS)
+    {
+        num_targets = RADAR_CFAR_MAX_TARGETS;
+    }
+
+    for (uint32_t t = 0; t < tracker->num_tracks; ++t)
+    {
+        tracker->tracks[t].range += tracker->tracks[t].range_rate;
+        track_target[t] = TRACK_NONE;
+    }
+
+    /* Gated nearest neighbour association, closest pair first */
+    for (;;)
+    {
+        float best_distance = 2.0f * gate * gate;
+        uint32_t best_track = TRACK_NONE;
+        uint32_t best_target = 0;
+
+        for (uint32_t t = 0; t < tracker->num_tracks; ++t)
+        {
+            if (track_target[t] != TRACK_NONE)
+            {
+                continue;
+            }
+
+            for (uint32_t d = 0; d < num_targets; ++d)
+            {
+                const float range_error = (float)targets[d].range_bin - tracker->tracks[t].range;
+                const float doppler_error = (float)targets[d].doppler_bin - tracker->tracks[t].doppler;
+                const float distance = (range_error * range_error) + (doppler_error * doppler_error);
+
+                if (((targets_used & (1uL << d)) == 0) &&
+                    (fabsf(range_error) <= gate) && (fabsf(doppler_error) <= gate) &&
+                    (distance <= best_distance))
+                {
+                    best_distance = distance;
+                    best_track = t;
+                    best_target = d;
+                }
+            }
+        }
+
+        if (best_track == TRACK_NONE)
+        {
+            break;
+        }
+        track_target[best_track] = (uint8_t)best_target;
+        targets_used |= 1uL << best_target;
+    }
+
+    /* Correct or coast every track, dropping the lost ones */
+    for (uint32_t t = 0; t < tracker->num_tracks; ++t)
+    {
+        radar_track_t track = tracker->tracks[t];
+
+        if (track_target[t] != TRACK_NONE)
+        {
+            const radar_target_t *target = &targets[track_target[t]];
+            const float residual = (float)target->range_bin - track.range;
+
+            track.range += TRACK_ALPHA * residual;
+            track.range_rate += TRACK_BETA * residual;
+            track.doppler += TRACK_DOPPLER_ALPHA * ((float)target->doppler_bin - track.doppler);
+            track.hits = (track.hits < UINT8_MAX) ? (uint8_t)(track.hits + 1u) : UINT8_MAX;
+            track.misses = 0;
+            track.confidence = (uint8_t)(track.confidence + ((TRACK_FULL_CONFIDENCE - track.confidence + 3u) / 4u));
+        }
+        else
+        {
+            track.misses++;
+            track.confidence = (uint8_t)(track.confidence - ((track.confidence + 3u) / 4u));
+            if ((track.hits < RADAR_TRACK_CONFIRM_HITS) || (track.misses > RADAR_TRACK_MAX_MISSES))
+            {
+                continue;
+            }
+        }
+
+        tracker->tracks[kept++] = track;
+    }
+    tracker->num_tracks = kept;
+
+    /* Births from the targets no track claimed */
+    for (uint32_t d = 0; (d < num_targets) && (tracker->num_tracks < RADAR_TRACK_MAX_TRACKS); ++d)
+    {
+        radar_track_t *track;
+        bool claimed = ((targets_used & (1uL << d)) != 0);
+
+        for (uint32_t t = 0; (t < tracker->num_tracks) && !claimed; ++t)
+        {
+            claimed = (fabsf((float)targets[d].range_bin - tracker->tracks[t].range) <= gate) &&
+                      (fabsf((float)targets[d].doppler_bin - tracker->tracks[t].doppler) <= gate);
+        }
+        if (claimed)
+        {
+            continue;
+        }
+
+        track = &tracker->tracks[tracker->num_tracks++];
+        track->range = (float)targets[d].range_bin;
+        track->range_rate = 0.0f;
+        track->doppler = (float)targets[d].doppler_bin;
+        track->id = tracker->next_id++;
+        track->hits = 1;
+        track->misses = 0;
+        track->confidence = TRACK_BIRTH_CONFIDENCE;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_track_write
+ *******************************************************************************
+ * Summary:
+ *   Encodes the confirmed tracks, see RADAR_TRACKS_SIZE for the layout.
+ *   Tentative tracks are left out.
+ *
+ * Parameters:
+ *   data             : output, RADAR_TRACKS_SIZE(max_tracks) bytes
+ *   tracker          : tracker state
+ *   max_tracks       : most tracks to write
+ *   range_fft_log2   : log2 of the range FFT size
+ *   doppler_fft_log2 : log2 of the Doppler FFT size
+ *
+ * Return:
+ *   number of bytes written
+ ******************************************************************************/
+uint32_t radar_track_write(uint8_t *data, const radar_tracker_t *tracker, uint32_t max_tracks,
+                           uint8_t range_fft_log2, uint8_t doppler_fft_log2)
+{
+    uint32_t num_written = 0;
+    uint8_t *entry = &data[RADAR_TRACKS_HEADER_SIZE];
+
+    for (uint32_t t = 0; (t < tracker->num_tracks) && (num_written < max_tracks); ++t)
+    {
+        const radar_track_t *track = &tracker->tracks[t];
+        const float range = fminf(fmaxf(track->range * 100.0f, 0.0f), (float)UINT16_MAX);
+        const float velocity = fminf(fmaxf(track->doppler * 100.0f, (float)INT16_MIN), (float)INT16_MAX);
+
+        if (track->hits < RADAR_TRACK_CONFIRM_HITS)
+        {
+            continue;
+        }
+
+        radar_frame_put_u16(&entry[0], track->id);
+        radar_frame_put_u16(&entry[2], (uint16_t)lroundf(range));
+        radar_frame_put_u16(&entry[4], (uint16_t)(int16_t)lroundf(velocity));
+        entry[6] = track->confidence;
+        entry[7] = track->misses;
+        entry += RADAR_TRACK_SIZE;
+        num_written++;
+    }
+
+    radar_frame_put_u16(&data[0], (uint16_t)num_written);
+    data[2] = range_fft_log2;
+    data[3] = doppler_fft_log2;
+
+    return RADAR_TRACKS_SIZE(num_written);
+}
+
+/* [] END OF FILE */
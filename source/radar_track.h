@@ -0,0 +1,108 @@
+/******************************************************************************
+ * File Name:   radar_track.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_track.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_TRACK_H_
+#define RADAR_TRACK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "radar_cfar.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Capacity of the track table */
+#define RADAR_TRACK_MAX_TRACKS          (16)
+
+#define RADAR_TRACK_MIN_INTERVAL        (1)
+#define RADAR_TRACK_MAX_INTERVAL        (255)
+#define RADAR_TRACK_MIN_GATE            (1)
+#define RADAR_TRACK_MAX_GATE            (16)
+
+#define RADAR_TRACK_DEFAULT_INTERVAL    (10)
+#define RADAR_TRACK_DEFAULT_GATE        (3)
+
+/* A track is reported once it was detected in this many frames and deleted
+ * after this many frames in a row without a detection. A tentative track is
+ * deleted at its first miss. */
+#define RADAR_TRACK_CONFIRM_HITS        (3)
+#define RADAR_TRACK_MAX_MISSES          (20)
+
+/* Track report layout, all multi-byte fields are little endian:
+ *   [0..1]   number of tracks
+ *   [2]      log2 of the range FFT size
+ *   [3]      log2 of the Doppler FFT size
+ * followed by one entry per confirmed track:
+ *   [0..1]   track id
+ *   [2..3]   range in 0.01 range bins
+ *   [4..5]   velocity in 0.01 Doppler bins, signed
+ *   [6]      confidence in percent
+ *   [7]      frames since the last detection */
+#define RADAR_TRACKS_HEADER_SIZE        (4)
+#define RADAR_TRACK_SIZE                (8)
+#define RADAR_TRACKS_SIZE(num_tracks)   (RADAR_TRACKS_HEADER_SIZE + ((num_tracks) * RADAR_TRACK_SIZE))
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t interval;           /* frames between track reports */
+    uint8_t gate;               /* largest range and Doppler distance of a detection in bins */
+} radar_track_config_t;
+
+typedef struct
+{
+    float range;                /* range bins */
+    float range_rate;           /* range bins per frame */
+    float doppler;              /* Doppler bins */
+    uint16_t id;
+    uint8_t hits;               /* frames with a detection, saturating */
+    uint8_t misses;             /* frames in a row without a detection */
+    uint8_t confidence;         /* percent */
+} radar_track_t;
+
+typedef struct
+{
+    radar_track_t tracks[RADAR_TRACK_MAX_TRACKS];
+    uint32_t num_tracks;
+    uint16_t next_id;
+} radar_tracker_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+bool radar_track_config_is_valid(const radar_track_config_t *config);
+void radar_track_reset(radar_tracker_t *tracker);
+void radar_track_update(radar_tracker_t *tracker, const radar_track_config_t *config,
+                        const radar_target_t *targets, uint32_t num_targets);
+uint32_t radar_track_write(uint8_t *data, const radar_tracker_t *tracker, uint32_t max_tracks,
+                           uint8_t range_fft_log2, uint8_t doppler_fft_log2);
+
+#endif /* RADAR_TRACK_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,369 @@
+/*****************************************************************************
+ * File name: radar_vital.c
+ *
+ * Description: This file implements the breathing and heart rate estimation
+ * from the phase of one range bin tracked over frames.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_range_doppler.h"
+#include "radar_vital.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define VITAL_PI                        (3.14159265f)
+
+/* Damping of the sliding DFT, keeps rounding errors from accumulating */
+#define VITAL_DAMPING                   (0.9999f)
+
+#define VITAL_QUALITY_SHIFT             (8)
+
+/*******************************************************************************
+ * Function Name: band_init
+ *******************************************************************************
+ * Summary:
+ *   Designs the band-pass filter of a band and selects the sliding DFT bins
+ *   covering it plus one guard bin on each side for the Hann window.
+ ******************************************************************************/
+static void band_init(radar_vital_band_t *band, float min_hz, float max_hz, float sample_rate, uint32_t window)
+{
+    const float center = sqrtf(min_hz * max_hz);
+    const float w0 = (2.0f * VITAL_PI * center) / sample_rate;
+    const float alpha = sinf(w0) * (max_hz - min_hz) / (2.0f * center);
+    const float a0 = 1.0f + alpha;
+    int32_t first = (int32_t)ceilf((min_hz * (float)window) / sample_rate);
+    int32_t last = (int32_t)floorf((max_hz * (float)window) / sample_rate);
+
+    band->filter.b0 = alpha / a0;
+    band->filter.b2 = -alpha / a0;
+    band->filter.a1 = (-2.0f * cosf(w0)) / a0;
+    band->filter.a2 = (1.0f - alpha) / a0;
+
+    /* Bins must stay below the Nyquist bin including the guard bin */
+    if (last > (((int32_t)window / 2) - 2))
+    {
+        last = ((int32_t)window / 2) - 2;
+    }
+    if (first < 1)
+    {
+        first = 1;
+    }
+
+    band->num_bins = (last >= first) ? (uint16_t)((last - first) + 3) : 0u;
+    band->first_bin = (uint16_t)(first - 1);
+
+    for (uint32_t i = 0; i < band->num_bins; ++i)
+    {
+        const float angle = (2.0f * VITAL_PI * (float)(band->first_bin + i)) / (float)window;
+
+        band->twiddle_re[i] = VITAL_DAMPING * cosf(angle);
+        band->twiddle_im[i] = VITAL_DAMPING * sinf(angle);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: band_update
+ *******************************************************************************
+ * Summary:
+ *   Filters a new phase sample, replaces the oldest sample of the window and
+ *   updates the DFT bins incrementally:
+ *   X(n) = r * exp(j*2*pi*k/N) * (X(n-1) + x(n) - r^N * x(n-N)).
+ ******************************************************************************/
+static void band_update(radar_vital_band_t *band, float sample, uint32_t ring_idx, float damping_window)
+{
+    radar_vital_biquad_t *filter = &band->filter;
+    const float filtered = (filter->b0 * sample) + filter->z1;
+    const float delta = filtered - (damping_window * band->ring[ring_idx]);
+
+    filter->z1 = filter->z2 - (filter->a1 * filtered);
+    filter->z2 = (filter->b2 * sample) - (filter->a2 * filtered);
+    band->ring[ring_idx] = filtered;
+
+    for (uint32_t i = 0; i < band->num_bins; ++i)
+    {
+        const float re = band->bin_re[i] + delta;
+        const float im = band->bin_im[i];
+
+        band->bin_re[i] = (re * band->twiddle_re[i]) - (im * band->twiddle_im[i]);
+        band->bin_im[i] = (re * band->twiddle_im[i]) + (im * band->twiddle_re[i]);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: band_estimate
+ *******************************************************************************
+ * Summary:
+ *   Finds the strongest Hann windowed bin of the band, refines it by
+ *   parabolic interpolation and converts it to a rate per minute.
+ ******************************************************************************/
+static void band_estimate(const radar_vital_band_t *band, float sample_rate, uint32_t window,
+                          uint16_t *rate, uint16_t *quality)
+{
+    float magnitude[RADAR_VITAL_MAX_BINS];
+    float peak_power = 0.0f;
+    float total_power = 0.0f;
+    uint32_t peak = 1;
+    float offset = 0.0f;
+    float value;
+
+    *rate = 0;
+    *quality = 0;
+
+    if (band->num_bins < 3u)
+    {
+        return;
+    }
+
+    /* Hann window applied in the frequency domain */
+    for (uint32_t i = 1; i < (band->num_bins - 1u); ++i)
+    {
+        const float re = band->bin_re[i] - (0.5f * (band->bin_re[i - 1u] + band->bin_re[i + 1u]));
+        const float im = band->bin_im[i] - (0.5f * (band->bin_im[i - 1u] + band->bin_im[i + 1u]));
+        const float power = (re * re) + (im * im);
+
+        magnitude[i] = sqrtf(power);
+        total_power += power;
+        if (power > peak_power)
+        {
+            peak_power = power;
+            peak = i;
+        }
+    }
+
+    if (peak_power <= 0.0f)
+    {
+        return;
+    }
+
+    if ((peak > 1u) && (peak < (band->num_bins - 2u)))
+    {
+        const float left = magnitude[peak - 1u];
+        const float center = magnitude[peak];
+        const float right = magnitude[peak + 1u];
+        const float curvature = left - (2.0f * center) + right;
+
+        if (curvature < 0.0f)
+        {
+            offset = (0.5f * (left - right)) / curvature;
+        }
+    }
+
+    value = (((float)(band->first_bin + peak) + offset) * sample_rate * 60.0f * 10.0f) / (float)window;
+    *rate = (uint16_t)lroundf(value);
+
+    value = (peak_power * (float)(band->num_bins - 2u) * (float)(1u << VITAL_QUALITY_SHIFT)) / total_power;
+    *quality = (value < 65535.0f) ? (uint16_t)value : UINT16_MAX;
+}
+
+/*******************************************************************************
+ * Function Name: radar_vital_init
+ *******************************************************************************
+ * Summary:
+ *   Sets up the vital signs estimation for a frame rate. The phase of every
+ *   frame_rate / RADAR_VITAL_SAMPLE_RATE_HZ frames is averaged into one
+ *   sample, the rates are estimated over RADAR_VITAL_WINDOW_S seconds and
+ *   reported once per second.
+ *
+ * Parameters:
+ *   vital      : vital signs state
+ *   frame_rate : frames per second
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_vital_init(radar_vital_t *vital, float frame_rate)
+{
+    const long frames_per_sample = lroundf(frame_rate / RADAR_VITAL_SAMPLE_RATE_HZ);
+    long window;
+    long samples_per_report;
+
+    vital->frames_per_sample = (frames_per_sample > 1) ? (uint32_t)frames_per_sample : 1u;
+    vital->sample_rate = frame_rate / (float)vital->frames_per_sample;
+
+    window = lroundf((float)RADAR_VITAL_WINDOW_S * vital->sample_rate);
+    vital->window = (window > (long)RADAR_VITAL_MAX_WINDOW) ? RADAR_VITAL_MAX_WINDOW
+                    : ((window > 1) ? (uint32_t)window : 1u);
+    vital->damping_window = powf(VITAL_DAMPING, (float)vital->window);
+
+    samples_per_report = lroundf(vital->sample_rate);
+    vital->samples_per_report = (samples_per_report > 1) ? (uint32_t)samples_per_report : 1u;
+
+    band_init(&vital->breathing, RADAR_VITAL_BREATHING_MIN_HZ, RADAR_VITAL_BREATHING_MAX_HZ,
+              vital->sample_rate, vital->window);
+    band_init(&vital->heart, RADAR_VITAL_HEART_MIN_HZ, RADAR_VITAL_HEART_MAX_HZ,
+              vital->sample_rate, vital->window);
+
+    radar_vital_reset(vital);
+}
+
+/*******************************************************************************
+ * Function Name: radar_vital_reset
+ *******************************************************************************
+ * Summary:
+ *   Starts over with an empty window, e.g. after the range bin changed.
+ *
+ * Parameters:
+ *   vital : vital signs state
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_vital_reset(radar_vital_t *vital)
+{
+    radar_vital_band_t *bands[] = { &vital->breathing, &vital->heart };
+
+    for (uint32_t i = 0; i < (sizeof(bands) / sizeof(bands[0])); ++i)
+    {
+        bands[i]->filter.z1 = 0.0f;
+        bands[i]->filter.z2 = 0.0f;
+        memset(bands[i]->ring, 0, sizeof(bands[i]->ring));
+        memset(bands[i]->bin_re, 0, sizeof(bands[i]->bin_re));
+        memset(bands[i]->bin_im, 0, sizeof(bands[i]->bin_im));
+    }
+
+    vital->primed = false;
+    vital->last_phase = 0.0f;
+    vital->unwrapped_phase = 0.0f;
+    vital->phase_sum = 0.0f;
+    vital->frame_count = 0;
+    vital->sample_count = 0;
+    vital->ring_idx = 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_vital_process
+ *******************************************************************************
+ * Summary:
+ *   Tracks the unwrapped phase of a range bin, averages it down to the
+ *   sample rate and feeds the band-pass filtered samples to the sliding DFT
+ *   of the breathing and the heart band. Each sample costs one update per
+ *   DFT bin instead of a transform of the whole window. Once per second the
+ *   rates are estimated from the strongest bin of each band.
+ *
+ * Parameters:
+ *   vital     : vital signs state
+ *   range_bin : range bin of the person, numbered like the target detection
+ *   geometry  : frame geometry
+ *   frame     : samples, chirp by chirp with the antennas interleaved
+ *   result    : rates, written when true is returned
+ *
+ * Return:
+ *   true if a result is due
+ ******************************************************************************/
+bool radar_vital_process(radar_vital_t *vital, uint16_t range_bin, const radar_geometry_t *geometry,
+                         const uint16_t *frame, radar_vital_result_t *result)
+{
+    float re, im;
+    float phase;
+    float delta;
+
+    radar_rd_range_bin(geometry, frame, 0, range_bin, &re, &im);
+    phase = atan2f(im, re);
+
+    if (!vital->primed)
+    {
+        vital->last_phase = phase;
+        vital->primed = true;
+    }
+
+    /* Unwrap, the phase moves by less than pi between frames */
+    delta = phase - vital->last_phase;
+    if (delta > VITAL_PI)
+    {
+        delta -= 2.0f * VITAL_PI;
+    }
+    else if (delta < -VITAL_PI)
+    {
+        delta += 2.0f * VITAL_PI;
+    }
+    vital->last_phase = phase;
+    vital->unwrapped_phase += delta;
+
+    vital->phase_sum += vital->unwrapped_phase;
+    if (++vital->frame_count < vital->frames_per_sample)
+    {
+        return false;
+    }
+
+    const float sample = vital->phase_sum / (float)vital->frames_per_sample;
+
+    vital->phase_sum = 0.0f;
+    vital->frame_count = 0;
+
+    band_update(&vital->breathing, sample, vital->ring_idx, vital->damping_window);
+    band_update(&vital->heart, sample, vital->ring_idx, vital->damping_window);
+    vital->ring_idx = (vital->ring_idx + 1u) % vital->window;
+    vital->sample_count++;
+
+    if ((vital->sample_count % vital->samples_per_report) != 0)
+    {
+        return false;
+    }
+
+    result->range_bin = range_bin;
+    result->breathing_rate = 0;
+    result->heart_rate = 0;
+    result->breathing_quality = 0;
+    result->heart_quality = 0;
+
+    if (vital->sample_count >= vital->window)
+    {
+        band_estimate(&vital->breathing, vital->sample_rate, vital->window,
+                      &result->breathing_rate, &result->breathing_quality);
+        band_estimate(&vital->heart, vital->sample_rate, vital->window,
+                      &result->heart_rate, &result->heart_quality);
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_vital_write_result
+ *******************************************************************************
+ * Summary:
+ *   Encodes a result, see RADAR_VITAL_RESULT_SIZE for the layout.
+ *
+ * Parameters:
+ *   data   : output, RADAR_VITAL_RESULT_SIZE bytes
+ *   result : rates to encode
+ *
+ * Return:
+ *   number of bytes written
+ ******************************************************************************/
+uint32_t radar_vital_write_result(uint8_t *data, const radar_vital_result_t *result)
+{
+    radar_frame_put_u16(&data[0], result->range_bin);
+    radar_frame_put_u16(&data[2], result->breathing_rate);
+    radar_frame_put_u16(&data[4], result->heart_rate);
+    radar_frame_put_u16(&data[6], result->breathing_quality);
+    radar_frame_put_u16(&data[8], result->heart_quality);
+
+    return RADAR_VITAL_RESULT_SIZE;
+}
+
+/* [] END OF FILE */
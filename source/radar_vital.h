@@ -0,0 +1,126 @@
+/******************************************************************************
+ * File Name:   radar_vital.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_vital.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_VITAL_H_
+#define RADAR_VITAL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "radar_frame.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* The phase is averaged down to about this rate before filtering */
+#define RADAR_VITAL_SAMPLE_RATE_HZ      (20.0f)
+
+/* Length of the sliding window the rates are estimated over */
+#define RADAR_VITAL_WINDOW_S            (20u)
+#define RADAR_VITAL_MAX_WINDOW          (RADAR_VITAL_WINDOW_S * 30u)
+
+/* Bands searched for the breathing and the heart rate */
+#define RADAR_VITAL_BREATHING_MIN_HZ    (0.1f)
+#define RADAR_VITAL_BREATHING_MAX_HZ    (0.6f)
+#define RADAR_VITAL_HEART_MIN_HZ        (0.8f)
+#define RADAR_VITAL_HEART_MAX_HZ        (2.0f)
+
+/* Sliding DFT bins per band, including one guard bin on each side. The bin
+ * of a frequency is frequency * RADAR_VITAL_WINDOW_S, so the highest bin is
+ * RADAR_VITAL_HEART_MAX_HZ * RADAR_VITAL_WINDOW_S = 40. */
+#define RADAR_VITAL_MAX_BINS            (43u)
+
+/* Result layout, all multi-byte fields are little endian:
+ *   [0..1]   range bin
+ *   [2..3]   breathing rate in 0.1 breaths per minute, 0 until the window is full
+ *   [4..5]   heart rate in 0.1 beats per minute, 0 until the window is full
+ *   [6..7]   breathing peak to band mean power ratio, Q8
+ *   [8..9]   heart peak to band mean power ratio, Q8 */
+#define RADAR_VITAL_RESULT_SIZE         (10)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    float b0, b2, a1, a2;       /* band-pass biquad, b1 is zero */
+    float z1, z2;
+} radar_vital_biquad_t;
+
+/* Band-pass filtered phase in a sliding window and its DFT bins around the
+ * band, updated by one sample at a time */
+typedef struct
+{
+    radar_vital_biquad_t filter;
+    float ring[RADAR_VITAL_MAX_WINDOW];
+    float twiddle_re[RADAR_VITAL_MAX_BINS];
+    float twiddle_im[RADAR_VITAL_MAX_BINS];
+    float bin_re[RADAR_VITAL_MAX_BINS];
+    float bin_im[RADAR_VITAL_MAX_BINS];
+    uint16_t first_bin;
+    uint16_t num_bins;
+} radar_vital_band_t;
+
+typedef struct
+{
+    uint16_t range_bin;
+    uint16_t breathing_rate;    /* 0.1 per minute */
+    uint16_t heart_rate;
+    uint16_t breathing_quality; /* Q8 */
+    uint16_t heart_quality;
+} radar_vital_result_t;
+
+typedef struct
+{
+    float sample_rate;          /* rate of the averaged phase */
+    uint32_t frames_per_sample;
+    uint32_t samples_per_report;
+    uint32_t window;            /* samples in the sliding window */
+    float damping_window;       /* damping ^ window */
+    radar_vital_band_t breathing;
+    radar_vital_band_t heart;
+    /* Running state */
+    bool primed;
+    float last_phase;
+    float unwrapped_phase;
+    float phase_sum;
+    uint32_t frame_count;
+    uint32_t sample_count;
+    uint32_t ring_idx;
+} radar_vital_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void radar_vital_init(radar_vital_t *vital, float frame_rate);
+void radar_vital_reset(radar_vital_t *vital);
+bool radar_vital_process(radar_vital_t *vital, uint16_t range_bin, const radar_geometry_t *geometry,
+                         const uint16_t *frame, radar_vital_result_t *result);
+uint32_t radar_vital_write_result(uint8_t *data, const radar_vital_result_t *result);
+
+#endif /* RADAR_VITAL_H_ */
+/* [] END OF FILE */
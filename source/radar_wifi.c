@@ -0,0 +1,434 @@
+/*****************************************************************************
+ * File name: radar_wifi.c
+ *
+ * Description: Wi-Fi outage handling of the frame stream: keeps the frames
+ * while the link is down, drains them at a paced rate once it is back, binds
+ * the sockets again if the AP assigned another address, and joins the AP
+ * again with a growing wait.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file for local module */
+#include "radar_wifi.h"
+
+/*******************************************************************************
+ * Function Name: is_due
+ *******************************************************************************
+ * Summary:
+ *   Checks whether a time has come, also across the wrap of the clock.
+ *
+ * Parameters:
+ *   now_ms : current time
+ *   due_ms : time to check
+ *
+ * Return:
+ *   true if due_ms is not in the future
+ ******************************************************************************/
+static bool is_due(uint32_t now_ms, uint32_t due_ms)
+{
+    return (uint32_t)(now_ms - due_ms) < 0x80000000u;
+}
+
+/*******************************************************************************
+ * Function Name: check_ms
+ *******************************************************************************
+ * Summary:
+ *   Length of a drain progress check: the time the whole backlog takes at
+ *   the drain rate. A backlog that did not shrink over it never drains.
+ *
+ * Parameters:
+ *   wifi : link state
+ *
+ * Return:
+ *   duration in milliseconds
+ ******************************************************************************/
+static uint32_t check_ms(const radar_wifi_t *wifi)
+{
+    return ((RADAR_WIFI_BACKLOG_DEPTH * 1000u) + wifi->rate - 1u) / wifi->rate;
+}
+
+/*******************************************************************************
+ * Function Name: radar_wifi_init
+ *******************************************************************************
+ * Summary:
+ *   Sets up the state of a link that is up, with an empty backlog.
+ *
+ * Parameters:
+ *   wifi         : link state
+ *   memory       : RADAR_WIFI_MEMORY_SIZE(max_datagram) bytes for the backlog
+ *   max_datagram : largest frame datagram
+ *   address      : IPv4 address the sockets are bound to
+ *   rebind       : binds the sockets to a new address
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_wifi_init(radar_wifi_t *wifi, uint8_t *memory, uint32_t max_datagram, uint32_t address,
+                     radar_wifi_rebind_t rebind)
+{
+    *wifi = (radar_wifi_t){
+        .state = RADAR_WIFI_UP,
+        .rebind = rebind,
+        .address = address,
+        .rate = RADAR_WIFI_DEFAULT_RATE
+    };
+    radar_resend_init(&wifi->backlog, memory, max_datagram, RADAR_WIFI_BACKLOG_DEPTH);
+}
+
+/*******************************************************************************
+ * Function Name: radar_wifi_rate_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks a drain rate of the backlog.
+ *
+ * Parameters:
+ *   rate : datagrams per second
+ *
+ * Return:
+ *   true if the rate is supported
+ ******************************************************************************/
+bool radar_wifi_rate_is_valid(uint16_t rate)
+{
+    return (rate >= 1u) && (rate <= RADAR_WIFI_MAX_RATE);
+}
+
+/*******************************************************************************
+ * Function Name: radar_wifi_event
+ *******************************************************************************
+ * Summary:
+ *   Notes an event of the connection manager: whether the link is up and
+ *   whether the AP assigned another IP address. Other events change
+ *   nothing.
+ *
+ * Parameters:
+ *   event           : connection manager event
+ *   connected       : the link is up, updated
+ *   address_changed : set for another IP address, cleared by the caller
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_wifi_event(cy_wcm_event_t event, bool *connected, bool *address_changed)
+{
+    switch (event)
+    {
+        case CY_WCM_EVENT_DISCONNECTED:
+        case CY_WCM_EVENT_INITIATED_RETRY:
+        {
+            *connected = false;
+            break;
+        }
+        case CY_WCM_EVENT_CONNECTED:
+        case CY_WCM_EVENT_RECONNECTED:
+        {
+            *connected = true;
+            break;
+        }
+        case CY_WCM_EVENT_IP_CHANGED:
+        {
+            *connected = true;
+            *address_changed = true;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_wifi_update
+ *******************************************************************************
+ * Summary:
+ *   Follows the link as reported by the connection manager. A lost link
+ *   keeps the frames. Once it is back, the sockets are bound to the address
+ *   of the kit first if the AP assigned another one; a failed rebind is
+ *   tried again after RADAR_WIFI_REBIND_RETRY_MS. The backlog is then
+ *   drained. If it did not shrink over a progress check, the drain rate does
+ *   not exceed the frame rate: the rest of the backlog is dropped and live
+ *   frames go out again.
+ *
+ * Parameters:
+ *   wifi            : link state
+ *   connected       : the link is up
+ *   address_changed : the connection manager reported another IP address
+ *   now_ms          : time in milliseconds
+ *
+ * Return:
+ *   milliseconds until the next call is due, RADAR_WIFI_IDLE if only a link
+ *   change needs one
+ ******************************************************************************/
+uint32_t radar_wifi_update(radar_wifi_t *wifi, bool connected, bool address_changed, uint32_t now_ms)
+{
+    cy_wcm_ip_address_t ip_address;
+    uint32_t wait_ms = RADAR_WIFI_IDLE;
+
+    if (!connected)
+    {
+        if (wifi->state != RADAR_WIFI_DOWN)
+        {
+            wifi->state = RADAR_WIFI_DOWN;
+            wifi->disconnects++;
+        }
+        return RADAR_WIFI_IDLE;
+    }
+
+    /* The sockets stay bound to the address of the kit, frames are kept
+     * until they are bound to a new one */
+    if (((wifi->state == RADAR_WIFI_DOWN) || address_changed) &&
+        (cy_wcm_get_ip_addr(CY_WCM_INTERFACE_TYPE_STA, &ip_address) == CY_RSLT_SUCCESS) &&
+        (ip_address.ip.v4 != wifi->address))
+    {
+        if (!wifi->rebind_pending)
+        {
+            wifi->rebind_pending = true;
+            wifi->rebind_ms = now_ms;
+        }
+        wifi->new_address = ip_address.ip.v4;
+        if (wifi->state != RADAR_WIFI_DOWN)
+        {
+            wifi->state = RADAR_WIFI_DOWN;
+            wifi->disconnects++;
+        }
+    }
+
+    if (wifi->rebind_pending && is_due(now_ms, wifi->rebind_ms))
+    {
+        if (wifi->rebind(wifi->new_address))
+        {
+            wifi->address = wifi->new_address;
+            wifi->rebind_pending = false;
+        }
+        else
+        {
+            wifi->rebind_ms = now_ms + RADAR_WIFI_REBIND_RETRY_MS;
+        }
+    }
+    if (wifi->rebind_pending)
+    {
+        return wifi->rebind_ms - now_ms;
+    }
+
+    if (wifi->state == RADAR_WIFI_DOWN)
+    {
+        wifi->state = RADAR_WIFI_DRAINING;
+        wifi->credit = RADAR_WIFI_CREDIT_UNIT;
+        wifi->credit_ms = now_ms;
+        wifi->check_ms = now_ms;
+        wifi->check_backlog = wifi->backlog.num_requested;
+    }
+
+    if ((wifi->state == RADAR_WIFI_DRAINING) && (wifi->backlog.num_requested != 0) &&
+        is_due(now_ms, wifi->check_ms + check_ms(wifi)))
+    {
+        if (wifi->backlog.num_requested >= wifi->check_backlog)
+        {
+            wifi->dropped += wifi->backlog.num_requested;
+            radar_resend_set_depth(&wifi->backlog, RADAR_WIFI_BACKLOG_DEPTH);
+        }
+        wifi->check_ms = now_ms;
+        wifi->check_backlog = wifi->backlog.num_requested;
+    }
+
+    if (wifi->state == RADAR_WIFI_DRAINING)
+    {
+        if (wifi->backlog.num_requested == 0)
+        {
+            wifi->state = RADAR_WIFI_UP;
+        }
+        else
+        {
+            wait_ms = (wifi->check_ms + check_ms(wifi)) - now_ms;
+        }
+    }
+
+    return wait_ms;
+}
+
+/*******************************************************************************
+ * Function Name: radar_wifi_keep
+ *******************************************************************************
+ * Summary:
+ *   Keeps a frame datagram behind the frames kept before, while the link is
+ *   down or the backlog drains. Once the backlog is full the oldest frame is
+ *   dropped.
+ *
+ * Parameters:
+ *   wifi     : link state
+ *   datagram : frame datagram, starting with the frame header
+ *   length   : size of the datagram
+ *
+ * Return:
+ *   true if the datagram is kept
+ ******************************************************************************/
+bool radar_wifi_keep(radar_wifi_t *wifi, const uint8_t *datagram, uint32_t length)
+{
+    const uint32_t num_kept = wifi->backlog.num_requested;
+
+    if (!radar_resend_keep(&wifi->backlog, datagram, length))
+    {
+        return false;
+    }
+
+    wifi->kept++;
+    if (wifi->backlog.num_requested == num_kept)
+    {
+        wifi->dropped++;
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_wifi_drain_wait
+ *******************************************************************************
+ * Summary:
+ *   Adds the drain credit earned since the last call and returns how long
+ *   the next kept frame has to wait for it.
+ *
+ * Parameters:
+ *   wifi   : link state
+ *   now_ms : time in milliseconds
+ *
+ * Return:
+ *   milliseconds until the next kept frame can be sent, RADAR_WIFI_IDLE if
+ *   the backlog is not draining
+ ******************************************************************************/
+uint32_t radar_wifi_drain_wait(radar_wifi_t *wifi, uint32_t now_ms)
+{
+    const uint32_t elapsed_ms = now_ms - wifi->credit_ms;
+    const uint32_t max_credit = RADAR_WIFI_MAX_CREDIT(wifi->rate);
+
+    wifi->credit_ms = now_ms;
+    if (elapsed_ms >= (max_credit / wifi->rate))
+    {
+        wifi->credit = max_credit;
+    }
+    else
+    {
+        wifi->credit += elapsed_ms * wifi->rate;
+        if (wifi->credit > max_credit)
+        {
+            wifi->credit = max_credit;
+        }
+    }
+
+    if ((wifi->state != RADAR_WIFI_DRAINING) || (wifi->backlog.num_requested == 0))
+    {
+        return RADAR_WIFI_IDLE;
+    }
+    if (wifi->credit >= RADAR_WIFI_CREDIT_UNIT)
+    {
+        return 0;
+    }
+
+    return ((RADAR_WIFI_CREDIT_UNIT - wifi->credit) + wifi->rate - 1u) / wifi->rate;
+}
+
+/*******************************************************************************
+ * Function Name: radar_wifi_drain_next
+ *******************************************************************************
+ * Summary:
+ *   Takes the oldest kept frame if the drain credit allows it. The datagram
+ *   stays valid until the next frame is kept.
+ *
+ * Parameters:
+ *   wifi     : link state
+ *   datagram : output, the kept datagram
+ *
+ * Return:
+ *   size of the datagram, 0 if none can be sent now
+ ******************************************************************************/
+uint32_t radar_wifi_drain_next(radar_wifi_t *wifi, const uint8_t **datagram)
+{
+    uint32_t length;
+
+    if ((wifi->state != RADAR_WIFI_DRAINING) || (wifi->credit < RADAR_WIFI_CREDIT_UNIT))
+    {
+        return 0;
+    }
+
+    length = radar_resend_next(&wifi->backlog, datagram);
+    if (length != 0)
+    {
+        wifi->credit -= RADAR_WIFI_CREDIT_UNIT;
+    }
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: radar_wifi_join_start
+ *******************************************************************************
+ * Summary:
+ *   Starts the joins after the link was lost. The connection manager gets
+ *   the first wait to rejoin the AP by itself.
+ *
+ * Parameters:
+ *   join        : join attempts
+ *   min_wait_ms : wait before the first attempt
+ *   max_wait_ms : longest wait between two attempts
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_wifi_join_start(radar_wifi_join_t *join, uint32_t min_wait_ms, uint32_t max_wait_ms)
+{
+    join->wait_ms = min_wait_ms;
+    join->max_wait_ms = max_wait_ms;
+    join->attempts = 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_wifi_join_attempt
+ *******************************************************************************
+ * Summary:
+ *   Joins the AP once, unless the connection manager rejoined it meanwhile.
+ *   The call blocks for the join. After a failed attempt the wait before the
+ *   next one doubles up to the longest wait.
+ *
+ * Parameters:
+ *   join   : join attempts
+ *   params : AP credentials
+ *
+ * Return:
+ *   true if the link is up
+ ******************************************************************************/
+bool radar_wifi_join_attempt(radar_wifi_join_t *join, cy_wcm_connect_params_t *params)
+{
+    cy_wcm_ip_address_t ip_address;
+
+    if (cy_wcm_is_connected_to_ap())
+    {
+        return true;
+    }
+
+    join->attempts++;
+    if (cy_wcm_connect_ap(params, &ip_address) == CY_RSLT_SUCCESS)
+    {
+        return true;
+    }
+
+    join->wait_ms = ((2u * join->wait_ms) < join->max_wait_ms) ? (2u * join->wait_ms) : join->max_wait_ms;
+    return false;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,116 @@
+/******************************************************************************
+ * File Name:   radar_wifi.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_wifi.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_WIFI_H_
+#define RADAR_WIFI_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cy_wcm.h"
+
+#include "radar_resend.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* States of the Wi-Fi link: while it is down the frames are kept in the
+ * backlog, once it is back they are drained at the backlog rate before live
+ * frames go out again */
+#define RADAR_WIFI_UP                   (0u)
+#define RADAR_WIFI_DOWN                 (1u)
+#define RADAR_WIFI_DRAINING             (2u)
+
+/* Frames kept while the link is down, the oldest are dropped beyond */
+#define RADAR_WIFI_BACKLOG_DEPTH        (RADAR_RESEND_MAX_DEPTH)
+#define RADAR_WIFI_MEMORY_SIZE(max_datagram) (RADAR_WIFI_BACKLOG_DEPTH * (max_datagram))
+
+/* Drain rate of the backlog in datagrams per second. The credit earns the
+ * rate per millisecond, a datagram costs a unit and at most a tenth of a
+ * second of datagrams can be saved up. */
+#define RADAR_WIFI_DEFAULT_RATE         (500u)
+#define RADAR_WIFI_MAX_RATE             (1000u)
+#define RADAR_WIFI_CREDIT_UNIT          (1000u)
+#define RADAR_WIFI_MAX_CREDIT(rate)     (((rate) * 100u) > RADAR_WIFI_CREDIT_UNIT ? ((rate) * 100u) : \
+                                         RADAR_WIFI_CREDIT_UNIT)
+
+/* Wait before binding the sockets to a new address is tried again */
+#define RADAR_WIFI_REBIND_RETRY_MS      (1000u)
+
+/* Returned as wait if nothing is due until the link changes */
+#define RADAR_WIFI_IDLE                 (UINT32_MAX)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Binds the sockets to the new IP address of the kit, true on success */
+typedef bool (*radar_wifi_rebind_t)(uint32_t address);
+
+/* Joins of the AP after the link was lost, made by a task of their own */
+typedef struct
+{
+    uint32_t wait_ms;           /* before the next attempt */
+    uint32_t max_wait_ms;
+    uint32_t attempts;
+} radar_wifi_join_t;
+
+/* Link state of the sending task */
+typedef struct
+{
+    uint8_t state;              /* RADAR_WIFI_* */
+    radar_resend_t backlog;     /* every kept frame is marked for sending */
+    radar_wifi_rebind_t rebind;
+    uint32_t address;           /* IPv4 address the sockets are bound to */
+    uint32_t new_address;
+    bool rebind_pending;
+    uint32_t rebind_ms;         /* time of the next rebind attempt */
+    uint16_t rate;              /* drained datagrams per second */
+    uint32_t credit;            /* RADAR_WIFI_CREDIT_UNIT per drained datagram */
+    uint32_t credit_ms;
+    uint32_t check_ms;          /* start of the drain progress check */
+    uint32_t check_backlog;     /* frames kept at the start of the check */
+    uint32_t disconnects;
+    uint32_t kept;
+    uint32_t dropped;           /* kept frames overwritten or given up */
+} radar_wifi_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void radar_wifi_init(radar_wifi_t *wifi, uint8_t *memory, uint32_t max_datagram, uint32_t address,
+                     radar_wifi_rebind_t rebind);
+bool radar_wifi_rate_is_valid(uint16_t rate);
+void radar_wifi_event(cy_wcm_event_t event, bool *connected, bool *address_changed);
+uint32_t radar_wifi_update(radar_wifi_t *wifi, bool connected, bool address_changed, uint32_t now_ms);
+bool radar_wifi_keep(radar_wifi_t *wifi, const uint8_t *datagram, uint32_t length);
+uint32_t radar_wifi_drain_wait(radar_wifi_t *wifi, uint32_t now_ms);
+uint32_t radar_wifi_drain_next(radar_wifi_t *wifi, const uint8_t **datagram);
+void radar_wifi_join_start(radar_wifi_join_t *join, uint32_t min_wait_ms, uint32_t max_wait_ms);
+bool radar_wifi_join_attempt(radar_wifi_join_t *join, cy_wcm_connect_params_t *params);
+
+#endif /* RADAR_WIFI_H_ */
+/* [] END OF FILE */
@@ -51,23 +51,90 @@
 
 /* UDP server task header file. */
 #include "udp_server.h"
+#include "radar_aead.h"
+#include "radar_clock.h"
+#include "radar_fec.h"
+#include "radar_frame.h"
+#include "radar_link.h"
+#include "radar_resend.h"
+#include "radar_stream.h"
+#include "radar_sync.h"
 #include "radar_task.h"
+#include "radar_wifi.h"
 
 #include "wifi_config.h"
 
+/* Memory plan, bounds the size of a frame datagram */
+#include "radar_memory.h"
+
 /*******************************************************************************
 * Macros
 ********************************************************************************/
 /* RTOS related macros for UDP server task. */
 #define RTOS_TASK_TICKS_TO_WAIT                   (1000)
 
-#define TASK_QUEUE_LENGTH     (3u)
+/* Largest datagram carrying a frame */
+#define MAX_FRAME_DATAGRAM_SIZE   (RADAR_MEMORY_MAX_FRAME_DATAGRAM)
+
+/* Retransmission requests of the client waiting for the UDP server task */
+#define MAX_PENDING_NACKS         (4u)
+
+/* Retransmission credit of one datagram and the largest credit, 100 ms of
+ * the budget but at least one datagram */
+#define RESEND_CREDIT_UNIT        (1000u)
+#define RESEND_MAX_CREDIT(budget) (((budget) * 100u) > RESEND_CREDIT_UNIT ? ((budget) * 100u) : RESEND_CREDIT_UNIT)
+
+/* TCP stream: every frame datagram prefixed with its size. Frames are
+ * collected until a full segment is ready or the oldest one waited
+ * TCP_FLUSH_MS, then written at once. */
+#define TCP_SEGMENT_SIZE          (RADAR_MEMORY_TCP_SEGMENT_SIZE)
+#define TCP_BUFFER_SIZE           (RADAR_MEMORY_TCP_BUFFER_SIZE)
+#define TCP_FLUSH_MS              (10u)
+#define TCP_SEND_TIMEOUT_MS       (1000u)
+
+/* Link test datagrams sent per pass of the UDP server task, a sender behind
+ * its schedule still serves the queue in between */
+#define LINK_MAX_SEND             (RADAR_LINK_MAX_BATCH)
+
+/* Retry of a request to the configuration task that found its queue full */
+#define CONFIG_RETRY_MS           (10u)
 /*******************************************************************************
 * Function Prototypes
 ********************************************************************************/
 static cy_rslt_t connect_to_wifi_ap(void);
 static cy_rslt_t create_udp_server_socket(void);
+static cy_rslt_t create_tcp_server_socket(void);
 static cy_rslt_t udp_server_recv_handler(cy_socket_t socket_handle, void *arg);
+static cy_rslt_t tcp_server_connect_handler(cy_socket_t socket_handle, void *arg);
+static cy_rslt_t tcp_server_disconnect_handler(cy_socket_t socket_handle, void *arg);
+static void send_sync_request(void);
+static bool send_datagram(const cy_socket_sockaddr_t *addr, const uint8_t *data, uint32_t length);
+static bool send_to_client(const uint8_t *data, uint32_t length);
+static bool send_frame_datagram(const uint8_t *data, uint32_t length);
+static void apply_multicast(const udp_server_multicast_t *config);
+static TickType_t check_lease(void);
+static void wifi_event_callback(cy_wcm_event_t event, cy_wcm_event_data_t *event_data);
+static void set_wifi_connected(bool connected, bool address_changed);
+static TickType_t check_wifi(void);
+static void wifi_join_task(void *arg);
+static bool rebind_sockets(uint32_t address);
+static void keep_frame(publisher_data_t *msg);
+static TickType_t backlog_wait(void);
+static void send_backlog(void);
+static void new_salt(void);
+static bool seal_frame(publisher_data_t *msg);
+static void send_udp_frame(publisher_data_t *msg);
+static void send_frame(const uint8_t *data, uint32_t length);
+static void queue_tcp_frame(const publisher_data_t *msg);
+static void flush_tcp_frames(void);
+static void close_tcp_client(void);
+static void send_fec_parity(const uint8_t *data, uint32_t length);
+static void take_nack_requests(void);
+static TickType_t resend_wait(void);
+static void send_resend(void);
+static TickType_t run_link_test(void);
+static bool send_link_datagram(uint32_t length);
+static void send_link_report(void);
 
 /*******************************************************************************
 * Global Variables
@@ -83,110 +150,1940 @@ char udp_msg_payload[MAX_UDP_RECV_BUFFER_SIZE];
 
 char *sub_msg = udp_msg_payload;
 
-/* Handle of the queue holding the commands for the subscriber task */
-QueueHandle_t radar_data_queue;
-QueueHandle_t radar_config_queue;
+/* Handle of the queue holding the commands for the subscriber task */
+QueueHandle_t radar_data_queue;
+QueueHandle_t radar_config_queue;
+
+/* Time exchange with the client, 0 ms interval disables it */
+static radar_sync_t clock_sync;
+static uint32_t sync_interval_ms = 0;
+static uint8_t sync_request[RADAR_SYNC_REQUEST_SIZE];
+
+/* Parity over the frame datagrams, settings from the configuration task are
+ * taken over before the next datagram */
+static radar_fec_t fec;
+static uint8_t fec_memory[RADAR_FEC_MEMORY_SIZE(MAX_FRAME_DATAGRAM_SIZE)];
+static radar_fec_config_t fec_config = {
+    .group_size = 0,
+    .parity_count = RADAR_FEC_DEFAULT_PARITY
+};
+static bool fec_config_changed = false;
+
+/* Encryption of the frame datagrams with the pre-shared key, used by the UDP
+ * server task only */
+static radar_aead_t aead;
+
+/* Sequence number of the next frame datagram, lets the client tell a lost
+ * datagram from a frame that was not sent */
+static uint8_t frame_sequence = 0;
+
+/* Sent frame datagrams kept for retransmission, owned by the UDP server
+ * task. Requests arrive in the receive callback and are handed over in
+ * nack_pending; nack_msg wakes up the task. */
+static radar_resend_t resend;
+static uint8_t resend_memory[RADAR_RESEND_MEMORY_SIZE(MAX_FRAME_DATAGRAM_SIZE)];
+static radar_resend_config_t resend_config = {
+    .depth = 0,
+    .budget = RADAR_RESEND_DEFAULT_BUDGET
+};
+static bool resend_config_changed = false;
+static uint16_t resend_budget = RADAR_RESEND_DEFAULT_BUDGET;
+static uint32_t resend_credit = 0;
+static TickType_t resend_credit_time = 0;
+
+static uint8_t nack_pending[MAX_PENDING_NACKS][RADAR_RESEND_NACK_MAX_SIZE];
+static uint8_t nack_pending_length[MAX_PENDING_NACKS];
+static uint32_t num_nack_pending = 0;
+static publisher_data_t nack_msg = {
+    .cmd = RADAR_NACK_COMMAND,
+    .length = 0,
+    .data = NULL
+};
+static publisher_data_t *nack_msg_ptr = &nack_msg;
+
+/* Transport of the frame datagrams. The TCP client is accepted and closed
+ * in the socket callbacks and used by the UDP server task. */
+static uint8_t transport_mode = UDP_SERVER_TRANSPORT_UDP;
+static udp_server_transport_stats_t transport_stats;
+static cy_socket_t tcp_server_socket;
+static cy_socket_t tcp_client_socket = NULL;
+static bool tcp_client_closed = false;
+static uint8_t tcp_buffer[TCP_BUFFER_SIZE];
+static radar_stream_t tcp_stream;
+static TickType_t tcp_buffer_time = 0;
+
+/* Bytes of a TCP write the link has not taken yet, read by the radar task in
+ * a critical section to skip frames while the stream backs up */
+static uint32_t tcp_fill = 0;
+
+/* Link capacity test, synthetic datagrams paced by the UDP server task.
+ * Runs are requested by the config task in link_request; link_msg wakes up
+ * the task. The report of a run reuses the datagram buffer. */
+static radar_link_t link;
+static uint8_t link_buffer[RADAR_LINK_MAX_SIZE];
+static radar_link_config_t link_request;
+static bool link_start_requested = false;
+static bool link_stop_requested = false;
+static bool link_report_pending = false;
+static bool link_wake_pending = false;
+static publisher_data_t link_msg = {
+    .cmd = RADAR_LINK_COMMAND,
+    .length = 0,
+    .data = NULL
+};
+static publisher_data_t *link_msg_ptr = &link_msg;
+
+/* Multicast stream of the frame datagrams. Settings from the configuration
+ * task are taken over by the UDP server task, which owns multicast_addr. */
+static udp_server_multicast_t multicast_config = {
+    .enabled = false,
+    .group = 0,
+    .port = UDP_SERVER_MULTICAST_PORT,
+    .ttl = UDP_SERVER_MULTICAST_TTL
+};
+static bool multicast_config_changed = false;
+static bool multicast_enabled = false;
+static cy_socket_sockaddr_t multicast_addr;
+
+/* Client lease. The receive callback notes when the client was last heard
+ * from; the UDP server task suspends the frames once the lease expired and
+ * has the configuration task stop and restart the sensor if requested.
+ * lease_msg wakes up the task when a suspended client is heard again. */
+static udp_server_lease_t lease_config = {
+    .duration_ms = 0,
+    .stop_radar = false
+};
+static TickType_t lease_heard = 0;
+static bool lease_expired = false;
+static bool lease_wake_pending = false;
+static bool lease_radar_stopped = false;
+static publisher_data_t lease_msg = {
+    .cmd = RADAR_KEEPALIVE_COMMAND,
+    .length = 0,
+    .data = NULL
+};
+static publisher_data_t *lease_msg_ptr = &lease_msg;
+
+char udp_server_lease_expired[] = "client lease expired";
+char udp_server_lease_renewed[] = "client lease renewed";
+
+/* Wi-Fi link. The connection manager callback notes whether the link is up
+ * or got another IP address and wifi_msg wakes up the UDP server task, which
+ * owns the link state and keeps the frames while the link is down. The
+ * blocking joins of the AP are left to the Wi-Fi join task, which reports
+ * back through set_wifi_connected(), so the UDP server task keeps taking
+ * frames throughout the outage. */
+static cy_wcm_connect_params_t wifi_conn_param;
+static bool wifi_connected = true;
+static bool wifi_address_changed = false;
+static bool wifi_wake_pending = false;
+static bool wifi_joining = false;
+static radar_wifi_t wifi;
+static uint8_t wifi_memory[RADAR_WIFI_MEMORY_SIZE(MAX_FRAME_DATAGRAM_SIZE)];
+static uint16_t backlog_rate = RADAR_WIFI_DEFAULT_RATE;
+static TaskHandle_t wifi_join_task_handle;
+static publisher_data_t wifi_msg = {
+    .cmd = RADAR_WIFI_COMMAND,
+    .length = 0,
+    .data = NULL
+};
+static publisher_data_t *wifi_msg_ptr = &wifi_msg;
+
+/*******************************************************************************
+ * Function Name: udp_server_task
+ *******************************************************************************
+ * Summary:
+ *  Task used to establish a connection to a remote UDP client.
+ *
+ * Parameters:
+ *  void *args : Task parameter defined during task creation (unused)
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void udp_server_task(void *arg)
+{
+    cy_rslt_t result;
+
+    publisher_data_t *msg;
+
+    /* Tick count the next time exchange is due at */
+    TickType_t next_sync = 0;
+
+    /* Initialize semaphore to protect payload */
+    sem_udp_payload = xSemaphoreCreateMutexStatic(&sem_udp_payload_buffer);
+    if (sem_udp_payload == NULL)
+    {
+        printf(" 'sem_udp_payload' semaphore creation failed... Task suspend\n\n");
+        CY_ASSERT(0);
+    }
+
+    radar_fec_init(&fec, fec_memory, MAX_FRAME_DATAGRAM_SIZE, &fec_config);
+    radar_resend_init(&resend, resend_memory, MAX_FRAME_DATAGRAM_SIZE, resend_config.depth);
+    radar_link_init(&link);
+    radar_stream_init(&tcp_stream, tcp_buffer, TCP_SEGMENT_SIZE, MAX_FRAME_DATAGRAM_SIZE);
+
+    if (!radar_aead_init(&aead, RADAR_AEAD_KEY))
+    {
+        printf("RADAR_AEAD_KEY has to be %u hex digits\n", 2u * RADAR_AEAD_KEY_SIZE);
+        CY_ASSERT(0);
+    }
+    if (aead.enabled)
+    {
+        new_salt();
+        printf("Frame datagrams are encrypted\n");
+    }
+
+    /* Device clock for frame timestamps and the time exchange */
+    radar_sync_init(&clock_sync);
+    if (radar_clock_init() != CY_RSLT_SUCCESS)
+    {
+        printf("Device clock initialization failed!\n");
+        CY_ASSERT(0);
+    }
+
+    /* Connect to Wi-Fi AP */
+    if(connect_to_wifi_ap() != CY_RSLT_SUCCESS )
+    {
+        printf("\n Failed to connect to Wi-Fi AP.\n");
+        CY_ASSERT(0);
+    }
+
+    /* Secure Sockets initialization */
+    result = cy_socket_init();
+    if (result != CY_RSLT_SUCCESS)
+    {
+        printf("Secure Sockets initialization failed!\n");
+        CY_ASSERT(0);
+    }
+
+    /* Create UDP Server*/
+    result = create_udp_server_socket();
+    if (result != CY_RSLT_SUCCESS)
+    {
+        printf("UDP Server Socket creation failed. Error: %"PRIu32"\n", result);
+        CY_ASSERT(0);
+    }
+
+    /* Create TCP Server for the streaming transport */
+    result = create_tcp_server_socket();
+    if (result != CY_RSLT_SUCCESS)
+    {
+        printf("TCP Server Socket creation failed. Error: %"PRIu32"\n", result);
+        CY_ASSERT(0);
+    }
+
+    /* The sockets are bound to the address of the first join */
+    radar_wifi_init(&wifi, wifi_memory, MAX_FRAME_DATAGRAM_SIZE, udp_server_addr.ip_address.ip.v4, rebind_sockets);
+
+    /* Create a message queue to communicate with other tasks and callbacks. */
+    radar_data_queue = xQueueCreateStatic(RADAR_MEMORY_DATA_QUEUE_LENGTH, sizeof(publisher_data_t *),
+                                          radar_data_queue_storage, &radar_data_queue_buffer);
+    if (radar_data_queue == NULL)
+    {
+        printf(" 'udp_server_task' queue creation failed... Task suspended\n\n");
+        CY_ASSERT(0);
+    }
+
+    radar_config_queue = xQueueCreateStatic(RADAR_MEMORY_CONFIG_QUEUE_LENGTH, sizeof(char *),
+                                            radar_config_queue_storage, &radar_config_queue_buffer);
+    if (radar_config_queue == NULL)
+    {
+        printf(" 'radar_config_queue' queue creation failed... Task suspended\n\n");
+        CY_ASSERT(0);
+    }
+
+    /* Link changes are reported once both queues exist */
+    result = cy_wcm_register_event_callback(wifi_event_callback);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        printf("Wi-Fi event callback registration failed. Error: %"PRIu32"\n", result);
+        CY_ASSERT(0);
+    }
+
+    wifi_join_task_handle = xTaskCreateStatic(wifi_join_task, "wifi_join_task", UDP_SERVER_WIFI_TASK_STACK_SIZE,
+                                              NULL, UDP_SERVER_WIFI_TASK_PRIORITY, wifi_join_task_stack,
+                                              &wifi_join_task_buffer);
+    if (wifi_join_task_handle == NULL)
+    {
+        printf("Failed to create Wi-Fi join task!\n");
+        CY_ASSERT(0);
+    }
+
+    radar_task_handle = xTaskCreateStatic(radar_task, "radar_task", RADAR_TASK_STACK_SIZE, NULL, RADAR_TASK_PRIORITY,
+                                          radar_task_stack, &radar_task_buffer);
+    if (radar_task_handle == NULL)
+    {
+        printf("Failed to create radar data task!\n");
+        CY_ASSERT(0);
+    }
+
+    while(true)
+    {
+        TickType_t wait = portMAX_DELAY;
+        TickType_t resend_ticks;
+        TickType_t link_ticks;
+        TickType_t lease_ticks;
+        TickType_t wifi_ticks;
+        TickType_t backlog_ticks;
+        uint32_t interval_ms;
+        bool resend_changed;
+        bool multicast_changed;
+        bool tcp_closed;
+        radar_resend_config_t resend_settings;
+        udp_server_multicast_t multicast_settings;
+
+        taskENTER_CRITICAL();
+        interval_ms = sync_interval_ms;
+        resend_changed = resend_config_changed;
+        resend_settings = resend_config;
+        resend_config_changed = false;
+        multicast_changed = multicast_config_changed;
+        multicast_settings = multicast_config;
+        multicast_config_changed = false;
+        tcp_closed = tcp_client_closed;
+        taskEXIT_CRITICAL();
+
+        if (tcp_closed)
+        {
+            close_tcp_client();
+        }
+
+        if (resend_changed)
+        {
+            radar_resend_set_depth(&resend, resend_settings.depth);
+            resend_budget = resend_settings.budget;
+        }
+        if (multicast_changed)
+        {
+            apply_multicast(&multicast_settings);
+        }
+        take_nack_requests();
+
+        wifi_ticks = check_wifi();
+        if (wifi_ticks < wait)
+        {
+            wait = wifi_ticks;
+        }
+
+        lease_ticks = check_lease();
+        if (lease_ticks < wait)
+        {
+            wait = lease_ticks;
+        }
+
+        /* Exchange times with the client once it is known, alive and reachable */
+        if ((interval_ms != 0) && (peer_addr.port != 0) && !lease_expired && (wifi.state != RADAR_WIFI_DOWN))
+        {
+            const TickType_t now = xTaskGetTickCount();
+
+            if ((TickType_t)(now - next_sync) < (TickType_t)(portMAX_DELAY / 2))
+            {
+                send_sync_request();
+                next_sync = now + pdMS_TO_TICKS(interval_ms);
+            }
+            if ((TickType_t)(next_sync - now) < wait)
+            {
+                wait = next_sync - now;
+            }
+        }
+
+        /* Retransmissions and the frames kept during a Wi-Fi outage only go
+         * out while no live data is waiting */
+        resend_ticks = resend_wait();
+        if (resend_ticks < wait)
+        {
+            wait = resend_ticks;
+        }
+        backlog_ticks = backlog_wait();
+        if (backlog_ticks < wait)
+        {
+            wait = backlog_ticks;
+        }
+
+        /* Link test datagrams due by now, then the wait for the next burst */
+        link_ticks = run_link_test();
+        if (link_ticks < wait)
+        {
+            wait = link_ticks;
+        }
+
+        /* Collected TCP frames go out at the latest TCP_FLUSH_MS after the first */
+        if (tcp_stream.length != 0)
+        {
+            const TickType_t waited = xTaskGetTickCount() - tcp_buffer_time;
+
+            if (waited >= pdMS_TO_TICKS(TCP_FLUSH_MS))
+            {
+                flush_tcp_frames();
+            }
+            else if ((pdMS_TO_TICKS(TCP_FLUSH_MS) - waited) < wait)
+            {
+                wait = pdMS_TO_TICKS(TCP_FLUSH_MS) - waited;
+            }
+        }
+
+        if (pdTRUE !=  xQueueReceive( radar_data_queue, &msg, wait ))
+        {
+            send_backlog();
+            send_resend();
+        }
+        else
+        {
+            /* A mailbox notification stands for the newest frame at this time */
+            if (msg->cmd == RADAR_LATEST_COMMAND)
+            {
+                msg = radar_take_latest_frame();
+                if (msg == NULL)
+                {
+                    continue;
+                }
+            }
+
+            switch(msg->cmd)
+            {
+                case RADAR_DATA_COMMAND:
+                case RADAR_TARGETS_COMMAND:
+                case RADAR_VITAL_COMMAND:
+                case RADAR_SPECTRO_COMMAND:
+                case RADAR_TRACKS_COMMAND:
+                {
+                    uint8_t mode;
+
+                    taskENTER_CRITICAL();
+                    mode = transport_mode;
+                    taskEXIT_CRITICAL();
+
+                    if (lease_expired)
+                    {
+                        /* Nobody is listening, the frame is not worth the airtime */
+                        radar_release_frame(msg);
+                        taskENTER_CRITICAL();
+                        transport_stats.frames_dropped++;
+                        taskEXIT_CRITICAL();
+                        break;
+                    }
+
+                    msg->data[RADAR_FRAME_HDR_SEQUENCE] = frame_sequence++;
+                    if (!seal_frame(msg))
+                    {
+                        radar_release_frame(msg);
+                        taskENTER_CRITICAL();
+                        transport_stats.frames_dropped++;
+                        taskEXIT_CRITICAL();
+                    }
+                    else if (mode == UDP_SERVER_TRANSPORT_TCP)
+                    {
+                        queue_tcp_frame(msg);
+                    }
+                    else if (wifi.state != RADAR_WIFI_UP)
+                    {
+                        /* Behind the backlog, live frames would overtake it */
+                        keep_frame(msg);
+                    }
+                    else
+                    {
+                        send_udp_frame(msg);
+                    }
+                    break;
+                }
+                case RADAR_STATS_COMMAND:
+                case RADAR_BENCH_COMMAND:
+                case RADAR_TEST_COMMAND:
+                {
+                    /* A reply is lost with the link, the client asks again */
+                    if (wifi.state != RADAR_WIFI_DOWN)
+                    {
+                        send_to_client(msg->data, msg->length);
+                    }
+                    break;
+                }
+                case RADAR_NACK_COMMAND:
+                {
+                    /* Only wakes up the task, the requests are taken above */
+                    break;
+                }
+                case RADAR_LINK_COMMAND:
+                {
+                    /* Only wakes up the task, the run is started above */
+                    break;
+                }
+                case RADAR_KEEPALIVE_COMMAND:
+                {
+                    /* Only wakes up the task, the lease is renewed above */
+                    break;
+                }
+                case RADAR_WIFI_COMMAND:
+                {
+                    /* Only wakes up the task, the link change is taken above */
+                    break;
+                }
+            }
+        }
+      }
+ }
+
+/*******************************************************************************
+ * Function Name: new_salt
+ *******************************************************************************
+ * Summary:
+ *  Starts an encryption session with a salt from the hardware random number
+ *  generator.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void new_salt(void)
+{
+    cyhal_trng_t trng;
+    uint8_t salt[RADAR_AEAD_SALT_SIZE];
+
+    if (cyhal_trng_init(&trng) != CY_RSLT_SUCCESS)
+    {
+        printf("Random number generator initialization failed!\n");
+        CY_ASSERT(0);
+    }
+    for (uint32_t i = 0; i < RADAR_AEAD_SALT_SIZE; i += sizeof(uint32_t))
+    {
+        radar_frame_put_u32(&salt[i], cyhal_trng_generate(&trng));
+    }
+    cyhal_trng_free(&trng);
+
+    radar_aead_set_salt(&aead, salt);
+}
+
+/*******************************************************************************
+ * Function Name: seal_frame
+ *******************************************************************************
+ * Summary:
+ *  Encrypts a frame datagram in place if a key is set. Parity and
+ *  retransmission work on the sealed datagram. Once the frame numbers wrap
+ *  around, a new salt keeps the nonces unique.
+ *
+ * Parameters:
+ *  msg : frame message from the radar task, its length is updated
+ *
+ * Return:
+ *  true if the datagram can be sent
+ *
+ *******************************************************************************/
+static bool seal_frame(publisher_data_t *msg)
+{
+    uint32_t length;
+
+    if (!aead.enabled)
+    {
+        return true;
+    }
+
+    length = radar_aead_seal(&aead, msg->data, msg->length);
+    if (length == 0)
+    {
+        new_salt();
+        length = radar_aead_seal(&aead, msg->data, msg->length);
+    }
+    if (length == 0)
+    {
+        return false;
+    }
+
+    msg->length = length;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: send_udp_frame
+ *******************************************************************************
+ * Summary:
+ *  Sends a frame datagram to the UDP client, adds it to the parity and keeps
+ *  it for retransmission. The frame message is released afterwards.
+ *
+ * Parameters:
+ *  msg : frame message from the radar task
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void send_udp_frame(publisher_data_t *msg)
+{
+    /* The radar task may write the message again once it is released */
+    send_frame(msg->data, msg->length);
+    radar_release_frame(msg);
+}
+
+/*******************************************************************************
+ * Function Name: send_frame
+ *******************************************************************************
+ * Summary:
+ *  Sends a frame datagram with its parity datagrams and keeps it for
+ *  retransmission, for live frames and the frames kept during a Wi-Fi
+ *  outage alike.
+ *
+ * Parameters:
+ *  data   : frame datagram
+ *  length : size of the datagram
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void send_frame(const uint8_t *data, uint32_t length)
+{
+    const bool sent = send_frame_datagram(data, length);
+
+    send_fec_parity(data, length);
+    radar_resend_store(&resend, data, length);
+
+    taskENTER_CRITICAL();
+    if (sent)
+    {
+        transport_stats.frames_sent++;
+        transport_stats.bytes_sent += length;
+    }
+    else
+    {
+        transport_stats.frames_dropped++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: keep_frame
+ *******************************************************************************
+ * Summary:
+ *  Keeps a frame datagram in the backlog until the Wi-Fi link is back and
+ *  the frames before it are sent. The frame message is released afterwards.
+ *  Once the backlog is full the oldest frame is dropped.
+ *
+ * Parameters:
+ *  msg : frame message from the radar task
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void keep_frame(publisher_data_t *msg)
+{
+    const bool kept = radar_wifi_keep(&wifi, msg->data, msg->length);
+
+    radar_release_frame(msg);
+
+    taskENTER_CRITICAL();
+    if (!kept)
+    {
+        transport_stats.frames_dropped++;
+    }
+    transport_stats.frames_kept = wifi.kept;
+    transport_stats.backlog_dropped = wifi.dropped;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: backlog_wait
+ *******************************************************************************
+ * Summary:
+ *  Adds the drain credit earned since the last call and returns how long
+ *  the next frame kept during a Wi-Fi outage has to wait for it.
+ *
+ * Return:
+ *  ticks until the next kept frame, portMAX_DELAY unless the backlog drains
+ *
+ *******************************************************************************/
+static TickType_t backlog_wait(void)
+{
+    const uint32_t wait_ms = radar_wifi_drain_wait(&wifi, xTaskGetTickCount() * portTICK_PERIOD_MS);
+
+    if (wait_ms == RADAR_WIFI_IDLE)
+    {
+        return portMAX_DELAY;
+    }
+    if (wait_ms == 0)
+    {
+        return 0;
+    }
+
+    return pdMS_TO_TICKS(wait_ms) + 1u;
+}
+
+/*******************************************************************************
+ * Function Name: send_backlog
+ *******************************************************************************
+ * Summary:
+ *  Sends the oldest frame kept during a Wi-Fi outage if the backlog rate
+ *  allows it, on the path of the live frames.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void send_backlog(void)
+{
+    const uint8_t *datagram;
+    const uint32_t length = radar_wifi_drain_next(&wifi, &datagram);
+
+    if (length != 0)
+    {
+        send_frame(datagram, length);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: queue_tcp_frame
+ *******************************************************************************
+ * Summary:
+ *  Copies a frame datagram with its size to the TCP stream and releases the
+ *  frame message. The stream is written once it holds a full segment.
+ *  Without a TCP client or while the Wi-Fi link is down the frame is
+ *  dropped; the client is closed with the link and has to connect again.
+ *
+ * Parameters:
+ *  msg : frame message from the radar task
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void queue_tcp_frame(const publisher_data_t *msg)
+{
+    if ((tcp_client_socket == NULL) || (wifi.state == RADAR_WIFI_DOWN) || (msg->length > MAX_FRAME_DATAGRAM_SIZE))
+    {
+        radar_release_frame(msg);
+        taskENTER_CRITICAL();
+        transport_stats.frames_dropped++;
+        taskEXIT_CRITICAL();
+        return;
+    }
+
+    if (tcp_stream.length == 0)
+    {
+        tcp_buffer_time = xTaskGetTickCount();
+    }
+    (void)radar_stream_add(&tcp_stream, msg->data, msg->length);
+    radar_release_frame(msg);
+
+    if (radar_stream_is_full(&tcp_stream))
+    {
+        flush_tcp_frames();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: flush_tcp_frames
+ *******************************************************************************
+ * Summary:
+ *  Writes the collected frames to the TCP client. The write blocks while the
+ *  link is slower than the frames arrive; the bytes it still holds are
+ *  reported to the radar task, which skips frames until the link caught up.
+ *  After TCP_SEND_TIMEOUT_MS the client is closed and the frames dropped.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void flush_tcp_frames(void)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    uint32_t offset = 0;
+    uint32_t bytes_sent;
+
+    if (tcp_client_socket == NULL)
+    {
+        radar_stream_clear(&tcp_stream);
+        return;
+    }
+
+    while ((offset < tcp_stream.length) && (result == CY_RSLT_SUCCESS))
+    {
+        taskENTER_CRITICAL();
+        tcp_fill = tcp_stream.length - offset;
+        taskEXIT_CRITICAL();
+
+        bytes_sent = 0;
+        result = cy_socket_send(tcp_client_socket, &tcp_buffer[offset], tcp_stream.length - offset,
+                                CY_SOCKET_FLAGS_NONE, &bytes_sent);
+        offset += bytes_sent;
+    }
+
+    if (result == CY_RSLT_SUCCESS)
+    {
+        taskENTER_CRITICAL();
+        tcp_fill = 0;
+        transport_stats.frames_sent += tcp_stream.frames;
+        transport_stats.bytes_sent += tcp_stream.length;
+        taskEXIT_CRITICAL();
+        radar_stream_clear(&tcp_stream);
+    }
+    else
+    {
+        printf("Failed to send data to TCP client. Error: %"PRIu32"\n", result);
+        close_tcp_client();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: close_tcp_client
+ *******************************************************************************
+ * Summary:
+ *  Closes the TCP client connection, frames not written yet are dropped.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void close_tcp_client(void)
+{
+    cy_socket_t client;
+
+    taskENTER_CRITICAL();
+    client = tcp_client_socket;
+    tcp_client_socket = NULL;
+    tcp_client_closed = false;
+    tcp_fill = 0;
+    transport_stats.frames_dropped += tcp_stream.frames;
+    transport_stats.connected = false;
+    taskEXIT_CRITICAL();
+
+    radar_stream_clear(&tcp_stream);
+    if (client != NULL)
+    {
+        (void)cy_socket_disconnect(client, 0);
+        (void)cy_socket_delete(client);
+        printf("TCP client disconnected\n");
+    }
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_set_transport
+ *******************************************************************************
+ * Summary:
+ *  Selects the transport of the frame datagrams: UDP to the last client that
+ *  sent a message, or a stream to the TCP client.
+ *
+ * Parameters:
+ *  mode : UDP_SERVER_TRANSPORT_UDP or UDP_SERVER_TRANSPORT_TCP
+ *
+ * Return:
+ *  RESULT_SUCCESS, RESULT_ERROR for an unknown transport
+ *
+ *******************************************************************************/
+int32_t udp_server_set_transport(uint8_t mode)
+{
+    if ((mode != UDP_SERVER_TRANSPORT_UDP) && (mode != UDP_SERVER_TRANSPORT_TCP))
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    transport_mode = mode;
+    taskEXIT_CRITICAL();
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_get_transport_stats
+ *******************************************************************************
+ * Summary:
+ *  Reads the transport and its counters of sent and dropped frames.
+ *
+ * Parameters:
+ *  stats : destination for the counters
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void udp_server_get_transport_stats(udp_server_transport_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = transport_stats;
+    stats->mode = transport_mode;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_get_tcp_fill
+ *******************************************************************************
+ * Summary:
+ *  Reads the fill level of the TCP stream: the bytes of the current write
+ *  that the link has not taken yet. It stays 0 while the link keeps up with
+ *  the frames and in UDP mode.
+ *
+ * Return:
+ *  bytes waiting for the link
+ *
+ *******************************************************************************/
+uint32_t udp_server_get_tcp_fill(void)
+{
+    uint32_t fill;
+
+    taskENTER_CRITICAL();
+    fill = tcp_fill;
+    taskEXIT_CRITICAL();
+
+    return fill;
+}
+
+/*******************************************************************************
+ * Function Name: send_datagram
+ *******************************************************************************
+ * Summary:
+ *  Sends a datagram from the server socket.
+ *
+ * Parameters:
+ *  addr   : destination
+ *  data   : datagram
+ *  length : size of the datagram
+ *
+ * Return:
+ *  true if the datagram was sent
+ *
+ *******************************************************************************/
+static bool send_datagram(const cy_socket_sockaddr_t *addr, const uint8_t *data, uint32_t length)
+{
+    cy_rslt_t result;
+    uint32_t bytes_sent = 0;
+
+    result = cy_socket_sendto(server_radar_data, data, length, CY_SOCKET_FLAGS_NONE,
+                              addr, sizeof(cy_socket_sockaddr_t), &bytes_sent);
+    if(result == CY_RSLT_SUCCESS )
+    {
+        printf("Data with length:%" PRIu32 " sent to udp client\n", bytes_sent);
+    }
+    else
+    {
+        printf("Failed to send data to client. Error: %"PRIu32"\n", result);
+    }
+
+    return result == CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: send_to_client
+ *******************************************************************************
+ * Summary:
+ *  Sends a datagram to the client.
+ *
+ * Parameters:
+ *  data   : datagram
+ *  length : size of the datagram
+ *
+ * Return:
+ *  true if the datagram was sent
+ *
+ *******************************************************************************/
+static bool send_to_client(const uint8_t *data, uint32_t length)
+{
+    return send_datagram(&peer_addr, data, length);
+}
+
+/*******************************************************************************
+ * Function Name: send_frame_datagram
+ *******************************************************************************
+ * Summary:
+ *  Sends a frame, parity or retransmitted datagram to the multicast group if
+ *  the multicast stream is enabled, else to the client.
+ *
+ * Parameters:
+ *  data   : datagram
+ *  length : size of the datagram
+ *
+ * Return:
+ *  true if the datagram was sent
+ *
+ *******************************************************************************/
+static bool send_frame_datagram(const uint8_t *data, uint32_t length)
+{
+    return send_datagram(multicast_enabled ? &multicast_addr : &peer_addr, data, length);
+}
+
+/*******************************************************************************
+ * Function Name: apply_multicast
+ *******************************************************************************
+ * Summary:
+ *  Takes over the multicast settings from the configuration task. The TTL
+ *  only applies to the datagrams sent to a multicast group.
+ *
+ * Parameters:
+ *  config : multicast settings
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void apply_multicast(const udp_server_multicast_t *config)
+{
+    cy_rslt_t result;
+    uint8_t ttl = config->ttl;
+
+    if (config->enabled)
+    {
+        result = cy_socket_setsockopt(server_radar_data, CY_SOCKET_SOL_IP, CY_SOCKET_SO_IP_MULTICAST_TTL,
+                                      &ttl, sizeof(ttl));
+        if (result != CY_RSLT_SUCCESS)
+        {
+            printf("Failed to set the multicast TTL. Error: %"PRIu32"\n", result);
+        }
+    }
+
+    multicast_addr.ip_address.version = CY_SOCKET_IP_VER_V4;
+    multicast_addr.ip_address.ip.v4 = config->group;
+    multicast_addr.port = config->port;
+    multicast_enabled = config->enabled;
+}
+
+/*******************************************************************************
+ * Function Name: send_fec_parity
+ *******************************************************************************
+ * Summary:
+ *  Adds a sent frame datagram to the parity of its group and sends the
+ *  parity datagrams once the group is complete. The datagram is added even
+ *  if sending it failed, the client can rebuild it as well.
+ *
+ * Parameters:
+ *  data   : frame datagram that was sent
+ *  length : size of the datagram
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void send_fec_parity(const uint8_t *data, uint32_t length)
+{
+    const uint8_t *parity;
+    uint32_t parity_length;
+
+    taskENTER_CRITICAL();
+    if (fec_config_changed)
+    {
+        radar_fec_configure(&fec, &fec_config);
+        fec_config_changed = false;
+    }
+    taskEXIT_CRITICAL();
+
+    if (radar_fec_add(&fec, data, length))
+    {
+        for (uint32_t i = 0; i < fec.config.parity_count; ++i)
+        {
+            parity_length = radar_fec_write_parity(&fec, i, &parity);
+            send_frame_datagram(parity, parity_length);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: take_nack_requests
+ *******************************************************************************
+ * Summary:
+ *  Marks the datagrams of the retransmission requests received since the
+ *  last call.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void take_nack_requests(void)
+{
+    uint8_t nacks[MAX_PENDING_NACKS][RADAR_RESEND_NACK_MAX_SIZE];
+    uint8_t lengths[MAX_PENDING_NACKS];
+    uint32_t num_nacks;
+
+    taskENTER_CRITICAL();
+    num_nacks = num_nack_pending;
+    memcpy(nacks, nack_pending, sizeof(nacks));
+    memcpy(lengths, nack_pending_length, sizeof(lengths));
+    num_nack_pending = 0;
+    taskEXIT_CRITICAL();
+
+    for (uint32_t i = 0; i < num_nacks; ++i)
+    {
+        (void)radar_resend_request(&resend, nacks[i], lengths[i]);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: resend_wait
+ *******************************************************************************
+ * Summary:
+ *  Adds the retransmission credit earned since the last call and returns
+ *  how long the next retransmission has to wait for it.
+ *
+ * Return:
+ *  ticks until the next retransmission, portMAX_DELAY if none is requested
+ *  or the link is down
+ *
+ *******************************************************************************/
+static TickType_t resend_wait(void)
+{
+    const TickType_t now = xTaskGetTickCount();
+    const uint32_t elapsed_ms = (uint32_t)(now - resend_credit_time) * portTICK_PERIOD_MS;
+    const uint32_t budget = resend_budget;
+
+    resend_credit_time = now;
+    if (elapsed_ms >= (RESEND_MAX_CREDIT(budget) / budget))
+    {
+        resend_credit = RESEND_MAX_CREDIT(budget);
+    }
+    else
+    {
+        resend_credit += elapsed_ms * budget;
+        if (resend_credit > RESEND_MAX_CREDIT(budget))
+        {
+            resend_credit = RESEND_MAX_CREDIT(budget);
+        }
+    }
+
+    if ((resend.num_requested == 0) || (wifi.state == RADAR_WIFI_DOWN))
+    {
+        return portMAX_DELAY;
+    }
+    if (resend_credit >= RESEND_CREDIT_UNIT)
+    {
+        return 0;
+    }
+
+    return pdMS_TO_TICKS(((RESEND_CREDIT_UNIT - resend_credit) + budget - 1u) / budget) + 1u;
+}
+
+/*******************************************************************************
+ * Function Name: send_resend
+ *******************************************************************************
+ * Summary:
+ *  Sends the oldest requested datagram again if the budget allows it.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void send_resend(void)
+{
+    const uint8_t *datagram;
+    uint32_t length;
+
+    if ((resend_credit < RESEND_CREDIT_UNIT) || (wifi.state == RADAR_WIFI_DOWN))
+    {
+        return;
+    }
+
+    length = radar_resend_next(&resend, &datagram);
+    if (length != 0)
+    {
+        resend_credit -= RESEND_CREDIT_UNIT;
+        send_frame_datagram(datagram, length);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: run_link_test
+ *******************************************************************************
+ * Summary:
+ *  Starts or stops a requested link test run, sends the datagrams whose
+ *  burst is due and the report once the run is over. A lost Wi-Fi link ends
+ *  the run, its report is sent once the link is back.
+ *
+ * Return:
+ *  ticks until the next burst, portMAX_DELAY if no run is going on
+ *
+ *******************************************************************************/
+static TickType_t run_link_test(void)
+{
+    radar_link_config_t config;
+    bool start;
+    bool stop;
+    uint64_t now;
+    uint64_t next;
+    uint32_t due;
+
+    taskENTER_CRITICAL();
+    start = link_start_requested;
+    stop = link_stop_requested;
+    config = link_request;
+    link_start_requested = false;
+    link_stop_requested = false;
+    link_wake_pending = false;
+    taskEXIT_CRITICAL();
+
+    now = radar_clock_now_us();
+    if (stop && link.running)
+    {
+        radar_link_stop(&link, now);
+        link_report_pending = true;
+    }
+    if (start)
+    {
+        /* A new run ends the one going on, its report is replaced */
+        radar_link_start(&link, &config, now);
+        link_report_pending = true;
+        for (uint32_t i = RADAR_LINK_HEADER_SIZE; i < config.size; ++i)
+        {
+            link_buffer[i] = (uint8_t)i;
+        }
+    }
+    if ((wifi.state == RADAR_WIFI_DOWN) && link.running)
+    {
+        radar_link_stop(&link, now);
+    }
+
+    due = radar_link_due(&link, now);
+    if (due > LINK_MAX_SEND)
+    {
+        due = LINK_MAX_SEND;
+    }
+    while (due-- != 0)
+    {
+        uint64_t host_time;
+        const uint64_t send_time = radar_clock_now_us();
+        const bool synced = udp_server_host_time(send_time, &host_time);
+
+        radar_link_write_header(&link, link_buffer, synced ? host_time : send_time,
+                                synced ? RADAR_FRAME_FLAG_SYNCED : 0u);
+        radar_link_sent(&link, send_link_datagram(link.config.size), send_time);
+    }
+
+    if (!link.running)
+    {
+        if (link_report_pending && (wifi.state != RADAR_WIFI_DOWN))
+        {
+            link_report_pending = false;
+            send_link_report();
+        }
+        return portMAX_DELAY;
+    }
+
+    now = radar_clock_now_us();
+    next = radar_link_next_us(&link);
+    if (next <= now)
+    {
+        return 0;
+    }
+
+    /* Bursts closer than a tick apart go out together at the next tick */
+    return pdMS_TO_TICKS((uint32_t)(((next - now) + 999u) / 1000u)) + 1u;
+}
+
+/*******************************************************************************
+ * Function Name: send_link_datagram
+ *******************************************************************************
+ * Summary:
+ *  Sends a link test datagram to the client. Unlike send_to_client(), nothing
+ *  is printed, the console would limit the rate of the test.
+ *
+ * Parameters:
+ *  length : size of the datagram in link_buffer
+ *
+ * Return:
+ *  true if the datagram was sent
+ *
+ *******************************************************************************/
+static bool send_link_datagram(uint32_t length)
+{
+    uint32_t bytes_sent = 0;
+
+    return cy_socket_sendto(server_radar_data, link_buffer, length, CY_SOCKET_FLAGS_NONE,
+                            &peer_addr, sizeof(cy_socket_sockaddr_t), &bytes_sent) == CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: send_link_report
+ *******************************************************************************
+ * Summary:
+ *  Sends the result of the last link test run as json text.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void send_link_report(void)
+{
+    uint32_t length;
+
+    link_buffer[0] = RADAR_LINK_REPORT_COMMAND;
+    link_buffer[1] = DUMMY_BYTE;
+    length = 2u + radar_link_report(&link, (char *)&link_buffer[2], sizeof(link_buffer) - 2u);
+
+    printf("%s\n", (char *)&link_buffer[2]);
+    send_to_client(link_buffer, length);
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_start_link_test
+ *******************************************************************************
+ * Summary:
+ *  Starts a link test run to the client, a run going on is ended first. The
+ *  client is the last one that sent a message.
+ *
+ * Parameters:
+ *  config : settings of the run
+ *
+ * Return:
+ *  RESULT_SUCCESS, RESULT_ERROR if the settings are not supported or no
+ *  client is known yet
+ *
+ *******************************************************************************/
+int32_t udp_server_start_link_test(const radar_link_config_t *config)
+{
+    bool wake;
+
+    if (!radar_link_config_is_valid(config) || (peer_addr.port == 0))
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    link_request = *config;
+    link_start_requested = true;
+    wake = !link_wake_pending;
+    link_wake_pending = true;
+    taskEXIT_CRITICAL();
+
+    if (wake)
+    {
+        xQueueSendToBack(radar_data_queue, &link_msg_ptr, 0);
+    }
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_stop_link_test
+ *******************************************************************************
+ * Summary:
+ *  Ends the link test run going on, its report is sent with what was sent
+ *  so far.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void udp_server_stop_link_test(void)
+{
+    bool wake;
+
+    taskENTER_CRITICAL();
+    link_stop_requested = true;
+    wake = !link_wake_pending;
+    link_wake_pending = true;
+    taskEXIT_CRITICAL();
+
+    if (wake)
+    {
+        xQueueSendToBack(radar_data_queue, &link_msg_ptr, 0);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: check_lease
+ *******************************************************************************
+ * Summary:
+ *  Suspends the frames once the client was not heard from within the lease
+ *  and resumes them when it is heard again. The sensor is stopped and
+ *  restarted through the configuration queue, in order with the commands of
+ *  the client.
+ *
+ * Return:
+ *  ticks until the lease expires, portMAX_DELAY without a running lease
+ *
+ *******************************************************************************/
+static TickType_t check_lease(void)
+{
+    const TickType_t now = xTaskGetTickCount();
+    udp_server_lease_t config;
+    TickType_t heard;
+    TickType_t wait = portMAX_DELAY;
+    bool expired = false;
+    bool stop_radar;
+    char *request;
+
+    taskENTER_CRITICAL();
+    config = lease_config;
+    heard = lease_heard;
+    lease_wake_pending = false;
+    taskEXIT_CRITICAL();
+
+    /* The client cannot renew the lease while the link is down */
+    if ((config.duration_ms != 0) && (peer_addr.port != 0) && (wifi.state != RADAR_WIFI_DOWN))
+    {
+        const TickType_t lease_ticks = pdMS_TO_TICKS(config.duration_ms);
+
+        expired = ((TickType_t)(now - heard) >= lease_ticks);
+        if (!expired)
+        {
+            wait = lease_ticks - (TickType_t)(now - heard);
+        }
+    }
+
+    if (expired != lease_expired)
+    {
+        taskENTER_CRITICAL();
+        lease_expired = expired;
+        transport_stats.suspended = expired;
+        if (expired)
+        {
+            transport_stats.lease_expiries++;
+        }
+        taskEXIT_CRITICAL();
+
+        printf(expired ? "Client lease expired, frames suspended \r\n" : "Client heard again, frames resumed \r\n");
+    }
+
+    stop_radar = expired && config.stop_radar;
+    if (stop_radar != lease_radar_stopped)
+    {
+        request = stop_radar ? udp_server_lease_expired : udp_server_lease_renewed;
+        if (xQueueSendToBack(radar_config_queue, &request, 0) == pdTRUE)
+        {
+            lease_radar_stopped = stop_radar;
+        }
+        else if (wait > pdMS_TO_TICKS(CONFIG_RETRY_MS))
+        {
+            wait = pdMS_TO_TICKS(CONFIG_RETRY_MS);
+        }
+    }
+
+    return wait;
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_set_lease
+ *******************************************************************************
+ * Summary:
+ *  Sets the client lease. The lease starts over with the new duration.
+ *
+ * Parameters:
+ *  config : lease settings
+ *
+ * Return:
+ *  RESULT_SUCCESS, RESULT_ERROR for a duration above UDP_SERVER_LEASE_MAX_MS
+ *
+ *******************************************************************************/
+int32_t udp_server_set_lease(const udp_server_lease_t *config)
+{
+    bool wake;
+
+    if (config->duration_ms > UDP_SERVER_LEASE_MAX_MS)
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    lease_config = *config;
+    lease_heard = xTaskGetTickCount();
+    wake = !lease_wake_pending;
+    lease_wake_pending = true;
+    taskEXIT_CRITICAL();
+
+    /* The UDP server task recomputes its wait with the new duration */
+    if (wake)
+    {
+        xQueueSendToBack(radar_data_queue, &lease_msg_ptr, 0);
+    }
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_get_lease
+ *******************************************************************************
+ * Summary:
+ *  Reads the client lease settings.
+ *
+ * Parameters:
+ *  config : destination for the settings
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void udp_server_get_lease(udp_server_lease_t *config)
+{
+    taskENTER_CRITICAL();
+    *config = lease_config;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: wifi_event_callback
+ *******************************************************************************
+ * Summary:
+ *  Wi-Fi connection manager callback, notes whether the link is up and
+ *  whether the kit got another IP address.
+ *
+ * Parameters:
+ *  event      : connection manager event
+ *  event_data : event details (unused)
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void wifi_event_callback(cy_wcm_event_t event, cy_wcm_event_data_t *event_data)
+{
+    bool connected;
+    bool address_changed = false;
+
+    (void)event_data;
+
+    taskENTER_CRITICAL();
+    connected = wifi_connected;
+    taskEXIT_CRITICAL();
+
+    radar_wifi_event(event, &connected, &address_changed);
+    set_wifi_connected(connected, address_changed);
+}
+
+/*******************************************************************************
+ * Function Name: set_wifi_connected
+ *******************************************************************************
+ * Summary:
+ *  Notes whether the Wi-Fi link is up and wakes up the UDP server task if it
+ *  changed or the kit got another IP address.
+ *
+ * Parameters:
+ *  connected       : the link is up
+ *  address_changed : the AP assigned another IP address
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void set_wifi_connected(bool connected, bool address_changed)
+{
+    bool wake;
+
+    taskENTER_CRITICAL();
+    wake = ((wifi_connected != connected) || address_changed) && !wifi_wake_pending;
+    wifi_connected = connected;
+    wifi_address_changed = wifi_address_changed || address_changed;
+    wifi_wake_pending = wifi_wake_pending || wake;
+    taskEXIT_CRITICAL();
+
+    if (wake)
+    {
+        xQueueSendToBack(radar_data_queue, &wifi_msg_ptr, 0);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: check_wifi
+ *******************************************************************************
+ * Summary:
+ *  Follows the Wi-Fi link, see radar_wifi_update(). A lost link keeps the
+ *  frames, closes the TCP client and starts the Wi-Fi join task. If the AP
+ *  assigned another IP address, the sockets are bound to it first. Once the
+ *  link is back the backlog is drained before live frames go out again, and
+ *  the client lease starts over.
+ *
+ * Return:
+ *  ticks until the next rebind attempt or drain progress check,
+ *  portMAX_DELAY if only a link change is awaited
+ *
+ *******************************************************************************/
+static TickType_t check_wifi(void)
+{
+    const uint8_t state = wifi.state;
+    bool connected;
+    bool address_changed;
+    bool join;
+    uint32_t wait_ms;
+
+    taskENTER_CRITICAL();
+    connected = wifi_connected;
+    address_changed = wifi_address_changed;
+    wifi_address_changed = false;
+    wifi_wake_pending = false;
+    wifi.rate = backlog_rate;
+    taskEXIT_CRITICAL();
+
+    wait_ms = radar_wifi_update(&wifi, connected, address_changed, xTaskGetTickCount() * portTICK_PERIOD_MS);
+
+    /* One run of joins per outage, the join task ends it once connected */
+    join = !connected && !wifi_joining;
+    wifi_joining = !connected;
+    if (join)
+    {
+        xTaskNotifyGive(wifi_join_task_handle);
+    }
+
+    if (wifi.state != state)
+    {
+        if (wifi.state == RADAR_WIFI_DOWN)
+        {
+            printf("Wi-Fi link lost, frames kept until it is back \r\n");
+            close_tcp_client();
+        }
+        else if (state == RADAR_WIFI_DOWN)
+        {
+            printf("Wi-Fi link back, %"PRIu32" kept frames to send \r\n", (uint32_t)wifi.backlog.num_requested);
+        }
+        if (wifi.state == RADAR_WIFI_UP)
+        {
+            printf("Backlog sent, live frames resumed \r\n");
+        }
+
+        taskENTER_CRITICAL();
+        if (state == RADAR_WIFI_DOWN)
+        {
+            lease_heard = xTaskGetTickCount();
+        }
+        transport_stats.wifi = wifi.state;
+        transport_stats.wifi_disconnects = wifi.disconnects;
+        transport_stats.backlog_dropped = wifi.dropped;
+        taskEXIT_CRITICAL();
+    }
+
+    return (wait_ms == RADAR_WIFI_IDLE) ? portMAX_DELAY : (pdMS_TO_TICKS(wait_ms) + 1u);
+}
+
+/*******************************************************************************
+ * Function Name: wifi_join_task
+ *******************************************************************************
+ * Summary:
+ *  Joins the AP again after the Wi-Fi link was lost, the join blocks for as
+ *  long as it takes. The connection manager gets the first
+ *  WIFI_RECONNECT_MIN_MS to rejoin the AP by itself, then the wait doubles
+ *  after every failed attempt up to WIFI_RECONNECT_MAX_MS. The UDP server
+ *  task starts the joins and learns of the link through
+ *  set_wifi_connected().
+ *
+ * Parameters:
+ *  void *arg : Task parameter defined during task creation (unused)
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void wifi_join_task(void *arg)
+{
+    radar_wifi_join_t join;
+    bool connected;
+
+    (void)arg;
+
+    while (true)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        radar_wifi_join_start(&join, WIFI_RECONNECT_MIN_MS, WIFI_RECONNECT_MAX_MS);
+        do
+        {
+            vTaskDelay(pdMS_TO_TICKS(join.wait_ms));
+
+            taskENTER_CRITICAL();
+            connected = wifi_connected;
+            taskEXIT_CRITICAL();
+
+            if (!connected)
+            {
+                connected = radar_wifi_join_attempt(&join, &wifi_conn_param);
+                if (connected)
+                {
+                    printf("Reconnected to Wi-Fi network '%s'.\n", wifi_conn_param.ap_credentials.SSID);
+                    set_wifi_connected(true, false);
+                }
+                else
+                {
+                    printf("Reconnection to Wi-Fi network failed. Retrying in %"PRIu32" ms...\n", join.wait_ms);
+                }
+            }
+        } while (!connected);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_set_backlog_rate
+ *******************************************************************************
+ * Summary:
+ *  Sets the rate the frames kept during a Wi-Fi outage are sent at once the
+ *  link is back. A rate that does not exceed the frame rate cannot drain the
+ *  backlog: once it did not shrink over the time it takes at this rate, the
+ *  rest is dropped and live frames go out again.
+ *
+ * Parameters:
+ *  rate : datagrams per second
+ *
+ * Return:
+ *  RESULT_SUCCESS, RESULT_ERROR for 0 or a rate above RADAR_WIFI_MAX_RATE
+ *
+ *******************************************************************************/
+int32_t udp_server_set_backlog_rate(uint16_t rate)
+{
+    if (!radar_wifi_rate_is_valid(rate))
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    backlog_rate = rate;
+    taskEXIT_CRITICAL();
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_get_backlog_rate
+ *******************************************************************************
+ * Summary:
+ *  Reads the rate the backlog of a Wi-Fi outage is sent at.
+ *
+ * Return:
+ *  datagrams per second
+ *
+ *******************************************************************************/
+uint16_t udp_server_get_backlog_rate(void)
+{
+    uint16_t rate;
+
+    taskENTER_CRITICAL();
+    rate = backlog_rate;
+    taskEXIT_CRITICAL();
+
+    return rate;
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_set_multicast
+ *******************************************************************************
+ * Summary:
+ *  Sets the multicast stream of the frame datagrams. It takes effect with the
+ *  next frame datagram; commands and their replies stay with the client.
+ *
+ * Parameters:
+ *  config : multicast settings, the group is only checked when enabled
+ *
+ * Return:
+ *  RESULT_SUCCESS, RESULT_ERROR for an address outside 224.0.0.0/4, port 0
+ *  or TTL 0
+ *
+ *******************************************************************************/
+int32_t udp_server_set_multicast(const udp_server_multicast_t *config)
+{
+    if ((config->enabled && ((config->group & 0xF0u) != 0xE0u)) || (config->port == 0) || (config->ttl == 0))
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    multicast_config = *config;
+    multicast_config_changed = true;
+    taskEXIT_CRITICAL();
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_get_multicast
+ *******************************************************************************
+ * Summary:
+ *  Reads the multicast settings.
+ *
+ * Parameters:
+ *  config : destination for the settings
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void udp_server_get_multicast(udp_server_multicast_t *config)
+{
+    taskENTER_CRITICAL();
+    *config = multicast_config;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_set_resend
+ *******************************************************************************
+ * Summary:
+ *  Sets the depth of the retransmission ring and the retransmission budget.
+ *  A new depth empties the ring.
+ *
+ * Parameters:
+ *  config : retransmission settings
+ *
+ * Return:
+ *  RESULT_SUCCESS, RESULT_ERROR if the settings are not supported
+ *
+ *******************************************************************************/
+int32_t udp_server_set_resend(const radar_resend_config_t *config)
+{
+    if (!radar_resend_config_is_valid(config))
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    resend_config = *config;
+    resend_config_changed = true;
+    taskEXIT_CRITICAL();
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_get_resend
+ *******************************************************************************
+ * Summary:
+ *  Reads the retransmission settings.
+ *
+ * Parameters:
+ *  config : destination for the settings
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void udp_server_get_resend(radar_resend_config_t *config)
+{
+    taskENTER_CRITICAL();
+    *config = resend_config;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_set_fec
+ *******************************************************************************
+ * Summary:
+ *  Sets the parity over the frame datagrams. It takes effect with the next
+ *  frame datagram, which starts a new group.
+ *
+ * Parameters:
+ *  config : parity settings
+ *
+ * Return:
+ *  RESULT_SUCCESS, RESULT_ERROR if the settings are not supported
+ *
+ *******************************************************************************/
+int32_t udp_server_set_fec(const radar_fec_config_t *config)
+{
+    if (!radar_fec_config_is_valid(config))
+    {
+        return RESULT_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    fec_config = *config;
+    fec_config_changed = true;
+    taskEXIT_CRITICAL();
+
+    return RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: udp_server_get_fec
+ *******************************************************************************
+ * Summary:
+ *  Reads the parity settings.
+ *
+ * Parameters:
+ *  config : destination for the settings
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void udp_server_get_fec(radar_fec_config_t *config)
+{
+    taskENTER_CRITICAL();
+    *config = fec_config;
+    taskEXIT_CRITICAL();
+}
+
 /*******************************************************************************
- * Function Name: udp_server_task
+ * Function Name: send_sync_request
  *******************************************************************************
  * Summary:
- *  Task used to establish a connection to a remote UDP client.
- *
- * Parameters:
- *  void *args : Task parameter defined during task creation (unused)
+ *  Sends the next time exchange request to the client. The request time is
+ *  taken right before sending.
  *
  * Return:
  *  void
  *
  *******************************************************************************/
-void udp_server_task(void *arg)
+static void send_sync_request(void)
 {
     cy_rslt_t result;
-
-    publisher_data_t *msg;
-
-    /* Variable to store number of bytes sent over UDP socket. */
     uint32_t bytes_sent = 0;
+    uint32_t length;
 
-    /* Initialize semaphore to protect payload */
-    sem_udp_payload = xSemaphoreCreateMutex();
-    if (sem_udp_payload == NULL)
-    {
-        printf(" 'sem_udp_payload' semaphore creation failed... Task suspend\n\n");
-        CY_ASSERT(0);
-    }
-
-    /* Connect to Wi-Fi AP */
-    if(connect_to_wifi_ap() != CY_RSLT_SUCCESS )
-    {
-        printf("\n Failed to connect to Wi-Fi AP.\n");
-        CY_ASSERT(0);
-    }
-
-    /* Secure Sockets initialization */
-    result = cy_socket_init();
-    if (result != CY_RSLT_SUCCESS)
-    {
-        printf("Secure Sockets initialization failed!\n");
-        CY_ASSERT(0);
-    }
+    taskENTER_CRITICAL();
+    length = radar_sync_write_request(&clock_sync, sync_request, radar_clock_now_us());
+    taskEXIT_CRITICAL();
 
-    /* Create UDP Server*/
-    result = create_udp_server_socket();
+    result = cy_socket_sendto(server_radar_data, sync_request, length, CY_SOCKET_FLAGS_NONE,
+                              &peer_addr, sizeof(cy_socket_sockaddr_t), &bytes_sent);
     if (result != CY_RSLT_SUCCESS)
     {
-        printf("UDP Server Socket creation failed. Error: %"PRIu32"\n", result);
-        CY_ASSERT(0);
-    }
-
-    /* Create a message queue to communicate with other tasks and callbacks. */
-    radar_data_queue = xQueueCreate(TASK_QUEUE_LENGTH, sizeof(publisher_data_t * ));
-    if (radar_data_queue == NULL)
-    {
-        printf(" 'udp_server_task' queue creation failed... Task suspended\n\n");
-        CY_ASSERT(0);
-    }
-
-    radar_config_queue = xQueueCreate(TASK_QUEUE_LENGTH, sizeof(sub_msg));
-    if (radar_config_queue == NULL)
-    {
-        printf(" 'radar_config_queue' queue creation failed... Task suspended\n\n");
-        CY_ASSERT(0);
+        printf("Failed to send time request to client. Error: %"PRIu32"\n", result);
     }
+}
 
+/*******************************************************************************
+ * Function Name: udp_server_set_sync_interval
+ *******************************************************************************
+ * Summary:
+ *  Sets the interval of the time exchange with the client.
+ *
+ * Parameters:
+ *  interval_ms : milliseconds between two exchanges, 0 stops them
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void udp_server_set_sync_interval(uint32_t interval_ms)
+{
+    taskENTER_CRITICAL();
+    sync_interval_ms = interval_ms;
+    taskEXIT_CRITICAL();
+}
 
-    if(pdPASS !=  xTaskCreate(radar_task, "radar_task", configMINIMAL_STACK_SIZE * 8, NULL, 7, &radar_task_handle))
-    {
-        printf("Failed to create radar data task!\n");
-        CY_ASSERT(0);
-    }
+/*******************************************************************************
+ * Function Name: udp_server_host_time
+ *******************************************************************************
+ * Summary:
+ *  Converts a device clock time to the clock of the client.
+ *
+ * Parameters:
+ *  device_time : device time in microseconds
+ *  host_time   : client time in microseconds
+ *
+ * Return:
+ *  true if the clocks are synchronized, host_time is unchanged otherwise
+ *
+ *******************************************************************************/
+bool udp_server_host_time(uint64_t device_time, uint64_t *host_time)
+{
+    bool synced;
 
-    while(true)
-    {
+    taskENTER_CRITICAL();
+    synced = radar_sync_host_time(&clock_sync, device_time, host_time);
+    taskEXIT_CRITICAL();
 
-        if (pdTRUE ==  xQueueReceive( radar_data_queue, &msg, ( TickType_t ) portMAX_DELAY ))
-        {
-            switch(msg->cmd)
-            {
-                case RADAR_DATA_COMMAND:
-                {
+    return synced;
+}
 
-                    result = cy_socket_sendto(server_radar_data, msg->data, msg->length, CY_SOCKET_FLAGS_NONE,
-                                             &peer_addr, sizeof(cy_socket_sockaddr_t), &bytes_sent);
-                    if(result == CY_RSLT_SUCCESS )
-                    {
-                        printf("Data with length:%" PRIu32 " sent to udp client\n", bytes_sent);
-                    }
-                    else
-                    {
-                        printf("Failed to send data to client. Error: %"PRIu32"\n", result);
-                    }
-                    break;
-                }
-            }
-        }
-      }
- }
+/*******************************************************************************
+ * Function Name: udp_server_get_sync
+ *******************************************************************************
+ * Summary:
+ *  Reads a consistent copy of the time synchronization state.
+ *
+ * Parameters:
+ *  sync : destination for the state
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void udp_server_get_sync(radar_sync_t *sync)
+{
+    taskENTER_CRITICAL();
+    *sync = clock_sync;
+    taskEXIT_CRITICAL();
+}
 
 /*******************************************************************************
  * Function Name: connect_to_wifi_ap()
@@ -203,8 +2100,6 @@ cy_rslt_t connect_to_wifi_ap(void)
     cy_rslt_t result;
 
     /* Variables used by Wi-Fi connection manager. */
-    cy_wcm_connect_params_t wifi_conn_param;
-
     cy_wcm_config_t wifi_config = {
             .interface = CY_WCM_INTERFACE_TYPE_STA
     };
@@ -262,6 +2157,61 @@ cy_rslt_t connect_to_wifi_ap(void)
     return result;
 }
 
+/*******************************************************************************
+ * Function Name: rebind_sockets
+ *******************************************************************************
+ * Summary:
+ *  Binds the UDP and TCP server sockets to the new IP address of the kit.
+ *  The old sockets are deleted, a TCP client has to connect again and the
+ *  multicast settings are applied to the new UDP socket.
+ *
+ * Parameters:
+ *  address : IPv4 address assigned by the AP
+ *
+ * Return:
+ *  true if both sockets are bound, false to try again later
+ *
+ *******************************************************************************/
+static bool rebind_sockets(uint32_t address)
+{
+    udp_server_multicast_t multicast_settings;
+    cy_rslt_t result;
+
+    close_tcp_client();
+    if (tcp_server_socket != NULL)
+    {
+        (void)cy_socket_delete(tcp_server_socket);
+        tcp_server_socket = NULL;
+    }
+    if (server_radar_data != NULL)
+    {
+        (void)cy_socket_delete(server_radar_data);
+        server_radar_data = NULL;
+    }
+
+    printf("IP Address changed to %d.%d.%d.%d\n", (uint8)address, (uint8)(address >> 8),
+            (uint8)(address >> 16), (uint8)(address >> 24));
+    udp_server_addr.ip_address.ip.v4 = address;
+
+    result = create_udp_server_socket();
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = create_tcp_server_socket();
+    }
+    if (result != CY_RSLT_SUCCESS)
+    {
+        printf("Socket creation on the new address failed. Error: %"PRIu32"\n", result);
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    multicast_settings = multicast_config;
+    taskEXIT_CRITICAL();
+    apply_multicast(&multicast_settings);
+
+    return true;
+}
+
 /*******************************************************************************
  * Function Name: create_udp_server_socket
  *******************************************************************************
@@ -308,6 +2258,158 @@ cy_rslt_t create_udp_server_socket(void)
     return result;
 }
 
+/*******************************************************************************
+ * Function Name: create_tcp_server_socket
+ *******************************************************************************
+ * Summary:
+ *  Function to create the listening socket of the TCP stream.
+ *
+ *  Return:
+ *   error
+ *
+ *******************************************************************************/
+cy_rslt_t create_tcp_server_socket(void)
+{
+    cy_rslt_t result;
+    cy_socket_sockaddr_t tcp_server_addr = udp_server_addr;
+
+    cy_socket_opt_callback_t tcp_connect_option = {
+            .callback = tcp_server_connect_handler,
+            .arg = NULL
+    };
+
+    result = cy_socket_create(CY_SOCKET_DOMAIN_AF_INET, CY_SOCKET_TYPE_STREAM, CY_SOCKET_IPPROTO_TCP, &tcp_server_socket);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    result = cy_socket_setsockopt(tcp_server_socket, CY_SOCKET_SOL_SOCKET,
+            CY_SOCKET_SO_CONNECT_REQUEST_CALLBACK,
+            &tcp_connect_option, sizeof(cy_socket_opt_callback_t));
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    tcp_server_addr.port = UDP_SERVER_TCP_PORT;
+    result = cy_socket_bind(tcp_server_socket, &tcp_server_addr, sizeof(tcp_server_addr));
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    result = cy_socket_listen(tcp_server_socket, 1);
+    if (result == CY_RSLT_SUCCESS)
+    {
+         printf("TCP socket listening on port: %d\n", tcp_server_addr.port);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: tcp_server_connect_handler
+ *******************************************************************************
+ * Summary:
+ *  Callback function to accept a TCP client. Nagle's algorithm is disabled,
+ *  the server collects the frames itself. Only one client is served, a
+ *  second one is closed right away.
+ *
+ *  Parameters:
+ *  socket_handle : listening socket
+ *  arg : unused
+ *
+ *  Return:
+ *   error
+ *
+ *******************************************************************************/
+cy_rslt_t tcp_server_connect_handler(cy_socket_t socket_handle, void *arg)
+{
+    cy_rslt_t result;
+    cy_socket_t client;
+    cy_socket_sockaddr_t client_addr;
+    uint32_t client_addr_length = sizeof(client_addr);
+    uint32_t no_delay = 1;
+    uint32_t send_timeout = TCP_SEND_TIMEOUT_MS;
+    bool busy;
+
+    cy_socket_opt_callback_t tcp_disconnect_option = {
+            .callback = tcp_server_disconnect_handler,
+            .arg = NULL
+    };
+
+    result = cy_socket_accept(socket_handle, &client_addr, &client_addr_length, &client);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        printf("Failed to accept TCP client. Error: %"PRIu32"\n", result);
+        return result;
+    }
+
+    taskENTER_CRITICAL();
+    busy = (tcp_client_socket != NULL);
+    taskEXIT_CRITICAL();
+
+    if (!busy)
+    {
+        result = cy_socket_setsockopt(client, CY_SOCKET_SOL_TCP, CY_SOCKET_SO_TCP_NODELAY,
+                                      &no_delay, sizeof(no_delay));
+    }
+    if (!busy && (result == CY_RSLT_SUCCESS))
+    {
+        result = cy_socket_setsockopt(client, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_SNDTIMEO,
+                                      &send_timeout, sizeof(send_timeout));
+    }
+    if (!busy && (result == CY_RSLT_SUCCESS))
+    {
+        result = cy_socket_setsockopt(client, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_DISCONNECT_CALLBACK,
+                                      &tcp_disconnect_option, sizeof(cy_socket_opt_callback_t));
+    }
+    if (busy || (result != CY_RSLT_SUCCESS))
+    {
+        printf("TCP client refused\n");
+        (void)cy_socket_disconnect(client, 0);
+        (void)cy_socket_delete(client);
+        return result;
+    }
+
+    taskENTER_CRITICAL();
+    tcp_client_socket = client;
+    tcp_client_closed = false;
+    transport_stats.connected = true;
+    taskEXIT_CRITICAL();
+
+    printf("TCP client connected\n");
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: tcp_server_disconnect_handler
+ *******************************************************************************
+ * Summary:
+ *  Callback function for a TCP client that closed the connection, the UDP
+ *  server task releases the socket.
+ *
+ *  Parameters:
+ *  socket_handle : client socket
+ *  arg : unused
+ *
+ *  Return:
+ *   error
+ *
+ *******************************************************************************/
+cy_rslt_t tcp_server_disconnect_handler(cy_socket_t socket_handle, void *arg)
+{
+    (void)socket_handle;
+    (void)arg;
+
+    taskENTER_CRITICAL();
+    tcp_client_closed = true;
+    taskEXIT_CRITICAL();
+
+    return CY_RSLT_SUCCESS;
+}
+
 /*******************************************************************************
  * Function Name: udp_server_recv_handler
  *******************************************************************************
@@ -329,12 +2431,74 @@ cy_rslt_t udp_server_recv_handler(cy_socket_t socket_handle, void *arg)
     /* Variable to store the number of bytes received. */
     uint32_t bytes_received = 0;
 
+    /* Arrival time of a time exchange response, taken before anything else */
+    const uint64_t received = radar_clock_now_us();
+
     if (xSemaphoreTake(sem_udp_payload, portMAX_DELAY) == pdTRUE)
     {
         /* Receive incoming message from UDP server. */
-        result = cy_socket_recvfrom(server_radar_data, udp_msg_payload, MAX_UDP_RECV_BUFFER_SIZE,
+        result = cy_socket_recvfrom(socket_handle, udp_msg_payload, MAX_UDP_RECV_BUFFER_SIZE - 1,
                                     CY_SOCKET_FLAGS_NONE, &peer_addr, NULL,
                                     &bytes_received);
+
+        /* Every datagram of the client renews its lease */
+        if (result == CY_RSLT_SUCCESS)
+        {
+            bool wake;
+
+            taskENTER_CRITICAL();
+            lease_heard = xTaskGetTickCount();
+            wake = lease_expired && !lease_wake_pending;
+            lease_wake_pending = lease_wake_pending || wake;
+            taskEXIT_CRITICAL();
+
+            if (wake)
+            {
+                xQueueSendToBack(radar_data_queue, &lease_msg_ptr, 0);
+            }
+        }
+
+        if ((result == CY_RSLT_SUCCESS) && (bytes_received == UDP_SERVER_KEEPALIVE_SIZE) &&
+            ((uint8_t)udp_msg_payload[0] == RADAR_KEEPALIVE_COMMAND))
+        {
+            xSemaphoreGive(sem_udp_payload);
+            return result;
+        }
+
+        if ((result == CY_RSLT_SUCCESS) && (bytes_received == RADAR_SYNC_RESPONSE_SIZE) &&
+            ((uint8_t)udp_msg_payload[0] == RADAR_SYNC_COMMAND))
+        {
+            taskENTER_CRITICAL();
+            (void)radar_sync_process_response(&clock_sync, (const uint8_t *)udp_msg_payload, bytes_received, received);
+            taskEXIT_CRITICAL();
+
+            xSemaphoreGive(sem_udp_payload);
+            return result;
+        }
+
+        if ((result == CY_RSLT_SUCCESS) && (bytes_received > RADAR_RESEND_NACK_HEADER_SIZE) &&
+            (bytes_received <= RADAR_RESEND_NACK_MAX_SIZE) && ((uint8_t)udp_msg_payload[0] == RADAR_NACK_COMMAND))
+        {
+            bool wake = false;
+
+            taskENTER_CRITICAL();
+            if (num_nack_pending < MAX_PENDING_NACKS)
+            {
+                memcpy(nack_pending[num_nack_pending], udp_msg_payload, bytes_received);
+                nack_pending_length[num_nack_pending] = (uint8_t)bytes_received;
+                num_nack_pending++;
+                wake = (num_nack_pending == 1u);
+            }
+            taskEXIT_CRITICAL();
+
+            xSemaphoreGive(sem_udp_payload);
+            if (wake)
+            {
+                xQueueSendToBack(radar_data_queue, &nack_msg_ptr, 0);
+            }
+            return result;
+        }
+
         printf("message received %s\n", udp_msg_payload);
 
         udp_msg_payload[bytes_received] = '\0';
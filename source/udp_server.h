@@ -40,9 +40,17 @@
 #ifndef UDP_SERVER_H_
 #define UDP_SERVER_H_
 
+#include <stdbool.h>
+
 /* Cypress secure socket header file */
 #include "cy_secure_sockets.h"
 
+#include "radar_fec.h"
+#include "radar_link.h"
+#include "radar_resend.h"
+#include "radar_sync.h"
+#include "radar_wifi.h"
+
 /*******************************************************************************
 * Macros
 ********************************************************************************/
@@ -52,13 +60,32 @@
 #define UDP_SERVER_MAX_PENDING_CONNECTIONS        (3)
 #define UDP_SERVER_RECV_TIMEOUT_MS                (500)
 
+/* Port of the TCP stream of frame datagrams */
+#define UDP_SERVER_TCP_PORT                       (57346)
+
+/* Transports of the frame datagrams */
+#define UDP_SERVER_TRANSPORT_UDP                  (0)
+#define UDP_SERVER_TRANSPORT_TCP                  (1)
+
+/* Client lease: frames are only sent while the client was heard from within
+ * the lease, a keepalive datagram is the command and a dummy byte */
+#define UDP_SERVER_LEASE_MAX_MS                   (600000)
+#define UDP_SERVER_KEEPALIVE_SIZE                 (2)
+
+/* Defaults of the multicast stream of frame datagrams */
+#define UDP_SERVER_MULTICAST_PORT                 (57347)
+#define UDP_SERVER_MULTICAST_TTL                  (1)
 
 /* RTOS related macros for UDP server task. */
 #define UDP_SERVER_TASK_STACK_SIZE                (8 * 1024)
 #define UDP_SERVER_TASK_PRIORITY                  (1)
 
+/* Task joining the AP again after the Wi-Fi link was lost */
+#define UDP_SERVER_WIFI_TASK_STACK_SIZE           (1024 * 2)
+#define UDP_SERVER_WIFI_TASK_PRIORITY             (1)
+
 /* Buffer size to store the incoming messages from server, in bytes. */
-#define MAX_UDP_RECV_BUFFER_SIZE                  (64)
+#define MAX_UDP_RECV_BUFFER_SIZE                  (256)
 
 /* Struct to be passed via the publisher task queue */
 typedef struct{
@@ -67,10 +94,65 @@ typedef struct{
     uint8_t *data;
 } publisher_data_t;
 
+/* Frame datagrams handed to the transport */
+typedef struct{
+    uint8_t mode;               /* UDP_SERVER_TRANSPORT_* */
+    bool connected;             /* a TCP client is connected */
+    uint32_t frames_sent;
+    uint32_t frames_dropped;    /* send errors, no TCP client, closed with frames pending or lease expired */
+    uint32_t bytes_sent;
+    bool suspended;             /* the client lease expired */
+    uint32_t lease_expiries;
+    uint8_t wifi;               /* RADAR_WIFI_* */
+    uint32_t wifi_disconnects;
+    uint32_t frames_kept;       /* kept for the backlog while the link was down */
+    uint32_t backlog_dropped;   /* kept frames overwritten or given up */
+} udp_server_transport_stats_t;
+
+/* Client lease */
+typedef struct{
+    uint32_t duration_ms;       /* 0 disables the lease */
+    bool stop_radar;            /* also stop the sensor while the lease is expired */
+} udp_server_lease_t;
+
+/* Multicast stream of frame datagrams, commands and replies stay unicast */
+typedef struct{
+    bool enabled;               /* frames go to the group instead of the client */
+    uint32_t group;             /* IPv4 group address, first byte in the LSB */
+    uint16_t port;
+    uint8_t ttl;
+} udp_server_multicast_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Requests of the UDP server task to the configuration task, told apart from
+ * client commands in the configuration queue by their address */
+extern char udp_server_lease_expired[];
+extern char udp_server_lease_renewed[];
+
 /*******************************************************************************
 * Function Prototypes
 ********************************************************************************/
 void udp_server_task(void *arg);
+void udp_server_set_sync_interval(uint32_t interval_ms);
+bool udp_server_host_time(uint64_t device_time, uint64_t *host_time);
+void udp_server_get_sync(radar_sync_t *sync);
+int32_t udp_server_set_fec(const radar_fec_config_t *config);
+void udp_server_get_fec(radar_fec_config_t *config);
+int32_t udp_server_set_resend(const radar_resend_config_t *config);
+void udp_server_get_resend(radar_resend_config_t *config);
+int32_t udp_server_set_transport(uint8_t mode);
+void udp_server_get_transport_stats(udp_server_transport_stats_t *stats);
+uint32_t udp_server_get_tcp_fill(void);
+int32_t udp_server_start_link_test(const radar_link_config_t *config);
+void udp_server_stop_link_test(void);
+int32_t udp_server_set_multicast(const udp_server_multicast_t *config);
+void udp_server_get_multicast(udp_server_multicast_t *config);
+int32_t udp_server_set_lease(const udp_server_lease_t *config);
+void udp_server_get_lease(udp_server_lease_t *config);
+int32_t udp_server_set_backlog_rate(uint16_t rate);
+uint16_t udp_server_get_backlog_rate(void);
 
 #endif /* UDP_SERVER_H_ */
 
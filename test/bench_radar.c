@@ -0,0 +1,81 @@
+/*****************************************************************************
+ * File name: bench_radar.c
+ *
+ * Description: This file contains the host driver of the kernel benchmark: it
+ * runs the benchmark of radar_bench.c a number of times and prints the json
+ * records, one per line, for scripts/bench_compare.py.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Header file for local module */
+#include "radar_bench.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Runs of the complete benchmark, the comparison keeps the fastest */
+#define BENCH_DEFAULT_RUNS      (5)
+
+/*******************************************************************************
+ * Function Name: print_record
+ *******************************************************************************
+ * Summary:
+ *   Benchmark report callback, prints a record on a line of its own.
+ *
+ * Parameters:
+ *   record : json record
+ *   length : length of the record
+ *   arg    : unused
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void print_record(const char *record, uint32_t length, void *arg)
+{
+    (void)arg;
+
+    printf("%.*s\n", (int)length, record);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Runs the benchmark, the optional argument is the number of runs.
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    const int runs = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_RUNS;
+
+    for (int run = 0; run < runs; ++run)
+    {
+        (void)radar_bench_run(print_record, NULL);
+    }
+
+    return 0;
+}
+
+/* [] END OF FILE */
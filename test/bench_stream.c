@@ -0,0 +1,505 @@
+/*****************************************************************************
+ * File name: bench_stream.c
+ *
+ * Description: This file contains the host measurement of the frame
+ * transports over the loopback interface: frame datagrams streamed over TCP,
+ * length-prefixed and coalesced into segments as the UDP server task writes
+ * them, against the same datagrams sent one by one over UDP.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+
+/* Header file from system */
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+/* Header file for local module */
+#include "radar_stream.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Frames sent per transport and datagram size */
+#define BENCH_DEFAULT_FRAMES    (20000u)
+
+/* Segment the datagrams are coalesced into, RADAR_MEMORY_TCP_SEGMENT_SIZE of
+ * the firmware */
+#define BENCH_SEGMENT_SIZE      (1460u)
+
+/* Largest datagram measured and the receive buffer of the TCP client */
+#define BENCH_MAX_DATAGRAM      (16384u)
+#define BENCH_RECEIVE_SIZE      (65536u)
+
+/* The UDP receiver stops once no datagram came for this long */
+#define BENCH_UDP_IDLE_MS       (200u)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    int socket;
+    struct sockaddr_in address;     /* UDP destination */
+    uint32_t size;                  /* datagram size */
+    uint32_t frames;                /* frames to send */
+    uint32_t received;              /* frames received, UDP */
+    double last;                    /* time of the last frame received, UDP */
+} bench_transport_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Datagram sizes measured, from a small frame to the largest one of the
+ * default profile */
+static const uint32_t bench_sizes[] = { 64u, 512u, 1460u, 4096u, BENCH_MAX_DATAGRAM };
+
+static uint8_t bench_datagram[BENCH_MAX_DATAGRAM];
+
+/*******************************************************************************
+ * Function Name: seconds_now
+ *******************************************************************************
+ * Summary:
+ *   Reads the monotonic clock.
+ *
+ * Return:
+ *   time in seconds
+ ******************************************************************************/
+static double seconds_now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+}
+
+/*******************************************************************************
+ * Function Name: send_all
+ *******************************************************************************
+ * Summary:
+ *   Writes bytes to a TCP socket, as flush_tcp_frames() does.
+ *
+ * Parameters:
+ *   socket : connected socket
+ *   data   : bytes to write
+ *   length : number of bytes
+ *
+ * Return:
+ *   0 on success, -1 if the connection failed
+ ******************************************************************************/
+static int send_all(int socket, const uint8_t *data, uint32_t length)
+{
+    uint32_t offset = 0;
+
+    while (offset < length)
+    {
+        const ssize_t sent = send(socket, &data[offset], length - offset, 0);
+
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        offset += (uint32_t)sent;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+ * Function Name: tcp_sender
+ *******************************************************************************
+ * Summary:
+ *   Sender thread of the TCP stream: collects the datagrams with
+ *   radar_stream until a segment is full and writes it at once.
+ *
+ * Parameters:
+ *   arg : bench_transport_t of the measurement
+ *
+ * Return:
+ *   NULL
+ ******************************************************************************/
+static void *tcp_sender(void *arg)
+{
+    bench_transport_t *transport = (bench_transport_t *)arg;
+    uint8_t *buffer = malloc(RADAR_STREAM_BUFFER_SIZE(BENCH_SEGMENT_SIZE, BENCH_MAX_DATAGRAM));
+    radar_stream_t stream;
+    int result = (buffer != NULL) ? 0 : -1;
+
+    if (buffer != NULL)
+    {
+        radar_stream_init(&stream, buffer, BENCH_SEGMENT_SIZE, BENCH_MAX_DATAGRAM);
+    }
+
+    for (uint32_t frame = 0; (frame < transport->frames) && (result == 0); ++frame)
+    {
+        (void)radar_stream_add(&stream, bench_datagram, transport->size);
+        if (radar_stream_is_full(&stream) || (frame == (transport->frames - 1u)))
+        {
+            result = send_all(transport->socket, buffer, stream.length);
+            radar_stream_clear(&stream);
+        }
+    }
+
+    (void)shutdown(transport->socket, SHUT_WR);
+    free(buffer);
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: open_tcp_pair
+ *******************************************************************************
+ * Summary:
+ *   Connects a TCP client to a server socket on the loopback interface and
+ *   disables Nagle's algorithm on the accepted socket, as the UDP server task
+ *   does.
+ *
+ * Parameters:
+ *   client   : output, client socket
+ *   accepted : output, accepted socket of the server
+ *
+ * Return:
+ *   0 on success, -1 if a socket failed; the sockets opened are returned in
+ *   either case, -1 otherwise
+ ******************************************************************************/
+static int open_tcp_pair(int *client, int *accepted)
+{
+    struct sockaddr_in address;
+    socklen_t address_length = sizeof(address);
+    const int one = 1;
+    const int server = socket(AF_INET, SOCK_STREAM, 0);
+    int result = -1;
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    *client = socket(AF_INET, SOCK_STREAM, 0);
+    *accepted = -1;
+    if ((server >= 0) && (*client >= 0) &&
+        (bind(server, (struct sockaddr *)&address, sizeof(address)) == 0) && (listen(server, 1) == 0) &&
+        (getsockname(server, (struct sockaddr *)&address, &address_length) == 0) &&
+        (connect(*client, (struct sockaddr *)&address, sizeof(address)) == 0))
+    {
+        *accepted = accept(server, NULL, NULL);
+        if ((*accepted >= 0) && (setsockopt(*accepted, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) == 0))
+        {
+            result = 0;
+        }
+    }
+
+    if (server >= 0)
+    {
+        (void)close(server);
+    }
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: receive_tcp
+ *******************************************************************************
+ * Summary:
+ *   Reads the stream until the sender closes it and splits it into the frame
+ *   datagrams as the client does.
+ *
+ * Parameters:
+ *   client : connected client socket
+ *   buffer : BENCH_RECEIVE_SIZE + RADAR_STREAM_LENGTH_SIZE + BENCH_MAX_DATAGRAM bytes
+ *   size   : datagram size sent
+ *
+ * Return:
+ *   frames received with the size sent
+ ******************************************************************************/
+static uint32_t receive_tcp(int client, uint8_t *buffer, uint32_t size)
+{
+    uint32_t received = 0;
+    uint32_t length = 0;
+    ssize_t bytes;
+
+    while ((bytes = recv(client, &buffer[length], BENCH_RECEIVE_SIZE, 0)) > 0)
+    {
+        const uint8_t *datagram;
+        uint32_t datagram_length;
+        uint32_t offset = 0;
+        uint32_t taken;
+
+        length += (uint32_t)bytes;
+        while ((taken = radar_stream_next(&buffer[offset], length - offset, &datagram, &datagram_length)) != 0)
+        {
+            if (datagram_length == size)
+            {
+                received++;
+            }
+            offset += taken;
+        }
+        memmove(buffer, &buffer[offset], length - offset);
+        length -= offset;
+    }
+
+    return received;
+}
+
+/*******************************************************************************
+ * Function Name: measure_tcp
+ *******************************************************************************
+ * Summary:
+ *   Streams the frames over a TCP connection on the loopback interface.
+ *
+ * Parameters:
+ *   size     : datagram size
+ *   frames   : frames to send
+ *   received : output, frames received
+ *
+ * Return:
+ *   seconds from the first frame sent to the last one received, negative if
+ *   the connection failed
+ ******************************************************************************/
+static double measure_tcp(uint32_t size, uint32_t frames, uint32_t *received)
+{
+    uint8_t *buffer = malloc(BENCH_RECEIVE_SIZE + RADAR_STREAM_LENGTH_SIZE + BENCH_MAX_DATAGRAM);
+    bench_transport_t transport;
+    pthread_t thread;
+    int client;
+    double start;
+    double seconds = -1.0;
+
+    *received = 0;
+    memset(&transport, 0, sizeof(transport));
+    transport.size = size;
+    transport.frames = frames;
+
+    if ((open_tcp_pair(&client, &transport.socket) == 0) && (buffer != NULL))
+    {
+        start = seconds_now();
+        if (pthread_create(&thread, NULL, tcp_sender, &transport) == 0)
+        {
+            *received = receive_tcp(client, buffer, size);
+            seconds = seconds_now() - start;
+            (void)pthread_join(thread, NULL);
+        }
+    }
+
+    if (transport.socket >= 0)
+    {
+        (void)close(transport.socket);
+    }
+    if (client >= 0)
+    {
+        (void)close(client);
+    }
+    free(buffer);
+    return seconds;
+}
+
+/*******************************************************************************
+ * Function Name: udp_receiver
+ *******************************************************************************
+ * Summary:
+ *   Receiver thread of the UDP datagrams, stops once none came for
+ *   BENCH_UDP_IDLE_MS.
+ *
+ * Parameters:
+ *   arg : bench_transport_t of the measurement
+ *
+ * Return:
+ *   NULL
+ ******************************************************************************/
+static void *udp_receiver(void *arg)
+{
+    bench_transport_t *transport = (bench_transport_t *)arg;
+    static uint8_t buffer[BENCH_MAX_DATAGRAM];
+
+    for (;;)
+    {
+        const ssize_t bytes = recv(transport->socket, buffer, sizeof(buffer), 0);
+
+        if (bytes < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        if ((uint32_t)bytes == transport->size)
+        {
+            transport->received++;
+            transport->last = seconds_now();
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: measure_udp
+ *******************************************************************************
+ * Summary:
+ *   Sends the frames as one UDP datagram each on the loopback interface, as
+ *   send_udp_frame() does. Datagrams the receiver falls behind on are lost.
+ *
+ * Parameters:
+ *   size     : datagram size
+ *   frames   : frames to send
+ *   received : output, frames received
+ *
+ * Return:
+ *   seconds from the first frame sent to the last one received, negative if
+ *   the sockets failed
+ ******************************************************************************/
+static double measure_udp(uint32_t size, uint32_t frames, uint32_t *received)
+{
+    struct sockaddr_in address;
+    socklen_t address_length = sizeof(address);
+    const struct timeval idle = { 0, (suseconds_t)BENCH_UDP_IDLE_MS * 1000 };
+    bench_transport_t transport;
+    pthread_t thread;
+    int sender;
+    double start;
+    double seconds = -1.0;
+
+    *received = 0;
+    memset(&transport, 0, sizeof(transport));
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    transport.socket = socket(AF_INET, SOCK_DGRAM, 0);
+    transport.size = size;
+    sender = socket(AF_INET, SOCK_DGRAM, 0);
+    if ((transport.socket >= 0) && (sender >= 0) &&
+        (bind(transport.socket, (struct sockaddr *)&address, sizeof(address)) == 0) &&
+        (getsockname(transport.socket, (struct sockaddr *)&address, &address_length) == 0) &&
+        (setsockopt(transport.socket, SOL_SOCKET, SO_RCVTIMEO, &idle, sizeof(idle)) == 0))
+    {
+        start = seconds_now();
+        if (pthread_create(&thread, NULL, udp_receiver, &transport) == 0)
+        {
+            for (uint32_t frame = 0; frame < frames; ++frame)
+            {
+                (void)sendto(sender, bench_datagram, size, 0, (struct sockaddr *)&address, sizeof(address));
+            }
+            (void)pthread_join(thread, NULL);
+
+            *received = transport.received;
+            seconds = (transport.received != 0) ? (transport.last - start) : 0.0;
+        }
+    }
+
+    if (transport.socket >= 0)
+    {
+        (void)close(transport.socket);
+    }
+    if (sender >= 0)
+    {
+        (void)close(sender);
+    }
+    return seconds;
+}
+
+/*******************************************************************************
+ * Function Name: print_result
+ *******************************************************************************
+ * Summary:
+ *   Prints the result of a measurement as a json record on a line of its own.
+ *
+ * Parameters:
+ *   transport : name of the transport
+ *   size      : datagram size
+ *   frames    : frames sent
+ *   received  : frames received
+ *   seconds   : time taken
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void print_result(const char *transport, uint32_t size, uint32_t frames, uint32_t received, double seconds)
+{
+    const double frames_per_s = (seconds > 0.0) ? ((double)received / seconds) : 0.0;
+
+    printf("{\"transport\":\"%s\",\"size\":%" PRIu32 ",\"frames\":%" PRIu32 ",\"received\":%" PRIu32
+           ",\"seconds\":%.4f,\"frames_per_s\":%.0f,\"mbit_per_s\":%.1f}\n",
+           transport, size, frames, received, seconds, frames_per_s, (frames_per_s * (double)size * 8.0) / 1e6);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Measures both transports for every datagram size, the optional argument
+ *   is the number of frames sent per measurement.
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    const uint32_t frames = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_FRAMES;
+    int result = 0;
+
+    for (uint32_t i = 0; i < sizeof(bench_datagram); ++i)
+    {
+        bench_datagram[i] = (uint8_t)i;
+    }
+
+    for (uint32_t i = 0; i < (sizeof(bench_sizes) / sizeof(bench_sizes[0])); ++i)
+    {
+        uint32_t received;
+        double seconds;
+
+        seconds = measure_tcp(bench_sizes[i], frames, &received);
+        if (seconds < 0.0)
+        {
+            printf("TCP loopback connection failed\n");
+            result = 1;
+        }
+        else
+        {
+            print_result("tcp", bench_sizes[i], frames, received, seconds);
+        }
+
+        seconds = measure_udp(bench_sizes[i], frames, &received);
+        if (seconds < 0.0)
+        {
+            printf("UDP loopback sockets failed\n");
+            result = 1;
+        }
+        else
+        {
+            print_result("udp", bench_sizes[i], frames, received, seconds);
+        }
+    }
+
+    return result;
+}
+
+/* [] END OF FILE */
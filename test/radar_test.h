@@ -0,0 +1,80 @@
+/******************************************************************************
+ * File Name:   radar_test.h
+ *
+ * Description: This file contains the checks shared by the host unit tests
+ *   of the radar modules.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef RADAR_TEST_H_
+#define RADAR_TEST_H_
+
+#include <math.h>
+#include <stdio.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Checks report the failed condition with its location and let the test go
+ * on, the test binary exits with the number of failed checks */
+#define TEST_CHECK(condition)                                                   \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            radar_test_failures++;                                              \
+        }                                                                       \
+    } while (0)
+
+#define TEST_CHECK_NEAR(value, expected, tolerance)                             \
+    do                                                                          \
+    {                                                                           \
+        const double test_value_ = (double)(value);                             \
+        const double test_expected_ = (double)(expected);                       \
+        if (!(fabs(test_value_ - test_expected_) <= (double)(tolerance)))       \
+        {                                                                       \
+            printf("%s:%d: check failed: %s = %g, expected %g +- %g\n", __FILE__, \
+                   __LINE__, #value, test_value_, test_expected_, (double)(tolerance)); \
+            radar_test_failures++;                                              \
+        }                                                                       \
+    } while (0)
+
+/* Runs one test function and names it in the output */
+#define TEST_RUN(test)                                                          \
+    do                                                                          \
+    {                                                                           \
+        const int test_failures_ = radar_test_failures;                         \
+        test();                                                                 \
+        printf("%s %s\n", (radar_test_failures == test_failures_) ? "pass" : "FAIL", #test); \
+    } while (0)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Defined once per test binary with RADAR_TEST_MAIN */
+extern int radar_test_failures;
+
+#define RADAR_TEST_MAIN int radar_test_failures = 0
+
+#endif /* RADAR_TEST_H_ */
+/* [] END OF FILE */
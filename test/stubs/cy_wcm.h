@@ -0,0 +1,97 @@
+/******************************************************************************
+ * File Name:   cy_wcm.h
+ *
+ * Description: Host stand-in for the parts of the Wi-Fi connection manager
+ *   header used by the radar modules under test. The tests define the
+ *   functions.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+
+#ifndef CY_WCM_H_
+#define CY_WCM_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define CY_RSLT_SUCCESS                     ((cy_rslt_t)0x00000000U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef uint32_t cy_rslt_t;
+
+typedef enum
+{
+    CY_WCM_INTERFACE_TYPE_STA = 0,
+    CY_WCM_INTERFACE_TYPE_AP,
+    CY_WCM_INTERFACE_TYPE_AP_STA
+} cy_wcm_interface_t;
+
+typedef enum
+{
+    CY_WCM_IP_VER_V4 = 4,
+    CY_WCM_IP_VER_V6 = 6
+} cy_wcm_ip_version_t;
+
+typedef struct
+{
+    cy_wcm_ip_version_t version;
+    union
+    {
+        uint32_t v4;
+        uint32_t v6[4];
+    } ip;
+} cy_wcm_ip_address_t;
+
+typedef struct
+{
+    struct
+    {
+        uint8_t SSID[33];
+        uint8_t password[64];
+        uint32_t security;
+    } ap_credentials;
+} cy_wcm_connect_params_t;
+
+typedef enum
+{
+    CY_WCM_EVENT_CONNECTING = 0,
+    CY_WCM_EVENT_CONNECTED,
+    CY_WCM_EVENT_CONNECT_FAILED,
+    CY_WCM_EVENT_RECONNECTED,
+    CY_WCM_EVENT_DISCONNECTED,
+    CY_WCM_EVENT_IP_CHANGED,
+    CY_WCM_EVENT_INITIATED_RETRY
+} cy_wcm_event_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+cy_rslt_t cy_wcm_connect_ap(cy_wcm_connect_params_t *connect_params, cy_wcm_ip_address_t *ip_addr);
+uint8_t cy_wcm_is_connected_to_ap(void);
+cy_rslt_t cy_wcm_get_ip_addr(cy_wcm_interface_t interface_type, cy_wcm_ip_address_t *ip_addr);
+
+#endif /* CY_WCM_H_ */
+/* [] END OF FILE */
@@ -0,0 +1,53 @@
+/******************************************************************************
+ * File Name:   xensiv_bgt60trxx.h
+ *
+ * Description: Host stand-in for the parts of the XENSIV BGT60TRxx driver header
+ *   used by the radar modules under test.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#ifndef XENSIV_BGT60TRXX_H_
+#define XENSIV_BGT60TRXX_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define XENSIV_BGT60TRXX_INITIAL_TEST_WORD          (0x0001U)
+
+#define XENSIV_BGT60TRXX_REG_FSTAT_FOF_ERR_MSK      (0x00200000UL)
+#define XENSIV_BGT60TRXX_REG_FSTAT_FUF_ERR_MSK      (0x00080000UL)
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+/* 12-bit LFSR of the sensor test mode */
+static inline uint16_t xensiv_bgt60trxx_get_next_test_word(uint16_t test_word)
+{
+    test_word = (uint16_t)(((test_word << 1) | (((test_word >> 11) ^ (test_word >> 10) ^
+                                                 (test_word >> 7) ^ (test_word >> 4)) & 1U)) & 0x0FFFU);
+    return test_word;
+}
+
+#endif /* XENSIV_BGT60TRXX_H_ */
+/* [] END OF FILE */
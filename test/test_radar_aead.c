@@ -0,0 +1,336 @@
+/*****************************************************************************
+ * File name: test_radar_aead.c
+ *
+ * Description: This file contains the host unit tests of the frame datagram
+ * encryption: sealed datagrams open with the key, a changed tag, payload or
+ * header is rejected, a frame number is sealed once per salt and a new salt
+ * starts over after the frame numbers wrap.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <stdio.h>
+#include <string.h>
+
+/* Header file from library */
+#include "mbedtls/gcm.h"
+
+/* Header file for local module */
+#include "radar_aead.h"
+#include "radar_frame.h"
+#include "radar_test.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_KEY                ("000102030405060708090a0b0c0d0e0f")
+#define TEST_PAYLOAD_SIZE       (64u)
+#define TEST_LENGTH             (RADAR_FRAME_HEADER_SIZE + TEST_PAYLOAD_SIZE)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static const uint8_t test_key[RADAR_AEAD_KEY_SIZE] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const uint8_t test_salt[RADAR_AEAD_SALT_SIZE] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+static const uint8_t test_new_salt[RADAR_AEAD_SALT_SIZE] = { 8, 7, 6, 5, 4, 3, 2, 1 };
+
+static radar_aead_t test_aead;
+static uint8_t test_datagram[TEST_LENGTH + RADAR_AEAD_OVERHEAD];
+static uint8_t test_plain[TEST_LENGTH];
+
+/*******************************************************************************
+ * Function Name: make_datagram
+ *******************************************************************************
+ * Summary:
+ *   Writes a frame datagram with a payload depending on the frame number and
+ *   keeps a copy of it in test_plain.
+ *
+ * Parameters:
+ *   frame_num : frame number of the header
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void make_datagram(uint32_t frame_num)
+{
+    memset(test_datagram, 0, sizeof(test_datagram));
+    test_datagram[RADAR_FRAME_HDR_CMD] = RADAR_DATA_COMMAND;
+    test_datagram[RADAR_FRAME_HDR_SEQUENCE] = (uint8_t)frame_num;
+    radar_frame_put_u32(&test_datagram[RADAR_FRAME_HDR_FRAME_NUM], frame_num);
+    for (uint32_t i = 0; i < TEST_PAYLOAD_SIZE; ++i)
+    {
+        test_datagram[RADAR_FRAME_HEADER_SIZE + i] = (uint8_t)((i * 7u) + frame_num);
+    }
+    memcpy(test_plain, test_datagram, TEST_LENGTH);
+}
+
+/*******************************************************************************
+ * Function Name: open_datagram
+ *******************************************************************************
+ * Summary:
+ *   Opens a sealed datagram the way the client does: the nonce is the salt
+ *   after the payload and the frame number, the header is authenticated.
+ *   The payload is decrypted in place if the tag matches.
+ *
+ * Parameters:
+ *   datagram : sealed datagram
+ *   length   : size of the sealed datagram
+ *
+ * Return:
+ *   true if the tag matches
+ ******************************************************************************/
+static bool open_datagram(uint8_t *datagram, uint32_t length)
+{
+    const uint32_t payload_size = length - RADAR_FRAME_HEADER_SIZE - RADAR_AEAD_OVERHEAD;
+    const uint8_t *salt = &datagram[RADAR_FRAME_HEADER_SIZE + payload_size];
+    uint8_t nonce[RADAR_AEAD_NONCE_SIZE];
+    mbedtls_gcm_context gcm;
+    int result;
+
+    memcpy(nonce, salt, RADAR_AEAD_SALT_SIZE);
+    memcpy(&nonce[RADAR_AEAD_SALT_SIZE], &datagram[RADAR_FRAME_HDR_FRAME_NUM], 4u);
+
+    mbedtls_gcm_init(&gcm);
+    (void)mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, test_key, RADAR_AEAD_KEY_SIZE * 8u);
+    result = mbedtls_gcm_auth_decrypt(&gcm, payload_size, nonce, sizeof(nonce), datagram, RADAR_FRAME_HEADER_SIZE,
+                                      &salt[RADAR_AEAD_SALT_SIZE], RADAR_AEAD_TAG_SIZE,
+                                      &datagram[RADAR_FRAME_HEADER_SIZE], &datagram[RADAR_FRAME_HEADER_SIZE]);
+    mbedtls_gcm_free(&gcm);
+
+    return result == 0;
+}
+
+/*******************************************************************************
+ * Function Name: seal_copy
+ *******************************************************************************
+ * Summary:
+ *   Seals the datagram of a frame number and returns a copy to tamper with.
+ *
+ * Parameters:
+ *   frame_num : frame number of the header
+ *   copy      : destination of the sealed datagram
+ *
+ * Return:
+ *   size of the sealed datagram
+ ******************************************************************************/
+static uint32_t seal_copy(uint32_t frame_num, uint8_t *copy)
+{
+    uint32_t length;
+
+    make_datagram(frame_num);
+    length = radar_aead_seal(&test_aead, test_datagram, TEST_LENGTH);
+    memcpy(copy, test_datagram, sizeof(test_datagram));
+
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: test_keys
+ *******************************************************************************
+ * Summary:
+ *   An empty key disables the encryption, a malformed key is refused and no
+ *   datagram is sealed before a salt is set.
+ ******************************************************************************/
+static void test_keys(void)
+{
+    TEST_CHECK(radar_aead_init(&test_aead, ""));
+    TEST_CHECK(!test_aead.enabled);
+    TEST_CHECK(!radar_aead_init(&test_aead, "000102030405060708090a0b0c0d0e"));
+    TEST_CHECK(!radar_aead_init(&test_aead, "000102030405060708090a0b0c0d0e0g"));
+    TEST_CHECK(!test_aead.enabled);
+
+    TEST_CHECK(radar_aead_init(&test_aead, "000102030405060708090A0B0C0D0E0F"));
+    TEST_CHECK(test_aead.enabled);
+    make_datagram(0);
+    TEST_CHECK(radar_aead_seal(&test_aead, test_datagram, TEST_LENGTH) == 0);
+    TEST_CHECK(memcmp(test_datagram, test_plain, TEST_LENGTH) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: test_round_trip
+ *******************************************************************************
+ * Summary:
+ *   A sealed datagram carries the header in plaintext with the sealed flag,
+ *   the encrypted payload, the salt and the tag, and opens to the original
+ *   payload.
+ ******************************************************************************/
+static void test_round_trip(void)
+{
+    uint32_t length;
+
+    TEST_CHECK(radar_aead_init(&test_aead, TEST_KEY));
+    radar_aead_set_salt(&test_aead, test_salt);
+    make_datagram(5);
+
+    length = radar_aead_seal(&test_aead, test_datagram, TEST_LENGTH);
+    TEST_CHECK(length == (TEST_LENGTH + RADAR_AEAD_OVERHEAD));
+    TEST_CHECK((test_datagram[RADAR_FRAME_HDR_FLAGS] & RADAR_FRAME_FLAG_SEALED) != 0);
+    TEST_CHECK(radar_frame_get_u32(&test_datagram[RADAR_FRAME_HDR_FRAME_NUM]) == 5u);
+    TEST_CHECK(memcmp(&test_datagram[RADAR_FRAME_HEADER_SIZE], &test_plain[RADAR_FRAME_HEADER_SIZE],
+                      TEST_PAYLOAD_SIZE) != 0);
+    TEST_CHECK(memcmp(&test_datagram[TEST_LENGTH], test_salt, RADAR_AEAD_SALT_SIZE) == 0);
+
+    TEST_CHECK(open_datagram(test_datagram, length));
+    TEST_CHECK(memcmp(&test_datagram[RADAR_FRAME_HEADER_SIZE], &test_plain[RADAR_FRAME_HEADER_SIZE],
+                      TEST_PAYLOAD_SIZE) == 0);
+    TEST_CHECK(test_aead.next_frame_num == 6u);
+}
+
+/*******************************************************************************
+ * Function Name: test_tag_tamper
+ *******************************************************************************
+ * Summary:
+ *   A changed bit of the tag or of the encrypted payload is rejected.
+ ******************************************************************************/
+static void test_tag_tamper(void)
+{
+    uint8_t sealed[sizeof(test_datagram)];
+    uint32_t length;
+
+    TEST_CHECK(radar_aead_init(&test_aead, TEST_KEY));
+    radar_aead_set_salt(&test_aead, test_salt);
+
+    length = seal_copy(1, sealed);
+    sealed[length - 1u] ^= 0x01u;
+    TEST_CHECK(!open_datagram(sealed, length));
+
+    length = seal_copy(2, sealed);
+    sealed[RADAR_FRAME_HEADER_SIZE + 3u] ^= 0x80u;
+    TEST_CHECK(!open_datagram(sealed, length));
+
+    length = seal_copy(3, sealed);
+    TEST_CHECK(open_datagram(sealed, length));
+}
+
+/*******************************************************************************
+ * Function Name: test_header_tamper
+ *******************************************************************************
+ * Summary:
+ *   The header is authenticated as additional data: a changed sequence
+ *   number, frame number or flag is rejected, as is a changed salt.
+ ******************************************************************************/
+static void test_header_tamper(void)
+{
+    uint8_t sealed[sizeof(test_datagram)];
+    uint32_t length;
+
+    TEST_CHECK(radar_aead_init(&test_aead, TEST_KEY));
+    radar_aead_set_salt(&test_aead, test_salt);
+
+    length = seal_copy(10, sealed);
+    sealed[RADAR_FRAME_HDR_SEQUENCE] ^= 0x01u;
+    TEST_CHECK(!open_datagram(sealed, length));
+
+    length = seal_copy(11, sealed);
+    radar_frame_put_u32(&sealed[RADAR_FRAME_HDR_FRAME_NUM], 12u);
+    TEST_CHECK(!open_datagram(sealed, length));
+
+    length = seal_copy(13, sealed);
+    sealed[RADAR_FRAME_HDR_FLAGS] &= (uint8_t)~RADAR_FRAME_FLAG_SEALED;
+    TEST_CHECK(!open_datagram(sealed, length));
+
+    length = seal_copy(14, sealed);
+    sealed[TEST_LENGTH] ^= 0x01u;
+    TEST_CHECK(!open_datagram(sealed, length));
+}
+
+/*******************************************************************************
+ * Function Name: test_frame_num_once
+ *******************************************************************************
+ * Summary:
+ *   A frame number below next_frame_num is refused and the datagram left as
+ *   it is, a nonce is never used twice under one salt.
+ ******************************************************************************/
+static void test_frame_num_once(void)
+{
+    TEST_CHECK(radar_aead_init(&test_aead, TEST_KEY));
+    radar_aead_set_salt(&test_aead, test_salt);
+
+    make_datagram(20);
+    TEST_CHECK(radar_aead_seal(&test_aead, test_datagram, TEST_LENGTH) != 0);
+
+    make_datagram(20);
+    TEST_CHECK(radar_aead_seal(&test_aead, test_datagram, TEST_LENGTH) == 0);
+    TEST_CHECK(memcmp(test_datagram, test_plain, TEST_LENGTH) == 0);
+    make_datagram(19);
+    TEST_CHECK(radar_aead_seal(&test_aead, test_datagram, TEST_LENGTH) == 0);
+    TEST_CHECK(test_aead.next_frame_num == 21u);
+
+    /* Frame numbers may skip ahead */
+    make_datagram(30);
+    TEST_CHECK(radar_aead_seal(&test_aead, test_datagram, TEST_LENGTH) != 0);
+    TEST_CHECK(test_aead.next_frame_num == 31u);
+}
+
+/*******************************************************************************
+ * Function Name: test_resalt_on_wrap
+ *******************************************************************************
+ * Summary:
+ *   After the last frame number no frame is sealed under the salt. A new
+ *   salt starts over at frame number 0 with nonces never used before.
+ ******************************************************************************/
+static void test_resalt_on_wrap(void)
+{
+    uint8_t before[sizeof(test_datagram)];
+    uint32_t length;
+
+    TEST_CHECK(radar_aead_init(&test_aead, TEST_KEY));
+    radar_aead_set_salt(&test_aead, test_salt);
+
+    length = seal_copy(0, before);
+    TEST_CHECK(length != 0);
+    TEST_CHECK(seal_copy(UINT32_MAX, test_datagram) != 0);
+    TEST_CHECK(test_aead.next_frame_num == ((uint64_t)UINT32_MAX + 1u));
+    make_datagram(0);
+    TEST_CHECK(radar_aead_seal(&test_aead, test_datagram, TEST_LENGTH) == 0);
+
+    /* What the UDP server does when a seal is refused */
+    radar_aead_set_salt(&test_aead, test_new_salt);
+    make_datagram(0);
+    TEST_CHECK(radar_aead_seal(&test_aead, test_datagram, TEST_LENGTH) == length);
+    TEST_CHECK(memcmp(&test_datagram[TEST_LENGTH], test_new_salt, RADAR_AEAD_SALT_SIZE) == 0);
+    TEST_CHECK(memcmp(&test_datagram[RADAR_FRAME_HEADER_SIZE], &before[RADAR_FRAME_HEADER_SIZE],
+                      TEST_PAYLOAD_SIZE) != 0);
+    TEST_CHECK(open_datagram(test_datagram, length));
+    TEST_CHECK(open_datagram(before, length));
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_keys);
+    TEST_RUN(test_round_trip);
+    TEST_RUN(test_tag_tamper);
+    TEST_RUN(test_header_tamper);
+    TEST_RUN(test_frame_num_once);
+    TEST_RUN(test_resalt_on_wrap);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,311 @@
+/*****************************************************************************
+ * File name: test_radar_aoa.c
+ *
+ * Description: This file contains the host unit tests of the angle of arrival
+ * estimation: targets with known azimuth and elevation simulated in the
+ * antennas of a frame, and frames without the antennas of a pair.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+#include <stdio.h>
+
+/* Header file for local module */
+#include "radar_aoa.h"
+#include "radar_cfar.h"
+#include "radar_range_doppler.h"
+#include "radar_test.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_PI                 (3.14159265358979323846)
+
+#define TEST_SAMPLES            (64u)
+#define TEST_CHIRPS             (16u)
+#define TEST_ANTENNAS           (3u)
+
+/* Largest error of an estimated angle, 0.01 degrees */
+#define TEST_ANGLE_TOLERANCE    (50)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t range_bin;
+    int32_t doppler_bin;
+    double azimuth;             /* degrees */
+    double elevation;           /* degrees */
+} test_target_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static const test_target_t test_scene[] = {
+    { .range_bin = 10, .doppler_bin = 2,  .azimuth = 20.0,  .elevation = -10.0 },
+    { .range_bin = 24, .doppler_bin = -3, .azimuth = -45.0, .elevation = 30.0 },
+    { .range_bin = 17, .doppler_bin = 0,  .azimuth = 0.0,   .elevation = 60.0 },
+};
+
+static const radar_cfar_config_t test_config = {
+    .guard_cells = RADAR_CFAR_DEFAULT_GUARD_CELLS,
+    .training_cells = RADAR_CFAR_DEFAULT_TRAINING_CELLS,
+    .threshold_db = RADAR_CFAR_DEFAULT_THRESHOLD_DB
+};
+
+static uint16_t test_frame[TEST_SAMPLES * TEST_CHIRPS * TEST_ANTENNAS];
+static float test_rd_memory[RADAR_RD_MEMORY_SIZE(TEST_SAMPLES, TEST_CHIRPS, TEST_ANTENNAS)];
+static uint32_t test_rd_power[RADAR_RD_POWER_SIZE(TEST_SAMPLES, TEST_CHIRPS)];
+static radar_target_t test_targets[RADAR_CFAR_MAX_TARGETS];
+static radar_rd_t test_rd;
+static uint32_t test_random = 1;
+
+/*******************************************************************************
+ * Function Name: next_random
+ *******************************************************************************
+ * Summary:
+ *   Linear congruential generator, the tests see the same noise every run.
+ *
+ * Parameters:
+ *   range : number of values
+ *
+ * Return:
+ *   value from 0 to range - 1
+ ******************************************************************************/
+static uint32_t next_random(uint32_t range)
+{
+    test_random = (test_random * 1103515245u) + 12345u;
+    return (test_random >> 16) % range;
+}
+
+/*******************************************************************************
+ * Function Name: antenna_phase
+ *******************************************************************************
+ * Summary:
+ *   Phase of a target at a sensor antenna relative to the reference antenna,
+ *   the antennas of a pair are half a wavelength apart.
+ *
+ * Parameters:
+ *   target : target
+ *   rx     : sensor antenna
+ *
+ * Return:
+ *   phase in radians
+ ******************************************************************************/
+static double antenna_phase(const test_target_t *target, uint32_t rx)
+{
+    const double degree = TEST_PI / 180.0;
+
+    if (rx == RADAR_AOA_AZIMUTH_RX)
+    {
+        return TEST_PI * sin(target->azimuth * degree);
+    }
+    if (rx == RADAR_AOA_ELEVATION_RX)
+    {
+        return TEST_PI * sin(target->elevation * degree);
+    }
+    return 0.0;
+}
+
+/*******************************************************************************
+ * Function Name: detect_scene
+ *******************************************************************************
+ * Summary:
+ *   Simulates the test scene with noise of a few ADC counts in the antennas
+ *   of the mask, antenna after antenna as the range-Doppler map expects
+ *   them, detects the targets and estimates their angles.
+ *
+ * Parameters:
+ *   antenna_mask : sensor antennas in the frame
+ *
+ * Return:
+ *   number of targets in test_targets
+ ******************************************************************************/
+static uint32_t detect_scene(uint8_t antenna_mask)
+{
+    radar_geometry_t geometry = {
+        .samples_per_chirp = TEST_SAMPLES,
+        .chirps_per_frame = TEST_CHIRPS,
+        .rx_antennas = 0
+    };
+    uint16_t *sample = test_frame;
+    uint32_t num_targets;
+
+    test_random = 1;
+    for (uint32_t rx = 0; rx < TEST_ANTENNAS; ++rx)
+    {
+        if (((antenna_mask >> rx) & 1u) == 0)
+        {
+            continue;
+        }
+        geometry.rx_antennas++;
+
+        for (uint32_t chirp = 0; chirp < TEST_CHIRPS; ++chirp)
+        {
+            for (uint32_t s = 0; s < TEST_SAMPLES; ++s)
+            {
+                double value = 2048.0 + (double)next_random(9) - 4.0;
+
+                for (uint32_t i = 0; i < (sizeof(test_scene) / sizeof(test_scene[0])); ++i)
+                {
+                    const test_target_t *target = &test_scene[i];
+
+                    value += 300.0 * cos((2.0 * TEST_PI * ((((double)target->range_bin * s) / TEST_SAMPLES) +
+                                                           (((double)target->doppler_bin * chirp) / TEST_CHIRPS))) +
+                                         antenna_phase(target, rx));
+                }
+                *sample++ = (uint16_t)lround(value);
+            }
+        }
+    }
+
+    radar_rd_process(&test_rd, &geometry, test_frame);
+    num_targets = radar_cfar_detect(&test_config, radar_cfar_scale(test_config.threshold_db), test_rd.power,
+                                    test_rd.range_bins, test_rd.doppler_bins, test_targets, RADAR_CFAR_MAX_TARGETS);
+    radar_aoa_estimate(&test_rd, antenna_mask, test_targets, num_targets);
+
+    return num_targets;
+}
+
+/*******************************************************************************
+ * Function Name: find_target
+ *******************************************************************************
+ * Summary:
+ *   Looks up the detection of a scene target.
+ *
+ * Parameters:
+ *   num_targets : number of targets in test_targets
+ *   target      : scene target
+ *
+ * Return:
+ *   detection, NULL if the target was missed
+ ******************************************************************************/
+static const radar_target_t *find_target(uint32_t num_targets, const test_target_t *target)
+{
+    for (uint32_t i = 0; i < num_targets; ++i)
+    {
+        if ((test_targets[i].range_bin == target->range_bin) && (test_targets[i].doppler_bin == target->doppler_bin))
+        {
+            return &test_targets[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: test_all_antennas
+ *******************************************************************************
+ * Summary:
+ *   With all three antennas every target gets its azimuth and elevation.
+ ******************************************************************************/
+static void test_all_antennas(void)
+{
+    const uint32_t num_targets = detect_scene(0x7);
+
+    TEST_CHECK(num_targets == (sizeof(test_scene) / sizeof(test_scene[0])));
+
+    for (uint32_t i = 0; i < (sizeof(test_scene) / sizeof(test_scene[0])); ++i)
+    {
+        const radar_target_t *target = find_target(num_targets, &test_scene[i]);
+
+        TEST_CHECK(target != NULL);
+        if (target != NULL)
+        {
+            TEST_CHECK_NEAR(target->azimuth, test_scene[i].azimuth * 100.0, TEST_ANGLE_TOLERANCE);
+            TEST_CHECK_NEAR(target->elevation, test_scene[i].elevation * 100.0, TEST_ANGLE_TOLERANCE);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_azimuth_pair
+ *******************************************************************************
+ * Summary:
+ *   Without the elevation antenna only the azimuth is estimated, from the
+ *   antennas at their positions within the frame.
+ ******************************************************************************/
+static void test_azimuth_pair(void)
+{
+    const uint8_t mask = (1u << RADAR_AOA_AZIMUTH_RX) | (1u << RADAR_AOA_REFERENCE_RX);
+    const uint32_t num_targets = detect_scene(mask);
+
+    TEST_CHECK(num_targets == (sizeof(test_scene) / sizeof(test_scene[0])));
+
+    for (uint32_t i = 0; i < (sizeof(test_scene) / sizeof(test_scene[0])); ++i)
+    {
+        const radar_target_t *target = find_target(num_targets, &test_scene[i]);
+
+        TEST_CHECK(target != NULL);
+        if (target != NULL)
+        {
+            TEST_CHECK_NEAR(target->azimuth, test_scene[i].azimuth * 100.0, TEST_ANGLE_TOLERANCE);
+            TEST_CHECK(target->elevation == RADAR_TARGET_ANGLE_NONE);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_no_reference
+ *******************************************************************************
+ * Summary:
+ *   Without the reference antenna no angle is estimated.
+ ******************************************************************************/
+static void test_no_reference(void)
+{
+    const uint8_t mask = (1u << RADAR_AOA_AZIMUTH_RX) | (1u << RADAR_AOA_ELEVATION_RX);
+    const uint32_t num_targets = detect_scene(mask);
+
+    TEST_CHECK(num_targets == (sizeof(test_scene) / sizeof(test_scene[0])));
+
+    for (uint32_t i = 0; i < num_targets; ++i)
+    {
+        TEST_CHECK(test_targets[i].azimuth == RADAR_TARGET_ANGLE_NONE);
+        TEST_CHECK(test_targets[i].elevation == RADAR_TARGET_ANGLE_NONE);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    const radar_geometry_t max_geometry = {
+        .samples_per_chirp = TEST_SAMPLES,
+        .chirps_per_frame = TEST_CHIRPS,
+        .rx_antennas = TEST_ANTENNAS
+    };
+
+    radar_rd_init(&test_rd, test_rd_memory, test_rd_power, &max_geometry);
+
+    TEST_RUN(test_all_antennas);
+    TEST_RUN(test_azimuth_pair);
+    TEST_RUN(test_no_reference);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,376 @@
+/*****************************************************************************
+ * File name: test_radar_cfar.c
+ *
+ * Description: This file contains the host unit tests of the CFAR target
+ * detection: synthetic power maps with known targets, the detection
+ * threshold, the target list limit and layout, and targets simulated in the
+ * ADC samples of a frame through the range-Doppler map.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_cfar.h"
+#include "radar_range_doppler.h"
+#include "radar_test.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_PI                 (3.14159265358979323846)
+
+/* Power map of the detector tests */
+#define TEST_RANGE_BINS         (64u)
+#define TEST_DOPPLER_BINS       (16u)
+#define TEST_NOISE              (100u)
+
+/* Frame of the range-Doppler tests, one antenna */
+#define TEST_SAMPLES            (64u)
+#define TEST_CHIRPS             (16u)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Target in a frame: beat frequency and Doppler shift as bins */
+typedef struct
+{
+    uint32_t range_bin;
+    int32_t doppler_bin;
+    double amplitude;           /* ADC counts */
+} test_target_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static const radar_cfar_config_t test_config = {
+    .guard_cells = RADAR_CFAR_DEFAULT_GUARD_CELLS,
+    .training_cells = RADAR_CFAR_DEFAULT_TRAINING_CELLS,
+    .threshold_db = RADAR_CFAR_DEFAULT_THRESHOLD_DB
+};
+
+static uint32_t test_power[TEST_RANGE_BINS * TEST_DOPPLER_BINS];
+static radar_target_t test_targets[RADAR_CFAR_MAX_TARGETS];
+static uint32_t test_random = 1;
+
+static uint16_t test_frame[TEST_SAMPLES * TEST_CHIRPS];
+static float test_rd_memory[RADAR_RD_MEMORY_SIZE(TEST_SAMPLES, TEST_CHIRPS, 1u)];
+static uint32_t test_rd_power[RADAR_RD_POWER_SIZE(TEST_SAMPLES, TEST_CHIRPS)];
+
+/*******************************************************************************
+ * Function Name: next_random
+ *******************************************************************************
+ * Summary:
+ *   Linear congruential generator, the tests see the same noise every run.
+ *
+ * Parameters:
+ *   range : number of values
+ *
+ * Return:
+ *   value from 0 to range - 1
+ ******************************************************************************/
+static uint32_t next_random(uint32_t range)
+{
+    test_random = (test_random * 1103515245u) + 12345u;
+    return (test_random >> 16) % range;
+}
+
+/*******************************************************************************
+ * Function Name: fill_noise
+ *******************************************************************************
+ * Summary:
+ *   Fills the power map with noise from 0.8 to 1.2 times TEST_NOISE.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void fill_noise(void)
+{
+    test_random = 1;
+
+    for (uint32_t i = 0; i < (TEST_RANGE_BINS * TEST_DOPPLER_BINS); ++i)
+    {
+        test_power[i] = ((TEST_NOISE * 8u) / 10u) + next_random((TEST_NOISE * 4u) / 10u);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: power_cell
+ *******************************************************************************
+ * Summary:
+ *   Cell of the power map by range bin and signed Doppler bin.
+ ******************************************************************************/
+static uint32_t *power_cell(uint32_t range_bin, int32_t doppler_bin)
+{
+    const uint32_t row = (uint32_t)((doppler_bin + (int32_t)TEST_DOPPLER_BINS) % (int32_t)TEST_DOPPLER_BINS);
+
+    return &test_power[(row * TEST_RANGE_BINS) + range_bin];
+}
+
+/*******************************************************************************
+ * Function Name: find_target
+ *******************************************************************************
+ * Summary:
+ *   Looks up a detection in the target list.
+ *
+ * Parameters:
+ *   num_targets : number of targets in test_targets
+ *   range_bin   : range bin of the detection
+ *   doppler_bin : signed Doppler bin of the detection
+ *
+ * Return:
+ *   true if the list holds the detection
+ ******************************************************************************/
+static bool find_target(uint32_t num_targets, uint32_t range_bin, int32_t doppler_bin)
+{
+    for (uint32_t i = 0; i < num_targets; ++i)
+    {
+        if ((test_targets[i].range_bin == range_bin) && (test_targets[i].doppler_bin == doppler_bin))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: test_scale
+ *******************************************************************************
+ * Summary:
+ *   The threshold factor is the linear power ratio in Q8.
+ ******************************************************************************/
+static void test_scale(void)
+{
+    TEST_CHECK(radar_cfar_scale(0) == 256u);
+    TEST_CHECK(radar_cfar_scale(10) == 2560u);
+    TEST_CHECK(radar_cfar_scale(20) == 25600u);
+    TEST_CHECK_NEAR(radar_cfar_scale(3), 511, 1);
+    TEST_CHECK_NEAR(radar_cfar_scale(RADAR_CFAR_MAX_THRESHOLD_DB), 256000, 1);
+}
+
+/*******************************************************************************
+ * Function Name: test_noise_only
+ *******************************************************************************
+ * Summary:
+ *   Noise does not reach the default threshold anywhere, including the
+ *   cells at the ends of the rows.
+ ******************************************************************************/
+static void test_noise_only(void)
+{
+    fill_noise();
+    TEST_CHECK(radar_cfar_detect(&test_config, radar_cfar_scale(test_config.threshold_db), test_power,
+                                 TEST_RANGE_BINS, TEST_DOPPLER_BINS, test_targets, RADAR_CFAR_MAX_TARGETS) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: test_targets_in_map
+ *******************************************************************************
+ * Summary:
+ *   Targets 20 dB above the noise are found at their range and signed
+ *   Doppler bins, also at the first and last range bin, and nothing else.
+ ******************************************************************************/
+static void test_targets_in_map(void)
+{
+    uint32_t num_targets;
+
+    fill_noise();
+    *power_cell(10, 0) = 100u * TEST_NOISE;
+    *power_cell(40, 3) = 100u * TEST_NOISE;
+    *power_cell(41, 3) = 30u * TEST_NOISE;      /* range sidelobe of the same target */
+    *power_cell(25, -2) = 100u * TEST_NOISE;
+    *power_cell(0, 5) = 100u * TEST_NOISE;
+    *power_cell(TEST_RANGE_BINS - 1u, -8) = 100u * TEST_NOISE;
+
+    num_targets = radar_cfar_detect(&test_config, radar_cfar_scale(test_config.threshold_db), test_power,
+                                    TEST_RANGE_BINS, TEST_DOPPLER_BINS, test_targets, RADAR_CFAR_MAX_TARGETS);
+
+    TEST_CHECK(num_targets == 5);
+    TEST_CHECK(find_target(num_targets, 10, 0));
+    TEST_CHECK(find_target(num_targets, 40, 3));
+    TEST_CHECK(find_target(num_targets, 25, -2));
+    TEST_CHECK(find_target(num_targets, 0, 5));
+    TEST_CHECK(find_target(num_targets, TEST_RANGE_BINS - 1u, -8));
+
+    for (uint32_t i = 0; i < num_targets; ++i)
+    {
+        TEST_CHECK(test_targets[i].power == (100u * TEST_NOISE));
+        TEST_CHECK(test_targets[i].azimuth == RADAR_TARGET_ANGLE_NONE);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_threshold
+ *******************************************************************************
+ * Summary:
+ *   A target 8 dB above the noise is missed at 12 dB and found at 3 dB.
+ ******************************************************************************/
+static void test_threshold(void)
+{
+    radar_cfar_config_t config = test_config;
+
+    fill_noise();
+    *power_cell(30, 1) = (63u * TEST_NOISE) / 10u;
+
+    TEST_CHECK(radar_cfar_detect(&config, radar_cfar_scale(config.threshold_db), test_power,
+                                 TEST_RANGE_BINS, TEST_DOPPLER_BINS, test_targets, RADAR_CFAR_MAX_TARGETS) == 0);
+
+    config.threshold_db = 3;
+    TEST_CHECK(radar_cfar_detect(&config, radar_cfar_scale(config.threshold_db), test_power,
+                                 TEST_RANGE_BINS, TEST_DOPPLER_BINS, test_targets, RADAR_CFAR_MAX_TARGETS) == 1);
+    TEST_CHECK(find_target(1, 30, 1));
+}
+
+/*******************************************************************************
+ * Function Name: test_max_targets
+ *******************************************************************************
+ * Summary:
+ *   A full target list keeps the strongest targets.
+ ******************************************************************************/
+static void test_max_targets(void)
+{
+    uint32_t num_targets;
+
+    fill_noise();
+    /* One target per Doppler row, apart from each other's training cells */
+    for (uint32_t i = 0; i < 6u; ++i)
+    {
+        *power_cell(30, (int32_t)(2u * i)) = (50u + (10u * i)) * TEST_NOISE;
+    }
+
+    num_targets = radar_cfar_detect(&test_config, radar_cfar_scale(test_config.threshold_db), test_power,
+                                    TEST_RANGE_BINS, TEST_DOPPLER_BINS, test_targets, 3);
+
+    TEST_CHECK(num_targets == 3);
+    TEST_CHECK(find_target(num_targets, 30, 6));
+    TEST_CHECK(find_target(num_targets, 30, -8));
+    TEST_CHECK(find_target(num_targets, 30, -6));
+
+    TEST_CHECK(radar_cfar_detect(&test_config, radar_cfar_scale(test_config.threshold_db), test_power,
+                                 TEST_RANGE_BINS, TEST_DOPPLER_BINS, test_targets, 0) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: test_write_targets
+ *******************************************************************************
+ * Summary:
+ *   The target list is encoded little endian with signed Doppler and angles.
+ ******************************************************************************/
+static void test_write_targets(void)
+{
+    const radar_target_t target = {
+        .range_bin = 0x0102,
+        .doppler_bin = -3,
+        .power = 0x0A0B0C0D,
+        .azimuth = -1234,
+        .elevation = RADAR_TARGET_ANGLE_NONE
+    };
+    const uint8_t expected[RADAR_TARGETS_SIZE(1)] = {
+        0x01, 0x00, 6, 4,
+        0x02, 0x01, 0xFD, 0xFF, 0x0D, 0x0C, 0x0B, 0x0A, 0x2E, 0xFB, 0x00, 0x80
+    };
+    uint8_t data[RADAR_TARGETS_SIZE(1)];
+
+    TEST_CHECK(radar_cfar_write_targets(data, &target, 1, 6, 4) == sizeof(data));
+    TEST_CHECK(memcmp(data, expected, sizeof(data)) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: test_frame_targets
+ *******************************************************************************
+ * Summary:
+ *   Targets simulated in the ADC samples of a frame, with noise of a few
+ *   counts, are found at their range and Doppler bins after the
+ *   range-Doppler map.
+ ******************************************************************************/
+static void test_frame_targets(void)
+{
+    const test_target_t targets[] = {
+        { .range_bin = 8,  .doppler_bin = 3,  .amplitude = 200.0 },
+        { .range_bin = 20, .doppler_bin = -4, .amplitude = 100.0 },
+        { .range_bin = 27, .doppler_bin = 0,  .amplitude = 50.0 },
+    };
+    const uint32_t num_expected = sizeof(targets) / sizeof(targets[0]);
+    const radar_geometry_t geometry = {
+        .samples_per_chirp = TEST_SAMPLES,
+        .chirps_per_frame = TEST_CHIRPS,
+        .rx_antennas = 1
+    };
+    radar_rd_t rd;
+    uint32_t num_targets;
+
+    test_random = 7;
+    for (uint32_t chirp = 0; chirp < TEST_CHIRPS; ++chirp)
+    {
+        for (uint32_t sample = 0; sample < TEST_SAMPLES; ++sample)
+        {
+            double value = 2048.0 + (double)next_random(9) - 4.0;
+
+            for (uint32_t i = 0; i < num_expected; ++i)
+            {
+                value += targets[i].amplitude *
+                         cos(2.0 * TEST_PI * ((((double)targets[i].range_bin * sample) / TEST_SAMPLES) +
+                                              (((double)targets[i].doppler_bin * chirp) / TEST_CHIRPS)));
+            }
+            test_frame[(chirp * TEST_SAMPLES) + sample] = (uint16_t)lround(value);
+        }
+    }
+
+    radar_rd_init(&rd, test_rd_memory, test_rd_power, &geometry);
+    TEST_CHECK(radar_rd_is_valid(&rd, &geometry));
+    radar_rd_process(&rd, &geometry, test_frame);
+
+    num_targets = radar_cfar_detect(&test_config, radar_cfar_scale(test_config.threshold_db), rd.power,
+                                    rd.range_bins, rd.doppler_bins, test_targets, RADAR_CFAR_MAX_TARGETS);
+
+    TEST_CHECK(num_targets == num_expected);
+    for (uint32_t i = 0; i < num_expected; ++i)
+    {
+        TEST_CHECK(find_target(num_targets, targets[i].range_bin, targets[i].doppler_bin));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_scale);
+    TEST_RUN(test_noise_only);
+    TEST_RUN(test_targets_in_map);
+    TEST_RUN(test_threshold);
+    TEST_RUN(test_max_targets);
+    TEST_RUN(test_write_targets);
+    TEST_RUN(test_frame_targets);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
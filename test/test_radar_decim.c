@@ -0,0 +1,346 @@
+/*****************************************************************************
+ * File name: test_radar_decim.c
+ *
+ * Description: This file contains the host unit tests of the polyphase FIR
+ * decimation: DC gain, passband and stopband response for every factor,
+ * antenna separation, and a timing of the decimation per input sample.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+/* Header file for local module */
+#include "radar_decim.h"
+#include "radar_test.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_PI                 (3.14159265358979323846)
+
+/* Geometry of the response measurements */
+#define TEST_SAMPLES            (512u)
+#define TEST_ANTENNAS           (2u)
+
+/* Tone around the ADC mid-scale */
+#define TEST_OFFSET             (2048.0)
+#define TEST_AMPLITUDE          (1000.0)
+
+/* Output samples at both ends of a chirp left out of a measurement, they see
+ * the edge extension */
+#define TEST_EDGE               (16u)
+
+/* Limits of the response, frequencies relative to the Nyquist frequency of
+ * the decimated signal */
+#define TEST_PASSBAND_DB        (0.5)
+#define TEST_STOPBAND_DB        (-30.0)
+
+/* Geometry and repetitions of the timing */
+#define BENCH_SAMPLES           (128u)
+#define BENCH_CHIRPS            (64u)
+#define BENCH_ANTENNAS          (3u)
+#define BENCH_RUNS              (200u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static const uint8_t test_factors[] = { 2, 4, 8 };
+
+static uint16_t test_frame[BENCH_SAMPLES * BENCH_CHIRPS * BENCH_ANTENNAS];
+static uint16_t test_scratch[RADAR_DECIM_SCRATCH_SIZE(TEST_SAMPLES, BENCH_ANTENNAS)];
+
+/*******************************************************************************
+ * Function Name: fill_tone
+ *******************************************************************************
+ * Summary:
+ *   Writes a tone to one antenna of a single chirp frame.
+ *
+ * Parameters:
+ *   rx        : antenna
+ *   frequency : cycles per input sample, 0 for a constant
+ *   amplitude : amplitude around TEST_OFFSET
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void fill_tone(uint32_t rx, double frequency, double amplitude)
+{
+    for (uint32_t sample = 0; sample < TEST_SAMPLES; ++sample)
+    {
+        const double value = TEST_OFFSET + (amplitude * cos(2.0 * TEST_PI * frequency * sample));
+
+        test_frame[(sample * TEST_ANTENNAS) + rx] = (uint16_t)lround(value);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: ac_rms
+ *******************************************************************************
+ * Summary:
+ *   RMS of one antenna of a single chirp frame around its mean, without
+ *   TEST_EDGE samples at both ends.
+ *
+ * Parameters:
+ *   samples : number of samples per antenna
+ *   rx      : antenna
+ *
+ * Return:
+ *   RMS value
+ ******************************************************************************/
+static double ac_rms(uint32_t samples, uint32_t rx)
+{
+    const uint32_t count = samples - (2u * TEST_EDGE);
+    double mean = 0.0;
+    double power = 0.0;
+
+    for (uint32_t sample = TEST_EDGE; sample < (samples - TEST_EDGE); ++sample)
+    {
+        mean += test_frame[(sample * TEST_ANTENNAS) + rx];
+    }
+    mean /= count;
+
+    for (uint32_t sample = TEST_EDGE; sample < (samples - TEST_EDGE); ++sample)
+    {
+        const double value = test_frame[(sample * TEST_ANTENNAS) + rx] - mean;
+
+        power += value * value;
+    }
+
+    return sqrt(power / count);
+}
+
+/*******************************************************************************
+ * Function Name: gain_db
+ *******************************************************************************
+ * Summary:
+ *   Gain of the decimation for a tone on antenna 1, antenna 2 is constant.
+ *
+ * Parameters:
+ *   factor   : decimation factor
+ *   relative : frequency of the tone relative to the Nyquist frequency of the
+ *              decimated signal
+ *
+ * Return:
+ *   gain in dB
+ ******************************************************************************/
+static double gain_db(uint8_t factor, double relative)
+{
+    const radar_geometry_t geometry = {
+        .samples_per_chirp = TEST_SAMPLES,
+        .chirps_per_frame = 1,
+        .rx_antennas = TEST_ANTENNAS
+    };
+    double rms_in;
+
+    fill_tone(0, relative / (2.0 * factor), TEST_AMPLITUDE);
+    fill_tone(1, 0.0, 0.0);
+    rms_in = ac_rms(TEST_SAMPLES, 0);
+
+    radar_decim_frame(factor, &geometry, test_frame, test_scratch);
+
+    return 20.0 * log10(ac_rms(TEST_SAMPLES / factor, 0) / rms_in);
+}
+
+/*******************************************************************************
+ * Function Name: test_dc_gain
+ *******************************************************************************
+ * Summary:
+ *   A constant passes unchanged, also at the ends of the chirp.
+ ******************************************************************************/
+static void test_dc_gain(void)
+{
+    const radar_geometry_t geometry = {
+        .samples_per_chirp = TEST_SAMPLES,
+        .chirps_per_frame = 1,
+        .rx_antennas = TEST_ANTENNAS
+    };
+    const uint16_t levels[] = { 0, 1000, 2048, RADAR_DECIM_SAMPLE_MAX };
+
+    for (uint32_t f = 0; f < sizeof(test_factors); ++f)
+    {
+        for (uint32_t l = 0; l < (sizeof(levels) / sizeof(levels[0])); ++l)
+        {
+            for (uint32_t i = 0; i < (TEST_SAMPLES * TEST_ANTENNAS); ++i)
+            {
+                test_frame[i] = levels[l];
+            }
+
+            radar_decim_frame(test_factors[f], &geometry, test_frame, test_scratch);
+
+            for (uint32_t i = 0; i < ((TEST_SAMPLES / test_factors[f]) * TEST_ANTENNAS); ++i)
+            {
+                TEST_CHECK_NEAR(test_frame[i], levels[l], 1);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_passband
+ *******************************************************************************
+ * Summary:
+ *   Tones from 10 % to 40 % of the decimated Nyquist frequency keep their
+ *   level, lower tones have too few periods in a chirp to measure.
+ ******************************************************************************/
+static void test_passband(void)
+{
+    const double relative[] = { 0.1, 0.2, 0.4 };
+
+    for (uint32_t f = 0; f < sizeof(test_factors); ++f)
+    {
+        for (uint32_t r = 0; r < (sizeof(relative) / sizeof(relative[0])); ++r)
+        {
+            TEST_CHECK_NEAR(gain_db(test_factors[f], relative[r]), 0.0, TEST_PASSBAND_DB);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_stopband
+ *******************************************************************************
+ * Summary:
+ *   Tones that would alias into the decimated signal are suppressed.
+ ******************************************************************************/
+static void test_stopband(void)
+{
+    const double relative[] = { 1.3, 1.6, 1.9 };
+
+    for (uint32_t f = 0; f < sizeof(test_factors); ++f)
+    {
+        for (uint32_t r = 0; r < (sizeof(relative) / sizeof(relative[0])); ++r)
+        {
+            TEST_CHECK(gain_db(test_factors[f], relative[r]) < TEST_STOPBAND_DB);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_antennas
+ *******************************************************************************
+ * Summary:
+ *   Antennas are filtered separately: a tone on one does not leak into the
+ *   constant of the other.
+ ******************************************************************************/
+static void test_antennas(void)
+{
+    for (uint32_t f = 0; f < sizeof(test_factors); ++f)
+    {
+        (void)gain_db(test_factors[f], 0.2);
+
+        for (uint32_t sample = 0; sample < (TEST_SAMPLES / test_factors[f]); ++sample)
+        {
+            TEST_CHECK_NEAR(test_frame[(sample * TEST_ANTENNAS) + 1u], TEST_OFFSET, 1);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Only the supported factors that divide the chirp are accepted.
+ ******************************************************************************/
+static void test_is_valid(void)
+{
+    radar_geometry_t geometry = {
+        .samples_per_chirp = 128,
+        .chirps_per_frame = 16,
+        .rx_antennas = 3
+    };
+    radar_geometry_t decimated;
+
+    TEST_CHECK(radar_decim_is_valid(1, &geometry));
+    TEST_CHECK(radar_decim_is_valid(2, &geometry));
+    TEST_CHECK(radar_decim_is_valid(8, &geometry));
+    TEST_CHECK(!radar_decim_is_valid(3, &geometry));
+    TEST_CHECK(!radar_decim_is_valid(16, &geometry));
+
+    geometry.samples_per_chirp = 100;
+    TEST_CHECK(radar_decim_is_valid(4, &geometry));
+    TEST_CHECK(!radar_decim_is_valid(8, &geometry));
+
+    radar_decim_geometry(4, &geometry, &decimated);
+    TEST_CHECK(decimated.samples_per_chirp == 25);
+    TEST_CHECK(decimated.chirps_per_frame == 16);
+    TEST_CHECK(decimated.rx_antennas == 3);
+}
+
+/*******************************************************************************
+ * Function Name: bench_decim
+ *******************************************************************************
+ * Summary:
+ *   Shows the time per input sample of every factor on a full frame. The
+ *   frame is refilled before every run, the refill is not timed.
+ ******************************************************************************/
+static void bench_decim(void)
+{
+    const radar_geometry_t geometry = {
+        .samples_per_chirp = BENCH_SAMPLES,
+        .chirps_per_frame = BENCH_CHIRPS,
+        .rx_antennas = BENCH_ANTENNAS
+    };
+    const uint32_t num_samples = BENCH_SAMPLES * BENCH_CHIRPS * BENCH_ANTENNAS;
+
+    for (uint32_t f = 0; f < sizeof(test_factors); ++f)
+    {
+        clock_t elapsed = 0;
+
+        for (uint32_t run = 0; run < BENCH_RUNS; ++run)
+        {
+            clock_t start;
+
+            for (uint32_t i = 0; i < num_samples; ++i)
+            {
+                test_frame[i] = (uint16_t)((i * 37u) & RADAR_DECIM_SAMPLE_MAX);
+            }
+
+            start = clock();
+            radar_decim_frame(test_factors[f], &geometry, test_frame, test_scratch);
+            elapsed += clock() - start;
+        }
+
+        printf("decim%u: %.2f ns per input sample\n", test_factors[f],
+               (1e9 * elapsed) / ((double)CLOCKS_PER_SEC * BENCH_RUNS * num_samples));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_dc_gain);
+    TEST_RUN(test_passband);
+    TEST_RUN(test_stopband);
+    TEST_RUN(test_antennas);
+    TEST_RUN(test_is_valid);
+    bench_decim();
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
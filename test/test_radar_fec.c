@@ -0,0 +1,505 @@
+/*****************************************************************************
+ * File name: test_radar_fec.c
+ *
+ * Description: This file contains the host unit tests of the parity encoder:
+ * frame datagrams are sent through a channel that drops them on purpose and
+ * rebuilt from the parity datagrams the way the host client does.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <stdio.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_fec.h"
+#include "radar_frame.h"
+#include "radar_test.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_MAX_DATAGRAM       (200u)
+
+/* Datagrams sent by the longest test */
+#define TEST_MAX_SENT           (1600u)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t data[TEST_MAX_DATAGRAM];
+    uint32_t length;
+    bool received;
+} test_datagram_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static uint8_t test_memory[RADAR_FEC_MEMORY_SIZE(TEST_MAX_DATAGRAM)];
+static radar_fec_t test_fec;
+static test_datagram_t test_sent[TEST_MAX_SENT];
+static uint32_t test_num_sent;
+static uint32_t test_recovered;
+static uint32_t test_random = 1;
+
+/*******************************************************************************
+ * Function Name: next_random
+ *******************************************************************************
+ * Summary:
+ *   Linear congruential generator, the tests see the same losses every run.
+ *
+ * Parameters:
+ *   range : number of values
+ *
+ * Return:
+ *   value from 0 to range - 1
+ ******************************************************************************/
+static uint32_t next_random(uint32_t range)
+{
+    test_random = (test_random * 1103515245u) + 12345u;
+    return (test_random >> 16) % range;
+}
+
+/*******************************************************************************
+ * Function Name: start
+ *******************************************************************************
+ * Summary:
+ *   Starts the encoder with new settings and forgets the datagrams sent.
+ *
+ * Parameters:
+ *   group_size   : data datagrams per group
+ *   parity_count : parity datagrams per group
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void start(uint8_t group_size, uint8_t parity_count)
+{
+    const radar_fec_config_t config = { .group_size = group_size, .parity_count = parity_count };
+
+    TEST_CHECK(radar_fec_config_is_valid(&config));
+    radar_fec_init(&test_fec, test_memory, TEST_MAX_DATAGRAM, &config);
+    test_num_sent = 0;
+    test_recovered = 0;
+    test_random = 1;
+}
+
+/*******************************************************************************
+ * Function Name: find_sent
+ *******************************************************************************
+ * Summary:
+ *   Looks up a sent datagram by its frame number.
+ *
+ * Parameters:
+ *   frame : frame number
+ *
+ * Return:
+ *   datagram or NULL if it was not sent
+ ******************************************************************************/
+static test_datagram_t *find_sent(uint32_t frame)
+{
+    for (uint32_t i = 0; i < test_num_sent; ++i)
+    {
+        if (radar_frame_get_u32(&test_sent[i].data[RADAR_FRAME_HDR_FRAME_NUM]) == frame)
+        {
+            return &test_sent[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: receive_parity
+ *******************************************************************************
+ * Summary:
+ *   Rebuilds a lost datagram from a parity datagram like FecDecoder of
+ *   udp_client_radar.py: if exactly one of the covered datagrams is missing,
+ *   it is the XOR of the payload with all others, each prefixed with its
+ *   size. The rebuilt datagram has to match the one sent bit for bit.
+ *
+ * Parameters:
+ *   data   : parity datagram
+ *   length : size of the parity datagram
+ *
+ * Return:
+ *   true if a datagram was rebuilt
+ ******************************************************************************/
+static bool receive_parity(const uint8_t *data, uint32_t length)
+{
+    const uint32_t base = radar_frame_get_u32(&data[2]);
+    const uint32_t count = data[6];
+    const uint32_t parity_count = data[7];
+    const uint32_t index = data[8];
+    const uint32_t payload_size = data[9] | ((uint32_t)data[10] << 8);
+    const uint32_t header_size = length - payload_size;
+    uint8_t payload[2u + TEST_MAX_DATAGRAM];
+    test_datagram_t *missing = NULL;
+    uint32_t num_missing = 0;
+    uint32_t rebuilt_length;
+
+    TEST_CHECK(data[0] == RADAR_FEC_COMMAND);
+    TEST_CHECK(payload_size <= sizeof(payload));
+    memcpy(payload, &data[header_size], payload_size);
+
+    for (uint32_t position = index; position < count; position += parity_count)
+    {
+        const uint32_t offset = data[RADAR_FEC_HDR_OFFSETS + (2u * position)] |
+                                ((uint32_t)data[RADAR_FEC_HDR_OFFSETS + (2u * position) + 1u] << 8);
+        test_datagram_t *datagram = find_sent(base + offset);
+        uint8_t size[2];
+
+        TEST_CHECK((offset != RADAR_FEC_OFFSET_UNUSED) && (datagram != NULL));
+        if (datagram == NULL)
+        {
+            return false;
+        }
+        if (!datagram->received)
+        {
+            missing = datagram;
+            num_missing++;
+            continue;
+        }
+
+        radar_frame_put_u16(size, (uint16_t)datagram->length);
+        for (uint32_t i = 0; i < datagram->length; ++i)
+        {
+            payload[2u + i] ^= datagram->data[i];
+        }
+        payload[0] ^= size[0];
+        payload[1] ^= size[1];
+    }
+
+    /* Positions behind the group are unused */
+    for (uint32_t position = count; position < ((header_size - RADAR_FEC_HDR_OFFSETS) / 2u); ++position)
+    {
+        TEST_CHECK((data[RADAR_FEC_HDR_OFFSETS + (2u * position)] == 0xFF) &&
+                   (data[RADAR_FEC_HDR_OFFSETS + (2u * position) + 1u] == 0xFF));
+    }
+
+    if (num_missing != 1u)
+    {
+        return false;
+    }
+
+    rebuilt_length = payload[0] | ((uint32_t)payload[1] << 8);
+    TEST_CHECK(rebuilt_length == missing->length);
+    TEST_CHECK(memcmp(&payload[2], missing->data, missing->length) == 0);
+    for (uint32_t i = 2u + missing->length; i < payload_size; ++i)
+    {
+        TEST_CHECK(payload[i] == 0);
+    }
+    missing->received = true;
+    test_recovered++;
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: send_parity
+ *******************************************************************************
+ * Summary:
+ *   Sends the parity datagrams of the current group through the channel.
+ *
+ * Parameters:
+ *   loss : one parity datagram in loss is dropped, 0 for none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void send_parity(uint32_t loss)
+{
+    for (uint32_t i = 0; i < test_fec.config.parity_count; ++i)
+    {
+        const uint8_t *parity;
+        const uint32_t length = radar_fec_write_parity(&test_fec, i, &parity);
+
+        TEST_CHECK(length > RADAR_FEC_HEADER_SIZE(test_fec.config.group_size));
+        if ((loss == 0) || (next_random(loss) != 0))
+        {
+            (void)receive_parity(parity, length);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: send
+ *******************************************************************************
+ * Summary:
+ *   Sends a frame datagram of random size and content through the channel
+ *   and the parity datagrams once its group is complete.
+ *
+ * Parameters:
+ *   frame    : frame number
+ *   received : false if the channel drops it
+ *   loss     : one parity datagram in loss is dropped, 0 for none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void send(uint32_t frame, bool received, uint32_t loss)
+{
+    test_datagram_t *datagram = &test_sent[test_num_sent++];
+
+    datagram->length = RADAR_FRAME_HEADER_SIZE + next_random(TEST_MAX_DATAGRAM - RADAR_FRAME_HEADER_SIZE + 1u);
+    for (uint32_t i = 0; i < datagram->length; ++i)
+    {
+        datagram->data[i] = (uint8_t)next_random(256);
+    }
+    datagram->data[RADAR_FRAME_HDR_CMD] = RADAR_DATA_COMMAND;
+    radar_frame_put_u32(&datagram->data[RADAR_FRAME_HDR_FRAME_NUM], frame);
+    datagram->received = received;
+
+    if (radar_fec_add(&test_fec, datagram->data, datagram->length))
+    {
+        send_parity(loss);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: all_received
+ *******************************************************************************
+ * Summary:
+ *   Checks whether every datagram sent arrived or was rebuilt.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true if none is missing
+ ******************************************************************************/
+static bool all_received(void)
+{
+    for (uint32_t i = 0; i < test_num_sent; ++i)
+    {
+        if (!test_sent[i].received)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: test_config_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Groups of 2 to 16 datagrams with 1 to 4 parity datagrams, or none.
+ ******************************************************************************/
+static void test_config_is_valid(void)
+{
+    radar_fec_config_t config = { .group_size = 0, .parity_count = 0 };
+
+    TEST_CHECK(radar_fec_config_is_valid(&config));
+    config.group_size = 1;
+    config.parity_count = 1;
+    TEST_CHECK(!radar_fec_config_is_valid(&config));
+    config.group_size = RADAR_FEC_MAX_GROUP;
+    config.parity_count = RADAR_FEC_MAX_PARITY;
+    TEST_CHECK(radar_fec_config_is_valid(&config));
+    config.group_size = RADAR_FEC_MAX_GROUP + 1u;
+    TEST_CHECK(!radar_fec_config_is_valid(&config));
+    config.group_size = 2;
+    config.parity_count = 3;
+    TEST_CHECK(!radar_fec_config_is_valid(&config));
+    config.parity_count = 0;
+    TEST_CHECK(!radar_fec_config_is_valid(&config));
+}
+
+/*******************************************************************************
+ * Function Name: test_single_loss
+ *******************************************************************************
+ * Summary:
+ *   One parity datagram rebuilds a lost datagram at any position of the
+ *   group, and nothing when none is lost.
+ ******************************************************************************/
+static void test_single_loss(void)
+{
+    start(8, 1);
+    for (uint32_t frame = 0; frame < 8u; ++frame)
+    {
+        send(frame, true, 0);
+    }
+    TEST_CHECK(test_recovered == 0);
+
+    for (uint32_t lost = 0; lost < 8u; ++lost)
+    {
+        for (uint32_t position = 0; position < 8u; ++position)
+        {
+            send(8u + (lost * 8u) + position, position != lost, 0);
+        }
+    }
+    TEST_CHECK(test_recovered == 8u);
+    TEST_CHECK(all_received());
+}
+
+/*******************************************************************************
+ * Function Name: test_burst_loss
+ *******************************************************************************
+ * Summary:
+ *   With 3 parity datagrams any burst of 3 lost datagrams is rebuilt, of a
+ *   burst of 4 the two covered by the same parity datagram are not.
+ ******************************************************************************/
+static void test_burst_loss(void)
+{
+    start(12, 3);
+    for (uint32_t first = 0; first <= 9u; ++first)
+    {
+        for (uint32_t position = 0; position < 12u; ++position)
+        {
+            send((first * 12u) + position, (position < first) || (position >= (first + 3u)), 0);
+        }
+    }
+    TEST_CHECK(test_recovered == 30u);
+    TEST_CHECK(all_received());
+
+    start(12, 3);
+    for (uint32_t position = 0; position < 12u; ++position)
+    {
+        send(position, (position < 4u) || (position >= 8u), 0);
+    }
+    TEST_CHECK(test_recovered == 2u);
+    TEST_CHECK(!find_sent(4)->received && !find_sent(7)->received);
+}
+
+/*******************************************************************************
+ * Function Name: test_random_loss
+ *******************************************************************************
+ * Summary:
+ *   With 10 percent of the frame and parity datagrams dropped at random, a
+ *   lost datagram is rebuilt when the other 3 datagrams of its parity
+ *   datagram and the parity datagram arrive: 0.9^4, about two thirds of the
+ *   losses, each bit for bit.
+ ******************************************************************************/
+static void test_random_loss(void)
+{
+    uint32_t lost = 0;
+
+    start(8, 2);
+    for (uint32_t frame = 0; frame < TEST_MAX_SENT; ++frame)
+    {
+        const bool received = (next_random(10) != 0);
+
+        lost += received ? 0u : 1u;
+        send(frame, received, 10);
+    }
+
+    TEST_CHECK_NEAR(lost, TEST_MAX_SENT / 10u, TEST_MAX_SENT / 40u);
+    TEST_CHECK_NEAR((double)test_recovered / (double)lost, 0.9 * 0.9 * 0.9 * 0.9, 0.1);
+}
+
+/*******************************************************************************
+ * Function Name: test_partial_group
+ *******************************************************************************
+ * Summary:
+ *   The parity of a group cut short lists only the datagrams sent so far
+ *   and still rebuilds them.
+ ******************************************************************************/
+static void test_partial_group(void)
+{
+    const uint8_t *parity;
+
+    start(8, 2);
+    TEST_CHECK(radar_fec_write_parity(&test_fec, 0, &parity) == 0);
+
+    for (uint32_t position = 0; position < 5u; ++position)
+    {
+        send(100u + position, position != 3u, 0);
+    }
+    TEST_CHECK(radar_fec_write_parity(&test_fec, 2, &parity) == 0);
+    send_parity(0);
+    TEST_CHECK(test_fec.count == 5u);
+    TEST_CHECK(test_recovered == 1u);
+    TEST_CHECK(all_received());
+}
+
+/*******************************************************************************
+ * Function Name: test_frame_gap
+ *******************************************************************************
+ * Summary:
+ *   Frame numbers of a group may skip frames that were not sent. A frame
+ *   too far from the start of the group to be listed starts a new group.
+ ******************************************************************************/
+static void test_frame_gap(void)
+{
+    static const uint32_t frames[] = { 10, 11, 15, 40, 41, 1000 };
+
+    start(6, 1);
+    for (uint32_t i = 0; i < (sizeof(frames) / sizeof(frames[0])); ++i)
+    {
+        send(frames[i], i != 2u, 0);
+    }
+    TEST_CHECK(test_recovered == 1u);
+    TEST_CHECK(all_received());
+
+    start(6, 1);
+    send(0, true, 0);
+    send(1, true, 0);
+    send(RADAR_FEC_OFFSET_UNUSED, true, 0);
+    TEST_CHECK((test_fec.count == 1u) && (test_fec.base_frame == RADAR_FEC_OFFSET_UNUSED));
+}
+
+/*******************************************************************************
+ * Function Name: test_ignored
+ *******************************************************************************
+ * Summary:
+ *   Datagrams shorter than a frame header or longer than the parity memory
+ *   holds are left out, and nothing is added while the parity is off.
+ ******************************************************************************/
+static void test_ignored(void)
+{
+    const radar_fec_config_t off = { .group_size = 0, .parity_count = 0 };
+    uint8_t datagram[TEST_MAX_DATAGRAM + 1u] = { 0 };
+    const uint8_t *parity;
+
+    start(4, 1);
+    TEST_CHECK(!radar_fec_add(&test_fec, datagram, RADAR_FRAME_HEADER_SIZE - 1u));
+    TEST_CHECK(!radar_fec_add(&test_fec, datagram, sizeof(datagram)));
+    TEST_CHECK(test_fec.count == 0);
+
+    radar_fec_configure(&test_fec, &off);
+    TEST_CHECK(!radar_fec_add(&test_fec, datagram, RADAR_FRAME_HEADER_SIZE));
+    TEST_CHECK(radar_fec_write_parity(&test_fec, 0, &parity) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_config_is_valid);
+    TEST_RUN(test_single_loss);
+    TEST_RUN(test_burst_loss);
+    TEST_RUN(test_random_loss);
+    TEST_RUN(test_partial_group);
+    TEST_RUN(test_frame_gap);
+    TEST_RUN(test_ignored);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
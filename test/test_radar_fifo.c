@@ -0,0 +1,317 @@
+/*****************************************************************************
+ * File name: test_radar_fifo.c
+ *
+ * Description: This file contains the host unit tests of the FIFO
+ * supervision: a simulated sensor fills a FIFO of a few frames on a fixed
+ * frame grid while the reader stalls now and then, overflows are recovered
+ * and the frames read after a recovery keep the numbers of their sensor
+ * frames.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <stdio.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_fifo.h"
+#include "radar_test.h"
+#include "xensiv_bgt60trxx.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_PERIOD_US          (10000u)
+
+/* Interrupt times scatter by up to a tenth of the period around the grid */
+#define TEST_JITTER_US          (1000u)
+
+/* Frames the FIFO holds, more overflow it */
+#define TEST_FIFO_FRAMES        (3u)
+
+/* Reader time per frame, and one read in TEST_STALL_CHANCE stalls for up to
+ * TEST_STALL_PERIODS frame periods */
+#define TEST_PROCESS_US         (TEST_PERIOD_US / 2u)
+#define TEST_STALL_CHANCE       (40u)
+#define TEST_STALL_PERIODS      (8u)
+
+/* Time from the FIFO reset to the sensor frames starting again */
+#define TEST_RESTART_US         (15000u)
+
+/* Frames read by the simulation */
+#define TEST_FRAMES             (5000u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static radar_fifo_t test_fifo;
+static uint32_t test_random = 1;
+
+/*******************************************************************************
+ * Function Name: next_random
+ *******************************************************************************
+ * Summary:
+ *   Linear congruential generator, the tests see the same stalls every run.
+ *
+ * Parameters:
+ *   range : number of values
+ *
+ * Return:
+ *   value from 0 to range - 1
+ ******************************************************************************/
+static uint32_t next_random(uint32_t range)
+{
+    test_random = (test_random * 1103515245u) + 12345u;
+    return (test_random >> 16) % range;
+}
+
+/*******************************************************************************
+ * Function Name: frame_time
+ *******************************************************************************
+ * Summary:
+ *   Device time of the FIFO interrupt of a sensor frame: the frame grid plus
+ *   a jitter that only depends on the frame.
+ *
+ * Parameters:
+ *   frame : sensor frame
+ *
+ * Return:
+ *   time in microseconds
+ ******************************************************************************/
+static uint64_t frame_time(uint32_t frame)
+{
+    const uint32_t jitter = ((frame * 2654435761u) >> 16) % ((2u * TEST_JITTER_US) + 1u);
+
+    return ((uint64_t)(frame + 1u) * TEST_PERIOD_US) + jitter - TEST_JITTER_US;
+}
+
+/*******************************************************************************
+ * Function Name: test_classify
+ *******************************************************************************
+ * Summary:
+ *   The FIFO status names the error, an overflow before an underflow, and
+ *   without an error flag the reason of the caller is taken.
+ ******************************************************************************/
+static void test_classify(void)
+{
+    TEST_CHECK(radar_fifo_classify(XENSIV_BGT60TRXX_REG_FSTAT_FOF_ERR_MSK, RADAR_FIFO_READ_ERROR) ==
+               RADAR_FIFO_OVERFLOW);
+    TEST_CHECK(radar_fifo_classify(XENSIV_BGT60TRXX_REG_FSTAT_FUF_ERR_MSK, RADAR_FIFO_READ_ERROR) ==
+               RADAR_FIFO_UNDERFLOW);
+    TEST_CHECK(radar_fifo_classify(XENSIV_BGT60TRXX_REG_FSTAT_FOF_ERR_MSK | XENSIV_BGT60TRXX_REG_FSTAT_FUF_ERR_MSK,
+                                   RADAR_FIFO_STALL) == RADAR_FIFO_OVERFLOW);
+    TEST_CHECK(radar_fifo_classify(0, RADAR_FIFO_READ_ERROR) == RADAR_FIFO_READ_ERROR);
+    TEST_CHECK(radar_fifo_classify(0, RADAR_FIFO_STALL) == RADAR_FIFO_STALL);
+}
+
+/*******************************************************************************
+ * Function Name: test_inject
+ *******************************************************************************
+ * Summary:
+ *   Every interval-th read is a simulated overflow, a new interval starts
+ *   counting over and 0 turns the simulation off.
+ ******************************************************************************/
+static void test_inject(void)
+{
+    uint32_t injected = 0;
+
+    radar_fifo_init(&test_fifo, TEST_PERIOD_US);
+    for (uint32_t read = 0; read < 100u; ++read)
+    {
+        TEST_CHECK(!radar_fifo_inject(&test_fifo));
+    }
+
+    radar_fifo_set_inject(&test_fifo, 7);
+    for (uint32_t read = 1; read <= 70u; ++read)
+    {
+        const bool overflow = radar_fifo_inject(&test_fifo);
+
+        TEST_CHECK(overflow == ((read % 7u) == 0));
+        injected += overflow ? 1u : 0u;
+    }
+    TEST_CHECK(injected == 10u);
+
+    (void)radar_fifo_inject(&test_fifo);
+    radar_fifo_set_inject(&test_fifo, 2);
+    TEST_CHECK(!radar_fifo_inject(&test_fifo));
+    TEST_CHECK(radar_fifo_inject(&test_fifo));
+
+    radar_fifo_set_inject(&test_fifo, 0);
+    TEST_CHECK(!radar_fifo_inject(&test_fifo));
+    TEST_CHECK(!radar_fifo_inject(&test_fifo));
+}
+
+/*******************************************************************************
+ * Function Name: test_counters
+ *******************************************************************************
+ * Summary:
+ *   Every recovery is counted by its reason and its outcome and marks the
+ *   next frame.
+ ******************************************************************************/
+static void test_counters(void)
+{
+    radar_fifo_init(&test_fifo, TEST_PERIOD_US);
+    radar_fifo_recovered(&test_fifo, RADAR_FIFO_OVERFLOW, true);
+    radar_fifo_recovered(&test_fifo, RADAR_FIFO_UNDERFLOW, true);
+    radar_fifo_recovered(&test_fifo, RADAR_FIFO_READ_ERROR, false);
+    radar_fifo_recovered(&test_fifo, RADAR_FIFO_STALL, true);
+    radar_fifo_recovered(&test_fifo, RADAR_FIFO_STALL, false);
+
+    TEST_CHECK((test_fifo.stats.overflows == 1u) && (test_fifo.stats.underflows == 1u));
+    TEST_CHECK((test_fifo.stats.read_errors == 1u) && (test_fifo.stats.stalls == 2u));
+    TEST_CHECK((test_fifo.stats.recoveries == 3u) && (test_fifo.stats.failed_recoveries == 2u));
+    TEST_CHECK(test_fifo.marker);
+}
+
+/*******************************************************************************
+ * Function Name: test_restart
+ *******************************************************************************
+ * Summary:
+ *   The time until the first frame of a started acquisition is no loss, the
+ *   frames after a recovery are numbered from their time.
+ ******************************************************************************/
+static void test_restart(void)
+{
+    radar_fifo_init(&test_fifo, TEST_PERIOD_US);
+    TEST_CHECK(radar_fifo_frame(&test_fifo, frame_time(0)) == 0);
+    TEST_CHECK(radar_fifo_frame(&test_fifo, frame_time(1)) == 0);
+
+    /* Stopped and started again a second later */
+    radar_fifo_restart(&test_fifo);
+    TEST_CHECK(radar_fifo_frame(&test_fifo, frame_time(100)) == 0);
+
+    /* Without a recovery the frames count one by one, whatever the time */
+    TEST_CHECK(radar_fifo_frame(&test_fifo, frame_time(105)) == 0);
+
+    radar_fifo_recovered(&test_fifo, RADAR_FIFO_OVERFLOW, true);
+    TEST_CHECK(radar_fifo_frame(&test_fifo, frame_time(112)) == 6u);
+    TEST_CHECK(radar_fifo_frame(&test_fifo, frame_time(113)) == 0);
+    TEST_CHECK(test_fifo.stats.frames_lost == 6u);
+
+    /* A recovery before the first frame has nothing to count from */
+    radar_fifo_restart(&test_fifo);
+    radar_fifo_recovered(&test_fifo, RADAR_FIFO_STALL, true);
+    TEST_CHECK(radar_fifo_frame(&test_fifo, frame_time(200)) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: test_overflow_recovery
+ *******************************************************************************
+ * Summary:
+ *   Runs the reader of the radar task against a sensor that fills a FIFO of
+ *   3 frames. A stalled reader overflows the FIFO, and every 97th read a
+ *   simulated overflow is injected as with the fifo_inject command. Each
+ *   overflow resets the FIFO and restarts the sensor, which drops the frames
+ *   in the FIFO and the ones during the restart. Every frame read has to get
+ *   the number of its sensor frame, the first one after a recovery is
+ *   marked, and the counters match the simulation.
+ ******************************************************************************/
+static void test_overflow_recovery(void)
+{
+    uint64_t reader_time = 0;
+    uint32_t next_frame = 0;
+    uint32_t frame_num = 0;
+    uint32_t frames_read = 0;
+    uint32_t overflows = 0;
+    uint32_t injections = 0;
+    uint32_t lost = 0;
+    bool recovered = false;
+
+    test_random = 1;
+    radar_fifo_init(&test_fifo, TEST_PERIOD_US);
+    radar_fifo_set_inject(&test_fifo, 97);
+
+    while (frames_read < TEST_FRAMES)
+    {
+        const uint64_t time = frame_time(next_frame);
+        const uint64_t read_time = (reader_time > time) ? reader_time : time;
+        uint32_t pending = 0;
+        bool injected;
+
+        while (frame_time(next_frame + pending) <= read_time)
+        {
+            pending++;
+        }
+
+        injected = radar_fifo_inject(&test_fifo);
+        if (injected || (pending > TEST_FIFO_FRAMES))
+        {
+            const uint32_t fstat = injected ? 0u : XENSIV_BGT60TRXX_REG_FSTAT_FOF_ERR_MSK;
+            const uint64_t restart_time = read_time + TEST_RESTART_US;
+            const uint32_t first = next_frame;
+
+            radar_fifo_recovered(&test_fifo, radar_fifo_classify(fstat, RADAR_FIFO_OVERFLOW), true);
+            overflows++;
+            injections += injected ? 1u : 0u;
+            recovered = true;
+
+            /* The FIFO is cleared and the sensor restarted */
+            while (frame_time(next_frame) <= restart_time)
+            {
+                next_frame++;
+            }
+            lost += next_frame - first;
+            reader_time = read_time;
+            continue;
+        }
+
+        frame_num += radar_fifo_frame(&test_fifo, time);
+        TEST_CHECK(frame_num == next_frame);
+        TEST_CHECK(test_fifo.marker == recovered);
+        test_fifo.marker = false;
+        recovered = false;
+
+        frame_num++;
+        next_frame++;
+        frames_read++;
+        reader_time = read_time + TEST_PROCESS_US;
+        if (next_random(TEST_STALL_CHANCE) == 0)
+        {
+            reader_time += (uint64_t)next_random(TEST_STALL_PERIODS + 1u) * TEST_PERIOD_US;
+        }
+    }
+
+    TEST_CHECK(test_fifo.stats.overflows == overflows);
+    TEST_CHECK(test_fifo.stats.recoveries == overflows);
+    TEST_CHECK(test_fifo.stats.failed_recoveries == 0);
+    TEST_CHECK(test_fifo.stats.frames_lost == lost);
+    TEST_CHECK((injections > 0) && (overflows > injections));
+    TEST_CHECK(frame_num == (frames_read + lost));
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_classify);
+    TEST_RUN(test_inject);
+    TEST_RUN(test_counters);
+    TEST_RUN(test_restart);
+    TEST_RUN(test_overflow_recovery);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,419 @@
+/*****************************************************************************
+ * File name: test_radar_kernels.c
+ *
+ * Description: This file contains the host unit tests of the kernels
+ * specialized per radar profile: on random frames and on the test sequence
+ * they give the same output, bit for bit, as the generic kernels that take
+ * the frame geometry at run time.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <stdio.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_frame.h"
+#include "radar_kernels.h"
+#include "radar_profile.h"
+#include "radar_roi.h"
+#include "radar_test.h"
+#include "radar_test_pattern.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Largest frame of the tested geometries */
+#define TEST_MAX_SAMPLES        (4096u)
+
+/* Samples behind every output buffer that no kernel may write */
+#define TEST_GUARD              (16u)
+#define TEST_POISON             (0xA5A5u)
+
+/* Corrupted samples per frame of the test sequence */
+#define TEST_CORRUPTIONS        (4u)
+
+/* Geometries the firmware profiles do not cover, specialized here the way
+ * radar_profile.c specializes the profiles:
+ * X(index, samples per chirp, chirps per frame, RX antennas) */
+#define TEST_GEOMETRY_LIST(X) \
+    X(0, 64u, 16u, 3u)        \
+    X(1, 32u, 8u, 2u)         \
+    X(2, 256u, 4u, 1u)        \
+    X(3, 20u, 5u, 3u)
+
+#define TEST_KERNELS(index, samples, chirps, rx)                                                           \
+    static uint32_t geometry_##index##_test_verify(const uint16_t *frame, uint16_t *test_word,             \
+                                                   uint32_t *first_error)                                  \
+    {                                                                                                      \
+        return radar_kernel_test_verify(frame, (samples) * (chirps) * (rx), (rx), test_word, first_error); \
+    }                                                                                                      \
+    static void geometry_##index##_deinterleave(const uint16_t *in, uint16_t *out)                         \
+    {                                                                                                      \
+        radar_kernel_deinterleave(in, out, (samples), (chirps), (rx));                                     \
+    }                                                                                                      \
+    static uint32_t geometry_##index##_roi_gather(const radar_roi_t *roi, const uint16_t *frame,           \
+                                                  uint16_t *out)                                           \
+    {                                                                                                      \
+        return radar_kernel_roi_gather(roi, frame, out, (samples), (chirps), (rx));                        \
+    }
+
+#define TEST_ENTRY(index, samples, chirps, rx)                                                             \
+    {                                                                                                      \
+        .geometry = { .samples_per_chirp = (samples), .chirps_per_frame = (chirps), .rx_antennas = (rx) }, \
+        .kernels = {                                                                                       \
+            .test_verify = geometry_##index##_test_verify,                                                 \
+            .deinterleave = geometry_##index##_deinterleave,                                               \
+            .roi_gather = geometry_##index##_roi_gather                                                    \
+        }                                                                                                  \
+    },
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    radar_geometry_t geometry;
+    radar_kernels_t kernels;
+} test_geometry_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+TEST_GEOMETRY_LIST(TEST_KERNELS)
+
+static const test_geometry_t test_specializations[] =
+{
+    TEST_GEOMETRY_LIST(TEST_ENTRY)
+};
+
+static uint16_t test_frame[TEST_MAX_SAMPLES];
+static uint16_t test_generic[TEST_MAX_SAMPLES + TEST_GUARD];
+static uint16_t test_specialized[TEST_MAX_SAMPLES + TEST_GUARD];
+static uint32_t test_random = 1;
+
+/*******************************************************************************
+ * Function Name: next_random
+ *******************************************************************************
+ * Summary:
+ *   Linear congruential generator, the tests see the same frames every run.
+ *
+ * Parameters:
+ *   range : number of values
+ *
+ * Return:
+ *   value from 0 to range - 1
+ ******************************************************************************/
+static uint32_t next_random(uint32_t range)
+{
+    test_random = (test_random * 1103515245u) + 12345u;
+    return (test_random >> 16) % range;
+}
+
+/*******************************************************************************
+ * Function Name: poison_outputs
+ *******************************************************************************
+ * Summary:
+ *   Fills both output buffers with the same pattern, so that comparing them
+ *   afterwards also covers the samples a kernel must leave alone.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void poison_outputs(void)
+{
+    for (uint32_t idx = 0; idx < (TEST_MAX_SAMPLES + TEST_GUARD); ++idx)
+    {
+        test_generic[idx] = TEST_POISON;
+        test_specialized[idx] = TEST_POISON;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: outputs_match
+ *******************************************************************************
+ * Summary:
+ *   Compares the complete output buffers bit for bit.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true if the generic and the specialized kernel wrote the same samples
+ ******************************************************************************/
+static bool outputs_match(void)
+{
+    return memcmp(test_generic, test_specialized, sizeof(test_generic)) == 0;
+}
+
+/*******************************************************************************
+ * Function Name: check_deinterleave
+ *******************************************************************************
+ * Summary:
+ *   Deinterleaves a random frame with the generic and the specialized kernel.
+ *
+ * Parameters:
+ *   geometry : frame geometry
+ *   kernels  : kernels specialized for the geometry
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void check_deinterleave(const radar_geometry_t *geometry, const radar_kernels_t *kernels)
+{
+    poison_outputs();
+    radar_frame_deinterleave(geometry, test_frame, test_generic);
+    kernels->deinterleave(test_frame, test_specialized);
+    TEST_CHECK(outputs_match());
+}
+
+/*******************************************************************************
+ * Function Name: check_roi_gather
+ *******************************************************************************
+ * Summary:
+ *   Gathers a random frame with the generic and the specialized kernel over
+ *   every antenna selection, several chirp strides and sample windows at the
+ *   start, the middle and the end of the chirps.
+ *
+ * Parameters:
+ *   geometry : frame geometry
+ *   kernels  : kernels specialized for the geometry
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void check_roi_gather(const radar_geometry_t *geometry, const radar_kernels_t *kernels)
+{
+    const uint32_t samples = geometry->samples_per_chirp;
+    const uint32_t strides[] = { 1u, 2u, 3u, geometry->chirps_per_frame };
+    const uint32_t windows[][2] =
+    {
+        { 0u, samples },
+        { 0u, 1u },
+        { 1u, samples - 2u },
+        { samples / 3u, samples / 2u },
+        { samples - 1u, 1u }
+    };
+    uint32_t checked = 0;
+
+    for (uint32_t mask = 1; mask < (1u << geometry->rx_antennas); ++mask)
+    {
+        for (uint32_t stride_idx = 0; stride_idx < (sizeof(strides) / sizeof(strides[0])); ++stride_idx)
+        {
+            for (uint32_t window_idx = 0; window_idx < (sizeof(windows) / sizeof(windows[0])); ++window_idx)
+            {
+                const radar_roi_t roi =
+                {
+                    .antenna_mask = (uint8_t)mask,
+                    .chirp_stride = (uint8_t)strides[stride_idx],
+                    .sample_start = (uint16_t)windows[window_idx][0],
+                    .sample_count = (uint16_t)windows[window_idx][1]
+                };
+
+                if (!radar_roi_is_valid(&roi, geometry))
+                {
+                    continue;
+                }
+
+                poison_outputs();
+                const uint32_t generic = radar_roi_gather(&roi, geometry, test_frame, test_generic);
+                const uint32_t specialized = kernels->roi_gather(&roi, test_frame, test_specialized);
+                TEST_CHECK(specialized == generic);
+                TEST_CHECK(outputs_match());
+                checked++;
+            }
+        }
+    }
+
+    TEST_CHECK(checked >= (1u << geometry->rx_antennas) - 1u);
+}
+
+/*******************************************************************************
+ * Function Name: check_test_verify
+ *******************************************************************************
+ * Summary:
+ *   Verifies a frame of the test sequence with the generic and the
+ *   specialized kernel, first intact and then with a few samples corrupted.
+ *   Both count the same errors, report the same first error and leave the
+ *   sequence at the same word.
+ *
+ * Parameters:
+ *   geometry : frame geometry
+ *   kernels  : kernels specialized for the geometry
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void check_test_verify(const radar_geometry_t *geometry, const radar_kernels_t *kernels)
+{
+    const uint32_t num_samples = (uint32_t)geometry->samples_per_chirp * geometry->chirps_per_frame *
+                                 geometry->rx_antennas;
+    const uint16_t start_word = (uint16_t)(1u + next_random(0x0FFEu));
+    uint16_t fill_word = start_word;
+
+    radar_test_pattern_fill(test_frame, num_samples, geometry->rx_antennas, &fill_word);
+
+    for (uint32_t corruptions = 0; corruptions <= TEST_CORRUPTIONS; corruptions += TEST_CORRUPTIONS)
+    {
+        for (uint32_t idx = 0; idx < corruptions; ++idx)
+        {
+            test_frame[next_random(num_samples)] ^= (uint16_t)(1u + next_random(0x0FFFu));
+        }
+
+        uint16_t generic_word = start_word;
+        uint16_t specialized_word = start_word;
+        uint32_t generic_error = UINT32_MAX;
+        uint32_t specialized_error = UINT32_MAX;
+        const uint32_t generic = radar_test_pattern_verify(test_frame, num_samples, geometry->rx_antennas,
+                                                           &generic_word, &generic_error);
+        const uint32_t specialized = kernels->test_verify(test_frame, &specialized_word, &specialized_error);
+
+        TEST_CHECK(specialized == generic);
+        TEST_CHECK(specialized_error == generic_error);
+        TEST_CHECK(specialized_word == generic_word);
+        TEST_CHECK(generic_word == fill_word);
+        if (corruptions == 0)
+        {
+            TEST_CHECK((generic == 0) && (generic_error == UINT32_MAX));
+        }
+    }
+
+    /* Corrupt an RX1 sample so that the error paths are taken whatever the
+     * random picks above hit */
+    test_frame[geometry->rx_antennas * next_random(num_samples / geometry->rx_antennas)] ^= 1u;
+
+    uint16_t generic_word = start_word;
+    uint16_t specialized_word = start_word;
+    uint32_t generic_error = UINT32_MAX;
+    uint32_t specialized_error = UINT32_MAX;
+    const uint32_t generic = radar_test_pattern_verify(test_frame, num_samples, geometry->rx_antennas,
+                                                       &generic_word, &generic_error);
+    const uint32_t specialized = kernels->test_verify(test_frame, &specialized_word, &specialized_error);
+
+    TEST_CHECK(generic > 0);
+    TEST_CHECK(specialized == generic);
+    TEST_CHECK(specialized_error == generic_error);
+    TEST_CHECK(specialized_word == generic_word);
+}
+
+/*******************************************************************************
+ * Function Name: check_kernels
+ *******************************************************************************
+ * Summary:
+ *   Compares all specialized kernels of a geometry with the generic ones on a
+ *   few random frames.
+ *
+ * Parameters:
+ *   geometry : frame geometry
+ *   kernels  : kernels specialized for the geometry
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void check_kernels(const radar_geometry_t *geometry, const radar_kernels_t *kernels)
+{
+    const uint32_t num_samples = (uint32_t)geometry->samples_per_chirp * geometry->chirps_per_frame *
+                                 geometry->rx_antennas;
+
+    TEST_CHECK(num_samples <= TEST_MAX_SAMPLES);
+    if (num_samples > TEST_MAX_SAMPLES)
+    {
+        return;
+    }
+
+    for (uint32_t frame = 0; frame < 4u; ++frame)
+    {
+        /* 12 bit ADC samples */
+        for (uint32_t idx = 0; idx < num_samples; ++idx)
+        {
+            test_frame[idx] = (uint16_t)next_random(0x1000u);
+        }
+
+        check_deinterleave(geometry, kernels);
+        check_roi_gather(geometry, kernels);
+        check_test_verify(geometry, kernels);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_profiles
+ *******************************************************************************
+ * Summary:
+ *   The kernels of every firmware profile match the generic kernels, and the
+ *   profiles are found by their geometry.
+ ******************************************************************************/
+static void test_profiles(void)
+{
+    for (uint32_t id = 0; id < RADAR_PROFILE_COUNT; ++id)
+    {
+        const radar_profile_t *profile = radar_profile_get(id);
+
+        TEST_CHECK(profile != NULL);
+        if (profile == NULL)
+        {
+            continue;
+        }
+
+        TEST_CHECK(profile->id == id);
+        TEST_CHECK(profile->samples_per_frame == ((uint32_t)profile->geometry.samples_per_chirp *
+                                                  profile->geometry.chirps_per_frame *
+                                                  profile->geometry.rx_antennas));
+        TEST_CHECK(radar_profile_has_geometry(profile, &profile->geometry));
+        TEST_CHECK(radar_profile_find(&profile->geometry) != NULL);
+        check_kernels(&profile->geometry, &profile->kernels);
+    }
+
+    TEST_CHECK(radar_profile_get(RADAR_PROFILE_COUNT) == NULL);
+}
+
+/*******************************************************************************
+ * Function Name: test_geometries
+ *******************************************************************************
+ * Summary:
+ *   Kernels specialized for several chirps and up to three antennas match the
+ *   generic kernels, also for geometries no profile uses.
+ ******************************************************************************/
+static void test_geometries(void)
+{
+    for (uint32_t idx = 0; idx < (sizeof(test_specializations) / sizeof(test_specializations[0])); ++idx)
+    {
+        check_kernels(&test_specializations[idx].geometry, &test_specializations[idx].kernels);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_profiles);
+    TEST_RUN(test_geometries);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,250 @@
+/*****************************************************************************
+ * File name: test_radar_mti.c
+ *
+ * Description: This file contains the host unit tests of the static clutter
+ * removal: a static scene is removed completely, a moving target passes, a
+ * target that stops fades into the background.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+#include <stdio.h>
+
+/* Header file for local module */
+#include "radar_mti.h"
+#include "radar_test.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_PI                 (3.14159265358979323846)
+
+#define TEST_SAMPLES            (64u)
+#define TEST_CHIRPS             (16u)
+#define TEST_ANTENNAS           (2u)
+#define TEST_CHIRP_LENGTH       (TEST_SAMPLES * TEST_ANTENNAS)
+#define TEST_FRAME_LENGTH       (TEST_CHIRP_LENGTH * TEST_CHIRPS)
+
+#define TEST_ALPHA_SHIFT        (4u)
+
+/* Static scene: strong reflections around the ADC mid-scale, beat frequency
+ * in cycles per sample */
+#define TEST_CLUTTER_AMPLITUDE  (600.0)
+#define TEST_CLUTTER_BEAT       (4.0 / TEST_SAMPLES)
+
+/* Moving target: beat frequency in cycles per sample, Doppler shift in
+ * cycles per chirp */
+#define TEST_MOVER_AMPLITUDE    (200.0)
+#define TEST_MOVER_BEAT         (0.25)
+#define TEST_MOVER_DOPPLER      (0.25)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static const radar_geometry_t test_geometry = {
+    .samples_per_chirp = TEST_SAMPLES,
+    .chirps_per_frame = TEST_CHIRPS,
+    .rx_antennas = TEST_ANTENNAS
+};
+
+static uint16_t test_frame[TEST_FRAME_LENGTH];
+static int32_t test_background[TEST_CHIRP_LENGTH];
+
+/*******************************************************************************
+ * Function Name: fill_frame
+ *******************************************************************************
+ * Summary:
+ *   Writes a frame of the static scene with an optional moving target and an
+ *   optional constant offset of a standing target.
+ *
+ * Parameters:
+ *   frame_number : number of the frame, the Doppler phase continues over
+ *                  frames
+ *   mover        : amplitude of the moving target, 0 for none
+ *   offset       : offset added to every sample
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void fill_frame(uint32_t frame_number, double mover, double offset)
+{
+    uint16_t *sample = test_frame;
+
+    for (uint32_t chirp = 0; chirp < TEST_CHIRPS; ++chirp)
+    {
+        const double doppler = 2.0 * TEST_PI * TEST_MOVER_DOPPLER * ((frame_number * TEST_CHIRPS) + chirp);
+
+        for (uint32_t s = 0; s < TEST_SAMPLES; ++s)
+        {
+            for (uint32_t rx = 0; rx < TEST_ANTENNAS; ++rx)
+            {
+                const double clutter = TEST_CLUTTER_AMPLITUDE * cos((2.0 * TEST_PI * TEST_CLUTTER_BEAT * s) + rx);
+                const double target = mover * cos((2.0 * TEST_PI * TEST_MOVER_BEAT * s) + doppler);
+
+                *sample++ = (uint16_t)lround(2048.0 + clutter + target + offset);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_static_scene
+ *******************************************************************************
+ * Summary:
+ *   A scene without motion leaves no residual, from the first frame on.
+ ******************************************************************************/
+static void test_static_scene(void)
+{
+    radar_mti_t mti;
+
+    radar_mti_init(&mti, test_background, TEST_CHIRP_LENGTH);
+
+    for (uint32_t frame_number = 0; frame_number < 4u; ++frame_number)
+    {
+        fill_frame(frame_number, 0.0, 0.0);
+        TEST_CHECK(radar_mti_process(&mti, TEST_ALPHA_SHIFT, &test_geometry, test_frame) == 0);
+
+        for (uint32_t i = 0; i < TEST_FRAME_LENGTH; ++i)
+        {
+            TEST_CHECK(test_frame[i] == RADAR_MTI_OUTPUT_OFFSET);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_mover
+ *******************************************************************************
+ * Summary:
+ *   A moving target in front of the static scene passes with the gain of the
+ *   background filter, (1 - z^-1) / (1 - (1 - 2^-alpha_shift) z^-1) at its
+ *   Doppler frequency, and the scene is removed.
+ ******************************************************************************/
+static void test_mover(void)
+{
+    const double a = 1.0 / (1u << TEST_ALPHA_SHIFT);
+    const double w = 2.0 * TEST_PI * TEST_MOVER_DOPPLER;
+    const double gain = sqrt((2.0 - (2.0 * cos(w))) /
+                             (1.0 - (2.0 * (1.0 - a) * cos(w)) + ((1.0 - a) * (1.0 - a))));
+    const double expected = 0.5 * (TEST_MOVER_AMPLITUDE * gain) * (TEST_MOVER_AMPLITUDE * gain);
+    radar_mti_t mti;
+    uint32_t energy = 0;
+
+    radar_mti_init(&mti, test_background, TEST_CHIRP_LENGTH);
+
+    /* Let the background settle on the scene, 2^-4 per chirp */
+    for (uint32_t frame_number = 0; frame_number < 8u; ++frame_number)
+    {
+        fill_frame(frame_number, TEST_MOVER_AMPLITUDE, 0.0);
+        energy = radar_mti_process(&mti, TEST_ALPHA_SHIFT, &test_geometry, test_frame);
+    }
+
+    TEST_CHECK_NEAR(energy, expected, 0.05 * expected);
+
+    /* Only the target is left: the residual follows its beat signal */
+    for (uint32_t chirp = 0; chirp < TEST_CHIRPS; ++chirp)
+    {
+        double correlation = 0.0;
+
+        for (uint32_t s = 0; s < TEST_SAMPLES; ++s)
+        {
+            const uint16_t *sample = &test_frame[(chirp * TEST_CHIRP_LENGTH) + (s * TEST_ANTENNAS)];
+
+            TEST_CHECK((sample[0] - RADAR_MTI_OUTPUT_OFFSET) == (sample[1] - RADAR_MTI_OUTPUT_OFFSET));
+            correlation += (sample[0] - RADAR_MTI_OUTPUT_OFFSET) * cos(2.0 * TEST_PI * TEST_CLUTTER_BEAT * s);
+        }
+
+        /* No clutter beat left in the residual */
+        TEST_CHECK_NEAR(correlation / TEST_SAMPLES, 0.0, 1.0);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_stopped_target
+ *******************************************************************************
+ * Summary:
+ *   A target that enters and stands still shows up and fades into the
+ *   background with 2^-alpha_shift per chirp.
+ ******************************************************************************/
+static void test_stopped_target(void)
+{
+    radar_mti_t mti;
+    uint32_t energy[4];
+
+    radar_mti_init(&mti, test_background, TEST_CHIRP_LENGTH);
+    fill_frame(0, 0.0, 0.0);
+    (void)radar_mti_process(&mti, TEST_ALPHA_SHIFT, &test_geometry, test_frame);
+
+    for (uint32_t frame_number = 0; frame_number < 4u; ++frame_number)
+    {
+        fill_frame(frame_number + 1u, 0.0, 300.0);
+        energy[frame_number] = radar_mti_process(&mti, TEST_ALPHA_SHIFT, &test_geometry, test_frame);
+    }
+
+    TEST_CHECK(energy[0] > 5000u);
+    TEST_CHECK(energy[1] < (energy[0] / 4u));
+    TEST_CHECK(energy[3] < (energy[0] / 256u));
+
+    /* Reset takes the next chirp as the background */
+    radar_mti_reset(&mti);
+    fill_frame(5, 0.0, -300.0);
+    TEST_CHECK(radar_mti_process(&mti, TEST_ALPHA_SHIFT, &test_geometry, test_frame) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: test_capacity
+ *******************************************************************************
+ * Summary:
+ *   A chirp longer than the background memory leaves the frame untouched.
+ ******************************************************************************/
+static void test_capacity(void)
+{
+    const radar_mti_config_t valid = { .enabled = true, .alpha_shift = TEST_ALPHA_SHIFT };
+    const radar_mti_config_t invalid = { .enabled = true, .alpha_shift = RADAR_MTI_MAX_ALPHA_SHIFT + 1 };
+    radar_mti_t mti;
+
+    radar_mti_init(&mti, test_background, TEST_CHIRP_LENGTH - 1u);
+    fill_frame(0, TEST_MOVER_AMPLITUDE, 0.0);
+    test_frame[0] ^= 1u;
+    TEST_CHECK(radar_mti_process(&mti, TEST_ALPHA_SHIFT, &test_geometry, test_frame) == 0);
+    TEST_CHECK(test_frame[0] != RADAR_MTI_OUTPUT_OFFSET);
+
+    TEST_CHECK(radar_mti_config_is_valid(&valid));
+    TEST_CHECK(!radar_mti_config_is_valid(&invalid));
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_static_scene);
+    TEST_RUN(test_mover);
+    TEST_RUN(test_stopped_target);
+    TEST_RUN(test_capacity);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,386 @@
+/*****************************************************************************
+ * File name: test_radar_pipeline.c
+ *
+ * Description: This file contains the host unit tests of the frame processing
+ * pipeline: the scratch arena, the pipeline descriptions, the buffer handling
+ * and cycle accounting of in place and out of place stages, and a chain of
+ * the firmware stages.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <stdio.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_pipeline.h"
+#include "radar_stages.h"
+#include "radar_test.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_SAMPLES            (64u)
+#define TEST_CHIRPS             (8u)
+#define TEST_ANTENNAS           (3u)
+#define TEST_FRAME_LENGTH       (TEST_SAMPLES * TEST_CHIRPS * TEST_ANTENNAS)
+
+#define TEST_LEVEL              (1000u)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Stage of the tests: adds a value to every sample, in place or into the
+ * output buffer, and returns a fixed result */
+typedef struct
+{
+    uint16_t add;
+    radar_stage_result_t result;
+    uint32_t calls;
+} test_stage_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+static radar_stage_result_t test_stage_process(void *context, radar_frame_t *frame, uint16_t *out);
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static test_stage_t test_add1 = { .add = 1, .result = RADAR_STAGE_CONTINUE };
+static test_stage_t test_add10 = { .add = 10, .result = RADAR_STAGE_CONTINUE };
+static test_stage_t test_drop = { .add = 0, .result = RADAR_STAGE_DROP };
+static test_stage_t test_done = { .add = 100, .result = RADAR_STAGE_DONE };
+
+static const radar_stage_t test_registry[] =
+{
+    { .name = "add1",  .process = test_stage_process, .in_place = true,  .context = &test_add1 },
+    { .name = "add10", .process = test_stage_process, .in_place = false, .context = &test_add10 },
+    { .name = "drop",  .process = test_stage_process, .in_place = true,  .context = &test_drop },
+    { .name = "done",  .process = test_stage_process, .in_place = false, .context = &test_done },
+};
+
+static uint16_t test_buffer_a[TEST_FRAME_LENGTH];
+static uint16_t test_buffer_b[TEST_FRAME_LENGTH];
+
+static uint64_t test_arena_memory[RADAR_STAGES_ARENA_SIZE(TEST_SAMPLES, TEST_CHIRPS, TEST_ANTENNAS) /
+                                  sizeof(uint64_t)];
+
+/*******************************************************************************
+ * Function Name: test_stage_process
+ *******************************************************************************
+ * Summary:
+ *   Processing function of the test stages.
+ *
+ * Parameters:
+ *   context : test stage
+ *   frame   : frame to process
+ *   out     : output buffer, NULL for in place stages
+ *
+ * Return:
+ *   result of the test stage
+ ******************************************************************************/
+static radar_stage_result_t test_stage_process(void *context, radar_frame_t *frame, uint16_t *out)
+{
+    test_stage_t *stage = (test_stage_t *)context;
+    uint16_t *result = (out != NULL) ? out : frame->samples;
+
+    for (uint32_t i = 0; i < frame->num_samples; ++i)
+    {
+        result[i] = (uint16_t)(frame->samples[i] + stage->add);
+    }
+    stage->calls++;
+
+    return stage->result;
+}
+
+/*******************************************************************************
+ * Function Name: fill_frame
+ *******************************************************************************
+ * Summary:
+ *   Starts a frame of the test geometry with every sample at TEST_LEVEL in
+ *   the first buffer.
+ *
+ * Parameters:
+ *   frame : frame to start
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void fill_frame(radar_frame_t *frame)
+{
+    for (uint32_t i = 0; i < TEST_FRAME_LENGTH; ++i)
+    {
+        test_buffer_a[i] = TEST_LEVEL;
+    }
+    memset(test_buffer_b, 0, sizeof(test_buffer_b));
+
+    memset(frame, 0, sizeof(*frame));
+    frame->samples = test_buffer_a;
+    frame->num_samples = TEST_FRAME_LENGTH;
+    frame->geometry.samples_per_chirp = TEST_SAMPLES;
+    frame->geometry.chirps_per_frame = TEST_CHIRPS;
+    frame->geometry.rx_antennas = TEST_ANTENNAS;
+    frame->decimation = 1;
+}
+
+/*******************************************************************************
+ * Function Name: set_pipeline
+ *******************************************************************************
+ * Summary:
+ *   Sets the stages of a pipeline from a description of the test stages.
+ *
+ * Parameters:
+ *   pipeline    : pipeline to update
+ *   description : pipeline description
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void set_pipeline(radar_pipeline_t *pipeline, const char *description)
+{
+    const radar_stage_t *stages[RADAR_PIPELINE_MAX_STAGES];
+    uint32_t num_stages = 0;
+
+    TEST_CHECK(radar_pipeline_parse(test_registry, sizeof(test_registry) / sizeof(test_registry[0]),
+                                    description, (uint32_t)strlen(description), stages, &num_stages));
+    radar_pipeline_set_stages(pipeline, stages, num_stages);
+}
+
+/*******************************************************************************
+ * Function Name: test_arena
+ *******************************************************************************
+ * Summary:
+ *   Blocks are aligned and the arena refuses to hand out more than it has.
+ ******************************************************************************/
+static void test_arena(void)
+{
+    uint64_t memory[8];
+    radar_arena_t arena;
+    uint8_t *first;
+    uint8_t *second;
+
+    radar_arena_init(&arena, memory, sizeof(memory));
+    first = radar_arena_alloc(&arena, 3);
+    second = radar_arena_alloc(&arena, 17);
+
+    TEST_CHECK(first == (uint8_t *)memory);
+    TEST_CHECK(second == (first + RADAR_ARENA_ALIGNMENT));
+    TEST_CHECK(arena.used == (RADAR_ARENA_ALIGNMENT + RADAR_ARENA_BLOCK_SIZE(17u)));
+    TEST_CHECK(radar_arena_alloc(&arena, sizeof(memory)) == NULL);
+    TEST_CHECK(radar_arena_alloc(&arena, sizeof(memory) - arena.used) != NULL);
+    TEST_CHECK(radar_arena_alloc(&arena, 1) == NULL);
+}
+
+/*******************************************************************************
+ * Function Name: test_parse
+ *******************************************************************************
+ * Summary:
+ *   Pipeline descriptions select the named stages in their order; unknown
+ *   names, empty names and too many stages are rejected.
+ ******************************************************************************/
+static void test_parse(void)
+{
+    const uint32_t registry_size = sizeof(test_registry) / sizeof(test_registry[0]);
+    const radar_stage_t *stages[RADAR_PIPELINE_MAX_STAGES];
+    const char *too_long = "add1,add1,add1,add1,add1,add1,add1,add1,add1";
+    uint32_t num_stages = 99;
+
+    TEST_CHECK(radar_pipeline_parse(test_registry, registry_size, "add10,add1", 10, stages, &num_stages));
+    TEST_CHECK(num_stages == 2);
+    TEST_CHECK(stages[0] == &test_registry[1]);
+    TEST_CHECK(stages[1] == &test_registry[0]);
+
+    /* The length bounds the description */
+    TEST_CHECK(radar_pipeline_parse(test_registry, registry_size, "add10,add1", 4, stages, &num_stages));
+    TEST_CHECK((num_stages == 1) && (stages[0] == &test_registry[0]));
+
+    TEST_CHECK(radar_pipeline_parse(test_registry, registry_size, "", 0, stages, &num_stages));
+    TEST_CHECK(num_stages == 0);
+
+    TEST_CHECK(!radar_pipeline_parse(test_registry, registry_size, "add", 3, stages, &num_stages));
+    TEST_CHECK(!radar_pipeline_parse(test_registry, registry_size, "add1,,add1", 10, stages, &num_stages));
+    TEST_CHECK(!radar_pipeline_parse(test_registry, registry_size, too_long, (uint32_t)strlen(too_long),
+                                     stages, &num_stages));
+    TEST_CHECK(radar_pipeline_parse(test_registry, registry_size, too_long, (uint32_t)strlen(too_long) - 5u,
+                                    stages, &num_stages));
+    TEST_CHECK(num_stages == RADAR_PIPELINE_MAX_STAGES);
+}
+
+/*******************************************************************************
+ * Function Name: test_run
+ *******************************************************************************
+ * Summary:
+ *   In place stages keep the buffer, out of place stages swap the buffers,
+ *   and every stage that ran is accounted.
+ ******************************************************************************/
+static void test_run(void)
+{
+    radar_pipeline_t pipeline;
+    radar_frame_t frame;
+
+    radar_pipeline_init(&pipeline, test_buffer_a, test_buffer_b);
+    set_pipeline(&pipeline, "add1,add10,add1,add10,add1");
+
+    for (uint32_t run = 1; run <= 3u; ++run)
+    {
+        fill_frame(&frame);
+        TEST_CHECK(radar_pipeline_run(&pipeline, &frame) == RADAR_STAGE_CONTINUE);
+        TEST_CHECK(frame.samples == test_buffer_a);
+        TEST_CHECK(frame.samples[0] == (TEST_LEVEL + 23u));
+        TEST_CHECK(frame.samples[TEST_FRAME_LENGTH - 1u] == (TEST_LEVEL + 23u));
+
+        for (uint32_t i = 0; i < pipeline.num_stages; ++i)
+        {
+            TEST_CHECK(pipeline.stats[i].runs == run);
+            TEST_CHECK(pipeline.stats[i].max_cycles >= pipeline.stats[i].last_cycles);
+            TEST_CHECK(pipeline.stats[i].total_cycles >= pipeline.stats[i].max_cycles);
+        }
+    }
+
+    /* A frame entering in the second buffer ends in the first */
+    set_pipeline(&pipeline, "add10");
+    TEST_CHECK(pipeline.stats[0].runs == 0);
+    fill_frame(&frame);
+    memcpy(test_buffer_b, test_buffer_a, sizeof(test_buffer_b));
+    frame.samples = test_buffer_b;
+    TEST_CHECK(radar_pipeline_run(&pipeline, &frame) == RADAR_STAGE_CONTINUE);
+    TEST_CHECK(frame.samples == test_buffer_a);
+    TEST_CHECK(frame.samples[0] == (TEST_LEVEL + 10u));
+
+    /* An empty pipeline passes the frame */
+    set_pipeline(&pipeline, "");
+    fill_frame(&frame);
+    TEST_CHECK(radar_pipeline_run(&pipeline, &frame) == RADAR_STAGE_CONTINUE);
+    TEST_CHECK((frame.samples == test_buffer_a) && (frame.samples[0] == TEST_LEVEL));
+}
+
+/*******************************************************************************
+ * Function Name: test_drop_done
+ *******************************************************************************
+ * Summary:
+ *   A dropping stage stops the pipeline and reports it, a finishing stage
+ *   stops it with its result as the frame.
+ ******************************************************************************/
+static void test_drop_done(void)
+{
+    radar_pipeline_t pipeline;
+    radar_frame_t frame;
+
+    radar_pipeline_init(&pipeline, test_buffer_a, test_buffer_b);
+
+    test_add10.calls = 0;
+    set_pipeline(&pipeline, "add1,drop,add10");
+    fill_frame(&frame);
+    TEST_CHECK(radar_pipeline_run(&pipeline, &frame) == RADAR_STAGE_DROP);
+    TEST_CHECK(test_add10.calls == 0);
+    TEST_CHECK((pipeline.stats[1].runs == 1) && (pipeline.stats[2].runs == 0));
+
+    set_pipeline(&pipeline, "add1,done,add10");
+    fill_frame(&frame);
+    TEST_CHECK(radar_pipeline_run(&pipeline, &frame) == RADAR_STAGE_CONTINUE);
+    TEST_CHECK(test_add10.calls == 0);
+    TEST_CHECK(frame.samples == test_buffer_b);
+    TEST_CHECK(frame.samples[0] == (TEST_LEVEL + 101u));
+}
+
+/*******************************************************************************
+ * Function Name: test_firmware_stages
+ *******************************************************************************
+ * Summary:
+ *   The firmware chain "decim,mti,roi" runs on the host with the generic
+ *   kernels: the frame leaves with the decimated and gathered geometry.
+ ******************************************************************************/
+static void test_firmware_stages(void)
+{
+    const char description[] = "decim,mti,roi";
+    const radar_geometry_t sensor_geometry = {
+        .samples_per_chirp = TEST_SAMPLES,
+        .chirps_per_frame = TEST_CHIRPS,
+        .rx_antennas = TEST_ANTENNAS
+    };
+    const radar_stage_t *stages[RADAR_PIPELINE_MAX_STAGES];
+    radar_stage_settings_t settings;
+    radar_pipeline_t pipeline;
+    radar_arena_t arena;
+    radar_frame_t frame;
+    uint32_t num_stages = 0;
+
+    radar_arena_init(&arena, test_arena_memory, sizeof(test_arena_memory));
+    TEST_CHECK(radar_stages_init(&arena, &sensor_geometry, NULL, 10.0f));
+    TEST_CHECK(arena.used <= sizeof(test_arena_memory));
+
+    memset(&settings, 0, sizeof(settings));
+    settings.decimation = 2;
+    settings.roi.antenna_mask = 0x5;
+    settings.roi.chirp_stride = 2;
+    settings.roi.sample_start = 4;
+    settings.roi.sample_count = 16;
+    settings.cfar.guard_cells = RADAR_CFAR_DEFAULT_GUARD_CELLS;
+    settings.cfar.training_cells = RADAR_CFAR_DEFAULT_TRAINING_CELLS;
+    settings.cfar.threshold_db = RADAR_CFAR_DEFAULT_THRESHOLD_DB;
+    settings.track.interval = RADAR_TRACK_DEFAULT_INTERVAL;
+    settings.track.gate = RADAR_TRACK_DEFAULT_GATE;
+    settings.spectro.range_bin = RADAR_SPECTRO_DEFAULT_RANGE_BIN;
+    settings.spectro.range_bins = RADAR_SPECTRO_DEFAULT_RANGE_BINS;
+    settings.spectro.window = RADAR_SPECTRO_DEFAULT_WINDOW;
+    settings.spectro.hop = RADAR_SPECTRO_DEFAULT_HOP;
+    radar_stages_configure(&settings);
+
+    TEST_CHECK(radar_pipeline_parse(radar_stages, radar_num_stages, description,
+                                    (uint32_t)strlen(description), stages, &num_stages));
+    radar_pipeline_init(&pipeline, test_buffer_a, test_buffer_b);
+    radar_pipeline_set_stages(&pipeline, stages, num_stages);
+
+    fill_frame(&frame);
+    TEST_CHECK(radar_pipeline_run(&pipeline, &frame) == RADAR_STAGE_CONTINUE);
+    TEST_CHECK(frame.samples == test_buffer_b);
+    TEST_CHECK(frame.decimation == 2);
+    TEST_CHECK(frame.geometry.samples_per_chirp == 16);
+    TEST_CHECK(frame.geometry.chirps_per_frame == (TEST_CHIRPS / 2u));
+    TEST_CHECK(frame.geometry.rx_antennas == 2);
+    TEST_CHECK(frame.num_samples == (16u * (TEST_CHIRPS / 2u) * 2u));
+    TEST_CHECK(frame.roi.sample_start == 4);
+
+    for (uint32_t i = 0; i < frame.num_samples; ++i)
+    {
+        TEST_CHECK_NEAR(frame.samples[i], TEST_LEVEL, 1);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_arena);
+    TEST_RUN(test_parse);
+    TEST_RUN(test_run);
+    TEST_RUN(test_drop_done);
+    TEST_RUN(test_firmware_stages);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,465 @@
+/*****************************************************************************
+ * File name: test_radar_resend.c
+ *
+ * Description: This file contains the host unit tests of the retransmission
+ * ring: frame datagrams are sent through a channel that drops them on
+ * purpose, and the client asks for the missing ones with negative
+ * acknowledgements the way udp_client_radar.py does.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <stdio.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_frame.h"
+#include "radar_resend.h"
+#include "radar_test.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_MAX_DATAGRAM       (100u)
+#define TEST_DEPTH              (32u)
+
+/* Frames sent by the longest test */
+#define TEST_MAX_FRAMES         (2000u)
+
+/* The client asks for the missing frames every TEST_NACK_INTERVAL frames */
+#define TEST_NACK_INTERVAL      (8u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static uint8_t test_memory[RADAR_RESEND_MEMORY_SIZE(TEST_MAX_DATAGRAM)];
+static radar_resend_t test_ring;
+static bool test_received[TEST_MAX_FRAMES];
+static uint32_t test_duplicates;
+static uint32_t test_random = 1;
+
+/*******************************************************************************
+ * Function Name: next_random
+ *******************************************************************************
+ * Summary:
+ *   Linear congruential generator, the tests see the same losses every run.
+ *
+ * Parameters:
+ *   range : number of values
+ *
+ * Return:
+ *   value from 0 to range - 1
+ ******************************************************************************/
+static uint32_t next_random(uint32_t range)
+{
+    test_random = (test_random * 1103515245u) + 12345u;
+    return (test_random >> 16) % range;
+}
+
+/*******************************************************************************
+ * Function Name: start
+ *******************************************************************************
+ * Summary:
+ *   Starts with an empty ring and nothing received.
+ *
+ * Parameters:
+ *   depth : datagrams kept
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void start(uint8_t depth)
+{
+    radar_resend_init(&test_ring, test_memory, TEST_MAX_DATAGRAM, depth);
+    memset(test_received, 0, sizeof(test_received));
+    test_duplicates = 0;
+    test_random = 1;
+}
+
+/*******************************************************************************
+ * Function Name: make_datagram
+ *******************************************************************************
+ * Summary:
+ *   Builds the frame datagram of a frame number. Size and content follow
+ *   from the frame number, so a received datagram can be checked.
+ *
+ * Parameters:
+ *   data  : output, TEST_MAX_DATAGRAM bytes
+ *   frame : frame number
+ *
+ * Return:
+ *   size of the datagram
+ ******************************************************************************/
+static uint32_t make_datagram(uint8_t *data, uint32_t frame)
+{
+    const uint32_t length = RADAR_FRAME_HEADER_SIZE + (frame % (TEST_MAX_DATAGRAM - RADAR_FRAME_HEADER_SIZE + 1u));
+
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        data[i] = (uint8_t)((frame * 7u) + i);
+    }
+    data[RADAR_FRAME_HDR_CMD] = RADAR_DATA_COMMAND;
+    radar_frame_put_u32(&data[RADAR_FRAME_HDR_FRAME_NUM], frame);
+
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: receive
+ *******************************************************************************
+ * Summary:
+ *   Takes a datagram on the client side, it has to match the one sent.
+ *
+ * Parameters:
+ *   data   : datagram
+ *   length : size of the datagram
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void receive(const uint8_t *data, uint32_t length)
+{
+    const uint32_t frame = radar_frame_get_u32(&data[RADAR_FRAME_HDR_FRAME_NUM]);
+    uint8_t expected[TEST_MAX_DATAGRAM];
+
+    TEST_CHECK(frame < TEST_MAX_FRAMES);
+    if (frame >= TEST_MAX_FRAMES)
+    {
+        return;
+    }
+    TEST_CHECK(length == make_datagram(expected, frame));
+    TEST_CHECK(memcmp(data, expected, length) == 0);
+
+    test_duplicates += test_received[frame] ? 1u : 0u;
+    test_received[frame] = true;
+}
+
+/*******************************************************************************
+ * Function Name: send_frame
+ *******************************************************************************
+ * Summary:
+ *   Sends a frame datagram through the channel and keeps it in the ring.
+ *
+ * Parameters:
+ *   frame : frame number
+ *   loss  : one datagram in loss is dropped, 0 for none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void send_frame(uint32_t frame, uint32_t loss)
+{
+    uint8_t data[TEST_MAX_DATAGRAM];
+    const uint32_t length = make_datagram(data, frame);
+
+    if ((loss == 0) || (next_random(loss) != 0))
+    {
+        receive(data, length);
+    }
+    TEST_CHECK(radar_resend_store(&test_ring, data, length));
+}
+
+/*******************************************************************************
+ * Function Name: write_nack
+ *******************************************************************************
+ * Summary:
+ *   Builds the request of the client for the frames missing from the first
+ *   missing one on, up to the last frame sent.
+ *
+ * Parameters:
+ *   nack   : output, RADAR_RESEND_NACK_MAX_SIZE bytes
+ *   oldest : first frame the client still waits for
+ *   sent   : frames sent so far
+ *
+ * Return:
+ *   size of the request, 0 if nothing is missing
+ ******************************************************************************/
+static uint32_t write_nack(uint8_t *nack, uint32_t oldest, uint32_t sent)
+{
+    uint32_t first = oldest;
+    uint32_t num_bits;
+
+    while ((first < sent) && test_received[first])
+    {
+        first++;
+    }
+    if (first == sent)
+    {
+        return 0;
+    }
+
+    num_bits = sent - first;
+    if (num_bits > (8u * RADAR_RESEND_NACK_MAX_BITMAP))
+    {
+        num_bits = 8u * RADAR_RESEND_NACK_MAX_BITMAP;
+    }
+
+    memset(nack, 0, RADAR_RESEND_NACK_MAX_SIZE);
+    nack[0] = RADAR_NACK_COMMAND;
+    nack[1] = RADAR_FRAME_DUMMY_BYTE;
+    radar_frame_put_u32(&nack[2], first);
+    for (uint32_t bit = 0; bit < num_bits; ++bit)
+    {
+        if (!test_received[first + bit])
+        {
+            nack[RADAR_RESEND_NACK_HEADER_SIZE + (bit / 8u)] |= (uint8_t)(1u << (bit % 8u));
+        }
+    }
+
+    return RADAR_RESEND_NACK_HEADER_SIZE + ((num_bits + 7u) / 8u);
+}
+
+/*******************************************************************************
+ * Function Name: resend
+ *******************************************************************************
+ * Summary:
+ *   Sends all datagrams marked for retransmission through the channel.
+ *
+ * Parameters:
+ *   loss : one datagram in loss is dropped, 0 for none
+ *
+ * Return:
+ *   number of datagrams sent again
+ ******************************************************************************/
+static uint32_t resend(uint32_t loss)
+{
+    const uint8_t *datagram;
+    uint32_t length;
+    uint32_t count = 0;
+
+    while ((length = radar_resend_next(&test_ring, &datagram)) != 0)
+    {
+        if ((loss == 0) || (next_random(loss) != 0))
+        {
+            receive(datagram, length);
+        }
+        count++;
+    }
+    TEST_CHECK(test_ring.num_requested == 0);
+
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: test_config_is_valid
+ *******************************************************************************
+ * Summary:
+ *   The depth stays within the ring and the budget within its limits.
+ ******************************************************************************/
+static void test_config_is_valid(void)
+{
+    radar_resend_config_t config = { .depth = 0, .budget = RADAR_RESEND_DEFAULT_BUDGET };
+
+    TEST_CHECK(radar_resend_config_is_valid(&config));
+    config.depth = RADAR_RESEND_MAX_DEPTH;
+    TEST_CHECK(radar_resend_config_is_valid(&config));
+    config.depth = RADAR_RESEND_MAX_DEPTH + 1u;
+    TEST_CHECK(!radar_resend_config_is_valid(&config));
+    config.depth = TEST_DEPTH;
+    config.budget = 0;
+    TEST_CHECK(!radar_resend_config_is_valid(&config));
+    config.budget = RADAR_RESEND_MAX_BUDGET + 1u;
+    TEST_CHECK(!radar_resend_config_is_valid(&config));
+}
+
+/*******************************************************************************
+ * Function Name: test_request
+ *******************************************************************************
+ * Summary:
+ *   A request marks the frames of its bitmap that are still in the ring,
+ *   once, and they are sent again oldest first.
+ ******************************************************************************/
+static void test_request(void)
+{
+    uint8_t nack[RADAR_RESEND_NACK_MAX_SIZE] = { RADAR_NACK_COMMAND, RADAR_FRAME_DUMMY_BYTE };
+    const uint8_t *datagram;
+
+    start(TEST_DEPTH);
+    for (uint32_t frame = 0; frame < 40u; ++frame)
+    {
+        send_frame(frame, 0);
+    }
+
+    /* Frames 4 and 5 fell out of the ring, 10, 11 and 20 are resent */
+    radar_frame_put_u32(&nack[2], 4);
+    nack[RADAR_RESEND_NACK_HEADER_SIZE] = 0xC3;
+    nack[RADAR_RESEND_NACK_HEADER_SIZE + 2u] = 0x01;
+    TEST_CHECK(radar_resend_request(&test_ring, nack, RADAR_RESEND_NACK_HEADER_SIZE + 3u) == 3u);
+    TEST_CHECK(radar_resend_request(&test_ring, nack, RADAR_RESEND_NACK_HEADER_SIZE + 3u) == 0);
+
+    TEST_CHECK(radar_resend_next(&test_ring, &datagram) != 0);
+    TEST_CHECK(radar_frame_get_u32(&datagram[RADAR_FRAME_HDR_FRAME_NUM]) == 10u);
+    TEST_CHECK(radar_resend_next(&test_ring, &datagram) != 0);
+    TEST_CHECK(radar_frame_get_u32(&datagram[RADAR_FRAME_HDR_FRAME_NUM]) == 11u);
+    TEST_CHECK(radar_resend_next(&test_ring, &datagram) != 0);
+    TEST_CHECK(radar_frame_get_u32(&datagram[RADAR_FRAME_HDR_FRAME_NUM]) == 20u);
+    TEST_CHECK(radar_resend_next(&test_ring, &datagram) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: test_invalid_request
+ *******************************************************************************
+ * Summary:
+ *   Requests without a bitmap, with a bitmap too long or of another command
+ *   are ignored.
+ ******************************************************************************/
+static void test_invalid_request(void)
+{
+    uint8_t nack[RADAR_RESEND_NACK_MAX_SIZE + 1u];
+
+    start(TEST_DEPTH);
+    for (uint32_t frame = 0; frame < 8u; ++frame)
+    {
+        send_frame(frame, 0);
+    }
+
+    memset(nack, 0xFF, sizeof(nack));
+    nack[0] = RADAR_NACK_COMMAND;
+    radar_frame_put_u32(&nack[2], 0);
+    TEST_CHECK(radar_resend_request(&test_ring, nack, RADAR_RESEND_NACK_HEADER_SIZE) == 0);
+    TEST_CHECK(radar_resend_request(&test_ring, nack, sizeof(nack)) == 0);
+    nack[0] = RADAR_DATA_COMMAND;
+    TEST_CHECK(radar_resend_request(&test_ring, nack, RADAR_RESEND_NACK_HEADER_SIZE + 1u) == 0);
+    TEST_CHECK(test_ring.num_requested == 0);
+}
+
+/*******************************************************************************
+ * Function Name: test_random_loss
+ *******************************************************************************
+ * Summary:
+ *   With 10 percent of the frame and resent datagrams dropped and a request
+ *   every 8 frames, every lost frame is asked for until it arrives, and
+ *   nothing arrives twice.
+ ******************************************************************************/
+static void test_random_loss(void)
+{
+    uint8_t nack[RADAR_RESEND_NACK_MAX_SIZE];
+    uint32_t oldest = 0;
+    uint32_t num_resent = 0;
+    uint32_t num_lost = 0;
+
+    start(TEST_DEPTH);
+    for (uint32_t frame = 0; frame < TEST_MAX_FRAMES; ++frame)
+    {
+        send_frame(frame, 10);
+        num_lost += test_received[frame] ? 0u : 1u;
+
+        if (((frame + 1u) % TEST_NACK_INTERVAL) == 0)
+        {
+            const uint32_t length = write_nack(nack, oldest, frame + 1u);
+
+            if (length != 0)
+            {
+                (void)radar_resend_request(&test_ring, nack, length);
+                num_resent += resend(10);
+            }
+
+            /* The client gives up on frames that left the ring */
+            if ((frame + 1u) > TEST_DEPTH)
+            {
+                oldest = (frame + 1u) - TEST_DEPTH;
+            }
+        }
+    }
+
+    for (uint32_t frame = 0; frame < TEST_MAX_FRAMES; ++frame)
+    {
+        TEST_CHECK(test_received[frame]);
+    }
+    TEST_CHECK(test_duplicates == 0);
+    /* Every loss is resent about 1 / 0.9 times */
+    TEST_CHECK_NEAR(num_resent, num_lost / 0.9, num_lost * 0.05);
+}
+
+/*******************************************************************************
+ * Function Name: test_keep
+ *******************************************************************************
+ * Summary:
+ *   Datagrams kept while the link is down are sent in order. Once the ring
+ *   is full the oldest are dropped with their mark.
+ ******************************************************************************/
+static void test_keep(void)
+{
+    uint8_t data[TEST_MAX_DATAGRAM];
+    const uint8_t *datagram;
+
+    start(8);
+    for (uint32_t frame = 0; frame < 12u; ++frame)
+    {
+        const uint32_t length = make_datagram(data, frame);
+
+        TEST_CHECK(radar_resend_keep(&test_ring, data, length));
+    }
+    TEST_CHECK(test_ring.num_requested == 8u);
+
+    for (uint32_t frame = 4; frame < 12u; ++frame)
+    {
+        TEST_CHECK(radar_resend_next(&test_ring, &datagram) != 0);
+        TEST_CHECK(radar_frame_get_u32(&datagram[RADAR_FRAME_HDR_FRAME_NUM]) == frame);
+    }
+    TEST_CHECK(radar_resend_next(&test_ring, &datagram) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: test_depth
+ *******************************************************************************
+ * Summary:
+ *   A new depth empties the ring, no depth keeps nothing and datagrams that
+ *   do not fit are not kept.
+ ******************************************************************************/
+static void test_depth(void)
+{
+    uint8_t data[TEST_MAX_DATAGRAM + 1u];
+    const uint8_t *datagram;
+
+    start(4);
+    TEST_CHECK(radar_resend_keep(&test_ring, data, make_datagram(data, 1)));
+    radar_resend_set_depth(&test_ring, 8);
+    TEST_CHECK(test_ring.num_requested == 0);
+    TEST_CHECK(radar_resend_next(&test_ring, &datagram) == 0);
+
+    TEST_CHECK(!radar_resend_store(&test_ring, data, RADAR_FRAME_HEADER_SIZE - 1u));
+    TEST_CHECK(!radar_resend_store(&test_ring, data, sizeof(data)));
+
+    radar_resend_set_depth(&test_ring, 0);
+    TEST_CHECK(!radar_resend_keep(&test_ring, data, make_datagram(data, 2)));
+    TEST_CHECK(test_ring.num_requested == 0);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_config_is_valid);
+    TEST_RUN(test_request);
+    TEST_RUN(test_invalid_request);
+    TEST_RUN(test_random_loss);
+    TEST_RUN(test_keep);
+    TEST_RUN(test_depth);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,370 @@
+/*****************************************************************************
+ * File name: test_radar_spectro.c
+ *
+ * Description: This file contains the host unit tests of the micro-Doppler
+ * spectrogram against a reference signal: a target whose slow-time phase
+ * turns at a known Doppler bin of the window.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_spectro.h"
+#include "radar_test.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_PI                 (3.14159265358979323846)
+
+#define TEST_SAMPLES            (64u)
+#define TEST_CHIRPS             (2u)
+#define TEST_ANTENNAS           (2u)
+
+/* Range bin of the target, the spectrogram also covers the next bin */
+#define TEST_RANGE_BIN          (6u)
+#define TEST_RANGE_BINS         (2u)
+
+#define TEST_WINDOW             (64u)
+#define TEST_HOP                (8u)
+#define TEST_HALF               (TEST_WINDOW / 2u)
+
+#define TEST_COLUMN_SIZE        RADAR_SPECTRO_COLUMN_SIZE(TEST_RANGE_BINS, TEST_WINDOW)
+
+/* Smallest distance of the Doppler bins away from the tone to the peak,
+ * 30 dB in steps of 0.5 dB */
+#define TEST_SIDELOBE_STEPS     (60u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static uint16_t test_frame[TEST_SAMPLES * TEST_CHIRPS * TEST_ANTENNAS];
+static uint8_t test_column[TEST_COLUMN_SIZE];
+static radar_spectro_t test_spectro;
+static double test_phase;
+static uint32_t test_random = 1;
+
+static const radar_geometry_t test_geometry = {
+    .samples_per_chirp = TEST_SAMPLES,
+    .chirps_per_frame = TEST_CHIRPS,
+    .rx_antennas = TEST_ANTENNAS
+};
+
+static const radar_spectro_config_t test_config = {
+    .range_bin = TEST_RANGE_BIN,
+    .range_bins = TEST_RANGE_BINS,
+    .window = TEST_WINDOW,
+    .hop = TEST_HOP
+};
+
+/*******************************************************************************
+ * Function Name: next_random
+ *******************************************************************************
+ * Summary:
+ *   Linear congruential generator, the tests see the same noise every run.
+ *
+ * Parameters:
+ *   range : number of values
+ *
+ * Return:
+ *   value from 0 to range - 1
+ ******************************************************************************/
+static uint32_t next_random(uint32_t range)
+{
+    test_random = (test_random * 1103515245u) + 12345u;
+    return (test_random >> 16) % range;
+}
+
+/*******************************************************************************
+ * Function Name: fill_frame
+ *******************************************************************************
+ * Summary:
+ *   Writes the next frame of the reference signal: the beat signal of the
+ *   target on antenna 1, whose phase turns by one Doppler bin of the window
+ *   per window, an unrelated target on antenna 2, and noise of a few ADC
+ *   counts.
+ *
+ * Parameters:
+ *   doppler : Doppler bin of the target, negative when moving away
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void fill_frame(int32_t doppler)
+{
+    uint16_t *sample = test_frame;
+
+    test_phase += (2.0 * TEST_PI * (double)doppler) / TEST_WINDOW;
+
+    for (uint32_t chirp = 0; chirp < TEST_CHIRPS; ++chirp)
+    {
+        for (uint32_t s = 0; s < TEST_SAMPLES; ++s)
+        {
+            const double beat = (2.0 * TEST_PI * TEST_RANGE_BIN * s) / TEST_SAMPLES;
+
+            *sample++ = (uint16_t)lround(2048.0 + (400.0 * cos(beat + test_phase)) + (double)next_random(9) - 4.0);
+            *sample++ = (uint16_t)lround(2048.0 + (400.0 * cos(3.0 * beat)));
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: run_frames
+ *******************************************************************************
+ * Summary:
+ *   Feeds frames of a target at one Doppler bin and writes the last column
+ *   that was due.
+ *
+ * Parameters:
+ *   num_frames : number of frames
+ *   doppler    : Doppler bin of the target
+ *
+ * Return:
+ *   number of columns
+ ******************************************************************************/
+static uint32_t run_frames(uint32_t num_frames, int32_t doppler)
+{
+    uint32_t num_columns = 0;
+
+    for (uint32_t frame = 0; frame < num_frames; ++frame)
+    {
+        fill_frame(doppler);
+        if (radar_spectro_process(&test_spectro, &test_geometry, test_frame))
+        {
+            TEST_CHECK(radar_spectro_write_column(&test_spectro, test_column) == TEST_COLUMN_SIZE);
+            num_columns++;
+        }
+    }
+
+    return num_columns;
+}
+
+/*******************************************************************************
+ * Function Name: start
+ *******************************************************************************
+ * Summary:
+ *   Starts the spectrogram and the reference signal over.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void start(void)
+{
+    test_random = 1;
+    test_phase = 0.0;
+    radar_spectro_init(&test_spectro, &test_config);
+}
+
+/*******************************************************************************
+ * Function Name: check_tone
+ *******************************************************************************
+ * Summary:
+ *   Checks that every range bin block of the last column peaks at the Doppler
+ *   bin of the target and that the bins away from its main lobe are low.
+ *
+ * Parameters:
+ *   doppler : Doppler bin of the target
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void check_tone(int32_t doppler)
+{
+    const uint8_t *block = &test_column[RADAR_SPECTRO_HEADER_SIZE];
+
+    for (uint32_t bin = 0; bin < TEST_RANGE_BINS; ++bin)
+    {
+        const uint8_t *level = &block[2];
+        const uint32_t peak = (uint32_t)((int32_t)TEST_HALF + doppler);
+
+        TEST_CHECK(level[peak] == 0);
+        TEST_CHECK((block[0] | (block[1] << 8)) > 0);
+
+        for (uint32_t i = 0; i < TEST_WINDOW; ++i)
+        {
+            if ((i + 3u < peak) || (i > peak + 3u))
+            {
+                TEST_CHECK(level[i] >= TEST_SIDELOBE_STEPS);
+            }
+        }
+
+        block += 2u + TEST_WINDOW;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_config_is_valid
+ *******************************************************************************
+ * Summary:
+ *   The window is a power of 2 within its limits and the hop fits into it.
+ ******************************************************************************/
+static void test_config_is_valid(void)
+{
+    radar_spectro_config_t config = test_config;
+
+    TEST_CHECK(radar_spectro_config_is_valid(&config));
+
+    config.window = RADAR_SPECTRO_MIN_WINDOW / 2u;
+    config.hop = 1;
+    TEST_CHECK(!radar_spectro_config_is_valid(&config));
+    config.window = RADAR_SPECTRO_MAX_WINDOW * 2u;
+    TEST_CHECK(!radar_spectro_config_is_valid(&config));
+    config.window = 48;
+    TEST_CHECK(!radar_spectro_config_is_valid(&config));
+
+    config = test_config;
+    config.hop = 0;
+    TEST_CHECK(!radar_spectro_config_is_valid(&config));
+    config.hop = TEST_WINDOW + 1u;
+    TEST_CHECK(!radar_spectro_config_is_valid(&config));
+
+    config = test_config;
+    config.range_bins = 0;
+    TEST_CHECK(!radar_spectro_config_is_valid(&config));
+    config.range_bins = RADAR_SPECTRO_MAX_RANGE_BINS + 1u;
+    TEST_CHECK(!radar_spectro_config_is_valid(&config));
+}
+
+/*******************************************************************************
+ * Function Name: test_columns
+ *******************************************************************************
+ * Summary:
+ *   The first column is due once the window is full, then one every hop.
+ ******************************************************************************/
+static void test_columns(void)
+{
+    start();
+
+    TEST_CHECK(run_frames(TEST_WINDOW - 1u, 5) == 0);
+    TEST_CHECK(run_frames(1, 5) == 1);
+    TEST_CHECK(run_frames(TEST_HOP - 1u, 5) == 0);
+    TEST_CHECK(run_frames(1, 5) == 1);
+    TEST_CHECK(run_frames(4u * TEST_HOP, 5) == 4);
+}
+
+/*******************************************************************************
+ * Function Name: test_tone
+ *******************************************************************************
+ * Summary:
+ *   Targets approaching and moving away show up at their Doppler bins.
+ ******************************************************************************/
+static void test_tone(void)
+{
+    static const int32_t dopplers[] = { 10, -20, 0, (int32_t)TEST_HALF - 4 };
+
+    for (uint32_t i = 0; i < (sizeof(dopplers) / sizeof(dopplers[0])); ++i)
+    {
+        start();
+        TEST_CHECK(run_frames(TEST_WINDOW, dopplers[i]) == 1);
+        check_tone(dopplers[i]);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_micro_doppler
+ *******************************************************************************
+ * Summary:
+ *   When the target turns around, the columns follow it one hop at a time:
+ *   a full window later only the new Doppler bin is left.
+ ******************************************************************************/
+static void test_micro_doppler(void)
+{
+    start();
+
+    (void)run_frames(TEST_WINDOW, 12);
+    check_tone(12);
+
+    /* Half a window later both Doppler bins are in the column */
+    (void)run_frames(TEST_HALF, -12);
+    TEST_CHECK(test_column[RADAR_SPECTRO_HEADER_SIZE + 2u + TEST_HALF + 12u] < 20u);
+    TEST_CHECK(test_column[RADAR_SPECTRO_HEADER_SIZE + 2u + TEST_HALF - 12u] < 20u);
+
+    (void)run_frames(TEST_HALF, -12);
+    check_tone(-12);
+}
+
+/*******************************************************************************
+ * Function Name: test_reset
+ *******************************************************************************
+ * Summary:
+ *   A reset empties the window: the next column needs a full window of new
+ *   frames and holds none of the old target.
+ ******************************************************************************/
+static void test_reset(void)
+{
+    start();
+    (void)run_frames(TEST_WINDOW + TEST_HOP, 8);
+
+    radar_spectro_reset(&test_spectro);
+    TEST_CHECK(run_frames(TEST_WINDOW - 1u, -8) == 0);
+    TEST_CHECK(run_frames(1, -8) == 1);
+    check_tone(-8);
+}
+
+/*******************************************************************************
+ * Function Name: test_layout
+ *******************************************************************************
+ * Summary:
+ *   The column header holds the settings and the peak level fits the
+ *   amplitude of the target.
+ ******************************************************************************/
+static void test_layout(void)
+{
+    const uint8_t expected[RADAR_SPECTRO_HEADER_SIZE] = { TEST_RANGE_BIN, 0, TEST_RANGE_BINS, 6, TEST_HOP, 0 };
+    uint32_t peak;
+
+    start();
+    (void)run_frames(TEST_WINDOW, 3);
+
+    TEST_CHECK(memcmp(test_column, expected, sizeof(expected)) == 0);
+
+    /* Amplitude 400 with both Hann windows summed over the chirps and the
+     * window: 200 * samples / 2 * chirps * window / 2 */
+    peak = test_column[RADAR_SPECTRO_HEADER_SIZE] | (test_column[RADAR_SPECTRO_HEADER_SIZE + 1u] << 8);
+    TEST_CHECK_NEAR(peak / 100.0, 20.0 * log10(200.0 * (TEST_SAMPLES / 2u) * TEST_CHIRPS * (TEST_WINDOW / 2u)), 0.5);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_config_is_valid);
+    TEST_RUN(test_columns);
+    TEST_RUN(test_tone);
+    TEST_RUN(test_micro_doppler);
+    TEST_RUN(test_reset);
+    TEST_RUN(test_layout);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,220 @@
+/*****************************************************************************
+ * File name: test_radar_stream.c
+ *
+ * Description: This file contains the host unit tests of the TCP stream
+ * framing: frame datagrams are prefixed with their size and coalesced into
+ * segments, and split up again from partial reads the way the client does.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+
+/* Header file from system */
+#include <stdio.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_stream.h"
+#include "radar_test.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_SEGMENT_SIZE       (64u)
+#define TEST_MAX_DATAGRAM       (40u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static uint8_t test_buffer[RADAR_STREAM_BUFFER_SIZE(TEST_SEGMENT_SIZE, TEST_MAX_DATAGRAM)];
+static radar_stream_t test_stream;
+
+/*******************************************************************************
+ * Function Name: make_datagram
+ *******************************************************************************
+ * Summary:
+ *   Fills a datagram with bytes that follow from its number and position.
+ *
+ * Parameters:
+ *   data   : output, length bytes
+ *   length : size of the datagram
+ *   number : datagram number
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void make_datagram(uint8_t *data, uint32_t length, uint32_t number)
+{
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        data[i] = (uint8_t)((number * 31u) + i);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: test_prefix
+ *******************************************************************************
+ * Summary:
+ *   A datagram is written after its size, 4 bytes little endian.
+ ******************************************************************************/
+static void test_prefix(void)
+{
+    uint8_t data[TEST_MAX_DATAGRAM];
+
+    radar_stream_init(&test_stream, test_buffer, TEST_SEGMENT_SIZE, TEST_MAX_DATAGRAM);
+    make_datagram(data, 10, 1);
+    TEST_CHECK(radar_stream_add(&test_stream, data, 10));
+    TEST_CHECK(test_stream.length == (RADAR_STREAM_LENGTH_SIZE + 10u));
+    TEST_CHECK(test_stream.frames == 1);
+    TEST_CHECK((test_buffer[0] == 10) && (test_buffer[1] == 0) && (test_buffer[2] == 0) && (test_buffer[3] == 0));
+    TEST_CHECK(memcmp(&test_buffer[RADAR_STREAM_LENGTH_SIZE], data, 10) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: test_coalesce
+ *******************************************************************************
+ * Summary:
+ *   Datagrams are collected until they fill a segment, the last one overruns
+ *   it, and no datagram is taken until the stream was written.
+ ******************************************************************************/
+static void test_coalesce(void)
+{
+    uint8_t data[TEST_MAX_DATAGRAM];
+
+    radar_stream_init(&test_stream, test_buffer, TEST_SEGMENT_SIZE, TEST_MAX_DATAGRAM);
+    make_datagram(data, 20, 1);
+    TEST_CHECK(radar_stream_add(&test_stream, data, 20));
+    TEST_CHECK(radar_stream_add(&test_stream, data, 20));
+    TEST_CHECK(!radar_stream_is_full(&test_stream));
+
+    TEST_CHECK(radar_stream_add(&test_stream, data, TEST_MAX_DATAGRAM));
+    TEST_CHECK(radar_stream_is_full(&test_stream));
+    TEST_CHECK(test_stream.length == ((3u * RADAR_STREAM_LENGTH_SIZE) + 40u + TEST_MAX_DATAGRAM));
+    TEST_CHECK(test_stream.length <= sizeof(test_buffer));
+    TEST_CHECK(test_stream.frames == 3);
+
+    TEST_CHECK(!radar_stream_add(&test_stream, data, 1));
+    TEST_CHECK(test_stream.frames == 3);
+
+    radar_stream_clear(&test_stream);
+    TEST_CHECK((test_stream.length == 0) && (test_stream.frames == 0));
+    TEST_CHECK(radar_stream_add(&test_stream, data, 1));
+}
+
+/*******************************************************************************
+ * Function Name: test_oversize
+ *******************************************************************************
+ * Summary:
+ *   A datagram larger than the largest frame datagram is not taken.
+ ******************************************************************************/
+static void test_oversize(void)
+{
+    uint8_t data[TEST_MAX_DATAGRAM + 1u];
+
+    radar_stream_init(&test_stream, test_buffer, TEST_SEGMENT_SIZE, TEST_MAX_DATAGRAM);
+    make_datagram(data, sizeof(data), 1);
+    TEST_CHECK(!radar_stream_add(&test_stream, data, sizeof(data)));
+    TEST_CHECK((test_stream.length == 0) && (test_stream.frames == 0));
+}
+
+/*******************************************************************************
+ * Function Name: test_partial_reads
+ *******************************************************************************
+ * Summary:
+ *   The receiver splits the stream into the datagrams sent, whatever sizes
+ *   the reads come in, and waits for the rest of a split datagram.
+ ******************************************************************************/
+static void test_partial_reads(void)
+{
+    static const uint32_t lengths[] = { 0, 1, 17, TEST_MAX_DATAGRAM, 5, 33, TEST_MAX_DATAGRAM, 2 };
+    const uint32_t num_datagrams = sizeof(lengths) / sizeof(lengths[0]);
+    uint8_t sent[sizeof(lengths) / sizeof(lengths[0]) * (RADAR_STREAM_LENGTH_SIZE + TEST_MAX_DATAGRAM)];
+    uint8_t received[sizeof(sent)];
+    uint8_t data[TEST_MAX_DATAGRAM];
+    uint32_t sent_length = 0;
+
+    /* The stream as written: every segment in turn */
+    radar_stream_init(&test_stream, test_buffer, TEST_SEGMENT_SIZE, TEST_MAX_DATAGRAM);
+    for (uint32_t i = 0; i < num_datagrams; ++i)
+    {
+        make_datagram(data, lengths[i], i);
+        TEST_CHECK(radar_stream_add(&test_stream, data, lengths[i]));
+        if (radar_stream_is_full(&test_stream) || (i == (num_datagrams - 1u)))
+        {
+            memcpy(&sent[sent_length], test_buffer, test_stream.length);
+            sent_length += test_stream.length;
+            radar_stream_clear(&test_stream);
+        }
+    }
+
+    for (uint32_t read_size = 1; read_size <= 13; read_size += 3)
+    {
+        uint32_t received_length = 0;
+        uint32_t offset = 0;
+        uint32_t next = 0;
+
+        while (offset < sent_length)
+        {
+            const uint32_t size = ((sent_length - offset) < read_size) ? (sent_length - offset) : read_size;
+            const uint8_t *datagram;
+            uint32_t datagram_length;
+            uint32_t taken;
+
+            memcpy(&received[received_length], &sent[offset], size);
+            received_length += size;
+            offset += size;
+
+            while ((taken = radar_stream_next(received, received_length, &datagram, &datagram_length)) != 0)
+            {
+                TEST_CHECK(next < num_datagrams);
+                if (next < num_datagrams)
+                {
+                    make_datagram(data, lengths[next], next);
+                    TEST_CHECK(datagram_length == lengths[next]);
+                    TEST_CHECK(memcmp(datagram, data, datagram_length) == 0);
+                }
+                next++;
+                memmove(received, &received[taken], received_length - taken);
+                received_length -= taken;
+            }
+        }
+
+        TEST_CHECK(next == num_datagrams);
+        TEST_CHECK(received_length == 0);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_prefix);
+    TEST_RUN(test_coalesce);
+    TEST_RUN(test_oversize);
+    TEST_RUN(test_partial_reads);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
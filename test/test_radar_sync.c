@@ -0,0 +1,377 @@
+/*****************************************************************************
+ * File name: test_radar_sync.c
+ *
+ * Description: This file contains the host unit tests of the time
+ * synchronization: request and response exchanges with a simulated host clock
+ * that is offset and drifts, over a network with injected delay jitter and
+ * lost responses.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <stdio.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_frame.h"
+#include "radar_sync.h"
+#include "radar_test.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Host clock against the device clock: 1000 s ahead, 40 ppm faster */
+#define TEST_HOST_OFFSET_US     (1000000000LL)
+#define TEST_HOST_DRIFT_PPM     (40)
+
+/* Network delay of each direction: the base delay, a few 100 us of jitter
+ * and in one of three datagrams queueing of up to TEST_QUEUEING_US, and the
+ * host turnaround */
+#define TEST_BASE_DELAY_US      (800u)
+#define TEST_JITTER_US          (300u)
+#define TEST_QUEUEING_US        (20000u)
+#define TEST_TURNAROUND_US      (150u)
+
+/* One exchange per second */
+#define TEST_INTERVAL_US        (1000000u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static radar_sync_t test_sync;
+static uint64_t test_now;               /* device time */
+static int64_t test_host_step;          /* host clock steps so far */
+static uint32_t test_random = 1;
+
+/*******************************************************************************
+ * Function Name: next_random
+ *******************************************************************************
+ * Summary:
+ *   Linear congruential generator, the tests see the same jitter every run.
+ *
+ * Parameters:
+ *   range : number of values
+ *
+ * Return:
+ *   value from 0 to range - 1
+ ******************************************************************************/
+static uint32_t next_random(uint32_t range)
+{
+    test_random = (test_random * 1103515245u) + 12345u;
+    return (test_random >> 16) % range;
+}
+
+/*******************************************************************************
+ * Function Name: host_clock
+ *******************************************************************************
+ * Summary:
+ *   Reads the simulated host clock at a device time.
+ *
+ * Parameters:
+ *   device_time : device time in microseconds
+ *
+ * Return:
+ *   host time in microseconds
+ ******************************************************************************/
+static uint64_t host_clock(uint64_t device_time)
+{
+    return (uint64_t)((int64_t)device_time + TEST_HOST_OFFSET_US + test_host_step +
+                      (((int64_t)device_time * TEST_HOST_DRIFT_PPM) / 1000000));
+}
+
+/*******************************************************************************
+ * Function Name: start
+ *******************************************************************************
+ * Summary:
+ *   Starts without an estimate, 10 s after the device booted.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void start(void)
+{
+    radar_sync_init(&test_sync);
+    test_now = 10000000u;
+    test_host_step = 0;
+    test_random = 1;
+}
+
+/*******************************************************************************
+ * Function Name: exchange
+ *******************************************************************************
+ * Summary:
+ *   Sends a request and answers it the way the host does, after the given
+ *   delays, then waits for the next exchange.
+ *
+ * Parameters:
+ *   up_us   : delay of the request
+ *   down_us : delay of the response
+ *   lost    : true if the response never arrives
+ *
+ * Return:
+ *   result of radar_sync_process_response, false if the response was lost
+ ******************************************************************************/
+static bool exchange(uint32_t up_us, uint32_t down_us, bool lost)
+{
+    uint8_t data[RADAR_SYNC_RESPONSE_SIZE];
+    uint64_t received;
+    bool answered = false;
+
+    TEST_CHECK(radar_sync_write_request(&test_sync, data, test_now) == RADAR_SYNC_REQUEST_SIZE);
+
+    received = test_now + up_us;
+    radar_frame_put_u64(&data[14], host_clock(received));
+    radar_frame_put_u64(&data[22], host_clock(received + TEST_TURNAROUND_US));
+
+    if (!lost)
+    {
+        answered = radar_sync_process_response(&test_sync, data, sizeof(data),
+                                               received + TEST_TURNAROUND_US + down_us);
+    }
+    test_now += TEST_INTERVAL_US;
+
+    return answered;
+}
+
+/*******************************************************************************
+ * Function Name: network_delay
+ *******************************************************************************
+ * Summary:
+ *   Delay of one direction with jitter and random queueing.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   delay in microseconds
+ ******************************************************************************/
+static uint32_t network_delay(void)
+{
+    uint32_t delay = TEST_BASE_DELAY_US + next_random(TEST_JITTER_US);
+
+    if (next_random(3) == 0)
+    {
+        delay += next_random(TEST_QUEUEING_US);
+    }
+
+    return delay;
+}
+
+/*******************************************************************************
+ * Function Name: jittered_exchange
+ *******************************************************************************
+ * Summary:
+ *   Exchange with jitter and queueing on both directions, one response in
+ *   five lost.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void jittered_exchange(void)
+{
+    const uint32_t up = network_delay();
+    const uint32_t down = network_delay();
+
+    (void)exchange(up, down, next_random(5) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: host_time_error
+ *******************************************************************************
+ * Summary:
+ *   Error of the estimated host time at the current device time.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   estimated minus true host time in microseconds
+ ******************************************************************************/
+static int64_t host_time_error(void)
+{
+    uint64_t host_time = 0;
+
+    TEST_CHECK(radar_sync_host_time(&test_sync, test_now, &host_time));
+    return (int64_t)(host_time - host_clock(test_now));
+}
+
+/*******************************************************************************
+ * Function Name: test_request
+ *******************************************************************************
+ * Summary:
+ *   The request holds the command, the sequence number and the send time.
+ ******************************************************************************/
+static void test_request(void)
+{
+    uint8_t data[RADAR_SYNC_REQUEST_SIZE];
+
+    start();
+    TEST_CHECK(radar_sync_write_request(&test_sync, data, 0x0102030405060708uLL) == sizeof(data));
+    TEST_CHECK((data[0] == RADAR_SYNC_COMMAND) && (data[1] == RADAR_FRAME_DUMMY_BYTE));
+    TEST_CHECK(radar_frame_get_u32(&data[2]) == 1u);
+    TEST_CHECK(radar_frame_get_u64(&data[6]) == 0x0102030405060708uLL);
+
+    (void)radar_sync_write_request(&test_sync, data, 0);
+    TEST_CHECK(radar_frame_get_u32(&data[2]) == 2u);
+}
+
+/*******************************************************************************
+ * Function Name: test_invalid_response
+ *******************************************************************************
+ * Summary:
+ *   Responses of the wrong size, to an older request or answered twice are
+ *   ignored, and there is no estimate before the first valid one.
+ ******************************************************************************/
+static void test_invalid_response(void)
+{
+    uint8_t stale[RADAR_SYNC_RESPONSE_SIZE];
+    uint8_t data[RADAR_SYNC_RESPONSE_SIZE];
+    uint64_t host_time = 0;
+
+    start();
+    TEST_CHECK(!radar_sync_host_time(&test_sync, test_now, &host_time));
+    TEST_CHECK(host_time == 0);
+
+    (void)radar_sync_write_request(&test_sync, stale, test_now);
+    radar_frame_put_u64(&stale[14], host_clock(test_now));
+    radar_frame_put_u64(&stale[22], host_clock(test_now));
+
+    test_now += 1000u;
+    (void)radar_sync_write_request(&test_sync, data, test_now);
+    radar_frame_put_u64(&data[14], host_clock(test_now));
+    radar_frame_put_u64(&data[22], host_clock(test_now));
+
+    TEST_CHECK(!radar_sync_process_response(&test_sync, stale, sizeof(stale), test_now));
+    TEST_CHECK(!radar_sync_process_response(&test_sync, data, RADAR_SYNC_REQUEST_SIZE, test_now));
+    data[0] = RADAR_DATA_COMMAND;
+    TEST_CHECK(!radar_sync_process_response(&test_sync, data, sizeof(data), test_now));
+    TEST_CHECK(!radar_sync_host_time(&test_sync, test_now, &host_time));
+
+    data[0] = RADAR_SYNC_COMMAND;
+    TEST_CHECK(radar_sync_process_response(&test_sync, data, sizeof(data), test_now));
+    TEST_CHECK(!radar_sync_process_response(&test_sync, data, sizeof(data), test_now));
+    TEST_CHECK(radar_sync_host_time(&test_sync, test_now, &host_time));
+}
+
+/*******************************************************************************
+ * Function Name: test_symmetric
+ *******************************************************************************
+ * Summary:
+ *   Without jitter a single exchange gives the offset, the delay is the
+ *   round trip without the host turnaround.
+ ******************************************************************************/
+static void test_symmetric(void)
+{
+    start();
+    TEST_CHECK(exchange(TEST_BASE_DELAY_US, TEST_BASE_DELAY_US, false));
+    TEST_CHECK(test_sync.last_delay == (2 * TEST_BASE_DELAY_US));
+
+    /* The drift of the last interval is not known yet */
+    test_now -= TEST_INTERVAL_US;
+    TEST_CHECK_NEAR(host_time_error(), 0, 1);
+}
+
+/*******************************************************************************
+ * Function Name: test_jitter
+ *******************************************************************************
+ * Summary:
+ *   With up to 20 ms of queueing in each direction and lost responses the
+ *   estimate stays within a millisecond: single exchanges are off by up to
+ *   half the jitter, the filter takes the least queued one, and the drift of
+ *   the host clock is tracked.
+ ******************************************************************************/
+static void test_jitter(void)
+{
+    int64_t max_error = 0;
+
+    start();
+    for (uint32_t i = 0; i < 600u; ++i)
+    {
+        jittered_exchange();
+
+        /* Settled after two minutes */
+        if (i >= 120u)
+        {
+            const int64_t error = host_time_error();
+
+            if ((error > max_error) || (-error > max_error))
+            {
+                max_error = (error > 0) ? error : -error;
+            }
+        }
+    }
+
+    TEST_CHECK(max_error < 1000);
+    TEST_CHECK_NEAR(test_sync.drift * 1e6, TEST_HOST_DRIFT_PPM, 5);
+    TEST_CHECK(test_sync.last_delay < (int64_t)(2u * (TEST_BASE_DELAY_US + TEST_JITTER_US)));
+}
+
+/*******************************************************************************
+ * Function Name: test_step
+ *******************************************************************************
+ * Summary:
+ *   When the host clock is stepped the offset starts over instead of
+ *   slewing towards it, the drift learned so far is kept.
+ ******************************************************************************/
+static void test_step(void)
+{
+    start();
+    for (uint32_t i = 0; i < 120u; ++i)
+    {
+        jittered_exchange();
+    }
+    TEST_CHECK_NEAR(host_time_error(), 0, 1000);
+
+    /* Stepped back by 2 s, the old exchanges leave the filter after 8 */
+    test_host_step = -2000000;
+    for (uint32_t i = 0; i < (2u * RADAR_SYNC_FILTER_LENGTH); ++i)
+    {
+        (void)exchange(TEST_BASE_DELAY_US, TEST_BASE_DELAY_US, false);
+    }
+    test_now -= TEST_INTERVAL_US;
+    TEST_CHECK_NEAR(host_time_error(), 0, 1000);
+    TEST_CHECK_NEAR(test_sync.drift * 1e6, TEST_HOST_DRIFT_PPM, 15);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_request);
+    TEST_RUN(test_invalid_response);
+    TEST_RUN(test_symmetric);
+    TEST_RUN(test_jitter);
+    TEST_RUN(test_step);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
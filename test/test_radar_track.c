@@ -0,0 +1,453 @@
+/*****************************************************************************
+ * File name: test_radar_track.c
+ *
+ * Description: This file contains the host unit tests of the target tracker
+ * against simulated trajectories: targets moving at constant speed, crossing
+ * each other, fading out and drowned in false alarms.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_test.h"
+#include "radar_track.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_RANGE_BINS         (64u)
+#define TEST_DOPPLER_BINS       (32u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static radar_tracker_t test_tracker;
+static radar_target_t test_targets[RADAR_CFAR_MAX_TARGETS];
+static uint32_t test_num_targets;
+static uint32_t test_random = 1;
+
+static const radar_track_config_t test_config = {
+    .interval = RADAR_TRACK_DEFAULT_INTERVAL,
+    .gate = RADAR_TRACK_DEFAULT_GATE
+};
+
+/*******************************************************************************
+ * Function Name: next_random
+ *******************************************************************************
+ * Summary:
+ *   Linear congruential generator, the tests see the same noise every run.
+ *
+ * Parameters:
+ *   range : number of values
+ *
+ * Return:
+ *   value from 0 to range - 1
+ ******************************************************************************/
+static uint32_t next_random(uint32_t range)
+{
+    test_random = (test_random * 1103515245u) + 12345u;
+    return (test_random >> 16) % range;
+}
+
+/*******************************************************************************
+ * Function Name: start
+ *******************************************************************************
+ * Summary:
+ *   Starts with an empty track table and track ids from 0.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void start(void)
+{
+    memset(&test_tracker, 0, sizeof(test_tracker));
+    test_random = 1;
+}
+
+/*******************************************************************************
+ * Function Name: detect
+ *******************************************************************************
+ * Summary:
+ *   Adds the detection of a target at its true position to the frame,
+ *   rounded to the bins the CFAR reports.
+ *
+ * Parameters:
+ *   range   : true range in bins
+ *   doppler : Doppler bin
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void detect(double range, int32_t doppler)
+{
+    radar_target_t *target = &test_targets[test_num_targets++];
+
+    target->range_bin = (uint16_t)lround(range);
+    target->doppler_bin = (int16_t)doppler;
+    target->power = 1000;
+    target->azimuth = RADAR_TARGET_ANGLE_NONE;
+    target->elevation = RADAR_TARGET_ANGLE_NONE;
+}
+
+/*******************************************************************************
+ * Function Name: update
+ *******************************************************************************
+ * Summary:
+ *   Runs the tracker on the detections of the frame and starts the next one.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void update(void)
+{
+    radar_track_update(&test_tracker, &test_config, test_targets, test_num_targets);
+    test_num_targets = 0;
+}
+
+/*******************************************************************************
+ * Function Name: find_track
+ *******************************************************************************
+ * Summary:
+ *   Looks up a track by its id.
+ *
+ * Parameters:
+ *   id : track id
+ *
+ * Return:
+ *   track or NULL if it was deleted
+ ******************************************************************************/
+static const radar_track_t *find_track(uint16_t id)
+{
+    for (uint32_t t = 0; t < test_tracker.num_tracks; ++t)
+    {
+        if (test_tracker.tracks[t].id == id)
+        {
+            return &test_tracker.tracks[t];
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: num_confirmed
+ *******************************************************************************
+ * Summary:
+ *   Counts the tracks a report would hold.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   number of confirmed tracks
+ ******************************************************************************/
+static uint32_t num_confirmed(void)
+{
+    uint8_t data[RADAR_TRACKS_SIZE(RADAR_TRACK_MAX_TRACKS)];
+
+    (void)radar_track_write(data, &test_tracker, RADAR_TRACK_MAX_TRACKS, 6, 5);
+    return (uint32_t)(data[0] | (data[1] << 8));
+}
+
+/*******************************************************************************
+ * Function Name: test_config_is_valid
+ *******************************************************************************
+ * Summary:
+ *   The report interval and the gate stay within their limits.
+ ******************************************************************************/
+static void test_config_is_valid(void)
+{
+    radar_track_config_t config = test_config;
+
+    TEST_CHECK(radar_track_config_is_valid(&config));
+    config.interval = 0;
+    TEST_CHECK(!radar_track_config_is_valid(&config));
+    config.interval = RADAR_TRACK_MAX_INTERVAL;
+    TEST_CHECK(radar_track_config_is_valid(&config));
+    config.gate = 0;
+    TEST_CHECK(!radar_track_config_is_valid(&config));
+    config.gate = RADAR_TRACK_MAX_GATE + 1;
+    TEST_CHECK(!radar_track_config_is_valid(&config));
+}
+
+/*******************************************************************************
+ * Function Name: test_confirm
+ *******************************************************************************
+ * Summary:
+ *   A new track is reported from its third detection on, a tentative track
+ *   is deleted at its first miss.
+ ******************************************************************************/
+static void test_confirm(void)
+{
+    start();
+
+    detect(20.0, 3);
+    update();
+    TEST_CHECK((test_tracker.num_tracks == 1) && (num_confirmed() == 0));
+    update();
+    TEST_CHECK(test_tracker.num_tracks == 0);
+
+    for (uint32_t frame = 1; frame <= RADAR_TRACK_CONFIRM_HITS; ++frame)
+    {
+        detect(20.0, 3);
+        update();
+        TEST_CHECK(num_confirmed() == ((frame < RADAR_TRACK_CONFIRM_HITS) ? 0u : 1u));
+    }
+    TEST_CHECK(find_track(1) != NULL);
+}
+
+/*******************************************************************************
+ * Function Name: test_constant_speed
+ *******************************************************************************
+ * Summary:
+ *   A target approaching at a quarter range bin per frame keeps one track,
+ *   which settles on its range, range rate and Doppler bin.
+ ******************************************************************************/
+static void test_constant_speed(void)
+{
+    const double rate = -0.25;
+    double range = 50.0;
+    const radar_track_t *track;
+
+    start();
+    for (uint32_t frame = 0; frame < 120u; ++frame)
+    {
+        detect(range, -4);
+        update();
+        range += rate;
+        TEST_CHECK((test_tracker.num_tracks == 1) && (test_tracker.tracks[0].id == 0));
+    }
+
+    track = find_track(0);
+    TEST_CHECK(track != NULL);
+    TEST_CHECK_NEAR(track->range, range - rate, 1.0);
+    TEST_CHECK_NEAR(track->range_rate, rate, 0.05);
+    TEST_CHECK_NEAR(track->doppler, -4.0, 0.01);
+    TEST_CHECK(track->confidence >= 97u);
+}
+
+/*******************************************************************************
+ * Function Name: test_coast
+ *******************************************************************************
+ * Summary:
+ *   A confirmed track coasts along its range rate through missed frames and
+ *   picks the target up again where it went, but is deleted after too many
+ *   misses in a row.
+ ******************************************************************************/
+static void test_coast(void)
+{
+    double range = 10.0;
+    const radar_track_t *track;
+
+    start();
+    for (uint32_t frame = 0; frame < 60u; ++frame)
+    {
+        detect(range, 6);
+        update();
+        range += 0.5;
+    }
+
+    /* Shadowed for 10 frames while it moves on by 5 range bins, more than
+     * the gate */
+    for (uint32_t frame = 0; frame < 10u; ++frame)
+    {
+        update();
+        range += 0.5;
+    }
+    track = find_track(0);
+    TEST_CHECK((track != NULL) && (track->misses == 10u) && (track->confidence < 10u));
+    TEST_CHECK(num_confirmed() == 1);
+
+    detect(range, 6);
+    update();
+    track = find_track(0);
+    TEST_CHECK((test_tracker.num_tracks == 1) && (track != NULL) && (track->misses == 0));
+
+    for (uint32_t frame = 0; frame < RADAR_TRACK_MAX_MISSES; ++frame)
+    {
+        update();
+    }
+    TEST_CHECK(find_track(0) != NULL);
+    update();
+    TEST_CHECK(test_tracker.num_tracks == 0);
+}
+
+/*******************************************************************************
+ * Function Name: test_crossing
+ *******************************************************************************
+ * Summary:
+ *   Two targets crossing in range with opposite Doppler bins keep their
+ *   tracks, the ids do not swap when they pass each other.
+ ******************************************************************************/
+static void test_crossing(void)
+{
+    double range = 10.0;
+    const radar_track_t *approaching;
+    const radar_track_t *leaving;
+
+    start();
+    for (uint32_t frame = 0; frame < 60u; ++frame)
+    {
+        detect(range, 5);
+        detect(40.0 - (range - 10.0), -5);
+        update();
+        range += 0.5;
+
+        TEST_CHECK(test_tracker.num_tracks == 2);
+        leaving = find_track(0);
+        approaching = find_track(1);
+        TEST_CHECK((leaving != NULL) && (leaving->doppler > 0.0f));
+        TEST_CHECK((approaching != NULL) && (approaching->doppler < 0.0f));
+    }
+
+    leaving = find_track(0);
+    approaching = find_track(1);
+    TEST_CHECK_NEAR(leaving->range, 39.5, 1.0);
+    TEST_CHECK_NEAR(approaching->range, 10.5, 1.0);
+    TEST_CHECK_NEAR(leaving->range_rate, 0.5, 0.05);
+    TEST_CHECK_NEAR(approaching->range_rate, -0.5, 0.05);
+}
+
+/*******************************************************************************
+ * Function Name: test_false_alarms
+ *******************************************************************************
+ * Summary:
+ *   False alarms scattered over the range Doppler map come and go as
+ *   tentative tracks, only the real target is reported.
+ ******************************************************************************/
+static void test_false_alarms(void)
+{
+    double range = 30.0;
+    uint32_t max_tracks = 0;
+
+    start();
+    for (uint32_t frame = 0; frame < 200u; ++frame)
+    {
+        detect(range, 2);
+        for (uint32_t i = 0; i < 3u; ++i)
+        {
+            detect((double)next_random(TEST_RANGE_BINS), (int32_t)next_random(TEST_DOPPLER_BINS) - 16);
+        }
+        update();
+        range += 0.1;
+
+        if (test_tracker.num_tracks > max_tracks)
+        {
+            max_tracks = test_tracker.num_tracks;
+        }
+    }
+
+    TEST_CHECK(num_confirmed() == 1);
+    TEST_CHECK((find_track(0) != NULL) && (find_track(0)->hits == 200u));
+    TEST_CHECK(max_tracks < RADAR_TRACK_MAX_TRACKS);
+}
+
+/*******************************************************************************
+ * Function Name: test_capacity
+ *******************************************************************************
+ * Summary:
+ *   Births stop when the table is full, a reset empties it and the ids keep
+ *   counting up.
+ ******************************************************************************/
+static void test_capacity(void)
+{
+    start();
+    for (uint32_t i = 0; i < RADAR_CFAR_MAX_TARGETS; ++i)
+    {
+        detect(4.0 + (8.0 * (i % 8u)), ((i / 8u) * 10) - 10);
+    }
+    update();
+    TEST_CHECK(test_tracker.num_tracks == RADAR_TRACK_MAX_TRACKS);
+
+    radar_track_reset(&test_tracker);
+    TEST_CHECK(test_tracker.num_tracks == 0);
+    detect(20.0, 0);
+    update();
+    TEST_CHECK(test_tracker.tracks[0].id == test_tracker.next_id - 1u);
+    TEST_CHECK(test_tracker.next_id > 1u);
+}
+
+/*******************************************************************************
+ * Function Name: test_write
+ *******************************************************************************
+ * Summary:
+ *   The report holds the confirmed tracks little endian, negative Doppler
+ *   bins in two's complement, and no more than the given number.
+ ******************************************************************************/
+static void test_write(void)
+{
+    uint8_t data[RADAR_TRACKS_SIZE(RADAR_TRACK_MAX_TRACKS)];
+
+    start();
+    for (uint32_t frame = 0; frame < 20u; ++frame)
+    {
+        detect(12.0, -3);
+        detect(30.0, 7);
+        update();
+    }
+    detect(50.0, 0);
+    update();
+
+    TEST_CHECK(radar_track_write(data, &test_tracker, RADAR_TRACK_MAX_TRACKS, 6, 5) == RADAR_TRACKS_SIZE(2));
+    TEST_CHECK((data[0] == 2) && (data[1] == 0) && (data[2] == 6) && (data[3] == 5));
+
+    /* 12 range bins and -3 Doppler bins in 0.01 bins, one miss */
+    TEST_CHECK((data[4] == 0) && (data[5] == 0));
+    TEST_CHECK((data[6] == (1200 & 0xFF)) && (data[7] == (1200 >> 8)));
+    TEST_CHECK((data[8] == (uint8_t)(-300 & 0xFF)) && (data[9] == (uint8_t)((-300 >> 8) & 0xFF)));
+    TEST_CHECK((data[10] > 0) && (data[11] == 1));
+    TEST_CHECK((data[12] == 1) && (data[13] == 0));
+
+    TEST_CHECK(radar_track_write(data, &test_tracker, 1, 6, 5) == RADAR_TRACKS_SIZE(1));
+    TEST_CHECK((data[0] == 1) && (data[1] == 0));
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_config_is_valid);
+    TEST_RUN(test_confirm);
+    TEST_RUN(test_constant_speed);
+    TEST_RUN(test_coast);
+    TEST_RUN(test_crossing);
+    TEST_RUN(test_false_alarms);
+    TEST_RUN(test_capacity);
+    TEST_RUN(test_write);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,291 @@
+/*****************************************************************************
+ * File name: test_radar_vital.c
+ *
+ * Description: This file contains the host unit tests of the vital signs
+ * estimation against a reference signal: a chest motion with known breathing
+ * and heart rates simulated in the phase of a range bin.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "radar_test.h"
+#include "radar_vital.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_PI                 (3.14159265358979323846)
+
+#define TEST_SAMPLES            (64u)
+#define TEST_CHIRPS             (2u)
+#define TEST_ANTENNAS           (2u)
+
+/* Range bin of the person */
+#define TEST_RANGE_BIN          (6u)
+
+/* Wavelength at 60 GHz in millimeters, the phase of the range bin moves by
+ * 4 pi per wavelength of chest displacement */
+#define TEST_WAVELENGTH_MM      (5.0)
+
+/* Reference signal: breathing 15 per minute with 4 mm chest displacement,
+ * heart 72 per minute with 0.2 mm */
+#define TEST_BREATHING_HZ       (0.25)
+#define TEST_BREATHING_MM       (4.0)
+#define TEST_HEART_HZ           (1.2)
+#define TEST_HEART_MM           (0.2)
+
+/* Largest error of a rate, 0.1 per minute */
+#define TEST_BREATHING_TOLERANCE    (5)
+#define TEST_HEART_TOLERANCE        (15)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static uint16_t test_frame[TEST_SAMPLES * TEST_CHIRPS * TEST_ANTENNAS];
+static radar_vital_t test_vital;
+static uint32_t test_random = 1;
+
+static const radar_geometry_t test_geometry = {
+    .samples_per_chirp = TEST_SAMPLES,
+    .chirps_per_frame = TEST_CHIRPS,
+    .rx_antennas = TEST_ANTENNAS
+};
+
+/*******************************************************************************
+ * Function Name: next_random
+ *******************************************************************************
+ * Summary:
+ *   Linear congruential generator, the tests see the same noise every run.
+ *
+ * Parameters:
+ *   range : number of values
+ *
+ * Return:
+ *   value from 0 to range - 1
+ ******************************************************************************/
+static uint32_t next_random(uint32_t range)
+{
+    test_random = (test_random * 1103515245u) + 12345u;
+    return (test_random >> 16) % range;
+}
+
+/*******************************************************************************
+ * Function Name: fill_frame
+ *******************************************************************************
+ * Summary:
+ *   Writes the frame at a time of the reference signal: the beat signal of
+ *   the person on antenna 1 with the phase of the chest displacement, an
+ *   unrelated target on antenna 2, and noise of a few ADC counts.
+ *
+ * Parameters:
+ *   time     : time of the frame in seconds
+ *   heart_mm : chest displacement of the heart beat
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void fill_frame(double time, double heart_mm)
+{
+    const double displacement = (TEST_BREATHING_MM * sin(2.0 * TEST_PI * TEST_BREATHING_HZ * time)) +
+                                (heart_mm * sin(2.0 * TEST_PI * TEST_HEART_HZ * time));
+    const double phase = (4.0 * TEST_PI * displacement) / TEST_WAVELENGTH_MM;
+    uint16_t *sample = test_frame;
+
+    for (uint32_t chirp = 0; chirp < TEST_CHIRPS; ++chirp)
+    {
+        for (uint32_t s = 0; s < TEST_SAMPLES; ++s)
+        {
+            const double beat = (2.0 * TEST_PI * TEST_RANGE_BIN * s) / TEST_SAMPLES;
+
+            *sample++ = (uint16_t)lround(2048.0 + (400.0 * cos(beat + phase)) + (double)next_random(9) - 4.0);
+            *sample++ = (uint16_t)lround(2048.0 + (400.0 * cos((3.0 * beat) + (7.0 * time))));
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: run_reference
+ *******************************************************************************
+ * Summary:
+ *   Feeds the reference signal for a number of seconds and keeps the last
+ *   result.
+ *
+ * Parameters:
+ *   frame_rate : frames per second
+ *   seconds    : duration
+ *   heart_mm   : chest displacement of the heart beat
+ *   result     : last result
+ *
+ * Return:
+ *   number of results
+ ******************************************************************************/
+static uint32_t run_reference(float frame_rate, uint32_t seconds, double heart_mm, radar_vital_result_t *result)
+{
+    const uint32_t num_frames = (uint32_t)lroundf(frame_rate * (float)seconds);
+    uint32_t num_results = 0;
+
+    test_random = 1;
+    radar_vital_init(&test_vital, frame_rate);
+
+    for (uint32_t frame = 0; frame < num_frames; ++frame)
+    {
+        fill_frame(frame / (double)frame_rate, heart_mm);
+        if (radar_vital_process(&test_vital, TEST_RANGE_BIN, &test_geometry, test_frame, result))
+        {
+            num_results++;
+
+            /* Nothing is estimated before the window is full */
+            if (frame < (uint32_t)(frame_rate * (float)(RADAR_VITAL_WINDOW_S - 1u)))
+            {
+                TEST_CHECK((result->breathing_rate == 0) && (result->heart_rate == 0));
+            }
+        }
+    }
+
+    return num_results;
+}
+
+/*******************************************************************************
+ * Function Name: test_reference
+ *******************************************************************************
+ * Summary:
+ *   Breathing and heart rate of the reference signal are found at 20 frames
+ *   per second, one result per second.
+ ******************************************************************************/
+static void test_reference(void)
+{
+    radar_vital_result_t result;
+
+    TEST_CHECK(run_reference(20.0f, 30, TEST_HEART_MM, &result) == 30);
+    TEST_CHECK(result.range_bin == TEST_RANGE_BIN);
+    TEST_CHECK_NEAR(result.breathing_rate, TEST_BREATHING_HZ * 600.0, TEST_BREATHING_TOLERANCE);
+    TEST_CHECK_NEAR(result.heart_rate, TEST_HEART_HZ * 600.0, TEST_HEART_TOLERANCE);
+    TEST_CHECK(result.breathing_quality > (4u << 8));
+    TEST_CHECK(result.heart_quality > (2u << 8));
+}
+
+/*******************************************************************************
+ * Function Name: test_averaged
+ *******************************************************************************
+ * Summary:
+ *   At 100 frames per second five frames are averaged into one sample, the
+ *   rates and the report interval stay the same.
+ ******************************************************************************/
+static void test_averaged(void)
+{
+    radar_vital_result_t result;
+
+    TEST_CHECK(run_reference(100.0f, 25, TEST_HEART_MM, &result) == 25);
+    TEST_CHECK(test_vital.frames_per_sample == 5);
+    TEST_CHECK_NEAR(result.breathing_rate, TEST_BREATHING_HZ * 600.0, TEST_BREATHING_TOLERANCE);
+    TEST_CHECK_NEAR(result.heart_rate, TEST_HEART_HZ * 600.0, TEST_HEART_TOLERANCE);
+}
+
+/*******************************************************************************
+ * Function Name: test_no_heart
+ *******************************************************************************
+ * Summary:
+ *   Without a heart beat only residues of the breathing are left in the
+ *   heart band: its quality drops well below the one of the reference.
+ ******************************************************************************/
+static void test_no_heart(void)
+{
+    radar_vital_result_t reference;
+    radar_vital_result_t result;
+
+    (void)run_reference(20.0f, 30, TEST_HEART_MM, &reference);
+    (void)run_reference(20.0f, 30, 0.0, &result);
+    TEST_CHECK_NEAR(result.breathing_rate, TEST_BREATHING_HZ * 600.0, TEST_BREATHING_TOLERANCE);
+    TEST_CHECK(result.heart_quality < (reference.heart_quality / 3u));
+}
+
+/*******************************************************************************
+ * Function Name: test_reset
+ *******************************************************************************
+ * Summary:
+ *   A reset empties the window: the next results carry no rates.
+ ******************************************************************************/
+static void test_reset(void)
+{
+    radar_vital_result_t result;
+    bool reported = false;
+
+    (void)run_reference(20.0f, 25, TEST_HEART_MM, &result);
+    TEST_CHECK(result.breathing_rate != 0);
+
+    radar_vital_reset(&test_vital);
+    for (uint32_t frame = 0; frame < 40u; ++frame)
+    {
+        fill_frame(frame / 20.0, TEST_HEART_MM);
+        if (radar_vital_process(&test_vital, TEST_RANGE_BIN, &test_geometry, test_frame, &result))
+        {
+            reported = true;
+            TEST_CHECK((result.breathing_rate == 0) && (result.heart_rate == 0));
+        }
+    }
+    TEST_CHECK(reported);
+}
+
+/*******************************************************************************
+ * Function Name: test_write_result
+ *******************************************************************************
+ * Summary:
+ *   The result is encoded little endian.
+ ******************************************************************************/
+static void test_write_result(void)
+{
+    const radar_vital_result_t result = {
+        .range_bin = 6,
+        .breathing_rate = 150,
+        .heart_rate = 0x02D0,
+        .breathing_quality = 0x1234,
+        .heart_quality = 0xABCD
+    };
+    const uint8_t expected[RADAR_VITAL_RESULT_SIZE] = { 6, 0, 150, 0, 0xD0, 0x02, 0x34, 0x12, 0xCD, 0xAB };
+    uint8_t data[RADAR_VITAL_RESULT_SIZE];
+
+    TEST_CHECK(radar_vital_write_result(data, &result) == sizeof(data));
+    TEST_CHECK(memcmp(data, expected, sizeof(data)) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_reference);
+    TEST_RUN(test_averaged);
+    TEST_RUN(test_no_heart);
+    TEST_RUN(test_reset);
+    TEST_RUN(test_write_result);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
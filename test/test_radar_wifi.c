@@ -0,0 +1,583 @@
+/*****************************************************************************
+ * File name: test_radar_wifi.c
+ *
+ * Description: This file contains the host unit tests of the Wi-Fi outage
+ * handling: a stand-in connection manager takes the link down and assigns new
+ * addresses, the frames are kept with the oldest dropped beyond the backlog,
+ * drained in order at the backlog rate, the sockets are bound again with
+ * retries and the joins back off.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2022 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <stdio.h>
+#include <string.h>
+
+/* Header file for local module */
+#include "cy_wcm.h"
+#include "radar_frame.h"
+#include "radar_test.h"
+#include "radar_wifi.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_MAX_DATAGRAM       (64u)
+
+/* Addresses the stand-in AP assigns */
+#define TEST_ADDRESS            (0x0A01A8C0u)
+#define TEST_NEW_ADDRESS        (0x0B01A8C0u)
+
+/* Live frame period in milliseconds, 50 frames per second */
+#define TEST_FRAME_MS           (20u)
+
+/* Waits of the joins, as in wifi_config.h */
+#define TEST_JOIN_MIN_MS        (1000u)
+#define TEST_JOIN_MAX_MS        (30000u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+RADAR_TEST_MAIN;
+
+static uint8_t test_memory[RADAR_WIFI_MEMORY_SIZE(TEST_MAX_DATAGRAM)];
+static radar_wifi_t test_wifi;
+
+/* Stand-in connection manager: link state seen by the event callback, the
+ * AP association, the address of the kit and the joins that fail */
+static bool test_connected;
+static bool test_address_changed;
+static uint8_t test_associated;
+static uint32_t test_address;
+static uint32_t test_join_failures;
+static uint32_t test_joins;
+
+/* Socket rebinds that fail before one succeeds */
+static uint32_t test_rebind_failures;
+static uint32_t test_rebinds;
+static uint32_t test_bound_address;
+
+/* Client side of the drain */
+static uint32_t test_next_frame;
+static uint32_t test_received;
+static bool test_in_order;
+
+/*******************************************************************************
+ * Function Name: cy_wcm_connect_ap
+ *******************************************************************************
+ * Summary:
+ *   Stand-in join of the AP, fails test_join_failures times first.
+ *
+ * Parameters:
+ *   connect_params : AP credentials (unused)
+ *   ip_addr        : output, the address of the kit
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS once the join succeeds
+ ******************************************************************************/
+cy_rslt_t cy_wcm_connect_ap(cy_wcm_connect_params_t *connect_params, cy_wcm_ip_address_t *ip_addr)
+{
+    (void)connect_params;
+
+    test_joins++;
+    if (test_join_failures != 0)
+    {
+        test_join_failures--;
+        return 1u;
+    }
+
+    test_associated = 1;
+    ip_addr->version = CY_WCM_IP_VER_V4;
+    ip_addr->ip.v4 = test_address;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_wcm_is_connected_to_ap
+ *******************************************************************************
+ * Summary:
+ *   Stand-in association state.
+ *
+ * Return:
+ *   1 if the kit is associated with the AP
+ ******************************************************************************/
+uint8_t cy_wcm_is_connected_to_ap(void)
+{
+    return test_associated;
+}
+
+/*******************************************************************************
+ * Function Name: cy_wcm_get_ip_addr
+ *******************************************************************************
+ * Summary:
+ *   Stand-in address of the kit.
+ *
+ * Parameters:
+ *   interface_type : interface (unused)
+ *   ip_addr        : output, the address
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS
+ ******************************************************************************/
+cy_rslt_t cy_wcm_get_ip_addr(cy_wcm_interface_t interface_type, cy_wcm_ip_address_t *ip_addr)
+{
+    (void)interface_type;
+
+    ip_addr->version = CY_WCM_IP_VER_V4;
+    ip_addr->ip.v4 = test_address;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: rebind
+ *******************************************************************************
+ * Summary:
+ *   Stand-in socket rebind, fails test_rebind_failures times first.
+ *
+ * Parameters:
+ *   address : new address of the kit
+ *
+ * Return:
+ *   true if the sockets are bound
+ ******************************************************************************/
+static bool rebind(uint32_t address)
+{
+    test_rebinds++;
+    if (test_rebind_failures != 0)
+    {
+        test_rebind_failures--;
+        return false;
+    }
+
+    test_bound_address = address;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: start
+ *******************************************************************************
+ * Summary:
+ *   Starts with the link up, an empty backlog and nothing received.
+ *
+ * Parameters:
+ *   rate : drain rate in datagrams per second
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void start(uint16_t rate)
+{
+    radar_wifi_init(&test_wifi, test_memory, TEST_MAX_DATAGRAM, TEST_ADDRESS, rebind);
+    test_wifi.rate = rate;
+    test_connected = true;
+    test_address_changed = false;
+    test_associated = 1;
+    test_address = TEST_ADDRESS;
+    test_join_failures = 0;
+    test_joins = 0;
+    test_rebind_failures = 0;
+    test_rebinds = 0;
+    test_bound_address = TEST_ADDRESS;
+    test_next_frame = 0;
+    test_received = 0;
+    test_in_order = true;
+}
+
+/*******************************************************************************
+ * Function Name: inject
+ *******************************************************************************
+ * Summary:
+ *   Delivers a connection manager event the way the event callback of the
+ *   UDP server does, and updates the link state right after.
+ *
+ * Parameters:
+ *   event  : connection manager event
+ *   now_ms : time in milliseconds
+ *
+ * Return:
+ *   wait returned by the update
+ ******************************************************************************/
+static uint32_t inject(cy_wcm_event_t event, uint32_t now_ms)
+{
+    uint32_t wait_ms;
+
+    radar_wifi_event(event, &test_connected, &test_address_changed);
+    test_associated = test_connected ? 1u : 0u;
+    wait_ms = radar_wifi_update(&test_wifi, test_connected, test_address_changed, now_ms);
+    test_address_changed = false;
+
+    return wait_ms;
+}
+
+/*******************************************************************************
+ * Function Name: keep_frame
+ *******************************************************************************
+ * Summary:
+ *   Keeps the datagram of a frame number in the backlog.
+ *
+ * Parameters:
+ *   frame : frame number
+ *
+ * Return:
+ *   true if the datagram is kept
+ ******************************************************************************/
+static bool keep_frame(uint32_t frame)
+{
+    uint8_t data[TEST_MAX_DATAGRAM];
+
+    memset(data, (int)frame, sizeof(data));
+    data[RADAR_FRAME_HDR_CMD] = RADAR_DATA_COMMAND;
+    radar_frame_put_u32(&data[RADAR_FRAME_HDR_FRAME_NUM], frame);
+
+    return radar_wifi_keep(&test_wifi, data, RADAR_FRAME_HEADER_SIZE + (frame % 8u));
+}
+
+/*******************************************************************************
+ * Function Name: drain
+ *******************************************************************************
+ * Summary:
+ *   Sends the kept frames that are due and takes them on the client side,
+ *   they have to arrive in frame order.
+ *
+ * Parameters:
+ *   now_ms : time in milliseconds
+ *
+ * Return:
+ *   number of frames sent
+ ******************************************************************************/
+static uint32_t drain(uint32_t now_ms)
+{
+    const uint8_t *datagram;
+    uint32_t length;
+    uint32_t sent = 0;
+
+    while (radar_wifi_drain_wait(&test_wifi, now_ms) == 0)
+    {
+        length = radar_wifi_drain_next(&test_wifi, &datagram);
+        if (length == 0)
+        {
+            break;
+        }
+
+        const uint32_t frame = radar_frame_get_u32(&datagram[RADAR_FRAME_HDR_FRAME_NUM]);
+
+        test_in_order = test_in_order && (frame >= test_next_frame) &&
+                        (length == (RADAR_FRAME_HEADER_SIZE + (frame % 8u)));
+        test_next_frame = frame + 1u;
+        test_received++;
+        sent++;
+    }
+
+    return sent;
+}
+
+/*******************************************************************************
+ * Function Name: test_events
+ *******************************************************************************
+ * Summary:
+ *   Connection manager events take the link down and up and report a new
+ *   address, other events change nothing.
+ ******************************************************************************/
+static void test_events(void)
+{
+    bool connected = true;
+    bool address_changed = false;
+
+    radar_wifi_event(CY_WCM_EVENT_DISCONNECTED, &connected, &address_changed);
+    TEST_CHECK(!connected && !address_changed);
+    radar_wifi_event(CY_WCM_EVENT_CONNECTING, &connected, &address_changed);
+    TEST_CHECK(!connected && !address_changed);
+    radar_wifi_event(CY_WCM_EVENT_RECONNECTED, &connected, &address_changed);
+    TEST_CHECK(connected && !address_changed);
+    radar_wifi_event(CY_WCM_EVENT_INITIATED_RETRY, &connected, &address_changed);
+    TEST_CHECK(!connected);
+    radar_wifi_event(CY_WCM_EVENT_IP_CHANGED, &connected, &address_changed);
+    TEST_CHECK(connected && address_changed);
+
+    TEST_CHECK(!radar_wifi_rate_is_valid(0));
+    TEST_CHECK(radar_wifi_rate_is_valid(RADAR_WIFI_MAX_RATE));
+    TEST_CHECK(!radar_wifi_rate_is_valid(RADAR_WIFI_MAX_RATE + 1u));
+}
+
+/*******************************************************************************
+ * Function Name: test_keep_oldest_drop
+ *******************************************************************************
+ * Summary:
+ *   A lost link keeps the newest RADAR_WIFI_BACKLOG_DEPTH frames, nothing is
+ *   drained while it is down, and once it is back the kept frames go out in
+ *   order before the link is up again.
+ ******************************************************************************/
+static void test_keep_oldest_drop(void)
+{
+    const uint32_t frames = RADAR_WIFI_BACKLOG_DEPTH + 36u;
+    uint32_t now_ms = 0;
+
+    start(RADAR_WIFI_MAX_RATE);
+    TEST_CHECK(inject(CY_WCM_EVENT_DISCONNECTED, now_ms) == RADAR_WIFI_IDLE);
+    TEST_CHECK(test_wifi.state == RADAR_WIFI_DOWN);
+    TEST_CHECK(test_wifi.disconnects == 1u);
+
+    for (uint32_t frame = 0; frame < frames; ++frame)
+    {
+        TEST_CHECK(keep_frame(frame));
+        now_ms += TEST_FRAME_MS;
+        TEST_CHECK(drain(now_ms) == 0);
+    }
+    TEST_CHECK(test_wifi.kept == frames);
+    TEST_CHECK(test_wifi.dropped == (frames - RADAR_WIFI_BACKLOG_DEPTH));
+    TEST_CHECK(test_wifi.backlog.num_requested == RADAR_WIFI_BACKLOG_DEPTH);
+
+    (void)inject(CY_WCM_EVENT_RECONNECTED, now_ms);
+    TEST_CHECK(test_wifi.state == RADAR_WIFI_DRAINING);
+    TEST_CHECK(test_rebinds == 0);
+
+    test_next_frame = frames - RADAR_WIFI_BACKLOG_DEPTH;
+    for (uint32_t ms = 0; (ms < 1000u) && (test_wifi.state != RADAR_WIFI_UP); ++ms)
+    {
+        (void)drain(now_ms);
+        (void)radar_wifi_update(&test_wifi, test_connected, false, now_ms);
+        now_ms++;
+    }
+    TEST_CHECK(test_wifi.state == RADAR_WIFI_UP);
+    TEST_CHECK(test_received == RADAR_WIFI_BACKLOG_DEPTH);
+    TEST_CHECK(test_next_frame == frames);
+    TEST_CHECK(test_in_order);
+    TEST_CHECK(test_wifi.dropped == (frames - RADAR_WIFI_BACKLOG_DEPTH));
+}
+
+/*******************************************************************************
+ * Function Name: test_drain_rate
+ *******************************************************************************
+ * Summary:
+ *   The backlog drains at the backlog rate while live frames keep being kept
+ *   behind it, and the link is up again once it is empty, with every frame
+ *   received once and in order.
+ ******************************************************************************/
+static void test_drain_rate(void)
+{
+    const uint16_t rate = 200u;
+    const uint32_t kept = 48u;
+    uint32_t now_ms = 0;
+    uint32_t frame = 0;
+    uint32_t sent_early = 0;
+    uint32_t drain_ms = 0;
+
+    start(rate);
+    (void)inject(CY_WCM_EVENT_DISCONNECTED, now_ms);
+    while (frame < kept)
+    {
+        TEST_CHECK(keep_frame(frame++));
+        now_ms += TEST_FRAME_MS;
+    }
+
+    (void)inject(CY_WCM_EVENT_CONNECTED, now_ms);
+    TEST_CHECK(test_wifi.state == RADAR_WIFI_DRAINING);
+    while ((test_wifi.state != RADAR_WIFI_UP) && (drain_ms < 10000u))
+    {
+        if ((drain_ms % TEST_FRAME_MS) == 0)
+        {
+            TEST_CHECK(keep_frame(frame++));
+        }
+
+        const uint32_t sent = drain(now_ms);
+
+        if (drain_ms < 250u)
+        {
+            sent_early += sent;
+        }
+        (void)radar_wifi_update(&test_wifi, test_connected, false, now_ms);
+        now_ms++;
+        drain_ms++;
+    }
+
+    /* The drain goes at the rate, the live frames included */
+    TEST_CHECK_NEAR(sent_early, (rate * 250u) / 1000u, 2);
+
+    /* 48 frames at 200/s with 50/s joining: about 48 / 150 s */
+    TEST_CHECK(test_wifi.state == RADAR_WIFI_UP);
+    TEST_CHECK_NEAR(drain_ms, (kept * 1000u) / (rate - (1000u / TEST_FRAME_MS)), 20);
+    TEST_CHECK(test_received == frame);
+    TEST_CHECK(test_in_order);
+    TEST_CHECK(test_wifi.dropped == 0);
+}
+
+/*******************************************************************************
+ * Function Name: test_slow_drain
+ *******************************************************************************
+ * Summary:
+ *   A drain rate below the frame rate never empties the backlog: after a
+ *   progress check the rest of the backlog is dropped and the link is up
+ *   again instead of lagging behind for good.
+ ******************************************************************************/
+static void test_slow_drain(void)
+{
+    const uint16_t rate = 25u;
+    uint32_t now_ms = 0;
+    uint32_t frame = 0;
+    uint32_t drain_ms = 0;
+    uint32_t wait_ms;
+
+    start(rate);
+    (void)inject(CY_WCM_EVENT_DISCONNECTED, now_ms);
+    while (frame < 10u)
+    {
+        TEST_CHECK(keep_frame(frame++));
+        now_ms += TEST_FRAME_MS;
+    }
+
+    wait_ms = inject(CY_WCM_EVENT_CONNECTED, now_ms);
+    TEST_CHECK(test_wifi.state == RADAR_WIFI_DRAINING);
+    TEST_CHECK(wait_ms == ((RADAR_WIFI_BACKLOG_DEPTH * 1000u) / rate));
+
+    while ((test_wifi.state != RADAR_WIFI_UP) && (drain_ms < 20000u))
+    {
+        if ((drain_ms % TEST_FRAME_MS) == 0)
+        {
+            TEST_CHECK(keep_frame(frame++));
+        }
+        (void)drain(now_ms);
+        (void)radar_wifi_update(&test_wifi, test_connected, false, now_ms);
+        now_ms++;
+        drain_ms++;
+    }
+
+    TEST_CHECK(test_wifi.state == RADAR_WIFI_UP);
+    TEST_CHECK(drain_ms <= (((RADAR_WIFI_BACKLOG_DEPTH * 1000u) / rate) + 1u));
+    TEST_CHECK(test_wifi.backlog.num_requested == 0);
+    TEST_CHECK((test_received + test_wifi.dropped) == frame);
+    TEST_CHECK(test_in_order);
+}
+
+/*******************************************************************************
+ * Function Name: test_rebind
+ *******************************************************************************
+ * Summary:
+ *   A new address keeps the frames until the sockets are bound to it. A
+ *   failed rebind is tried again after RADAR_WIFI_REBIND_RETRY_MS, and the
+ *   frames kept meanwhile are drained after it.
+ ******************************************************************************/
+static void test_rebind(void)
+{
+    uint32_t now_ms = 1000u;
+    uint32_t wait_ms;
+
+    /* New address while the link is up */
+    start(RADAR_WIFI_MAX_RATE);
+    test_address = TEST_NEW_ADDRESS;
+    test_rebind_failures = 2;
+    wait_ms = inject(CY_WCM_EVENT_IP_CHANGED, now_ms);
+    TEST_CHECK(test_wifi.state == RADAR_WIFI_DOWN);
+    TEST_CHECK(test_rebinds == 1u);
+    TEST_CHECK(wait_ms == RADAR_WIFI_REBIND_RETRY_MS);
+    TEST_CHECK(keep_frame(0));
+
+    wait_ms = radar_wifi_update(&test_wifi, true, false, now_ms + RADAR_WIFI_REBIND_RETRY_MS - 1u);
+    TEST_CHECK((test_rebinds == 1u) && (wait_ms == 1u));
+    now_ms += RADAR_WIFI_REBIND_RETRY_MS;
+    (void)radar_wifi_update(&test_wifi, true, false, now_ms);
+    TEST_CHECK((test_rebinds == 2u) && (test_wifi.state == RADAR_WIFI_DOWN));
+    TEST_CHECK(keep_frame(1));
+    now_ms += RADAR_WIFI_REBIND_RETRY_MS;
+    (void)radar_wifi_update(&test_wifi, true, false, now_ms);
+    TEST_CHECK(test_rebinds == 3u);
+    TEST_CHECK((test_bound_address == TEST_NEW_ADDRESS) && (test_wifi.address == TEST_NEW_ADDRESS));
+    TEST_CHECK(test_wifi.state == RADAR_WIFI_DRAINING);
+
+    for (uint32_t ms = 0; ms < 10u; ++ms)
+    {
+        (void)drain(now_ms);
+        (void)radar_wifi_update(&test_wifi, true, false, now_ms);
+        now_ms++;
+    }
+    TEST_CHECK(test_received == 2u);
+    TEST_CHECK(test_wifi.state == RADAR_WIFI_UP);
+    TEST_CHECK(test_in_order);
+    TEST_CHECK(test_wifi.disconnects == 1u);
+
+    /* Same address on the next event, nothing to bind */
+    (void)inject(CY_WCM_EVENT_IP_CHANGED, now_ms);
+    TEST_CHECK((test_rebinds == 3u) && (test_wifi.state == RADAR_WIFI_UP));
+
+    /* New address after an outage, bound before the backlog drains */
+    start(RADAR_WIFI_MAX_RATE);
+    (void)inject(CY_WCM_EVENT_DISCONNECTED, now_ms);
+    TEST_CHECK(keep_frame(0));
+    test_address = TEST_NEW_ADDRESS;
+    (void)inject(CY_WCM_EVENT_CONNECTED, now_ms);
+    TEST_CHECK((test_rebinds == 1u) && (test_bound_address == TEST_NEW_ADDRESS));
+    TEST_CHECK(test_wifi.state == RADAR_WIFI_DRAINING);
+    TEST_CHECK(test_wifi.disconnects == 1u);
+}
+
+/*******************************************************************************
+ * Function Name: test_join_backoff
+ *******************************************************************************
+ * Summary:
+ *   The wait between the joins doubles up to the longest wait, a join
+ *   succeeds once the AP takes the kit, and no join is made while the
+ *   connection manager rejoined the AP by itself.
+ ******************************************************************************/
+static void test_join_backoff(void)
+{
+    const uint32_t expected[] = { 2000u, 4000u, 8000u, 16000u, 30000u, 30000u };
+    cy_wcm_connect_params_t params;
+    radar_wifi_join_t join;
+
+    memset(&params, 0, sizeof(params));
+    start(RADAR_WIFI_MAX_RATE);
+    (void)inject(CY_WCM_EVENT_DISCONNECTED, 0);
+    test_join_failures = sizeof(expected) / sizeof(expected[0]);
+
+    radar_wifi_join_start(&join, TEST_JOIN_MIN_MS, TEST_JOIN_MAX_MS);
+    TEST_CHECK(join.wait_ms == TEST_JOIN_MIN_MS);
+    for (uint32_t i = 0; i < (sizeof(expected) / sizeof(expected[0])); ++i)
+    {
+        TEST_CHECK(!radar_wifi_join_attempt(&join, &params));
+        TEST_CHECK(join.wait_ms == expected[i]);
+    }
+
+    TEST_CHECK(radar_wifi_join_attempt(&join, &params));
+    TEST_CHECK(join.attempts == ((sizeof(expected) / sizeof(expected[0])) + 1u));
+    TEST_CHECK(test_joins == join.attempts);
+
+    /* Rejoined by the connection manager: no join of its own */
+    radar_wifi_join_start(&join, TEST_JOIN_MIN_MS, TEST_JOIN_MAX_MS);
+    TEST_CHECK(radar_wifi_join_attempt(&join, &params));
+    TEST_CHECK((join.attempts == 0) && (join.wait_ms == TEST_JOIN_MIN_MS));
+}
+
+/*******************************************************************************
+ * Function Name: main
+ ******************************************************************************/
+int main(void)
+{
+    TEST_RUN(test_events);
+    TEST_RUN(test_keep_oldest_drop);
+    TEST_RUN(test_drain_rate);
+    TEST_RUN(test_slow_drain);
+    TEST_RUN(test_rebind);
+    TEST_RUN(test_join_backoff);
+
+    return radar_test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,798 @@
+#******************************************************************************
+# File Name:   udp_aggregator_radar.py
+#
+# Description: Receives and time-aligns the radar data of many UDP servers.
+# 
+#********************************************************************************
+# Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#********************************************************************************
+
+#!/usr/bin/env python
+import socket
+import select
+import json
+import optparse
+import time
+import sys
+import os
+import math
+import cmath
+import threading
+import queue
+import multiprocessing
+from array import array
+from collections import deque
+from functools import partial
+
+from udp_client_radar import (BUFFER_SIZE, DEFAULT_PORT, FRAME_HEADER_SIZE, FRAME_COMMANDS,
+                              RADAR_DATA_COMMAND, RADAR_STATS_COMMAND, RADAR_TARGETS_COMMAND, RADAR_VITAL_COMMAND,
+                              RADAR_SPECTRO_COMMAND, RADAR_TRACKS_COMMAND, RADAR_SYNC_COMMAND, RADAR_FEC_COMMAND,
+                              SYNC_REQUEST_SIZE, DEFAULT_LEASE_MS, KEEPALIVES_PER_LEASE, KEEPALIVE, FecDecoder,
+                              parse_frame_header, parse_targets, parse_tracks, parse_vital, parse_spectro,
+                              sync_response, host_time_us)
+
+try:
+        import numpy
+except ImportError:
+        numpy = None
+
+
+DEFAULT_SOCKETS = 1
+DEFAULT_WORKERS = os.cpu_count() or 1
+
+# Frames of different boards taken less than this after the first frame of a merged
+# frame are merged, one frame period of the boards: their frames are not taken in
+# phase, so the frame of every board nearest in time can be up to a period apart
+DEFAULT_ALIGN_WINDOW_MS = 5.0
+
+# A merged frame is returned once every active board contributed or it is this old
+DEFAULT_ALIGN_LATENCY_MS = 50.0
+
+# A board is active while its last frame is younger than this
+ACTIVE_TIMEOUT_US = 1000000
+
+# Datagrams of one board waiting for a worker, older ones are dropped beyond it
+STREAM_BACKLOG = 256
+
+# Datagrams processed per worker task, then the stream goes to the back of the queue
+DRAIN_BATCH = 16
+
+# Merged frames waiting for the consumer, older ones are dropped beyond it
+MERGED_BACKLOG = 1024
+
+# Receive timeout, bounds the time a merged frame waits beyond its latency
+RECEIVE_TIMEOUT_S = 0.02
+
+# Simulated boards of the scaling benchmark
+DEFAULT_BENCH_STREAMS = "1,2,4,8,16,32,64"
+DEFAULT_BENCH_RATE = 100.0
+DEFAULT_BENCH_SECONDS = 5.0
+BENCH_SAMPLES = 128
+
+
+def fft(values):
+        """
+         values: complex samples, the length is a power of two
+
+        Returns the discrete Fourier transform of the samples, an iterative radix-2 FFT
+        used when numpy is not installed.
+        """
+        n = len(values)
+        result = list(values)
+        j = 0
+        for i in range(1, n):
+                bit = n >> 1
+                while j & bit:
+                        j ^= bit
+                        bit >>= 1
+                j |= bit
+                if i < j:
+                        result[i], result[j] = result[j], result[i]
+        size = 2
+        while size <= n:
+                step = cmath.exp(-2j * cmath.pi / size)
+                half = size // 2
+                for start in range(0, n, size):
+                        w = 1.0
+                        for k in range(start, start + half):
+                                t = w * result[k + half]
+                                result[k + half] = result[k] - t
+                                result[k] += t
+                                w *= step
+                size *= 2
+        return result
+
+def range_profile(samples, samples_per_chirp, antennas):
+        """
+         samples: frame samples, chirp by chirp with the antennas interleaved
+         samples_per_chirp: samples of every chirp and antenna
+         antennas: interleaved antennas
+
+        Returns the magnitude of the range FFT of the first antenna averaged over the
+        chirps of the frame, one value per range bin.
+        """
+        chirp_length = samples_per_chirp * antennas
+        chirps = len(samples) // chirp_length if chirp_length else 0
+        if chirps == 0:
+                return []
+        size = 1 << (samples_per_chirp - 1).bit_length()
+        if numpy is not None:
+                frame = numpy.asarray(samples[:chirps * chirp_length], dtype=numpy.float32)
+                frame = frame.reshape(chirps, samples_per_chirp, antennas)[:, :, 0]
+                frame = frame - frame.mean(axis=1, keepdims=True)
+                spectrum = numpy.abs(numpy.fft.rfft(frame, n=size, axis=1))[:, :size // 2]
+                return spectrum.mean(axis=0).tolist()
+        profile = [0.0] * (size // 2)
+        for chirp in range(chirps):
+                chirp_samples = samples[chirp * chirp_length:(chirp + 1) * chirp_length:antennas]
+                mean = sum(chirp_samples) / samples_per_chirp
+                spectrum = fft([value - mean for value in chirp_samples] + [0.0] * (size - samples_per_chirp))
+                for k in range(size // 2):
+                        profile[k] += abs(spectrum[k]) / chirps
+        return profile
+
+def process_frame(data, header):
+        """
+         data: frame datagram
+         header: its header, see parse_frame_header()
+
+        Default processing of the aggregator. Returns a dictionary with the range profile
+        and its peak range bin for radar data frames, and the parsed content of target,
+        track, vital signs and spectrogram frames.
+        """
+        command = data[0]
+        if command == RADAR_DATA_COMMAND:
+                samples = array('H', data[FRAME_HEADER_SIZE:len(data) - (len(data) - FRAME_HEADER_SIZE) % 2])
+                if sys.byteorder != 'little':
+                        samples.byteswap()
+                antennas = bin(header["roi_antennas"]).count("1")
+                profile = range_profile(samples, header["roi_sample_count"], antennas)
+                peak = max(range(1, len(profile)), key=profile.__getitem__) if len(profile) > 1 else 0
+                return {"range_profile": profile, "peak_bin": peak}
+        if command == RADAR_TARGETS_COMMAND:
+                return {"targets": parse_targets(data)[2]}
+        if command == RADAR_TRACKS_COMMAND:
+                return {"tracks": parse_tracks(data)[2]}
+        if command == RADAR_VITAL_COMMAND:
+                return {"vital": parse_vital(data)}
+        if command == RADAR_SPECTRO_COMMAND:
+                range_bin, hop, columns = parse_spectro(data)
+                return {"spectro_range_bin": range_bin, "spectro": columns}
+        return {}
+
+class WorkStealingPool:
+        """
+        Runs tasks on worker threads. Every worker takes tasks from the front of its own
+        queue and, once that is empty, steals from the back of the queues of the others,
+        so a worker with slow streams does not hold up the rest while others are idle.
+        Tasks can be submitted from any thread.
+        """
+        def __init__(self, workers):
+                """
+                 workers: number of worker threads
+                """
+                self.queues = [deque() for _ in range(workers)]
+                self.ready = threading.Condition()
+                self.pending = 0
+                self.running = True
+                self.executed = [0] * workers
+                self.stolen = [0] * workers
+                self.threads = [threading.Thread(target=self.run, args=(index,), daemon=True) for index in range(workers)]
+                for thread in self.threads:
+                        thread.start()
+
+        def submit(self, task, affinity):
+                """
+                 task: callable without arguments
+                 affinity: number selecting the worker whose queue the task is added to
+                """
+                self.queues[affinity % len(self.queues)].append(task)
+                with self.ready:
+                        self.pending += 1
+                        self.ready.notify()
+
+        def take(self, index):
+                """
+                 index: worker looking for a task
+
+                Returns the next task of the worker and whether it was stolen, or (None, False)
+                if all queues are empty.
+                """
+                try:
+                        return self.queues[index].popleft(), False
+                except IndexError:
+                        pass
+                count = len(self.queues)
+                for offset in range(1, count):
+                        try:
+                                return self.queues[(index + offset) % count].pop(), True
+                        except IndexError:
+                                continue
+                return None, False
+
+        def run(self, index):
+                """
+                 index: worker number
+
+                Worker thread. Every task counted in pending is in one of the queues, and a
+                worker only looks for one after claiming it, so the search always succeeds.
+                """
+                while True:
+                        with self.ready:
+                                while self.pending == 0 and self.running:
+                                        self.ready.wait()
+                                if self.pending == 0:
+                                        return
+                                self.pending -= 1
+                        task, stolen = self.take(index)
+                        while task is None:
+                                task, stolen = self.take(index)
+                        self.executed[index] += 1
+                        self.stolen[index] += stolen
+                        task()
+
+        def stop(self):
+                """
+                Finishes the queued tasks and stops the worker threads.
+                """
+                with self.ready:
+                        self.running = False
+                        self.ready.notify_all()
+                for thread in self.threads:
+                        thread.join()
+
+class Stream:
+        """
+        Frame stream of one board, identified by its source address: the datagrams waiting
+        for a worker, the parity decoder, the clock mapping and the counters. At most one
+        worker processes a stream at a time, so its frames are processed in order.
+        """
+        def __init__(self, index, address, sock):
+                """
+                 index: stream number, selects the preferred worker
+                 address: source address of the board
+                 sock: socket the board sends to
+                """
+                self.index = index
+                self.address = address
+                self.socket = sock
+                self.pending = deque()
+                self.lock = threading.Lock()
+                self.scheduled = False
+                self.decoder = FecDecoder()
+                self.last_frame_num = None
+                self.offset_us = None
+                self.counts = {"frames": 0, "lost": 0, "recovered": 0, "duplicates": 0, "overflows": 0, "resyncs": 0}
+
+        def push(self, data, received_us):
+                """
+                 data: datagram received from the board
+                 received_us: host time of the reception
+
+                Queues a datagram for processing. Returns True if the stream has to be
+                submitted to the pool, False if a worker already has it.
+                """
+                if len(self.pending) >= STREAM_BACKLOG:
+                        self.pending.popleft()
+                        self.counts["overflows"] += 1
+                self.pending.append((data, received_us))
+                with self.lock:
+                        if self.scheduled:
+                                return False
+                        self.scheduled = True
+                        return True
+
+        def release(self):
+                """
+                Returns True if datagrams arrived while the stream was processed and it has
+                to be submitted again, otherwise marks it as idle and returns False.
+                """
+                with self.lock:
+                        if self.pending:
+                                return True
+                        self.scheduled = False
+                        return False
+
+        def count(self, header, recovered):
+                """
+                 header: header of a processed frame
+                 recovered: the frame was rebuilt from parity
+
+                Counts the frames lost as gaps in the frame numbers.
+                """
+                frame_num = header["frame_num"]
+                self.counts["frames"] += 1
+                if header["resync"]:
+                        self.counts["resyncs"] += 1
+                if recovered:
+                        self.counts["recovered"] += 1
+                        self.counts["lost"] = max(self.counts["lost"] - 1, 0)
+                        return
+                if self.last_frame_num is not None:
+                        gap = (frame_num - self.last_frame_num) & 0xFFFFFFFF
+                        if 1 < gap < 0x80000000 and not header["resync"]:
+                                self.counts["lost"] += gap - 1
+                        elif gap >= 0x80000000:
+                                return
+                self.last_frame_num = frame_num
+
+        def frame_time(self, header, received_us):
+                """
+                 header: header of a frame
+                 received_us: host time of the reception
+
+                Returns the time of the frame on the host clock. Frames of a synchronized
+                board carry it. Otherwise the device time is shifted by the smallest offset
+                to the reception seen, the one with the least queueing delay, which creeps
+                up by 1 us per frame to follow a device clock running slower than the host.
+                """
+                if header["synced"]:
+                        return header["timestamp"]
+                offset = received_us - header["timestamp"]
+                if self.offset_us is None or offset < self.offset_us + 1:
+                        self.offset_us = offset
+                else:
+                        self.offset_us += 1
+                return header["timestamp"] + self.offset_us
+
+class MergedFrame:
+        """
+        Frames of different boards taken at the same time.
+        """
+        def __init__(self, time_us, received_us):
+                """
+                 time_us: host time of the first frame
+                 received_us: host time the first frame was received
+                """
+                self.time_us = time_us
+                self.received_us = received_us
+                self.frames = {}
+
+class FrameAligner:
+        """
+        Merges the processed frames of all boards by their time on the host clock. A merged
+        frame is returned once every active board contributed a frame or it waited for the
+        alignment latency; frames arriving after that are counted as late and dropped.
+        """
+        def __init__(self, window_us, latency_us, output):
+                """
+                 window_us: largest time difference to the first frame of a merged frame
+                 latency_us: longest time a merged frame waits for missing boards
+                 output: queue the merged frames are put in
+                """
+                self.window_us = window_us
+                self.latency_us = latency_us
+                self.output = output
+                self.lock = threading.Lock()
+                self.groups = []
+                self.last_seen = {}
+                self.emitted_until = None
+                self.counts = {"merged": 0, "complete": 0, "late": 0, "dropped": 0}
+
+        def add(self, address, header, result, time_us, received_us):
+                """
+                 address: board the frame comes from
+                 header: frame header
+                 result: processing result of the frame
+                 time_us: host time of the frame
+                 received_us: host time the frame was received
+                """
+                with self.lock:
+                        self.last_seen[address] = received_us
+                        if self.emitted_until is not None and time_us < self.emitted_until - self.window_us:
+                                self.counts["late"] += 1
+                                return
+                        for group in reversed(self.groups):
+                                if abs(group.time_us - time_us) < self.window_us and address not in group.frames:
+                                        break
+                        else:
+                                group = MergedFrame(time_us, received_us)
+                                position = len(self.groups)
+                                while position > 0 and self.groups[position - 1].time_us > time_us:
+                                        position -= 1
+                                self.groups.insert(position, group)
+                        group.frames[address] = (header, result)
+                        group.received_us = min(group.received_us, received_us)
+                        self.emit(received_us)
+
+        def expire(self):
+                """
+                Returns the merged frames that waited for the alignment latency.
+                """
+                with self.lock:
+                        self.emit(host_time_us())
+
+        def emit(self, now_us):
+                """
+                 now_us: host time
+
+                Moves the merged frames that are complete or waited long enough to the output,
+                oldest first. The caller holds the lock.
+                """
+                active = sum(1 for seen in self.last_seen.values() if now_us - seen < ACTIVE_TIMEOUT_US)
+                while self.groups:
+                        group = self.groups[0]
+                        complete = len(group.frames) >= active
+                        if not complete and now_us - group.received_us < self.latency_us:
+                                break
+                        self.groups.pop(0)
+                        self.emitted_until = group.time_us
+                        self.counts["merged"] += 1
+                        self.counts["complete"] += complete
+                        try:
+                                self.output.put_nowait(group)
+                        except queue.Full:
+                                self.counts["dropped"] += 1
+
+class RadarAggregator:
+        """
+        Receives the frame datagrams of many boards on a set of local UDP sockets, one
+        receive thread each. Datagrams are demultiplexed by source address into streams,
+        processed on a work-stealing pool of worker threads and merged across boards by
+        frame time. Merged frames are read with merged() or by iterating.
+
+        With the standard CPython interpreter, workers run in parallel only while the
+        processing releases the GIL, as numpy does for its array operations and FFTs; the
+        free-threaded interpreter runs all of it in parallel.
+        """
+        def __init__(self, sockets=DEFAULT_SOCKETS, port=0, workers=DEFAULT_WORKERS, processor=process_frame,
+                     window_ms=DEFAULT_ALIGN_WINDOW_MS, latency_ms=DEFAULT_ALIGN_LATENCY_MS, lease_ms=0):
+                """
+                 sockets: number of local UDP sockets
+                 port: port of the first socket, the others use the following ports; 0 picks
+                       free ports
+                 workers: number of worker threads
+                 processor: function(data, header) returning the result of a frame
+                 window_ms: largest time difference to the first frame of a merged frame
+                 latency_ms: longest time a merged frame waits for missing boards
+                 lease_ms: client lease of the boards renewed with keepalives, 0 sends none
+                """
+                self.sockets = []
+                for index in range(sockets):
+                        s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+                        s.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1 << 22)
+                        s.bind(("", port + index if port else 0))
+                        self.sockets.append(s)
+                self.processor = processor
+                self.keepalive_interval = lease_ms / 1000.0 / KEEPALIVES_PER_LEASE
+                self.output = queue.Queue(MERGED_BACKLOG)
+                self.aligner = FrameAligner(int(window_ms * 1000), int(latency_ms * 1000), self.output)
+                self.streams = {}
+                self.streams_lock = threading.Lock()
+                self.boards = []
+                self.running = True
+                self.pool = WorkStealingPool(max(workers, 1))
+                self.receivers = [threading.Thread(target=self.receive, args=(s,), daemon=True) for s in self.sockets]
+                for thread in self.receivers:
+                        thread.start()
+
+        def ports(self):
+                """
+                Returns the local ports the boards send to.
+                """
+                return [s.getsockname()[1] for s in self.sockets]
+
+        def add_board(self, server_ip, server_port=DEFAULT_PORT, config=None):
+                """
+                 server_ip: IP address of the udp server of the board
+                 server_port: port of the udp server
+                 config: optional dictionary of settings sent before the transmission is enabled
+
+                Starts the data transmission of a board. Boards are spread over the sockets,
+                and every board sends to the socket that enabled it.
+                """
+                s = self.sockets[len(self.boards) % len(self.sockets)]
+                if config:
+                        s.sendto(json.dumps(config).encode(), (server_ip, server_port))
+                s.sendto('{"radar_transmission":"enable"}'.encode(), (server_ip, server_port))
+                self.boards.append((server_ip, server_port, s))
+
+        def receive(self, s):
+                """
+                 s: socket
+
+                Receive thread of a socket. Answers clock synchronization requests at once and
+                queues frame and parity datagrams on the stream of their board. Renews the
+                client lease of the boards that send to the socket.
+                """
+                next_keepalive = time.perf_counter()
+                while self.running:
+                        if self.keepalive_interval and time.perf_counter() >= next_keepalive:
+                                for server_ip, server_port, board_socket in list(self.boards):
+                                        if board_socket is s:
+                                                s.sendto(KEEPALIVE, (server_ip, server_port))
+                                next_keepalive = time.perf_counter() + self.keepalive_interval
+                        readable, _, _ = select.select([s], [], [], RECEIVE_TIMEOUT_S)
+                        if not readable:
+                                self.aligner.expire()
+                                continue
+                        try:
+                                data, address = s.recvfrom(BUFFER_SIZE)
+                        except OSError:
+                                continue
+                        received_us = host_time_us()
+                        if len(data) < 2:
+                                continue
+                        if data[0] == RADAR_SYNC_COMMAND and len(data) == SYNC_REQUEST_SIZE:
+                                s.sendto(sync_response(data, received_us, host_time_us()), address)
+                                continue
+                        if data[0] == RADAR_STATS_COMMAND:
+                                print("Statistics of", address[0], ":", data[2:].decode())
+                                continue
+                        if data[0] != RADAR_FEC_COMMAND and (data[0] not in FRAME_COMMANDS or len(data) < FRAME_HEADER_SIZE):
+                                continue
+                        stream = self.streams.get(address)
+                        if stream is None:
+                                with self.streams_lock:
+                                        stream = self.streams.setdefault(address, Stream(len(self.streams), address, s))
+                        if stream.push(data, received_us):
+                                self.pool.submit(partial(self.drain, stream), stream.index)
+
+        def drain(self, stream):
+                """
+                 stream: stream of a board
+
+                Worker task: processes up to DRAIN_BATCH datagrams of a stream in order and
+                hands the results to the aligner, then submits the stream again if datagrams
+                are left.
+                """
+                for _ in range(DRAIN_BATCH):
+                        try:
+                                data, received_us = stream.pending.popleft()
+                        except IndexError:
+                                break
+                        recovered = data[0] == RADAR_FEC_COMMAND
+                        if recovered:
+                                data = stream.decoder.add_parity(data)
+                                if data is None:
+                                        continue
+                        else:
+                                frame_num = int.from_bytes(data[2:6], 'little')
+                                if frame_num in stream.decoder.received:
+                                        stream.counts["duplicates"] += 1
+                                        continue
+                                stream.decoder.add_frame(data)
+                        header = parse_frame_header(data)
+                        stream.count(header, recovered)
+                        result = self.processor(data, header)
+                        self.aligner.add(stream.address, header, result, stream.frame_time(header, received_us), received_us)
+                if stream.release():
+                        self.pool.submit(partial(self.drain, stream), stream.index)
+
+        def merged(self, timeout=None):
+                """
+                 timeout: seconds to wait, None waits until a merged frame is ready
+
+                Returns the next merged frame, or None after the timeout.
+                """
+                try:
+                        return self.output.get(timeout=timeout)
+                except queue.Empty:
+                        return None
+
+        def __iter__(self):
+                while self.running:
+                        group = self.merged(RECEIVE_TIMEOUT_S)
+                        if group is not None:
+                                yield group
+
+        def stats(self):
+                """
+                Returns the counters of every stream, the aligner and the worker pool.
+                """
+                return {
+                        "streams": {"{}:{}".format(*stream.address): dict(stream.counts) for stream in list(self.streams.values())},
+                        "aligner": dict(self.aligner.counts),
+                        "workers": {"executed": list(self.pool.executed), "stolen": list(self.pool.stolen)},
+                }
+
+        def stop(self):
+                """
+                Stops the data transmission of the boards, the receive threads and the workers.
+                """
+                for server_ip, server_port, s in self.boards:
+                        s.sendto('{"radar_transmission":"disable"}'.encode(), (server_ip, server_port))
+                self.running = False
+                for thread in self.receivers:
+                        thread.join()
+                self.pool.stop()
+                for s in self.sockets:
+                        s.close()
+
+def bench_sender(ports, streams, rate, seconds, sent):
+        """
+         ports: local ports of the aggregator
+         streams: number of simulated boards
+         rate: frames per second of every board
+         seconds: duration
+         sent: shared counter of the frames sent
+
+        Simulated boards of the scaling benchmark, run in a process of its own. Every board
+        sends from a socket of its own one chirp of BENCH_SAMPLES samples per frame with a
+        target in a range bin of its own, with its device clock starting at a random time.
+        """
+        sockets = [socket.socket(socket.AF_INET, socket.SOCK_DGRAM) for _ in range(streams)]
+        payloads = []
+        clocks = []
+        for index in range(streams):
+                bin_index = 4 + index % (BENCH_SAMPLES // 2 - 8)
+                samples = array('H', (int(2048 + 1000 * math.cos(2 * math.pi * bin_index * k / BENCH_SAMPLES)) for k in range(BENCH_SAMPLES)))
+                if sys.byteorder != 'little':
+                        samples.byteswap()
+                payloads.append(samples.tobytes())
+                clocks.append(int.from_bytes(os.urandom(4), 'little'))
+        period = 1.0 / rate
+        start = time.perf_counter()
+        frame_num = 0
+        while time.perf_counter() - start < seconds:
+                device_us = int((time.perf_counter() - start) * 1e6)
+                for index, s in enumerate(sockets):
+                        header = (bytes([RADAR_DATA_COMMAND, frame_num & 0xFF]) + frame_num.to_bytes(4, 'little') +
+                                  bytes([1, 1]) + (0).to_bytes(2, 'little') + BENCH_SAMPLES.to_bytes(2, 'little') +
+                                  bytes([1, 0]) + (clocks[index] + device_us).to_bytes(8, 'little'))
+                        s.sendto(header + payloads[index], ("127.0.0.1", ports[index % len(ports)]))
+                frame_num += 1
+                with sent.get_lock():
+                        sent.value += streams
+                delay = start + frame_num * period - time.perf_counter()
+                if delay > 0:
+                        time.sleep(delay)
+        for s in sockets:
+                s.close()
+
+def percentile(values, fraction):
+        """
+         values: sorted list
+         fraction: 0 to 1
+
+        Returns the value below which the given fraction of the values lies.
+        """
+        return values[min(int(fraction * len(values)), len(values) - 1)] if values else 0
+
+def udp_aggregator_radar_bench(stream_counts, sockets, workers, rate, seconds, report=None):
+        """
+         stream_counts: numbers of simulated boards to run the benchmark with
+         sockets: number of local UDP sockets of the aggregator
+         workers: number of worker threads
+         rate: frames per second of every simulated board
+         seconds: duration of every run
+
+        Scaling benchmark: runs the aggregator with the default processing against 1 to n
+        simulated boards on the loopback interface and shows the frames sent and
+        processed per second, the merged frames complete with all boards and the latency
+        from the reception of the first frame of a merged frame to its output.
+        """
+        print("Workers: {}, sockets: {}, numpy: {}, frames per board: {}/s".format(
+              workers, sockets, "yes" if numpy is not None else "no", rate))
+        print("streams  sent/s  processed/s  lost  complete  latency p50/p99 ms  stolen")
+        results = []
+        for streams in stream_counts:
+                aggregator = RadarAggregator(sockets, 0, workers)
+                sent = multiprocessing.Value('q', 0)
+                sender = multiprocessing.Process(target=bench_sender, args=(aggregator.ports(), streams, rate, seconds, sent))
+                latencies = []
+                start = time.perf_counter()
+                last = start
+                sender.start()
+                while sender.is_alive() or not aggregator.output.empty():
+                        group = aggregator.merged(0.5)
+                        if group is None:
+                                if not sender.is_alive():
+                                        break
+                                continue
+                        last = time.perf_counter()
+                        latencies.append((host_time_us() - group.received_us) / 1000.0)
+                elapsed = max(last - start, seconds)
+                sender.join()
+                aggregator.stop()
+                stats = aggregator.stats()
+                processed = sum(counts["frames"] for counts in stats["streams"].values())
+                latencies.sort()
+                record = {
+                        "streams": streams,
+                        "sent_per_s": sent.value / elapsed,
+                        "processed_per_s": processed / elapsed,
+                        "lost": sent.value - processed,
+                        "complete": stats["aligner"]["complete"] / max(stats["aligner"]["merged"], 1),
+                        "latency_p50_ms": percentile(latencies, 0.5),
+                        "latency_p99_ms": percentile(latencies, 0.99),
+                        "stolen": sum(stats["workers"]["stolen"]),
+                }
+                results.append(record)
+                print("{streams:7} {sent_per_s:7.0f} {processed_per_s:12.0f} {lost:5} {complete:9.1%} {latency_p50_ms:9.1f} / {latency_p99_ms:<8.1f} {stolen:6}".format(**record))
+        if report:
+                with open(report, "w") as f:
+                        json.dump(results, f, indent=2)
+
+def udp_aggregator_radar(boards, server_port, sockets, port, workers, config=None, window_ms=DEFAULT_ALIGN_WINDOW_MS):
+        """
+         boards: IP addresses of the udp servers
+         server_port: port of the udp servers
+         sockets: number of local UDP sockets
+         port: port of the first local socket, 0 picks free ports
+         workers: number of worker threads
+         config: optional dictionary of settings sent to every board
+         window_ms: largest time difference to the first frame of a merged frame
+
+        Starts the data transmission of all boards and shows the merged frames on the
+        terminal, with the frame number and peak range bin of every board. The counters
+        of every board are shown when the aggregator is stopped.
+        """
+        print("================================================================================")
+        print("UDP Aggregator for Radar data")
+        print("================================================================================")
+        aggregator = RadarAggregator(sockets, port, workers, window_ms=window_ms, lease_ms=(config or {}).get("lease", 0))
+        print("Local ports:", aggregator.ports(), " workers:", workers)
+        for server_ip in boards:
+                print("Start radar device with data tranmission enabled. IP Address:", server_ip, " Port:", server_port)
+                aggregator.add_board(server_ip, server_port, config)
+
+        try:
+                for group in aggregator:
+                        print("Merged frame time: ", group.time_us, " boards: ", len(group.frames), " ",
+                              ", ".join("{} frame {} peak {}".format(address[0], header["frame_num"], result.get("peak_bin", "-"))
+                                        for address, (header, result) in sorted(group.frames.items())))
+        except KeyboardInterrupt:
+                pass
+
+        aggregator.stop()
+        print(json.dumps(aggregator.stats(), indent=2))
+
+
+if __name__ == '__main__':
+        parser = optparse.OptionParser()
+        parser.add_option("-p", "--port", dest="port", type="int", default=DEFAULT_PORT, help="Port of the UDP servers [default: %default].")
+        parser.add_option("--hostname", dest="hostname", default="", help="Comma separated IP addresses of the servers.")
+        parser.add_option("--local-port", dest="local_port", type="int", default=0, help="Port of the first local socket, 0 picks free ports [default: %default].")
+        parser.add_option("--sockets", dest="sockets", type="int", default=DEFAULT_SOCKETS, help="Local UDP sockets the boards are spread over [default: %default].")
+        parser.add_option("--workers", dest="workers", type="int", default=DEFAULT_WORKERS, help="Worker threads processing the frames [default: %default].")
+        parser.add_option("--align-window-ms", dest="align_window_ms", type="float", default=DEFAULT_ALIGN_WINDOW_MS, help="Frames of the boards are merged if taken within this time, the frame period [default: %default].")
+        parser.add_option("--lease", dest="lease", type="int", default=DEFAULT_LEASE_MS, help="The boards suspend their frames if the aggregator is not heard from within this many ms, 0 streams until disabled [default: %default].")
+        parser.add_option("--config", dest="config", type="string", help="Json settings sent to every board before the transmission is enabled.")
+        parser.add_option("--bench", dest="bench", type="string", help="Run the scaling benchmark with these comma separated numbers of simulated boards, e.g. " + DEFAULT_BENCH_STREAMS + ".")
+        parser.add_option("--bench-rate", dest="bench_rate", type="float", default=DEFAULT_BENCH_RATE, help="Frames per second of every simulated board [default: %default].")
+        parser.add_option("--bench-seconds", dest="bench_seconds", type="float", default=DEFAULT_BENCH_SECONDS, help="Duration of every benchmark run [default: %default].")
+        parser.add_option("--report", dest="report", type="string", help="Write the benchmark results to this json file.")
+        (options, args) = parser.parse_args()
+
+        if options.bench:
+                udp_aggregator_radar_bench([int(n) for n in options.bench.split(",")], max(options.sockets, 1),
+                                           max(options.workers, 1), options.bench_rate, options.bench_seconds, options.report)
+        elif options.hostname:
+                config = json.loads(options.config) if options.config else {}
+                # Frames of all boards go to the local sockets over UDP
+                config["transport"] = "udp"
+                config.setdefault("lease", options.lease)
+                udp_aggregator_radar(options.hostname.split(","), options.port, max(options.sockets, 1),
+                                     options.local_port, max(options.workers, 1), config, options.align_window_ms)
+        else:
+                parser.error("--hostname or --bench is required")
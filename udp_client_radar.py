@@ -38,9 +38,13 @@
 
 #!/usr/bin/env python
 import socket
+import select
+import json
 import optparse
 import time
 import sys
+import random
+from collections import OrderedDict
 
 
 BUFFER_SIZE = 8192
@@ -49,6 +53,96 @@ BUFFER_SIZE = 8192
 DEFAULT_IP   = '10.120.128.41'  # IP address of the UDP server
 DEFAULT_PORT = 57345             # Port of the UDP server for data
 DEFAULT_MODE = "data"
+DEFAULT_TCP_PORT = 57346         # Port of the TCP stream of frame datagrams
+DEFAULT_MULTICAST_PORT = 57347   # Port of the multicast stream of frame datagrams
+DEFAULT_MULTICAST_IF = "0.0.0.0" # Local interface the multicast group is joined on, any by default
+
+# Size prefix of every frame datagram in the TCP stream
+TCP_LENGTH_SIZE = 4
+
+# Radar data frame header, see source/radar_frame.h
+FRAME_HEADER_SIZE = 22
+FRAME_FLAG_SYNCED = 0x20
+FRAME_FLAG_RESYNC = 0x40
+FRAME_FLAG_SEALED = 0x80
+
+# Commands in the first byte of every datagram from the udp server
+RADAR_DATA_COMMAND = 1
+RADAR_STATS_COMMAND = 2
+RADAR_BENCH_COMMAND = 3
+RADAR_TARGETS_COMMAND = 4
+RADAR_VITAL_COMMAND = 5
+RADAR_SPECTRO_COMMAND = 6
+RADAR_TRACKS_COMMAND = 7
+RADAR_SYNC_COMMAND = 8
+RADAR_FEC_COMMAND = 9
+RADAR_NACK_COMMAND = 10
+RADAR_LINK_COMMAND = 13
+RADAR_LINK_REPORT_COMMAND = 14
+RADAR_KEEPALIVE_COMMAND = 15
+
+# Commands of the datagrams carrying a frame, the ones protected by parity
+FRAME_COMMANDS = (RADAR_DATA_COMMAND, RADAR_TARGETS_COMMAND, RADAR_VITAL_COMMAND, RADAR_SPECTRO_COMMAND, RADAR_TRACKS_COMMAND)
+
+# Target list after the frame header, see source/radar_cfar.h
+TARGETS_HEADER_SIZE = 4
+TARGET_SIZE = 12
+TARGET_ANGLE_NONE = -32768
+
+# Track report after the frame header, see source/radar_track.h
+TRACKS_HEADER_SIZE = 4
+TRACK_SIZE = 8
+
+# Spectrogram column after the frame header, see source/radar_spectro.h
+SPECTRO_HEADER_SIZE = 6
+
+# Clock synchronization request and response, see source/radar_sync.h
+SYNC_REQUEST_SIZE = 14
+
+# Sealed frame datagram, see source/radar_aead.h
+AEAD_KEY_SIZE = 16
+AEAD_SALT_SIZE = 8
+AEAD_TAG_SIZE = 16
+AEAD_OVERHEAD = AEAD_SALT_SIZE + AEAD_TAG_SIZE
+# Frame numbers accepted behind the newest one before they count as replayed
+AEAD_REPLAY_WINDOW = 64
+
+# Parity datagram, see source/radar_fec.h
+FEC_HEADER_OFFSETS = 11
+FEC_OFFSET_UNUSED = 0xFFFF
+
+# Frame datagrams kept for rebuilding a lost one, more than a group of the largest size
+FEC_HISTORY = 64
+
+# Retransmission request, see source/radar_resend.h
+NACK_MAX_FRAMES = 64
+# Longest run of missing frame numbers requested, the server keeps at most 64 datagrams
+NACK_MAX_RANGE = 1024
+
+# Frame datagrams received ahead of a missing one before it is given up
+DEFAULT_REORDER_WINDOW = 32
+
+# Allowed increase of the minimum cycles of a kernel over the baseline in percent
+DEFAULT_BENCH_TOLERANCE = 10.0
+
+# Client lease: the server suspends the frames if the client is not heard from within
+# it, the client sends a keepalive several times per lease
+DEFAULT_LEASE_MS = 3000
+KEEPALIVES_PER_LEASE = 3
+KEEPALIVE = bytes([RADAR_KEEPALIVE_COMMAND, 0xFF])
+
+# Link test datagram, see source/radar_link.h
+LINK_HEADER_SIZE = 16
+LINK_MAX_COUNT = 100000
+
+# Link test sweep: datagram sizes, bursts and rates tried, seconds per point
+DEFAULT_LINK_SIZES = "256,1024,1472,4096,8192"
+DEFAULT_LINK_BATCHES = "1,4"
+DEFAULT_LINK_RATES = "50,100,200,500,1000,2000"
+DEFAULT_LINK_SECONDS = 2.0
+# A point is sustainable below this loss in percent and this lag of the sender
+DEFAULT_LINK_MAX_LOSS = 1.0
+DEFAULT_LINK_MAX_LAG_MS = 20.0
 
 
 def udp_client_radar_test(server_ip, server_port):
@@ -77,48 +171,1063 @@ def udp_client_radar_test(server_ip, server_port):
                 except KeyboardInterrupt:
                         break
 
-def udp_client_radar( server_ip, server_port):
+def parse_frame_header(data):
+        """
+         data: radar data datagram received from the udp server
+
+        Returns the fields of the frame header as a dictionary.
+        """
+        return {
+                "sequence": data[1],
+                "frame_num": int.from_bytes(data[2:6], 'little'),
+                "roi_antennas": data[6],
+                "roi_chirp_stride": data[7],
+                "roi_sample_start": int.from_bytes(data[8:10], 'little'),
+                "roi_sample_count": int.from_bytes(data[10:12], 'little'),
+                "decimation": data[12],
+                "flags": data[13],
+                "timestamp": int.from_bytes(data[14:22], 'little'),
+                "synced": (data[13] & FRAME_FLAG_SYNCED) != 0,
+                "resync": (data[13] & FRAME_FLAG_RESYNC) != 0,
+        }
+
+def sync_response(request, t2, t3):
+        """
+         request: clock synchronization request received from the udp server
+         t2: host time in microseconds the request was received
+         t3: host time in microseconds the response is sent
+
+        Returns the response datagram, the request with both host times appended.
+        """
+        return request[:SYNC_REQUEST_SIZE] + t2.to_bytes(8, 'little') + t3.to_bytes(8, 'little')
+
+def host_time_us():
+        """
+        Returns the host wall clock in microseconds, the reference of the frame timestamps.
+        """
+        return time.time_ns() // 1000
+
+def parse_targets(data):
+        """
+         data: target list datagram received from the udp server
+
+        Returns the range and Doppler FFT sizes and the list of targets, each a dictionary
+        with range bin, signed Doppler bin, power and azimuth and elevation in degrees. An
+        angle is None if the frame did not contain its antennas.
+        """
+        payload = data[FRAME_HEADER_SIZE:]
+        num_targets = int.from_bytes(payload[0:2], 'little')
+        targets = []
+        for i in range(num_targets):
+                entry = payload[TARGETS_HEADER_SIZE + i * TARGET_SIZE:TARGETS_HEADER_SIZE + (i + 1) * TARGET_SIZE]
+                targets.append({
+                        "range_bin": int.from_bytes(entry[0:2], 'little'),
+                        "doppler_bin": int.from_bytes(entry[2:4], 'little', signed=True),
+                        "power": int.from_bytes(entry[4:8], 'little'),
+                })
+                for key, field in (("azimuth", entry[8:10]), ("elevation", entry[10:12])):
+                        angle = int.from_bytes(field, 'little', signed=True)
+                        targets[-1][key] = None if angle == TARGET_ANGLE_NONE else angle / 100.0
+        return 1 << payload[2], 1 << payload[3], targets
+
+def parse_tracks(data):
+        """
+         data: track report datagram received from the udp server
+
+        Returns the range and Doppler FFT sizes and the list of confirmed tracks, each a
+        dictionary with id, range in range bins, velocity in Doppler bins, confidence in
+        percent and the frames since the track was last detected.
+        """
+        payload = data[FRAME_HEADER_SIZE:]
+        num_tracks = int.from_bytes(payload[0:2], 'little')
+        tracks = []
+        for i in range(num_tracks):
+                entry = payload[TRACKS_HEADER_SIZE + i * TRACK_SIZE:TRACKS_HEADER_SIZE + (i + 1) * TRACK_SIZE]
+                tracks.append({
+                        "id": int.from_bytes(entry[0:2], 'little'),
+                        "range": int.from_bytes(entry[2:4], 'little') / 100.0,
+                        "velocity": int.from_bytes(entry[4:6], 'little', signed=True) / 100.0,
+                        "confidence": entry[6],
+                        "misses": entry[7],
+                })
+        return 1 << payload[2], 1 << payload[3], tracks
+
+def parse_vital(data):
+        """
+         data: vital signs datagram received from the udp server
+
+        Returns a dictionary with the range bin, the breathing and heart rate per minute
+        and their quality. The rates are 0 until the estimation window is full.
+        """
+        payload = data[FRAME_HEADER_SIZE:]
+        return {
+                "range_bin": int.from_bytes(payload[0:2], 'little'),
+                "breathing_rate": int.from_bytes(payload[2:4], 'little') / 10.0,
+                "heart_rate": int.from_bytes(payload[4:6], 'little') / 10.0,
+                "breathing_quality": int.from_bytes(payload[6:8], 'little') / 256.0,
+                "heart_quality": int.from_bytes(payload[8:10], 'little') / 256.0,
+        }
+
+def parse_spectro(data):
+        """
+         data: spectrogram column datagram received from the udp server
+
+        Returns the first range bin, the hop in frames and one list per range bin with the
+        level in dB of every Doppler bin, from -window/2 to window/2 - 1.
+        """
+        payload = data[FRAME_HEADER_SIZE:]
+        range_bin = int.from_bytes(payload[0:2], 'little')
+        window = 1 << payload[3]
+        hop = int.from_bytes(payload[4:6], 'little')
+        columns = []
+        for i in range(payload[2]):
+                block = payload[SPECTRO_HEADER_SIZE + i * (2 + window):SPECTRO_HEADER_SIZE + (i + 1) * (2 + window)]
+                peak = int.from_bytes(block[0:2], 'little') / 100.0
+                columns.append([peak - level / 2.0 for level in block[2:]])
+        return range_bin, hop, columns
+
+class FecDecoder:
+        """
+        Rebuilds lost frame datagrams from the parity datagrams of the udp server. A parity
+        datagram covers every n-th datagram of a group and is the XOR of them, each prefixed
+        with its size, so one lost datagram among those it covers can be rebuilt.
+        """
+        def __init__(self):
+                self.received = OrderedDict()
+
+        def add_frame(self, data):
+                """
+                 data: frame datagram received from the udp server
+                """
+                self.received[int.from_bytes(data[2:6], 'little')] = data
+                if len(self.received) > FEC_HISTORY:
+                        self.received.popitem(last=False)
+
+        def add_parity(self, data):
+                """
+                 data: parity datagram received from the udp server
+
+                Returns the rebuilt frame datagram or None if none of its datagrams is missing
+                or more than one is.
+                """
+                base = int.from_bytes(data[2:6], 'little')
+                count, parity_count, index = data[6], data[7], data[8]
+                payload_size = int.from_bytes(data[9:11], 'little')
+                payload = data[len(data) - payload_size:]
+                offsets = [int.from_bytes(data[i:i + 2], 'little') for i in range(FEC_HEADER_OFFSETS, len(data) - payload_size, 2)]
+
+                members = [(base + offset) & 0xFFFFFFFF for position, offset in enumerate(offsets[:count])
+                           if position % parity_count == index and offset != FEC_OFFSET_UNUSED]
+                missing = [frame_num for frame_num in members if frame_num not in self.received]
+                if len(missing) != 1:
+                        return None
+
+                value = int.from_bytes(payload, 'little')
+                for frame_num in members:
+                        if frame_num != missing[0]:
+                                datagram = self.received[frame_num]
+                                value ^= int.from_bytes(len(datagram).to_bytes(2, 'little') + datagram, 'little')
+                payload = value.to_bytes(payload_size, 'little')
+                length = int.from_bytes(payload[0:2], 'little')
+                datagram = payload[2:2 + length]
+                if length < FRAME_HEADER_SIZE or int.from_bytes(datagram[2:6], 'little') != missing[0]:
+                        return None
+                self.add_frame(datagram)
+                return datagram
+
+class FrameOpener:
+        """
+        Decrypts and authenticates sealed frame datagrams with the pre-shared key. Every frame
+        number is accepted once per salt and only within AEAD_REPLAY_WINDOW of the newest one,
+        so replayed datagrams are dropped. A new salt is taken once a datagram sealed with it
+        is authentic, the salt it replaces is not accepted again.
+        """
+        def __init__(self, key):
+                """
+                 key: pre-shared key, AEAD_KEY_SIZE bytes
+                """
+                try:
+                        from cryptography.hazmat.primitives.ciphers.aead import AESGCM
+                except ImportError:
+                        sys.exit("Decrypting the frames needs the cryptography package: pip install cryptography")
+                self.aead = AESGCM(key)
+                self.salt = None
+                self.retired = set()
+                self.newest = None
+                self.seen = 0
+                self.counts = {"opened": 0, "plaintext": 0, "forged": 0, "replayed": 0}
+                self.time = 0.0
+
+        def fresh(self, frame_num):
+                """
+                 frame_num: frame number of a datagram sealed with the current salt
+
+                Returns True if the frame number was not accepted before and is within the window.
+                """
+                if self.newest is None or frame_num > self.newest:
+                        return True
+                behind = self.newest - frame_num
+                return behind < AEAD_REPLAY_WINDOW and not (self.seen >> behind) & 1
+
+        def accept(self, frame_num):
+                """
+                 frame_num: frame number of an authentic datagram
+
+                Marks the frame number as received in the replay window.
+                """
+                if self.newest is None or frame_num > self.newest:
+                        shift = frame_num - self.newest if self.newest is not None else AEAD_REPLAY_WINDOW
+                        self.seen = ((self.seen << min(shift, AEAD_REPLAY_WINDOW)) | 1) & ((1 << AEAD_REPLAY_WINDOW) - 1)
+                        self.newest = frame_num
+                else:
+                        self.seen |= 1 << (self.newest - frame_num)
+
+        def open(self, data):
+                """
+                 data: frame datagram
+
+                Returns the datagram with the payload decrypted and the salt and tag removed, None
+                if it is not sealed, not authentic or replayed.
+                """
+                start = time.perf_counter()
+                datagram = self.decrypt(data)
+                self.time += time.perf_counter() - start
+                return datagram
+
+        def decrypt(self, data):
+                """
+                 data: frame datagram
+
+                Does the work of open().
+                """
+                if len(data) < FRAME_HEADER_SIZE + AEAD_OVERHEAD or not data[13] & FRAME_FLAG_SEALED:
+                        self.counts["plaintext"] += 1
+                        return None
+                end = len(data) - AEAD_OVERHEAD
+                salt = bytes(data[end:end + AEAD_SALT_SIZE])
+                frame_num = int.from_bytes(data[2:6], 'little')
+                if salt in self.retired or (salt == self.salt and not self.fresh(frame_num)):
+                        self.counts["replayed"] += 1
+                        return None
+                try:
+                        payload = self.aead.decrypt(salt + bytes(data[2:6]), bytes(data[FRAME_HEADER_SIZE:end]) + bytes(data[end + AEAD_SALT_SIZE:]),
+                                                    bytes(data[:FRAME_HEADER_SIZE]))
+                except Exception:
+                        self.counts["forged"] += 1
+                        return None
+                if salt != self.salt:
+                        if self.salt is not None:
+                                self.retired.add(self.salt)
+                        self.salt = salt
+                        self.newest = None
+                        self.seen = 0
+                self.accept(frame_num)
+                self.counts["opened"] += 1
+                return bytes(data[:13]) + bytes([data[13] & ~FRAME_FLAG_SEALED & 0xFF]) + bytes(data[14:FRAME_HEADER_SIZE]) + payload
+
+        def report(self):
+                """
+                Shows the decrypted, rejected and replayed datagrams and the decryption time.
+                """
+                print("Decrypted: {opened}, plaintext: {plaintext}, not authentic: {forged}, replayed: {replayed}".format(**self.counts))
+                if self.counts["opened"]:
+                        print("Decryption: {:.1f} us per frame".format(1e6 * self.time / self.counts["opened"]))
+
+class LossInjector:
+        """
+        Drops received datagrams in bursts like a Wi-Fi link: a two-state Markov chain whose
+        bad state drops every datagram.
+        """
+        def __init__(self, loss, burst):
+                """
+                 loss: average fraction of dropped datagrams, below 1
+                 burst: average number of datagrams dropped in a row, at least 1
+                """
+                self.recover = 1.0 / burst
+                self.fail = loss * self.recover / (1.0 - loss)
+                self.bad = False
+
+        def drop(self):
+                """
+                Returns True if the next datagram is lost.
+                """
+                self.bad = random.random() < ((1.0 - self.recover) if self.bad else self.fail)
+                return self.bad
+
+def nack_requests(first, last):
+        """
+         first: first missing frame number
+         last: last missing frame number
+
+        Returns the retransmission requests for all frame numbers from first to last. The
+        server skips the ones it did not send.
+        """
+        if ((last - first) & 0xFFFFFFFF) >= NACK_MAX_RANGE:
+                first = (last - NACK_MAX_RANGE + 1) & 0xFFFFFFFF
+        count = ((last - first) & 0xFFFFFFFF) + 1
+        requests = []
+        for start in range(0, count, NACK_MAX_FRAMES):
+                bits = min(NACK_MAX_FRAMES, count - start)
+                bitmap = ((1 << bits) - 1).to_bytes((bits + 7) // 8, 'little')
+                requests.append(bytes([RADAR_NACK_COMMAND, 0xFF]) + ((first + start) & 0xFFFFFFFF).to_bytes(4, 'little') + bitmap)
+        return requests
+
+class ReorderBuffer:
+        """
+        Puts the frame datagrams back in the order they were sent, by the sequence number in
+        the second byte of the frame header. A gap in the sequence numbers is a lost datagram:
+        the frame numbers between the datagrams around it are requested again, once more
+        halfway through the window, and the datagrams after it are held back until it arrives
+        or the window is full.
+        """
+        def __init__(self, window):
+                """
+                 window: datagrams held back for a missing one, below 128
+                """
+                self.window = window
+                self.next_seq = None
+                self.high_seq = None
+                self.high_frame = None
+                self.last_frame = None
+                self.pending = {}
+                self.lost = 0
+
+        def add(self, data):
+                """
+                 data: frame datagram received from the udp server
+
+                Returns the datagrams that are now in order and the retransmission requests
+                to send to the server.
+                """
+                seq = data[1]
+                frame_num = int.from_bytes(data[2:6], 'little')
+                if self.next_seq is None:
+                        self.next_seq = self.high_seq = seq
+                        self.high_frame = frame_num
+                if ((seq - self.next_seq) & 0xFF) >= 128 or seq in self.pending:
+                        return [], []
+
+                requests = []
+                ahead = (seq - self.high_seq) & 0xFF
+                if 0 < ahead < 128:
+                        if ahead > 1:
+                                requests = nack_requests((self.high_frame + 1) & 0xFFFFFFFF, (frame_num - 1) & 0xFFFFFFFF)
+                        self.high_seq = seq
+                        self.high_frame = frame_num
+                        if self.next_seq not in self.pending and self.last_frame is not None and \
+                           ((seq - self.next_seq) & 0xFF) == self.window // 2:
+                                # still missing halfway through the window, the request or the
+                                # retransmission may have been lost as well
+                                held = min(self.pending, key=lambda s: (s - self.next_seq) & 0xFF, default=seq)
+                                first_held = int.from_bytes(self.pending.get(held, data)[2:6], 'little')
+                                requests += nack_requests((self.last_frame + 1) & 0xFFFFFFFF, (first_held - 1) & 0xFFFFFFFF)
+                self.pending[seq] = data
+
+                ready = []
+                while self.pending:
+                        if self.next_seq in self.pending:
+                                ready.append(self.pending.pop(self.next_seq))
+                                self.last_frame = int.from_bytes(ready[-1][2:6], 'little')
+                        elif ((self.high_seq - self.next_seq) & 0xFF) >= self.window:
+                                self.lost += 1
+                        else:
+                                break
+                        self.next_seq = (self.next_seq + 1) & 0xFF
+                return ready, requests
+
+def print_frame(data, recovered=False):
+        """
+         data: frame datagram received from the udp server
+         recovered: the datagram was rebuilt from parity
+
+        Shows the content of a frame datagram on the terminal.
+        """
+        header = parse_frame_header(data)
+        label = "Recovered" if recovered else "Received"
+        if header["resync"]:
+                print("Sensor FIFO reset, frames before frame number ", header["frame_num"], " may be missing")
+        if data[0] == RADAR_TARGETS_COMMAND:
+                range_fft_size, doppler_fft_size, targets = parse_targets(data)
+                print(label, "targets frame number: ", header["frame_num"], " targets: ",
+                      ", ".join("range {range_bin} doppler {doppler_bin} power {power} azimuth {azimuth} elevation {elevation}".format(**t) for t in targets))
+        elif data[0] == RADAR_TRACKS_COMMAND:
+                range_fft_size, doppler_fft_size, tracks = parse_tracks(data)
+                print(label, "tracks frame number: ", header["frame_num"], " tracks: ",
+                      ", ".join("id {id} range {range} velocity {velocity} confidence {confidence}%".format(**t) for t in tracks))
+        elif data[0] == RADAR_SPECTRO_COMMAND:
+                range_bin, hop, columns = parse_spectro(data)
+                print(label, "spectrogram frame number: ", header["frame_num"], " range bins: ", range_bin,
+                      "to", range_bin + len(columns) - 1, " peak levels: ",
+                      ", ".join("{:.1f} dB".format(max(column)) for column in columns))
+        elif data[0] == RADAR_VITAL_COMMAND:
+                print(label, "vital signs frame number: ", header["frame_num"],
+                      " range {range_bin} breathing {breathing_rate}/min (quality {breathing_quality:.1f}) heart {heart_rate}/min (quality {heart_quality:.1f})".format(**parse_vital(data)))
+        else:
+                print(label, "data frame number: ", header["frame_num"],
+                      " time: ", header["timestamp"], "us" if header["synced"] else "us (device clock)",
+                      " samples: ", (len(data) - FRAME_HEADER_SIZE) // 2)
+
+def join_group(group, port, interface=DEFAULT_MULTICAST_IF):
+        """
+         group: IPv4 multicast group address
+         port: port of the multicast stream
+         interface: address of the local interface the group is joined on
+
+        Returns a UDP socket that receives the datagrams sent to the group. The port can
+        be shared, so several receivers on one host get every datagram.
+        """
+        g = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+        g.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        if hasattr(socket, "SO_REUSEPORT"):
+                g.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEPORT, 1)
+        g.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1 << 21)
+        g.bind(("", port))
+        g.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, socket.inet_aton(group) + socket.inet_aton(interface))
+        return g
+
+
+def receive(sockets, timeout=None):
+        """
+         sockets: UDP sockets the datagrams can arrive on
+         timeout: seconds to wait, None waits until a datagram arrives
+
+        Waits for the next datagram on any of the sockets and returns it with its sender,
+        (None, None) after the timeout.
+        """
+        readable, _, _ = select.select(sockets, [], [], timeout)
+        if not readable:
+                return None, None
+        return readable[0].recvfrom(BUFFER_SIZE)
+
+
+class Keepalive:
+        """
+        Renews the client lease of the server while the client runs.
+        """
+        def __init__(self, s, server, lease_ms):
+                """
+                 s: UDP socket the commands are sent from
+                 server: (IP address, port) of the udp server
+                 lease_ms: client lease configured on the server
+                """
+                self.s = s
+                self.server = server
+                self.interval = lease_ms / 1000.0 / KEEPALIVES_PER_LEASE
+                self.next = time.perf_counter() + self.interval
+
+        def poll(self):
+                """
+                Sends a keepalive if one is due and returns the seconds until the next one.
+                """
+                now = time.perf_counter()
+                if now >= self.next:
+                        self.s.sendto(KEEPALIVE, self.server)
+                        self.next = max(self.next + self.interval, now)
+                return self.next - now
+
+
+def udp_client_radar( server_ip, server_port, config=None, loss=0.0, burst=1.0, reorder_window=DEFAULT_REORDER_WINDOW, record=None, opener=None,
+                      group=None, control=True):
         """
          server_ip: IP address of the udp server
          server_port: port on which the server is listening
+         config: optional dictionary of settings sent before the transmission is enabled
+         loss: fraction of frame and parity datagrams dropped on purpose to test the parity
+         burst: average number of datagrams dropped in a row
+         reorder_window: datagrams held back for a missing one if the server retransmits
+         record: optional binary file the received frame datagrams are written to
+         opener: optional FrameOpener, frames that are not sealed with its key are dropped
+         group: optional (group address, port, interface) of the multicast stream to join
+         control: False only listens to the multicast group, without sending any command;
+                  else keepalives renew the client lease of config while the client runs
 
         This functions intializes the connection to udp server and starts radar device with
         given configuration. The radar raw data is read from the socket and frame number is
-        shown on the terminal. 
+        shown on the terminal. Lost frames are rebuilt from parity datagrams if the server
+        sends them, and requested again if the server keeps sent frames for retransmission;
+        the loss and recovery counts are shown when the client is stopped.
+        With a multicast group the frames arrive on the group and the replies to commands
+        on the unicast socket. A listener does not send anything: the server replies to the
+        last client that sent a command.
         """
         
     
         print("================================================================================")
         print("UDP Client for Radar data")
         print("================================================================================")
+
+        s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sockets = [s] if control else []
+        if group:
+                print("Join multicast group:", group[0], " Port:", group[1])
+                sockets.append(join_group(*group))
+
+        if control:
+                print("Sending radar configuration. IP Address:",server_ip, " Port:",server_port)
+                if config:
+                        print("Send radar settings", config)
+                        s.sendto(json.dumps(config).encode(), (server_ip, server_port))
+
+                # radar data tranmission mode with presence application settings
+                print("Start radar device with data tranmission enabled")
+                s.sendto('{"radar_transmission":"enable"}'.encode(), (server_ip, server_port))
+        keepalive = Keepalive(s, (server_ip, server_port), config["lease"]) if control and config and config.get("lease") else None
+
+        decoder = FecDecoder()
+        reorder = ReorderBuffer(reorder_window) if config and config.get("resend_depth", 0) > 0 else None
+        injector = LossInjector(loss, burst) if loss > 0.0 else None
+        dropped = set()
+        counts = {"frames": 0, "dropped": 0, "recovered": 0, "resent": 0, "frame_bytes": 0, "parity_bytes": 0}
+        decode_time = 0.0
+        start_time = None
+        
+        while True:
+                try:
+                        data, adr  = receive(sockets, keepalive.poll() if keepalive else None);
+                        if data is None:
+                                continue
+                        if start_time is None:
+                                start_time = time.perf_counter()
+                        if data[0] == RADAR_SYNC_COMMAND and len(data) == SYNC_REQUEST_SIZE:
+                                t2 = host_time_us()
+                                s.sendto(sync_response(data, t2, host_time_us()), adr)
+                                continue
+                        if data[0] == RADAR_STATS_COMMAND:
+                                print("Statistics: ", data[2:].decode())
+                                continue
+                        if data[0] == RADAR_FEC_COMMAND:
+                                counts["parity_bytes"] += len(data)
+                                if injector and injector.drop():
+                                        continue
+                                start = time.perf_counter()
+                                datagram = decoder.add_parity(data)
+                                decode_time += time.perf_counter() - start
+                                if datagram is None:
+                                        continue
+                                frame_num = int.from_bytes(datagram[2:6], 'little')
+                                if frame_num in dropped:
+                                        counts["recovered"] += 1
+                                        dropped.discard(frame_num)
+                                data = datagram
+                        elif data[0] in FRAME_COMMANDS:
+                                if record:
+                                        write_record(record, data)
+                                frame_num = int.from_bytes(data[2:6], 'little')
+                                if frame_num in dropped:
+                                        counts["resent"] += 1
+                                else:
+                                        counts["frames"] += 1
+                                        counts["frame_bytes"] += len(data)
+                                if injector and injector.drop():
+                                        if frame_num not in dropped:
+                                                counts["dropped"] += 1
+                                                dropped.add(frame_num)
+                                        continue
+                                if frame_num in dropped:
+                                        counts["recovered"] += 1
+                                        dropped.discard(frame_num)
+                                start = time.perf_counter()
+                                decoder.add_frame(data)
+                                decode_time += time.perf_counter() - start
+                        else:
+                                print_frame(data)
+                                continue
+
+                        # Parity and retransmission work on the sealed datagrams
+                        if opener:
+                                data = opener.open(data)
+                                if data is None:
+                                        continue
+                        if reorder is None:
+                                print_frame(data)
+                                continue
+                        ready, requests = reorder.add(data)
+                        for request in requests:
+                                s.sendto(request, (server_ip, server_port))
+                        for datagram in ready:
+                                print_frame(datagram)
+
+                except KeyboardInterrupt:
+                        break
+
+        if counts["frames"]:
+                print("Frames: {frames}, dropped: {dropped}, recovered: {recovered}, retransmitted: {resent}".format(**counts))
+                if reorder:
+                        print("Lost after retransmission: ", reorder.lost)
+                if counts["dropped"]:
+                        print("Recovered frame rate: {:.1f}%, lost after recovery: {:.2f}%".format(
+                              100.0 * counts["recovered"] / counts["dropped"], 100.0 * (counts["dropped"] - counts["recovered"]) / counts["frames"]))
+                print("Parity bandwidth: {:.1f}% of the frame bytes, decoding: {:.1f} us per frame".format(
+                      100.0 * counts["parity_bytes"] / counts["frame_bytes"], 1e6 * decode_time / counts["frames"]))
+                print_throughput(counts["frames"], counts["frame_bytes"], time.perf_counter() - start_time)
+        if opener:
+                opener.report()
+
+
+def print_throughput(frames, frame_bytes, elapsed):
+        """
+         frames: frame datagrams received
+         frame_bytes: their total size
+         elapsed: seconds since the first datagram
+
+        Shows the received frame rate and data rate on the terminal.
+        """
+        if elapsed > 0.0:
+                print("Throughput: {:.1f} frames/s, {:.1f} kB/s".format(frames / elapsed, frame_bytes / elapsed / 1000.0))
+
+
+def write_record(record, data):
+        """
+         record: binary file
+         data: frame datagram
+
+        Appends a frame datagram to a recording, prefixed with its size like in the TCP
+        stream, so a recording can be replayed by udp_emulator_radar.py.
+        """
+        record.write(len(data).to_bytes(TCP_LENGTH_SIZE, 'little'))
+        record.write(data)
+
+
+def read_tcp_frames(stream, buffer):
+        """
+         stream: connected TCP socket
+         buffer: bytearray with the bytes read but not returned yet
+
+        Reads from the TCP stream and returns the complete frame datagrams, an empty list
+        if none is complete yet. Raises ConnectionError once the server closed the stream.
+        """
+        chunk = stream.recv(BUFFER_SIZE)
+        if not chunk:
+                raise ConnectionError("TCP stream closed by the server")
+        buffer.extend(chunk)
+        frames = []
+        while len(buffer) >= TCP_LENGTH_SIZE:
+                length = int.from_bytes(buffer[:TCP_LENGTH_SIZE], 'little')
+                if len(buffer) < TCP_LENGTH_SIZE + length:
+                        break
+                frames.append(bytes(buffer[TCP_LENGTH_SIZE:TCP_LENGTH_SIZE + length]))
+                del buffer[:TCP_LENGTH_SIZE + length]
+        return frames
+
+
+def udp_client_radar_tcp(server_ip, server_port, tcp_port, config=None, record=None, opener=None):
+        """
+         server_ip: IP address of the udp server
+         server_port: port of the udp server
+         tcp_port: port of the TCP stream
+         config: dictionary of radar settings sent before the transmission is started,
+                 keepalives renew its client lease while the client runs
+         record: optional binary file the received frame datagrams are written to
+         opener: optional FrameOpener, frames that are not sealed with its key are dropped
+
+        Selects the TCP transport, connects to the TCP stream and starts the radar data
+        transmission. Every frame datagram is received without loss; when the link is too
+        slow the device skips acquisition frames instead, shown as gaps in the frame numbers.
+        Configuration, statistics and clock synchronization still use the udp socket.
+        """
+        print("================================================================================")
+        print("TCP Client for Radar data")
+        print("================================================================================")
         print("Sending radar configuration. IP Address:",server_ip, " Port:",server_port)
 
         s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        config = dict(config or {})
+        config["transport"] = "tcp"
+        print("Send radar settings", config)
+        s.sendto(json.dumps(config).encode(), (server_ip, server_port))
+
+        print("Connect to the TCP stream. Port:", tcp_port)
+        stream = socket.create_connection((server_ip, tcp_port))
 
-        # radar data tranmission mode with presence application settings
         print("Start radar device with data tranmission enabled")
         s.sendto('{"radar_transmission":"enable"}'.encode(), (server_ip, server_port))
-        
+        keepalive = Keepalive(s, (server_ip, server_port), config["lease"]) if config.get("lease") else None
+
+        buffer = bytearray()
+        frames = 0
+        frame_bytes = 0
+        skipped = 0
+        last_frame = None
+        start_time = None
+
         while True:
                 try:
-                        data, adr  = s.recvfrom(BUFFER_SIZE);
-                        print("Received data frame number: ", int.from_bytes(data[2:6], 'little'))
+                        readable, _, _ = select.select([s, stream], [], [], keepalive.poll() if keepalive else None)
+                        if s in readable:
+                                data, adr = s.recvfrom(BUFFER_SIZE)
+                                if data[0] == RADAR_SYNC_COMMAND and len(data) == SYNC_REQUEST_SIZE:
+                                        t2 = host_time_us()
+                                        s.sendto(sync_response(data, t2, host_time_us()), adr)
+                                elif data[0] == RADAR_STATS_COMMAND:
+                                        print("Statistics: ", data[2:].decode())
+                        if stream not in readable:
+                                continue
+                        for data in read_tcp_frames(stream, buffer):
+                                if start_time is None:
+                                        start_time = time.perf_counter()
+                                if record:
+                                        write_record(record, data)
+                                frame_num = parse_frame_header(data)["frame_num"]
+                                if last_frame is not None and frame_num > last_frame + 1:
+                                        skipped += frame_num - last_frame - 1
+                                last_frame = frame_num
+                                frames += 1
+                                frame_bytes += len(data)
+                                if opener:
+                                        data = opener.open(data)
+                                        if data is None:
+                                                continue
+                                print_frame(data)
 
-                except KeyboardInterrupt:
+                except (KeyboardInterrupt, ConnectionError) as e:
+                        if isinstance(e, ConnectionError):
+                                print(e)
                         break
 
+        stream.close()
+        if frames:
+                print("Frames: {}, skipped by the device: {}".format(frames, skipped))
+                print_throughput(frames, frame_bytes, time.perf_counter() - start_time)
+        if opener:
+                opener.report()
+
+def percentile(values, fraction):
+        """
+         values: sorted list of numbers
+         fraction: 0.0 to 1.0
+
+        Returns the value below which the given fraction of the values lies, None if there
+        are no values.
+        """
+        if not values:
+                return None
+        return values[min(int(fraction * len(values)), len(values) - 1)]
+
+def link_point(s, server, size, batch, rate, seconds):
+        """
+         s: socket the server sends the link test datagrams to
+         server: address of the udp server
+         size: bytes per datagram
+         batch: datagrams sent back to back
+         rate: datagrams per second
+         seconds: length of the run
+
+        Runs one link test on the server and measures the delivered throughput, the loss and
+        the latency of its datagrams. The latency is measured against the host clock if the
+        server is synchronized, else relative to the fastest datagram of the run. Returns the
+        measurement as a dictionary, None if the server sent no report.
+        """
+        count = max(1, min(int(rate * seconds), LINK_MAX_COUNT))
+        settings = {"link_size": size, "link_batch": batch, "link_rate": rate, "link_count": count, "link_test": "run"}
+        s.sendto(json.dumps(settings).encode(), server)
+
+        received = {}
+        report = None
+        first = last = None
+        deadline = time.monotonic() + count / rate + 3.0
+        while report is None:
+                s.settimeout(max(deadline - time.monotonic(), 0.01))
+                try:
+                        data, adr = s.recvfrom(BUFFER_SIZE)
+                except socket.timeout:
+                        break
+                arrival = host_time_us()
+                if data[0] == RADAR_SYNC_COMMAND and len(data) == SYNC_REQUEST_SIZE:
+                        s.sendto(sync_response(data, arrival, host_time_us()), adr)
+                elif data[0] == RADAR_LINK_COMMAND and len(data) >= LINK_HEADER_SIZE:
+                        run = data[1]
+                        sequence = int.from_bytes(data[2:6], 'little')
+                        timestamp = int.from_bytes(data[6:14], 'little')
+                        synced = (data[14] & FRAME_FLAG_SYNCED) != 0
+                        received.setdefault(run, {})[sequence] = (arrival, timestamp, synced, len(data))
+                        first = arrival if first is None else first
+                        last = arrival
+                elif data[0] == RADAR_LINK_REPORT_COMMAND:
+                        report = json.loads(data[2:].decode())
+
+        if report is None:
+                s.sendto('{"link_test":"stop"}'.encode(), server)
+                return None
+
+        datagrams = received.get(report["run"], {})
+        delivered = sum(entry[3] for entry in datagrams.values())
+        synced = bool(datagrams) and all(entry[2] for entry in datagrams.values())
+        offsets = sorted(entry[0] - entry[1] for entry in datagrams.values())
+        if not synced and offsets:
+                offsets = [offset - offsets[0] for offset in offsets]
+        # The first datagram only starts the clock
+        elapsed = (last - first) / 1e6 if datagrams and last > first else 0.0
+        delivered -= delivered / len(datagrams) if datagrams else 0
+
+        return OrderedDict([
+                ("size", size), ("batch", batch), ("rate", rate), ("count", count),
+                ("sent", report["sent"]), ("failed", report["failed"]), ("received", len(datagrams)),
+                ("loss_percent", 100.0 * (count - len(datagrams)) / count),
+                ("throughput_kbps", 8.0 * delivered / elapsed / 1000.0 if elapsed > 0.0 else 0.0),
+                ("latency_synced", synced),
+                ("latency_p50_us", percentile(offsets, 0.5)),
+                ("latency_p99_us", percentile(offsets, 0.99)),
+                ("max_lag_us", report["max_lag_us"]),
+                ("duration_us", report["duration_us"]),
+        ])
+
+def udp_client_radar_link(server_ip, server_port, config=None, sizes=DEFAULT_LINK_SIZES, batches=DEFAULT_LINK_BATCHES,
+                          rates=DEFAULT_LINK_RATES, seconds=DEFAULT_LINK_SECONDS, max_loss=DEFAULT_LINK_MAX_LOSS,
+                          max_lag_ms=DEFAULT_LINK_MAX_LAG_MS, report=None):
+        """
+         server_ip: IP address of the udp server
+         server_port: port on which the server is listening
+         config: optional dictionary of settings sent before the sweep, e.g. the sync interval
+         sizes, batches, rates: comma separated datagram sizes, bursts and rates to try
+         seconds: length of every run
+         max_loss: highest loss in percent of a sustainable point
+         max_lag_ms: longest delay of the sender behind its schedule at a sustainable point
+         report: optional file the measurements and the recommendation are written to as json
+
+        This function sweeps the link test of the server over the datagram sizes, bursts and
+        rates, with synthetic datagrams and without the radar sensor. The rates of a size and
+        burst are tried in increasing order until one is not sustainable. The frame
+        configuration recommended is the sustainable point with the highest delivered
+        throughput. Returns 0 if a sustainable point was found, 1 otherwise.
+        """
+        server = (server_ip, server_port)
+        s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        s.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4 * 1024 * 1024)
+
+        if config:
+                print("Send radar settings", config)
+                s.sendto(json.dumps(config).encode(), server)
+
+        points = []
+        for size in [int(value) for value in sizes.split(",")]:
+                for batch in [int(value) for value in batches.split(",")]:
+                        for rate in [int(value) for value in rates.split(",")]:
+                                point = link_point(s, server, size, batch, rate, seconds)
+                                if point is None:
+                                        print("{:5} bytes x {:2} at {:5}/s: no report from the server".format(size, batch, rate))
+                                        break
+                                point["sustainable"] = (point["failed"] == 0 and point["loss_percent"] <= max_loss and
+                                                        point["max_lag_us"] <= max_lag_ms * 1000.0)
+                                points.append(point)
+                                print("{size:5} bytes x {batch:2} at {rate:5}/s: {throughput_kbps:9.1f} kbit/s, loss {loss_percent:5.1f}%, "
+                                      "latency p50 {latency_p50_us} us p99 {latency_p99_us} us, lag {max_lag_us} us{}".format(
+                                      "" if point["sustainable"] else " (not sustainable)", **point))
+                                if not point["sustainable"]:
+                                        break
+
+        sustainable = [point for point in points if point["sustainable"]]
+        best = max(sustainable, key=lambda point: point["size"] * point["rate"]) if sustainable else None
+        if best:
+                print("Recommended: frame datagrams of up to {size} bytes at {rate} per second, in bursts of {batch}, "
+                      "{throughput_kbps:.1f} kbit/s".format(**best))
+        else:
+                print("No sustainable link test point")
+
+        if report:
+                with open(report, "w") as f:
+                        json.dump(OrderedDict([("points", points), ("recommended", best)]), f, indent=2)
+
+        return 0 if best else 1
+
+def udp_client_radar_stats(server_ip, server_port):
+        """
+         server_ip: IP address of the udp server
+         server_port: port on which the server is listening
+
+        This function requests the frame counters and the cycles spent in every processing
+        stage and shows them on the terminal.
+        """
+        s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        s.settimeout(2.0)
+        s.sendto('{"stats":"get"}'.encode(), (server_ip, server_port))
+
+        while True:
+                try:
+                        data, adr = s.recvfrom(BUFFER_SIZE)
+                except socket.timeout:
+                        print("No statistics received")
+                        break
+                if data[0] == RADAR_STATS_COMMAND:
+                        print(json.dumps(json.loads(data[2:].decode()), indent=2))
+                        break
+
+def bench_key(record):
+        """
+         record: benchmark result
+
+        Returns the kernel and geometry identifying a benchmark result.
+        """
+        return (record["kernel"], record["samples"], record["chirps"], record["antennas"])
+
+def compare_bench(results, baseline, tolerance):
+        """
+         results: benchmark results of this run
+         baseline: benchmark results stored earlier
+         tolerance: allowed increase of the minimum cycles in percent
+
+        Compares the minimum cycles of every kernel and geometry present in both runs and
+        returns the list of regressions as (result, baseline result) tuples.
+        """
+        reference = {bench_key(record): record for record in baseline}
+        regressions = []
+        for record in results:
+                base = reference.get(bench_key(record))
+                if base is None:
+                        continue
+                if record["min_cycles"] > base["min_cycles"] * (1.0 + tolerance / 100.0):
+                        regressions.append((record, base))
+        return regressions
+
+def udp_client_radar_bench(server_ip, server_port, report=None, baseline=None, tolerance=DEFAULT_BENCH_TOLERANCE):
+        """
+         server_ip: IP address of the udp server
+         server_port: port on which the server is listening
+         report: optional file the results are written to as json
+         baseline: optional json file of earlier results to compare with
+         tolerance: allowed increase of the minimum cycles over the baseline in percent
+
+        This function runs the kernel benchmark on the radar device, shows the results on the
+        terminal and returns 1 if a kernel got slower than the baseline allows, 0 otherwise.
+        """
+        s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        s.settimeout(10.0)
+        s.sendto('{"bench":"run"}'.encode(), (server_ip, server_port))
+
+        results = []
+        while True:
+                try:
+                        data, adr = s.recvfrom(BUFFER_SIZE)
+                except socket.timeout:
+                        print("Benchmark did not finish")
+                        return 1
+                if data[0] != RADAR_BENCH_COMMAND:
+                        continue
+                record = json.loads(data[2:].decode())
+                if "done" in record:
+                        break
+                results.append(record)
+                print("{kernel:12} {samples:5} x {chirps:3} x {antennas} min {min_cycles:8} avg {avg_cycles:8} cycles".format(**record))
+
+        if len(results) != record["done"]:
+                print("Received", len(results), "of", record["done"], "results")
+
+        if report:
+                with open(report, "w") as f:
+                        json.dump(results, f, indent=2)
+
+        if baseline:
+                with open(baseline) as f:
+                        regressions = compare_bench(results, json.load(f), tolerance)
+                for record, base in regressions:
+                        print("Regression:", record["kernel"], bench_key(record)[1:], "min cycles",
+                              base["min_cycles"], "->", record["min_cycles"])
+                if regressions:
+                        return 1
+                print("No regression against", baseline)
+
+        return 0
+
 	
 if __name__ == '__main__':
         parser = optparse.OptionParser()
         parser.add_option("-p", "--port", dest="port", type="int", default=DEFAULT_PORT, help="Port to listen on [default: %default].")
         parser.add_option("--hostname", dest="hostname", default=DEFAULT_IP, help="Hostname or IP address of the server to connect to.")
-        parser.add_option("-m", "--mode", dest="mode", type="string", default=DEFAULT_MODE, help="Mode for radar: test, data.")
+        parser.add_option("-m", "--mode", dest="mode", type="string", default=DEFAULT_MODE, help="Mode for radar: test, data, stats, bench, link, listen (frames of --multicast only, no commands).")
+        parser.add_option("--pipeline", dest="pipeline", type="string", help="Comma separated processing stages, e.g. decim,mti,roi, decim,cfar, decim,mti,track, vital or spectro.")
+        parser.add_option("--decimation", dest="decimation", type="int", help="Decimation factor applied to every chirp: 1, 2, 4, 8.")
+        parser.add_option("--mti", dest="mti", type="string", help="Static clutter removal: enable, disable.")
+        parser.add_option("--mti-alpha-shift", dest="mti_alpha_shift", type="int", help="Clutter background weight of a new chirp is 2^-n.")
+        parser.add_option("--mti-threshold", dest="mti_threshold", type="int", help="Skip frames whose mean residual power is below this value.")
+        parser.add_option("--cfar-guard-cells", dest="cfar_guard_cells", type="int", help="Target detector cells left out next to the cell under test.")
+        parser.add_option("--cfar-training-cells", dest="cfar_training_cells", type="int", help="Target detector cells averaged on each side for the noise estimate.")
+        parser.add_option("--cfar-threshold-db", dest="cfar_threshold_db", type="int", help="Target detection threshold above the noise estimate in dB.")
+        parser.add_option("--track-interval", dest="track_interval", type="int", help="Frames between track reports.")
+        parser.add_option("--track-gate", dest="track_gate", type="int", help="Largest range and Doppler distance in bins of a detection from its track.")
+        parser.add_option("--vital-range-bin", dest="vital_range_bin", type="int", help="Range bin of the person whose breathing and heart rate are tracked.")
+        parser.add_option("--spectro-range-bin", dest="spectro_range_bin", type="int", help="First range bin of the micro-Doppler spectrogram.")
+        parser.add_option("--spectro-range-bins", dest="spectro_range_bins", type="int", help="Consecutive range bins of the spectrogram: 1 to 4.")
+        parser.add_option("--spectro-window", dest="spectro_window", type="int", help="Frames per spectrogram window: 8, 16, 32, 64, 128.")
+        parser.add_option("--spectro-hop", dest="spectro_hop", type="int", help="Frames between spectrogram columns.")
+        parser.add_option("--sync-interval", dest="sync_interval", type="int", help="Milliseconds between clock synchronization requests, 0 disables them.")
+        parser.add_option("--fec-group", dest="fec_group", type="int", help="Frame datagrams per parity group: 2 to 16, 0 disables the parity.")
+        parser.add_option("--fec-parity", dest="fec_parity", type="int", help="Parity datagrams per group: 1 to 4, up to as many lost datagrams in a row are rebuilt.")
+        parser.add_option("--loss", dest="loss", type="float", default=0.0, help="Drop this percentage of the received frame and parity datagrams to test the parity [default: %default].")
+        parser.add_option("--loss-burst", dest="loss_burst", type="float", default=1.0, help="Average number of datagrams dropped in a row [default: %default].")
+        parser.add_option("--resend-depth", dest="resend_depth", type="int", help="Sent frame datagrams the server keeps for retransmission: 0 to 64, 0 disables it.")
+        parser.add_option("--resend-budget", dest="resend_budget", type="int", help="Retransmitted datagrams per second: 1 to 1000.")
+        parser.add_option("--reorder-window", dest="reorder_window", type="int", default=DEFAULT_REORDER_WINDOW, help="Datagrams held back for a missing one with retransmission [default: %default].")
+        parser.add_option("--handoff", dest="handoff", type="string", help="Frames handed to the server: queue (every frame in order) or latest (newest frame only).")
+        parser.add_option("--profile", dest="profile", type="int", help="Radar profile id from source/radar_profiles.json, changed while the radar is stopped.")
+        parser.add_option("--fifo-inject", dest="fifo_inject", type="int", help="Simulate a sensor FIFO overflow every n frames to test the recovery, 0 disables it.")
+        parser.add_option("--transport", dest="transport", type="string", default="udp", help="Transport of the frame datagrams: udp, tcp [default: %default].")
+        parser.add_option("--tcp-port", dest="tcp_port", type="int", default=DEFAULT_TCP_PORT, help="Port of the TCP stream [default: %default].")
+        parser.add_option("--lease", dest="lease", type="int", default=DEFAULT_LEASE_MS, help="The server suspends the frames if the client is not heard from within this many ms, 0 streams until disabled [default: %default].")
+        parser.add_option("--lease-stop", dest="lease_stop", action="store_true", default=False, help="Also stop the sensor when the lease expires, it is restarted when the client is heard again.")
+        parser.add_option("--multicast", dest="multicast", type="string", help="IPv4 multicast group the frame datagrams are sent to and received from, e.g. 239.1.2.3.")
+        parser.add_option("--multicast-port", dest="multicast_port", type="int", default=DEFAULT_MULTICAST_PORT, help="Port of the multicast stream [default: %default].")
+        parser.add_option("--multicast-ttl", dest="multicast_ttl", type="int", help="Router hops of the multicast datagrams, 1 keeps them on the local network.")
+        parser.add_option("--multicast-if", dest="multicast_if", type="string", default=DEFAULT_MULTICAST_IF, help="Address of the local interface the group is joined on [default: %default].")
+        parser.add_option("--roi-antennas", dest="roi_antennas", type="int", help="Bit mask of the RX antennas to transmit.")
+        parser.add_option("--roi-chirp-stride", dest="roi_chirp_stride", type="int", help="Transmit every n-th chirp.")
+        parser.add_option("--roi-sample-start", dest="roi_sample_start", type="int", help="First sample of every chirp to transmit.")
+        parser.add_option("--roi-sample-count", dest="roi_sample_count", type="int", help="Number of samples of every chirp to transmit.")
+        parser.add_option("--key", dest="key", type="string", help="Pre-shared key the server was built with (RADAR_AEAD_KEY), 32 hex digits; frames that are not sealed with it are dropped.")
+        parser.add_option("--record", dest="record", type="string", help="Write the received frame datagrams to this file, to replay them with udp_emulator_radar.py.")
+        parser.add_option("--report", dest="report", type="string", help="Write the benchmark or link test results to this json file.")
+        parser.add_option("--baseline", dest="baseline", type="string", help="Compare the benchmark results with this json file.")
+        parser.add_option("--tolerance", dest="tolerance", type="float", default=DEFAULT_BENCH_TOLERANCE, help="Allowed benchmark slowdown in percent [default: %default].")
+        parser.add_option("--link-sizes", dest="link_sizes", type="string", default=DEFAULT_LINK_SIZES, help="Link test datagram sizes in bytes, 16 to 8192 [default: %default].")
+        parser.add_option("--link-batches", dest="link_batches", type="string", default=DEFAULT_LINK_BATCHES, help="Link test datagrams sent back to back, 1 to 32 [default: %default].")
+        parser.add_option("--link-rates", dest="link_rates", type="string", default=DEFAULT_LINK_RATES, help="Link test datagrams per second in increasing order, up to 20000 [default: %default].")
+        parser.add_option("--link-seconds", dest="link_seconds", type="float", default=DEFAULT_LINK_SECONDS, help="Length of every link test run [default: %default].")
+        parser.add_option("--link-max-loss", dest="link_max_loss", type="float", default=DEFAULT_LINK_MAX_LOSS, help="Highest loss in percent of a sustainable link [default: %default].")
+        parser.add_option("--link-max-lag", dest="link_max_lag", type="float", default=DEFAULT_LINK_MAX_LAG_MS, help="Longest delay in ms of the server behind the link test schedule [default: %default].")
         (options, args) = parser.parse_args()
+
+        config = {}
+        for key in ("pipeline", "profile", "decimation", "mti", "mti_alpha_shift", "mti_threshold", "cfar_guard_cells", "cfar_training_cells", "cfar_threshold_db", "track_interval", "track_gate", "vital_range_bin", "spectro_range_bin", "spectro_range_bins", "spectro_window", "spectro_hop", "sync_interval", "fec_group", "fec_parity", "resend_depth", "resend_budget", "handoff", "fifo_inject", "roi_antennas", "roi_chirp_stride", "roi_sample_start", "roi_sample_count"):
+                if getattr(options, key) is not None:
+                        config[key] = getattr(options, key)
         #start udp client to connect to radar device
 
         if options.mode == "test":
                 udp_client_radar_test(options.hostname, options.port)
+        elif options.mode == "stats":
+                udp_client_radar_stats(options.hostname, options.port)
+        elif options.mode == "bench":
+                sys.exit(udp_client_radar_bench(options.hostname, options.port, options.report, options.baseline, options.tolerance))
+        elif options.mode == "listen":
+                if not options.multicast:
+                        parser.error("--mode listen needs --multicast")
+                opener = FrameOpener(bytes.fromhex(options.key)) if options.key else None
+                udp_client_radar(options.hostname, options.port, None, options.loss / 100.0, max(options.loss_burst, 1.0),
+                                 opener=opener, group=(options.multicast, options.multicast_port, options.multicast_if), control=False)
+        elif options.mode == "link":
+                sys.exit(udp_client_radar_link(options.hostname, options.port, config, options.link_sizes, options.link_batches,
+                                               options.link_rates, options.link_seconds, options.link_max_loss,
+                                               options.link_max_lag, options.report))
         else:
-                udp_client_radar(options.hostname, options.port)    
+                record = open(options.record, "wb") if options.record else None
+                if options.key and len(bytes.fromhex(options.key)) != AEAD_KEY_SIZE:
+                        parser.error("--key needs {} hex digits".format(2 * AEAD_KEY_SIZE))
+                opener = FrameOpener(bytes.fromhex(options.key)) if options.key else None
+                config["lease"] = options.lease
+                config["lease_stop"] = "enable" if options.lease_stop else "disable"
+                if options.transport == "tcp":
+                        udp_client_radar_tcp(options.hostname, options.port, options.tcp_port, config, record, opener)
+                else:
+                        # Back to UDP in case an earlier client left the device streaming over TCP or to a group
+                        config["transport"] = "udp"
+                        config["multicast"] = options.multicast or "disable"
+                        group = None
+                        if options.multicast:
+                                config["multicast_port"] = options.multicast_port
+                                if options.multicast_ttl is not None:
+                                        config["multicast_ttl"] = options.multicast_ttl
+                                group = (options.multicast, options.multicast_port, options.multicast_if)
+                        udp_client_radar(options.hostname, options.port, config, options.loss / 100.0, max(options.loss_burst, 1.0),
+                                         min(max(options.reorder_window, 1), 127), record, opener, group)
+                if record:
+                        record.close()    
 
 
@@ -0,0 +1,758 @@
+#******************************************************************************
+# File Name:   udp_emulator_radar.py
+#
+# Description: Emulates many radar UDP servers for capacity tests.
+# 
+#********************************************************************************
+# Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#********************************************************************************
+
+#!/usr/bin/env python
+import socket
+import select
+import json
+import optparse
+import time
+import sys
+import math
+import heapq
+import random
+import struct
+import ctypes
+import ctypes.util
+from array import array
+from collections import deque
+
+from udp_client_radar import (BUFFER_SIZE, DEFAULT_PORT, DEFAULT_MULTICAST_PORT, FRAME_HEADER_SIZE, FRAME_FLAG_SYNCED,
+                              TCP_LENGTH_SIZE, RADAR_DATA_COMMAND, RADAR_STATS_COMMAND, KEEPALIVE, LossInjector,
+                              host_time_us)
+
+
+DEFAULT_DEVICES = 16
+DEFAULT_ADDRESS = "127.0.0.1"
+DEFAULT_RATE = 200.0
+DEFAULT_SAMPLES = 128
+DEFAULT_CHIRPS = 1
+DEFAULT_ANTENNAS = 1
+DEFAULT_PAYLOAD_FRAMES = 8
+DEFAULT_BATCH = 64
+DEFAULT_REORDER_DEPTH = 2
+DEFAULT_BACKLOG = 64
+DEFAULT_BACKLOG_RATE = 500
+
+# Largest payload of a UDP datagram
+MAX_DATAGRAM_SIZE = 65507
+
+# Frame header: command, sequence, frame number, region of interest (antennas, chirp
+# stride, first sample, samples), decimation, flags and timestamp, see parse_frame_header()
+FRAME_HEADER = struct.Struct("<BBIBBHHBBQ")
+
+# Longest client lease in ms, see source/udp_server.h, and fastest backlog drain in
+# datagrams per second, see source/radar_wifi.h
+LEASE_MAX_MS = 600000
+BACKLOG_MAX_RATE = 1000
+
+# Drain credit of the backlog is capped at this many seconds of the rate, like the
+# retransmission credit of the udp server
+BACKLOG_MAX_CREDIT_S = 0.1
+
+# Commands are polled at least this often while frames are due
+COMMAND_POLL_S = 0.001
+
+# Largest sleep of the send loop
+IDLE_SLEEP_S = 0.01
+
+# Source address of every datagram, set with an IP_PKTINFO control message
+IP_PKTINFO = getattr(socket, "IP_PKTINFO", 8)
+PKTINFO = struct.Struct("=i4s4s")
+PKTINFO_SPACE = socket.CMSG_SPACE(PKTINFO.size)
+
+# Different target for every device
+TARGET_AMPLITUDE = 600.0
+TARGET_MOTION_BINS = 2.0
+NOISE_AMPLITUDE = 20.0
+SAMPLE_OFFSET = 2048
+SAMPLE_MAX = 4095
+
+
+class iovec(ctypes.Structure):
+        _fields_ = [("iov_base", ctypes.c_void_p), ("iov_len", ctypes.c_size_t)]
+
+class msghdr(ctypes.Structure):
+        _fields_ = [("msg_name", ctypes.c_void_p), ("msg_namelen", ctypes.c_uint32),
+                    ("msg_iov", ctypes.c_void_p), ("msg_iovlen", ctypes.c_size_t),
+                    ("msg_control", ctypes.c_void_p), ("msg_controllen", ctypes.c_size_t),
+                    ("msg_flags", ctypes.c_int)]
+
+class mmsghdr(ctypes.Structure):
+        _fields_ = [("msg_hdr", msghdr), ("msg_len", ctypes.c_uint)]
+
+libc = ctypes.CDLL(ctypes.util.find_library("c"), use_errno=True)
+libc.sendmmsg.argtypes = [ctypes.c_int, ctypes.c_void_p, ctypes.c_uint, ctypes.c_int]
+libc.sendmmsg.restype = ctypes.c_int
+
+# Fields of a message set for every datagram: destination, payload and source address
+MSG_NAME = struct.Struct("@PI")
+MSG_CONTROL = struct.Struct("@PN")
+IOVEC = struct.Struct("@PN")
+MSG_CONTROL_OFFSET = msghdr.msg_control.offset
+
+
+def sockaddr(address):
+        """
+         address: (IP address, port) tuple
+
+        Returns a ctypes buffer with the sockaddr_in of an IPv4 address.
+        """
+        data = struct.pack("=H", socket.AF_INET) + struct.pack("!H", address[1]) + socket.inet_aton(address[0]) + bytes(8)
+        return ctypes.create_string_buffer(data, len(data))
+
+def pktinfo(data):
+        """
+         data: in_pktinfo structure with the source address
+
+        Returns a ctypes buffer with the IP_PKTINFO control message that sends a datagram
+        from this address.
+        """
+        header = struct.pack("@Nii", socket.CMSG_LEN(PKTINFO.size), socket.IPPROTO_IP, IP_PKTINFO)
+        data = (header + data).ljust(PKTINFO_SPACE, b'\0')
+        return ctypes.create_string_buffer(data, len(data))
+
+class SendBatch:
+        """
+        Datagrams of one socket sent with a single sendmmsg call. The messages, the io
+        vectors and the frame headers are allocated once; every datagram only writes its
+        header and the addresses of its payload, destination and source address. Payloads
+        are not copied.
+        """
+        def __init__(self, sock, size):
+                """
+                 sock: UDP socket
+                 size: datagrams per call
+                """
+                self.fd = sock.fileno()
+                self.size = size
+                self.count = 0
+                self.headers = ctypes.create_string_buffer(size * FRAME_HEADER_SIZE)
+                self.iov = (iovec * (2 * size))()
+                self.msgs = (mmsghdr * size)()
+                self.msg_size = ctypes.sizeof(mmsghdr)
+                self.iov_size = ctypes.sizeof(iovec)
+                for i in range(size):
+                        self.iov[2 * i].iov_base = ctypes.addressof(self.headers) + i * FRAME_HEADER_SIZE
+                        self.iov[2 * i].iov_len = FRAME_HEADER_SIZE
+                        self.msgs[i].msg_hdr.msg_iov = ctypes.addressof(self.iov[2 * i])
+                        self.msgs[i].msg_hdr.msg_iovlen = 2
+                self.sent = 0
+                self.calls = 0
+                self.errors = 0
+
+        def add(self, fields, payload, destination, source):
+                """
+                 fields: frame header fields in FRAME_HEADER order
+                 payload: (address, size) of the payload
+                 destination: sockaddr buffer of the client
+                 source: IP_PKTINFO buffer of the device
+
+                Adds a datagram and sends the batch once it is full.
+                """
+                i = self.count
+                FRAME_HEADER.pack_into(self.headers, i * FRAME_HEADER_SIZE, *fields)
+                IOVEC.pack_into(self.iov, (2 * i + 1) * self.iov_size, payload[0], payload[1])
+                MSG_NAME.pack_into(self.msgs, i * self.msg_size, ctypes.addressof(destination), ctypes.sizeof(destination))
+                MSG_CONTROL.pack_into(self.msgs, i * self.msg_size + MSG_CONTROL_OFFSET, ctypes.addressof(source), ctypes.sizeof(source))
+                self.count = i + 1
+                if self.count == self.size:
+                        self.flush()
+
+        def flush(self):
+                """
+                Sends the datagrams added since the last call. A datagram the kernel rejects
+                is counted as an error and skipped.
+                """
+                first = 0
+                while first < self.count:
+                        sent = libc.sendmmsg(self.fd, ctypes.addressof(self.msgs) + first * self.msg_size, self.count - first, 0)
+                        self.calls += 1
+                        if sent < 0:
+                                self.errors += 1
+                                first += 1
+                                continue
+                        self.sent += sent
+                        first += sent
+                self.count = 0
+
+def synthetic_payloads(index, frames, samples, chirps, antennas):
+        """
+         index: device number
+         frames: number of payloads
+         samples: samples per chirp
+         chirps: chirps per frame
+         antennas: RX antennas
+
+        Returns payloads with the echo of a target of the device: a beat tone in a range
+        bin of its own that moves back and forth by a few bins over the payloads, with a
+        phase that advances from chirp to chirp by its velocity and from antenna to antenna
+        by its angle, plus noise. Samples are interleaved by antenna like the sensor FIFO.
+        """
+        rng = random.Random(index)
+        range_bin = 4 + (index * 7) % max(samples // 2 - 8, 1)
+        doppler = rng.uniform(-0.2, 0.2)
+        angle = rng.uniform(-1.0, 1.0)
+        payloads = []
+        for frame in range(frames):
+                beat = range_bin + TARGET_MOTION_BINS * math.sin(2 * math.pi * frame / frames)
+                values = array('H')
+                for chirp in range(chirps):
+                        for sample in range(samples):
+                                for antenna in range(antennas):
+                                        phase = 2 * math.pi * (beat * sample / samples + doppler * chirp) + angle * antenna
+                                        value = SAMPLE_OFFSET + TARGET_AMPLITUDE * math.cos(phase) + rng.uniform(-NOISE_AMPLITUDE, NOISE_AMPLITUDE)
+                                        values.append(min(max(int(value), 0), SAMPLE_MAX))
+                if sys.byteorder != 'little':
+                        values.byteswap()
+                roi = ((1 << antennas) - 1, 1, 0, samples, 1)
+                payloads.append((values.tobytes(), roi))
+        return payloads
+
+def replay_payloads(path):
+        """
+         path: recording written by udp_client_radar.py --record
+
+        Returns the payloads of the radar data frames of a recording with the region of
+        interest and decimation of their headers.
+        """
+        payloads = []
+        with open(path, "rb") as f:
+                data = f.read()
+        position = 0
+        while position + TCP_LENGTH_SIZE <= len(data):
+                length = int.from_bytes(data[position:position + TCP_LENGTH_SIZE], 'little')
+                datagram = data[position + TCP_LENGTH_SIZE:position + TCP_LENGTH_SIZE + length]
+                position += TCP_LENGTH_SIZE + length
+                if len(datagram) < FRAME_HEADER_SIZE or datagram[0] != RADAR_DATA_COMMAND:
+                        continue
+                fields = FRAME_HEADER.unpack_from(datagram)
+                payloads.append((datagram[FRAME_HEADER_SIZE:], fields[3:8]))
+        return payloads
+
+class LinkOutages:
+        """
+        Stand-in for the Wi-Fi connection manager of the devices: the link of every device
+        goes down for a while at a fixed interval, each device at a phase of its own, and
+        comes back by itself.
+        """
+        def __init__(self, every, length, devices):
+                """
+                 every: seconds from one outage of a device to the next, 0 disables them
+                 length: seconds the link stays down
+                 devices: number of devices, spreads the outages over the interval
+                """
+                self.every = every
+                self.length = min(length, every)
+                self.devices = max(devices, 1)
+                self.start = time.perf_counter()
+
+        def is_up(self, device, now):
+                """
+                 device: emulated device
+                 now: current time of the send loop
+                """
+                if self.every <= 0.0:
+                        return True
+                # The first outage begins one interval after the start
+                elapsed = now - self.start - self.every * (1.0 + device.index / self.devices)
+                return elapsed < 0.0 or elapsed % self.every >= self.length
+
+class EmulatedDevice:
+        """
+        One emulated radar device: its address, the client it sends to, its frame and
+        datagram counters and its precomputed payloads.
+        """
+        def __init__(self, index, address, payloads, loss, burst, clock_offset, backlog, backlog_rate):
+                """
+                 index: device number
+                 address: (IP address, port) of the emulated udp server
+                 payloads: list of (payload buffer, region of interest and decimation) sent in turn
+                 loss: fraction of frame datagrams lost on the way
+                 burst: average number of datagrams lost in a row
+                 clock_offset: microseconds added to the host clock for the frame time
+                 backlog: frames kept while the link is down, the oldest are dropped beyond
+                 backlog_rate: datagrams per second the kept frames are sent at once the link
+                               is back
+                """
+                self.index = index
+                self.address = address
+                self.source_info = PKTINFO.pack(0, socket.inet_aton(address[0]), bytes(4))
+                self.source = pktinfo(self.source_info)
+                self.payloads = payloads
+                self.payload_index = index % len(payloads)
+                self.injector = LossInjector(loss, burst) if loss > 0.0 else None
+                self.clock_offset = clock_offset
+                self.mode = None
+                self.scheduled = False
+                self.client = None
+                self.destination = None
+                self.group = None
+                self.group_port = DEFAULT_MULTICAST_PORT
+                self.group_destination = None
+                self.lease = 0.0
+                self.lease_stop = False
+                self.heard = 0.0
+                self.suspended = False
+                self.link = "up"
+                self.backlog = deque(maxlen=max(backlog, 1))
+                self.backlog_rate = backlog_rate
+                self.drain_credit = 0.0
+                self.drain_time = 0.0
+                self.check_time = 0.0
+                self.check_backlog = 0
+                self.frame_num = 0
+                self.sequence = 0
+                self.counts = {"frames": 0, "lost": 0, "reordered": 0, "suspended": 0, "lease_expiries": 0,
+                               "wifi_disconnects": 0, "kept": 0, "backlog_dropped": 0}
+
+        def connect(self, client, mode):
+                """
+                 client: (IP address, port) the datagrams are sent to
+                 mode: "data", "test" or None to stop
+                """
+                self.mode = mode
+                if client is not None:
+                        self.client = client
+                        self.destination = sockaddr(client)
+
+        def set_multicast(self, group, port):
+                """
+                 group: IPv4 multicast group the frame datagrams are sent to, None sends them
+                        to the client
+                 port: port of the multicast stream
+                """
+                self.group = group
+                self.group_port = port
+                self.group_destination = sockaddr((group, port)) if group else None
+
+class RadarEmulator:
+        """
+        Emulates radar devices that speak the protocol of the udp server. Every device has
+        an address of its own, consecutive IP addresses on the same port by default, and
+        answers the radar_transmission, stats and multicast commands. Devices on the same
+        port share one socket, and the datagrams of all of them go out in batches with
+        sendmmsg; the source address of every datagram is set with IP_PKTINFO.
+        """
+        def __init__(self, devices, address, port, consecutive_ports, payloads, options):
+                """
+                 devices: number of devices
+                 address: IP address of the first device
+                 port: port of the first device
+                 consecutive_ports: devices use consecutive ports on one address instead of
+                                    consecutive addresses on one port
+                 payloads: list of (payload, region of interest and decimation) of every device
+                 options: rate, loss, loss_burst, reorder, reorder_depth, jitter, synced, batch,
+                          outage_every, outage_length, backlog and backlog_rate
+                """
+                self.period = 1.0 / options.rate
+                self.reorder = options.reorder / 100.0
+                self.reorder_depth = max(options.reorder_depth, 1)
+                self.jitter = options.jitter / 1000.0
+                self.synced = options.synced
+                self.sockets = {}
+                self.batches = {}
+                self.devices = {}
+                self.by_socket = {}
+                first = struct.unpack("!I", socket.inet_aton(address))[0]
+                for index in range(devices):
+                        if consecutive_ports:
+                                device_address = (address, port + index)
+                        else:
+                                device_address = (socket.inet_ntoa(struct.pack("!I", first + index)), port)
+                        if device_address[1] not in self.sockets:
+                                s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+                                s.setsockopt(socket.SOL_SOCKET, socket.SO_SNDBUF, 1 << 22)
+                                s.setsockopt(socket.IPPROTO_IP, IP_PKTINFO, 1)
+                                s.bind(("0.0.0.0" if not consecutive_ports else address, device_address[1]))
+                                self.sockets[device_address[1]] = s
+                                self.batches[device_address[1]] = SendBatch(s, max(options.batch, 1))
+                        buffers = [(ctypes.create_string_buffer(data, len(data)), roi) for data, roi in payloads[index]]
+                        self.devices[device_address] = EmulatedDevice(index, device_address, buffers, options.loss / 100.0,
+                                                                      max(options.loss_burst, 1.0), random.randrange(1 << 32),
+                                                                      options.backlog, options.backlog_rate)
+                self.outages = LinkOutages(options.outage_every, options.outage_length, devices)
+                self.frames = []
+                self.sends = []
+                self.order = 0
+                self.time_base = 0
+
+        def start(self, device, client, mode):
+                """
+                 device: emulated device
+                 client: (IP address, port) the datagrams are sent to, None keeps the last one
+                 mode: "data", "test" or None to stop
+                """
+                device.connect(client, mode)
+                if mode is not None and not device.scheduled and device.client is not None:
+                        device.scheduled = True
+                        phase = self.period * device.index / len(self.devices)
+                        heapq.heappush(self.frames, (time.perf_counter() + phase, device.index, device))
+
+        def handle_command(self, s):
+                """
+                 s: socket a command arrived on
+
+                Answers a command like the udp server does: radar_transmission enables, disables
+                or starts the test mode of the device the command was sent to, and stats replies
+                with its counters. The multicast keys move the frame stream to a group, lease
+                and lease_stop set the client lease that every datagram renews and
+                backlog_rate the drain rate after a link outage. The sender of the command
+                becomes the client of the device.
+                """
+                try:
+                        data, ancdata, flags, client = s.recvmsg(BUFFER_SIZE, PKTINFO_SPACE)
+                except OSError:
+                        return
+                local = s.getsockname()
+                ip = local[0]
+                for level, kind, value in ancdata:
+                        if level == socket.IPPROTO_IP and kind == IP_PKTINFO and len(value) >= PKTINFO.size:
+                                ip = socket.inet_ntoa(PKTINFO.unpack_from(value)[2])
+                device = self.devices.get((ip, local[1]))
+                # Nothing reaches a device whose link is down
+                if device is None or device.link == "down":
+                        return
+                device.heard = time.perf_counter()
+                if data == KEEPALIVE:
+                        return
+                try:
+                        command = json.loads(data.decode())
+                except ValueError:
+                        return
+                if not isinstance(command, dict):
+                        return
+                lease = command.get("lease")
+                if isinstance(lease, int) and 0 <= lease <= LEASE_MAX_MS:
+                        device.lease = lease / 1000.0
+                if command.get("lease_stop") in ("enable", "disable"):
+                        device.lease_stop = command["lease_stop"] == "enable"
+                backlog_rate = command.get("backlog_rate")
+                if isinstance(backlog_rate, int) and 0 < backlog_rate <= BACKLOG_MAX_RATE:
+                        device.backlog_rate = backlog_rate
+                if any(key in command for key in ("multicast", "multicast_port", "multicast_ttl")):
+                        self.multicast(device, s, command)
+                transmission = command.get("radar_transmission")
+                if transmission in ("enable", "test"):
+                        self.start(device, client, "data" if transmission == "enable" else "test")
+                elif transmission == "disable":
+                        device.connect(client, None)
+                if command.get("stats") == "get":
+                        stats = dict(device.counts, frame_num=device.frame_num, wifi=device.link,
+                                     address="{}:{}".format(*device.address))
+                        s.sendmsg([bytes([RADAR_STATS_COMMAND, 0xFF]) + json.dumps(stats).encode()],
+                                  [(socket.IPPROTO_IP, IP_PKTINFO, device.source_info)], 0, client)
+
+        def multicast(self, device, s, command):
+                """
+                 device: emulated device the command was sent to
+                 s: socket of the device
+                 command: json command with the multicast, multicast_port or multicast_ttl keys
+
+                Streams the frame datagrams of the device to a multicast group like the udp
+                server does, "disable" sends them to the client again. Invalid settings are
+                ignored. The TTL is set on the socket, shared by the devices on its port. The
+                outgoing interface follows from the source address of the device.
+                """
+                group = command.get("multicast", device.group or "disable")
+                port = command.get("multicast_port", device.group_port)
+                ttl = command.get("multicast_ttl", s.getsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL))
+                if group == "disable":
+                        group = None
+                try:
+                        if group and (socket.inet_aton(group)[0] & 0xF0) != 0xE0:
+                                return
+                except (OSError, TypeError):
+                        return
+                if not isinstance(port, int) or not 0 < port <= 0xFFFF or not isinstance(ttl, int) or not 0 < ttl <= 0xFF:
+                        return
+                s.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL, ttl)
+                device.set_multicast(group, port)
+
+        def generate(self, now):
+                """
+                 now: current time of the send loop
+
+                Takes the frames of every device that are due, at most one per device so the
+                send loop keeps polling when it falls behind: advances the frame and sequence
+                numbers, applies the client lease and the loss and schedules the datagram with
+                its reordering and jitter delay. While the link of the device is down or its
+                backlog drains, the frame joins the backlog instead.
+                """
+                for _ in range(len(self.devices)):
+                        if not self.frames or self.frames[0][0] > now:
+                                break
+                        due, index, device = heapq.heappop(self.frames)
+                        if device.mode is None:
+                                device.scheduled = False
+                                continue
+                        heapq.heappush(self.frames, (due + self.period, index, device))
+                        # The client cannot renew the lease while the link is down
+                        expired = device.link != "down" and device.lease > 0.0 and now - device.heard >= device.lease
+                        if expired != device.suspended:
+                                device.suspended = expired
+                                device.counts["lease_expiries"] += expired
+                        if expired:
+                                # The frame is dropped, or not taken at all with the sensor stopped
+                                if not device.lease_stop:
+                                        device.frame_num = (device.frame_num + 1) & 0xFFFFFFFF
+                                        device.counts["suspended"] += 1
+                                continue
+                        frame_num = device.frame_num
+                        sequence = device.sequence
+                        device.frame_num = (frame_num + 1) & 0xFFFFFFFF
+                        device.sequence = (sequence + 1) & 0xFF
+                        device.counts["frames"] += 1
+                        timestamp = int(due * 1e6) + (self.time_base if self.synced else device.clock_offset)
+                        if device.link != "up":
+                                if len(device.backlog) == device.backlog.maxlen:
+                                        device.counts["backlog_dropped"] += 1
+                                device.backlog.append((frame_num, sequence, timestamp))
+                                device.counts["kept"] += 1
+                                continue
+                        if device.injector and device.injector.drop():
+                                device.counts["lost"] += 1
+                                continue
+                        send_time = due
+                        if self.jitter:
+                                send_time += random.uniform(0.0, self.jitter)
+                        if self.reorder and random.random() < self.reorder:
+                                send_time += self.period * random.randint(1, self.reorder_depth)
+                                device.counts["reordered"] += 1
+                        if send_time <= now:
+                                self.send(device, frame_num, sequence, timestamp)
+                        else:
+                                self.order += 1
+                                heapq.heappush(self.sends, (send_time, self.order, device, frame_num, sequence, timestamp))
+
+        def follow_links(self, now):
+                """
+                 now: current time of the send loop
+
+                Takes the link changes of the connection manager like the udp server does: a
+                lost link pauses the frames of the device, and once it is back its backlog is
+                sent at the backlog rate, live frames only after it. A backlog that did not
+                shrink over the time it takes at the backlog rate is dropped. The client lease
+                starts over with the link. Returns True while a backlog is draining.
+                """
+                draining = False
+                for device in self.devices.values():
+                        up = self.outages.is_up(device, now)
+                        if not up and device.link != "down":
+                                device.link = "down"
+                                device.counts["wifi_disconnects"] += 1
+                        elif up and device.link == "down":
+                                device.link = "draining"
+                                device.heard = now
+                                device.drain_credit = 1.0
+                                device.drain_time = now
+                                device.check_time = now
+                                device.check_backlog = len(device.backlog)
+                        if device.link != "draining":
+                                continue
+                        if device.backlog and now - device.check_time >= device.backlog.maxlen / device.backlog_rate:
+                                if len(device.backlog) >= device.check_backlog:
+                                        device.counts["backlog_dropped"] += len(device.backlog)
+                                        device.backlog.clear()
+                                device.check_time = now
+                                device.check_backlog = len(device.backlog)
+                        max_credit = max(device.backlog_rate * BACKLOG_MAX_CREDIT_S, 1.0)
+                        device.drain_credit = min(device.drain_credit + (now - device.drain_time) * device.backlog_rate, max_credit)
+                        device.drain_time = now
+                        while device.backlog and device.drain_credit >= 1.0:
+                                frame_num, sequence, timestamp = device.backlog.popleft()
+                                device.drain_credit -= 1.0
+                                if device.mode is None:
+                                        continue
+                                if device.injector and device.injector.drop():
+                                        device.counts["lost"] += 1
+                                        continue
+                                self.send(device, frame_num, sequence, timestamp)
+                        if device.backlog:
+                                draining = True
+                        else:
+                                device.link = "up"
+                return draining
+
+        def send(self, device, frame_num, sequence, timestamp):
+                """
+                 device: emulated device
+                 frame_num: frame number of the datagram
+                 sequence: datagram sequence number
+                 timestamp: frame time in microseconds
+
+                Adds a frame datagram, or the test mode message, to the batch of the device.
+                """
+                if device.mode == "test":
+                        s = self.sockets[device.address[1]]
+                        s.sendmsg([("Frame %d received correctly" % frame_num).encode()],
+                                  [(socket.IPPROTO_IP, IP_PKTINFO, device.source_info)], 0, device.client)
+                        return
+                payload, roi = device.payloads[frame_num % len(device.payloads)]
+                flags = FRAME_FLAG_SYNCED if self.synced else 0
+                self.batches[device.address[1]].add(
+                        (RADAR_DATA_COMMAND, sequence, frame_num) + tuple(roi) + (flags, timestamp & 0xFFFFFFFFFFFFFFFF),
+                        (ctypes.addressof(payload), len(payload)), device.group_destination or device.destination, device.source)
+
+        def run(self, duration, report_interval=1.0):
+                """
+                 duration: seconds to run, 0 runs until interrupted
+                 report_interval: seconds between the rate reports
+
+                Send loop: polls the commands, generates the due frames, sends the datagrams
+                whose time has come in batches and shows the datagram rate every interval.
+                """
+                self.time_base = host_time_us() - int(time.perf_counter() * 1e6)
+                start = time.perf_counter()
+                last_poll = 0.0
+                last_report = start
+                last_sent = 0
+                sockets = list(self.sockets.values())
+                while duration <= 0 or time.perf_counter() - start < duration:
+                        now = time.perf_counter()
+                        if now - last_poll >= COMMAND_POLL_S:
+                                last_poll = now
+                                readable, _, _ = select.select(sockets, [], [], 0)
+                                for s in readable:
+                                        self.handle_command(s)
+                        draining = self.outages.every > 0.0 and self.follow_links(now)
+                        self.generate(now)
+                        while self.sends and self.sends[0][0] <= now:
+                                _, _, device, frame_num, sequence, timestamp = heapq.heappop(self.sends)
+                                if device.mode is not None:
+                                        self.send(device, frame_num, sequence, timestamp)
+                        for batch in self.batches.values():
+                                batch.flush()
+
+                        if now - last_report >= report_interval:
+                                sent = sum(batch.sent for batch in self.batches.values())
+                                calls = sum(batch.calls for batch in self.batches.values())
+                                lag = (now - self.frames[0][0]) * 1000.0 if self.frames else 0.0
+                                print("Sent {:.0f} datagrams/s, {} devices active, {} datagrams per sendmmsg, {} errors, {:.1f} ms behind".format(
+                                      (sent - last_sent) / (now - last_report), sum(1 for device in self.devices.values() if device.mode),
+                                      sent // max(calls, 1), sum(batch.errors for batch in self.batches.values()), max(lag, 0.0)))
+                                last_report = now
+                                last_sent = sent
+
+                        due = [queue[0][0] for queue in (self.frames, self.sends) if queue]
+                        if draining:
+                                due.append(now + COMMAND_POLL_S)
+                        delay = min(due + [now + IDLE_SLEEP_S]) - time.perf_counter()
+                        if delay > 0:
+                                readable, _, _ = select.select(sockets, [], [], min(delay, IDLE_SLEEP_S))
+                                for s in readable:
+                                        self.handle_command(s)
+                                last_poll = time.perf_counter()
+
+        def stats(self):
+                """
+                Returns the counters of all devices and sockets.
+                """
+                totals = {"frames": 0, "lost": 0, "reordered": 0, "suspended": 0, "lease_expiries": 0,
+                          "wifi_disconnects": 0, "kept": 0, "backlog_dropped": 0}
+                for device in self.devices.values():
+                        for key in totals:
+                                totals[key] += device.counts[key]
+                totals["sent"] = sum(batch.sent for batch in self.batches.values())
+                totals["sendmmsg_calls"] = sum(batch.calls for batch in self.batches.values())
+                totals["errors"] = sum(batch.errors for batch in self.batches.values())
+                return totals
+
+
+if __name__ == '__main__':
+        parser = optparse.OptionParser()
+        parser.add_option("--devices", dest="devices", type="int", default=DEFAULT_DEVICES, help="Number of emulated devices [default: %default].")
+        parser.add_option("--address", dest="address", default=DEFAULT_ADDRESS, help="IP address of the first device, the others use the following addresses [default: %default].")
+        parser.add_option("-p", "--port", dest="port", type="int", default=DEFAULT_PORT, help="Port of the devices [default: %default].")
+        parser.add_option("--consecutive-ports", dest="consecutive_ports", action="store_true", default=False, help="Devices use consecutive ports on --address instead of consecutive addresses.")
+        parser.add_option("--rate", dest="rate", type="float", default=DEFAULT_RATE, help="Frames per second of every device [default: %default].")
+        parser.add_option("--samples", dest="samples", type="int", default=DEFAULT_SAMPLES, help="Samples per chirp of the synthetic frames [default: %default].")
+        parser.add_option("--chirps", dest="chirps", type="int", default=DEFAULT_CHIRPS, help="Chirps per frame of the synthetic frames [default: %default].")
+        parser.add_option("--antennas", dest="antennas", type="int", default=DEFAULT_ANTENNAS, help="RX antennas of the synthetic frames [default: %default].")
+        parser.add_option("--payload-frames", dest="payload_frames", type="int", default=DEFAULT_PAYLOAD_FRAMES, help="Synthetic frames precomputed per device and sent in turn [default: %default].")
+        parser.add_option("--replay", dest="replay", type="string", help="Send the radar data frames of a recording of udp_client_radar.py --record instead.")
+        parser.add_option("--loss", dest="loss", type="float", default=0.0, help="Percentage of frame datagrams lost [default: %default].")
+        parser.add_option("--loss-burst", dest="loss_burst", type="float", default=1.0, help="Average number of datagrams lost in a row [default: %default].")
+        parser.add_option("--reorder", dest="reorder", type="float", default=0.0, help="Percentage of frame datagrams sent after later ones [default: %default].")
+        parser.add_option("--reorder-depth", dest="reorder_depth", type="int", default=DEFAULT_REORDER_DEPTH, help="A reordered datagram is delayed by up to this many frame periods [default: %default].")
+        parser.add_option("--jitter", dest="jitter", type="float", default=0.0, help="Random send delay of every datagram of up to this many ms [default: %default].")
+        parser.add_option("--synced", dest="synced", action="store_true", default=False, help="Frames carry the host time with flags bit 5 set, as from a synchronized device.")
+        parser.add_option("--target", dest="target", type="string", help="host:port every device streams to from the start, without waiting for a command.")
+        parser.add_option("--outage-every", dest="outage_every", type="float", default=0.0, help="Seconds between Wi-Fi link outages of every device, 0 disables them [default: %default].")
+        parser.add_option("--outage-length", dest="outage_length", type="float", default=1.0, help="Seconds a Wi-Fi link outage lasts [default: %default].")
+        parser.add_option("--backlog", dest="backlog", type="int", default=DEFAULT_BACKLOG, help="Frames a device keeps while its link is down, RADAR_WIFI_BACKLOG_DEPTH of the firmware [default: %default].")
+        parser.add_option("--backlog-rate", dest="backlog_rate", type="int", default=DEFAULT_BACKLOG_RATE, help="Datagrams per second the kept frames are sent at once the link is back [default: %default].")
+        parser.add_option("--batch", dest="batch", type="int", default=DEFAULT_BATCH, help="Datagrams per sendmmsg call [default: %default].")
+        parser.add_option("--duration", dest="duration", type="float", default=0.0, help="Seconds to run, 0 runs until interrupted [default: %default].")
+        (options, args) = parser.parse_args()
+
+        if options.replay:
+                recording = replay_payloads(options.replay)
+                if not recording:
+                        parser.error("no radar data frames in " + options.replay)
+                payloads = [recording] * options.devices
+        else:
+                frames = max(options.payload_frames, 1)
+                if FRAME_HEADER_SIZE + 2 * options.samples * options.chirps * options.antennas > MAX_DATAGRAM_SIZE:
+                        parser.error("the frames do not fit a UDP datagram")
+                # Devices with the same target share their payloads
+                targets = max(options.samples // 2 - 8, 1)
+                shared = {}
+                payloads = []
+                for index in range(options.devices):
+                        key = index % targets
+                        if key not in shared:
+                                shared[key] = synthetic_payloads(index, frames, options.samples, options.chirps, options.antennas)
+                        payloads.append(shared[key])
+
+        print("================================================================================")
+        print("UDP Server emulator for Radar data")
+        print("================================================================================")
+        emulator = RadarEmulator(options.devices, options.address, options.port, options.consecutive_ports, payloads, options)
+        first, last = min(emulator.devices), max(emulator.devices)
+        print("Devices:", options.devices, " from", "{}:{}".format(*first), "to", "{}:{}".format(*last), " frames per second:", options.rate)
+        if options.target:
+                host, port = options.target.rsplit(":", 1)
+                for device in emulator.devices.values():
+                        emulator.start(device, (socket.gethostbyname(host), int(port)), "data")
+
+        try:
+                emulator.run(options.duration)
+        except KeyboardInterrupt:
+                pass
+        print(json.dumps(emulator.stats()))